@@ -148,6 +148,7 @@ def envoy_dependencies(skip_targets = []):
     _com_google_absl()
     _com_google_googletest()
     _com_google_protobuf()
+    _com_googlesource_code_re2()
     _com_googlesource_quiche()
     _com_lightstep_tracer_cpp()
     _io_opentracing_cpp()
@@ -511,6 +512,13 @@ def _com_google_protobuf():
         actual = "@com_google_protobuf//util/python:python_headers",
     )
 
+def _com_googlesource_code_re2():
+    _repository_impl("com_googlesource_code_re2")
+    native.bind(
+        name = "re2",
+        actual = "@com_googlesource_code_re2//:re2",
+    )
+
 def _com_googlesource_quiche():
     location = REPOSITORY_LOCATIONS["com_googlesource_quiche"]
     genrule_repository(
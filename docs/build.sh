@@ -83,6 +83,7 @@ PROTO_RST="
   /envoy/api/v2/ratelimit/ratelimit/envoy/api/v2/ratelimit/ratelimit.proto.rst
   /envoy/config/accesslog/v2/als/envoy/config/accesslog/v2/als.proto.rst
   /envoy/config/accesslog/v2/file/envoy/config/accesslog/v2/file.proto.rst
+  /envoy/config/accesslog/v2alpha/columnar_file/envoy/config/accesslog/v2alpha/columnar_file.proto.rst
   /envoy/config/bootstrap/v2/bootstrap/envoy/config/bootstrap/v2/bootstrap.proto.rst
   /envoy/config/cluster/redis/redis_cluster/envoy/config/cluster/redis/redis_cluster.proto.rst
   /envoy/config/common/tap/v2alpha/common/envoy/config/common/tap/v2alpha/common.proto.rst
@@ -149,6 +150,7 @@ PROTO_RST="
   /envoy/type/matcher/value/envoy/type/matcher/value.proto.rst
   /envoy/type/matcher/number/envoy/type/matcher/number.proto.rst
   /envoy/type/matcher/string/envoy/type/matcher/string.proto.rst
+  /envoy/type/matcher/regex/envoy/type/matcher/regex.proto.rst
 "
 
 # Dump all the generated RST so they can be added to PROTO_RST easily.
@@ -53,6 +53,12 @@ public:
    */
   virtual SysCallSizeResult recvfrom(int sockfd, void* buffer, size_t length, int flags,
                                      struct sockaddr* addr, socklen_t* addrlen) PURE;
+
+  /**
+   * @see sendmsg (man 2 sendmsg)
+   */
+  virtual SysCallSizeResult sendmsg(int sockfd, const msghdr* message, int flags) PURE;
+
   /**
    * Release all resources allocated for fd.
    * @return zero on success, -1 returned otherwise.
@@ -5,6 +5,7 @@
 #endif
 
 #include <sched.h>
+#include <sys/socket.h>
 
 #include "envoy/api/os_sys_calls_common.h"
 #include "envoy/common/pure.h"
@@ -20,6 +21,24 @@ public:
    * @see sched_getaffinity (man 2 sched_getaffinity)
    */
   virtual SysCallIntResult sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask) PURE;
+
+  /**
+   * @see sched_setaffinity (man 2 sched_setaffinity)
+   */
+  virtual SysCallIntResult sched_setaffinity(pid_t pid, size_t cpusetsize,
+                                             const cpu_set_t* mask) PURE;
+
+  /**
+   * @see recvmmsg (man 2 recvmmsg)
+   */
+  virtual SysCallIntResult recvmmsg(int sockfd, mmsghdr* messages, unsigned int length, int flags,
+                                    timespec* timeout) PURE;
+
+  /**
+   * @see sendmmsg (man 2 sendmmsg)
+   */
+  virtual SysCallIntResult sendmmsg(int sockfd, mmsghdr* messages, unsigned int length,
+                                    int flags) PURE;
 };
 
 typedef std::unique_ptr<LinuxOsSysCalls> LinuxOsSysCallsPtr;
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "envoy/common/pure.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Regex {
+
+/**
+ * A compiled regex expression matcher which uses an abstract regex engine.
+ */
+class CompiledMatcher {
+public:
+  virtual ~CompiledMatcher() = default;
+
+  /**
+   * @return whether the value matches the compiled regex expression. The entire value must match.
+   */
+  virtual bool match(absl::string_view value) const PURE;
+};
+
+typedef std::unique_ptr<const CompiledMatcher> CompiledMatcherPtr;
+
+/**
+ * A set of compiled regex expressions that are evaluated together, so that finding all the
+ * expressions matching a value costs a single scan of the value regardless of the number of
+ * expressions in the set.
+ */
+class CompiledMatcherSet {
+public:
+  virtual ~CompiledMatcherSet() = default;
+
+  /**
+   * Finds the expressions that match a value. The entire value must match an expression.
+   * @param value supplies the value to match.
+   * @param matches supplies the output vector. On return it contains the indexes (in insertion
+   *        order) of the expressions matching the value, in ascending order.
+   */
+  virtual void match(absl::string_view value, std::vector<int>& matches) const PURE;
+
+  /**
+   * @return the number of expressions in the set.
+   */
+  virtual size_t size() const PURE;
+};
+
+typedef std::unique_ptr<const CompiledMatcherSet> CompiledMatcherSetPtr;
+
+} // namespace Regex
+} // namespace Envoy
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "envoy/common/pure.h"
+#include "envoy/compressor/compressor.h"
+#include "envoy/server/filter_config.h"
+
+#include "common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace Compressor {
+
+/**
+ * Creates the compressors of one content coding, e.g. for each response that an HTTP filter
+ * compresses.
+ */
+class CompressorFactory {
+public:
+  virtual ~CompressorFactory() {}
+
+  /**
+   * @return CompressorPtr a new compressor, ready to compress a stream.
+   */
+  virtual CompressorPtr createCompressor() PURE;
+
+  /**
+   * @return const std::string& the content coding produced by the compressors, as found in the
+   *         Accept-Encoding and Content-Encoding headers, e.g. "gzip".
+   */
+  virtual const std::string& contentEncoding() const PURE;
+};
+
+typedef std::unique_ptr<CompressorFactory> CompressorFactoryPtr;
+
+/**
+ * Implemented by each compressor library and registered via Registry::registerFactory() or the
+ * convenience class RegisterFactory.
+ */
+class NamedCompressorLibraryConfigFactory {
+public:
+  virtual ~NamedCompressorLibraryConfigFactory() {}
+
+  /**
+   * Create the compressor factory of the library from its configuration.
+   * @param config supplies the configuration of the library, as returned by
+   *        createEmptyConfigProto().
+   * @param context supplies the context of the filter using the library, e.g. to read data
+   *        sources.
+   * @return CompressorFactoryPtr the compressor factory.
+   */
+  virtual CompressorFactoryPtr
+  createCompressorFactoryFromProto(const Protobuf::Message& config,
+                                   Server::Configuration::FactoryContext& context) PURE;
+
+  /**
+   * @return ProtobufTypes::MessagePtr an empty configuration of the library.
+   */
+  virtual ProtobufTypes::MessagePtr createEmptyConfigProto() PURE;
+
+  /**
+   * @return std::string the identifying name of the library.
+   */
+  virtual std::string name() PURE;
+};
+
+} // namespace Compressor
+} // namespace Envoy
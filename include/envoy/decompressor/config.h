@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "envoy/common/pure.h"
+#include "envoy/decompressor/decompressor.h"
+#include "envoy/server/filter_config.h"
+
+#include "common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace Decompressor {
+
+/**
+ * Creates the decompressors of one content coding, e.g. for each response that an HTTP filter
+ * decompresses.
+ */
+class DecompressorFactory {
+public:
+  virtual ~DecompressorFactory() {}
+
+  /**
+   * @return DecompressorPtr a new decompressor, ready to decompress a stream.
+   */
+  virtual DecompressorPtr createDecompressor() PURE;
+
+  /**
+   * @return const std::string& the content coding read by the decompressors, as found in the
+   *         Accept-Encoding and Content-Encoding headers, e.g. "gzip".
+   */
+  virtual const std::string& contentEncoding() const PURE;
+};
+
+typedef std::unique_ptr<DecompressorFactory> DecompressorFactoryPtr;
+
+/**
+ * Implemented by each decompressor library and registered via Registry::registerFactory() or the
+ * convenience class RegisterFactory.
+ */
+class NamedDecompressorLibraryConfigFactory {
+public:
+  virtual ~NamedDecompressorLibraryConfigFactory() {}
+
+  /**
+   * Create the decompressor factory of the library from its configuration.
+   * @param config supplies the configuration of the library, as returned by
+   *        createEmptyConfigProto().
+   * @param context supplies the context of the filter using the library, e.g. to read data
+   *        sources.
+   * @return DecompressorFactoryPtr the decompressor factory.
+   */
+  virtual DecompressorFactoryPtr
+  createDecompressorFactoryFromProto(const Protobuf::Message& config,
+                                     Server::Configuration::FactoryContext& context) PURE;
+
+  /**
+   * @return ProtobufTypes::MessagePtr an empty configuration of the library.
+   */
+  virtual ProtobufTypes::MessagePtr createEmptyConfigProto() PURE;
+
+  /**
+   * @return std::string the identifying name of the library.
+   */
+  virtual std::string name() PURE;
+};
+
+} // namespace Decompressor
+} // namespace Envoy
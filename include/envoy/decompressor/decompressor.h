@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include "envoy/buffer/buffer.h"
 
 namespace Envoy {
@@ -16,10 +18,14 @@ public:
    * Decompresses data from one buffer into another buffer.
    * @param input_buffer supplies the buffer with compressed data.
    * @param output_buffer supplies the buffer to output decompressed data.
+   * @return false if the input is not a valid stream, in which case the output is incomplete and
+   *         the decompressor does not output anything more.
    */
-  virtual void decompress(const Buffer::Instance& input_buffer,
+  virtual bool decompress(const Buffer::Instance& input_buffer,
                           Buffer::Instance& output_buffer) PURE;
 };
 
+typedef std::unique_ptr<Decompressor> DecompressorPtr;
+
 } // namespace Decompressor
 } // namespace Envoy
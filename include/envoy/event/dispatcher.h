@@ -17,6 +17,7 @@
 #include "envoy/network/listen_socket.h"
 #include "envoy/network/listener.h"
 #include "envoy/network/transport_socket.h"
+#include "envoy/network/write_batch.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
 #include "envoy/thread/thread.h"
@@ -29,8 +30,11 @@ namespace Event {
  */
 // clang-format off
 #define ALL_DISPATCHER_STATS(HISTOGRAM)                                                            \
+  HISTOGRAM(deferred_delete_size)                                                                  \
   HISTOGRAM(loop_duration_us)                                                                      \
-  HISTOGRAM(poll_delay_us)
+  HISTOGRAM(poll_delay_us)                                                                         \
+  HISTOGRAM(poll_wait_us)                                                                          \
+  HISTOGRAM(post_delay_us)
 // clang-format on
 
 /**
@@ -141,10 +145,10 @@ public:
    * Create a logical udp listener on a specific port.
    * @param socket supplies the socket to listen on.
    * @param cb supplies the udp listener callbacks to invoke for listener events.
-   * @return Network::ListenerPtr a new listener that is owned by the caller.
+   * @return Network::UdpListenerPtr a new listener that is owned by the caller.
    */
-  virtual Network::ListenerPtr createUdpListener(Network::Socket& socket,
-                                                 Network::UdpListenerCallbacks& cb) PURE;
+  virtual Network::UdpListenerPtr createUdpListener(Network::Socket& socket,
+                                                    Network::UdpListenerCallbacks& cb) PURE;
   /**
    * Allocate a timer. @see Timer for docs on how to use the timer.
    * @param cb supplies the callback to invoke when the timer fires.
@@ -199,6 +203,14 @@ public:
    * @return the watermark buffer factory for this dispatcher.
    */
   virtual Buffer::WatermarkFactory& getWatermarkFactory() PURE;
+
+  /**
+   * Returns the batch that connections may queue socket writes in, so that the writes of an event
+   * loop iteration are submitted to the kernel together.
+   * @return Network::WriteBatch* the write batch for this dispatcher, or nullptr if writes should
+   *         be performed directly.
+   */
+  virtual Network::WriteBatch* writeBatch() PURE;
 };
 
 typedef std::unique_ptr<Dispatcher> DispatcherPtr;
@@ -55,6 +55,13 @@ public:
    * stream object and no further callbacks will be invoked.
    */
   virtual void resetStream() PURE;
+
+  /**
+   * @return bool whether the messages sent on the stream are backed up, i.e. the stream is above
+   *         its write buffer high watermark. Callers which can afford to lose messages should stop
+   *         sending until it goes back below.
+   */
+  virtual bool isAboveWriteBufferHighWatermark() const PURE;
 };
 
 class AsyncRequestCallbacks {
@@ -124,7 +131,8 @@ public:
   virtual ProtobufTypes::MessagePtr createEmptyResponse() PURE;
 
   /**
-   * Called when populating the headers to send with initial metadata.
+   * Called when populating the headers to send with initial metadata. Setting the grpc-encoding
+   * metadata to gzip compresses the messages sent on the stream.
    * @param metadata initial metadata reference.
    */
   virtual void onCreateInitialMetadata(Http::HeaderMap& metadata) PURE;
@@ -127,6 +127,12 @@ public:
      * Reset the stream.
      */
     virtual void reset() PURE;
+
+    /***
+     * @return bool whether the data sent on the stream is backed up in the write buffer of the
+     *         upstream connection, i.e. it is above its high watermark.
+     */
+    virtual bool isAboveWriteBufferHighWatermark() const PURE;
   };
 
   virtual ~AsyncClient() {}
@@ -222,6 +222,8 @@ struct Http1Settings {
   bool accept_http_10_{false};
   // Set a default host if no Host: header is present for HTTP/1.0 requests.`
   std::string default_host_for_http_10_;
+  // Parse requests with the vectorized parser rather than http_parser.
+  bool use_vectorized_parser_{false};
 };
 
 /**
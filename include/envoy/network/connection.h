@@ -294,6 +294,18 @@ public:
    */
   virtual std::chrono::milliseconds delayedCloseTimeout() const PURE;
 
+  /**
+   * Provide direct access to the socket of the connection, so that data can be moved between
+   * sockets without going through the connection's buffers and transport socket (e.g. with
+   * splice(2)). This requires a passthrough transport socket, no filter other than the one
+   * consuming the data, and nothing buffered in the connection. The caller must keep reads
+   * disabled while it reads from the socket, and must not write to the connection while it writes
+   * to the socket.
+   * @return IoHandle* the socket of the connection, or nullptr if data cannot bypass the
+   *         connection.
+   */
+  virtual IoHandle* rawIoHandle() PURE;
+
   /**
    * @return std::string the failure reason of the underlying transport socket, if no failure
    *         occurred an empty string is returned.
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/pure.h"
+#include "envoy/network/listen_socket.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * The active listener of a connection handler, which the connections of a listener are balanced
+ * across. Every worker has one per listener.
+ */
+class BalancedConnectionHandler {
+public:
+  virtual ~BalancedConnectionHandler() {}
+
+  /**
+   * @return uint64_t the number of connections of the listener owned by the handler.
+   */
+  virtual uint64_t numConnections() const PURE;
+
+  /**
+   * Increment the number of connections of the listener owned by the handler. Called by the connection balancer on
+   * the handler it picks, while it still holds its lock, so that the count of the target accounts
+   * for the connection before it is posted to the target.
+   */
+  virtual void incNumConnections() PURE;
+
+  /**
+   * Post an accepted socket to the thread of this handler, which accepts it as if its own listener
+   * had accepted it. Used to move connections across workers.
+   * @param socket supplies the socket that is moved into the callee.
+   */
+  virtual void post(ConnectionSocketPtr&& socket) PURE;
+};
+
+/**
+ * Balances the connections accepted by a listener across the handlers of the workers.
+ */
+class ConnectionBalancer {
+public:
+  virtual ~ConnectionBalancer() {}
+
+  /**
+   * Register a handler which connections may be balanced to.
+   */
+  virtual void registerHandler(BalancedConnectionHandler& handler) PURE;
+
+  /**
+   * Unregister a handler, which must not be picked anymore.
+   */
+  virtual void unregisterHandler(BalancedConnectionHandler& handler) PURE;
+
+  /**
+   * Pick the handler of a connection accepted by a handler. The balancer calls incNumConnections()
+   * on the picked handler.
+   * @param current_handler supplies the handler which accepted the connection.
+   * @return BalancedConnectionHandler& current_handler if the connection stays on it, or the
+   *         handler the connection must be posted to.
+   */
+  virtual BalancedConnectionHandler&
+  pickTargetHandler(BalancedConnectionHandler& current_handler) PURE;
+};
+
+typedef std::unique_ptr<ConnectionBalancer> ConnectionBalancerPtr;
+
+} // namespace Network
+} // namespace Envoy
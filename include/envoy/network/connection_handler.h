@@ -9,7 +9,14 @@
 #include "envoy/network/listener.h"
 #include "envoy/ssl/context.h"
 
+#include "spdlog/spdlog.h"
+
 namespace Envoy {
+
+namespace Event {
+class Dispatcher;
+}
+
 namespace Network {
 
 /**
@@ -24,6 +31,18 @@ public:
    */
   virtual uint64_t numConnections() PURE;
 
+  /**
+   * Increment the number of active connections owned by the handler. Used by active listeners
+   * which are not created by the handler itself, such as udp listeners, for the connections they
+   * own.
+   */
+  virtual void incNumConnections() PURE;
+
+  /**
+   * Decrement the number of active connections owned by the handler.
+   */
+  virtual void decNumConnections() PURE;
+
   /**
    * Adds listener to the handler.
    * @param config listener configuration options.
@@ -68,9 +87,58 @@ public:
    * after they have been temporarily disabled.
    */
   virtual void enableListeners() PURE;
+
+  /**
+   * Used by ConnectionHandler to manage listeners.
+   */
+  class ActiveListener {
+  public:
+    virtual ~ActiveListener() {}
+
+    /**
+     * @return the tag value as configured.
+     */
+    virtual uint64_t listenerTag() PURE;
+
+    /**
+     * @return the actual Listener object, or nullptr if the listener has been stopped.
+     */
+    virtual Listener* listener() PURE;
+
+    /**
+     * Destroy the actual Listener it wraps. Connections owned by the active listener are not
+     * closed, which is used for draining.
+     */
+    virtual void destroy() PURE;
+  };
+
+  typedef std::unique_ptr<ActiveListener> ActiveListenerPtr;
 };
 
 typedef std::unique_ptr<ConnectionHandler> ConnectionHandlerPtr;
 
+/**
+ * A registered factory interface to create different kinds of ActiveUdpListener, such as a QUIC
+ * listener which demultiplexes the datagrams of a udp socket into connections.
+ */
+class ActiveUdpListenerFactory {
+public:
+  virtual ~ActiveUdpListenerFactory() {}
+
+  /**
+   * Create an active udp listener and the UdpListener it wraps for a listener config.
+   * @param parent supplies the handler which owns the created active listener.
+   * @param dispatcher supplies the dispatcher used to create the UdpListener.
+   * @param logger supplies the logger of the handler.
+   * @param config supplies the listener config, whose socket is a datagram socket.
+   * @return ConnectionHandler::ActiveListenerPtr the created active listener.
+   */
+  virtual ConnectionHandler::ActiveListenerPtr
+  createActiveUdpListener(ConnectionHandler& parent, Event::Dispatcher& dispatcher,
+                          spdlog::logger& logger, ListenerConfig& config) const PURE;
+};
+
+typedef std::unique_ptr<const ActiveUdpListenerFactory> ActiveUdpListenerFactoryPtr;
+
 } // namespace Network
 } // namespace Envoy
@@ -3,15 +3,21 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "envoy/api/os_sys_calls_common.h"
+#include "envoy/buffer/buffer.h"
 #include "envoy/common/exception.h"
 #include "envoy/network/connection.h"
+#include "envoy/network/connection_balancer.h"
 #include "envoy/network/listen_socket.h"
 #include "envoy/stats/scope.h"
 
 namespace Envoy {
 namespace Network {
 
+class ActiveUdpListenerFactory;
+
 /**
  * A configuration for an individual listener.
  */
@@ -80,6 +86,18 @@ public:
    * @return const std::string& the listener's name.
    */
   virtual const std::string& name() const PURE;
+
+  /**
+   * @return const ActiveUdpListenerFactory* the factory which creates the active listener of a
+   *         listener with a datagram socket, or nullptr for listeners with a stream socket.
+   */
+  virtual const ActiveUdpListenerFactory* udpListenerFactory() PURE;
+
+  /**
+   * @return ConnectionBalancer& the connection balancer to use for the listener, which is shared
+   *         by the connection handlers of all the workers.
+   */
+  virtual ConnectionBalancer& connectionBalancer() PURE;
 };
 
 /**
@@ -125,6 +143,11 @@ struct UdpData {
   // is still being flushed out (Jan, 2019).
 };
 
+/**
+ * Datagrams received by a single read of a udp socket, in the order they were received.
+ */
+typedef std::vector<UdpData> UdpDataBatch;
+
 /**
  * Udp listener callbacks.
  */
@@ -141,6 +164,16 @@ public:
    */
   virtual void onData(const UdpData& data) PURE;
 
+  /**
+   * Called with all datagrams received by a single read of the underlying udp socket, on platforms
+   * where the listener reads datagrams in batches (recvmmsg(2)). onData() is called for every
+   * datagram instead on other platforms. Datagrams coalesced by UDP generic receive offload are
+   * split back into the datagrams sent by the peer.
+   *
+   * @param batch supplies the datagrams. The callee may move the buffers out of the batch.
+   */
+  virtual void onDataBatch(UdpDataBatch& batch) PURE;
+
   /**
    * Called when the underlying socket is ready for write.
    *
@@ -179,6 +212,42 @@ public:
 
 typedef std::unique_ptr<Listener> ListenerPtr;
 
+/**
+ * A datagram to be sent by a udp listener.
+ */
+struct UdpSendData {
+  const Address::Instance& peer_address_;
+  Buffer::Instance& buffer_;
+};
+
+/**
+ * A udp listener, which can send datagrams from the socket it listens on.
+ */
+class UdpListener : public virtual Listener {
+public:
+  virtual ~UdpListener() {}
+
+  /**
+   * Send a datagram to a peer. The buffer is not drained.
+   * @param data supplies the datagram and its destination.
+   * @return Api::SysCallSizeResult the number of bytes sent or the error of the system call.
+   */
+  virtual Api::SysCallSizeResult send(const UdpSendData& data) PURE;
+
+  /**
+   * Send datagrams with as few system calls as possible. On Linux they are sent with sendmmsg(2),
+   * and consecutive datagrams of the same size to the same peer are coalesced with UDP generic
+   * segmentation offload where the kernel supports it. The buffers are not drained.
+   * @param batch supplies the datagrams and their destinations.
+   * @return Api::SysCallIntResult the number of leading datagrams of the batch that were sent,
+   *         which is less than the size of the batch if the socket buffer filled up, or the error
+   *         of the system call if none could be sent.
+   */
+  virtual Api::SysCallIntResult sendBatch(const std::vector<UdpSendData>& batch) PURE;
+};
+
+typedef std::unique_ptr<UdpListener> UdpListenerPtr;
+
 /**
  * Thrown when there is a runtime error creating/binding a listener.
  */
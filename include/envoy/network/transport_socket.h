@@ -81,6 +81,13 @@ public:
    * @param event supplies the connection event
    */
   virtual void raiseEvent(ConnectionEvent event) PURE;
+
+  /**
+   * Run the connection's write path as if the socket had become writable. This is used by a
+   * transport socket whose writes complete outside of doWrite() (e.g. writes queued in a
+   * Network::WriteBatch) to have the completion accounted for.
+   */
+  virtual void flushWriteBuffer() PURE;
 };
 
 /**
@@ -145,6 +152,12 @@ public:
    * @return the const SSL connection data if this is an SSL connection, or nullptr if it is not.
    */
   virtual const Ssl::ConnectionInfo* ssl() const PURE;
+
+  /**
+   * @return bool whether the transport socket reads and writes data on the socket as is, without
+   *         transforming or observing it, so that data may bypass it.
+   */
+  virtual bool passthrough() const PURE;
 };
 
 typedef std::unique_ptr<TransportSocket> TransportSocketPtr;
@@ -171,6 +184,14 @@ public:
    *        not be modified.
    */
   virtual void hashKey(std::vector<uint8_t>& key) const PURE;
+
+  /**
+   * @return bool whether the transport socket may queue its writes in the dispatcher's write
+   *         batch. Writes which are batched are reported as written by a later doWrite() call,
+   *         so a transport socket wrapping another one and inspecting the written bytes must
+   *         create it without batching.
+   */
+  virtual bool allowWriteBatching() const PURE;
 };
 
 typedef std::shared_ptr<TransportSocketOptions> TransportSocketOptionsSharedPtr;
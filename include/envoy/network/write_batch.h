@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/api/io_error.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/pure.h"
+#include "envoy/network/io_handle.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Callbacks for a socket write queued in a WriteBatch.
+ */
+class WriteBatchCallbacks {
+public:
+  virtual ~WriteBatchCallbacks() {}
+
+  /**
+   * Called once the queued write has been performed. Bytes that were written have already been
+   * drained from the buffer passed to WriteBatch::add().
+   * @param result supplies the number of bytes written, or the error of the write.
+   */
+  virtual void onBatchedWrite(Api::IoCallUint64Result&& result) PURE;
+};
+
+/**
+ * Collects socket writes issued by the connections of a dispatcher during an event loop iteration
+ * and performs them together at the end of the iteration, trading one system call per connection
+ * for one system call per batch.
+ */
+class WriteBatch {
+public:
+  virtual ~WriteBatch() {}
+
+  /**
+   * Queue a write of the contents of a buffer. The buffer must not be drained by anyone else until
+   * the write completes or is removed from the batch. Data appended to the buffer in the meantime
+   * may or may not be part of the write.
+   * @param io_handle supplies the socket to write to.
+   * @param buffer supplies the data to write.
+   * @param callbacks supplies the callbacks to invoke once the write is done. A callbacks object
+   *        may only have one write queued at a time.
+   */
+  virtual void add(IoHandle& io_handle, Buffer::Instance& buffer,
+                   WriteBatchCallbacks& callbacks) PURE;
+
+  /**
+   * Remove a queued write, if any. The callbacks will not be invoked.
+   * @param callbacks supplies the callbacks the write was queued with.
+   */
+  virtual void remove(WriteBatchCallbacks& callbacks) PURE;
+};
+
+typedef std::unique_ptr<WriteBatch> WriteBatchPtr;
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+
+#include "envoy/network/connection_handler.h"
+
+#include "common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Interface to create udp listener according to
+ * envoy::api::v2::listener::UdpListenerConfig.udp_listener_name.
+ */
+class ActiveUdpListenerConfigFactory {
+public:
+  virtual ~ActiveUdpListenerConfigFactory() {}
+
+  /**
+   * Create an ActiveUdpListenerFactory object according to given message.
+   * @param message supplies the config of the udp listener, as returned by
+   *        createEmptyConfigProto().
+   * @return Network::ActiveUdpListenerFactoryPtr the factory used by the connection handlers of
+   *         the workers to create the active listeners.
+   * @throw EnvoyException if the config is invalid.
+   */
+  virtual Network::ActiveUdpListenerFactoryPtr
+  createActiveUdpListenerFactory(const Protobuf::Message& message) PURE;
+
+  /**
+   * @return ProtobufTypes::MessagePtr create empty config proto message. The udp listener config,
+   *         which arrives in an opaque google.protobuf.Struct message, will be converted to JSON
+   *         and then parsed into this empty proto.
+   */
+  virtual ProtobufTypes::MessagePtr createEmptyConfigProto() PURE;
+
+  /**
+   * @return std::string the identifying name for a particular implementation of the active udp
+   *         listener produced by the factory.
+   */
+  virtual std::string name() PURE;
+};
+
+} // namespace Server
+} // namespace Envoy
@@ -3,6 +3,7 @@
 #include <chrono>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "envoy/admin/v2alpha/server_info.pb.h"
 #include "envoy/common/pure.h"
@@ -172,6 +173,18 @@ public:
    */
   virtual bool cpusetThreadsEnabled() const PURE;
 
+  /**
+   * @return const std::vector<uint32_t>& the CPUs the worker threads are pinned to, one per worker.
+   *         The worker threads are not pinned if it is empty.
+   */
+  virtual const std::vector<uint32_t>& workerCpuAffinity() const PURE;
+
+  /**
+   * @return const std::vector<uint32_t>& the CPUs the main thread is pinned to. The main thread is
+   *         not pinned if it is empty.
+   */
+  virtual const std::vector<uint32_t>& mainThreadCpuAffinity() const PURE;
+
   /**
    * Converts the Options in to CommandLineOptions proto message defined in server_info.proto.
    * @return CommandLineOptionsPtr the protobuf representation of the options.
@@ -91,9 +91,11 @@ public:
   virtual ~WorkerFactory() {}
 
   /**
+   * @param index supplies the index of the worker, which names its per worker stats.
+   * @param overload_manager supplies the server's overload manager.
    * @return WorkerPtr a new worker.
    */
-  virtual WorkerPtr createWorker(OverloadManager& overload_manager) PURE;
+  virtual WorkerPtr createWorker(uint32_t index, OverloadManager& overload_manager) PURE;
 };
 
 } // namespace Server
@@ -73,6 +73,14 @@ public:
    */
   virtual void setStatsMatcher(StatsMatcherPtr&& stats_matcher) PURE;
 
+  /**
+   * Make counters and gauges created from now on keep a shard per worker thread, which is merged
+   * into the stat when histograms are merged during the flush process. This avoids contention
+   * between workers updating the same stat, at the expense of memory per stat.
+   * @param concurrency the number of worker threads.
+   */
+  virtual void enablePerWorkerStats(uint32_t concurrency) PURE;
+
   /**
    * Initialize the store for threading. This will be called once after all worker threads have
    * been initialized. At this point the store can initialize itself for multi-threaded operation.
@@ -187,6 +187,21 @@ public:
    */
   virtual bool removeCluster(const std::string& cluster) PURE;
 
+  /**
+   * Start a batch of cluster updates. Until endClusterUpdateBatch() is called, the thread local
+   * updates resulting from addOrUpdateCluster() and removeCluster() are queued rather than posted
+   * to the workers one at a time. This avoids flooding the workers with one post per cluster when
+   * a single xDS update adds or removes many clusters. Note that get() does not reflect the
+   * batched changes until the batch ends. Batches do not nest.
+   */
+  virtual void beginClusterUpdateBatch() PURE;
+
+  /**
+   * End a batch of cluster updates started with beginClusterUpdateBatch(). All queued thread local
+   * updates are posted to each worker at once and applied in the order they were made.
+   */
+  virtual void endClusterUpdateBatch() PURE;
+
   /**
    * Shutdown the cluster manager prior to destroying connection pools and other thread local data.
    */
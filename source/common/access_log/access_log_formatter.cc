@@ -27,19 +27,53 @@ namespace {
 // empty.
 StreamInfoFormatter::FieldExtractor sslConnectionInfoStringExtractor(
     std::function<std::string(const Ssl::ConnectionInfo& connection_info)> string_extractor) {
-  return [string_extractor](const StreamInfo::StreamInfo& stream_info) {
+  return [string_extractor](const StreamInfo::StreamInfo& stream_info, std::string& output) {
     if (stream_info.downstreamSslConnection() == nullptr) {
-      return UnspecifiedValueString;
+      output.append(UnspecifiedValueString);
+      return;
     }
 
     const auto value = string_extractor(*stream_info.downstreamSslConnection());
     if (value.empty()) {
-      return UnspecifiedValueString;
+      output.append(UnspecifiedValueString);
     } else {
-      return value;
+      output.append(value);
     }
   };
 }
+
+// Appends the value, or the unspecified value if it is empty.
+void appendOrUnspecified(absl::string_view value, std::string& output) {
+  if (value.empty()) {
+    output.append(UnspecifiedValueString);
+  } else {
+    output.append(value.data(), value.size());
+  }
+}
+
+// Appends an integer without going through a temporary string.
+template <class T> void appendInteger(T value, std::string& output) {
+  const fmt::format_int formatted(value);
+  output.append(formatted.data(), formatted.size());
+}
+
+void appendDuration(const absl::optional<std::chrono::nanoseconds>& time, std::string& output) {
+  if (time) {
+    appendInteger(std::chrono::duration_cast<std::chrono::milliseconds>(time.value()).count(),
+                  output);
+  } else {
+    output.append(UnspecifiedValueString);
+  }
+}
+
+// Appends at most max_length characters of the value.
+void appendTruncated(absl::string_view value, const absl::optional<size_t>& max_length,
+                     std::string& output) {
+  if (max_length && value.length() > max_length.value()) {
+    value = value.substr(0, max_length.value());
+  }
+  output.append(value.data(), value.size());
+}
 } // namespace
 
 const std::string AccessLogFormatUtils::DEFAULT_FORMAT =
@@ -84,12 +118,17 @@ std::string FormatterImpl::format(const Http::HeaderMap& request_headers,
                                   const StreamInfo::StreamInfo& stream_info) const {
   std::string log_line;
   log_line.reserve(256);
+  formatTo(request_headers, response_headers, response_trailers, stream_info, log_line);
+  return log_line;
+}
 
+void FormatterImpl::formatTo(const Http::HeaderMap& request_headers,
+                             const Http::HeaderMap& response_headers,
+                             const Http::HeaderMap& response_trailers,
+                             const StreamInfo::StreamInfo& stream_info, std::string& output) const {
   for (const FormatterProviderPtr& provider : providers_) {
-    log_line += provider->format(request_headers, response_headers, response_trailers, stream_info);
+    provider->formatTo(request_headers, response_headers, response_trailers, stream_info, output);
   }
-
-  return log_line;
 }
 
 JsonFormatterImpl::JsonFormatterImpl(std::unordered_map<std::string, std::string>& format_mapping) {
@@ -122,6 +161,15 @@ std::string JsonFormatterImpl::format(const Http::HeaderMap& request_headers,
   return absl::StrCat(log_line, "\n");
 }
 
+void JsonFormatterImpl::formatTo(const Http::HeaderMap& request_headers,
+                                 const Http::HeaderMap& response_headers,
+                                 const Http::HeaderMap& response_trailers,
+                                 const StreamInfo::StreamInfo& stream_info,
+                                 std::string& output) const {
+  // The fields are serialized through a protobuf Struct, so there is no allocation to save here.
+  output.append(format(request_headers, response_headers, response_trailers, stream_info));
+}
+
 std::unordered_map<std::string, std::string> JsonFormatterImpl::toMap(
     const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
     const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info) const {
@@ -279,108 +327,101 @@ std::vector<FormatterProviderPtr> AccessLogFormatParser::parse(const std::string
 StreamInfoFormatter::StreamInfoFormatter(const std::string& field_name) {
 
   if (field_name == "REQUEST_DURATION") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      return AccessLogFormatUtils::durationToString(stream_info.lastDownstreamRxByteReceived());
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      appendDuration(stream_info.lastDownstreamRxByteReceived(), output);
     };
   } else if (field_name == "RESPONSE_DURATION") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      return AccessLogFormatUtils::durationToString(stream_info.firstUpstreamRxByteReceived());
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      appendDuration(stream_info.firstUpstreamRxByteReceived(), output);
     };
   } else if (field_name == "RESPONSE_TX_DURATION") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
       auto downstream = stream_info.lastDownstreamTxByteSent();
       auto upstream = stream_info.firstUpstreamRxByteReceived();
 
       if (downstream && upstream) {
-        auto val = downstream.value() - upstream.value();
-        return AccessLogFormatUtils::durationToString(val);
+        appendDuration(downstream.value() - upstream.value(), output);
+        return;
       }
 
-      return UnspecifiedValueString;
+      output.append(UnspecifiedValueString);
     };
   } else if (field_name == "BYTES_RECEIVED") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      return fmt::format_int(stream_info.bytesReceived()).str();
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      appendInteger(stream_info.bytesReceived(), output);
     };
   } else if (field_name == "PROTOCOL") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      return AccessLogFormatUtils::protocolToString(stream_info.protocol());
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      output.append(AccessLogFormatUtils::protocolToString(stream_info.protocol()));
     };
   } else if (field_name == "RESPONSE_CODE") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      return stream_info.responseCode() ? fmt::format_int(stream_info.responseCode().value()).str()
-                                        : "0";
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      appendInteger(stream_info.responseCode() ? stream_info.responseCode().value() : 0, output);
     };
   } else if (field_name == "RESPONSE_CODE_DETAILS") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      return stream_info.responseCodeDetails() ? stream_info.responseCodeDetails().value()
-                                               : UnspecifiedValueString;
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      output.append(stream_info.responseCodeDetails() ? stream_info.responseCodeDetails().value()
+                                                      : UnspecifiedValueString);
     };
   } else if (field_name == "BYTES_SENT") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      return fmt::format_int(stream_info.bytesSent()).str();
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      appendInteger(stream_info.bytesSent(), output);
     };
   } else if (field_name == "DURATION") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      return AccessLogFormatUtils::durationToString(stream_info.requestComplete());
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      appendDuration(stream_info.requestComplete(), output);
     };
   } else if (field_name == "RESPONSE_FLAGS") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      return StreamInfo::ResponseFlagUtils::toShortString(stream_info);
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      output.append(StreamInfo::ResponseFlagUtils::toShortString(stream_info));
     };
   } else if (field_name == "UPSTREAM_HOST") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
       if (stream_info.upstreamHost()) {
-        return stream_info.upstreamHost()->address()->asString();
+        output.append(stream_info.upstreamHost()->address()->asString());
       } else {
-        return UnspecifiedValueString;
+        output.append(UnspecifiedValueString);
       }
     };
   } else if (field_name == "UPSTREAM_CLUSTER") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      std::string upstream_cluster_name;
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
       if (nullptr != stream_info.upstreamHost()) {
-        upstream_cluster_name = stream_info.upstreamHost()->cluster().name();
+        appendOrUnspecified(stream_info.upstreamHost()->cluster().name(), output);
+      } else {
+        output.append(UnspecifiedValueString);
       }
-
-      return upstream_cluster_name.empty() ? UnspecifiedValueString : upstream_cluster_name;
     };
   } else if (field_name == "UPSTREAM_LOCAL_ADDRESS") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      return stream_info.upstreamLocalAddress() != nullptr
-                 ? stream_info.upstreamLocalAddress()->asString()
-                 : UnspecifiedValueString;
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      output.append(stream_info.upstreamLocalAddress() != nullptr
+                        ? stream_info.upstreamLocalAddress()->asString()
+                        : UnspecifiedValueString);
     };
   } else if (field_name == "DOWNSTREAM_LOCAL_ADDRESS") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      return stream_info.downstreamLocalAddress()->asString();
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      output.append(stream_info.downstreamLocalAddress()->asString());
     };
   } else if (field_name == "DOWNSTREAM_LOCAL_ADDRESS_WITHOUT_PORT") {
-    field_extractor_ = [](const Envoy::StreamInfo::StreamInfo& stream_info) {
-      return StreamInfo::Utility::formatDownstreamAddressNoPort(
-          *stream_info.downstreamLocalAddress());
+    field_extractor_ = [](const Envoy::StreamInfo::StreamInfo& stream_info, std::string& output) {
+      output.append(StreamInfo::Utility::formatDownstreamAddressNoPort(
+          *stream_info.downstreamLocalAddress()));
     };
   } else if (field_name == "DOWNSTREAM_REMOTE_ADDRESS") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      return stream_info.downstreamRemoteAddress()->asString();
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      output.append(stream_info.downstreamRemoteAddress()->asString());
     };
   } else if (field_name == "DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      return StreamInfo::Utility::formatDownstreamAddressNoPort(
-          *stream_info.downstreamRemoteAddress());
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      output.append(StreamInfo::Utility::formatDownstreamAddressNoPort(
+          *stream_info.downstreamRemoteAddress()));
     };
   } else if (field_name == "REQUESTED_SERVER_NAME") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      if (!stream_info.requestedServerName().empty()) {
-        return stream_info.requestedServerName();
-      } else {
-        return UnspecifiedValueString;
-      }
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      appendOrUnspecified(stream_info.requestedServerName(), output);
     };
   } else if (field_name == "ROUTE_NAME") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      std::string route_name = stream_info.getRouteName();
-      return route_name.empty() ? UnspecifiedValueString : route_name;
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      appendOrUnspecified(stream_info.getRouteName(), output);
     };
   } else if (field_name == "DOWNSTREAM_PEER_URI_SAN") {
     field_extractor_ =
@@ -406,30 +447,36 @@ StreamInfoFormatter::StreamInfoFormatter(const std::string& field_name) {
     field_extractor_ = sslConnectionInfoStringExtractor(
         [](const Ssl::ConnectionInfo& connection_info) { return connection_info.sessionId(); });
   } else if (field_name == "UPSTREAM_TRANSPORT_FAILURE_REASON") {
-    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
-      if (!stream_info.upstreamTransportFailureReason().empty()) {
-        return stream_info.upstreamTransportFailureReason();
-      } else {
-        return UnspecifiedValueString;
-      }
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info, std::string& output) {
+      appendOrUnspecified(stream_info.upstreamTransportFailureReason(), output);
     };
   } else {
     throw EnvoyException(fmt::format("Not supported field in StreamInfo: {}", field_name));
   }
 }
 
-std::string StreamInfoFormatter::format(const Http::HeaderMap&, const Http::HeaderMap&,
-                                        const Http::HeaderMap&,
-                                        const StreamInfo::StreamInfo& stream_info) const {
-  return field_extractor_(stream_info);
+void StreamInfoFormatter::formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                   const Http::HeaderMap&,
+                                   const StreamInfo::StreamInfo& stream_info,
+                                   std::string& output) const {
+  field_extractor_(stream_info, output);
+}
+
+std::string FormatterProviderBase::format(const Http::HeaderMap& request_headers,
+                                          const Http::HeaderMap& response_headers,
+                                          const Http::HeaderMap& response_trailers,
+                                          const StreamInfo::StreamInfo& stream_info) const {
+  std::string value;
+  formatTo(request_headers, response_headers, response_trailers, stream_info, value);
+  return value;
 }
 
 PlainStringFormatter::PlainStringFormatter(const std::string& str) : str_(str) {}
 
-std::string PlainStringFormatter::format(const Http::HeaderMap&, const Http::HeaderMap&,
-                                         const Http::HeaderMap&,
-                                         const StreamInfo::StreamInfo&) const {
-  return str_;
+void PlainStringFormatter::formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                    const Http::HeaderMap&, const StreamInfo::StreamInfo&,
+                                    std::string& output) const {
+  output.append(str_);
 }
 
 HeaderFormatter::HeaderFormatter(const std::string& main_header,
@@ -438,24 +485,22 @@ HeaderFormatter::HeaderFormatter(const std::string& main_header,
     : main_header_(main_header), alternative_header_(alternative_header), max_length_(max_length) {}
 
 std::string HeaderFormatter::format(const Http::HeaderMap& headers) const {
+  std::string header_value_string;
+  formatTo(headers, header_value_string);
+  return header_value_string;
+}
+
+void HeaderFormatter::formatTo(const Http::HeaderMap& headers, std::string& output) const {
   const Http::HeaderEntry* header = headers.get(main_header_);
 
   if (!header && !alternative_header_.get().empty()) {
     header = headers.get(alternative_header_);
   }
 
-  std::string header_value_string;
-  if (!header) {
-    header_value_string = UnspecifiedValueString;
-  } else {
-    header_value_string = std::string(header->value().getStringView());
-  }
-
-  if (max_length_ && header_value_string.length() > max_length_.value()) {
-    return header_value_string.substr(0, max_length_.value());
-  }
-
-  return header_value_string;
+  // The value is appended straight from the header map without an intermediate copy.
+  appendTruncated(header ? header->value().getStringView()
+                         : absl::string_view(UnspecifiedValueString),
+                  max_length_, output);
 }
 
 ResponseHeaderFormatter::ResponseHeaderFormatter(const std::string& main_header,
@@ -463,11 +508,11 @@ ResponseHeaderFormatter::ResponseHeaderFormatter(const std::string& main_header,
                                                  absl::optional<size_t> max_length)
     : HeaderFormatter(main_header, alternative_header, max_length) {}
 
-std::string ResponseHeaderFormatter::format(const Http::HeaderMap&,
-                                            const Http::HeaderMap& response_headers,
-                                            const Http::HeaderMap&,
-                                            const StreamInfo::StreamInfo&) const {
-  return HeaderFormatter::format(response_headers);
+void ResponseHeaderFormatter::formatTo(const Http::HeaderMap&,
+                                       const Http::HeaderMap& response_headers,
+                                       const Http::HeaderMap&, const StreamInfo::StreamInfo&,
+                                       std::string& output) const {
+  HeaderFormatter::formatTo(response_headers, output);
 }
 
 RequestHeaderFormatter::RequestHeaderFormatter(const std::string& main_header,
@@ -475,10 +520,10 @@ RequestHeaderFormatter::RequestHeaderFormatter(const std::string& main_header,
                                                absl::optional<size_t> max_length)
     : HeaderFormatter(main_header, alternative_header, max_length) {}
 
-std::string RequestHeaderFormatter::format(const Http::HeaderMap& request_headers,
-                                           const Http::HeaderMap&, const Http::HeaderMap&,
-                                           const StreamInfo::StreamInfo&) const {
-  return HeaderFormatter::format(request_headers);
+void RequestHeaderFormatter::formatTo(const Http::HeaderMap& request_headers,
+                                      const Http::HeaderMap&, const Http::HeaderMap&,
+                                      const StreamInfo::StreamInfo&, std::string& output) const {
+  HeaderFormatter::formatTo(request_headers, output);
 }
 
 ResponseTrailerFormatter::ResponseTrailerFormatter(const std::string& main_header,
@@ -486,10 +531,10 @@ ResponseTrailerFormatter::ResponseTrailerFormatter(const std::string& main_heade
                                                    absl::optional<size_t> max_length)
     : HeaderFormatter(main_header, alternative_header, max_length) {}
 
-std::string ResponseTrailerFormatter::format(const Http::HeaderMap&, const Http::HeaderMap&,
-                                             const Http::HeaderMap& response_trailers,
-                                             const StreamInfo::StreamInfo&) const {
-  return HeaderFormatter::format(response_trailers);
+void ResponseTrailerFormatter::formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                        const Http::HeaderMap& response_trailers,
+                                        const StreamInfo::StreamInfo&, std::string& output) const {
+  HeaderFormatter::formatTo(response_trailers, output);
 }
 
 MetadataFormatter::MetadataFormatter(const std::string& filter_namespace,
@@ -528,21 +573,23 @@ DynamicMetadataFormatter::DynamicMetadataFormatter(const std::string& filter_nam
                                                    absl::optional<size_t> max_length)
     : MetadataFormatter(filter_namespace, path, max_length) {}
 
-std::string DynamicMetadataFormatter::format(const Http::HeaderMap&, const Http::HeaderMap&,
-                                             const Http::HeaderMap&,
-                                             const StreamInfo::StreamInfo& stream_info) const {
-  return MetadataFormatter::format(stream_info.dynamicMetadata());
+void DynamicMetadataFormatter::formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                        const Http::HeaderMap&,
+                                        const StreamInfo::StreamInfo& stream_info,
+                                        std::string& output) const {
+  output.append(MetadataFormatter::format(stream_info.dynamicMetadata()));
 }
 
 StartTimeFormatter::StartTimeFormatter(const std::string& format) : date_formatter_(format) {}
 
-std::string StartTimeFormatter::format(const Http::HeaderMap&, const Http::HeaderMap&,
-                                       const Http::HeaderMap&,
-                                       const StreamInfo::StreamInfo& stream_info) const {
+void StartTimeFormatter::formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                  const Http::HeaderMap&,
+                                  const StreamInfo::StreamInfo& stream_info,
+                                  std::string& output) const {
   if (date_formatter_.formatString().empty()) {
-    return AccessLogDateTimeFormatter::fromTime(stream_info.startTime());
+    output.append(AccessLogDateTimeFormatter::fromTime(stream_info.startTime()));
   } else {
-    return date_formatter_.fromTime(stream_info.startTime());
+    output.append(date_formatter_.fromTime(stream_info.startTime()));
   }
 }
 
@@ -94,6 +94,9 @@ public:
                      const Http::HeaderMap& response_headers,
                      const Http::HeaderMap& response_trailers,
                      const StreamInfo::StreamInfo& stream_info) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+                std::string& output) const override;
 
 private:
   std::vector<FormatterProviderPtr> providers_;
@@ -108,6 +111,9 @@ public:
                      const Http::HeaderMap& response_headers,
                      const Http::HeaderMap& response_trailers,
                      const StreamInfo::StreamInfo& stream_info) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+                std::string& output) const override;
 
 private:
   std::vector<FormatterProviderPtr> providers_;
@@ -118,17 +124,29 @@ private:
         const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info) const;
 };
 
+/**
+ * Base class for the providers, which implements format() on top of the formatTo() of the provider.
+ */
+class FormatterProviderBase : public FormatterProvider {
+public:
+  // FormatterProvider::format
+  std::string format(const Http::HeaderMap& request_headers,
+                     const Http::HeaderMap& response_headers,
+                     const Http::HeaderMap& response_trailers,
+                     const StreamInfo::StreamInfo& stream_info) const override;
+};
+
 /**
  * Formatter for string literal. It ignores headers and stream info and returns string by which it
  * was initialized.
  */
-class PlainStringFormatter : public FormatterProvider {
+class PlainStringFormatter : public FormatterProviderBase {
 public:
   PlainStringFormatter(const std::string& str);
 
-  // Formatter::format
-  std::string format(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
-                     const StreamInfo::StreamInfo&) const override;
+  // FormatterProvider::format
+  void formatTo(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
+                const StreamInfo::StreamInfo&, std::string& output) const override;
 
 private:
   std::string str_;
@@ -140,6 +158,7 @@ public:
                   absl::optional<size_t> max_length);
 
   std::string format(const Http::HeaderMap& headers) const;
+  void formatTo(const Http::HeaderMap& headers, std::string& output) const;
 
 private:
   Http::LowerCaseString main_header_;
@@ -150,55 +169,63 @@ private:
 /**
  * Formatter based on request header.
  */
-class RequestHeaderFormatter : public FormatterProvider, HeaderFormatter {
+class RequestHeaderFormatter : public FormatterProviderBase, HeaderFormatter {
 public:
   RequestHeaderFormatter(const std::string& main_header, const std::string& alternative_header,
                          absl::optional<size_t> max_length);
 
-  // Formatter::format
-  std::string format(const Http::HeaderMap& request_headers, const Http::HeaderMap&,
-                     const Http::HeaderMap&, const StreamInfo::StreamInfo&) const override;
+  // FormatterProvider::format
+  using FormatterProviderBase::format;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap&,
+                const Http::HeaderMap&, const StreamInfo::StreamInfo&,
+                std::string& output) const override;
 };
 
 /**
  * Formatter based on the response header.
  */
-class ResponseHeaderFormatter : public FormatterProvider, HeaderFormatter {
+class ResponseHeaderFormatter : public FormatterProviderBase, HeaderFormatter {
 public:
   ResponseHeaderFormatter(const std::string& main_header, const std::string& alternative_header,
                           absl::optional<size_t> max_length);
 
-  // Formatter::format
-  std::string format(const Http::HeaderMap&, const Http::HeaderMap& response_headers,
-                     const Http::HeaderMap&, const StreamInfo::StreamInfo&) const override;
+  // FormatterProvider::format
+  using FormatterProviderBase::format;
+  void formatTo(const Http::HeaderMap&, const Http::HeaderMap& response_headers,
+                const Http::HeaderMap&, const StreamInfo::StreamInfo&,
+                std::string& output) const override;
 };
 
 /**
  * Formatter based on the response trailer.
  */
-class ResponseTrailerFormatter : public FormatterProvider, HeaderFormatter {
+class ResponseTrailerFormatter : public FormatterProviderBase, HeaderFormatter {
 public:
   ResponseTrailerFormatter(const std::string& main_header, const std::string& alternative_header,
                            absl::optional<size_t> max_length);
 
-  // Formatter::format
-  std::string format(const Http::HeaderMap&, const Http::HeaderMap&,
-                     const Http::HeaderMap& response_trailers,
-                     const StreamInfo::StreamInfo&) const override;
+  // FormatterProvider::format
+  using FormatterProviderBase::format;
+  void formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo&,
+                std::string& output) const override;
 };
 
 /**
  * Formatter based on the StreamInfo field.
  */
-class StreamInfoFormatter : public FormatterProvider {
+class StreamInfoFormatter : public FormatterProviderBase {
 public:
   StreamInfoFormatter(const std::string& field_name);
 
-  // Formatter::format
-  std::string format(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
-                     const StreamInfo::StreamInfo& stream_info) const override;
+  // FormatterProvider::format
+  void formatTo(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
+                const StreamInfo::StreamInfo& stream_info, std::string& output) const override;
 
-  using FieldExtractor = std::function<std::string(const StreamInfo::StreamInfo&)>;
+  /**
+   * Appends a field of the stream info to the output.
+   */
+  using FieldExtractor = std::function<void(const StreamInfo::StreamInfo&, std::string& output)>;
 
 private:
   FieldExtractor field_extractor_;
@@ -223,24 +250,27 @@ private:
 /**
  * Formatter based on the DynamicMetadata from StreamInfo.
  */
-class DynamicMetadataFormatter : public FormatterProvider, MetadataFormatter {
+class DynamicMetadataFormatter : public FormatterProviderBase, MetadataFormatter {
 public:
   DynamicMetadataFormatter(const std::string& filter_namespace,
                            const std::vector<std::string>& path, absl::optional<size_t> max_length);
 
   // FormatterProvider::format
-  std::string format(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
-                     const StreamInfo::StreamInfo& stream_info) const override;
+  using FormatterProviderBase::format;
+  void formatTo(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
+                const StreamInfo::StreamInfo& stream_info, std::string& output) const override;
 };
 
 /**
  * Formatter
  */
-class StartTimeFormatter : public FormatterProvider {
+class StartTimeFormatter : public FormatterProviderBase {
 public:
   StartTimeFormatter(const std::string& format);
-  std::string format(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
-                     const StreamInfo::StreamInfo&) const override;
+
+  // FormatterProvider::format
+  void formatTo(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
+                const StreamInfo::StreamInfo& stream_info, std::string& output) const override;
 
 private:
   const Envoy::DateFormatter date_formatter_;
@@ -10,6 +10,61 @@
 namespace Envoy {
 namespace AccessLog {
 
+AccessLogFlusher::AccessLogFlusher(Thread::ThreadFactory& thread_factory)
+    : thread_(thread_factory.createThread([this]() -> void { threadRoutine(); })) {}
+
+AccessLogFlusher::~AccessLogFlusher() {
+  {
+    Thread::LockGuard lock(lock_);
+    exit_ = true;
+    pending_event_.notifyOne();
+  }
+  thread_->join();
+}
+
+void AccessLogFlusher::flushLater(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(lock_);
+  pending_files_.push_back(&file);
+  pending_event_.notifyOne();
+}
+
+void AccessLogFlusher::remove(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(lock_);
+  pending_files_.remove(&file);
+  while (flushing_file_ == &file) {
+    flushed_event_.wait(lock_);
+  }
+}
+
+void AccessLogFlusher::threadRoutine() {
+  while (true) {
+    AccessLogFileImpl* file;
+    {
+      Thread::LockGuard lock(lock_);
+      while (pending_files_.empty() && !exit_) {
+        pending_event_.wait(lock_);
+      }
+
+      if (exit_) {
+        return;
+      }
+
+      file = pending_files_.front();
+      pending_files_.pop_front();
+      flushing_file_ = file;
+    }
+
+    // The file cannot be destroyed while it is being flushed, see remove().
+    file->flushFromFlushThread();
+
+    {
+      Thread::LockGuard lock(lock_);
+      flushing_file_ = nullptr;
+      flushed_event_.notifyAll();
+    }
+  }
+}
+
 void AccessLogManagerImpl::reopen() {
   for (auto& access_log : access_logs_) {
     access_log.second->reopen();
@@ -21,23 +76,27 @@ AccessLogFileSharedPtr AccessLogManagerImpl::createAccessLog(const std::string&
     return access_logs_[file_name];
   }
 
+  if (flusher_ == nullptr) {
+    flusher_ = std::make_shared<AccessLogFlusher>(api_.threadFactory());
+  }
+
   access_logs_[file_name] = std::make_shared<AccessLogFileImpl>(
       api_.fileSystem().createFile(file_name), dispatcher_, lock_, file_stats_,
-      file_flush_interval_msec_, api_.threadFactory());
+      file_flush_interval_msec_, flusher_);
   return access_logs_[file_name];
 }
 
 AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                                      Thread::BasicLockable& lock, AccessLogFileStats& stats,
                                      std::chrono::milliseconds flush_interval_msec,
-                                     Thread::ThreadFactory& thread_factory)
+                                     AccessLogFlusherSharedPtr flusher)
     : file_(std::move(file)), file_lock_(lock),
       flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
-        flush_event_.notifyOne();
+        flushLater();
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
-      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {
+      flush_interval_msec_(flush_interval_msec), stats_(stats), flusher_(std::move(flusher)) {
   open();
 }
 
@@ -52,25 +111,21 @@ void AccessLogFileImpl::open() {
 void AccessLogFileImpl::reopen() { reopen_file_ = true; }
 
 AccessLogFileImpl::~AccessLogFileImpl() {
-  {
-    Thread::LockGuard lock(write_lock_);
-    flush_thread_exit_ = true;
-    flush_event_.notifyOne();
-  }
-
-  if (flush_thread_ != nullptr) {
-    flush_thread_->join();
-  }
+  flusher_->remove(*this);
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
+  Thread::LockGuard flush_lock(flush_lock_);
+  moveWriteBuffers();
   if (file_->isOpen()) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
+    if (about_to_write_buffer_.length() > 0) {
+      doWrite(about_to_write_buffer_);
     }
 
     const Api::IoCallBoolResult result = file_->close();
     ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
                                    result.err_->getErrorDetails()));
+  } else {
+    discard(about_to_write_buffer_);
   }
 }
 
@@ -97,96 +152,147 @@ void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
     }
   }
 
-  stats_.write_total_buffered_.sub(buffer.length());
-  buffer.drain(buffer.length());
+  discard(buffer);
 }
 
-void AccessLogFileImpl::flushThreadFunc() {
+void AccessLogFileImpl::discard(Buffer::Instance& buffer) {
+  buffer.drain(buffer.length());
+  releaseWriteBuffers();
+}
 
-  while (true) {
-    std::unique_lock<Thread::BasicLockable> flush_lock;
+void AccessLogFileImpl::moveWriteBuffers() {
+  // The stats are shared by all the files and writers, so the writers count in their write buffer
+  // and the counts are added to the stats here.
+  uint64_t writes_buffered = 0;
+  uint64_t writes_dropped = 0;
+  uint64_t buffered_bytes = 0;
+  for (uint32_t i = 0; i < NUM_WRITE_BUFFERS; i++) {
+    WriteBuffer& write_buffer = write_buffers_[i];
+    Thread::LockGuard lock(write_buffer.lock_);
+    moved_bytes_[i] += write_buffer.buffer_.length();
+    about_to_write_buffer_.move(write_buffer.buffer_);
+    writes_buffered += write_buffer.writes_buffered_;
+    write_buffer.writes_buffered_ = 0;
+    writes_dropped += write_buffer.writes_dropped_;
+    write_buffer.writes_dropped_ = 0;
+    buffered_bytes += write_buffer.buffered_bytes_;
+  }
+  if (writes_buffered > 0) {
+    stats_.write_buffered_.add(writes_buffered);
+  }
+  if (writes_dropped > 0) {
+    stats_.write_dropped_.add(writes_dropped);
+  }
+  ASSERT(buffered_bytes >= published_buffered_bytes_);
+  stats_.write_total_buffered_.add(buffered_bytes - published_buffered_bytes_);
+  published_buffered_bytes_ = buffered_bytes;
+}
 
-    {
-      Thread::LockGuard write_lock(write_lock_);
+void AccessLogFileImpl::releaseWriteBuffers() {
+  // The data moved from the write buffers is written or dropped, so it no longer counts against
+  // their size limit.
+  uint64_t released_bytes = 0;
+  for (uint32_t i = 0; i < NUM_WRITE_BUFFERS; i++) {
+    if (moved_bytes_[i] == 0) {
+      continue;
+    }
+    WriteBuffer& write_buffer = write_buffers_[i];
+    Thread::LockGuard lock(write_buffer.lock_);
+    ASSERT(write_buffer.buffered_bytes_ >= moved_bytes_[i]);
+    write_buffer.buffered_bytes_ -= moved_bytes_[i];
+    released_bytes += moved_bytes_[i];
+    moved_bytes_[i] = 0;
+  }
+  ASSERT(published_buffered_bytes_ >= released_bytes);
+  stats_.write_total_buffered_.sub(released_bytes);
+  published_buffered_bytes_ -= released_bytes;
+}
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_) {
-        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
-        flush_event_.wait(write_lock_);
-      }
+void AccessLogFileImpl::flushFromFlushThread() {
+  Thread::LockGuard flush_lock(flush_lock_);
 
-      if (flush_thread_exit_) {
-        return;
-      }
+  // Data written from now on asks for another flush.
+  flush_pending_ = false;
 
-      flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      ASSERT(flush_buffer_.length() > 0);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
-    }
+  // flushLater() can be called either by large enough write buffers or by timer.
+  // In case it was timer, the write buffers can be empty.
+  moveWriteBuffers();
+  if (about_to_write_buffer_.length() == 0) {
+    return;
+  }
 
-    // if we failed to open file before, then simply ignore
-    if (file_->isOpen()) {
-      try {
-        if (reopen_file_) {
-          reopen_file_ = false;
-          const Api::IoCallBoolResult result = file_->close();
-          ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
-                                         result.err_->getErrorDetails()));
-          open();
-        }
-
-        doWrite(about_to_write_buffer_);
-      } catch (const EnvoyException&) {
-        stats_.reopen_failed_.inc();
+  // if we failed to open file before, then simply drop the data
+  if (file_->isOpen()) {
+    try {
+      if (reopen_file_) {
+        reopen_file_ = false;
+        const Api::IoCallBoolResult result = file_->close();
+        ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
+                                       result.err_->getErrorDetails()));
+        open();
       }
+
+      doWrite(about_to_write_buffer_);
+    } catch (const EnvoyException&) {
+      stats_.reopen_failed_.inc();
+      discard(about_to_write_buffer_);
     }
+  } else {
+    discard(about_to_write_buffer_);
   }
 }
 
 void AccessLogFileImpl::flush() {
-  std::unique_lock<Thread::BasicLockable> flush_buffer_lock;
-
-  {
-    Thread::LockGuard write_lock(write_lock_);
-
-    // flush_lock_ must be held while checking this or else it is
-    // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
-    // but has not yet completed doWrite(). This would allow flush() to
-    // return before the pending data has actually been written to disk.
-    flush_buffer_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-
-    if (flush_buffer_.length() == 0) {
-      return;
-    }
-
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
+  // flush_lock_ is held while checking the write buffers, or else it is possible that the flush
+  // thread has already moved data from them to about_to_write_buffer_ but has not yet completed
+  // doWrite(). This would allow flush() to return before the pending data has actually been
+  // written to disk.
+  Thread::LockGuard flush_lock(flush_lock_);
+
+  moveWriteBuffers();
+  if (about_to_write_buffer_.length() == 0) {
+    return;
   }
 
   doWrite(about_to_write_buffer_);
 }
 
 void AccessLogFileImpl::write(absl::string_view data) {
-  Thread::LockGuard lock(write_lock_);
+  bool flush_buffer;
+  {
+    WriteBuffer& write_buffer = write_buffers_[writeBufferIndex()];
+    Thread::LockGuard lock(write_buffer.lock_);
+    if (write_buffer.buffered_bytes_ + data.length() > MAX_BUFFER_SIZE) {
+      write_buffer.writes_dropped_++;
+      return;
+    }
+    write_buffer.writes_buffered_++;
+    write_buffer.buffered_bytes_ += data.length();
+    write_buffer.buffer_.add(data.data(), data.size());
+    flush_buffer = write_buffer.buffer_.length() > MIN_FLUSH_SIZE;
+  }
 
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
+  // The first write to the file starts the flush timer, and is flushed right away.
+  if (!flush_timer_enabled_ && !flush_timer_enabled_.exchange(true)) {
+    flush_timer_->enableTimer(flush_interval_msec_);
+    flushLater();
+  } else if (flush_buffer) {
+    flushLater();
   }
+}
 
-  stats_.write_buffered_.inc();
-  stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
-    flush_event_.notifyOne();
+void AccessLogFileImpl::flushLater() {
+  if (!flush_pending_ && !flush_pending_.exchange(true)) {
+    flusher_->flushLater(*this);
   }
 }
 
-void AccessLogFileImpl::createFlushStructures() {
-  flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); });
-  flush_timer_->enableTimer(flush_interval_msec_);
+uint32_t AccessLogFileImpl::writeBufferIndex() {
+  // Threads are handed out the write buffers round robin the first time they write, so that the
+  // workers of a process with no more workers than write buffers have a write buffer each.
+  static std::atomic<uint32_t> next_index{};
+  static thread_local const uint32_t index = next_index++ % NUM_WRITE_BUFFERS;
+  return index;
 }
 
 } // namespace AccessLog
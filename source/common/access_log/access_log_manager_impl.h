@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <list>
 #include <string>
 #include <unordered_map>
 
@@ -21,6 +24,7 @@ namespace Envoy {
   COUNTER(write_completed)                                                                         \
   COUNTER(flushed_by_timer)                                                                        \
   COUNTER(reopen_failed)                                                                           \
+  COUNTER(write_dropped)                                                                           \
   GAUGE  (write_total_buffered)
 // clang-format on
 
@@ -30,6 +34,45 @@ struct AccessLogFileStats {
 
 namespace AccessLog {
 
+class AccessLogFileImpl;
+
+/**
+ * A single thread that writes the buffered data of all the access log files of a manager to disk.
+ * Files ask for a flush with flushLater() and the thread flushes them in the order they asked.
+ */
+class AccessLogFlusher {
+public:
+  AccessLogFlusher(Thread::ThreadFactory& thread_factory);
+  ~AccessLogFlusher();
+
+  /**
+   * Ask the flush thread to flush a file. A file asks at most once until the flush thread starts
+   * flushing it.
+   * @param file supplies the file to flush.
+   */
+  void flushLater(AccessLogFileImpl& file);
+
+  /**
+   * Forget about a file which is about to be destroyed. This waits for the flush thread if it is
+   * flushing the file.
+   * @param file supplies the file to forget about.
+   */
+  void remove(AccessLogFileImpl& file);
+
+private:
+  void threadRoutine();
+
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar pending_event_;
+  Thread::CondVar flushed_event_;
+  std::list<AccessLogFileImpl*> pending_files_ GUARDED_BY(lock_);
+  AccessLogFileImpl* flushing_file_ GUARDED_BY(lock_){};
+  bool exit_ GUARDED_BY(lock_){};
+  Thread::ThreadPtr thread_;
+};
+
+using AccessLogFlusherSharedPtr = std::shared_ptr<AccessLogFlusher>;
+
 class AccessLogManagerImpl : public AccessLogManager {
 public:
   AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
@@ -50,22 +93,26 @@ private:
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
   AccessLogFileStats file_stats_;
+  // Created with the first file. The files share it, as they may outlive the manager.
+  AccessLogFlusherSharedPtr flusher_;
   std::unordered_map<std::string, AccessLogFileSharedPtr> access_logs_;
 };
 
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
- * This implementation uses a flush thread per file, with the idea there there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * Writes are therefore buffered and written to disk by the flush thread that all the files of a
+ * manager share. Writers are spread over several buffers, each with its own lock, so that workers
+ * writing to the same file rarely contend. A worker always writes to the same buffer, which keeps
+ * the lines it writes in order. Each buffer tracks the data written to it that is not on disk yet
+ * under its own lock, and data written while too much of it is buffered is dropped.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
   AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                     Thread::BasicLockable& lock, AccessLogFileStats& stats_,
                     std::chrono::milliseconds flush_interval_msec,
-                    Thread::ThreadFactory& thread_factory);
+                    AccessLogFlusherSharedPtr flusher);
   ~AccessLogFileImpl();
 
   // AccessLog::AccessLogFile
@@ -79,56 +126,83 @@ public:
   void reopen() override;
   void flush() override;
 
+  /**
+   * Write the buffered data to disk, reopening the file first if asked to. Called by the flush
+   * thread.
+   */
+  void flushFromFlushThread();
+
 private:
+  struct WriteBuffer {
+    Thread::MutexBasicLockable lock_;
+    Buffer::OwnedImpl buffer_ GUARDED_BY(lock_);
+    // Size of the data written to this buffer which is not written to disk yet, including the
+    // data moved to about_to_write_buffer_.
+    uint64_t buffered_bytes_ GUARDED_BY(lock_){};
+    // Writes buffered and dropped since the flush thread last added them to the stats, which are
+    // shared by all the files and writers.
+    uint64_t writes_buffered_ GUARDED_BY(lock_){};
+    uint64_t writes_dropped_ GUARDED_BY(lock_){};
+  };
+
   void doWrite(Buffer::Instance& buffer);
-  void flushThreadFunc();
+  void discard(Buffer::Instance& buffer);
+  void moveWriteBuffers();
+  void releaseWriteBuffers();
+  void flushLater();
   void open();
-  void createFlushStructures();
+  static uint32_t writeBufferIndex();
 
-  // Minimum size before the flush thread will be told to flush.
+  // Minimum size of a write buffer before the flush thread will be told to flush.
   static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+  // Number of write buffers the writers are spread over.
+  static const uint32_t NUM_WRITE_BUFFERS = 16;
+  // Maximum size of the data buffered for a write buffer, so that at most 16MiB are buffered for
+  // the file. Data written beyond this is dropped.
+  static const uint64_t MAX_BUFFER_SIZE = 1024 * 1024 * 16 / NUM_WRITE_BUFFERS;
 
   Filesystem::FilePtr file_;
 
   // These locks are always acquired in the following order if multiple locks are held:
-  //    1) write_lock_
-  //    2) flush_lock_
+  //    1) flush_lock_
+  //    2) the lock_ of a WriteBuffer
   //    3) file_lock_
-  Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
-                                          // to disk. This is used to make sure that file blocks do
-                                          // not get interleaved by multiple processes writing to
-                                          // the same file during hot-restart.
+  Thread::BasicLockable& file_lock_;      // This lock is used only when writing to disk. This is
+                                          // used to make sure that file blocks do not get
+                                          // interleaved by multiple processes writing to the same
+                                          // file during hot-restart.
   Thread::MutexBasicLockable flush_lock_; // This lock is used to prevent simultaneous flushes from
                                           // the flush thread and a synchronous flush. This protects
                                           // concurrent access to the about_to_write_buffer_, fd_,
                                           // and all other data used during flushing and file
                                           // re-opening.
-  Thread::MutexBasicLockable
-      write_lock_; // The lock is used when filling the flush buffer. It allows
-                   // multiple threads to write to the same file at relatively
-                   // high performance. It is always local to the process.
-  Thread::ThreadPtr flush_thread_;
-  Thread::CondVar flush_event_;
-  std::atomic<bool> flush_thread_exit_{};
+  std::array<WriteBuffer, NUM_WRITE_BUFFERS> write_buffers_; // These buffers are filled by the
+                                                             // writers and then flushed either
+                                                             // when MIN_FLUSH_SIZE is reached or
+                                                             // when a timer fires.
+  std::array<uint64_t, NUM_WRITE_BUFFERS> moved_bytes_{}; // The size of the data moved from each
+                                                         // write buffer to
+                                                         // about_to_write_buffer_, used under
+                                                         // flush_lock_.
+  uint64_t published_buffered_bytes_{}; // The buffered bytes of this file which are included in the
+                                        // write_total_buffered gauge, used under flush_lock_.
+  std::atomic<bool> flush_pending_{};      // Whether the flush thread was asked to flush the file.
+  std::atomic<bool> flush_timer_enabled_{};
   std::atomic<bool> reopen_file_{};
-  Buffer::OwnedImpl
-      flush_buffer_ GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It gets
-                                             // filled and then flushed either when max size is
-                                             // reached or when a timer fires.
   // TODO(jmarantz): this should be GUARDED_BY(flush_lock_) but the analysis cannot poke through
   // the std::make_unique assignment. I do not believe it's possible to annotate this properly now
   // due to limitations in the clang thread annotation analysis.
-  Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
-                                            // continue to fill. This buffer is then used for the
-                                            // final write to disk.
+  Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only while flushing. Data is
+                                            // moved from the write buffers under their locks,
+                                            // which are then released so that they can continue to
+                                            // fill. This buffer is then used for the final write to
+                                            // disk.
   Event::TimerPtr flush_timer_;
-  Thread::ThreadFactory& thread_factory_;
   const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
   AccessLogFileStats& stats_;
+  AccessLogFlusherSharedPtr flusher_;
 };
 
 } // namespace AccessLog
@@ -44,6 +44,11 @@ SysCallSizeResult OsSysCallsImpl::recvfrom(int sockfd, void* buffer, size_t leng
   return {rc, errno};
 }
 
+SysCallSizeResult OsSysCallsImpl::sendmsg(int sockfd, const msghdr* message, int flags) {
+  const ssize_t rc = ::sendmsg(sockfd, message, flags);
+  return {rc, errno};
+}
+
 SysCallIntResult OsSysCallsImpl::ftruncate(int fd, off_t length) {
   const int rc = ::ftruncate(fd, length);
   return {rc, errno};
@@ -6,6 +6,7 @@
 
 #include <errno.h>
 #include <sched.h>
+#include <sys/socket.h>
 
 namespace Envoy {
 namespace Api {
@@ -16,5 +17,23 @@ SysCallIntResult LinuxOsSysCallsImpl::sched_getaffinity(pid_t pid, size_t cpuset
   return {rc, errno};
 }
 
+SysCallIntResult LinuxOsSysCallsImpl::sched_setaffinity(pid_t pid, size_t cpusetsize,
+                                                        const cpu_set_t* mask) {
+  const int rc = ::sched_setaffinity(pid, cpusetsize, mask);
+  return {rc, errno};
+}
+
+SysCallIntResult LinuxOsSysCallsImpl::recvmmsg(int sockfd, mmsghdr* messages, unsigned int length,
+                                               int flags, timespec* timeout) {
+  const int rc = ::recvmmsg(sockfd, messages, length, flags, timeout);
+  return {rc, errno};
+}
+
+SysCallIntResult LinuxOsSysCallsImpl::sendmmsg(int sockfd, mmsghdr* messages, unsigned int length,
+                                               int flags) {
+  const int rc = ::sendmmsg(sockfd, messages, length, flags);
+  return {rc, errno};
+}
+
 } // namespace Api
 } // namespace Envoy
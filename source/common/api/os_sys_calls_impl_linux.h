@@ -15,6 +15,11 @@ class LinuxOsSysCallsImpl : public LinuxOsSysCalls {
 public:
   // Api::LinuxOsSysCalls
   SysCallIntResult sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask) override;
+  SysCallIntResult sched_setaffinity(pid_t pid, size_t cpusetsize, const cpu_set_t* mask) override;
+  SysCallIntResult recvmmsg(int sockfd, mmsghdr* messages, unsigned int length, int flags,
+                            timespec* timeout) override;
+  SysCallIntResult sendmmsg(int sockfd, mmsghdr* messages, unsigned int length,
+                            int flags) override;
 };
 
 typedef ThreadSafeSingleton<LinuxOsSysCallsImpl> LinuxOsSysCallsSingleton;
@@ -0,0 +1,53 @@
+#include "common/common/atomic_token_bucket_impl.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+
+AtomicTokenBucketImpl::AtomicTokenBucketImpl(uint64_t max_tokens, TimeSource& time_source,
+                                             double fill_rate)
+    : max_tokens_(max_tokens), fill_rate_(std::abs(fill_rate)), time_source_(time_source),
+      start_(time_source.monotonicTime()), time_full_(0) {}
+
+double AtomicTokenBucketImpl::now() const {
+  return std::chrono::duration<double>(time_source_.monotonicTime() - start_).count();
+}
+
+uint64_t AtomicTokenBucketImpl::consume(uint64_t tokens, bool allow_partial) {
+  const double now = this->now();
+  double time_full = time_full_.load(std::memory_order_relaxed);
+  uint64_t consumed;
+  double new_time_full;
+  do {
+    const double available = max_tokens_ - std::max(time_full - now, 0.0) * fill_rate_;
+    consumed = allow_partial
+                   ? std::min(tokens, static_cast<uint64_t>(std::floor(std::max(available, 0.0))))
+                   : tokens;
+    if (consumed == 0 || available < consumed) {
+      return 0;
+    }
+    new_time_full = std::max(time_full, now) + consumed / fill_rate_;
+  } while (!time_full_.compare_exchange_weak(time_full, new_time_full, std::memory_order_relaxed));
+  return consumed;
+}
+
+std::chrono::milliseconds AtomicTokenBucketImpl::nextTokenAvailable() {
+  // The bucket holds a token once it is (max_tokens - 1) tokens away from being full.
+  const double wait = time_full_.load(std::memory_order_relaxed) - (max_tokens_ - 1) / fill_rate_ -
+                      now();
+  if (wait <= 0) {
+    return std::chrono::milliseconds(0);
+  }
+  return std::chrono::milliseconds(static_cast<uint64_t>(std::ceil(wait * 1000)));
+}
+
+void AtomicTokenBucketImpl::reset(uint64_t num_tokens) {
+  ASSERT(num_tokens <= max_tokens_);
+  time_full_.store(now() + (max_tokens_ - num_tokens) / fill_rate_, std::memory_order_relaxed);
+}
+
+} // namespace Envoy
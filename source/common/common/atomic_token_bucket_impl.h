@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+
+#include "envoy/common/time.h"
+#include "envoy/common/token_bucket.h"
+
+namespace Envoy {
+
+/**
+ * A token bucket which may be shared by several threads. Unlike TokenBucketImpl, its whole state
+ * is the time at which the bucket will be full again, so that tokens are consumed with a single
+ * compare and swap rather than under a lock.
+ */
+class AtomicTokenBucketImpl : public TokenBucket {
+public:
+  /**
+   * @param max_tokens supplies the maximum number of tokens in the bucket.
+   * @param time_source supplies the time source.
+   * @param fill_rate supplies the number of tokens that will return to the bucket on each second.
+   * The default is 1.
+   */
+  explicit AtomicTokenBucketImpl(uint64_t max_tokens, TimeSource& time_source,
+                                 double fill_rate = 1);
+
+  // TokenBucket
+  uint64_t consume(uint64_t tokens, bool allow_partial) override;
+  std::chrono::milliseconds nextTokenAvailable() override;
+  void reset(uint64_t num_tokens) override;
+
+private:
+  // The number of seconds elapsed since the bucket was created.
+  double now() const;
+
+  const double max_tokens_;
+  const double fill_rate_;
+  TimeSource& time_source_;
+  const MonotonicTime start_;
+  // When the bucket will be full again, in seconds since start_. Consuming tokens pushes it back,
+  // and it is in the past while the bucket is full.
+  std::atomic<double> time_full_;
+};
+
+} // namespace Envoy
@@ -73,7 +73,8 @@ bool StringMatcher::match(const absl::string_view value) const {
   case envoy::type::matcher::StringMatcher::kSuffix:
     return absl::EndsWith(value, matcher_.suffix());
   case envoy::type::matcher::StringMatcher::kRegex:
-    return std::regex_match(value.begin(), value.end(), regex_);
+  case envoy::type::matcher::StringMatcher::kSafeRegex:
+    return regex_->match(value);
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
@@ -94,6 +95,10 @@ LowerCaseStringMatcher::toLowerCase(const envoy::type::matcher::StringMatcher& m
   case envoy::type::matcher::StringMatcher::kRegex:
     lowercase.set_regex(StringUtil::toLower(matcher.regex()));
     break;
+  case envoy::type::matcher::StringMatcher::kSafeRegex:
+    *lowercase.mutable_safe_regex() = matcher.safe_regex();
+    lowercase.mutable_safe_regex()->set_regex(StringUtil::toLower(matcher.safe_regex().regex()));
+    break;
   case envoy::type::matcher::StringMatcher::kExact:
     lowercase.set_exact(StringUtil::toLower(matcher.exact()));
     break;
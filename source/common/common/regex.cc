@@ -0,0 +1,152 @@
+#include "common/common/regex.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/logger.h"
+#include "common/common/utility.h"
+#include "common/protobuf/utility.h"
+
+#include "re2/re2.h"
+#include "re2/set.h"
+
+namespace Envoy {
+namespace Regex {
+namespace {
+
+// Matches the RE2 default program size documented in the RegexMatcher API.
+constexpr uint32_t DefaultMaxProgramSize = 100;
+
+class CompiledStdMatcher : public CompiledMatcher {
+public:
+  CompiledStdMatcher(std::regex&& regex) : regex_(std::move(regex)) {}
+
+  // CompiledMatcher
+  bool match(absl::string_view value) const override {
+    return std::regex_match(value.begin(), value.end(), regex_);
+  }
+
+private:
+  const std::regex regex_;
+};
+
+RE2::Options googleReOptions() {
+  RE2::Options options;
+  // Errors are surfaced as exceptions below; do not spam the log.
+  options.set_log_errors(false);
+  return options;
+}
+
+void checkProgramSize(const std::string& regex, int program_size,
+                      const envoy::type::matcher::RegexMatcher& config) {
+  const uint32_t max_program_size = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      config.google_re2(), max_program_size, DefaultMaxProgramSize);
+  if (static_cast<uint32_t>(program_size) > max_program_size) {
+    throw EnvoyException(fmt::format("regex '{}' RE2 program size of {} > max program size of {}",
+                                     regex, program_size, max_program_size));
+  }
+}
+
+class CompiledGoogleReMatcher : public CompiledMatcher {
+public:
+  CompiledGoogleReMatcher(const envoy::type::matcher::RegexMatcher& config)
+      : regex_(config.regex(), googleReOptions()) {
+    if (!regex_.ok()) {
+      throw EnvoyException(fmt::format("Invalid regex '{}': {}", config.regex(), regex_.error()));
+    }
+    checkProgramSize(config.regex(), regex_.ProgramSize(), config);
+  }
+
+  // CompiledMatcher
+  bool match(absl::string_view value) const override {
+    return re2::RE2::FullMatch(re2::StringPiece(value.data(), value.size()), regex_);
+  }
+
+private:
+  const re2::RE2 regex_;
+};
+
+class CompiledGoogleReMatcherSet : public CompiledMatcherSet {
+public:
+  CompiledGoogleReMatcherSet(const std::vector<envoy::type::matcher::RegexMatcher>& configs)
+      : set_(googleReOptions(), RE2::ANCHOR_BOTH) {
+    for (const auto& config : configs) {
+      ASSERT(config.engine_type_case() == envoy::type::matcher::RegexMatcher::kGoogleRe2);
+      // Compile each expression on its own first so that errors and program size limits are
+      // reported per expression, exactly as for a standalone matcher. The expressions are kept to
+      // match without the set when its DFA runs out of memory.
+      matchers_.push_back(std::make_unique<const CompiledGoogleReMatcher>(config));
+      std::string error;
+      const int index = set_.Add(re2::StringPiece(config.regex()), &error);
+      if (index < 0) {
+        throw EnvoyException(fmt::format("Invalid regex '{}': {}", config.regex(), error));
+      }
+    }
+    if (!set_.Compile()) {
+      throw EnvoyException("unable to compile regex set: out of memory");
+    }
+  }
+
+  // CompiledMatcherSet
+  void match(absl::string_view value, std::vector<int>& matches) const override {
+    matches.clear();
+    re2::RE2::Set::ErrorInfo error_info;
+    if (set_.Match(re2::StringPiece(value.data(), value.size()), &matches, &error_info)) {
+      // RE2::Set does not guarantee any order for the matching indexes.
+      std::sort(matches.begin(), matches.end());
+      return;
+    }
+    if (error_info.kind != re2::RE2::Set::kOutOfMemory) {
+      return;
+    }
+    // The set has no NFA to fall back to, unlike a single RE2, so failing to match would look like
+    // no expression matching. Match the expressions one by one instead.
+    if (!logged_out_of_memory_.exchange(true)) {
+      ENVOY_LOG_MISC(warn,
+                     "regex set of {} expressions ran out of memory, matching them one by one",
+                     matchers_.size());
+    }
+    matches.clear();
+    for (size_t i = 0; i < matchers_.size(); i++) {
+      if (matchers_[i]->match(value)) {
+        matches.push_back(i);
+      }
+    }
+  }
+  size_t size() const override { return matchers_.size(); }
+
+private:
+  re2::RE2::Set set_;
+  std::vector<std::unique_ptr<const CompiledGoogleReMatcher>> matchers_;
+  // Whether running out of memory was logged, which is done once per set as it may recur for
+  // every match.
+  mutable std::atomic<bool> logged_out_of_memory_{};
+};
+
+} // namespace
+
+std::regex Utility::parseStdRegex(const std::string& regex, std::regex::flag_type flags) {
+  return RegexUtil::parseRegex(regex, flags);
+}
+
+CompiledMatcherPtr Utility::parseStdRegexAsCompiledMatcher(const std::string& regex) {
+  return std::make_unique<CompiledStdMatcher>(parseStdRegex(regex));
+}
+
+CompiledMatcherPtr Utility::parseRegex(const envoy::type::matcher::RegexMatcher& matcher) {
+  // Google Re is the only currently supported engine.
+  ASSERT(matcher.has_google_re2());
+  return std::make_unique<CompiledGoogleReMatcher>(matcher);
+}
+
+CompiledMatcherSetPtr
+Utility::parseRegexSet(const std::vector<envoy::type::matcher::RegexMatcher>& matchers) {
+  return std::make_unique<CompiledGoogleReMatcherSet>(matchers);
+}
+
+} // namespace Regex
+} // namespace Envoy
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "envoy/common/regex.h"
+#include "envoy/type/matcher/regex.pb.h"
+
+namespace Envoy {
+namespace Regex {
+
+/**
+ * Utilities for constructing compiled regex matchers.
+ */
+class Utility {
+public:
+  /**
+   * Constructs a std::regex, converting any std::regex_error exception into an EnvoyException.
+   * @param regex std::string containing the regular expression to parse.
+   * @param flags std::regex::flag_type containing parser flags. Defaults to std::regex::optimize.
+   * @return std::regex constructed from regex and flags.
+   * @throw EnvoyException if the regex string is invalid.
+   */
+  static std::regex parseStdRegex(const std::string& regex,
+                                  std::regex::flag_type flags = std::regex::optimize);
+
+  /**
+   * Constructs a std::regex based compiled matcher.
+   * @throw EnvoyException if the regex string is invalid.
+   */
+  static CompiledMatcherPtr parseStdRegexAsCompiledMatcher(const std::string& regex);
+
+  /**
+   * Construct a compiled regex matcher from a match config.
+   * @throw EnvoyException if the regex string is invalid or exceeds the configured program size.
+   */
+  static CompiledMatcherPtr parseRegex(const envoy::type::matcher::RegexMatcher& matcher);
+
+  /**
+   * Compiles a set of match configs into a single matcher. The expressions are evaluated together
+   * so a miss costs one scan of the input instead of one scan per expression.
+   * @throw EnvoyException if any regex string is invalid or exceeds the configured program size.
+   */
+  static CompiledMatcherSetPtr
+  parseRegexSet(const std::vector<envoy::type::matcher::RegexMatcher>& matchers);
+};
+
+} // namespace Regex
+} // namespace Envoy
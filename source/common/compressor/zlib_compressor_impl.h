@@ -2,6 +2,7 @@
 
 #include "envoy/compressor/compressor.h"
 
+#include "absl/strings/string_view.h"
 #include "zlib.h"
 
 namespace Envoy {
@@ -64,6 +65,23 @@ public:
   void init(CompressionLevel level, CompressionStrategy strategy, int64_t window_bits,
             uint64_t memory_level);
 
+  /**
+   * Resets an initialized compressor, so that it compresses a new stream with the parameters given
+   * to init() while keeping the memory allocated by zlib. Any output of the previous stream which
+   * has not been flushed yet is discarded.
+   */
+  void reset();
+
+  /**
+   * Primes the history buffer of the compressor with a preset dictionary, i.e. data which is
+   * likely to appear in the input. It must be called after init() or reset() and before
+   * compressing any data, and the stream can only be decompressed with the same dictionary. zlib
+   * copies the dictionary, so it does not need to outlive the call. Dictionaries are not
+   * supported by gzip streams, i.e. when window_bits is greater than 15.
+   * @param dictionary supplies the dictionary. Only its last 2^window_bits bytes are used.
+   */
+  void setDictionary(absl::string_view dictionary);
+
   /**
    * It returns the checksum of all output produced so far. Compressor's checksum at the end of the
    * stream has to match decompressor's checksum produced at the end of the decompression.
@@ -34,8 +34,12 @@ void ZlibDecompressorImpl::init(int64_t window_bits) {
 
 uint64_t ZlibDecompressorImpl::checksum() { return zstream_ptr_->adler; }
 
-void ZlibDecompressorImpl::decompress(const Buffer::Instance& input_buffer,
+bool ZlibDecompressorImpl::decompress(const Buffer::Instance& input_buffer,
                                       Buffer::Instance& output_buffer) {
+  if (failed_) {
+    return false;
+  }
+
   const uint64_t num_slices = input_buffer.getRawSlices(nullptr, 0);
   STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
   input_buffer.getRawSlices(slices.begin(), num_slices);
@@ -47,7 +51,6 @@ void ZlibDecompressorImpl::decompress(const Buffer::Instance& input_buffer,
       if (zstream_ptr_->avail_out == 0) {
         output_buffer.add(static_cast<void*>(chunk_char_ptr_.get()),
                           chunk_size_ - zstream_ptr_->avail_out);
-        chunk_char_ptr_ = std::make_unique<unsigned char[]>(chunk_size_);
         zstream_ptr_->avail_out = chunk_size_;
         zstream_ptr_->next_out = chunk_char_ptr_.get();
       }
@@ -57,7 +60,11 @@ void ZlibDecompressorImpl::decompress(const Buffer::Instance& input_buffer,
   const uint64_t n_output{chunk_size_ - zstream_ptr_->avail_out};
   if (n_output > 0) {
     output_buffer.add(static_cast<void*>(chunk_char_ptr_.get()), n_output);
+    // The output has been copied, so the next call starts over at the beginning of the chunk.
+    zstream_ptr_->avail_out = chunk_size_;
+    zstream_ptr_->next_out = chunk_char_ptr_.get();
   }
+  return !failed_;
 }
 
 bool ZlibDecompressorImpl::inflateNext() {
@@ -73,6 +80,21 @@ bool ZlibDecompressorImpl::inflateNext() {
     return false; // This means that zlib needs more input, so stop here.
   }
 
+  if (result == Z_NEED_DICT && !dictionary_.empty()) {
+    // zlib rejects a dictionary whose checksum is not the one the stream asks for.
+    failed_ = inflateSetDictionary(zstream_ptr_.get(),
+                                   reinterpret_cast<const Bytef*>(dictionary_.data()),
+                                   dictionary_.size()) != Z_OK;
+    return !failed_;
+  }
+
+  if (result == Z_DATA_ERROR || result == Z_NEED_DICT) {
+    // The input is not a valid stream, which may come from a peer, so the output ends here rather
+    // than crashing, and the caller is told about it.
+    failed_ = true;
+    return false;
+  }
+
   RELEASE_ASSERT(result == Z_OK, "");
   return true;
 }
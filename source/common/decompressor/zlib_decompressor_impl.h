@@ -2,6 +2,7 @@
 
 #include "envoy/decompressor/decompressor.h"
 
+#include "absl/strings/string_view.h"
 #include "zlib.h"
 
 namespace Envoy {
@@ -32,6 +33,13 @@ public:
    */
   void init(int64_t window_bits);
 
+  /**
+   * Sets the preset dictionary which the stream was compressed with. zlib streams name their
+   * dictionary by its Adler-32 checksum, and the output ends if the dictionary does not match.
+   * @param dictionary supplies the dictionary, which must outlive the decompressor.
+   */
+  void setDictionary(absl::string_view dictionary) { dictionary_ = dictionary; }
+
   /**
    * It returns the checksum of all output produced so far. Decompressor's checksum at the end of
    * the stream has to match compressor's checksum produced at the end of the compression.
@@ -41,13 +49,15 @@ public:
   uint64_t checksum();
 
   // Decompressor
-  void decompress(const Buffer::Instance& input_buffer, Buffer::Instance& output_buffer) override;
+  bool decompress(const Buffer::Instance& input_buffer, Buffer::Instance& output_buffer) override;
 
 private:
   bool inflateNext();
 
   const uint64_t chunk_size_;
   bool initialized_;
+  bool failed_{};
+  absl::string_view dictionary_;
 
   std::unique_ptr<unsigned char[]> chunk_char_ptr_;
   std::unique_ptr<z_stream, std::function<void(z_stream*)>> zstream_ptr_;
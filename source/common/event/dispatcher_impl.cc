@@ -20,8 +20,10 @@
 #include "common/filesystem/watcher_impl.h"
 #include "common/network/connection_impl.h"
 #include "common/network/dns_impl.h"
+#include "common/network/io_uring_impl.h"
 #include "common/network/listener_impl.h"
 #include "common/network/udp_listener_impl.h"
+#include "common/runtime/runtime_impl.h"
 
 #include "event2/event.h"
 
@@ -42,6 +44,7 @@ DispatcherImpl::DispatcherImpl(Buffer::WatermarkFactoryPtr&& factory, Api::Api&
 DispatcherImpl::~DispatcherImpl() {}
 
 void DispatcherImpl::initializeStats(Stats::Scope& scope, const std::string& prefix) {
+  stamp_posts_ = true;
   // This needs to be run in the dispatcher's thread, so that we have a thread id to log.
   post([this, &scope, prefix] {
     stats_prefix_ = prefix + "dispatcher";
@@ -62,6 +65,9 @@ void DispatcherImpl::clearDeferredDeleteList() {
   }
 
   ENVOY_LOG(trace, "clearing deferred deletion list (size={})", num_to_delete);
+  if (stats_ != nullptr) {
+    stats_->deferred_delete_size_.recordValue(num_to_delete);
+  }
 
   // Swap the current deletion vector so that if we do deferred delete while we are deleting, we
   // use the other vector. We will get another callback to delete that vector.
@@ -127,10 +133,10 @@ DispatcherImpl::createListener(Network::Socket& socket, Network::ListenerCallbac
                                                         hand_off_restored_destination_connections)};
 }
 
-Network::ListenerPtr DispatcherImpl::createUdpListener(Network::Socket& socket,
-                                                       Network::UdpListenerCallbacks& cb) {
+Network::UdpListenerPtr DispatcherImpl::createUdpListener(Network::Socket& socket,
+                                                          Network::UdpListenerCallbacks& cb) {
   ASSERT(isThreadSafe());
-  return Network::ListenerPtr{new Network::UdpListenerImpl(*this, socket, cb)};
+  return Network::UdpListenerPtr{new Network::UdpListenerImpl(*this, socket, cb)};
 }
 
 TimerPtr DispatcherImpl::createTimer(TimerCb cb) {
@@ -147,6 +153,17 @@ void DispatcherImpl::deferredDelete(DeferredDeletablePtr&& to_delete) {
   }
 }
 
+Network::WriteBatch* DispatcherImpl::writeBatch() {
+  ASSERT(isThreadSafe());
+  if (!write_batch_initialized_) {
+    write_batch_initialized_ = true;
+    if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.io_uring_write_batching")) {
+      write_batch_ = Network::IoUringWriteBatchImpl::create(*this);
+    }
+  }
+  return write_batch_.get();
+}
+
 void DispatcherImpl::exit() { base_scheduler_.loopExit(); }
 
 SignalEventPtr DispatcherImpl::listenForSignal(int signal_num, SignalCb cb) {
@@ -155,11 +172,15 @@ SignalEventPtr DispatcherImpl::listenForSignal(int signal_num, SignalCb cb) {
 }
 
 void DispatcherImpl::post(std::function<void()> callback) {
+  absl::optional<MonotonicTime> posted_time;
+  if (stamp_posts_) {
+    posted_time = api_.timeSource().monotonicTime();
+  }
   bool do_post;
   {
     Thread::LockGuard lock(post_lock_);
     do_post = post_callbacks_.empty();
-    post_callbacks_.push_back(callback);
+    post_callbacks_.push_back(PostCallback{callback, posted_time});
   }
 
   if (do_post) {
@@ -186,7 +207,7 @@ void DispatcherImpl::runPostCallbacks() {
     // re-assigned, which happens while holding the lock. This can lead to a deadlock (via
     // recursive mutex acquisition) if destroying the callback runs a destructor, which through some
     // callstack calls post() on this dispatcher.
-    std::function<void()> callback;
+    PostCallback callback;
     {
       Thread::LockGuard lock(post_lock_);
       if (post_callbacks_.empty()) {
@@ -195,7 +216,12 @@ void DispatcherImpl::runPostCallbacks() {
       callback = post_callbacks_.front();
       post_callbacks_.pop_front();
     }
-    callback();
+    if (stats_ != nullptr && callback.posted_time_.has_value()) {
+      const auto delay = std::chrono::duration_cast<std::chrono::microseconds>(
+          api_.timeSource().monotonicTime() - callback.posted_time_.value());
+      stats_->post_delay_us_.recordValue(delay.count());
+    }
+    callback.callback_();
   }
 }
 
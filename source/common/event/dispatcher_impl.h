@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -18,6 +19,8 @@
 #include "common/event/libevent.h"
 #include "common/event/libevent_scheduler.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Event {
 
@@ -56,8 +59,8 @@ public:
   Network::ListenerPtr createListener(Network::Socket& socket, Network::ListenerCallbacks& cb,
                                       bool bind_to_port,
                                       bool hand_off_restored_destination_connections) override;
-  Network::ListenerPtr createUdpListener(Network::Socket& socket,
-                                         Network::UdpListenerCallbacks& cb) override;
+  Network::UdpListenerPtr createUdpListener(Network::Socket& socket,
+                                            Network::UdpListenerCallbacks& cb) override;
   TimerPtr createTimer(TimerCb cb) override;
   void deferredDelete(DeferredDeletablePtr&& to_delete) override;
   void exit() override;
@@ -65,8 +68,16 @@ public:
   void post(std::function<void()> callback) override;
   void run(RunType type) override;
   Buffer::WatermarkFactory& getWatermarkFactory() override { return *buffer_factory_; }
+  Network::WriteBatch* writeBatch() override;
 
 private:
+  struct PostCallback {
+    std::function<void()> callback_;
+    // When the callback was posted, for the post_delay_us stat. It is only stamped once the stats
+    // are initialized, so that posting does not read the clock otherwise.
+    absl::optional<MonotonicTime> posted_time_;
+  };
+
   void runPostCallbacks();
 
   // Validate that an operation is thread safe, i.e. it's invoked on the same thread that the
@@ -77,6 +88,8 @@ private:
   Api::Api& api_;
   std::string stats_prefix_;
   std::unique_ptr<DispatcherStats> stats_;
+  // Set by initializeStats(), which may run on another thread than the posting ones.
+  std::atomic<bool> stamp_posts_{};
   Thread::ThreadIdPtr run_tid_;
   Buffer::WatermarkFactoryPtr buffer_factory_;
   LibeventScheduler base_scheduler_;
@@ -87,8 +100,11 @@ private:
   std::vector<DeferredDeletablePtr> to_delete_2_;
   std::vector<DeferredDeletablePtr>* current_to_delete_;
   Thread::MutexBasicLockable post_lock_;
-  std::list<std::function<void()>> post_callbacks_ GUARDED_BY(post_lock_);
+  std::list<PostCallback> post_callbacks_ GUARDED_BY(post_lock_);
   bool deferred_deleting_{};
+  // Created on first use, as the runtime is not loaded yet when the dispatchers are created.
+  Network::WriteBatchPtr write_batch_;
+  bool write_batch_initialized_{};
 };
 
 } // namespace Event
@@ -90,6 +90,12 @@ void AsyncStreamImpl::initialize(bool buffer_body_for_retry) {
                                         header_value.value());
   }
   callbacks_.onCreateInitialMetadata(headers_message_->headers());
+  const Http::HeaderEntry* grpc_encoding =
+      headers_message_->headers().get(Http::Headers::get().GrpcEncoding);
+  if (grpc_encoding != nullptr &&
+      grpc_encoding->value().getStringView() == Http::Headers::get().GrpcEncodingValues.Gzip) {
+    compressor_ = Common::createCompressor(CompressionAlgorithm::Gzip);
+  }
   stream_->sendHeaders(headers_message_->headers(), false);
 }
 
@@ -177,7 +183,11 @@ void AsyncStreamImpl::onReset() {
 }
 
 void AsyncStreamImpl::sendMessage(const Protobuf::Message& request, bool end_stream) {
-  stream_->sendData(*Common::serializeToGrpcFrame(request), end_stream);
+  if (compressor_ != nullptr) {
+    stream_->sendData(*Common::serializeToCompressedGrpcFrame(request, *compressor_), end_stream);
+  } else {
+    stream_->sendData(*Common::serializeToGrpcFrame(request), end_stream);
+  }
 }
 
 void AsyncStreamImpl::closeStream() {
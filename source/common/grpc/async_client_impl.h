@@ -3,6 +3,7 @@
 #include "envoy/grpc/async_client.h"
 
 #include "common/common/linked_object.h"
+#include "common/compressor/zlib_compressor_impl.h"
 #include "common/grpc/codec.h"
 #include "common/http/async_client_impl.h"
 
@@ -58,6 +59,9 @@ public:
   void sendMessage(const Protobuf::Message& request, bool end_stream) override;
   void closeStream() override;
   void resetStream() override;
+  bool isAboveWriteBufferHighWatermark() const override {
+    return stream_ && stream_->isAboveWriteBufferHighWatermark();
+  }
 
   bool hasResetStream() const { return http_reset_; }
 
@@ -78,6 +82,8 @@ private:
   bool http_reset_{};
   Http::AsyncClient::Stream* stream_{};
   Decoder decoder_;
+  // Set when the initial metadata asks for compressed messages.
+  std::unique_ptr<Compressor::ZlibCompressorImpl> compressor_;
   // This is a member to avoid reallocation on every onData().
   std::vector<Frame> decoded_frames_;
 
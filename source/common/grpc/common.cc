@@ -138,6 +138,29 @@ Buffer::InstancePtr Common::serializeToGrpcFrame(const Protobuf::Message& messag
   return body;
 }
 
+Buffer::InstancePtr
+Common::serializeToCompressedGrpcFrame(const Protobuf::Message& message,
+                                       Compressor::ZlibCompressorImpl& compressor) {
+  Buffer::InstancePtr body = serializeMessage(message);
+  compressor.compress(*body, Compressor::State::Finish);
+  compressor.reset();
+
+  std::array<uint8_t, GRPC_FRAME_HEADER_SIZE> header;
+  Encoder().newFrame(GRPC_FH_COMPRESSED, body->length(), header);
+  body->prepend(absl::string_view(reinterpret_cast<const char*>(header.data()), header.size()));
+  return body;
+}
+
+std::unique_ptr<Compressor::ZlibCompressorImpl>
+Common::createCompressor(CompressionAlgorithm algorithm) {
+  ASSERT(algorithm == CompressionAlgorithm::Gzip);
+  auto compressor = std::make_unique<Compressor::ZlibCompressorImpl>();
+  // The largest window and the default memory level of zlib, with the gzip header.
+  compressor->init(Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
+                   Compressor::ZlibCompressorImpl::CompressionStrategy::Standard, 15 | 16, 8);
+  return compressor;
+}
+
 Buffer::InstancePtr Common::serializeMessage(const Protobuf::Message& message) {
   auto body = std::make_unique<Buffer::OwnedImpl>();
   const uint32_t size = message.ByteSize();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include "envoy/common/exception.h"
@@ -9,6 +10,8 @@
 #include "envoy/http/header_map.h"
 #include "envoy/http/message.h"
 
+#include "common/compressor/zlib_compressor_impl.h"
+#include "common/grpc/codec.h"
 #include "common/grpc/status.h"
 #include "common/protobuf/protobuf.h"
 
@@ -123,6 +126,22 @@ public:
    */
   static Buffer::InstancePtr serializeToGrpcFrame(const Protobuf::Message& message);
 
+  /**
+   * Serialize protobuf message into a compressed gRPC frame, flagged as compressed.
+   * @param message supplies the message.
+   * @param compressor supplies the compressor, which is reset for the next message afterwards.
+   */
+  static Buffer::InstancePtr
+  serializeToCompressedGrpcFrame(const Protobuf::Message& message,
+                                 Compressor::ZlibCompressorImpl& compressor);
+
+  /**
+   * Create a compressor for serializeToCompressedGrpcFrame().
+   * @param algorithm supplies the compression algorithm. It must not be CompressionAlgorithm::None.
+   */
+  static std::unique_ptr<Compressor::ZlibCompressorImpl>
+  createCompressor(CompressionAlgorithm algorithm);
+
   /**
    * Serialize protobuf message. Without grpc header.
    */
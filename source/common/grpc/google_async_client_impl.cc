@@ -153,6 +153,15 @@ void GoogleAsyncStreamImpl::initialize(bool /*buffer_body_for_retry*/) {
   // copy headers here.
   Http::HeaderMapImpl initial_metadata;
   callbacks_.onCreateInitialMetadata(initial_metadata);
+  // The library compresses the messages itself and sets the grpc-encoding metadata.
+  const Http::HeaderEntry* grpc_encoding =
+      initial_metadata.get(Http::Headers::get().GrpcEncoding);
+  if (grpc_encoding != nullptr) {
+    if (grpc_encoding->value().getStringView() == Http::Headers::get().GrpcEncodingValues.Gzip) {
+      ctxt_.set_compression_algorithm(GRPC_COMPRESS_GZIP);
+    }
+    initial_metadata.remove(Http::Headers::get().GrpcEncoding);
+  }
   initial_metadata.iterate(
       [](const Http::HeaderEntry& header, void* ctxt) {
         auto* client_context = static_cast<grpc::ClientContext*>(ctxt);
@@ -197,6 +206,7 @@ void GoogleAsyncStreamImpl::sendMessage(const Protobuf::Message& request, bool e
   write_pending_queue_.emplace(request, end_stream);
   ENVOY_LOG(trace, "Queued message to write ({} bytes)",
             write_pending_queue_.back().buf_.value().Length());
+  bytes_in_write_pending_queue_ += write_pending_queue_.back().buf_.value().Length();
   writeQueued();
 }
 
@@ -299,6 +309,7 @@ void GoogleAsyncStreamImpl::handleOpCompletion(GoogleAsyncTag::Operation op, boo
   case GoogleAsyncTag::Operation::Write: {
     ASSERT(ok);
     write_pending_ = false;
+    bytes_in_write_pending_queue_ -= write_pending_queue_.front().buf_.value().Length();
     write_pending_queue_.pop();
     writeQueued();
     break;
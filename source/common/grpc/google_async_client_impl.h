@@ -207,6 +207,9 @@ public:
   void sendMessage(const Protobuf::Message& request, bool end_stream) override;
   void closeStream() override;
   void resetStream() override;
+  bool isAboveWriteBufferHighWatermark() const override {
+    return bytes_in_write_pending_queue_ > WriteBufferHighWatermark;
+  }
 
 protected:
   bool call_failed() const { return call_failed_; }
@@ -276,6 +279,10 @@ private:
   grpc::ClientContext ctxt_;
   std::unique_ptr<grpc::GenericClientAsyncReaderWriter> rw_;
   std::queue<PendingMessage> write_pending_queue_;
+  // The bytes of the messages in write_pending_queue_, and the bytes above which the stream is
+  // backed up.
+  uint64_t bytes_in_write_pending_queue_{};
+  static constexpr uint64_t WriteBufferHighWatermark = 1024 * 1024;
   grpc::ByteBuffer read_buf_;
   grpc::Status status_;
   // Has Operation::Init completed?
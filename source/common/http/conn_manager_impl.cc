@@ -407,6 +407,12 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
       upstream_options_(std::make_shared<Network::Socket::Options>()) {
   connection_manager_.stats_.named_.downstream_rq_total_.inc();
   connection_manager_.stats_.named_.downstream_rq_active_.inc();
+  if (connection_manager_.runtime_.snapshot().runtimeFeatureEnabled(
+          "envoy.reloadable_features.http_header_map_arena")) {
+    // Slabs are only allocated on first use, so streams without trailers added by filters do not
+    // pay for more than the arena itself.
+    header_map_arena_ = std::make_shared<HeaderMapArena>();
+  }
   if (connection_manager_.codec_->protocol() == Protocol::Http2) {
     connection_manager_.stats_.named_.downstream_rq_http2_total_.inc();
   } else {
@@ -985,7 +991,7 @@ HeaderMap& ConnectionManagerImpl::ActiveStream::addDecodedTrailers() {
   // Trailers can only be added once.
   ASSERT(!request_trailers_);
 
-  request_trailers_ = std::make_unique<HeaderMapImpl>();
+  request_trailers_ = std::make_unique<HeaderMapImpl>(header_map_arena_);
   return *request_trailers_;
 }
 
@@ -1378,7 +1384,7 @@ HeaderMap& ConnectionManagerImpl::ActiveStream::addEncodedTrailers() {
   // Trailers can only be added once.
   ASSERT(!response_trailers_);
 
-  response_trailers_ = std::make_unique<HeaderMapImpl>();
+  response_trailers_ = std::make_unique<HeaderMapImpl>(header_map_arena_);
   return *response_trailers_;
 }
 
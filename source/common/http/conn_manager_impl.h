@@ -29,6 +29,7 @@
 #include "common/common/linked_object.h"
 #include "common/grpc/common.h"
 #include "common/http/conn_manager_config.h"
+#include "common/http/header_map_arena.h"
 #include "common/http/user_agent.h"
 #include "common/http/utility.h"
 #include "common/stream_info/stream_info_impl.h"
@@ -493,6 +494,10 @@ private:
     Router::ConfigConstSharedPtr snapped_route_config_;
     Tracing::SpanPtr active_span_;
     const uint64_t stream_id_;
+    // Backs the header maps created by the connection manager for this stream when arena
+    // allocation is enabled. The codec allocates the maps it receives from its own per stream
+    // arena.
+    HeaderMapArenaSharedPtr header_map_arena_;
     StreamEncoder* response_encoder_{};
     HeaderMapPtr continue_headers_;
     HeaderMapPtr response_headers_;
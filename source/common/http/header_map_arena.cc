@@ -0,0 +1,69 @@
+#include "common/http/header_map_arena.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Http {
+
+constexpr uint32_t HeaderMapArena::DefaultInitialSlabSize;
+constexpr uint32_t HeaderMapArena::MaxSlabSize;
+
+HeaderMapArena::HeaderMapArena(uint32_t initial_slab_size)
+    : next_slab_size_(alignedSize(std::max<size_t>(initial_slab_size, sizeof(FreeBlock)))) {}
+
+size_t HeaderMapArena::alignedSize(size_t size) {
+  constexpr size_t alignment = alignof(std::max_align_t);
+  return (std::max(size, sizeof(FreeBlock)) + alignment - 1) & ~(alignment - 1);
+}
+
+void HeaderMapArena::newSlab(size_t min_size) {
+  const size_t slab_size = std::max(next_slab_size_, min_size);
+  // Slabs grow geometrically so that streams with many headers still only hit the heap a
+  // logarithmic number of times, up to a cap to bound the memory wasted at the tail of a slab.
+  next_slab_size_ = std::min<size_t>(next_slab_size_ * 2, MaxSlabSize);
+
+  // The unused tail of the current slab is abandoned; it is reclaimed with the arena.
+  slabs_.emplace_back(new char[slab_size]);
+  current_ = slabs_.back().get();
+  remaining_ = slab_size;
+  bytes_reserved_ += slab_size;
+}
+
+void* HeaderMapArena::allocate(size_t size) {
+  size = alignedSize(size);
+  for (auto& free_list : free_lists_) {
+    if (free_list.first == size && free_list.second != nullptr) {
+      FreeBlock* block = free_list.second;
+      free_list.second = block->next_;
+      return block;
+    }
+  }
+
+  if (size > remaining_) {
+    newSlab(size);
+  }
+  void* block = current_;
+  current_ += size;
+  remaining_ -= size;
+  return block;
+}
+
+void HeaderMapArena::deallocate(void* block, size_t size) {
+  ASSERT(block != nullptr);
+  size = alignedSize(size);
+  FreeBlock* free_block = static_cast<FreeBlock*>(block);
+  for (auto& free_list : free_lists_) {
+    if (free_list.first == size) {
+      free_block->next_ = free_list.second;
+      free_list.second = free_block;
+      return;
+    }
+  }
+  free_block->next_ = nullptr;
+  free_lists_.emplace_back(size, free_block);
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "common/common/non_copyable.h"
+
+#include "absl/container/inlined_vector.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * Slab allocator backing the header entries of the header maps of a single stream. Memory is
+ * carved sequentially out of slabs that are only returned to the heap when the arena is destroyed,
+ * so populating and destroying the header maps of a stream costs a handful of heap allocations
+ * rather than one per header. Blocks released before that (e.g. a header being removed) are kept
+ * on a per size free list and reused by later allocations of the same size.
+ *
+ * The arena is not thread safe. It is shared (via HeaderMapArenaSharedPtr) by the header maps of
+ * a stream, which keep it alive for as long as any of them exists.
+ */
+class HeaderMapArena : NonCopyable {
+public:
+  static constexpr uint32_t DefaultInitialSlabSize = 4096;
+  static constexpr uint32_t MaxSlabSize = 64 * 1024;
+
+  explicit HeaderMapArena(uint32_t initial_slab_size = DefaultInitialSlabSize);
+
+  /**
+   * @param size supplies the number of bytes to allocate.
+   * @return void* a block of at least size bytes aligned for any fundamental type.
+   */
+  void* allocate(size_t size);
+
+  /**
+   * Releases a block previously returned by allocate(). The memory is not returned to the heap
+   * until the arena is destroyed, but it may be handed out again by allocate().
+   * @param block supplies the block to release.
+   * @param size supplies the size the block was allocated with.
+   */
+  void deallocate(void* block, size_t size);
+
+  /**
+   * @return uint64_t the number of slabs allocated from the heap so far. Used for testing.
+   */
+  uint64_t slabCount() const { return slabs_.size(); }
+
+  /**
+   * @return uint64_t the total size of the slabs allocated from the heap so far.
+   */
+  uint64_t bytesReserved() const { return bytes_reserved_; }
+
+private:
+  struct FreeBlock {
+    FreeBlock* next_;
+  };
+
+  static size_t alignedSize(size_t size);
+  void newSlab(size_t min_size);
+
+  std::vector<std::unique_ptr<char[]>> slabs_;
+  char* current_{};
+  size_t remaining_{};
+  size_t next_slab_size_;
+  uint64_t bytes_reserved_{};
+  // Header maps allocate a single node size, so a linear scan of a couple of entries is cheaper
+  // than any kind of map.
+  absl::InlinedVector<std::pair<size_t, FreeBlock*>, 2> free_lists_;
+};
+
+using HeaderMapArenaSharedPtr = std::shared_ptr<HeaderMapArena>;
+
+/**
+ * Standard allocator adapter over a HeaderMapArena. A default constructed allocator (no arena)
+ * allocates from the heap, so containers using it behave exactly as with std::allocator unless an
+ * arena is supplied.
+ */
+template <class T> class HeaderMapArenaAllocator {
+public:
+  using value_type = T;
+
+  HeaderMapArenaAllocator(HeaderMapArena* arena = nullptr) : arena_(arena) {}
+  template <class U>
+  HeaderMapArenaAllocator(const HeaderMapArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    if (arena_ == nullptr) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T*>(arena_->allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (arena_ == nullptr) {
+      ::operator delete(p);
+      return;
+    }
+    arena_->deallocate(p, n * sizeof(T));
+  }
+
+  HeaderMapArena* arena() const { return arena_; }
+
+  template <class U> bool operator==(const HeaderMapArenaAllocator<U>& rhs) const {
+    return arena_ == rhs.arena();
+  }
+  template <class U> bool operator!=(const HeaderMapArenaAllocator<U>& rhs) const {
+    return arena_ != rhs.arena();
+  }
+
+private:
+  HeaderMapArena* arena_;
+};
+
+} // namespace Http
+} // namespace Envoy
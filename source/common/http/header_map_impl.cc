@@ -1,15 +1,21 @@
 #include "common/http/header_map_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <list>
 #include <memory>
 #include <string>
+#include <utility>
+
+#include "envoy/common/exception.h"
 
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
+#include "common/common/fmt.h"
 #include "common/common/utility.h"
 #include "common/singleton/const_singleton.h"
 
+#include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
 
 namespace Envoy {
@@ -253,6 +259,69 @@ template <> bool HeaderMapImpl::HeaderList::isPseudoHeader(const LowerCaseString
   return key.get().c_str()[0] == ':';
 }
 
+HeaderMapImpl::HeaderEntryImpl* HeaderMapImpl::HeaderList::find(absl::string_view key) {
+  if (index_ != nullptr) {
+    auto it = index_->find(key);
+    return it == index_->end() ? nullptr : it->second.front();
+  }
+  for (HeaderEntryImpl& header : headers_) {
+    if (header.key() == key) {
+      return &header;
+    }
+  }
+  return nullptr;
+}
+
+void HeaderMapImpl::HeaderList::remove(absl::string_view key) {
+  if (index_ != nullptr) {
+    auto it = index_->find(key);
+    if (it != index_->end()) {
+      // Erasing the entries updates the index, so work on a copy of the list.
+      const auto entries = it->second;
+      for (HeaderEntryImpl* entry : entries) {
+        erase(entry->entry_);
+      }
+    }
+    return;
+  }
+  for (auto i = headers_.begin(); i != headers_.end();) {
+    if (i->key() == key) {
+      i = erase(i);
+    } else {
+      ++i;
+    }
+  }
+}
+
+void HeaderMapImpl::HeaderList::buildIndex() {
+  index_ = std::make_unique<EntryIndex>();
+  for (HeaderEntryImpl& header : headers_) {
+    addToIndex(header);
+  }
+}
+
+void HeaderMapImpl::HeaderList::addToIndex(HeaderEntryImpl& entry) {
+  auto& entries = (*index_)[entry.key().getStringView()];
+  // Pseudo headers are inserted ahead of regular headers, but entries sharing a key are either all
+  // pseudo headers or all regular headers, so appending keeps the entries of a key in list order.
+  entries.push_back(&entry);
+}
+
+void HeaderMapImpl::HeaderList::removeFromIndex(const HeaderEntryImpl& entry) {
+  auto it = index_->find(entry.key().getStringView());
+  ASSERT(it != index_->end());
+  auto& entries = it->second;
+  entries.erase(std::find(entries.begin(), entries.end(), &entry));
+  if (entries.empty()) {
+    index_->erase(it);
+  } else if (it->first.data() == entry.key().getStringView().data()) {
+    // The key points into the entry being removed, re-key with the key of an entry that remains.
+    auto remaining = std::move(entries);
+    index_->erase(it);
+    index_->emplace(remaining.front()->key().getStringView(), std::move(remaining));
+  }
+}
+
 HeaderMapImpl::HeaderEntryImpl::HeaderEntryImpl(const LowerCaseString& key) : key_(key) {}
 
 HeaderMapImpl::HeaderEntryImpl::HeaderEntryImpl(const LowerCaseString& key, HeaderString&& value)
@@ -275,6 +344,64 @@ void HeaderMapImpl::HeaderEntryImpl::value(const HeaderEntry& header) {
   value(header.value().getStringView());
 }
 
+constexpr size_t HeaderMapImpl::MaxCustomInlineHeaders;
+constexpr size_t HeaderMapImpl::HeaderList::IndexThreshold;
+
+std::vector<LowerCaseString>& HeaderMapImpl::customInlineHeaders() {
+  static auto* custom_headers = new std::vector<LowerCaseString>();
+  return *custom_headers;
+}
+
+bool& HeaderMapImpl::customInlineHeadersFinalized() {
+  static bool finalized = false;
+  return finalized;
+}
+
+void HeaderMapImpl::registerCustomInlineHeader(const LowerCaseString& name) {
+  auto& custom_headers = customInlineHeaders();
+  if (std::find(custom_headers.begin(), custom_headers.end(), name) != custom_headers.end()) {
+    return;
+  }
+
+  // Pseudo-headers are defined by the HTTP/2 specification, so only regular header names, i.e.
+  // RFC 7230 tokens, can be registered.
+  const std::string& header_name = name.get();
+  if (header_name.empty() || header_name[0] == ':') {
+    throw EnvoyException(fmt::format("'{}' is not a valid custom inline header name: it must be a "
+                                     "non-empty header name which is not a pseudo-header",
+                                     header_name));
+  }
+  const auto is_token_char = [](char c) {
+    return absl::ascii_isalnum(c) || absl::string_view("!#$%&'*+-.^_`|~").find(c) !=
+                                         absl::string_view::npos;
+  };
+  if (!std::all_of(header_name.begin(), header_name.end(), is_token_char)) {
+    throw EnvoyException(
+        fmt::format("'{}' is not a valid custom inline header name: it must be a token", header_name));
+  }
+
+#define CHECK_NOT_BUILTIN_INLINE_HEADER(header)                                                    \
+  if (name == Headers::get().header) {                                                             \
+    throw EnvoyException(fmt::format("'{}' is already an inline header", name.get()));             \
+  }
+  ALL_INLINE_HEADERS(CHECK_NOT_BUILTIN_INLINE_HEADER)
+  CHECK_NOT_BUILTIN_INLINE_HEADER(HostLegacy)
+#undef CHECK_NOT_BUILTIN_INLINE_HEADER
+
+  if (customInlineHeadersFinalized()) {
+    throw EnvoyException(fmt::format(
+        "cannot register inline header '{}' after header maps have been used", name.get()));
+  }
+  if (custom_headers.size() == MaxCustomInlineHeaders) {
+    throw EnvoyException(fmt::format("cannot register inline header '{}': at most {} custom inline "
+                                     "headers are supported",
+                                     name.get(), MaxCustomInlineHeaders));
+  }
+  // The lookup table keeps pointers to the names, so the vector must never reallocate.
+  custom_headers.reserve(MaxCustomInlineHeaders);
+  custom_headers.push_back(name);
+}
+
 #define INLINE_HEADER_STATIC_MAP_ENTRY(name)                                                       \
   add(Headers::get().name.get().c_str(), [](HeaderMapImpl& h) -> StaticLookupResponse {            \
     return {&h.inline_headers_.name##_, &Headers::get().name};                                     \
@@ -292,6 +419,21 @@ struct HeaderMapImpl::StaticLookupTable : public TrieLookupTable<EntryCb> {
     add(Headers::get().HostLegacy.get().c_str(), [](HeaderMapImpl& h) -> StaticLookupResponse {
       return {&h.inline_headers_.Host_, &Headers::get().Host};
     });
+
+    // Custom inline headers can no longer be registered once the table has been built.
+    customInlineHeadersFinalized() = true;
+    const auto& custom_headers = customInlineHeaders();
+    const auto custom_header_cbs =
+        customInlineHeaderCbs(std::make_index_sequence<MaxCustomInlineHeaders>());
+    for (size_t i = 0; i < custom_headers.size(); i++) {
+      add(custom_headers[i].get(), custom_header_cbs[i]);
+    }
+  }
+
+  template <size_t... Indexes>
+  static std::array<EntryCb, sizeof...(Indexes)>
+  customInlineHeaderCbs(std::index_sequence<Indexes...>) {
+    return {{&HeaderMapImpl::customInlineHeaderCb<Indexes>...}};
   }
 };
 
@@ -305,7 +447,12 @@ void HeaderMapImpl::appendToHeader(HeaderString& header, absl::string_view data)
   header.append(data.data(), data.size());
 }
 
-HeaderMapImpl::HeaderMapImpl() { memset(&inline_headers_, 0, sizeof(inline_headers_)); }
+HeaderMapImpl::HeaderMapImpl() : HeaderMapImpl(nullptr) {}
+
+HeaderMapImpl::HeaderMapImpl(HeaderMapArenaSharedPtr arena)
+    : arena_(std::move(arena)), headers_(arena_.get()) {
+  memset(&inline_headers_, 0, sizeof(inline_headers_));
+}
 
 HeaderMapImpl::HeaderMapImpl(
     const std::initializer_list<std::pair<LowerCaseString, std::string>>& values)
@@ -363,7 +510,7 @@ void HeaderMapImpl::insertByKey(HeaderString&& key, HeaderString&& value) {
       value.clear();
     }
   } else {
-    std::list<HeaderEntryImpl>::iterator i = headers_.insert(std::move(key), std::move(value));
+    HeaderEntryList::iterator i = headers_.insert(std::move(key), std::move(value));
     i->entry_ = i;
   }
 }
@@ -462,23 +609,19 @@ uint64_t HeaderMapImpl::byteSize() const {
 }
 
 const HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) const {
-  for (const HeaderEntryImpl& header : headers_) {
-    if (header.key() == key.get().c_str()) {
-      return &header;
-    }
-  }
-
-  return nullptr;
+  return const_cast<HeaderMapImpl*>(this)->get(key);
 }
 
 HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) {
-  for (HeaderEntryImpl& header : headers_) {
-    if (header.key() == key.get().c_str()) {
-      return &header;
+  EntryCb cb = ConstSingleton<StaticLookupTable>::get().find(key.get());
+  if (cb) {
+    StaticLookupResponse ref_lookup_response = cb(*this);
+    // The legacy host header is stored as :authority, and must not be returned by its old name.
+    if (ref_lookup_response.key_->get() == key.get()) {
+      return *ref_lookup_response.entry_;
     }
   }
-
-  return nullptr;
+  return headers_.find(key.get());
 }
 
 void HeaderMapImpl::iterate(ConstIterateCb cb, void* context) const {
@@ -526,13 +669,7 @@ void HeaderMapImpl::remove(const LowerCaseString& key) {
     StaticLookupResponse ref_lookup_response = cb(*this);
     removeInline(ref_lookup_response.entry_);
   } else {
-    for (auto i = headers_.begin(); i != headers_.end();) {
-      if (i->key() == key.get().c_str()) {
-        i = headers_.erase(i);
-      } else {
-        ++i;
-      }
-    }
+    headers_.remove(key.get());
   }
 }
 
@@ -560,7 +697,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
     return **entry;
   }
 
-  std::list<HeaderEntryImpl>::iterator i = headers_.insert(key);
+  HeaderEntryList::iterator i = headers_.insert(key);
   i->entry_ = i;
   *entry = &(*i);
   return **entry;
@@ -574,7 +711,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
     return **entry;
   }
 
-  std::list<HeaderEntryImpl>::iterator i = headers_.insert(key, std::move(value));
+  HeaderEntryList::iterator i = headers_.insert(key, std::move(value));
   i->entry_ = i;
   *entry = &(*i);
   return **entry;
@@ -5,12 +5,17 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/http/header_map.h"
 
 #include "common/common/non_copyable.h"
+#include "common/http/header_map_arena.h"
 #include "common/http/headers.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+
 namespace Envoy {
 namespace Http {
 
@@ -45,7 +50,30 @@ public:
    */
   static void appendToHeader(HeaderString& header, absl::string_view data);
 
+  /**
+   * The maximum number of headers that can be registered with registerCustomInlineHeader().
+   */
+  static constexpr size_t MaxCustomInlineHeaders = 16;
+
+  /**
+   * Registers a header that header maps handle like the headers in ALL_INLINE_HEADERS: lookup()
+   * finds it in O(1) and multiple occurrences are coalesced into a single comma separated value.
+   * This must happen before any header map is used (i.e. during bootstrap). Registering the same
+   * header more than once is a no-op.
+   * @param name supplies the name of the header.
+   * @throw EnvoyException if the name is empty, a pseudo-header or not a token, if the header is a
+   *        built in inline header, if the maximum number of custom inline headers would be
+   *        exceeded, or if header maps are already in use.
+   */
+  static void registerCustomInlineHeader(const LowerCaseString& name);
+
   HeaderMapImpl();
+  /**
+   * Creates a header map whose entries are allocated from an arena. The map keeps the arena alive
+   * until it is destroyed, so the arena can be shared by all the header maps of a stream.
+   * @param arena supplies the arena to allocate entries from.
+   */
+  explicit HeaderMapImpl(HeaderMapArenaSharedPtr arena);
   explicit HeaderMapImpl(
       const std::initializer_list<std::pair<LowerCaseString, std::string>>& values);
   explicit HeaderMapImpl(const HeaderMap& rhs) : HeaderMapImpl() { copyFrom(rhs); }
@@ -87,6 +115,9 @@ protected:
   void copyFrom(const HeaderMap& rhs);
   void clear() { removePrefix(LowerCaseString("")); }
 
+  struct HeaderEntryImpl;
+  using HeaderEntryList = std::list<HeaderEntryImpl, HeaderMapArenaAllocator<HeaderEntryImpl>>;
+
   struct HeaderEntryImpl : public HeaderEntry, NonCopyable {
     HeaderEntryImpl(const LowerCaseString& key);
     HeaderEntryImpl(const LowerCaseString& key, HeaderString&& value);
@@ -103,7 +134,7 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+    HeaderEntryList::iterator entry_;
   };
 
   struct StaticLookupResponse {
@@ -113,6 +144,12 @@ protected:
 
   typedef StaticLookupResponse (*EntryCb)(HeaderMapImpl&);
 
+  static std::vector<LowerCaseString>& customInlineHeaders();
+  static bool& customInlineHeadersFinalized();
+  template <size_t Index> static StaticLookupResponse customInlineHeaderCb(HeaderMapImpl& h) {
+    return {&h.custom_inline_headers_[Index], &customInlineHeaders()[Index]};
+  }
+
   /**
    * This is the static lookup table that is used to determine whether a header is one of the O(1)
    * headers. This uses a trie for lookup time at most equal to the size of the incoming string.
@@ -136,28 +173,38 @@ protected:
    */
   class HeaderList : NonCopyable {
   public:
-    HeaderList() : pseudo_headers_end_(headers_.end()) {}
+    explicit HeaderList(HeaderMapArena* arena)
+        : headers_(HeaderMapArenaAllocator<HeaderEntryImpl>(arena)),
+          pseudo_headers_end_(headers_.end()) {}
 
     template <class Key> bool isPseudoHeader(const Key& key) {
       return !key.getStringView().empty() && key.getStringView()[0] == ':';
     }
 
     template <class Key, class... Value>
-    std::list<HeaderEntryImpl>::iterator insert(Key&& key, Value&&... value) {
+    HeaderEntryList::iterator insert(Key&& key, Value&&... value) {
       const bool is_pseudo_header = isPseudoHeader(key);
-      std::list<HeaderEntryImpl>::iterator i =
+      HeaderEntryList::iterator i =
           headers_.emplace(is_pseudo_header ? pseudo_headers_end_ : headers_.end(),
                            std::forward<Key>(key), std::forward<Value>(value)...);
       if (!is_pseudo_header && pseudo_headers_end_ == headers_.end()) {
         pseudo_headers_end_ = i;
       }
+      if (index_ != nullptr) {
+        addToIndex(*i);
+      } else if (headers_.size() > IndexThreshold) {
+        buildIndex();
+      }
       return i;
     }
 
-    std::list<HeaderEntryImpl>::iterator erase(std::list<HeaderEntryImpl>::iterator i) {
+    HeaderEntryList::iterator erase(HeaderEntryList::iterator i) {
       if (pseudo_headers_end_ == i) {
         pseudo_headers_end_++;
       }
+      if (index_ != nullptr) {
+        removeFromIndex(*i);
+      }
       return headers_.erase(i);
     }
 
@@ -168,23 +215,52 @@ protected:
           if (pseudo_headers_end_ == entry.entry_) {
             pseudo_headers_end_++;
           }
+          if (index_ != nullptr) {
+            removeFromIndex(entry);
+          }
         }
         return to_remove;
       });
     }
 
-    std::list<HeaderEntryImpl>::iterator begin() { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::iterator end() { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_iterator begin() const { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::const_iterator end() const { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
+    /**
+     * @return the first entry with the given key, or nullptr if there is none.
+     */
+    HeaderEntryImpl* find(absl::string_view key);
+    const HeaderEntryImpl* find(absl::string_view key) const {
+      return const_cast<HeaderList*>(this)->find(key);
+    }
+
+    /**
+     * Removes all the entries with the given key.
+     */
+    void remove(absl::string_view key);
+
+    HeaderEntryList::iterator begin() { return headers_.begin(); }
+    HeaderEntryList::iterator end() { return headers_.end(); }
+    HeaderEntryList::const_iterator begin() const { return headers_.begin(); }
+    HeaderEntryList::const_iterator end() const { return headers_.end(); }
+    HeaderEntryList::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
+    HeaderEntryList::const_reverse_iterator rend() const { return headers_.rend(); }
     size_t size() const { return headers_.size(); }
     bool empty() const { return headers_.empty(); }
 
   private:
-    std::list<HeaderEntryImpl> headers_;
-    std::list<HeaderEntryImpl>::iterator pseudo_headers_end_;
+    // Lists of entries by key, in list order. The keys point into the key of the first entry.
+    using EntryIndex =
+        absl::flat_hash_map<absl::string_view, absl::InlinedVector<HeaderEntryImpl*, 1>>;
+
+    // For small maps a linear scan is faster than hashing the key, so the index is only built
+    // (and then maintained) once the map grows beyond this size.
+    static constexpr size_t IndexThreshold = 16;
+
+    void buildIndex();
+    void addToIndex(HeaderEntryImpl& entry);
+    void removeFromIndex(const HeaderEntryImpl& entry);
+
+    HeaderEntryList headers_;
+    HeaderEntryList::iterator pseudo_headers_end_;
+    std::unique_ptr<EntryIndex> index_;
   };
 
   void insertByKey(HeaderString&& key, HeaderString&& value);
@@ -195,7 +271,10 @@ protected:
 
   void removeInline(HeaderEntryImpl** entry);
 
+  // Declared before headers_ so that the arena outlives the entries allocated from it.
+  const HeaderMapArenaSharedPtr arena_;
   AllInlineHeaders inline_headers_;
+  std::array<HeaderEntryImpl*, MaxCustomInlineHeaders> custom_inline_headers_{};
   HeaderList headers_;
 
   ALL_INLINE_HEADERS(DEFINE_INLINE_HEADER_FUNCS)
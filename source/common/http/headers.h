@@ -76,6 +76,7 @@ public:
   const LowerCaseString GrpcStatus{"grpc-status"};
   const LowerCaseString GrpcTimeout{"grpc-timeout"};
   const LowerCaseString GrpcAcceptEncoding{"grpc-accept-encoding"};
+  const LowerCaseString GrpcEncoding{"grpc-encoding"};
   const LowerCaseString Host{":authority"};
   const LowerCaseString HostLegacy{"host"};
   const LowerCaseString KeepAlive{"keep-alive"};
@@ -201,6 +202,10 @@ public:
     const std::string Default{"identity,deflate,gzip"};
   } GrpcAcceptEncodingValues;
 
+  struct {
+    const std::string Gzip{"gzip"};
+  } GrpcEncodingValues;
+
   struct {
     const std::string Trailers{"trailers"};
   } TEValues;
@@ -226,6 +231,7 @@ public:
   } AcceptEncodingValues;
 
   struct {
+    const std::string Deflate{"deflate"};
     const std::string Gzip{"gzip"};
   } ContentEncodingValues;
 
@@ -17,6 +17,7 @@
 #include "common/http/codec_helper.h"
 #include "common/http/codes.h"
 #include "common/http/header_map_impl.h"
+#include "common/http/http1/parser.h"
 
 namespace Envoy {
 namespace Http {
@@ -120,7 +121,9 @@ private:
 /**
  * Base class for HTTP/1.1 client and server connections.
  */
-class ConnectionImpl : public virtual Connection, protected Logger::Loggable<Logger::Id::http> {
+class ConnectionImpl : public virtual Connection,
+                       public ParserCallbacks,
+                       protected Logger::Loggable<Logger::Id::http> {
 public:
   /**
    * @return Network::Connection& the backing network connection.
@@ -172,13 +175,17 @@ public:
   bool maybeDirectDispatch(Buffer::Instance& data);
 
 protected:
+  /**
+   * @param use_vectorized_parser supplies whether to parse with VectorizedRequestParser rather
+   *        than http_parser. Only supported for requests.
+   */
   ConnectionImpl(Network::Connection& connection, http_parser_type type,
-                 uint32_t max_request_headers_kb);
+                 uint32_t max_request_headers_kb, bool use_vectorized_parser);
 
   bool resetStreamCalled() { return reset_stream_called_; }
 
   Network::Connection& connection_;
-  http_parser parser_;
+  ParserPtr parser_;
   HeaderMapPtr deferred_end_stream_headers_;
   Http::Code error_code_{Http::Code::BadRequest};
   bool handling_upgrade_{};
@@ -198,53 +205,29 @@ private:
    */
   size_t dispatchSlice(const char* slice, size_t len);
 
-  /**
-   * Called when a request/response is beginning. A base routine happens first then a virtual
-   * dispatch is invoked.
-   */
-  void onMessageBeginBase();
-  virtual void onMessageBegin() PURE;
-
-  /**
-   * Called when URL data is received.
-   * @param data supplies the start address.
-   * @param length supplies the length.
-   */
-  virtual void onUrl(const char* data, size_t length) PURE;
+  // Http1::ParserCallbacks
+  // The base routines for message begin, headers complete and message complete happen first,
+  // then a virtual dispatch is invoked. onUrl() and onBody() are implemented by subclasses.
+  void onMessageBeginBase() override;
+  void onHeaderField(const char* data, size_t length) override;
+  void onHeaderValue(const char* data, size_t length) override;
+  int onHeadersCompleteBase() override;
+  void onMessageCompleteBase() override;
 
   /**
-   * Called when header field data is received.
-   * @param data supplies the start address.
-   * @param length supplies the length.
+   * Called when a request/response is beginning.
    */
-  void onHeaderField(const char* data, size_t length);
-
-  /**
-   * Called when header value data is received.
-   * @param data supplies the start address.
-   * @param length supplies the length.
-   */
-  void onHeaderValue(const char* data, size_t length);
+  virtual void onMessageBegin() PURE;
 
   /**
-   * Called when headers are complete. A base routine happens first then a virtual dispatch is
-   * invoked.
+   * Called when headers are complete.
    * @return 0 if no error, 1 if there should be no body.
    */
-  int onHeadersCompleteBase();
   virtual int onHeadersComplete(HeaderMapImplPtr&& headers) PURE;
 
-  /**
-   * Called when body data is received.
-   * @param data supplies the start address.
-   * @param length supplies the length.
-   */
-  virtual void onBody(const char* data, size_t length) PURE;
-
   /**
    * Called when the request/response is complete.
    */
-  void onMessageCompleteBase();
   virtual void onMessageComplete() PURE;
 
   /**
@@ -269,7 +252,6 @@ private:
    */
   virtual void onBelowLowWatermark() PURE;
 
-  static http_parser_settings settings_;
   static const ToLowerTable& toLowerTable();
 
   HeaderMapImplPtr current_header_map_;
@@ -282,6 +264,8 @@ private:
   char* reserved_current_{};
   Protocol protocol_{Protocol::Http11};
   const uint32_t max_headers_kb_;
+  // Whether the headers of each message are allocated from a per message arena.
+  const bool header_map_arena_enabled_;
 };
 
 /**
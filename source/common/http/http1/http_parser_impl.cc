@@ -0,0 +1,62 @@
+#include "common/http/http1/http_parser_impl.h"
+
+#include <climits>
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+http_parser_settings HttpParserImpl::settings_{
+    [](http_parser* parser) -> int {
+      static_cast<HttpParserImpl*>(parser->data)->callbacks_.onMessageBeginBase();
+      return 0;
+    },
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      static_cast<HttpParserImpl*>(parser->data)->callbacks_.onUrl(at, length);
+      return 0;
+    },
+    nullptr, // on_status
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      static_cast<HttpParserImpl*>(parser->data)->callbacks_.onHeaderField(at, length);
+      return 0;
+    },
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      static_cast<HttpParserImpl*>(parser->data)->callbacks_.onHeaderValue(at, length);
+      return 0;
+    },
+    [](http_parser* parser) -> int {
+      return static_cast<HttpParserImpl*>(parser->data)->callbacks_.onHeadersCompleteBase();
+    },
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      static_cast<HttpParserImpl*>(parser->data)->callbacks_.onBody(at, length);
+      return 0;
+    },
+    [](http_parser* parser) -> int {
+      static_cast<HttpParserImpl*>(parser->data)->callbacks_.onMessageCompleteBase();
+      return 0;
+    },
+    nullptr, // on_chunk_header
+    nullptr  // on_chunk_complete
+};
+
+HttpParserImpl::HttpParserImpl(http_parser_type type, ParserCallbacks& callbacks)
+    : callbacks_(callbacks) {
+  http_parser_init(&parser_, type);
+  parser_.data = this;
+}
+
+size_t HttpParserImpl::execute(const char* data, size_t length) {
+  return http_parser_execute(&parser_, &settings_, data, length);
+}
+
+absl::optional<uint64_t> HttpParserImpl::contentLength() const {
+  // http_parser uses ULLONG_MAX to signal that there is no content length.
+  if (parser_.content_length == ULLONG_MAX) {
+    return absl::nullopt;
+  }
+  return parser_.content_length;
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <http_parser.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Callbacks invoked by a Parser as it makes progress through a message. The data passed to the
+ * data callbacks points into the buffer being parsed and is only valid for the duration of the
+ * call. A single element (URL, header field, etc.) may be delivered in several fragments if it
+ * spans buffer slices.
+ */
+class ParserCallbacks {
+public:
+  virtual ~ParserCallbacks() = default;
+
+  /**
+   * Called when a request/response is beginning.
+   */
+  virtual void onMessageBeginBase() PURE;
+
+  /**
+   * Called when URL data is received.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   */
+  virtual void onUrl(const char* data, size_t length) PURE;
+
+  /**
+   * Called when header field data is received.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   */
+  virtual void onHeaderField(const char* data, size_t length) PURE;
+
+  /**
+   * Called when header value data is received.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   */
+  virtual void onHeaderValue(const char* data, size_t length) PURE;
+
+  /**
+   * Called when headers are complete.
+   * @return 0 if no error, 1 if there should be no body, 2 if no body or further data is expected
+   *         on the connection (upgrade).
+   */
+  virtual int onHeadersCompleteBase() PURE;
+
+  /**
+   * Called when body data is received.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   */
+  virtual void onBody(const char* data, size_t length) PURE;
+
+  /**
+   * Called when the request/response is complete.
+   */
+  virtual void onMessageCompleteBase() PURE;
+};
+
+/**
+ * Incremental HTTP/1.1 parser used by the codec. Error codes and methods use the http_parser
+ * enums so that all implementations report identical errors and method names.
+ */
+class Parser {
+public:
+  virtual ~Parser() = default;
+
+  /**
+   * Parses a span of data, invoking the callbacks as elements are recognized.
+   * @param data supplies the start address.
+   * @param length supplies the length. A length of 0 signals the end of the connection.
+   * @return size_t the number of bytes consumed. Parsing stops early on error or when paused.
+   */
+  virtual size_t execute(const char* data, size_t length) PURE;
+
+  /**
+   * Pauses the parser. May be called from within a callback, in which case execute() returns
+   * after the callback.
+   */
+  virtual void pause() PURE;
+
+  /**
+   * Resumes a paused parser.
+   */
+  virtual void resume() PURE;
+
+  /**
+   * @return http_errno the parser error, HPE_OK or HPE_PAUSED if there is none.
+   */
+  virtual http_errno error() const PURE;
+
+  /**
+   * @return http_method the method of the current request.
+   */
+  virtual http_method method() const PURE;
+
+  /**
+   * @return uint32_t the status code of the current response.
+   */
+  virtual uint32_t statusCode() const PURE;
+
+  /**
+   * @return bool whether the current message is HTTP/1.1.
+   */
+  virtual bool isHttp11() const PURE;
+
+  /**
+   * @return bool whether the current message uses chunked transfer encoding.
+   */
+  virtual bool isChunked() const PURE;
+
+  /**
+   * @return absl::optional<uint64_t> the content length of the current message, if known.
+   */
+  virtual absl::optional<uint64_t> contentLength() const PURE;
+};
+
+using ParserPtr = std::unique_ptr<Parser>;
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,749 @@
+#include "common/http/http1/vectorized_parser.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+
+#include "common/common/assert.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+struct MethodEntry {
+  absl::string_view name_;
+  http_method method_;
+};
+
+const MethodEntry Methods[] = {
+#define METHOD_ENTRY(num, name, string) {#string, HTTP_##name},
+    HTTP_METHOD_MAP(METHOD_ENTRY)
+#undef METHOD_ENTRY
+};
+
+// RFC 7230 section 3.2.6 tchar.
+bool isTokenChar(char c) {
+  switch (c) {
+  case '!':
+  case '#':
+  case '$':
+  case '%':
+  case '&':
+  case '\'':
+  case '*':
+  case '+':
+  case '-':
+  case '.':
+  case '^':
+  case '_':
+  case '`':
+  case '|':
+  case '~':
+    return true;
+  default:
+    return absl::ascii_isalnum(c);
+  }
+}
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  c = absl::ascii_tolower(c);
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+} // namespace
+
+constexpr size_t VectorizedRequestParser::MaxMethodLength;
+constexpr size_t VectorizedRequestParser::MaxFramingHeaderNameLength;
+constexpr size_t VectorizedRequestParser::MaxTransferEncodingLength;
+
+const char* VectorizedRequestParser::findUrlEnd(const char* begin, const char* end) {
+#ifdef __SSE2__
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i first_non_control = _mm_set1_epi8(0x21);
+  const __m128i del = _mm_set1_epi8(0x7f);
+  while (end - begin >= 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+    // The comparisons are signed, so bytes >= 0x80 compare below 0x21 as well and have to be
+    // masked out again.
+    const __m128i control = _mm_andnot_si128(_mm_cmplt_epi8(chunk, zero),
+                                             _mm_cmplt_epi8(chunk, first_non_control));
+    const int mask = _mm_movemask_epi8(_mm_or_si128(control, _mm_cmpeq_epi8(chunk, del)));
+    if (mask != 0) {
+      return begin + __builtin_ctz(mask);
+    }
+    begin += 16;
+  }
+#endif
+  for (; begin < end; ++begin) {
+    const uint8_t c = *begin;
+    if (c <= 0x20 || c == 0x7f) {
+      return begin;
+    }
+  }
+  return end;
+}
+
+const char* VectorizedRequestParser::findLineEnd(const char* begin, const char* end) {
+#ifdef __SSE2__
+  const __m128i cr = _mm_set1_epi8('\r');
+  const __m128i lf = _mm_set1_epi8('\n');
+  while (end - begin >= 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+    const int mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, lf)));
+    if (mask != 0) {
+      return begin + __builtin_ctz(mask);
+    }
+    begin += 16;
+  }
+#endif
+  for (; begin < end; ++begin) {
+    if (*begin == '\r' || *begin == '\n') {
+      return begin;
+    }
+  }
+  return end;
+}
+
+const char* VectorizedRequestParser::findHeaderValueEnd(const char* begin, const char* end) {
+#ifdef __SSE2__
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i space = _mm_set1_epi8(0x20);
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i del = _mm_set1_epi8(0x7f);
+  while (end - begin >= 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+    // The comparisons are signed, so the bytes in (0, 0x20) are the ones above zero and below a
+    // space.
+    const __m128i control = _mm_andnot_si128(
+        _mm_cmpeq_epi8(chunk, tab),
+        _mm_and_si128(_mm_cmpgt_epi8(chunk, zero), _mm_cmplt_epi8(chunk, space)));
+    const int mask = _mm_movemask_epi8(_mm_or_si128(control, _mm_cmpeq_epi8(chunk, del)));
+    if (mask != 0) {
+      return begin + __builtin_ctz(mask);
+    }
+    begin += 16;
+  }
+#endif
+  for (; begin < end; ++begin) {
+    const uint8_t c = *begin;
+    if ((c != 0 && c < 0x20 && c != '\t') || c == 0x7f) {
+      return begin;
+    }
+  }
+  return end;
+}
+
+size_t VectorizedRequestParser::execute(const char* data, size_t length) {
+  if (error_ != HPE_OK || paused_) {
+    return 0;
+  }
+
+  // Resume a message whose headers complete callback paused the parser.
+  if (state_ == State::HeadersDone) {
+    onHeadersDone();
+    if (error_ != HPE_OK || paused_) {
+      return 0;
+    }
+  }
+
+  if (length == 0) {
+    // The connection was closed, which is only expected in between messages.
+    if (state_ != State::MessageStart) {
+      setError(HPE_INVALID_EOF_STATE);
+    }
+    return 0;
+  }
+
+  const char* p = data;
+  const char* const end = data + length;
+  // Start of the URL, header field or header value fragment that is being scanned, if any.
+  const char* mark = nullptr;
+  switch (state_) {
+  case State::UrlScheme:
+  case State::UrlSchemeSlash:
+  case State::UrlSchemeSlashSlash:
+  case State::Url:
+  case State::HeaderField:
+  case State::HeaderValue:
+    mark = data;
+    break;
+  default:
+    break;
+  }
+
+  while (p < end && error_ == HPE_OK && !paused_) {
+    switch (state_) {
+    case State::MessageStart:
+      // Like http_parser, tolerate empty lines in between messages.
+      if (*p == '\r' || *p == '\n') {
+        p++;
+      } else if (*p >= 'A' && *p <= 'Z') {
+        state_ = State::Method;
+        startMessage();
+      } else {
+        setError(HPE_INVALID_METHOD);
+      }
+      break;
+
+    case State::Method:
+      if (*p == ' ') {
+        p++;
+        if (finishMethod()) {
+          state_ = State::SpacesBeforeUrl;
+        }
+      } else if (((*p >= 'A' && *p <= 'Z') || *p == '-') && method_length_ < MaxMethodLength) {
+        method_buffer_[method_length_++] = *p++;
+      } else {
+        setError(HPE_INVALID_METHOD);
+      }
+      break;
+
+    case State::SpacesBeforeUrl:
+      if (*p == ' ') {
+        p++;
+      } else if (findUrlEnd(p, p + 1) == p) {
+        setError(HPE_INVALID_URL);
+      } else {
+        mark = p;
+        // CONNECT targets are in authority form. Otherwise the target has to be an absolute
+        // path, "*" or an absolute URL.
+        if (method_ == HTTP_CONNECT || *p == '/' || *p == '*') {
+          state_ = State::Url;
+        } else if (absl::ascii_isalpha(*p)) {
+          state_ = State::UrlScheme;
+        } else {
+          setError(HPE_INVALID_URL);
+        }
+      }
+      break;
+
+    case State::UrlScheme:
+      if (absl::ascii_isalpha(*p)) {
+        p++;
+      } else if (*p == ':') {
+        p++;
+        state_ = State::UrlSchemeSlash;
+      } else {
+        setError(HPE_INVALID_URL);
+      }
+      break;
+
+    case State::UrlSchemeSlash:
+    case State::UrlSchemeSlashSlash:
+      if (*p != '/') {
+        setError(HPE_INVALID_URL);
+        break;
+      }
+      p++;
+      state_ = state_ == State::UrlSchemeSlash ? State::UrlSchemeSlashSlash : State::Url;
+      break;
+
+    case State::Url:
+      p = findUrlEnd(p, end);
+      if (p == end) {
+        break;
+      }
+      if (p > mark) {
+        callbacks_.onUrl(mark, p - mark);
+      }
+      mark = nullptr;
+      if (*p == ' ') {
+        state_ = State::SpacesBeforeVersion;
+      } else if (*p == '\r' || *p == '\n') {
+        // A request line without a version is an HTTP/0.9 request.
+        http_major_ = 0;
+        http_minor_ = 9;
+        state_ = *p == '\r' ? State::RequestLineLf : State::HeaderLineStart;
+      } else {
+        setError(HPE_INVALID_URL);
+        break;
+      }
+      p++;
+      break;
+
+    case State::SpacesBeforeVersion:
+      if (*p == ' ') {
+        p++;
+      } else if (*p == 'H') {
+        version_index_ = 0;
+        state_ = State::Version;
+      } else {
+        setError(HPE_INVALID_CONSTANT);
+      }
+      break;
+
+    case State::Version: {
+      static constexpr absl::string_view prefix = "HTTP/";
+      if (*p != prefix[version_index_]) {
+        setError(HPE_INVALID_CONSTANT);
+        break;
+      }
+      p++;
+      if (++version_index_ == prefix.size()) {
+        state_ = State::VersionMajor;
+      }
+      break;
+    }
+
+    case State::VersionMajor:
+    case State::VersionMinor:
+      if (!absl::ascii_isdigit(*p)) {
+        setError(HPE_INVALID_VERSION);
+        break;
+      }
+      if (state_ == State::VersionMajor) {
+        http_major_ = *p - '0';
+        state_ = State::VersionDot;
+      } else {
+        http_minor_ = *p - '0';
+        state_ = State::VersionEnd;
+      }
+      p++;
+      break;
+
+    case State::VersionDot:
+      if (*p != '.') {
+        setError(HPE_INVALID_VERSION);
+        break;
+      }
+      p++;
+      state_ = State::VersionMinor;
+      break;
+
+    case State::VersionEnd:
+      if (*p == '\r') {
+        state_ = State::RequestLineLf;
+      } else if (*p == '\n') {
+        state_ = State::HeaderLineStart;
+      } else {
+        setError(HPE_INVALID_VERSION);
+        break;
+      }
+      p++;
+      break;
+
+    case State::RequestLineLf:
+    case State::HeaderLineLf:
+    case State::TrailerLineLf:
+      if (*p != '\n') {
+        setError(HPE_LF_EXPECTED);
+        break;
+      }
+      p++;
+      state_ = state_ == State::TrailerLineLf ? State::TrailerLineStart : State::HeaderLineStart;
+      break;
+
+    case State::HeaderLineStart:
+      if (*p == '\r') {
+        p++;
+        state_ = State::HeadersLf;
+      } else if (*p == '\n') {
+        p++;
+        onHeadersComplete();
+      } else if (isTokenChar(*p)) {
+        // This also rejects obsolete line folding, which starts with whitespace.
+        mark = p;
+        header_name_length_ = 0;
+        state_ = State::HeaderField;
+      } else {
+        setError(HPE_INVALID_HEADER_TOKEN);
+      }
+      break;
+
+    case State::HeaderField:
+      while (p < end && isTokenChar(*p)) {
+        p++;
+      }
+      if (p == end) {
+        break;
+      }
+      if (*p != ':') {
+        setError(HPE_INVALID_HEADER_TOKEN);
+        break;
+      }
+      addHeaderNameFragment(mark, p);
+      if (p > mark) {
+        callbacks_.onHeaderField(mark, p - mark);
+      }
+      mark = nullptr;
+      p++;
+      if (finishHeaderName()) {
+        state_ = State::HeaderValueStart;
+      }
+      break;
+
+    case State::HeaderValueStart:
+      if (*p == ' ' || *p == '\t') {
+        p++;
+      } else {
+        mark = p;
+        state_ = State::HeaderValue;
+      }
+      break;
+
+    case State::HeaderValue:
+      p = findHeaderValueEnd(p, end);
+      if (p == end) {
+        break;
+      }
+      if (*p != '\r' && *p != '\n') {
+        setError(HPE_INVALID_HEADER_TOKEN);
+        break;
+      }
+      // Always deliver the last fragment, even if empty, so that empty values are reported.
+      if (!addHeaderValueFragment(mark, p)) {
+        break;
+      }
+      callbacks_.onHeaderValue(mark, p - mark);
+      mark = nullptr;
+      if (!finishHeaderValue()) {
+        break;
+      }
+      state_ = *p == '\r' ? State::HeaderLineLf : State::HeaderLineStart;
+      p++;
+      break;
+
+    case State::HeadersLf:
+      if (*p != '\n') {
+        setError(HPE_LF_EXPECTED);
+        break;
+      }
+      p++;
+      onHeadersComplete();
+      break;
+
+    case State::HeadersDone:
+      onHeadersDone();
+      break;
+
+    case State::BodyIdentity:
+    case State::ChunkData: {
+      const uint64_t body_length = std::min<uint64_t>(remaining_, end - p);
+      remaining_ -= body_length;
+      p += body_length;
+      callbacks_.onBody(p - body_length, body_length);
+      if (remaining_ == 0) {
+        if (state_ == State::ChunkData) {
+          state_ = State::ChunkDataCr;
+        } else {
+          onMessageComplete();
+        }
+      }
+      break;
+    }
+
+    case State::ChunkSize: {
+      const int value = hexValue(*p);
+      if (value >= 0) {
+        if (remaining_ > (std::numeric_limits<uint64_t>::max() >> 4)) {
+          setError(HPE_INVALID_CHUNK_SIZE);
+          break;
+        }
+        remaining_ = (remaining_ << 4) | value;
+        chunk_size_digits_ = true;
+        p++;
+        break;
+      }
+      if (!chunk_size_digits_) {
+        setError(HPE_INVALID_CHUNK_SIZE);
+        break;
+      }
+      if (*p == ';' || *p == ' ' || *p == '\t') {
+        state_ = State::ChunkExtension;
+      } else if (*p == '\r') {
+        state_ = State::ChunkSizeLf;
+      } else if (*p == '\n') {
+        state_ = remaining_ == 0 ? State::TrailerLineStart : State::ChunkData;
+      } else {
+        setError(HPE_INVALID_CHUNK_SIZE);
+        break;
+      }
+      p++;
+      break;
+    }
+
+    case State::ChunkExtension:
+      // Chunk extensions are ignored.
+      p = findLineEnd(p, end);
+      if (p == end) {
+        break;
+      }
+      if (*p == '\r') {
+        state_ = State::ChunkSizeLf;
+      } else {
+        state_ = remaining_ == 0 ? State::TrailerLineStart : State::ChunkData;
+      }
+      p++;
+      break;
+
+    case State::ChunkSizeLf:
+      if (*p != '\n') {
+        setError(HPE_LF_EXPECTED);
+        break;
+      }
+      p++;
+      state_ = remaining_ == 0 ? State::TrailerLineStart : State::ChunkData;
+      break;
+
+    case State::ChunkDataCr:
+    case State::ChunkDataLf:
+      if (*p == '\r' && state_ == State::ChunkDataCr) {
+        state_ = State::ChunkDataLf;
+      } else if (*p == '\n') {
+        state_ = State::ChunkSize;
+        chunk_size_digits_ = false;
+      } else {
+        setError(state_ == State::ChunkDataCr ? HPE_STRICT : HPE_LF_EXPECTED);
+        break;
+      }
+      p++;
+      break;
+
+    case State::TrailerLineStart:
+      if (*p == '\r') {
+        p++;
+        state_ = State::TrailersLf;
+      } else if (*p == '\n') {
+        p++;
+        onMessageComplete();
+      } else {
+        state_ = State::TrailerLine;
+      }
+      break;
+
+    case State::TrailerLine:
+      // Trailers are not reported, just skip to the end of the line. Their values are validated
+      // like the values of headers.
+      p = findHeaderValueEnd(p, end);
+      if (p == end) {
+        break;
+      }
+      if (*p != '\r' && *p != '\n') {
+        setError(HPE_INVALID_HEADER_TOKEN);
+        break;
+      }
+      state_ = *p == '\r' ? State::TrailerLineLf : State::TrailerLineStart;
+      p++;
+      break;
+
+    case State::TrailersLf:
+      if (*p != '\n') {
+        setError(HPE_LF_EXPECTED);
+        break;
+      }
+      p++;
+      onMessageComplete();
+      break;
+    }
+  }
+
+  // Deliver the part of the element that is still being scanned at the end of the data.
+  if (error_ == HPE_OK && mark != nullptr && p > mark) {
+    switch (state_) {
+    case State::UrlScheme:
+    case State::UrlSchemeSlash:
+    case State::UrlSchemeSlashSlash:
+    case State::Url:
+      callbacks_.onUrl(mark, p - mark);
+      break;
+    case State::HeaderField:
+      addHeaderNameFragment(mark, p);
+      callbacks_.onHeaderField(mark, p - mark);
+      break;
+    case State::HeaderValue:
+      if (addHeaderValueFragment(mark, p)) {
+        callbacks_.onHeaderValue(mark, p - mark);
+      }
+      break;
+    default:
+      NOT_REACHED_GCOVR_EXCL_LINE;
+    }
+  }
+
+  return p - data;
+}
+
+void VectorizedRequestParser::startMessage() {
+  method_length_ = 0;
+  http_major_ = 0;
+  http_minor_ = 0;
+  framing_header_ = FramingHeader::None;
+  chunked_ = false;
+  content_length_.reset();
+  skip_body_ = false;
+  upgrade_ = false;
+  remaining_ = 0;
+  chunk_size_digits_ = false;
+  callbacks_.onMessageBeginBase();
+}
+
+bool VectorizedRequestParser::finishMethod() {
+  const absl::string_view name(method_buffer_, method_length_);
+  for (const MethodEntry& entry : Methods) {
+    if (entry.name_ == name) {
+      method_ = entry.method_;
+      return true;
+    }
+  }
+  setError(HPE_INVALID_METHOD);
+  return false;
+}
+
+void VectorizedRequestParser::addHeaderNameFragment(const char* begin, const char* end) {
+  // Only the names of framing headers are needed, so longer names are not buffered.
+  const size_t length = end - begin;
+  if (header_name_length_ + length > MaxFramingHeaderNameLength) {
+    header_name_length_ = MaxFramingHeaderNameLength + 1;
+    return;
+  }
+  for (; begin < end; ++begin) {
+    header_name_buffer_[header_name_length_++] = absl::ascii_tolower(*begin);
+  }
+}
+
+bool VectorizedRequestParser::finishHeaderName() {
+  framing_header_ = FramingHeader::None;
+  if (header_name_length_ > MaxFramingHeaderNameLength) {
+    return true;
+  }
+
+  const absl::string_view name(header_name_buffer_, header_name_length_);
+  if (name == "content-length") {
+    if (content_length_.has_value()) {
+      setError(HPE_UNEXPECTED_CONTENT_LENGTH);
+      return false;
+    }
+    framing_header_ = FramingHeader::ContentLength;
+    header_content_length_ = 0;
+    header_content_length_digits_ = false;
+    header_content_length_trailing_space_ = false;
+  } else if (name == "transfer-encoding") {
+    framing_header_ = FramingHeader::TransferEncoding;
+    transfer_encoding_length_ = 0;
+    transfer_encoding_trailing_space_ = false;
+  }
+  return true;
+}
+
+bool VectorizedRequestParser::addHeaderValueFragment(const char* begin, const char* end) {
+  switch (framing_header_) {
+  case FramingHeader::None:
+    break;
+
+  case FramingHeader::ContentLength:
+    for (; begin < end; ++begin) {
+      const char c = *begin;
+      if (absl::ascii_isdigit(c) && !header_content_length_trailing_space_) {
+        const uint64_t digit = c - '0';
+        if (header_content_length_ > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+          setError(HPE_INVALID_CONTENT_LENGTH);
+          return false;
+        }
+        header_content_length_ = header_content_length_ * 10 + digit;
+        header_content_length_digits_ = true;
+      } else if ((c == ' ' || c == '\t') && header_content_length_digits_) {
+        header_content_length_trailing_space_ = true;
+      } else {
+        setError(HPE_INVALID_CONTENT_LENGTH);
+        return false;
+      }
+    }
+    break;
+
+  case FramingHeader::TransferEncoding:
+    for (; begin < end; ++begin) {
+      if (*begin == ' ' || *begin == '\t') {
+        transfer_encoding_trailing_space_ = true;
+      } else if (transfer_encoding_trailing_space_ ||
+                 transfer_encoding_length_ == MaxTransferEncodingLength) {
+        // Either multiple codings or a coding that is too long to be "chunked".
+        transfer_encoding_length_ = MaxTransferEncodingLength;
+      } else {
+        transfer_encoding_buffer_[transfer_encoding_length_++] = absl::ascii_tolower(*begin);
+      }
+    }
+    break;
+  }
+  return true;
+}
+
+bool VectorizedRequestParser::finishHeaderValue() {
+  switch (framing_header_) {
+  case FramingHeader::None:
+    break;
+
+  case FramingHeader::ContentLength:
+    if (!header_content_length_digits_) {
+      setError(HPE_INVALID_CONTENT_LENGTH);
+      return false;
+    }
+    content_length_ = header_content_length_;
+    break;
+
+  case FramingHeader::TransferEncoding:
+    if (absl::string_view(transfer_encoding_buffer_, transfer_encoding_length_) == "chunked") {
+      chunked_ = true;
+    }
+    break;
+  }
+  framing_header_ = FramingHeader::None;
+  return true;
+}
+
+void VectorizedRequestParser::onHeadersComplete() {
+  // A message with both framing headers is a request smuggling vector, reject it.
+  if (chunked_ && content_length_.has_value()) {
+    setError(HPE_UNEXPECTED_CONTENT_LENGTH);
+    return;
+  }
+
+  state_ = State::HeadersDone;
+  const int rc = callbacks_.onHeadersCompleteBase();
+  upgrade_ = rc == 2 || method_ == HTTP_CONNECT;
+  skip_body_ = rc == 1;
+  if (!paused_) {
+    onHeadersDone();
+  }
+}
+
+void VectorizedRequestParser::onHeadersDone() {
+  ASSERT(state_ == State::HeadersDone);
+  if (upgrade_) {
+    onMessageComplete();
+    // As with http_parser, nothing after the headers of an upgrade is parsed. The caller takes
+    // over the connection from here.
+    paused_ = true;
+  } else if (skip_body_ || (!chunked_ && content_length_.value_or(0) == 0)) {
+    onMessageComplete();
+  } else if (chunked_) {
+    state_ = State::ChunkSize;
+    remaining_ = 0;
+    chunk_size_digits_ = false;
+  } else {
+    state_ = State::BodyIdentity;
+    remaining_ = content_length_.value();
+  }
+}
+
+void VectorizedRequestParser::onMessageComplete() {
+  state_ = State::MessageStart;
+  callbacks_.onMessageCompleteBase();
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <http_parser.h>
+
+#include <cstdint>
+
+#include "common/http/http1/parser.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * HTTP/1.1 request parser that scans the request line and header values a vector register at a
+ * time (SSE2 where available, with a scalar fallback) instead of a byte at a time. Like
+ * http_parser it is incremental: it runs directly over the buffer slices, hands out fragments
+ * pointing into them and keeps no copy of the message, so elements may span slices and dispatch
+ * calls.
+ *
+ * Compared to http_parser the parser is deliberately stricter in a few places: obsolete header
+ * line folding is rejected (RFC 7230 section 3.2.4) and the CRLF after chunk data is validated.
+ * Trailers are skipped without being reported.
+ */
+class VectorizedRequestParser : public Parser {
+public:
+  explicit VectorizedRequestParser(ParserCallbacks& callbacks) : callbacks_(callbacks) {}
+
+  // Http1::Parser
+  size_t execute(const char* data, size_t length) override;
+  void pause() override { paused_ = true; }
+  void resume() override { paused_ = false; }
+  http_errno error() const override { return error_; }
+  http_method method() const override { return method_; }
+  uint32_t statusCode() const override { return 0; }
+  bool isHttp11() const override { return http_major_ == 1 && http_minor_ == 1; }
+  bool isChunked() const override { return chunked_; }
+  absl::optional<uint64_t> contentLength() const override { return content_length_; }
+
+  /**
+   * @return the position of the first byte in [begin, end) that cannot be part of a request
+   *         target (a space, control character or DEL), or end if there is none.
+   */
+  static const char* findUrlEnd(const char* begin, const char* end);
+
+  /**
+   * @return the position of the first CR or LF in [begin, end), or end if there is none.
+   */
+  static const char* findLineEnd(const char* begin, const char* end);
+
+  /**
+   * @return the position of the first byte in [begin, end) that ends a header value: a CR or LF,
+   *         or a byte that cannot be part of a header value (a control character other than HTAB,
+   *         or DEL). NUL does not end a value, the codec rejects it with an error of its own, as it
+   *         does with http_parser.
+   */
+  static const char* findHeaderValueEnd(const char* begin, const char* end);
+
+private:
+  enum class State {
+    MessageStart,
+    Method,
+    SpacesBeforeUrl,
+    UrlScheme,
+    UrlSchemeSlash,
+    UrlSchemeSlashSlash,
+    Url,
+    SpacesBeforeVersion,
+    Version,
+    VersionMajor,
+    VersionDot,
+    VersionMinor,
+    VersionEnd,
+    RequestLineLf,
+    HeaderLineStart,
+    HeaderField,
+    HeaderValueStart,
+    HeaderValue,
+    HeaderLineLf,
+    HeadersLf,
+    HeadersDone,
+    BodyIdentity,
+    ChunkSize,
+    ChunkExtension,
+    ChunkSizeLf,
+    ChunkData,
+    ChunkDataCr,
+    ChunkDataLf,
+    TrailerLineStart,
+    TrailerLine,
+    TrailerLineLf,
+    TrailersLf,
+  };
+
+  // Headers whose value affects message framing.
+  enum class FramingHeader { None, ContentLength, TransferEncoding };
+
+  static constexpr size_t MaxMethodLength = 16;
+  // Long enough for "transfer-encoding".
+  static constexpr size_t MaxFramingHeaderNameLength = 17;
+  // Long enough for "chunked" plus a byte to detect longer values.
+  static constexpr size_t MaxTransferEncodingLength = 8;
+
+  void startMessage();
+  bool finishMethod();
+  void addHeaderNameFragment(const char* begin, const char* end);
+  bool finishHeaderName();
+  bool addHeaderValueFragment(const char* begin, const char* end);
+  bool finishHeaderValue();
+  void onHeadersComplete();
+  void onHeadersDone();
+  void onMessageComplete();
+  void setError(http_errno error) { error_ = error; }
+
+  ParserCallbacks& callbacks_;
+  State state_{State::MessageStart};
+  http_errno error_{HPE_OK};
+  bool paused_{};
+
+  // Per message state.
+  char method_buffer_[MaxMethodLength];
+  uint32_t method_length_{};
+  http_method method_{HTTP_GET};
+  uint32_t version_index_{};
+  uint16_t http_major_{};
+  uint16_t http_minor_{};
+  char header_name_buffer_[MaxFramingHeaderNameLength];
+  uint32_t header_name_length_{};
+  FramingHeader framing_header_{FramingHeader::None};
+  char transfer_encoding_buffer_[MaxTransferEncodingLength];
+  uint32_t transfer_encoding_length_{};
+  bool transfer_encoding_trailing_space_{};
+  uint64_t header_content_length_{};
+  bool header_content_length_digits_{};
+  bool header_content_length_trailing_space_{};
+  bool chunked_{};
+  absl::optional<uint64_t> content_length_;
+  bool skip_body_{};
+  bool upgrade_{};
+  // Bytes left in the body or current chunk, or the chunk size being parsed.
+  uint64_t remaining_{};
+  bool chunk_size_digits_{};
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
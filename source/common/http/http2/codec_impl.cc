@@ -48,8 +48,33 @@ template <typename T> static T* remove_const(const void* object) {
   return const_cast<T*>(reinterpret_cast<const T*>(object));
 }
 
+/**
+ * @return uint64_t the length of the next DATA frame of pending data, which is at most max_length.
+ * The frame ends at a slice boundary when one fits so that onDataSourceSend() moves the slices of
+ * the frame to the connection instead of copying the part of a slice that does not fit. Only a
+ * bounded number of slices is looked at since this runs for every frame; when they do not reach
+ * max_length the frame is as large as the pending data allows.
+ */
+static uint64_t dataFrameLength(const Buffer::Instance& data, uint64_t max_length) {
+  static const uint64_t MAX_SLICES = 64;
+  Buffer::RawSlice slices[MAX_SLICES];
+  const uint64_t num_slices = data.getRawSlices(slices, MAX_SLICES);
+  uint64_t length = 0;
+  for (uint64_t i = 0; i < std::min(num_slices, MAX_SLICES); i++) {
+    if (length + slices[i].len_ > max_length) {
+      // A slice does not fit. Fall back to a full frame if not even the first slice fits.
+      return length > 0 ? length : max_length;
+    }
+    length += slices[i].len_;
+  }
+  return std::min(data.length(), max_length);
+}
+
 ConnectionImpl::StreamImpl::StreamImpl(ConnectionImpl& parent, uint32_t buffer_limit)
-    : parent_(parent), headers_(new HeaderMapImpl()), local_end_stream_sent_(false),
+    : parent_(parent), header_map_arena_(parent.header_map_arena_enabled_
+                                             ? std::make_shared<HeaderMapArena>()
+                                             : nullptr),
+      headers_(newHeaderMap()), local_end_stream_sent_(false),
       remote_end_stream_(false), data_deferred_(false),
       waiting_for_non_informational_headers_(false),
       pending_receive_buffer_high_watermark_called_(false),
@@ -231,6 +256,7 @@ ssize_t ConnectionImpl::StreamImpl::onDataSourceRead(uint64_t length, uint32_t*
     return NGHTTP2_ERR_DEFERRED;
   } else {
     *data_flags |= NGHTTP2_DATA_FLAG_NO_COPY;
+    length = dataFrameLength(pending_send_data_, length);
     if (local_end_stream_ && pending_send_data_.length() <= length) {
       *data_flags |= NGHTTP2_DATA_FLAG_EOF;
       if (pending_trailers_) {
@@ -241,7 +267,7 @@ ssize_t ConnectionImpl::StreamImpl::onDataSourceRead(uint64_t length, uint32_t*
       }
     }
 
-    return std::min(length, pending_send_data_.length());
+    return length;
   }
 }
 
@@ -251,9 +277,8 @@ int ConnectionImpl::StreamImpl::onDataSourceSend(const uint8_t* framehd, size_t
   // https://nghttp2.org/documentation/types.html#c.nghttp2_send_data_callback
   static const uint64_t FRAME_HEADER_SIZE = 9;
 
-  Buffer::OwnedImpl output(framehd, FRAME_HEADER_SIZE);
-  output.move(pending_send_data_, length);
-  parent_.connection_.write(output, false);
+  parent_.outbound_frames_.add(framehd, FRAME_HEADER_SIZE);
+  parent_.outbound_frames_.move(pending_send_data_, length);
   return 0;
 }
 
@@ -556,8 +581,7 @@ int ConnectionImpl::onInvalidFrame(int32_t stream_id, int error_code) {
 
 ssize_t ConnectionImpl::onSend(const uint8_t* data, size_t length) {
   ENVOY_CONN_LOG(trace, "send data: bytes={}", connection_, length);
-  Buffer::OwnedImpl buffer(data, length);
-  connection_.write(buffer, false);
+  outbound_frames_.add(data, length);
   return length;
 }
 
@@ -565,6 +589,9 @@ int ConnectionImpl::onStreamClose(int32_t stream_id, uint32_t error_code) {
   StreamImpl* stream = getStream(stream_id);
   if (stream) {
     ENVOY_CONN_LOG(debug, "stream closed: {}", connection_, error_code);
+    // A stream closes while sending when its reset is sent. Write the reset before the reset
+    // callbacks run, as they may close the connection.
+    writeOutboundFrames();
     if (!stream->remote_end_stream_ || !stream->local_end_stream_) {
       StreamResetReason reason;
       if (stream->reset_due_to_messaging_error_) {
@@ -660,6 +687,7 @@ void ConnectionImpl::sendPendingFrames() {
   }
 
   int rc = nghttp2_session_send(session_);
+  writeOutboundFrames();
   if (rc != 0) {
     ASSERT(rc == NGHTTP2_ERR_CALLBACK_FAILURE);
     throw CodecProtocolException(fmt::format("{}", nghttp2_strerror(rc)));
@@ -688,6 +716,18 @@ void ConnectionImpl::sendPendingFrames() {
   }
 }
 
+void ConnectionImpl::writeOutboundFrames() {
+  if (outbound_frames_.length() == 0) {
+    return;
+  }
+
+  // Writing may re-enter the codec, e.g. through the watermark callbacks of the connection, so the
+  // frames are moved out of outbound_frames_ first.
+  Buffer::OwnedImpl output;
+  output.move(outbound_frames_);
+  connection_.write(output, false);
+}
+
 void ConnectionImpl::sendSettings(const Http2Settings& http2_settings, bool disable_push) {
   ASSERT(http2_settings.hpack_table_size_ <= Http2Settings::MAX_HPACK_TABLE_SIZE);
   ASSERT(Http2Settings::MIN_MAX_CONCURRENT_STREAMS <= http2_settings.max_concurrent_streams_ &&
@@ -918,7 +958,7 @@ int ClientConnectionImpl::onBeginHeaders(const nghttp2_frame* frame) {
   if (frame->headers.cat == NGHTTP2_HCAT_HEADERS) {
     StreamImpl* stream = getStream(frame->hd.stream_id);
     ASSERT(!stream->headers_);
-    stream->headers_ = std::make_unique<HeaderMapImpl>();
+    stream->headers_ = stream->newHeaderMap();
   }
 
   return 0;
@@ -954,7 +994,7 @@ int ServerConnectionImpl::onBeginHeaders(const nghttp2_frame* frame) {
 
     StreamImpl* stream = getStream(frame->hd.stream_id);
     ASSERT(!stream->headers_);
-    stream->headers_ = std::make_unique<HeaderMapImpl>();
+    stream->headers_ = stream->newHeaderMap();
     return 0;
   }
 
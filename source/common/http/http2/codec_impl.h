@@ -20,6 +20,7 @@
 #include "common/http/http2/metadata_decoder.h"
 #include "common/http/http2/metadata_encoder.h"
 #include "common/http/utility.h"
+#include "common/runtime/runtime_impl.h"
 
 #include "absl/types/optional.h"
 #include "nghttp2/nghttp2.h"
@@ -77,8 +78,10 @@ public:
                  const Http2Settings& http2_settings, const uint32_t max_request_headers_kb)
       : stats_{ALL_HTTP2_CODEC_STATS(POOL_COUNTER_PREFIX(stats, "http2."))},
         connection_(connection), max_request_headers_kb_(max_request_headers_kb),
-        per_stream_buffer_limit_(http2_settings.initial_stream_window_size_), dispatching_(false),
-        raised_goaway_(false), pending_deferred_reset_(false) {}
+        per_stream_buffer_limit_(http2_settings.initial_stream_window_size_),
+        header_map_arena_enabled_(
+            Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http_header_map_arena")),
+        dispatching_(false), raised_goaway_(false), pending_deferred_reset_(false) {}
 
   ~ConnectionImpl();
 
@@ -200,8 +203,11 @@ protected:
     virtual void maybeTransformUpgradeFromH2ToH1() PURE;
 
     bool buffers_overrun() const { return read_disable_count_ > 0; }
+    HeaderMapImplPtr newHeaderMap() { return std::make_unique<HeaderMapImpl>(header_map_arena_); }
 
     ConnectionImpl& parent_;
+    // Shared by all the header maps received on the stream if arena allocation is enabled.
+    const HeaderMapArenaSharedPtr header_map_arena_;
     HeaderMapImplPtr headers_;
     StreamDecoder* decoder_{};
     int32_t stream_id_{-1};
@@ -278,16 +284,21 @@ protected:
   StreamImpl* getStream(int32_t stream_id);
   int saveHeader(const nghttp2_frame* frame, HeaderString&& name, HeaderString&& value);
   void sendPendingFrames();
+  void writeOutboundFrames();
   void sendSettings(const Http2Settings& http2_settings, bool disable_push);
 
   static Http2Callbacks http2_callbacks_;
 
   std::list<StreamImplPtr> active_streams_;
   nghttp2_session* session_{};
+  // The frames nghttp2 sends in one sendPendingFrames() call, which are written to the connection
+  // at once. DATA payloads are moved into it from the pending data of the streams.
+  Buffer::OwnedImpl outbound_frames_;
   CodecStats stats_;
   Network::Connection& connection_;
   const uint32_t max_request_headers_kb_;
   uint32_t per_stream_buffer_limit_;
+  const bool header_map_arena_enabled_;
   bool allow_metadata_;
 
 private:
@@ -0,0 +1,42 @@
+#include "common/network/connection_balancer_impl.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Network {
+
+void ExactConnectionBalancerImpl::registerHandler(BalancedConnectionHandler& handler) {
+  Thread::LockGuard lock(lock_);
+  handlers_.push_back(&handler);
+}
+
+void ExactConnectionBalancerImpl::unregisterHandler(BalancedConnectionHandler& handler) {
+  Thread::LockGuard lock(lock_);
+  // There is one handler per worker, and they are only unregistered when the listener is removed.
+  handlers_.erase(std::find(handlers_.begin(), handlers_.end(), &handler));
+}
+
+BalancedConnectionHandler&
+ExactConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler&) {
+  BalancedConnectionHandler* min_connection_handler = nullptr;
+  {
+    Thread::LockGuard lock(lock_);
+    ASSERT(!handlers_.empty());
+    for (BalancedConnectionHandler* handler : handlers_) {
+      if (min_connection_handler == nullptr ||
+          handler->numConnections() < min_connection_handler->numConnections()) {
+        min_connection_handler = handler;
+      }
+    }
+
+    min_connection_handler->incNumConnections();
+  }
+
+  return *min_connection_handler;
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+#include "envoy/network/connection_balancer.h"
+
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Connection balancer which moves every accepted connection to the handler with the fewest
+ * connections. The handlers are compared under a lock, so that the connections are balanced
+ * exactly. This is meant for listeners with few, long lived connections, since every accept
+ * contends on the lock and most connections are posted to another worker.
+ */
+class ExactConnectionBalancerImpl : public ConnectionBalancer {
+public:
+  // Network::ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler& handler) override;
+  void unregisterHandler(BalancedConnectionHandler& handler) override;
+  BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override;
+
+private:
+  Thread::MutexBasicLockable lock_;
+  std::vector<BalancedConnectionHandler*> handlers_ GUARDED_BY(lock_);
+};
+
+/**
+ * Connection balancer which keeps every connection on the handler which accepted it, leaving the
+ * balance to the kernel.
+ */
+class NopConnectionBalancerImpl : public ConnectionBalancer {
+public:
+  // Network::ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler&) override {}
+  void unregisterHandler(BalancedConnectionHandler&) override {}
+  BalancedConnectionHandler&
+  pickTargetHandler(BalancedConnectionHandler& current_handler) override {
+    current_handler.incNumConnections();
+    return current_handler;
+  }
+};
+
+} // namespace Network
+} // namespace Envoy
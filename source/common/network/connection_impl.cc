@@ -603,6 +603,12 @@ void ConnectionImpl::onWriteReady() {
   }
 }
 
+void ConnectionImpl::flushWriteBuffer() {
+  if (ioHandle().isOpen() && !connecting_) {
+    onWriteReady();
+  }
+}
+
 void ConnectionImpl::setConnectionStats(const ConnectionStats& stats) {
   ASSERT(!connection_stats_,
          "Two network filters are attempting to set connection stats. This indicates an issue "
@@ -652,6 +658,15 @@ void ConnectionImpl::initializeDelayedCloseTimer() {
   delayed_close_timer_->enableTimer(delayedCloseTimeout());
 }
 
+IoHandle* ConnectionImpl::rawIoHandle() {
+  if (state() != State::Open || connecting_ || inDelayedClose() || read_end_stream_ ||
+      write_end_stream_ || read_buffer_.length() != 0 || write_buffer_->length() != 0 ||
+      !transport_socket_->passthrough() || !filter_manager_.singleReadFilter()) {
+    return nullptr;
+  }
+  return &ioHandle();
+}
+
 absl::string_view ConnectionImpl::transportFailureReason() const {
   return transport_socket_->failureReason();
 }
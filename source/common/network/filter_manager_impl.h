@@ -108,6 +108,10 @@ public:
   bool initializeReadFilters();
   void onRead();
   FilterStatus onWrite();
+  // Returns true if no filter other than a single read filter sees the data of the connection.
+  bool singleReadFilter() const {
+    return upstream_filters_.size() <= 1 && downstream_filters_.empty();
+  }
 
 private:
   struct ActiveReadFilter : public ReadFilterCallbacks, LinkedObject<ActiveReadFilter> {
@@ -0,0 +1,269 @@
+#include "common/network/io_uring_impl.h"
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/network/io_socket_handle_impl.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define ENVOY_IO_URING 1
+#endif
+#endif
+#endif
+
+namespace Envoy {
+namespace Network {
+
+#ifdef ENVOY_IO_URING
+
+IoUring::~IoUring() {
+  if (sqes_ != nullptr) {
+    ::munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    ::munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr) {
+    ::munmap(sq_ring_, sq_ring_size_);
+  }
+  if (fd_ != -1) {
+    ::close(fd_);
+  }
+}
+
+IoUringPtr IoUring::create(uint32_t entries) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  const int fd = ::syscall(__NR_io_uring_setup, entries, &params);
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  IoUringPtr ring(new IoUring());
+  ring->fd_ = fd;
+  ring->sq_entries_ = params.sq_entries;
+  ring->sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  ring->cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    ring->sq_ring_size_ = ring->cq_ring_size_ = std::max(ring->sq_ring_size_, ring->cq_ring_size_);
+  }
+
+  void* sq_ring = ::mmap(nullptr, ring->sq_ring_size_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (sq_ring == MAP_FAILED) {
+    return nullptr;
+  }
+  ring->sq_ring_ = sq_ring;
+
+  if (single_mmap) {
+    ring->cq_ring_ = sq_ring;
+  } else {
+    void* cq_ring = ::mmap(nullptr, ring->cq_ring_size_, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (cq_ring == MAP_FAILED) {
+      return nullptr;
+    }
+    ring->cq_ring_ = cq_ring;
+  }
+
+  ring->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = ::mmap(nullptr, ring->sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    return nullptr;
+  }
+  ring->sqes_ = sqes;
+
+  char* sq = static_cast<char*>(ring->sq_ring_);
+  ring->sq_tail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+  ring->sq_mask_ = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+  ring->sq_array_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+  char* cq = static_cast<char*>(ring->cq_ring_);
+  ring->cq_head_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+  ring->cq_tail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+  ring->cq_mask_ = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+  ring->cqes_ = cq + params.cq_off.cqes;
+  return ring;
+}
+
+void IoUring::prepareWritev(int fd, const iovec* iov, uint32_t iovcnt, uint32_t user_data) {
+  ASSERT(prepared_ < sq_entries_);
+  // The kernel consumes every submission before io_uring_enter(2) returns, so the tail is only
+  // ever written by us and the slots are free again once the previous submission completed.
+  const uint32_t tail = *sq_tail_ + prepared_;
+  const uint32_t index = tail & sq_mask_;
+  io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqes_) + index;
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = IORING_OP_WRITEV;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(iov);
+  sqe->len = iovcnt;
+  sqe->user_data = user_data;
+  sq_array_[index] = index;
+  prepared_++;
+}
+
+int IoUring::submitAndWait(std::vector<int32_t>& results) {
+  const uint32_t to_submit = prepared_;
+  prepared_ = 0;
+  if (to_submit == 0) {
+    return 0;
+  }
+  __atomic_store_n(sq_tail_, *sq_tail_ + to_submit, __ATOMIC_RELEASE);
+
+  uint32_t submitted = 0;
+  uint32_t completed = 0;
+  while (completed < to_submit) {
+    const int rc = ::syscall(__NR_io_uring_enter, fd_, to_submit - submitted,
+                             to_submit - completed, IORING_ENTER_GETEVENTS, nullptr, 0);
+    if (rc < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return errno;
+    }
+    submitted += rc;
+
+    uint32_t head = *cq_head_;
+    const uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+      const io_uring_cqe* cqe = static_cast<const io_uring_cqe*>(cqes_) + (head & cq_mask_);
+      ASSERT(cqe->user_data < results.size());
+      results[cqe->user_data] = cqe->res;
+      completed++;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  }
+  return 0;
+}
+
+#else
+
+IoUring::~IoUring() {}
+
+IoUringPtr IoUring::create(uint32_t) { return nullptr; }
+
+void IoUring::prepareWritev(int, const iovec*, uint32_t, uint32_t) { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+int IoUring::submitAndWait(std::vector<int32_t>&) { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+#endif
+
+WriteBatchPtr IoUringWriteBatchImpl::create(Event::Dispatcher& dispatcher) {
+  IoUringPtr ring = IoUring::create(RingEntries);
+  if (ring == nullptr) {
+    ENVOY_LOG(info, "io_uring is not available, socket writes will not be batched");
+    return nullptr;
+  }
+  return WriteBatchPtr{new IoUringWriteBatchImpl(dispatcher, std::move(ring))};
+}
+
+IoUringWriteBatchImpl::IoUringWriteBatchImpl(Event::Dispatcher& dispatcher, IoUringPtr&& ring)
+    : ring_(std::move(ring)), results_(ring_->entries()) {
+  // The ring's file descriptor only becomes readable when completions are left in it, which
+  // flush() never does, so the event only fires when it is activated.
+  flush_event_ = dispatcher.createFileEvent(
+      ring_->fd(), [this](uint32_t) -> void { flush(); }, Event::FileTriggerType::Level,
+      Event::FileReadyType::Read);
+}
+
+void IoUringWriteBatchImpl::add(IoHandle& io_handle, Buffer::Instance& buffer,
+                                WriteBatchCallbacks& callbacks) {
+  if (queued_.empty()) {
+    flush_event_->activate(Event::FileReadyType::Read);
+  }
+  queued_.push_back({&io_handle, &buffer, &callbacks, {}, 0, {0, 0}});
+}
+
+void IoUringWriteBatchImpl::remove(WriteBatchCallbacks& callbacks) {
+  auto it = std::find_if(queued_.begin(), queued_.end(), [&callbacks](const QueuedWrite& write) {
+    return write.callbacks_ == &callbacks;
+  });
+  if (it != queued_.end()) {
+    queued_.erase(it);
+    return;
+  }
+  for (QueuedWrite& write : flushing_) {
+    if (write.callbacks_ == &callbacks) {
+      write.callbacks_ = nullptr;
+      return;
+    }
+  }
+}
+
+void IoUringWriteBatchImpl::flush() {
+  ASSERT(flushing_.empty());
+  // Writes queued by the callbacks below go into the next batch.
+  flushing_.swap(queued_);
+  ENVOY_LOG(trace, "flushing {} batched writes", flushing_.size());
+
+  for (size_t begin = 0; begin < flushing_.size(); begin += ring_->entries()) {
+    const size_t end = std::min<size_t>(begin + ring_->entries(), flushing_.size());
+    for (size_t i = begin; i < end; i++) {
+      QueuedWrite& write = flushing_[i];
+      Buffer::RawSlice slices[MaxSlices];
+      const uint64_t num_slices =
+          std::min<uint64_t>(write.buffer_->getRawSlices(slices, MaxSlices), MaxSlices);
+      write.iovcnt_ = 0;
+      for (uint64_t j = 0; j < num_slices; j++) {
+        if (slices[j].mem_ != nullptr && slices[j].len_ != 0) {
+          write.iov_[write.iovcnt_].iov_base = slices[j].mem_;
+          write.iov_[write.iovcnt_].iov_len = slices[j].len_;
+          write.iovcnt_++;
+        }
+      }
+      if (write.iovcnt_ != 0) {
+        ring_->prepareWritev(write.io_handle_->fd(), write.iov_, write.iovcnt_, i - begin);
+      }
+    }
+
+    const int error = ring_->submitAndWait(results_);
+    if (error != 0) {
+      ENVOY_LOG(debug, "io_uring_enter failed: {}", strerror(error));
+    }
+    for (size_t i = begin; i < end; i++) {
+      QueuedWrite& write = flushing_[i];
+      if (write.iovcnt_ == 0) {
+        write.result_ = {0, 0};
+      } else if (error != 0) {
+        // Not expected, but nothing was written. Do it the usual way.
+        write.result_ =
+            Api::OsSysCallsSingleton::get().writev(write.io_handle_->fd(), write.iov_, write.iovcnt_);
+      } else if (results_[i - begin] < 0) {
+        write.result_ = {-1, -results_[i - begin]};
+      } else {
+        write.result_ = {results_[i - begin], 0};
+      }
+    }
+  }
+
+  // Hand out the results once every write is done, as the callbacks may queue or remove writes.
+  for (QueuedWrite& write : flushing_) {
+    if (write.callbacks_ == nullptr) {
+      continue;
+    }
+    if (write.result_.rc_ > 0) {
+      write.buffer_->drain(write.result_.rc_);
+      // Draining may run watermark callbacks which close the connection and remove the write.
+      if (write.callbacks_ == nullptr) {
+        continue;
+      }
+    }
+    write.callbacks_->onBatchedWrite(IoSocketHandleImpl::sysCallResultToIoCallResult(write.result_));
+  }
+  flushing_.clear();
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+#include "envoy/network/write_batch.h"
+
+#include "common/common/logger.h"
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Network {
+
+class IoUring;
+typedef std::unique_ptr<IoUring> IoUringPtr;
+
+/**
+ * A minimal io_uring submission and completion queue pair driven through the raw system calls.
+ * Operations are submitted and reaped synchronously: the ring is used to issue many system calls
+ * at once, not to make them asynchronous, so every operation must be on a non-blocking file.
+ */
+class IoUring : NonCopyable {
+public:
+  ~IoUring();
+
+  /**
+   * @param entries supplies the minimum number of operations that can be submitted at once.
+   * @return IoUringPtr a new ring, or nullptr if io_uring is not supported by the kernel or is not
+   *         permitted in this process.
+   */
+  static IoUringPtr create(uint32_t entries);
+
+  /**
+   * @return uint32_t the maximum number of operations that can be prepared before they are
+   *         submitted.
+   */
+  uint32_t entries() const { return sq_entries_; }
+
+  /**
+   * @return int the file descriptor of the ring.
+   */
+  int fd() const { return fd_; }
+
+  /**
+   * Prepare a writev(2) operation. Its result is reported at index user_data of the results of
+   * the next submitAndWait().
+   */
+  void prepareWritev(int fd, const iovec* iov, uint32_t iovcnt, uint32_t user_data);
+
+  /**
+   * Submit all prepared operations in a single system call and wait for them to complete.
+   * @param results receives, for each operation, the return value of the system call or the
+   *        negated errno. It must have room for every user_data that was prepared.
+   * @return int 0 on success, or the errno of io_uring_enter(2). If it fails the results are
+   *         undefined.
+   */
+  int submitAndWait(std::vector<int32_t>& results);
+
+private:
+  IoUring() {}
+
+  int fd_{-1};
+  uint32_t sq_entries_{};
+  uint32_t prepared_{};
+
+  void* sq_ring_{};
+  size_t sq_ring_size_{};
+  void* cq_ring_{};
+  size_t cq_ring_size_{};
+  void* sqes_{};
+  size_t sqes_size_{};
+
+  // Pointers into the shared rings.
+  uint32_t* sq_tail_{};
+  uint32_t sq_mask_{};
+  uint32_t* sq_array_{};
+  uint32_t* cq_head_{};
+  uint32_t* cq_tail_{};
+  uint32_t cq_mask_{};
+  void* cqes_{};
+};
+
+/**
+ * WriteBatch which submits the queued writes as one io_uring_enter(2) call. The batch is flushed
+ * from an event that is activated when the first write is queued, and therefore runs after the
+ * other events that are ready in the current event loop iteration.
+ */
+class IoUringWriteBatchImpl : public WriteBatch, Logger::Loggable<Logger::Id::connection> {
+public:
+  /**
+   * @return WriteBatchPtr a new batch, or nullptr if io_uring cannot be used.
+   */
+  static WriteBatchPtr create(Event::Dispatcher& dispatcher);
+
+  // Network::WriteBatch
+  void add(IoHandle& io_handle, Buffer::Instance& buffer, WriteBatchCallbacks& callbacks) override;
+  void remove(WriteBatchCallbacks& callbacks) override;
+
+  // The maximum number of slices written per queued write, like Buffer::OwnedImpl::write().
+  static constexpr uint32_t MaxSlices = 16;
+  static constexpr uint32_t RingEntries = 256;
+
+private:
+  struct QueuedWrite {
+    IoHandle* io_handle_;
+    Buffer::Instance* buffer_;
+    // Nulled out when the write is removed while the batch is being flushed.
+    WriteBatchCallbacks* callbacks_;
+    iovec iov_[MaxSlices];
+    uint32_t iovcnt_;
+    Api::SysCallSizeResult result_;
+  };
+
+  IoUringWriteBatchImpl(Event::Dispatcher& dispatcher, IoUringPtr&& ring);
+
+  void flush();
+
+  IoUringPtr ring_;
+  Event::FileEventPtr flush_event_;
+  std::vector<QueuedWrite> queued_;
+  // The writes being completed by flush(), which may remove some of them.
+  std::vector<QueuedWrite> flushing_;
+  std::vector<int32_t> results_;
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -1,5 +1,7 @@
 #include "common/network/raw_buffer_socket.h"
 
+#include "envoy/event/dispatcher.h"
+
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/http/headers.h"
@@ -7,10 +9,21 @@
 namespace Envoy {
 namespace Network {
 
+RawBufferSocket::~RawBufferSocket() { removeBatchedWrite(); }
+
 void RawBufferSocket::setTransportSocketCallbacks(TransportSocketCallbacks& callbacks) {
   callbacks_ = &callbacks;
 }
 
+void RawBufferSocket::closeSocket(Network::ConnectionEvent) { removeBatchedWrite(); }
+
+void RawBufferSocket::removeBatchedWrite() {
+  if (write_batch_ != nullptr) {
+    write_batch_->remove(*this);
+    write_batch_ = nullptr;
+  }
+}
+
 IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
   PostIoAction action = PostIoAction::KeepOpen;
   uint64_t bytes_read = 0;
@@ -47,7 +60,24 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
 
 IoResult RawBufferSocket::doWrite(Buffer::Instance& buffer, bool end_stream) {
   PostIoAction action;
-  uint64_t bytes_written = 0;
+  uint64_t bytes_written = batched_bytes_written_;
+  batched_bytes_written_ = 0;
+  if (batched_write_failed_) {
+    return {PostIoAction::Close, bytes_written, false};
+  }
+  if (write_batch_ != nullptr) {
+    // A batched write is still in flight, its completion will call us again.
+    return {PostIoAction::KeepOpen, bytes_written, false};
+  }
+  // Writes that half close the connection are not batched, so that the shutdown follows the data.
+  if (batch_writes_ && !end_stream && buffer.length() > 0) {
+    write_batch_ = callbacks_->connection().dispatcher().writeBatch();
+    if (write_batch_ != nullptr) {
+      write_batch_->add(callbacks_->ioHandle(), buffer, *this);
+      return {PostIoAction::KeepOpen, bytes_written, false};
+    }
+  }
+
   ASSERT(!shutdown_ || buffer.length() == 0);
   do {
     if (buffer.length() == 0) {
@@ -80,14 +110,31 @@ IoResult RawBufferSocket::doWrite(Buffer::Instance& buffer, bool end_stream) {
   return {action, bytes_written, false};
 }
 
+void RawBufferSocket::onBatchedWrite(Api::IoCallUint64Result&& result) {
+  write_batch_ = nullptr;
+  if (result.ok()) {
+    ENVOY_CONN_LOG(trace, "batched write returns: {}", callbacks_->connection(), result.rc_);
+    batched_bytes_written_ += result.rc_;
+  } else {
+    ENVOY_CONN_LOG(trace, "batched write error: {}", callbacks_->connection(),
+                   result.err_->getErrorDetails());
+    if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+      // The socket is full. The connection gets a write event once it drains.
+      return;
+    }
+    batched_write_failed_ = true;
+  }
+  callbacks_->flushWriteBuffer();
+}
+
 std::string RawBufferSocket::protocol() const { return EMPTY_STRING; }
 absl::string_view RawBufferSocket::failureReason() const { return EMPTY_STRING; }
 
 void RawBufferSocket::onConnected() { callbacks_->raiseEvent(ConnectionEvent::Connected); }
 
 TransportSocketPtr
-RawBufferSocketFactory::createTransportSocket(TransportSocketOptionsSharedPtr) const {
-  return std::make_unique<RawBufferSocket>();
+RawBufferSocketFactory::createTransportSocket(TransportSocketOptionsSharedPtr options) const {
+  return std::make_unique<RawBufferSocket>(options == nullptr || options->allowWriteBatching());
 }
 
 bool RawBufferSocketFactory::implementsSecureTransport() const { return false; }
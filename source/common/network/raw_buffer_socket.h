@@ -3,28 +3,51 @@
 #include "envoy/buffer/buffer.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/transport_socket.h"
+#include "envoy/network/write_batch.h"
 
 #include "common/common/logger.h"
 
 namespace Envoy {
 namespace Network {
 
-class RawBufferSocket : public TransportSocket, protected Logger::Loggable<Logger::Id::connection> {
+class RawBufferSocket : public TransportSocket,
+                        public WriteBatchCallbacks,
+                        protected Logger::Loggable<Logger::Id::connection> {
 public:
+  /**
+   * @param batch_writes supplies whether writes may be queued in the dispatcher's write batch.
+   *        This requires the callbacks to be the connection's, so that the completion of a
+   *        batched write can be reported through TransportSocketCallbacks::flushWriteBuffer().
+   */
+  explicit RawBufferSocket(bool batch_writes = false) : batch_writes_(batch_writes) {}
+  ~RawBufferSocket();
+
   // Network::TransportSocket
   void setTransportSocketCallbacks(TransportSocketCallbacks& callbacks) override;
   std::string protocol() const override;
   absl::string_view failureReason() const override;
   bool canFlushClose() override { return true; }
-  void closeSocket(Network::ConnectionEvent) override {}
+  void closeSocket(Network::ConnectionEvent) override;
   void onConnected() override;
   IoResult doRead(Buffer::Instance& buffer) override;
   IoResult doWrite(Buffer::Instance& buffer, bool end_stream) override;
   const Ssl::ConnectionInfo* ssl() const override { return nullptr; }
+  bool passthrough() const override { return true; }
+
+  // Network::WriteBatchCallbacks
+  void onBatchedWrite(Api::IoCallUint64Result&& result) override;
 
 private:
+  void removeBatchedWrite();
+
   TransportSocketCallbacks* callbacks_{};
   bool shutdown_{};
+  const bool batch_writes_;
+  // The batch a write is queued in, if any.
+  WriteBatch* write_batch_{};
+  // Bytes written by batched writes which have not been reported by doWrite() yet.
+  uint64_t batched_bytes_written_{};
+  bool batched_write_failed_{};
 };
 
 class RawBufferSocketFactory : public TransportSocketFactory {
@@ -7,19 +7,23 @@ namespace Network {
 
 class TransportSocketOptionsImpl : public TransportSocketOptions {
 public:
-  TransportSocketOptionsImpl(absl::string_view override_server_name = "")
+  TransportSocketOptionsImpl(absl::string_view override_server_name = "",
+                             bool allow_write_batching = true)
       : override_server_name_(override_server_name.empty()
                                   ? absl::nullopt
-                                  : absl::optional<std::string>(override_server_name)) {}
+                                  : absl::optional<std::string>(override_server_name)),
+        allow_write_batching_(allow_write_batching) {}
 
   // Network::TransportSocketOptions
   const absl::optional<std::string>& serverNameOverride() const override {
     return override_server_name_;
   }
   void hashKey(std::vector<uint8_t>& key) const override;
+  bool allowWriteBatching() const override { return allow_write_batching_; }
 
 private:
   const absl::optional<std::string> override_server_name_;
+  const bool allow_write_batching_;
 };
 
 } // namespace Network
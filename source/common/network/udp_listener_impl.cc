@@ -1,5 +1,7 @@
 #include "common/network/udp_listener_impl.h"
 
+#include <netinet/in.h>
+#include <netinet/udp.h>
 #include <sys/un.h>
 
 #include "envoy/buffer/buffer.h"
@@ -9,14 +11,72 @@
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
+#include "common/common/stack_array.h"
 #include "common/event/dispatcher_impl.h"
 #include "common/network/address_impl.h"
 
+#ifdef __linux__
+#include "common/api/os_sys_calls_impl_linux.h"
+#endif
+
 #include "event2/listener.h"
 
+// The UDP generic segmentation/receive offload socket options are missing from older C library
+// headers.
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
 namespace Envoy {
 namespace Network {
 
+namespace {
+
+// The largest payload of a datagram, and thus of a run of datagrams coalesced with generic
+// segmentation offload. This is the IPv4 limit, which is the lower of the IPv4 and IPv6 ones.
+constexpr uint64_t MaxUdpPayloadSize = 65507;
+
+socklen_t sockAddrFromAddress(const Address::Instance& address, sockaddr_storage& addr) {
+  memset(&addr, 0, sizeof(addr));
+  const Address::Ip* ip = address.ip();
+  if (ip == nullptr) {
+    return 0;
+  }
+
+  if (ip->ipv4() != nullptr) {
+    sockaddr_in* addrv4 = reinterpret_cast<sockaddr_in*>(&addr);
+    addrv4->sin_family = AF_INET;
+    addrv4->sin_port = htons(ip->port());
+    addrv4->sin_addr.s_addr = ip->ipv4()->address();
+    return sizeof(sockaddr_in);
+  }
+
+  sockaddr_in6* addrv6 = reinterpret_cast<sockaddr_in6*>(&addr);
+  addrv6->sin6_family = AF_INET6;
+  addrv6->sin6_port = htons(ip->port());
+  const absl::uint128 ipv6_address = ip->ipv6()->address();
+  memcpy(static_cast<void*>(&addrv6->sin6_addr.s6_addr), static_cast<const void*>(&ipv6_address),
+         sizeof(absl::uint128));
+  return sizeof(sockaddr_in6);
+}
+
+// Appends the non empty slices of a buffer to a list of iovecs.
+void appendSlices(const Buffer::Instance& buffer, std::vector<iovec>& iovecs) {
+  const uint64_t num_slices = buffer.getRawSlices(nullptr, 0);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  buffer.getRawSlices(slices.begin(), num_slices);
+  for (const Buffer::RawSlice& slice : slices) {
+    if (slice.len_ != 0) {
+      iovecs.push_back({slice.mem_, slice.len_});
+    }
+  }
+}
+
+} // namespace
+
 UdpListenerImpl::UdpListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket,
                                  UdpListenerCallbacks& cb)
     : BaseListenerImpl(dispatcher, socket), cb_(cb) {
@@ -31,6 +91,29 @@ UdpListenerImpl::UdpListenerImpl(Event::DispatcherImpl& dispatcher, Socket& sock
     throw CreateListenerException(fmt::format("cannot set post-bound socket option on socket: {}",
                                               socket.localAddress()->asString()));
   }
+
+#ifdef __linux__
+  // Generic receive offload lets the kernel coalesce datagrams of a flow into a single read, and
+  // generic segmentation offload lets it split a single write into datagrams. Both are only used
+  // when the kernel supports them (4.18+ for segmentation, 5.0+ for receive).
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const int fd = socket.ioHandle().fd();
+  const int enable = 1;
+  gro_enabled_ = os_sys_calls.setsockopt(fd, SOL_UDP, UDP_GRO, &enable, sizeof(enable)).rc_ == 0;
+  int segment_size = 0;
+  socklen_t segment_size_length = sizeof(segment_size);
+  gso_enabled_ =
+      os_sys_calls.getsockopt(fd, SOL_UDP, UDP_SEGMENT, &segment_size, &segment_size_length).rc_ ==
+      0;
+
+  read_batches_ = true;
+  read_slot_size_ = gro_enabled_ ? MaxCoalescedDatagramSize : MaxDatagramSize;
+  read_slots_ = std::make_unique<uint8_t[]>(MaxBatchSize * read_slot_size_);
+  read_addresses_.resize(MaxBatchSize);
+  read_iovecs_.resize(MaxBatchSize);
+  read_control_.resize(MaxBatchSize * CMSG_SPACE(sizeof(int)));
+  read_headers_.resize(MaxBatchSize);
+#endif
 }
 
 UdpListenerImpl::~UdpListenerImpl() {
@@ -46,7 +129,7 @@ void UdpListenerImpl::enable() {
 
 UdpListenerImpl::ReceiveResult UdpListenerImpl::doRecvFrom(sockaddr_storage& peer_addr,
                                                            socklen_t& addr_len) {
-  constexpr uint64_t const read_length = 16384;
+  constexpr uint64_t const read_length = MaxDatagramSize;
 
   Buffer::InstancePtr buffer = std::make_unique<Buffer::OwnedImpl>();
 
@@ -84,7 +167,68 @@ void UdpListenerImpl::onSocketEvent(short flags) {
   }
 }
 
+Address::InstanceConstSharedPtr
+UdpListenerImpl::peerAddress(const sockaddr_storage& addr, socklen_t addr_len,
+                             ssize_t receive_size,
+                             const Address::InstanceConstSharedPtr& local_address) {
+  RELEASE_ASSERT(
+      addr_len > 0,
+      fmt::format(
+          "Unable to get remote address for fd: {}, local address: {}. address length is 0 ",
+          socket_.ioHandle().fd(), local_address->asString()));
+
+  Address::InstanceConstSharedPtr peer_address;
+
+  // TODO(conqerAtApple): Current implementation of Address::addressFromSockAddr
+  // cannot be used here unfortunately. This should belong in Address namespace.
+  switch (addr.ss_family) {
+  case AF_INET: {
+    const struct sockaddr_in* sin = reinterpret_cast<const struct sockaddr_in*>(&addr);
+    ASSERT(AF_INET == sin->sin_family);
+    peer_address = std::make_shared<Address::Ipv4Instance>(sin);
+
+    break;
+  }
+  case AF_INET6: {
+    const struct sockaddr_in6* sin6 = reinterpret_cast<const struct sockaddr_in6*>(&addr);
+    ASSERT(AF_INET6 == sin6->sin6_family);
+    if (IN6_IS_ADDR_V4MAPPED(&sin6->sin6_addr)) {
+#if defined(__APPLE__)
+      struct sockaddr_in sin = {
+          {}, AF_INET, sin6->sin6_port, {sin6->sin6_addr.__u6_addr.__u6_addr32[3]}, {}};
+#else
+      struct sockaddr_in sin = {AF_INET, sin6->sin6_port, {sin6->sin6_addr.s6_addr32[3]}, {}};
+#endif
+      peer_address = std::make_shared<Address::Ipv4Instance>(&sin);
+    } else {
+      peer_address = std::make_shared<Address::Ipv6Instance>(*sin6, true);
+    }
+
+    break;
+  }
+
+  default:
+    RELEASE_ASSERT(false,
+                   fmt::format("Unsupported address family: {}, local address: {}, receive size: "
+                               "{}, address length: {}",
+                               addr.ss_family, local_address->asString(), receive_size, addr_len));
+    break;
+  }
+
+  RELEASE_ASSERT((peer_address != nullptr),
+                 fmt::format("Unable to get remote address for fd: {}, local address: {} ",
+                             socket_.ioHandle().fd(), local_address->asString()));
+
+  return peer_address;
+}
+
 void UdpListenerImpl::handleReadCallback() {
+#ifdef __linux__
+  if (read_batches_ && readBatches()) {
+    return;
+  }
+#endif
+
   sockaddr_storage addr;
   socklen_t addr_len = 0;
 
@@ -103,65 +247,252 @@ void UdpListenerImpl::handleReadCallback() {
     }
 
     Address::InstanceConstSharedPtr local_address = socket_.localAddress();
+    RELEASE_ASSERT((local_address != nullptr),
+                   fmt::format("Unable to get local address for fd: {}", socket_.ioHandle().fd()));
 
-    RELEASE_ASSERT(
-        addr_len > 0,
-        fmt::format(
-            "Unable to get remote address for fd: {}, local address: {}. address length is 0 ",
-            socket_.ioHandle().fd(), local_address->asString()));
+    Address::InstanceConstSharedPtr peer_address =
+        peerAddress(addr, addr_len, recv_result.result_.rc_, local_address);
 
-    Address::InstanceConstSharedPtr peer_address;
+    cb_.onData(UdpData{local_address, peer_address, std::move(recv_result.buffer_)});
 
-    // TODO(conqerAtApple): Current implementation of Address::addressFromSockAddr
-    // cannot be used here unfortunately. This should belong in Address namespace.
-    switch (addr.ss_family) {
-    case AF_INET: {
-      const struct sockaddr_in* sin = reinterpret_cast<const struct sockaddr_in*>(&addr);
-      ASSERT(AF_INET == sin->sin_family);
-      peer_address = std::make_shared<Address::Ipv4Instance>(sin);
+  } while (true);
+}
 
-      break;
-    }
-    case AF_INET6: {
-      const struct sockaddr_in6* sin6 = reinterpret_cast<const struct sockaddr_in6*>(&addr);
-      ASSERT(AF_INET6 == sin6->sin6_family);
-      if (IN6_IS_ADDR_V4MAPPED(&sin6->sin6_addr)) {
-#if defined(__APPLE__)
-        struct sockaddr_in sin = {
-            {}, AF_INET, sin6->sin6_port, {sin6->sin6_addr.__u6_addr.__u6_addr32[3]}, {}};
-#else
-        struct sockaddr_in sin = {AF_INET, sin6->sin6_port, {sin6->sin6_addr.s6_addr32[3]}, {}};
-#endif
-        peer_address = std::make_shared<Address::Ipv4Instance>(&sin);
-      } else {
-        peer_address = std::make_shared<Address::Ipv6Instance>(*sin6, true);
-      }
+#ifdef __linux__
+bool UdpListenerImpl::readBatches() {
+  auto& os_sys_calls = Api::LinuxOsSysCallsSingleton::get();
+  const int fd = socket_.ioHandle().fd();
+  const size_t control_size = CMSG_SPACE(sizeof(int));
 
-      break;
+  do {
+    for (uint32_t i = 0; i < MaxBatchSize; i++) {
+      read_iovecs_[i].iov_base = read_slots_.get() + i * read_slot_size_;
+      read_iovecs_[i].iov_len = read_slot_size_;
+      msghdr& header = read_headers_[i].msg_hdr;
+      header.msg_name = &read_addresses_[i];
+      header.msg_namelen = sizeof(sockaddr_storage);
+      header.msg_iov = &read_iovecs_[i];
+      header.msg_iovlen = 1;
+      header.msg_control = gro_enabled_ ? &read_control_[i * control_size] : nullptr;
+      header.msg_controllen = gro_enabled_ ? control_size : 0;
+      header.msg_flags = 0;
+      read_headers_[i].msg_len = 0;
     }
 
-    default:
-      RELEASE_ASSERT(false,
-                     fmt::format("Unsupported address family: {}, local address: {}, receive size: "
-                                 "{}, address length: {}",
-                                 addr.ss_family, local_address->asString(), recv_result.result_.rc_,
-                                 addr_len));
-      break;
+    const Api::SysCallIntResult result =
+        os_sys_calls.recvmmsg(fd, read_headers_.data(), MaxBatchSize, 0, nullptr);
+    if (result.rc_ < 0) {
+      if (result.errno_ == ENOSYS) {
+        read_batches_ = false;
+        return false;
+      }
+      if (result.errno_ != EAGAIN) {
+        cb_.onError(UdpListenerCallbacks::ErrorCode::SyscallError, result.errno_);
+      }
+      return true;
     }
 
-    RELEASE_ASSERT((peer_address != nullptr),
-                   fmt::format("Unable to get remote address for fd: {}, local address: {} ",
-                               socket_.ioHandle().fd(), local_address->asString()));
-
+    Address::InstanceConstSharedPtr local_address = socket_.localAddress();
     RELEASE_ASSERT((local_address != nullptr),
                    fmt::format("Unable to get local address for fd: {}", socket_.ioHandle().fd()));
 
-    cb_.onData(UdpData{local_address, peer_address, std::move(recv_result.buffer_)});
+    UdpDataBatch batch;
+    batch.reserve(result.rc_);
+    for (int i = 0; i < result.rc_; i++) {
+      const msghdr& header = read_headers_[i].msg_hdr;
+      const uint64_t length = read_headers_[i].msg_len;
+      if (length == 0) {
+        // TODO(conqerAtapple): Is zero length packet interesting?
+        continue;
+      }
+
+      Address::InstanceConstSharedPtr peer_address = peerAddress(
+          read_addresses_[i], header.msg_namelen, static_cast<ssize_t>(length), local_address);
+
+      // With generic receive offload, the read may hold several datagrams of the same size, of
+      // which only the last may be shorter.
+      uint64_t segment_size = length;
+      if (gro_enabled_) {
+        for (const cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr;
+             cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&header), const_cast<cmsghdr*>(cmsg))) {
+          if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+            int gro_size;
+            memcpy(&gro_size, CMSG_DATA(cmsg), sizeof(gro_size));
+            if (gro_size > 0) {
+              segment_size = gro_size;
+            }
+          }
+        }
+      }
+
+      const uint8_t* data = static_cast<const uint8_t*>(read_iovecs_[i].iov_base);
+      for (uint64_t offset = 0; offset < length; offset += segment_size) {
+        batch.push_back(UdpData{local_address, peer_address,
+                                std::make_unique<Buffer::OwnedImpl>(
+                                    data + offset, std::min(segment_size, length - offset))});
+      }
+    }
 
+    if (!batch.empty()) {
+      cb_.onDataBatch(batch);
+    }
+
+    // A short read drained the socket. Datagrams that arrive later raise a new edge triggered read
+    // event, so there is no need to read again until EAGAIN.
+    if (static_cast<uint32_t>(result.rc_) < MaxBatchSize) {
+      return true;
+    }
   } while (true);
 }
+#endif
 
 void UdpListenerImpl::handleWriteCallback() { cb_.onWriteReady(socket_); }
 
+Api::SysCallSizeResult UdpListenerImpl::send(const UdpSendData& data) {
+  sockaddr_storage peer_addr;
+  const socklen_t peer_addr_len = sockAddrFromAddress(data.peer_address_, peer_addr);
+  ASSERT(peer_addr_len > 0);
+
+  const uint64_t num_slices = data.buffer_.getRawSlices(nullptr, 0);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  data.buffer_.getRawSlices(slices.begin(), num_slices);
+  STACK_ARRAY(iov, iovec, num_slices);
+  uint64_t num_slices_to_write = 0;
+  for (const Buffer::RawSlice& slice : slices) {
+    if (slice.len_ != 0) {
+      iov[num_slices_to_write].iov_base = slice.mem_;
+      iov[num_slices_to_write].iov_len = slice.len_;
+      num_slices_to_write++;
+    }
+  }
+
+  msghdr message{};
+  message.msg_name = &peer_addr;
+  message.msg_namelen = peer_addr_len;
+  message.msg_iov = iov.begin();
+  message.msg_iovlen = num_slices_to_write;
+  return Api::OsSysCallsSingleton::get().sendmsg(socket_.ioHandle().fd(), &message, 0);
+}
+
+Api::SysCallIntResult UdpListenerImpl::sendBatch(const std::vector<UdpSendData>& batch) {
+#ifdef __linux__
+  return sendBatchMmsg(batch);
+#else
+  int sent = 0;
+  for (const UdpSendData& data : batch) {
+    const Api::SysCallSizeResult result = send(data);
+    if (result.rc_ < 0) {
+      if (sent == 0) {
+        return {-1, result.errno_};
+      }
+      break;
+    }
+    sent++;
+  }
+  return {sent, 0};
+#endif
+}
+
+#ifdef __linux__
+Api::SysCallIntResult UdpListenerImpl::sendBatchMmsg(const std::vector<UdpSendData>& batch) {
+  auto& os_sys_calls = Api::LinuxOsSysCallsSingleton::get();
+  const int fd = socket_.ioHandle().fd();
+  const size_t control_size = CMSG_SPACE(sizeof(uint16_t));
+  bool coalesce = gso_enabled_;
+  uint32_t sent = 0;
+
+  while (sent < batch.size()) {
+    // Group the next datagrams into at most MaxBatchSize messages. When segmentation offload is
+    // available, a run of datagrams to the same peer, of which all but the last have the same size
+    // and the last is not larger, is sent as a single message.
+    send_messages_.clear();
+    send_iovecs_.clear();
+    size_t next = sent;
+    while (next < batch.size() && send_messages_.size() < MaxBatchSize) {
+      const UdpSendData& first = batch[next];
+      SendMessage message{0, first.buffer_.length(), send_iovecs_.size(), 0};
+      uint64_t total_size = 0;
+      while (next < batch.size()) {
+        const UdpSendData& data = batch[next];
+        const uint64_t length = data.buffer_.length();
+        if (message.datagrams_ > 0 &&
+            (!coalesce || message.datagrams_ == MaxGsoSegments || length == 0 ||
+             length > message.segment_size_ || total_size + length > MaxUdpPayloadSize ||
+             !(data.peer_address_ == first.peer_address_))) {
+          break;
+        }
+        appendSlices(data.buffer_, send_iovecs_);
+        total_size += length;
+        message.datagrams_++;
+        next++;
+        if (length < message.segment_size_) {
+          break;
+        }
+      }
+      message.num_iovecs_ = send_iovecs_.size() - message.first_iovec_;
+      send_messages_.push_back(message);
+    }
+
+    // The iovecs are only pointed to once they are all collected, as collecting them may move
+    // them.
+    const size_t num_messages = send_messages_.size();
+    send_addresses_.resize(num_messages);
+    send_control_.assign(num_messages * control_size, 0);
+    send_headers_.resize(num_messages);
+    size_t datagram = sent;
+    for (size_t i = 0; i < num_messages; i++) {
+      const SendMessage& message = send_messages_[i];
+      msghdr& header = send_headers_[i].msg_hdr;
+      header = msghdr{};
+      header.msg_name = &send_addresses_[i];
+      header.msg_namelen = sockAddrFromAddress(batch[datagram].peer_address_, send_addresses_[i]);
+      ASSERT(header.msg_namelen > 0);
+      header.msg_iov = send_iovecs_.data() + message.first_iovec_;
+      header.msg_iovlen = message.num_iovecs_;
+      if (message.datagrams_ > 1) {
+        header.msg_control = &send_control_[i * control_size];
+        header.msg_controllen = control_size;
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&header);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_SEGMENT;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        const uint16_t segment_size = message.segment_size_;
+        memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+      }
+      send_headers_[i].msg_len = 0;
+      datagram += message.datagrams_;
+    }
+
+    const Api::SysCallIntResult result =
+        os_sys_calls.sendmmsg(fd, send_headers_.data(), num_messages, 0);
+    if (result.rc_ < 0) {
+      if (coalesce && (result.errno_ == EIO || result.errno_ == EINVAL)) {
+        // EIO means that the device cannot offload segmentation, EINVAL that a segment does not
+        // fit the path MTU. Send the datagrams one by one instead.
+        if (result.errno_ == EIO) {
+          gso_enabled_ = false;
+        }
+        coalesce = false;
+        continue;
+      }
+      if (sent == 0) {
+        return {-1, result.errno_};
+      }
+      break;
+    }
+
+    for (int i = 0; i < result.rc_; i++) {
+      sent += send_messages_[i].datagrams_;
+    }
+    if (static_cast<size_t>(result.rc_) < num_messages) {
+      // The socket buffer is full.
+      break;
+    }
+  }
+
+  return {static_cast<int>(sent), 0};
+}
+#endif
+
 } // namespace Network
 } // namespace Envoy
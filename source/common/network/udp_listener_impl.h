@@ -1,6 +1,10 @@
 #pragma once
 
+#include <sys/socket.h>
+
 #include <atomic>
+#include <memory>
+#include <vector>
 
 #include "common/buffer/buffer_impl.h"
 #include "common/event/event_impl_base.h"
@@ -14,15 +18,20 @@ namespace Network {
 /**
  * libevent implementation of Network::Listener for UDP.
  */
-class UdpListenerImpl : public BaseListenerImpl {
+class UdpListenerImpl : public BaseListenerImpl, public UdpListener {
 public:
   UdpListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket, UdpListenerCallbacks& cb);
 
   ~UdpListenerImpl();
 
+  // Network::Listener
   virtual void disable() override;
   virtual void enable() override;
 
+  // Network::UdpListener
+  Api::SysCallSizeResult send(const UdpSendData& data) override;
+  Api::SysCallIntResult sendBatch(const std::vector<UdpSendData>& batch) override;
+
   struct ReceiveResult {
     Api::SysCallIntResult result_;
     Buffer::InstancePtr buffer_;
@@ -31,6 +40,17 @@ public:
   // Useful for testing/mocking.
   virtual ReceiveResult doRecvFrom(sockaddr_storage& peer_addr, socklen_t& addr_len);
 
+  // The maximum number of datagrams read or written by a single recvmmsg(2)/sendmmsg(2) call.
+  static constexpr uint32_t MaxBatchSize = 16;
+  // The maximum size of a datagram read without UDP generic receive offload.
+  static constexpr uint64_t MaxDatagramSize = 16384;
+  // The maximum size of a datagram read with UDP generic receive offload, in which the kernel may
+  // coalesce several datagrams.
+  static constexpr uint64_t MaxCoalescedDatagramSize = 65535;
+  // The maximum number of datagrams coalesced in a single write with UDP generic segmentation
+  // offload (UDP_MAX_SEGMENTS in the kernel).
+  static constexpr uint32_t MaxGsoSegments = 64;
+
 protected:
   void handleWriteCallback();
   void handleReadCallback();
@@ -39,7 +59,47 @@ protected:
 
 private:
   void onSocketEvent(short flags);
+  Address::InstanceConstSharedPtr peerAddress(const sockaddr_storage& addr, socklen_t addr_len,
+                                              ssize_t receive_size,
+                                              const Address::InstanceConstSharedPtr& local_address);
+#ifdef __linux__
+  /**
+   * Read datagrams with recvmmsg(2) until the socket is drained.
+   * @return bool false if recvmmsg(2) is not supported and datagrams must be read one at a time.
+   */
+  bool readBatches();
+  Api::SysCallIntResult sendBatchMmsg(const std::vector<UdpSendData>& batch);
+#endif
+
   Event::FileEventPtr file_event_;
+  bool read_batches_{};
+  bool gro_enabled_{};
+  bool gso_enabled_{};
+
+#ifdef __linux__
+  // A message of a batched write: a single datagram, or a run of datagrams to the same peer that is
+  // segmented by the kernel.
+  struct SendMessage {
+    uint32_t datagrams_;
+    uint64_t segment_size_;
+    size_t first_iovec_;
+    size_t num_iovecs_;
+  };
+
+  // Scratch space for batched reads and writes, reused across socket events. Reads and writes have
+  // their own so that callbacks can write while a read batch is being processed.
+  uint64_t read_slot_size_{};
+  std::unique_ptr<uint8_t[]> read_slots_;
+  std::vector<sockaddr_storage> read_addresses_;
+  std::vector<iovec> read_iovecs_;
+  std::vector<char> read_control_;
+  std::vector<mmsghdr> read_headers_;
+  std::vector<SendMessage> send_messages_;
+  std::vector<sockaddr_storage> send_addresses_;
+  std::vector<iovec> send_iovecs_;
+  std::vector<char> send_control_;
+  std::vector<mmsghdr> send_headers_;
+#endif
 };
 
 } // namespace Network
@@ -149,7 +149,10 @@ CorsPolicyImpl::CorsPolicyImpl(const envoy::api::v2::route::CorsPolicy& config,
     allow_origin_.push_back(origin);
   }
   for (const auto& regex : config.allow_origin_regex()) {
-    allow_origin_regex_.push_back(RegexUtil::parseRegex(regex));
+    allow_origin_regex_.push_back(Regex::Utility::parseStdRegexAsCompiledMatcher(regex));
+  }
+  for (const auto& regex : config.allow_origin_safe_regex()) {
+    allow_origin_regex_.push_back(Regex::Utility::parseRegex(regex));
   }
   allow_methods_ = config.allow_methods();
   allow_headers_ = config.allow_headers();
@@ -841,7 +844,12 @@ RegexRouteEntryImpl::RegexRouteEntryImpl(const VirtualHostImpl& vhost,
                                          const envoy::api::v2::route::Route& route,
                                          Server::Configuration::FactoryContext& factory_context)
     : RouteEntryImplBase(vhost, route, factory_context),
-      regex_(RegexUtil::parseRegex(route.match().regex())), regex_str_(route.match().regex()) {}
+      regex_(route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex
+                 ? Regex::Utility::parseStdRegexAsCompiledMatcher(route.match().regex())
+                 : Regex::Utility::parseRegex(route.match().safe_regex())),
+      regex_str_(route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex
+                     ? route.match().regex()
+                     : route.match().safe_regex().regex()) {}
 
 void RegexRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers,
                                             bool insert_envoy_original_path) const {
@@ -851,9 +859,9 @@ void RegexRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers,
   // TODO(yuval-k): This ASSERT can happen if the path was changed by a filter without clearing the
   // route cache. We should consider if ASSERT-ing is the desired behavior in this case.
 
-  const absl::string_view path_view = path.getStringView();
-  ASSERT(std::regex_match(path_view.begin(), path_view.begin() + path_string_length, regex_));
-  const std::string matched_path(path_view.begin(), path_view.begin() + path_string_length);
+  const absl::string_view path_view = path.getStringView().substr(0, path_string_length);
+  ASSERT(regex_->match(path_view));
+  const std::string matched_path(path_view);
 
   finalizePathHeader(headers, matched_path, insert_envoy_original_path);
 }
@@ -863,9 +871,7 @@ RouteConstSharedPtr RegexRouteEntryImpl::matches(const Http::HeaderMap& headers,
   if (RouteEntryImplBase::matchRoute(headers, random_value)) {
     const Http::HeaderString& path = headers.Path()->value();
     const absl::string_view query_string = Http::Utility::findQueryStringStart(path);
-    if (std::regex_match(path.getStringView().begin(),
-                         path.getStringView().begin() + (path.size() - query_string.length()),
-                         regex_)) {
+    if (regex_->match(path.getStringView().substr(0, path.size() - query_string.length()))) {
       return clusterEntry(headers, random_value);
     }
   }
@@ -910,6 +916,7 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
     hedge_policy_ = virtual_host.hedge_policy();
   }
 
+  std::vector<envoy::type::matcher::RegexMatcher> safe_regex_configs;
   for (const auto& route : virtual_host.routes()) {
     const bool has_prefix =
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kPrefix;
@@ -917,13 +924,25 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kPath;
     const bool has_regex =
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex;
+    const bool has_safe_regex =
+        route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kSafeRegex;
+    const uint32_t route_index = routes_.size();
     if (has_prefix) {
       routes_.emplace_back(new PrefixRouteEntryImpl(*this, route, factory_context));
+      route_path_index_.addPrefix(route.match().prefix(), routes_.back()->caseSensitive(),
+                                  route_index);
     } else if (has_path) {
       routes_.emplace_back(new PathRouteEntryImpl(*this, route, factory_context));
+      route_path_index_.addExact(route.match().path(), routes_.back()->caseSensitive(),
+                                 route_index);
+    } else if (has_regex) {
+      routes_.emplace_back(new RegexRouteEntryImpl(*this, route, factory_context));
+      route_path_index_.addAlwaysEvaluated(route_index);
     } else {
-      ASSERT(has_regex);
+      ASSERT(has_safe_regex);
       routes_.emplace_back(new RegexRouteEntryImpl(*this, route, factory_context));
+      safe_regex_configs.push_back(route.match().safe_regex());
+      safe_regex_route_indexes_.push_back(route_index);
     }
 
     if (validate_clusters) {
@@ -937,6 +956,10 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
     }
   }
 
+  if (!safe_regex_configs.empty()) {
+    safe_regex_routes_ = Regex::Utility::parseRegexSet(safe_regex_configs);
+  }
+
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
     virtual_clusters_.push_back(VirtualClusterEntry(virtual_cluster, stat_name_pool_));
   }
@@ -1034,9 +1057,29 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const Http::HeaderMap&
     return SSL_REDIRECT_ROUTE;
   }
 
-  // Check for a route that matches the request.
-  for (const RouteEntryImplBaseConstSharedPtr& route : routes_) {
-    RouteConstSharedPtr route_entry = route->matches(headers, random_value);
+  // Check for a route that matches the request. The path index narrows the routes down to the
+  // ones whose path criterion can match; evaluating them in configuration order preserves
+  // first-match semantics.
+  const Http::HeaderString& path = headers.Path()->value();
+  const size_t path_length_without_query =
+      path.size() - Http::Utility::findQueryStringStart(path).length();
+  RoutePathIndex::Candidates candidates;
+  route_path_index_.findCandidates(path.getStringView(), path_length_without_query, candidates);
+  if (safe_regex_routes_ != nullptr) {
+    // Reused across requests so that matching does not allocate.
+    static thread_local std::vector<int> matches;
+    safe_regex_routes_->match(path.getStringView().substr(0, path_length_without_query), matches);
+    if (!matches.empty()) {
+      const size_t indexed_candidates = candidates.size();
+      for (const int match : matches) {
+        candidates.push_back(safe_regex_route_indexes_[match]);
+      }
+      std::inplace_merge(candidates.begin(), candidates.begin() + indexed_candidates,
+                         candidates.end());
+    }
+  }
+  for (const uint32_t index : candidates) {
+    RouteConstSharedPtr route_entry = routes_[index]->matches(headers, random_value);
     if (nullptr != route_entry) {
       return route_entry;
     }
@@ -17,12 +17,14 @@
 #include "envoy/server/filter_config.h"
 #include "envoy/upstream/cluster_manager.h"
 
+#include "common/common/regex.h"
 #include "common/config/metadata.h"
 #include "common/http/header_utility.h"
 #include "common/router/config_utility.h"
 #include "common/router/header_formatter.h"
 #include "common/router/header_parser.h"
 #include "common/router/metadatamatchcriteria_impl.h"
+#include "common/router/route_path_index.h"
 #include "common/router/router_ratelimit.h"
 #include "common/stats/symbol_table_impl.h"
 
@@ -104,7 +106,9 @@ public:
 
   // Router::CorsPolicy
   const std::list<std::string>& allowOrigins() const override { return allow_origin_; };
-  const std::list<std::regex>& allowOriginRegexes() const override { return allow_origin_regex_; }
+  const std::vector<Regex::CompiledMatcherPtr>& allowOriginRegexes() const override {
+    return allow_origin_regex_;
+  }
   const std::string& allowMethods() const override { return allow_methods_; };
   const std::string& allowHeaders() const override { return allow_headers_; };
   const std::string& exposeHeaders() const override { return expose_headers_; };
@@ -131,7 +135,7 @@ private:
   const envoy::api::v2::route::CorsPolicy config_;
   Runtime::Loader& loader_;
   std::list<std::string> allow_origin_;
-  std::list<std::regex> allow_origin_regex_;
+  std::vector<Regex::CompiledMatcherPtr> allow_origin_regex_;
   std::string allow_methods_;
   std::string allow_headers_;
   std::string expose_headers_;
@@ -202,6 +206,13 @@ private:
   Stats::StatNamePool stat_name_pool_;
   const Stats::StatName stat_name_;
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  // Index over the path criteria of routes_, built once at construction time.
+  RoutePathIndex route_path_index_;
+  // All safe_regex routes of the virtual host compiled into a single set, so that a request is
+  // matched against all of them with one scan of the path. safe_regex_route_indexes_ maps the
+  // position of an expression in the set to the position of its route in routes_.
+  Regex::CompiledMatcherSetPtr safe_regex_routes_;
+  std::vector<uint32_t> safe_regex_route_indexes_;
   std::vector<VirtualClusterEntry> virtual_clusters_;
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
@@ -364,6 +375,7 @@ public:
                      Server::Configuration::FactoryContext& factory_context);
 
   bool isDirectResponse() const { return direct_response_code_.has_value(); }
+  bool caseSensitive() const { return case_sensitive_; }
 
   bool isRedirect() const {
     if (!isDirectResponse()) {
@@ -727,7 +739,7 @@ public:
   void rewritePathHeader(Http::HeaderMap& headers, bool insert_envoy_original_path) const override;
 
 private:
-  const std::regex regex_;
+  const Regex::CompiledMatcherPtr regex_;
   const std::string regex_str_;
 };
 
@@ -0,0 +1,105 @@
+#include "common/router/route_path_index.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+bool childLessThan(const std::pair<uint8_t, uint32_t>& child, uint8_t c) { return child.first < c; }
+
+} // namespace
+
+RoutePathIndex::RoutePathIndex() : nodes_(2), case_sensitive_root_(0), case_insensitive_root_(1) {}
+
+void RoutePathIndex::addPrefix(absl::string_view prefix, bool case_sensitive, uint32_t index) {
+  nodes_[findOrCreateNode(prefix, case_sensitive)].prefix_routes_.push_back(index);
+}
+
+void RoutePathIndex::addExact(absl::string_view path, bool case_sensitive, uint32_t index) {
+  nodes_[findOrCreateNode(path, case_sensitive)].exact_routes_.push_back(index);
+}
+
+void RoutePathIndex::addAlwaysEvaluated(uint32_t index) {
+  ASSERT(always_evaluated_.empty() || always_evaluated_.back() < index);
+  always_evaluated_.push_back(index);
+}
+
+uint32_t RoutePathIndex::findOrCreateNode(absl::string_view key, bool case_sensitive) {
+  has_case_insensitive_routes_ |= !case_sensitive;
+  uint32_t current = case_sensitive ? case_sensitive_root_ : case_insensitive_root_;
+  for (const char key_char : key) {
+    const uint8_t c = case_sensitive ? key_char : absl::ascii_tolower(key_char);
+    // Do not hold references into nodes_ across the emplace_back() below since it may reallocate.
+    auto& children = nodes_[current].children_;
+    auto it = std::lower_bound(children.begin(), children.end(), c, childLessThan);
+    if (it != children.end() && it->first == c) {
+      current = it->second;
+      continue;
+    }
+
+    const uint32_t next = nodes_.size();
+    children.emplace(it, c, next);
+    nodes_.emplace_back();
+    current = next;
+  }
+  return current;
+}
+
+const RoutePathIndex::Node* RoutePathIndex::findChild(const Node& node, uint8_t c) const {
+  auto it = std::lower_bound(node.children_.begin(), node.children_.end(), c, childLessThan);
+  if (it == node.children_.end() || it->first != c) {
+    return nullptr;
+  }
+  return &nodes_[it->second];
+}
+
+void RoutePathIndex::walk(uint32_t root, bool case_sensitive, absl::string_view path,
+                          size_t path_length_without_query, Candidates& candidates) const {
+  const Node* current = &nodes_[root];
+  for (size_t i = 0;; i++) {
+    // Prefix routes compare against the full path, exact routes only against the part before the
+    // query string.
+    candidates.insert(candidates.end(), current->prefix_routes_.begin(),
+                      current->prefix_routes_.end());
+    if (i == path_length_without_query) {
+      candidates.insert(candidates.end(), current->exact_routes_.begin(),
+                        current->exact_routes_.end());
+    }
+    if (i == path.size()) {
+      return;
+    }
+
+    const uint8_t c = case_sensitive ? path[i] : absl::ascii_tolower(path[i]);
+    current = findChild(*current, c);
+    if (current == nullptr) {
+      return;
+    }
+  }
+}
+
+void RoutePathIndex::findCandidates(absl::string_view path, size_t path_length_without_query,
+                                    Candidates& candidates) const {
+  ASSERT(path_length_without_query <= path.size());
+  candidates.clear();
+  walk(case_sensitive_root_, true, path, path_length_without_query, candidates);
+  if (has_case_insensitive_routes_) {
+    walk(case_insensitive_root_, false, path, path_length_without_query, candidates);
+  }
+
+  // The trie candidates are usually a handful of routes, so sort them and merge the (already
+  // sorted) always evaluated routes in linear time rather than sorting everything.
+  std::sort(candidates.begin(), candidates.end());
+  if (!always_evaluated_.empty()) {
+    const size_t trie_candidates = candidates.size();
+    candidates.insert(candidates.end(), always_evaluated_.begin(), always_evaluated_.end());
+    std::inplace_merge(candidates.begin(), candidates.begin() + trie_candidates, candidates.end());
+  }
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Index over the path criteria of the routes of a virtual host. Routes are identified by their
+ * position in the virtual host's route list. Prefix and exact path routes are stored in a byte
+ * trie (one for case sensitive and one for case insensitive routes) so that the set of routes
+ * whose path criterion can match a request is found in O(path length), independent of the number
+ * of configured routes. Routes that cannot be indexed (regex routes) are returned as candidates
+ * for every request.
+ *
+ * The index only narrows down the routes by path. Callers must still run the full route match
+ * (headers, query parameters, runtime, etc.) on the candidates, in ascending index order, to
+ * preserve first-match semantics.
+ */
+class RoutePathIndex {
+public:
+  using Candidates = absl::InlinedVector<uint32_t, 8>;
+
+  RoutePathIndex();
+
+  /**
+   * Adds a prefix route.
+   * @param prefix supplies the prefix to match against the full path (including query string).
+   * @param case_sensitive supplies whether the prefix is compared case sensitively.
+   * @param index supplies the position of the route in the virtual host.
+   */
+  void addPrefix(absl::string_view prefix, bool case_sensitive, uint32_t index);
+
+  /**
+   * Adds an exact path route.
+   * @param path supplies the path to compare with the path excluding the query string.
+   * @param case_sensitive supplies whether the path is compared case sensitively.
+   * @param index supplies the position of the route in the virtual host.
+   */
+  void addExact(absl::string_view path, bool case_sensitive, uint32_t index);
+
+  /**
+   * Adds a route that must be evaluated for every request (e.g. a regex route).
+   * @param index supplies the position of the route in the virtual host.
+   */
+  void addAlwaysEvaluated(uint32_t index);
+
+  /**
+   * Finds the routes that may match a path.
+   * @param path supplies the full request path including the query string.
+   * @param path_length_without_query supplies the length of the path excluding the query string.
+   * @param candidates supplies the output vector. On return it contains the positions of the
+   *        candidate routes in ascending order.
+   */
+  void findCandidates(absl::string_view path, size_t path_length_without_query,
+                      Candidates& candidates) const;
+
+  /**
+   * @return uint64_t the number of trie nodes allocated by the index. Used for testing.
+   */
+  uint64_t nodeCount() const { return nodes_.size(); }
+
+private:
+  struct Node {
+    // Children sorted by byte so that lookups are a binary search on a small contiguous array.
+    std::vector<std::pair<uint8_t, uint32_t>> children_;
+    std::vector<uint32_t> prefix_routes_;
+    std::vector<uint32_t> exact_routes_;
+  };
+
+  uint32_t findOrCreateNode(absl::string_view key, bool case_sensitive);
+  const Node* findChild(const Node& node, uint8_t c) const;
+  void walk(uint32_t root, bool case_sensitive, absl::string_view path,
+            size_t path_length_without_query, Candidates& candidates) const;
+
+  // Flat storage for the nodes of both tries. Nodes reference their children by position.
+  std::vector<Node> nodes_;
+  const uint32_t case_sensitive_root_;
+  const uint32_t case_insensitive_root_;
+  bool has_case_insensitive_routes_{};
+  std::vector<uint32_t> always_evaluated_;
+};
+
+} // namespace Router
+} // namespace Envoy
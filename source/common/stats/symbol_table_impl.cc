@@ -98,7 +98,7 @@ uint64_t SymbolTableImpl::Encoding::moveToStorage(SymbolTable::Storage symbol_ar
 
 SymbolTableImpl::SymbolTableImpl()
     // Have to be explicitly initialized, if we want to use the GUARDED_BY macro.
-    : next_symbol_(0), monotonic_counter_(0) {}
+    : monotonic_counter_(0) {}
 
 SymbolTableImpl::~SymbolTableImpl() {
   // To avoid leaks into the symbol table, we expect all StatNames to be freed.
@@ -116,19 +116,16 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
     return;
   }
 
-  // We want to hold the lock for the minimum amount of time, so we do the
+  // We want to hold the locks for the minimum amount of time, so we do the
   // string-splitting and prepare a temp vector of Symbol first.
   const std::vector<absl::string_view> tokens = absl::StrSplit(name, '.');
   std::vector<Symbol> symbols;
   symbols.reserve(tokens.size());
 
-  // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
-  {
-    Thread::LockGuard lock(lock_);
-    for (auto& token : tokens) {
-      symbols.push_back(toSymbol(token));
-    }
+  // Now populate the Symbol objects, which involves bumping ref-counts in this.
+  // Each token only locks its own stripe.
+  for (auto& token : tokens) {
+    symbols.push_back(toSymbol(token));
   }
 
   // Now efficiently encode the array of 32-bit symbols into a uint8_t array.
@@ -138,9 +135,8 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
 }
 
 uint64_t SymbolTableImpl::numSymbols() const {
-  Thread::LockGuard lock(lock_);
-  ASSERT(encode_map_.size() == decode_map_.size());
-  return encode_map_.size();
+  absl::ReaderMutexLock lock(&decode_lock_);
+  return decode_map_.size();
 }
 
 std::string SymbolTableImpl::toString(const StatName& stat_name) const {
@@ -157,7 +153,7 @@ std::string SymbolTableImpl::decodeSymbolVec(const SymbolVec& symbols) const {
   name_tokens.reserve(symbols.size());
   {
     // Hold the lock only while decoding symbols.
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&decode_lock_);
     for (Symbol symbol : symbols) {
       name_tokens.push_back(fromSymbol(symbol));
     }
@@ -165,89 +161,130 @@ std::string SymbolTableImpl::decodeSymbolVec(const SymbolVec& symbols) const {
   return absl::StrJoin(name_tokens, ".");
 }
 
-void SymbolTableImpl::incRefCount(const StatName& stat_name) {
-  // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
-  const SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
-
-  Thread::LockGuard lock(lock_);
+std::vector<absl::string_view> SymbolTableImpl::symbolsToTokens(const SymbolVec& symbols) const {
+  std::vector<absl::string_view> tokens;
+  tokens.reserve(symbols.size());
+  absl::ReaderMutexLock lock(&decode_lock_);
   for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-    ASSERT(decode_search != decode_map_.end());
-
-    auto encode_search = encode_map_.find(*decode_search->second);
-    ASSERT(encode_search != encode_map_.end());
+    tokens.push_back(fromSymbol(symbol));
+  }
+  return tokens;
+}
 
+void SymbolTableImpl::incRefCount(const StatName& stat_name) {
+  // Before taking any lock, decode the array of symbols from the SymbolTable::Storage.
+  const SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
+  const std::vector<absl::string_view> tokens = symbolsToTokens(symbols);
+
+  // The caller holds a reference to the symbols, so none of them can be removed concurrently and
+  // a reader lock is enough to bump the ref counts.
+  for (absl::string_view token : tokens) {
+    Stripe& token_stripe = stripe(token);
+    absl::ReaderMutexLock lock(&token_stripe.mutex_);
+    auto encode_search = token_stripe.encode_map_.find(token);
+    ASSERT(encode_search != token_stripe.encode_map_.end());
     ++encode_search->second.ref_count_;
   }
 }
 
 void SymbolTableImpl::free(const StatName& stat_name) {
-  // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
+  // Before taking any lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
+  const std::vector<absl::string_view> tokens = symbolsToTokens(symbols);
 
-  Thread::LockGuard lock(lock_);
-  for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-    ASSERT(decode_search != decode_map_.end());
-
-    auto encode_search = encode_map_.find(*decode_search->second);
-    ASSERT(encode_search != encode_map_.end());
-
-    // If that was the last remaining client usage of the symbol, erase the
-    // current mappings and add the now-unused symbol to the reuse pool.
-    //
-    // The "if (--EXPR.ref_count_)" pattern speeds up BM_CreateRace by 20% in
-    // symbol_table_speed_test.cc, relative to breaking out the decrement into a
-    // separate step, likely due to the non-trivial dereferences in EXPR.
-    if (--encode_search->second.ref_count_ == 0) {
-      decode_map_.erase(decode_search);
-      encode_map_.erase(encode_search);
-      pool_.push(symbol);
+  for (uint64_t i = 0; i < symbols.size(); ++i) {
+    releaseSymbol(symbols[i], tokens[i]);
+  }
+}
+
+void SymbolTableImpl::releaseSymbol(Symbol symbol, absl::string_view token) {
+  Stripe& token_stripe = stripe(token);
+  {
+    // Drop the reference under the reader lock unless it is the last one.
+    absl::ReaderMutexLock lock(&token_stripe.mutex_);
+    auto encode_search = token_stripe.encode_map_.find(token);
+    ASSERT(encode_search != token_stripe.encode_map_.end());
+    std::atomic<uint32_t>& ref_count = encode_search->second.ref_count_;
+    uint32_t count = ref_count.load();
+    while (count > 1) {
+      if (ref_count.compare_exchange_weak(count, count - 1)) {
+        return;
+      }
     }
   }
+
+  // Another thread may have taken or dropped references in between, so look the symbol up again
+  // under the writer lock, where its ref count cannot change under us.
+  absl::MutexLock lock(&token_stripe.mutex_);
+  auto encode_search = token_stripe.encode_map_.find(token);
+  ASSERT(encode_search != token_stripe.encode_map_.end());
+
+  // If that was the last remaining client usage of the symbol, erase the
+  // current mappings and add the now-unused symbol to the reuse pool.
+  if (--encode_search->second.ref_count_ == 0) {
+    // The token is owned by the decode map, so it must be erased from the encode map first.
+    token_stripe.encode_map_.erase(encode_search);
+    absl::MutexLock decode_lock(&decode_lock_);
+    decode_map_.erase(symbol);
+    pool_.push(symbol);
+  }
 }
+
 Symbol SymbolTableImpl::toSymbol(absl::string_view sv) {
+  Stripe& token_stripe = stripe(sv);
+  {
+    // If the string segment already exists, up the refcount at that location and return its
+    // symbol. This is the common case, which only needs a reader lock.
+    absl::ReaderMutexLock lock(&token_stripe.mutex_);
+    auto encode_find = token_stripe.encode_map_.find(sv);
+    if (encode_find != token_stripe.encode_map_.end()) {
+      ++encode_find->second.ref_count_;
+      return encode_find->second.symbol_;
+    }
+  }
+
+  absl::MutexLock lock(&token_stripe.mutex_);
+  // Another thread may have inserted the string segment while we were not holding the lock.
+  auto encode_find = token_stripe.encode_map_.find(sv);
+  if (encode_find != token_stripe.encode_map_.end()) {
+    ++encode_find->second.ref_count_;
+    return encode_find->second.symbol_;
+  }
+
+  // We create the actual string, place it in the decode_map_, and then insert
+  // a string_view pointing to it in the encode_map_. This allows us to only
+  // store the string once. We use unique_ptr so copies are not made as
+  // flat_hash_map moves values around.
+  auto str = std::make_unique<std::string>(std::string(sv));
+  const absl::string_view token = *str;
   Symbol result;
-  auto encode_find = encode_map_.find(sv);
-  // If the string segment doesn't already exist,
-  if (encode_find == encode_map_.end()) {
-    // We create the actual string, place it in the decode_map_, and then insert
-    // a string_view pointing to it in the encode_map_. This allows us to only
-    // store the string once. We use unique_ptr so copies are not made as
-    // flat_hash_map moves values around.
-    auto str = std::make_unique<std::string>(std::string(sv));
-    auto encode_insert = encode_map_.insert({*str, SharedSymbol(next_symbol_)});
-    ASSERT(encode_insert.second);
-    auto decode_insert = decode_map_.insert({next_symbol_, std::move(str)});
+  {
+    absl::MutexLock decode_lock(&decode_lock_);
+    result = newSymbol();
+    auto decode_insert = decode_map_.insert({result, std::move(str)});
     ASSERT(decode_insert.second);
-
-    result = next_symbol_;
-    newSymbol();
-  } else {
-    // If the insertion didn't take place, return the actual value at that location and up the
-    // refcount at that location
-    result = encode_find->second.symbol_;
-    ++(encode_find->second.ref_count_);
   }
+  auto encode_insert = token_stripe.encode_map_.try_emplace(token, result);
+  ASSERT(encode_insert.second);
   return result;
 }
 
 absl::string_view SymbolTableImpl::fromSymbol(const Symbol symbol) const
-    EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    SHARED_LOCKS_REQUIRED(decode_lock_) {
   auto search = decode_map_.find(symbol);
   RELEASE_ASSERT(search != decode_map_.end(), "no such symbol");
   return {*search->second};
 }
 
-void SymbolTableImpl::newSymbol() EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+Symbol SymbolTableImpl::newSymbol() EXCLUSIVE_LOCKS_REQUIRED(decode_lock_) {
   if (pool_.empty()) {
-    next_symbol_ = ++monotonic_counter_;
-  } else {
-    next_symbol_ = pool_.top();
-    pool_.pop();
+    // This should catch integer overflow for the new symbol.
+    ASSERT(monotonic_counter_ + 1 != 0);
+    return monotonic_counter_++;
   }
-  // This should catch integer overflow for the new symbol.
-  ASSERT(monotonic_counter_ != 0);
+  const Symbol symbol = pool_.top();
+  pool_.pop();
+  return symbol;
 }
 
 bool SymbolTableImpl::lessThan(const StatName& a, const StatName& b) const {
@@ -260,7 +297,7 @@ bool SymbolTableImpl::lessThan(const StatName& a, const StatName& b) const {
 
   // Calling fromSymbol requires holding the lock, as it needs read-access to
   // the maps that are written when adding new symbols.
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&decode_lock_);
   for (uint64_t i = 0, n = std::min(av.size(), bv.size()); i < n; ++i) {
     if (av[i] != bv[i]) {
       bool ret = fromSymbol(av[i]) < fromSymbol(bv[i]);
@@ -272,16 +309,22 @@ bool SymbolTableImpl::lessThan(const StatName& a, const StatName& b) const {
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTableImpl::debugPrint() const {
-  Thread::LockGuard lock(lock_);
-  std::vector<Symbol> symbols;
-  for (const auto& p : decode_map_) {
-    symbols.push_back(p.first);
+  // The decode lock may not be held while taking the lock of a stripe, so copy the tokens first.
+  std::vector<std::pair<Symbol, std::string>> tokens;
+  {
+    absl::ReaderMutexLock lock(&decode_lock_);
+    for (const auto& p : decode_map_) {
+      tokens.emplace_back(p.first, *p.second);
+    }
   }
-  std::sort(symbols.begin(), symbols.end());
-  for (Symbol symbol : symbols) {
-    const std::string& token = *decode_map_.find(symbol)->second;
-    const SharedSymbol& shared_symbol = encode_map_.find(token)->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token, shared_symbol.ref_count_);
+  std::sort(tokens.begin(), tokens.end());
+  for (const auto& p : tokens) {
+    const Stripe& token_stripe = stripe(p.second);
+    absl::ReaderMutexLock lock(&token_stripe.mutex_);
+    auto encode_search = token_stripe.encode_map_.find(p.second);
+    const uint32_t ref_count =
+        encode_search == token_stripe.encode_map_.end() ? 0 : encode_search->second.ref_count_.load();
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", p.first, p.second, ref_count);
   }
 }
 #endif
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <memory>
 #include <stack>
@@ -20,8 +21,10 @@
 #include "common/common/utility.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Stats {
@@ -167,11 +170,26 @@ private:
     SharedSymbol(Symbol symbol) : symbol_(symbol), ref_count_(1) {}
 
     Symbol symbol_;
-    uint32_t ref_count_;
+    // Incremented while holding only a reader lock on the stripe of the symbol. It is decremented
+    // to zero only while holding the writer lock, so that a symbol being removed is never revived.
+    std::atomic<uint32_t> ref_count_;
   };
 
-  // This must be held during both encode() and free().
-  mutable Thread::MutexBasicLockable lock_;
+  // The encode map stores both the symbol and the ref count of that symbol. Using
+  // absl::string_view lets us only store the complete string once, in the decode map. A node map
+  // keeps the atomic ref counts in place as the map grows.
+  using EncodeMap = absl::node_hash_map<absl::string_view, SharedSymbol, StringViewHash>;
+  using DecodeMap = absl::flat_hash_map<Symbol, std::unique_ptr<std::string>>;
+
+  // The encode map is striped by the hash of the token, so that threads encoding different
+  // tokens do not contend. Encoding a token that already has a symbol only takes a reader lock on
+  // its stripe; the writer lock is taken to insert or remove tokens.
+  struct Stripe {
+    mutable absl::Mutex mutex_;
+    EncodeMap encode_map_ GUARDED_BY(mutex_);
+  };
+  static constexpr uint32_t NumStripesBits = 4;
+  static constexpr uint32_t NumStripes = 1 << NumStripesBits;
 
   /**
    * Decodes a vector of symbols back into its period-delimited stat name. If
@@ -184,13 +202,19 @@ private:
    */
   std::string decodeSymbolVec(const SymbolVec& symbols) const;
 
+  /**
+   * Decodes symbols into the tokens they stand for. The tokens remain valid as long as the caller
+   * holds a reference to the symbols.
+   */
+  std::vector<absl::string_view> symbolsToTokens(const SymbolVec& symbols) const;
+
   /**
    * Convenience function for encode(), symbolizing one string segment at a time.
    *
    * @param sv the individual string to be encoded as a symbol.
    * @return Symbol the encoded string.
    */
-  Symbol toSymbol(absl::string_view sv) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  Symbol toSymbol(absl::string_view sv);
 
   /**
    * Convenience function for decode(), decoding one symbol at a time.
@@ -198,12 +222,26 @@ private:
    * @param symbol the individual symbol to be decoded.
    * @return absl::string_view the decoded string.
    */
-  absl::string_view fromSymbol(Symbol symbol) const EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  absl::string_view fromSymbol(Symbol symbol) const SHARED_LOCKS_REQUIRED(decode_lock_);
 
   /**
-   * Stages a new symbol for use. To be called after a successful insertion.
+   * Releases one reference to the symbol of a token, removing the symbol if that was the last one.
    */
-  void newSymbol();
+  void releaseSymbol(Symbol symbol, absl::string_view token);
+
+  /**
+   * @return a symbol for a new token, re-using a freed symbol if there is one.
+   */
+  Symbol newSymbol() EXCLUSIVE_LOCKS_REQUIRED(decode_lock_);
+
+  /**
+   * @return the stripe of the encode map holding the token.
+   */
+  Stripe& stripe(absl::string_view token) const {
+    // The low bits of the hash are used by the maps themselves, so the stripe is picked by the
+    // high bits.
+    return stripes_[StringViewHash()(token) >> (64 - NumStripesBits)];
+  }
 
   /**
    * Tokenizes name, finds or allocates symbols for each token, and adds them
@@ -215,29 +253,25 @@ private:
   void addTokensToEncoding(absl::string_view name, Encoding& encoding);
 
   Symbol monotonicCounter() {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&decode_lock_);
     return monotonic_counter_;
   }
 
-  // Stores the symbol to be used at next insertion. This should exist ahead of insertion time so
-  // that if insertion succeeds, the value written is the correct one.
-  Symbol next_symbol_ GUARDED_BY(lock_);
+  mutable Stripe stripes_[NumStripes];
+
+  // Guards the decode map and the allocation of symbols. When both are held, the lock of a stripe
+  // must be taken before this one.
+  mutable absl::Mutex decode_lock_;
 
   // If the free pool is exhausted, we monotonically increase this counter.
-  Symbol monotonic_counter_;
+  Symbol monotonic_counter_ GUARDED_BY(decode_lock_);
 
-  // Bitmap implementation.
-  // The encode map stores both the symbol and the ref count of that symbol.
-  // Using absl::string_view lets us only store the complete string once, in the decode map.
-  using EncodeMap = absl::flat_hash_map<absl::string_view, SharedSymbol, StringViewHash>;
-  using DecodeMap = absl::flat_hash_map<Symbol, std::unique_ptr<std::string>>;
-  EncodeMap encode_map_ GUARDED_BY(lock_);
-  DecodeMap decode_map_ GUARDED_BY(lock_);
+  DecodeMap decode_map_ GUARDED_BY(decode_lock_);
 
   // Free pool of symbols for re-use.
   // TODO(ambuc): There might be an optimization here relating to storing ranges of freed symbols
   // using an Envoy::IntervalSet.
-  std::stack<Symbol> pool_ GUARDED_BY(lock_);
+  std::stack<Symbol> pool_ GUARDED_BY(decode_lock_);
 };
 
 /**
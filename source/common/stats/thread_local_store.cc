@@ -146,6 +146,11 @@ std::vector<ParentHistogramSharedPtr> ThreadLocalStoreImpl::histograms() const {
   return ret;
 }
 
+void ThreadLocalStoreImpl::enablePerWorkerStats(uint32_t concurrency) {
+  // The main thread updates stats as well, so it gets a shard of its own.
+  stat_shards_ = concurrency + 1;
+}
+
 void ThreadLocalStoreImpl::initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                                                ThreadLocal::Instance& tls) {
   threading_ever_initialized_ = true;
@@ -184,6 +189,14 @@ void ThreadLocalStoreImpl::mergeHistograms(PostMergeCb merge_complete_cb) {
 
 void ThreadLocalStoreImpl::mergeInternal(PostMergeCb merge_complete_cb) {
   if (!shutting_down_) {
+    {
+      Thread::LockGuard lock(lock_);
+      for (ScopeImpl* scope : scopes_) {
+        for (const ShardedStatSharedPtr& stat : scope->central_cache_.sharded_stats_) {
+          stat->merge();
+        }
+      }
+    }
     for (const ParentHistogramSharedPtr& histogram : histograms()) {
       histogram->merge();
     }
@@ -259,6 +272,10 @@ ThreadLocalStoreImpl::ScopeImpl::ScopeImpl(ThreadLocalStoreImpl& parent, const s
       prefix_(Utility::sanitizeStatsName(prefix), parent.symbolTable()) {}
 
 ThreadLocalStoreImpl::ScopeImpl::~ScopeImpl() {
+  // Stats shared with other scopes keep the values that were not merged yet.
+  for (const ShardedStatSharedPtr& stat : central_cache_.sharded_stats_) {
+    stat->merge();
+  }
   parent_.releaseScopeCrossThread(this);
   prefix_.free(symbolTable());
 }
@@ -398,9 +415,16 @@ Counter& ThreadLocalStoreImpl::ScopeImpl::counterFromStatName(StatName name) {
 
   return safeMakeStat<Counter>(
       final_stat_name, central_cache_.counters_, central_cache_.rejected_stats_,
-      [](StatDataAllocator& allocator, StatName name, absl::string_view tag_extracted_name,
-         const std::vector<Tag>& tags) -> CounterSharedPtr {
-        return allocator.makeCounter(name, tag_extracted_name, tags);
+      [this](StatDataAllocator& allocator, StatName name, absl::string_view tag_extracted_name,
+             const std::vector<Tag>& tags) -> CounterSharedPtr {
+        CounterSharedPtr counter = allocator.makeCounter(name, tag_extracted_name, tags);
+        const uint32_t shards = parent_.stat_shards_;
+        if (shards == 0) {
+          return counter;
+        }
+        auto sharded_counter = std::make_shared<ShardedCounterImpl>(std::move(counter), shards);
+        central_cache_.sharded_stats_.push_back(sharded_counter);
+        return sharded_counter;
       },
       tls_cache, tls_rejected_stats, parent_.null_counter_);
 }
@@ -447,9 +471,16 @@ Gauge& ThreadLocalStoreImpl::ScopeImpl::gaugeFromStatName(StatName name) {
 
   return safeMakeStat<Gauge>(
       final_stat_name, central_cache_.gauges_, central_cache_.rejected_stats_,
-      [](StatDataAllocator& allocator, StatName name, absl::string_view tag_extracted_name,
-         const std::vector<Tag>& tags) -> GaugeSharedPtr {
-        return allocator.makeGauge(name, tag_extracted_name, tags);
+      [this](StatDataAllocator& allocator, StatName name, absl::string_view tag_extracted_name,
+             const std::vector<Tag>& tags) -> GaugeSharedPtr {
+        GaugeSharedPtr gauge = allocator.makeGauge(name, tag_extracted_name, tags);
+        const uint32_t shards = parent_.stat_shards_;
+        if (shards == 0) {
+          return gauge;
+        }
+        auto sharded_gauge = std::make_shared<ShardedGaugeImpl>(std::move(gauge), shards);
+        central_cache_.sharded_stats_.push_back(sharded_gauge);
+        return sharded_gauge;
       },
       tls_cache, tls_rejected_stats, parent_.null_gauge_);
 }
@@ -559,6 +590,58 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::tlsHistogram(StatName name,
   return *hist_tls_ptr;
 }
 
+StatShards::StatShards(uint32_t count)
+    : count_(count), storage_(new char[count * sizeof(Shard) + alignof(Shard) - 1]) {
+  ASSERT(count > 0);
+  void* aligned = storage_.get();
+  size_t space = count * sizeof(Shard) + alignof(Shard) - 1;
+  aligned = std::align(alignof(Shard), count * sizeof(Shard), aligned, space);
+  ASSERT(aligned != nullptr);
+  shards_ = static_cast<Shard*>(aligned);
+  for (uint32_t i = 0; i < count; i++) {
+    new (&shards_[i]) Shard();
+  }
+}
+
+uint32_t StatShards::threadIndex() {
+  static std::atomic<uint32_t> next_thread_index;
+  static thread_local const uint32_t thread_index = next_thread_index++;
+  return thread_index;
+}
+
+uint64_t StatShards::sum() const {
+  uint64_t sum = 0;
+  for (uint32_t i = 0; i < count_; i++) {
+    sum += shards_[i].value_.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+uint64_t StatShards::drain() {
+  uint64_t sum = 0;
+  for (uint32_t i = 0; i < count_; i++) {
+    sum += shards_[i].value_.exchange(0, std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+void ShardedCounterImpl::merge() {
+  const uint64_t amount = shards_.drain();
+  if (amount > 0) {
+    parent_->add(amount);
+  }
+}
+
+void ShardedGaugeImpl::merge() {
+  // Shards are updated by two's complement, so a negative sum is a net subtraction.
+  const int64_t amount = static_cast<int64_t>(shards_.drain());
+  if (amount > 0) {
+    parent_->add(amount);
+  } else if (amount < 0) {
+    parent_->sub(-static_cast<uint64_t>(amount));
+  }
+}
+
 ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name,
                                                    absl::string_view tag_extracted_name,
                                                    const std::vector<Tag>& tags,
@@ -4,7 +4,9 @@
 #include <chrono>
 #include <cstdint>
 #include <list>
+#include <memory>
 #include <string>
+#include <type_traits>
 
 #include "envoy/thread_local/thread_local.h"
 
@@ -14,6 +16,7 @@
 #include "common/stats/symbol_table_impl.h"
 #include "common/stats/utility.h"
 
+#include "absl/base/optimization.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "circllhist.h"
@@ -115,6 +118,151 @@ private:
 
 using ParentHistogramImplSharedPtr = std::shared_ptr<ParentHistogramImpl>;
 
+/**
+ * Per thread deltas of a counter or gauge that have not been merged into the stat yet. Each thread
+ * adds to its own shard, which has a cache line of its own, so that threads updating the same stat
+ * do not contend for it. Threads are assigned to shards round robin, so threads beyond the number
+ * of shards share one; adding to a shard remains safe from any thread.
+ */
+class StatShards {
+public:
+  explicit StatShards(uint32_t count);
+
+  /**
+   * Adds to the shard of the calling thread. Values wrap around, so adding the two's complement
+   * of an amount subtracts it.
+   */
+  void add(uint64_t amount) {
+    shards_[threadIndex() % count_].value_.fetch_add(amount, std::memory_order_relaxed);
+  }
+
+  /**
+   * @return the sum of all shards, which may be racing with concurrent adds.
+   */
+  uint64_t sum() const;
+
+  /**
+   * Clears all shards.
+   * @return the sum of the shards that were cleared.
+   */
+  uint64_t drain();
+
+  /**
+   * @return the address of a shard, for testing its alignment.
+   */
+  const void* shardForTest(uint32_t index) const { return &shards_[index]; }
+
+private:
+  // Each shard has a cache line of its own so that threads adding to different shards do not
+  // contend. Operator new does not honour an alignment beyond the default one before C++17, so
+  // the shards are constructed in storage which is aligned by hand.
+  struct alignas(ABSL_CACHELINE_SIZE) Shard {
+    std::atomic<uint64_t> value_{0};
+  };
+  static_assert(std::is_trivially_destructible<Shard>::value,
+                "the shards are released without running their destructors");
+
+  static uint32_t threadIndex();
+
+  const uint32_t count_;
+  std::unique_ptr<char[]> storage_;
+  Shard* shards_;
+};
+
+/**
+ * A counter or gauge with per thread shards, which are merged into the parent stat by merge().
+ */
+class ShardedStat {
+public:
+  virtual ~ShardedStat() {}
+
+  /**
+   * Moves the values of all shards into the parent stat.
+   */
+  virtual void merge() PURE;
+};
+
+using ShardedStatSharedPtr = std::shared_ptr<ShardedStat>;
+
+/**
+ * Forwards the naming and tagging of a sharded stat to the parent stat made by the allocator.
+ */
+template <class Base> class ShardedMetric : public Base, public ShardedStat {
+public:
+  ShardedMetric(std::shared_ptr<Base> parent, uint32_t shards)
+      : parent_(std::move(parent)), shards_(shards) {}
+
+  // Stats::Metric
+  std::string name() const override { return parent_->name(); }
+  StatName statName() const override { return parent_->statName(); }
+  std::vector<Tag> tags() const override { return parent_->tags(); }
+  std::string tagExtractedName() const override { return parent_->tagExtractedName(); }
+  StatName tagExtractedStatName() const override { return parent_->tagExtractedStatName(); }
+  void iterateTagStatNames(const Metric::TagStatNameIterFn& fn) const override {
+    parent_->iterateTagStatNames(fn);
+  }
+  void iterateTags(const Metric::TagIterFn& fn) const override { parent_->iterateTags(fn); }
+  bool used() const override { return parent_->used() || shards_.sum() != 0; }
+  SymbolTable& symbolTable() override { return parent_->symbolTable(); }
+  const SymbolTable& constSymbolTable() const override { return parent_->constSymbolTable(); }
+
+protected:
+  const std::shared_ptr<Base> parent_;
+  StatShards shards_;
+};
+
+/**
+ * Counter whose increments go to the shard of the incrementing thread. The shards are merged
+ * into the parent counter during the stats flush, and before the counter is latched.
+ */
+class ShardedCounterImpl : public ShardedMetric<Counter> {
+public:
+  using ShardedMetric::ShardedMetric;
+
+  // Stats::Counter
+  void add(uint64_t amount) override { shards_.add(amount); }
+  void inc() override { add(1); }
+  uint64_t latch() override {
+    merge();
+    return parent_->latch();
+  }
+  void reset() override {
+    shards_.drain();
+    parent_->reset();
+  }
+  uint64_t value() const override { return parent_->value() + shards_.sum(); }
+
+  // Stats::ShardedStat
+  void merge() override;
+};
+
+/**
+ * Gauge whose additions and subtractions go to the shard of the calling thread. Setting the gauge
+ * discards the unmerged shards and sets the parent gauge directly.
+ */
+class ShardedGaugeImpl : public ShardedMetric<Gauge> {
+public:
+  using ShardedMetric::ShardedMetric;
+
+  // Stats::Gauge
+  void add(uint64_t amount) override { shards_.add(amount); }
+  void dec() override { sub(1); }
+  void inc() override { add(1); }
+  void set(uint64_t value) override {
+    shards_.drain();
+    parent_->set(value);
+  }
+  void sub(uint64_t amount) override { shards_.add(-amount); }
+  uint64_t value() const override { return parent_->value() + shards_.sum(); }
+  absl::optional<bool> cachedShouldImport() const override {
+    return parent_->cachedShouldImport();
+  }
+  void setShouldImport(bool should_import) override { parent_->setShouldImport(should_import); }
+
+  // Stats::ShardedStat
+  void merge() override;
+};
+
 /**
  * Class used to create ThreadLocalHistogram in the scope.
  */
@@ -205,6 +353,7 @@ public:
     tag_producer_ = std::move(tag_producer);
   }
   void setStatsMatcher(StatsMatcherPtr&& stats_matcher) override;
+  void enablePerWorkerStats(uint32_t concurrency) override;
   void initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                            ThreadLocal::Instance& tls) override;
   void shutdownThreading() override;
@@ -233,6 +382,8 @@ private:
     StatMap<GaugeSharedPtr> gauges_;
     StatMap<ParentHistogramImplSharedPtr> histograms_;
     StatNameStorageSet rejected_stats_;
+    // The counters and gauges above that are sharded, which are merged during the stats flush.
+    std::vector<ShardedStatSharedPtr> sharded_stats_;
   };
 
   struct ScopeImpl : public TlsScope {
@@ -355,6 +506,8 @@ private:
   std::atomic<bool> threading_ever_initialized_{};
   std::atomic<bool> shutting_down_{};
   std::atomic<bool> merge_in_progress_{};
+  // The number of shards of counters and gauges created from now on, or 0 if they are not sharded.
+  std::atomic<uint32_t> stat_shards_{};
   HeapStatDataAllocator heap_allocator_;
 
   NullCounterImpl null_counter_;
@@ -0,0 +1,233 @@
+#include "common/tcp_proxy/splicer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "envoy/event/dispatcher.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace TcpProxy {
+
+Splicer::Direction::Direction(Splicer& parent, Network::Connection& source, int source_fd,
+                              Network::Connection& destination, int destination_fd)
+    : parent_(parent), source_(source), source_fd_(source_fd), destination_(destination),
+      destination_fd_(destination_fd) {}
+
+Splicer::Direction::~Direction() {
+  for (int fd : pipe_) {
+    if (fd != -1) {
+      ::close(fd);
+    }
+  }
+}
+
+#ifdef __linux__
+
+bool Splicer::Direction::createPipe() { return ::pipe2(pipe_, O_NONBLOCK | O_CLOEXEC) == 0; }
+
+void Splicer::Direction::onSourceReadable() {
+  source_readable_ = true;
+  transfer();
+}
+
+void Splicer::Direction::transfer() {
+  // Like the read loop of the connection, yield to other connections once a buffer's worth of data
+  // has been moved.
+  const uint64_t limit = source_.bufferLimit();
+  uint64_t moved = 0;
+  while (active_) {
+    if (pipe_bytes_ == 0) {
+      if (!source_readable_) {
+        return;
+      }
+      if (limit > 0 && moved >= limit) {
+        parent_.onYield(*this);
+        return;
+      }
+      const ssize_t rc = ::splice(source_fd_, nullptr, pipe_[1], nullptr, MaxSpliceSize,
+                                  SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (rc == 0) {
+        parent_.onEndStream(*this);
+        return;
+      }
+      if (rc < 0) {
+        if (errno == EAGAIN) {
+          source_readable_ = false;
+          return;
+        }
+        if (errno != EINTR) {
+          parent_.onError(source_, errno);
+          return;
+        }
+        continue;
+      }
+      pipe_bytes_ = rc;
+    }
+
+    const ssize_t rc = ::splice(pipe_[0], nullptr, destination_fd_, nullptr, pipe_bytes_,
+                                SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (rc < 0) {
+      if (errno == EAGAIN) {
+        // Wait for the destination to become writable.
+        return;
+      }
+      if (errno != EINTR) {
+        parent_.onError(destination_, errno);
+        return;
+      }
+      continue;
+    }
+    ASSERT(static_cast<uint64_t>(rc) <= pipe_bytes_);
+    pipe_bytes_ -= rc;
+    moved += rc;
+    parent_.onBytesSpliced(*this, rc);
+  }
+}
+
+SplicerPtr Splicer::create(Network::Connection& downstream, Network::Connection& upstream,
+                           SplicerCallbacks& callbacks) {
+  Network::IoHandle* downstream_handle = downstream.rawIoHandle();
+  Network::IoHandle* upstream_handle = upstream.rawIoHandle();
+  if (downstream_handle == nullptr || upstream_handle == nullptr) {
+    return nullptr;
+  }
+
+  SplicerPtr splicer(new Splicer(downstream, downstream_handle->fd(), upstream,
+                                 upstream_handle->fd(), callbacks));
+  if (!splicer->downstream_to_upstream_.createPipe() ||
+      !splicer->upstream_to_downstream_.createPipe()) {
+    ENVOY_LOG(debug, "unable to create splice pipes: {}", strerror(errno));
+    return nullptr;
+  }
+  splicer->start();
+  return splicer;
+}
+
+#else
+
+bool Splicer::Direction::createPipe() { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+void Splicer::Direction::onSourceReadable() { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+void Splicer::Direction::transfer() { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+SplicerPtr Splicer::create(Network::Connection&, Network::Connection&, SplicerCallbacks&) {
+  return nullptr;
+}
+
+#endif
+
+Splicer::Splicer(Network::Connection& downstream, int downstream_fd, Network::Connection& upstream,
+                 int upstream_fd, SplicerCallbacks& callbacks)
+    : downstream_(downstream), upstream_(upstream), downstream_fd_(downstream_fd),
+      upstream_fd_(upstream_fd), callbacks_(callbacks),
+      downstream_to_upstream_(*this, downstream, downstream_fd, upstream, upstream_fd),
+      upstream_to_downstream_(*this, upstream, upstream_fd, downstream, downstream_fd) {}
+
+Splicer::~Splicer() { disable(); }
+
+void Splicer::start() {
+  ENVOY_CONN_LOG(debug, "splicing data to and from upstream connection {}", downstream_,
+                 upstream_.id());
+  downstream_.readDisable(true);
+  upstream_.readDisable(true);
+
+  // Both connections watch their sockets with edge triggered events as well, and libevent requires
+  // all the events of a file descriptor to agree on the trigger type.
+  Event::Dispatcher& dispatcher = downstream_.dispatcher();
+  downstream_event_ = dispatcher.createFileEvent(
+      downstream_fd_, [this](uint32_t events) -> void { onDownstreamEvent(events); },
+      Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
+  upstream_event_ = dispatcher.createFileEvent(
+      upstream_fd_, [this](uint32_t events) -> void { onUpstreamEvent(events); },
+      Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
+
+  // Data may have been received before the events were registered.
+  downstream_event_->activate(Event::FileReadyType::Read);
+  upstream_event_->activate(Event::FileReadyType::Read);
+}
+
+void Splicer::disable() {
+  downstream_to_upstream_.disable();
+  upstream_to_downstream_.disable();
+  downstream_event_.reset();
+  upstream_event_.reset();
+}
+
+void Splicer::onDownstreamEvent(uint32_t events) {
+  if ((events & Event::FileReadyType::Read) && downstream_to_upstream_.active()) {
+    downstream_to_upstream_.onSourceReadable();
+  }
+  if ((events & Event::FileReadyType::Write) && upstream_to_downstream_.active()) {
+    upstream_to_downstream_.onDestinationWritable();
+  }
+}
+
+void Splicer::onUpstreamEvent(uint32_t events) {
+  if ((events & Event::FileReadyType::Read) && upstream_to_downstream_.active()) {
+    upstream_to_downstream_.onSourceReadable();
+  }
+  if ((events & Event::FileReadyType::Write) && downstream_to_upstream_.active()) {
+    downstream_to_upstream_.onDestinationWritable();
+  }
+}
+
+void Splicer::onBytesSpliced(Direction& direction, uint64_t bytes) {
+  if (&direction == &downstream_to_upstream_) {
+    callbacks_.onDownstreamBytesSpliced(bytes);
+  } else {
+    callbacks_.onUpstreamBytesSpliced(bytes);
+  }
+}
+
+void Splicer::onEndStream(Direction& direction) {
+  const bool downstream = &direction == &downstream_to_upstream_;
+  ENVOY_CONN_LOG(trace, "{} end of stream while splicing", downstream_,
+                 downstream ? "downstream" : "upstream");
+  direction.disable();
+  updateEvents();
+  // The connection reads the end of stream again and forwards it through the filter chain.
+  (downstream ? downstream_ : upstream_).readDisable(false);
+}
+
+void Splicer::onError(Network::Connection& connection, int error) {
+  ENVOY_CONN_LOG(debug, "splice error on connection {}: {}", downstream_, connection.id(),
+                 strerror(error));
+  disable();
+  callbacks_.onSpliceError(connection);
+}
+
+void Splicer::onYield(Direction& direction) {
+  if (&direction == &downstream_to_upstream_) {
+    downstream_event_->activate(Event::FileReadyType::Read);
+  } else {
+    upstream_event_->activate(Event::FileReadyType::Read);
+  }
+}
+
+void Splicer::updateEvents() {
+  const uint32_t downstream_events =
+      (downstream_to_upstream_.active() ? Event::FileReadyType::Read : 0) |
+      (upstream_to_downstream_.active() ? Event::FileReadyType::Write : 0);
+  const uint32_t upstream_events =
+      (upstream_to_downstream_.active() ? Event::FileReadyType::Read : 0) |
+      (downstream_to_upstream_.active() ? Event::FileReadyType::Write : 0);
+  if (downstream_events == 0) {
+    downstream_event_.reset();
+  } else {
+    downstream_event_->setEnabled(downstream_events);
+  }
+  if (upstream_events == 0) {
+    upstream_event_.reset();
+  } else {
+    upstream_event_->setEnabled(upstream_events);
+  }
+}
+
+} // namespace TcpProxy
+} // namespace Envoy
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/pure.h"
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/file_event.h"
+#include "envoy/network/connection.h"
+
+#include "common/common/logger.h"
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace TcpProxy {
+
+/**
+ * Callbacks used by a Splicer to report the data it moved and the failures it hit.
+ */
+class SplicerCallbacks {
+public:
+  virtual ~SplicerCallbacks() {}
+
+  /**
+   * Called when data received on the downstream connection was written to the upstream socket.
+   * @param bytes supplies the number of bytes written.
+   */
+  virtual void onDownstreamBytesSpliced(uint64_t bytes) PURE;
+
+  /**
+   * Called when data received on the upstream connection was written to the downstream socket.
+   * @param bytes supplies the number of bytes written.
+   */
+  virtual void onUpstreamBytesSpliced(uint64_t bytes) PURE;
+
+  /**
+   * Called when reading from or writing to the socket of a connection failed. The splicer no
+   * longer watches either socket when this is called, and the connection is expected to be closed.
+   * @param connection supplies the connection whose socket failed.
+   */
+  virtual void onSpliceError(Network::Connection& connection) PURE;
+};
+
+class Splicer;
+typedef std::unique_ptr<Splicer> SplicerPtr;
+
+/**
+ * Moves data between the sockets of a downstream and an upstream connection with splice(2),
+ * through a pipe per direction, so that the data is never copied to user space. Both connections
+ * are read disabled while data is spliced. When the source of a direction reaches the end of
+ * stream and its pipe is drained, reading is re-enabled on the source connection, which then
+ * observes the end of stream itself and handles it as usual. Connections must have half close
+ * enabled, so that they do not watch for early close while they are read disabled.
+ */
+class Splicer : public Event::DeferredDeletable, NonCopyable, Logger::Loggable<Logger::Id::filter> {
+public:
+  ~Splicer();
+
+  /**
+   * Start splicing data between two connections.
+   * @return SplicerPtr the splicer, or nullptr if the data of either connection cannot bypass it
+   *         (@see Network::Connection::rawIoHandle()) or splice(2) is not supported.
+   */
+  static SplicerPtr create(Network::Connection& downstream, Network::Connection& upstream,
+                           SplicerCallbacks& callbacks);
+
+  /**
+   * Stop watching the sockets, leaving the connections read disabled. This must be called before
+   * either connection is closed. Data that is still in flight is dropped.
+   */
+  void disable();
+
+  /**
+   * @return bool whether data is spliced in at least one direction.
+   */
+  bool active() const {
+    return downstream_to_upstream_.active() || upstream_to_downstream_.active();
+  }
+
+  // Upper bound of the data moved by one splice(2) call, which is the default capacity of a pipe.
+  static constexpr uint64_t MaxSpliceSize = 64 * 1024;
+
+private:
+  class Direction {
+  public:
+    Direction(Splicer& parent, Network::Connection& source, int source_fd,
+              Network::Connection& destination, int destination_fd);
+    ~Direction();
+
+    bool createPipe();
+    bool active() const { return active_; }
+    void onSourceReadable();
+    void onDestinationWritable() { transfer(); }
+    void disable() { active_ = false; }
+
+  private:
+    void transfer();
+
+    Splicer& parent_;
+    Network::Connection& source_;
+    const int source_fd_;
+    Network::Connection& destination_;
+    const int destination_fd_;
+    int pipe_[2]{-1, -1};
+    // Bytes read from the source which are in the pipe. The source is only read once the pipe is
+    // empty, so that a full pipe is never mistaken for a source without data.
+    uint64_t pipe_bytes_{};
+    // Cleared when reading from the source would block, set again by a read event.
+    bool source_readable_{true};
+    bool active_{true};
+  };
+
+  Splicer(Network::Connection& downstream, int downstream_fd, Network::Connection& upstream,
+          int upstream_fd, SplicerCallbacks& callbacks);
+
+  void start();
+  void onDownstreamEvent(uint32_t events);
+  void onUpstreamEvent(uint32_t events);
+  void onBytesSpliced(Direction& direction, uint64_t bytes);
+  void onEndStream(Direction& direction);
+  void onError(Network::Connection& connection, int error);
+  void onYield(Direction& direction);
+  void updateEvents();
+
+  Network::Connection& downstream_;
+  Network::Connection& upstream_;
+  const int downstream_fd_;
+  const int upstream_fd_;
+  SplicerCallbacks& callbacks_;
+  Direction downstream_to_upstream_;
+  Direction upstream_to_downstream_;
+  Event::FileEventPtr downstream_event_;
+  Event::FileEventPtr upstream_event_;
+};
+
+} // namespace TcpProxy
+} // namespace Envoy
@@ -68,7 +68,7 @@ Config::Config(const envoy::config::filter::network::tcp_proxy::v2::TcpProxy& co
     : max_connect_attempts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_connect_attempts, 1)),
       upstream_drain_manager_slot_(context.threadLocal().allocateSlot()),
       shared_config_(std::make_shared<SharedConfig>(config, context)),
-      random_generator_(context.random()) {
+      random_generator_(context.random()), zero_copy_forwarding_(config.zero_copy_forwarding()) {
 
   upstream_drain_manager_slot_->set([](Event::Dispatcher&) {
     return ThreadLocal::ThreadLocalObjectSharedPtr(new UpstreamDrainManager());
@@ -443,6 +443,45 @@ void Filter::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
   upstream_callbacks_->onEvent(Network::ConnectionEvent::Connected);
 
   read_callbacks_->continueReading();
+
+  if (config_->zeroCopyForwarding() && upstream_conn_data_ != nullptr &&
+      read_callbacks_->connection().state() == Network::Connection::State::Open) {
+    splicer_ = Splicer::create(read_callbacks_->connection(), upstream_conn_data_->connection(),
+                               *this);
+    if (splicer_ != nullptr) {
+      config_->stats().splice_cx_total_.inc();
+    } else {
+      ENVOY_CONN_LOG(debug, "data cannot be spliced, forwarding it through the connection buffers",
+                     read_callbacks_->connection());
+    }
+  }
+}
+
+void Filter::onDownstreamBytesSpliced(uint64_t bytes) {
+  getStreamInfo().addBytesReceived(bytes);
+  config_->stats().downstream_cx_rx_bytes_total_.add(bytes);
+  config_->stats().splice_bytes_total_.add(bytes);
+  resetIdleTimer();
+}
+
+void Filter::onUpstreamBytesSpliced(uint64_t bytes) {
+  getStreamInfo().addBytesSent(bytes);
+  config_->stats().downstream_cx_tx_bytes_total_.add(bytes);
+  config_->stats().splice_bytes_total_.add(bytes);
+  resetIdleTimer();
+}
+
+void Filter::onSpliceError(Network::Connection& connection) {
+  // This results in also closing the other connection.
+  connection.close(Network::ConnectionCloseType::NoFlush);
+}
+
+void Filter::disableSplicer() {
+  if (splicer_ != nullptr) {
+    // The splicer may be on the stack if it reported an error.
+    splicer_->disable();
+    read_callbacks_->connection().dispatcher().deferredDelete(std::move(splicer_));
+  }
 }
 
 void Filter::onConnectTimeout() {
@@ -458,6 +497,7 @@ Network::FilterStatus Filter::onData(Buffer::Instance& data, bool end_stream) {
   ENVOY_CONN_LOG(trace, "downstream connection received {} bytes, end_stream={}",
                  read_callbacks_->connection(), data.length(), end_stream);
   getStreamInfo().addBytesReceived(data.length());
+  config_->stats().copy_bytes_total_.add(data.length());
   upstream_conn_data_->connection().write(data, end_stream);
   ASSERT(0 == data.length());
   resetIdleTimer(); // TODO(ggreenway) PERF: do we need to reset timer on both send and receive?
@@ -465,6 +505,11 @@ Network::FilterStatus Filter::onData(Buffer::Instance& data, bool end_stream) {
 }
 
 void Filter::onDownstreamEvent(Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::RemoteClose ||
+      event == Network::ConnectionEvent::LocalClose) {
+    disableSplicer();
+  }
+
   if (upstream_conn_data_) {
     if (event == Network::ConnectionEvent::RemoteClose) {
       upstream_conn_data_->connection().close(Network::ConnectionCloseType::FlushWrite);
@@ -500,6 +545,7 @@ void Filter::onUpstreamData(Buffer::Instance& data, bool end_stream) {
   ENVOY_CONN_LOG(trace, "upstream connection received {} bytes, end_stream={}",
                  read_callbacks_->connection(), data.length(), end_stream);
   getStreamInfo().addBytesSent(data.length());
+  config_->stats().copy_bytes_total_.add(data.length());
   read_callbacks_->connection().write(data, end_stream);
   ASSERT(0 == data.length());
   resetIdleTimer(); // TODO(ggreenway) PERF: do we need to reset timer on both send and receive?
@@ -513,6 +559,7 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
 
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
+    disableSplicer();
     upstream_conn_data_.reset();
     disableIdleTimer();
 
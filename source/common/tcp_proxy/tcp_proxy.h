@@ -26,6 +26,7 @@
 #include "common/network/filter_impl.h"
 #include "common/network/utility.h"
 #include "common/stream_info/stream_info_impl.h"
+#include "common/tcp_proxy/splicer.h"
 #include "common/upstream/load_balancer_impl.h"
 
 namespace Envoy {
@@ -46,7 +47,10 @@ namespace TcpProxy {
   COUNTER(downstream_flow_control_resumed_reading_total)                                           \
   COUNTER(idle_timeout)                                                                            \
   COUNTER(upstream_flush_total)                                                                    \
-  GAUGE  (upstream_flush_active)
+  GAUGE  (upstream_flush_active)                                                                   \
+  COUNTER(splice_cx_total)                                                                         \
+  COUNTER(splice_bytes_total)                                                                      \
+  COUNTER(copy_bytes_total)
 // clang-format on
 
 /**
@@ -115,6 +119,7 @@ public:
   const Router::MetadataMatchCriteria* metadataMatchCriteria() {
     return cluster_metadata_match_criteria_.get();
   }
+  bool zeroCopyForwarding() const { return zero_copy_forwarding_; }
 
 private:
   struct Route {
@@ -151,6 +156,7 @@ private:
   SharedConfigSharedPtr shared_config_;
   std::unique_ptr<const Router::MetadataMatchCriteria> cluster_metadata_match_criteria_;
   Runtime::RandomGenerator& random_generator_;
+  const bool zero_copy_forwarding_;
 };
 
 typedef std::shared_ptr<Config> ConfigSharedPtr;
@@ -176,6 +182,7 @@ private:
 class Filter : public Network::ReadFilter,
                public Upstream::LoadBalancerContextBase,
                Tcp::ConnectionPool::Callbacks,
+               SplicerCallbacks,
                protected Logger::Loggable<Logger::Id::filter> {
 public:
   Filter(ConfigSharedPtr config, Upstream::ClusterManager& cluster_manager,
@@ -193,6 +200,11 @@ public:
   void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
                    Upstream::HostDescriptionConstSharedPtr host) override;
 
+  // TcpProxy::SplicerCallbacks
+  void onDownstreamBytesSpliced(uint64_t bytes) override;
+  void onUpstreamBytesSpliced(uint64_t bytes) override;
+  void onSpliceError(Network::Connection& connection) override;
+
   // Upstream::LoadBalancerContext
   const Router::MetadataMatchCriteria* metadataMatchCriteria() override {
     return config_->metadataMatchCriteria();
@@ -273,6 +285,7 @@ protected:
   void onIdleTimeout();
   void resetIdleTimer();
   void disableIdleTimer();
+  void disableSplicer();
 
   const ConfigSharedPtr config_;
   Upstream::ClusterManager& cluster_manager_;
@@ -286,6 +299,8 @@ protected:
   StreamInfo::StreamInfoImpl stream_info_;
   uint32_t connect_attempts_{};
   bool connecting_{};
+  // Declared last so that it stops watching the sockets before the connections are destroyed.
+  SplicerPtr splicer_;
 };
 
 // This class deals with an upstream connection that needs to finish flushing, when the downstream
@@ -68,6 +68,9 @@ void CdsApiImpl::onConfigUpdate(
     const std::string& system_version_info) {
   cm_.adsMux().pause(Config::TypeUrl::get().ClusterLoadAssignment);
   Cleanup eds_resume([this] { cm_.adsMux().resume(Config::TypeUrl::get().ClusterLoadAssignment); });
+  // Post the thread local changes of the whole update to the workers at once.
+  cm_.beginClusterUpdateBatch();
+  Cleanup end_batch([this] { cm_.endClusterUpdateBatch(); });
 
   std::vector<std::string> exception_msgs;
   std::unordered_set<std::string> cluster_names;
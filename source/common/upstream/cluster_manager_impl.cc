@@ -294,7 +294,8 @@ ClusterManagerImpl::ClusterManagerImpl(
 ClusterManagerStats ClusterManagerImpl::generateStats(Stats::Scope& scope) {
   const std::string final_prefix = "cluster_manager.";
   return {ALL_CLUSTER_MANAGER_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
-                                    POOL_GAUGE_PREFIX(scope, final_prefix))};
+                                    POOL_GAUGE_PREFIX(scope, final_prefix),
+                                    POOL_HISTOGRAM_PREFIX(scope, final_prefix))};
 }
 
 void ClusterManagerImpl::onClusterInit(Cluster& cluster) {
@@ -516,7 +517,7 @@ bool ClusterManagerImpl::addOrUpdateCluster(const envoy::api::v2::Cluster& clust
 }
 
 void ClusterManagerImpl::createOrUpdateThreadLocalCluster(ClusterData& cluster) {
-  tls_->runOnAllThreads([this, new_cluster = cluster.cluster_->info(),
+  runOnAllWorkers([this, new_cluster = cluster.cluster_->info(),
                          thread_aware_lb_factory = cluster.loadBalancerFactory()]() -> void {
     ThreadLocalClusterManagerImpl& cluster_manager =
         tls_->getTyped<ThreadLocalClusterManagerImpl>();
@@ -546,7 +547,7 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
     active_clusters_.erase(existing_active_cluster);
 
     ENVOY_LOG(info, "removing cluster {}", cluster_name);
-    tls_->runOnAllThreads([this, cluster_name]() -> void {
+    runOnAllWorkers([this, cluster_name]() -> void {
       ThreadLocalClusterManagerImpl& cluster_manager =
           tls_->getTyped<ThreadLocalClusterManagerImpl>();
 
@@ -577,6 +578,43 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
   return removed;
 }
 
+void ClusterManagerImpl::beginClusterUpdateBatch() {
+  ASSERT(cluster_update_batch_timer_ == nullptr);
+  cluster_update_batch_timer_ = std::make_unique<Stats::Timespan>(
+      cm_stats_.cluster_update_batch_duration_, time_source_);
+}
+
+void ClusterManagerImpl::endClusterUpdateBatch() {
+  ASSERT(cluster_update_batch_timer_ != nullptr);
+  std::shared_ptr<Stats::Timespan> timer = std::move(cluster_update_batch_timer_);
+  if (batched_thread_local_updates_.empty()) {
+    timer->complete();
+    return;
+  }
+
+  ENVOY_LOG(debug, "posting {} batched thread local cluster updates",
+            batched_thread_local_updates_.size());
+  auto updates = std::make_shared<std::vector<Event::PostCb>>();
+  updates->swap(batched_thread_local_updates_);
+  tls_->runOnAllThreads(
+      [updates]() -> void {
+        for (const auto& update : *updates) {
+          update();
+        }
+      },
+      [timer]() -> void { timer->complete(); });
+}
+
+void ClusterManagerImpl::runOnAllWorkers(Event::PostCb cb) {
+  // While a batch is in progress, every thread local update is queued so that the relative order of
+  // cluster creation, membership updates and removal is kept on the workers.
+  if (cluster_update_batch_timer_ != nullptr) {
+    batched_thread_local_updates_.push_back(std::move(cb));
+  } else {
+    tls_->runOnAllThreads(std::move(cb));
+  }
+}
+
 void ClusterManagerImpl::loadCluster(const envoy::api::v2::Cluster& cluster,
                                      const std::string& version_info, bool added_via_api,
                                      ClusterMap& cluster_map) {
@@ -676,7 +714,7 @@ Tcp::ConnectionPool::Instance* ClusterManagerImpl::tcpConnPoolForCluster(
 
 void ClusterManagerImpl::postThreadLocalHostRemoval(const Cluster& cluster,
                                                     const HostVector& hosts_removed) {
-  tls_->runOnAllThreads([this, name = cluster.info()->name(), hosts_removed]() {
+  runOnAllWorkers([this, name = cluster.info()->name(), hosts_removed]() {
     ThreadLocalClusterManagerImpl::removeHosts(name, hosts_removed, *tls_);
   });
 }
@@ -686,7 +724,7 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(const Cluster& cluster, ui
                                                       const HostVector& hosts_removed) {
   const auto& host_set = cluster.prioritySet().hostSetsPerPriority()[priority];
 
-  tls_->runOnAllThreads([this, name = cluster.info()->name(), priority,
+  runOnAllWorkers([this, name = cluster.info()->name(), priority,
                          update_params = HostSetImpl::updateHostsParams(*host_set),
                          locality_weights = host_set->localityWeights(), hosts_added, hosts_removed,
                          overprovisioning_factor = host_set->overprovisioningFactor()]() {
@@ -697,7 +735,7 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(const Cluster& cluster, ui
 }
 
 void ClusterManagerImpl::postThreadLocalHealthFailure(const HostSharedPtr& host) {
-  tls_->runOnAllThreads(
+  runOnAllWorkers(
       [this, host] { ThreadLocalClusterManagerImpl::onHostHealthFailure(host, *tls_); });
 }
 
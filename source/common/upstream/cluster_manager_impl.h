@@ -17,6 +17,7 @@
 #include "envoy/secret/secret_manager.h"
 #include "envoy/ssl/context_manager.h"
 #include "envoy/stats/scope.h"
+#include "envoy/stats/timespan.h"
 #include "envoy/thread_local/thread_local.h"
 #include "envoy/upstream/cluster_manager.h"
 
@@ -139,7 +140,7 @@ private:
  * All cluster manager stats. @see stats_macros.h
  */
 // clang-format off
-#define ALL_CLUSTER_MANAGER_STATS(COUNTER, GAUGE)                                                  \
+#define ALL_CLUSTER_MANAGER_STATS(COUNTER, GAUGE, HISTOGRAM)                                       \
   COUNTER(cluster_added)                                                                           \
   COUNTER(cluster_modified)                                                                        \
   COUNTER(cluster_removed)                                                                         \
@@ -148,14 +149,16 @@ private:
   COUNTER(update_merge_cancelled)                                                                  \
   COUNTER(update_out_of_merge_window)                                                              \
   GAUGE  (active_clusters)                                                                         \
-  GAUGE  (warming_clusters)
+  GAUGE  (warming_clusters)                                                                        \
+  HISTOGRAM(cluster_update_batch_duration)
 // clang-format on
 
 /**
  * Struct definition for all cluster manager stats. @see stats_macros.h
  */
 struct ClusterManagerStats {
-  ALL_CLUSTER_MANAGER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  ALL_CLUSTER_MANAGER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                            GENERATE_HISTOGRAM_STRUCT)
 };
 
 /**
@@ -202,6 +205,8 @@ public:
                     Network::TransportSocketOptionsSharedPtr transport_socket_options) override;
   Http::AsyncClient& httpAsyncClientForCluster(const std::string& cluster) override;
   bool removeCluster(const std::string& cluster) override;
+  void beginClusterUpdateBatch() override;
+  void endClusterUpdateBatch() override;
   void shutdown() override {
     // Make sure we destroy all potential outgoing connections before this returns.
     cds_api_.reset();
@@ -436,6 +441,7 @@ private:
                    bool added_via_api, ClusterMap& cluster_map);
   void onClusterInit(Cluster& cluster);
   void postThreadLocalHealthFailure(const HostSharedPtr& host);
+  void runOnAllWorkers(Event::PostCb cb);
   void updateGauges();
 
   ClusterManagerFactory& factory_;
@@ -463,6 +469,10 @@ private:
   Server::ConfigTracker::EntryOwnerPtr config_tracker_entry_;
   TimeSource& time_source_;
   ClusterUpdatesMap updates_map_;
+  // Thread local updates queued while a cluster update batch is in progress. These are posted to
+  // the workers as a single callback when the batch ends.
+  std::vector<Event::PostCb> batched_thread_local_updates_;
+  Stats::TimespanPtr cluster_update_batch_timer_;
   Event::Dispatcher& dispatcher_;
   Http::Context& http_context_;
 };
@@ -0,0 +1,131 @@
+#include "extensions/access_loggers/columnar_file/columnar_file_access_log_impl.h"
+
+#include "envoy/upstream/upstream.h"
+
+#include "common/http/header_map_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace ColumnarFile {
+
+ColumnarFileAccessLog::ColumnarFileAccessLog(AccessLog::FilterPtr&& filter,
+                                             AccessLog::AccessLogFileSharedPtr log_file,
+                                             uint64_t max_entries_per_block,
+                                             std::chrono::milliseconds block_flush_interval,
+                                             ThreadLocal::SlotAllocator& tls)
+    : filter_(std::move(filter)), tls_slot_(tls.allocateSlot()) {
+  SharedStateSharedPtr shared_state = std::make_shared<SharedState>(
+      std::move(log_file), max_entries_per_block, block_flush_interval);
+  tls_slot_->set([shared_state](Event::Dispatcher& dispatcher) {
+    return ThreadLocal::ThreadLocalObjectSharedPtr{
+        new ThreadLocalEncoder(shared_state, dispatcher)};
+  });
+}
+
+void ColumnarFileAccessLog::toRecord(const Http::HeaderMap& request_headers,
+                                     const StreamInfo::StreamInfo& stream_info,
+                                     ColumnarRecord& record) {
+  record.start_time_us_ = std::chrono::duration_cast<std::chrono::microseconds>(
+                              stream_info.startTime().time_since_epoch())
+                              .count();
+  if (stream_info.requestComplete()) {
+    record.duration_us_ = std::chrono::duration_cast<std::chrono::microseconds>(
+                              stream_info.requestComplete().value())
+                              .count();
+  }
+  if (stream_info.responseCode()) {
+    record.response_code_ = stream_info.responseCode().value();
+  }
+  if (stream_info.hasAnyResponseFlag()) {
+    for (uint64_t flag = StreamInfo::ResponseFlag::FailedLocalHealthCheck;
+         flag <= StreamInfo::ResponseFlag::LastFlag; flag <<= 1) {
+      if (stream_info.hasResponseFlag(static_cast<StreamInfo::ResponseFlag>(flag))) {
+        record.response_flags_ |= flag;
+      }
+    }
+  }
+  record.protocol_ = stream_info.protocol();
+  record.bytes_received_ = stream_info.bytesReceived();
+  record.bytes_sent_ = stream_info.bytesSent();
+
+  if (request_headers.Method() != nullptr) {
+    record.method_ = request_headers.Method()->value().getStringView();
+  }
+  if (request_headers.Host() != nullptr) {
+    record.authority_ = request_headers.Host()->value().getStringView();
+  }
+  if (request_headers.EnvoyOriginalPath() != nullptr) {
+    record.path_ = request_headers.EnvoyOriginalPath()->value().getStringView();
+  } else if (request_headers.Path() != nullptr) {
+    record.path_ = request_headers.Path()->value().getStringView();
+  }
+
+  if (stream_info.upstreamHost() != nullptr) {
+    record.upstream_cluster_ = stream_info.upstreamHost()->cluster().name();
+    record.upstream_host_ = stream_info.upstreamHost()->address()->asString();
+  }
+  record.route_name_ = stream_info.getRouteName();
+  if (stream_info.downstreamRemoteAddress() != nullptr) {
+    record.downstream_remote_address_ = stream_info.downstreamRemoteAddress()->asString();
+  }
+}
+
+void ColumnarFileAccessLog::log(const Http::HeaderMap* request_headers,
+                                const Http::HeaderMap* response_headers,
+                                const Http::HeaderMap* response_trailers,
+                                const StreamInfo::StreamInfo& stream_info) {
+  static Http::HeaderMapImpl empty_headers;
+  if (!request_headers) {
+    request_headers = &empty_headers;
+  }
+  if (!response_headers) {
+    response_headers = &empty_headers;
+  }
+  if (!response_trailers) {
+    response_trailers = &empty_headers;
+  }
+
+  if (filter_) {
+    if (!filter_->evaluate(stream_info, *request_headers, *response_headers, *response_trailers)) {
+      return;
+    }
+  }
+
+  ColumnarRecord record;
+  toRecord(*request_headers, stream_info, record);
+  tls_slot_->getTyped<ThreadLocalEncoder>().add(record);
+}
+
+ColumnarFileAccessLog::ThreadLocalEncoder::ThreadLocalEncoder(
+    const SharedStateSharedPtr& shared_state, Event::Dispatcher& dispatcher)
+    : shared_state_(shared_state), flush_timer_(dispatcher.createTimer([this]() { flush(); })) {}
+
+ColumnarFileAccessLog::ThreadLocalEncoder::~ThreadLocalEncoder() { flush(); }
+
+void ColumnarFileAccessLog::ThreadLocalEncoder::add(const ColumnarRecord& record) {
+  if (encoder_.records() == 0) {
+    flush_timer_->enableTimer(shared_state_->block_flush_interval_);
+  }
+
+  encoder_.add(record);
+  if (encoder_.records() >= shared_state_->max_entries_per_block_) {
+    flush();
+  }
+}
+
+void ColumnarFileAccessLog::ThreadLocalEncoder::flush() {
+  flush_timer_->disableTimer();
+  if (encoder_.records() == 0) {
+    return;
+  }
+
+  block_.clear();
+  encoder_.finish(block_);
+  shared_state_->log_file_->write(block_);
+}
+
+} // namespace ColumnarFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
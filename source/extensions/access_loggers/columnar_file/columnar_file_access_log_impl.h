@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "extensions/access_loggers/columnar_file/columnar_format.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace ColumnarFile {
+
+/**
+ * Access log Instance that writes logs to a file in the columnar format. Each worker encodes its
+ * entries into a block of its own, which it writes to the file once it is full or after the block
+ * flush interval.
+ */
+class ColumnarFileAccessLog : public AccessLog::Instance {
+public:
+  ColumnarFileAccessLog(AccessLog::FilterPtr&& filter, AccessLog::AccessLogFileSharedPtr log_file,
+                        uint64_t max_entries_per_block,
+                        std::chrono::milliseconds block_flush_interval,
+                        ThreadLocal::SlotAllocator& tls);
+
+  /**
+   * Fill an entry of the columnar format from a request.
+   * @param request_headers supplies the request headers.
+   * @param stream_info supplies the stream info.
+   * @param record supplies the entry to fill. Its strings point into the headers and the stream
+   *        info.
+   */
+  static void toRecord(const Http::HeaderMap& request_headers,
+                       const StreamInfo::StreamInfo& stream_info, ColumnarRecord& record);
+
+  // AccessLog::Instance
+  void log(const Http::HeaderMap* request_headers, const Http::HeaderMap* response_headers,
+           const Http::HeaderMap* response_trailers,
+           const StreamInfo::StreamInfo& stream_info) override;
+
+private:
+  /**
+   * Shared state that is owned by the per-thread encoders. This allows the access log to be
+   * destroyed while the encoders write their last blocks.
+   */
+  struct SharedState {
+    SharedState(AccessLog::AccessLogFileSharedPtr log_file, uint64_t max_entries_per_block,
+                std::chrono::milliseconds block_flush_interval)
+        : log_file_(std::move(log_file)), max_entries_per_block_(max_entries_per_block),
+          block_flush_interval_(block_flush_interval) {}
+
+    const AccessLog::AccessLogFileSharedPtr log_file_;
+    const uint64_t max_entries_per_block_;
+    const std::chrono::milliseconds block_flush_interval_;
+  };
+
+  using SharedStateSharedPtr = std::shared_ptr<SharedState>;
+
+  /**
+   * Per-thread block of entries.
+   */
+  struct ThreadLocalEncoder : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalEncoder(const SharedStateSharedPtr& shared_state, Event::Dispatcher& dispatcher);
+    ~ThreadLocalEncoder();
+
+    void add(const ColumnarRecord& record);
+    void flush();
+
+    SharedStateSharedPtr shared_state_;
+    ColumnarBlockEncoder encoder_;
+    std::string block_;
+    Event::TimerPtr flush_timer_;
+  };
+
+  AccessLog::FilterPtr filter_;
+  ThreadLocal::SlotPtr tls_slot_;
+};
+
+} // namespace ColumnarFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
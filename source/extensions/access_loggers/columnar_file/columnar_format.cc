@@ -0,0 +1,292 @@
+#include "extensions/access_loggers/columnar_file/columnar_format.h"
+
+#include "envoy/common/exception.h"
+
+#include "common/common/fmt.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace ColumnarFile {
+
+namespace {
+
+constexpr absl::string_view Magic = "EACL";
+constexpr uint64_t Version = 1;
+
+void appendVarint(uint64_t value, std::string& output) {
+  while (value >= 0x80) {
+    output.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  output.push_back(static_cast<char>(value));
+}
+
+uint64_t zigzagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t zigzagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * Reads varints and strings from a buffer.
+ */
+class Reader {
+public:
+  Reader(absl::string_view data) : data_(data) {}
+
+  /**
+   * @param value supplies the varint read.
+   * @return bool false if the buffer ends before the varint.
+   * @throw EnvoyException if the varint is longer than 64 bits.
+   */
+  bool readVarint(uint64_t& value) {
+    value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+      if (position_ == data_.size()) {
+        return false;
+      }
+      const uint8_t byte = data_[position_++];
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    throw EnvoyException("columnar access log: varint is too long");
+  }
+
+  uint64_t varint() {
+    uint64_t value;
+    if (!readVarint(value)) {
+      throw EnvoyException("columnar access log: block is truncated");
+    }
+    return value;
+  }
+
+  absl::string_view bytes(uint64_t length) {
+    if (length > data_.size() - position_) {
+      throw EnvoyException("columnar access log: block is truncated");
+    }
+    const absl::string_view bytes = data_.substr(position_, length);
+    position_ += length;
+    return bytes;
+  }
+
+  bool empty() const { return position_ == data_.size(); }
+  size_t position() const { return position_; }
+
+private:
+  const absl::string_view data_;
+  size_t position_{};
+};
+
+absl::string_view dictionaryString(const std::vector<absl::string_view>& dictionary,
+                                   uint64_t index) {
+  if (index == 0) {
+    return {};
+  }
+  if (index > dictionary.size()) {
+    throw EnvoyException(fmt::format("columnar access log: string {} is not in the dictionary of {}",
+                                     index, dictionary.size()));
+  }
+  return dictionary[index - 1];
+}
+
+} // namespace
+
+void ColumnarBlockEncoder::add(const ColumnarRecord& record) {
+  appendVarint(zigzagEncode(static_cast<int64_t>(record.start_time_us_ - previous_start_time_us_)),
+               column(ColumnarColumn::StartTime));
+  previous_start_time_us_ = record.start_time_us_;
+  appendVarint(record.duration_us_ ? record.duration_us_.value() + 1 : 0,
+               column(ColumnarColumn::Duration));
+  appendVarint(record.response_code_, column(ColumnarColumn::ResponseCode));
+  appendVarint(record.response_flags_, column(ColumnarColumn::ResponseFlags));
+  appendVarint(record.protocol_ ? static_cast<uint64_t>(record.protocol_.value()) + 1 : 0,
+               column(ColumnarColumn::Protocol));
+  appendVarint(record.bytes_received_, column(ColumnarColumn::BytesReceived));
+  appendVarint(record.bytes_sent_, column(ColumnarColumn::BytesSent));
+  addDictionaryString(ColumnarColumn::Method, record.method_);
+  addDictionaryString(ColumnarColumn::Authority, record.authority_);
+  addString(ColumnarColumn::Path, record.path_);
+  addDictionaryString(ColumnarColumn::UpstreamCluster, record.upstream_cluster_);
+  addDictionaryString(ColumnarColumn::UpstreamHost, record.upstream_host_);
+  addDictionaryString(ColumnarColumn::RouteName, record.route_name_);
+  addString(ColumnarColumn::DownstreamRemoteAddress, record.downstream_remote_address_);
+  records_++;
+}
+
+void ColumnarBlockEncoder::addString(ColumnarColumn column, absl::string_view value) {
+  std::string& output = this->column(column);
+  appendVarint(value.size(), output);
+  output.append(value.data(), value.size());
+}
+
+void ColumnarBlockEncoder::addDictionaryString(ColumnarColumn column, absl::string_view value) {
+  if (value.empty()) {
+    appendVarint(0, this->column(column));
+    return;
+  }
+
+  auto it = dictionary_.find(value);
+  if (it == dictionary_.end()) {
+    it = dictionary_.emplace(std::string(value), dictionary_.size() + 1).first;
+    appendVarint(value.size(), encoded_dictionary_);
+    encoded_dictionary_.append(value.data(), value.size());
+  }
+  appendVarint(it->second, this->column(column));
+}
+
+void ColumnarBlockEncoder::finish(std::string& output) {
+  payload_.clear();
+  appendVarint(records_, payload_);
+  appendVarint(dictionary_.size(), payload_);
+  payload_.append(encoded_dictionary_);
+  appendVarint(NumColumnarColumns, payload_);
+  for (std::string& column : columns_) {
+    appendVarint(column.size(), payload_);
+    payload_.append(column);
+    column.clear();
+  }
+
+  output.append(Magic.data(), Magic.size());
+  appendVarint(Version, output);
+  appendVarint(payload_.size(), output);
+  output.append(payload_);
+
+  dictionary_.clear();
+  encoded_dictionary_.clear();
+  records_ = 0;
+  previous_start_time_us_ = 0;
+}
+
+size_t ColumnarBlockDecoder::decode(absl::string_view data,
+                                    std::vector<ColumnarRecord>& records) {
+  if (data.size() < Magic.size()) {
+    return 0;
+  }
+  if (data.substr(0, Magic.size()) != Magic) {
+    throw EnvoyException("columnar access log: bad block magic");
+  }
+
+  Reader header(data.substr(Magic.size()));
+  uint64_t version;
+  uint64_t length;
+  if (!header.readVarint(version) || !header.readVarint(length)) {
+    return 0;
+  }
+  if (version != Version) {
+    throw EnvoyException(fmt::format("columnar access log: unsupported version {}", version));
+  }
+  const size_t payload_start = Magic.size() + header.position();
+  if (length > data.size() - payload_start) {
+    return 0;
+  }
+
+  Reader payload(data.substr(payload_start, length));
+  const uint64_t num_records = payload.varint();
+  // Each entry takes at least a byte per column, which bounds the entries of a sane block.
+  if (num_records > length) {
+    throw EnvoyException(fmt::format("columnar access log: block of {} bytes cannot hold {} entries",
+                                     length, num_records));
+  }
+
+  const uint64_t num_strings = payload.varint();
+  if (num_strings > length) {
+    throw EnvoyException(fmt::format("columnar access log: block of {} bytes cannot hold {} strings",
+                                     length, num_strings));
+  }
+  std::vector<absl::string_view> dictionary;
+  dictionary.reserve(num_strings);
+  for (uint64_t i = 0; i < num_strings; i++) {
+    dictionary.push_back(payload.bytes(payload.varint()));
+  }
+
+  const size_t first_record = records.size();
+  records.resize(first_record + num_records);
+  const uint64_t num_columns = payload.varint();
+  for (uint64_t i = 0; i < num_columns; i++) {
+    Reader column(payload.bytes(payload.varint()));
+    if (i >= NumColumnarColumns) {
+      // A column added by a later version of the format.
+      continue;
+    }
+
+    uint64_t start_time_us = 0;
+    for (size_t j = first_record; j < records.size(); j++) {
+      ColumnarRecord& record = records[j];
+      switch (static_cast<ColumnarColumn>(i)) {
+      case ColumnarColumn::StartTime:
+        start_time_us += zigzagDecode(column.varint());
+        record.start_time_us_ = start_time_us;
+        break;
+      case ColumnarColumn::Duration: {
+        const uint64_t duration_us = column.varint();
+        if (duration_us > 0) {
+          record.duration_us_ = duration_us - 1;
+        }
+        break;
+      }
+      case ColumnarColumn::ResponseCode:
+        record.response_code_ = column.varint();
+        break;
+      case ColumnarColumn::ResponseFlags:
+        record.response_flags_ = column.varint();
+        break;
+      case ColumnarColumn::Protocol: {
+        const uint64_t protocol = column.varint();
+        if (protocol > Http::NumProtocols) {
+          throw EnvoyException(fmt::format("columnar access log: unknown protocol {}", protocol));
+        }
+        if (protocol > 0) {
+          record.protocol_ = static_cast<Http::Protocol>(protocol - 1);
+        }
+        break;
+      }
+      case ColumnarColumn::BytesReceived:
+        record.bytes_received_ = column.varint();
+        break;
+      case ColumnarColumn::BytesSent:
+        record.bytes_sent_ = column.varint();
+        break;
+      case ColumnarColumn::Method:
+        record.method_ = dictionaryString(dictionary, column.varint());
+        break;
+      case ColumnarColumn::Authority:
+        record.authority_ = dictionaryString(dictionary, column.varint());
+        break;
+      case ColumnarColumn::Path:
+        record.path_ = column.bytes(column.varint());
+        break;
+      case ColumnarColumn::UpstreamCluster:
+        record.upstream_cluster_ = dictionaryString(dictionary, column.varint());
+        break;
+      case ColumnarColumn::UpstreamHost:
+        record.upstream_host_ = dictionaryString(dictionary, column.varint());
+        break;
+      case ColumnarColumn::RouteName:
+        record.route_name_ = dictionaryString(dictionary, column.varint());
+        break;
+      case ColumnarColumn::DownstreamRemoteAddress:
+        record.downstream_remote_address_ = column.bytes(column.varint());
+        break;
+      }
+    }
+
+    if (!column.empty()) {
+      throw EnvoyException(fmt::format("columnar access log: column {} has trailing bytes", i));
+    }
+  }
+
+  if (!payload.empty()) {
+    throw EnvoyException("columnar access log: block has trailing bytes");
+  }
+  return payload_start + length;
+}
+
+} // namespace ColumnarFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/http/protocol.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace ColumnarFile {
+
+/**
+ * An access log entry of the columnar format. Empty strings are not logged.
+ */
+struct ColumnarRecord {
+  // Microseconds since the epoch.
+  uint64_t start_time_us_{};
+  absl::optional<uint64_t> duration_us_;
+  uint64_t response_code_{};
+  // Bit set of StreamInfo::ResponseFlag.
+  uint64_t response_flags_{};
+  absl::optional<Http::Protocol> protocol_;
+  uint64_t bytes_received_{};
+  uint64_t bytes_sent_{};
+  absl::string_view method_;
+  absl::string_view authority_;
+  absl::string_view path_;
+  absl::string_view upstream_cluster_;
+  absl::string_view upstream_host_;
+  absl::string_view route_name_;
+  absl::string_view downstream_remote_address_;
+};
+
+/**
+ * The columns of a block, in the order they are written. New columns are only ever appended, and
+ * decoders skip the columns they do not know.
+ */
+enum class ColumnarColumn : uint32_t {
+  StartTime,
+  Duration,
+  ResponseCode,
+  ResponseFlags,
+  Protocol,
+  BytesReceived,
+  BytesSent,
+  Method,
+  Authority,
+  Path,
+  UpstreamCluster,
+  UpstreamHost,
+  RouteName,
+  DownstreamRemoteAddress,
+};
+
+constexpr uint32_t NumColumnarColumns =
+    static_cast<uint32_t>(ColumnarColumn::DownstreamRemoteAddress) + 1;
+
+/**
+ * Encodes access log entries into a block of the columnar format. A block is:
+ * - the magic "EACL" and the varint version of the format, 1.
+ * - the varint length of the rest of the block.
+ * - the varint number of entries.
+ * - the varint number of strings of the dictionary of the block, followed by each string as a
+ *   varint length and its bytes.
+ * - the varint number of columns, followed by each column as a varint length and its bytes. A
+ *   column holds a value per entry:
+ *   - the start time as the zigzag varint difference to the start time of the previous entry of
+ *     the block, or to 0 for the first one.
+ *   - numbers as varints. Optional numbers are offset by 1, with 0 standing for no value.
+ *   - the path and the downstream remote address as a varint length and their bytes.
+ *   - other strings as a varint index into the dictionary, offset by 1, with 0 standing for an
+ *     empty string.
+ */
+class ColumnarBlockEncoder {
+public:
+  /**
+   * Add an entry to the block.
+   * @param record supplies the entry.
+   */
+  void add(const ColumnarRecord& record);
+
+  /**
+   * @return uint64_t the number of entries of the block.
+   */
+  uint64_t records() const { return records_; }
+
+  /**
+   * Append the block to a buffer and start a new one.
+   * @param output supplies the buffer to append the block to.
+   */
+  void finish(std::string& output);
+
+private:
+  void addString(ColumnarColumn column, absl::string_view value);
+  void addDictionaryString(ColumnarColumn column, absl::string_view value);
+  std::string& column(ColumnarColumn column) { return columns_[static_cast<uint32_t>(column)]; }
+
+  // Index of each string of the dictionary, offset by 1.
+  absl::flat_hash_map<std::string, uint64_t> dictionary_;
+  std::string encoded_dictionary_;
+  std::array<std::string, NumColumnarColumns> columns_;
+  std::string payload_;
+  uint64_t records_{};
+  uint64_t previous_start_time_us_{};
+};
+
+/**
+ * Decodes blocks of the columnar format.
+ */
+class ColumnarBlockDecoder {
+public:
+  /**
+   * Decode the first block of a buffer.
+   * @param data supplies the buffer.
+   * @param records supplies the vector the entries of the block are appended to. Their strings
+   *        point into data.
+   * @return size_t the size of the block, or 0 if data does not hold a whole block.
+   * @throw EnvoyException if the block is malformed.
+   */
+  static size_t decode(absl::string_view data, std::vector<ColumnarRecord>& records);
+};
+
+} // namespace ColumnarFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,45 @@
+#include "extensions/access_loggers/columnar_file/config.h"
+
+#include "envoy/config/accesslog/v2alpha/columnar_file.pb.validate.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/filter_config.h"
+
+#include "common/protobuf/utility.h"
+
+#include "extensions/access_loggers/columnar_file/columnar_file_access_log_impl.h"
+#include "extensions/access_loggers/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace ColumnarFile {
+
+AccessLog::InstanceSharedPtr ColumnarFileAccessLogFactory::createAccessLogInstance(
+    const Protobuf::Message& config, AccessLog::FilterPtr&& filter,
+    Server::Configuration::FactoryContext& context) {
+  const auto& proto_config = MessageUtil::downcastAndValidate<
+      const envoy::config::accesslog::v2alpha::ColumnarFileAccessLog&>(config);
+
+  return std::make_shared<ColumnarFileAccessLog>(
+      std::move(filter), context.accessLogManager().createAccessLog(proto_config.path()),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, max_entries_per_block, 1024),
+      std::chrono::milliseconds(
+          PROTOBUF_GET_MS_OR_DEFAULT(proto_config, block_flush_interval, 1000)),
+      context.threadLocal());
+}
+
+ProtobufTypes::MessagePtr ColumnarFileAccessLogFactory::createEmptyConfigProto() {
+  return ProtobufTypes::MessagePtr{new envoy::config::accesslog::v2alpha::ColumnarFileAccessLog()};
+}
+
+std::string ColumnarFileAccessLogFactory::name() const { return AccessLogNames::get().ColumnarFile; }
+
+/**
+ * Static registration for the columnar file access log. @see RegisterFactory.
+ */
+REGISTER_FACTORY(ColumnarFileAccessLogFactory, Server::Configuration::AccessLogInstanceFactory);
+
+} // namespace ColumnarFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -7,6 +7,8 @@ namespace Extensions {
 namespace AccessLoggers {
 namespace File {
 
+constexpr size_t FileAccessLog::MaxRetainedLogLineCapacity;
+
 FileAccessLog::FileAccessLog(const std::string& access_log_path, AccessLog::FilterPtr&& filter,
                              AccessLog::FormatterPtr&& formatter,
                              AccessLog::AccessLogManager& log_manager)
@@ -35,8 +37,18 @@ void FileAccessLog::log(const Http::HeaderMap* request_headers,
     }
   }
 
-  log_file_->write(
-      formatter_->format(*request_headers, *response_headers, *response_trailers, stream_info));
+  // Each thread formats into its own buffer, which keeps its capacity between log lines so that
+  // formatting does not allocate once the buffer has grown to the size of a line.
+  static thread_local std::string log_line;
+  log_line.clear();
+  formatter_->formatTo(*request_headers, *response_headers, *response_trailers, stream_info,
+                       log_line);
+  log_file_->write(log_line);
+
+  // Don't hold on to the memory of an unusually long line.
+  if (log_line.capacity() > MaxRetainedLogLineCapacity) {
+    std::string().swap(log_line);
+  }
 }
 
 } // namespace File
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include "envoy/access_log/access_log.h"
 
 namespace Envoy {
@@ -21,6 +23,9 @@ public:
            const StreamInfo::StreamInfo& stream_info) override;
 
 private:
+  // The largest formatting buffer a thread keeps between log lines.
+  static constexpr size_t MaxRetainedLogLineCapacity = 64 * 1024;
+
   AccessLog::AccessLogFileSharedPtr log_file_;
   AccessLog::FilterPtr filter_;
   AccessLog::FormatterPtr formatter_;
@@ -41,7 +41,8 @@ HttpGrpcAccessLogFactory::createAccessLogInstance(const Protobuf::Message& confi
           });
 
   return std::make_shared<HttpGrpcAccessLog>(std::move(filter), proto_config,
-                                             grpc_access_log_streamer);
+                                             grpc_access_log_streamer, context.threadLocal(),
+                                             context.scope());
 }
 
 ProtobufTypes::MessagePtr HttpGrpcAccessLogFactory::createEmptyConfigProto() {
@@ -4,7 +4,9 @@
 
 #include "common/common/assert.h"
 #include "common/http/header_map_impl.h"
+#include "common/http/headers.h"
 #include "common/network/utility.h"
+#include "common/protobuf/utility.h"
 #include "common/stream_info/utility.h"
 
 namespace Envoy {
@@ -22,9 +24,17 @@ GrpcAccessLogStreamerImpl::GrpcAccessLogStreamerImpl(Grpc::AsyncClientFactoryPtr
   });
 }
 
+void GrpcAccessLogStreamerImpl::ThreadLocalStream::onCreateInitialMetadata(
+    Http::HeaderMap& metadata) {
+  if (compression_ == Grpc::CompressionAlgorithm::Gzip) {
+    metadata.addReference(Http::Headers::get().GrpcEncoding,
+                          Http::Headers::get().GrpcEncodingValues.Gzip);
+  }
+}
+
 void GrpcAccessLogStreamerImpl::ThreadLocalStream::onRemoteClose(Grpc::Status::GrpcStatus,
                                                                  const std::string&) {
-  auto it = parent_.stream_map_.find(log_name_);
+  auto it = parent_.stream_map_.find({log_name_, compression_});
   ASSERT(it != parent_.stream_map_.end());
   if (it->second.stream_ != nullptr) {
     // Only erase if we have a stream. Otherwise we had an inline failure and we will clear the
@@ -37,11 +47,15 @@ GrpcAccessLogStreamerImpl::ThreadLocalStreamer::ThreadLocalStreamer(
     const SharedStateSharedPtr& shared_state)
     : client_(shared_state->factory_->create()), shared_state_(shared_state) {}
 
-void GrpcAccessLogStreamerImpl::ThreadLocalStreamer::send(
-    envoy::service::accesslog::v2::StreamAccessLogsMessage& message, const std::string& log_name) {
-  auto stream_it = stream_map_.find(log_name);
+bool GrpcAccessLogStreamerImpl::ThreadLocalStreamer::send(
+    envoy::service::accesslog::v2::StreamAccessLogsMessage& message, const std::string& log_name,
+    Grpc::CompressionAlgorithm compression) {
+  auto stream_it = stream_map_.find({log_name, compression});
   if (stream_it == stream_map_.end()) {
-    stream_it = stream_map_.emplace(log_name, ThreadLocalStream(*this, log_name)).first;
+    stream_it = stream_map_
+                    .emplace(std::make_pair(log_name, compression),
+                             ThreadLocalStream(*this, log_name, compression))
+                    .first;
   }
 
   auto& stream_entry = stream_it->second;
@@ -56,20 +70,75 @@ void GrpcAccessLogStreamerImpl::ThreadLocalStreamer::send(
     identifier->set_log_name(log_name);
   }
 
-  if (stream_entry.stream_ != nullptr) {
-    stream_entry.stream_->sendMessage(message, false);
-  } else {
+  if (stream_entry.stream_ == nullptr) {
     // Clear out the stream data due to stream creation failure.
     stream_map_.erase(stream_it);
+    return false;
+  }
+
+  // Logs are dropped rather than buffered without bound while the service does not keep up.
+  if (stream_entry.stream_->isAboveWriteBufferHighWatermark()) {
+    return false;
+  }
+  stream_entry.stream_->sendMessage(message, false);
+  return true;
+}
+
+HttpGrpcAccessLog::SharedState::SharedState(
+    GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer,
+    const envoy::config::accesslog::v2::CommonGrpcAccessLogConfig& config, Stats::Scope& scope)
+    : grpc_access_log_streamer_(std::move(grpc_access_log_streamer)), log_name_(config.log_name()),
+      buffer_flush_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, buffer_flush_interval, 1000)),
+      buffer_size_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384)),
+      compression_(config.gzip_compression() ? Grpc::CompressionAlgorithm::Gzip
+                                             : Grpc::CompressionAlgorithm::None),
+      stats_({ALL_GRPC_ACCESS_LOGGER_STATS(
+          POOL_COUNTER_PREFIX(scope, "access_logs.grpc_access_log."))}) {}
+
+HttpGrpcAccessLog::ThreadLocalLogger::ThreadLocalLogger(const SharedStateSharedPtr& shared_state,
+                                                        Event::Dispatcher& dispatcher)
+    : shared_state_(shared_state), flush_timer_(dispatcher.createTimer([this]() { flush(); })) {}
+
+void HttpGrpcAccessLog::ThreadLocalLogger::log(
+    envoy::data::accesslog::v2::HTTPAccessLogEntry&& entry) {
+  approximate_message_size_bytes_ += entry.ByteSizeLong();
+  message_.mutable_http_logs()->mutable_log_entry()->Add(std::move(entry));
+  if (approximate_message_size_bytes_ >= shared_state_->buffer_size_bytes_) {
+    flush();
+  } else if (message_.http_logs().log_entry_size() == 1) {
+    flush_timer_->enableTimer(shared_state_->buffer_flush_interval_);
   }
 }
 
+void HttpGrpcAccessLog::ThreadLocalLogger::flush() {
+  flush_timer_->disableTimer();
+  const uint64_t entries = message_.http_logs().log_entry_size();
+  if (entries == 0) {
+    return;
+  }
+
+  if (shared_state_->grpc_access_log_streamer_->send(message_, shared_state_->log_name_,
+                                                     shared_state_->compression_)) {
+    shared_state_->stats_.logs_written_.add(entries);
+  } else {
+    shared_state_->stats_.logs_dropped_.add(entries);
+  }
+  message_.Clear();
+  approximate_message_size_bytes_ = 0;
+}
+
 HttpGrpcAccessLog::HttpGrpcAccessLog(
     AccessLog::FilterPtr&& filter,
     const envoy::config::accesslog::v2::HttpGrpcAccessLogConfig& config,
-    GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer)
-    : filter_(std::move(filter)), config_(config),
-      grpc_access_log_streamer_(grpc_access_log_streamer) {
+    GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer, ThreadLocal::SlotAllocator& tls,
+    Stats::Scope& scope)
+    : filter_(std::move(filter)), config_(config), tls_slot_(tls.allocateSlot()) {
+  SharedStateSharedPtr shared_state =
+      std::make_shared<SharedState>(grpc_access_log_streamer, config_.common_config(), scope);
+  tls_slot_->set([shared_state](Event::Dispatcher& dispatcher) {
+    return ThreadLocal::ThreadLocalObjectSharedPtr{new ThreadLocalLogger(shared_state, dispatcher)};
+  });
+
   for (const auto& header : config_.additional_request_headers_to_log()) {
     request_headers_to_log_.emplace_back(header);
   }
@@ -182,12 +251,11 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
     }
   }
 
-  envoy::service::accesslog::v2::StreamAccessLogsMessage message;
-  auto* log_entry = message.mutable_http_logs()->add_log_entry();
+  envoy::data::accesslog::v2::HTTPAccessLogEntry log_entry;
 
   // Common log properties.
   // TODO(mattklein123): Populate sample_rate field.
-  auto* common_properties = log_entry->mutable_common_properties();
+  auto* common_properties = log_entry.mutable_common_properties();
 
   if (stream_info.downstreamRemoteAddress() != nullptr) {
     Network::Utility::addressToProtobufAddress(
@@ -298,20 +366,20 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
   if (stream_info.protocol()) {
     switch (stream_info.protocol().value()) {
     case Http::Protocol::Http10:
-      log_entry->set_protocol_version(envoy::data::accesslog::v2::HTTPAccessLogEntry::HTTP10);
+      log_entry.set_protocol_version(envoy::data::accesslog::v2::HTTPAccessLogEntry::HTTP10);
       break;
     case Http::Protocol::Http11:
-      log_entry->set_protocol_version(envoy::data::accesslog::v2::HTTPAccessLogEntry::HTTP11);
+      log_entry.set_protocol_version(envoy::data::accesslog::v2::HTTPAccessLogEntry::HTTP11);
       break;
     case Http::Protocol::Http2:
-      log_entry->set_protocol_version(envoy::data::accesslog::v2::HTTPAccessLogEntry::HTTP2);
+      log_entry.set_protocol_version(envoy::data::accesslog::v2::HTTPAccessLogEntry::HTTP2);
       break;
     }
   }
 
   // HTTP request properties.
   // TODO(mattklein123): Populate port field.
-  auto* request_properties = log_entry->mutable_request();
+  auto* request_properties = log_entry.mutable_request();
   if (request_headers->Scheme() != nullptr) {
     request_properties->set_scheme(std::string(request_headers->Scheme()->value().getStringView()));
   }
@@ -363,7 +431,7 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
   }
 
   // HTTP response properties.
-  auto* response_properties = log_entry->mutable_response();
+  auto* response_properties = log_entry.mutable_response();
   if (stream_info.responseCode()) {
     response_properties->mutable_response_code()->set_value(stream_info.responseCode().value());
   }
@@ -394,8 +462,7 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
     }
   }
 
-  // TODO(mattklein123): Consider batching multiple logs and flushing.
-  grpc_access_log_streamer_->send(message, config_.common_config().log_name());
+  tls_slot_->getTyped<ThreadLocalLogger>().log(std::move(log_entry));
 }
 
 } // namespace HttpGrpc
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <unordered_map>
+#include <map>
 #include <vector>
 
 #include "envoy/access_log/access_log.h"
@@ -11,14 +11,32 @@
 #include "envoy/local_info/local_info.h"
 #include "envoy/service/accesslog/v2/als.pb.h"
 #include "envoy/singleton/instance.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/grpc/codec.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace AccessLoggers {
 namespace HttpGrpc {
 
-// TODO(mattklein123): Stats
+/**
+ * All stats for the gRPC access logger. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_GRPC_ACCESS_LOGGER_STATS(COUNTER)                                                      \
+  COUNTER(logs_written)                                                                            \
+  COUNTER(logs_dropped)
+// clang-format on
+
+/**
+ * Struct definition for all gRPC access logger stats. @see stats_macros.h
+ */
+struct GrpcAccessLoggerStats {
+  ALL_GRPC_ACCESS_LOGGER_STATS(GENERATE_COUNTER_STRUCT)
+};
 
 /**
  * Interface for an access log streamer. The streamer deals with threading and sends access logs
@@ -29,12 +47,16 @@ public:
   virtual ~GrpcAccessLogStreamer() {}
 
   /**
-   * Send an access log.
-   * @param message supplies the access log to send.
+   * Send access logs.
+   * @param message supplies the access logs to send.
    * @param log_name supplies the name of the log stream to send on.
+   * @param compression supplies the compression of the messages of the log stream. It is applied
+   *        when the stream is started.
+   * @return bool whether the message was sent. Messages are dropped while the stream is backed up
+   *         or when it cannot be started.
    */
-  virtual void send(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
-                    const std::string& log_name) PURE;
+  virtual bool send(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
+                    const std::string& log_name, Grpc::CompressionAlgorithm compression) PURE;
 };
 
 typedef std::shared_ptr<GrpcAccessLogStreamer> GrpcAccessLogStreamerSharedPtr;
@@ -49,9 +71,9 @@ public:
                             const LocalInfo::LocalInfo& local_info);
 
   // GrpcAccessLogStreamer
-  void send(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
-            const std::string& log_name) override {
-    tls_slot_->getTyped<ThreadLocalStreamer>().send(message, log_name);
+  bool send(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
+            const std::string& log_name, Grpc::CompressionAlgorithm compression) override {
+    return tls_slot_->getTyped<ThreadLocalStreamer>().send(message, log_name, compression);
   }
 
 private:
@@ -76,11 +98,12 @@ private:
    */
   struct ThreadLocalStream : public Grpc::TypedAsyncStreamCallbacks<
                                  envoy::service::accesslog::v2::StreamAccessLogsResponse> {
-    ThreadLocalStream(ThreadLocalStreamer& parent, const std::string& log_name)
-        : parent_(parent), log_name_(log_name) {}
+    ThreadLocalStream(ThreadLocalStreamer& parent, const std::string& log_name,
+                      Grpc::CompressionAlgorithm compression)
+        : parent_(parent), log_name_(log_name), compression_(compression) {}
 
     // Grpc::TypedAsyncStreamCallbacks
-    void onCreateInitialMetadata(Http::HeaderMap&) override {}
+    void onCreateInitialMetadata(Http::HeaderMap& metadata) override;
     void onReceiveInitialMetadata(Http::HeaderMapPtr&&) override {}
     void onReceiveMessage(
         std::unique_ptr<envoy::service::accesslog::v2::StreamAccessLogsResponse>&&) override {}
@@ -89,6 +112,7 @@ private:
 
     ThreadLocalStreamer& parent_;
     const std::string log_name_;
+    const Grpc::CompressionAlgorithm compression_;
     Grpc::AsyncStream* stream_{};
   };
 
@@ -97,11 +121,13 @@ private:
    */
   struct ThreadLocalStreamer : public ThreadLocal::ThreadLocalObject {
     ThreadLocalStreamer(const SharedStateSharedPtr& shared_state);
-    void send(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
-              const std::string& log_name);
+    bool send(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
+              const std::string& log_name, Grpc::CompressionAlgorithm compression);
 
     Grpc::AsyncClientPtr client_;
-    std::unordered_map<std::string, ThreadLocalStream> stream_map_;
+    // The streams by log name and compression, so that access logs which share a log name but not
+    // the compression each get the compression they are configured with.
+    std::map<std::pair<std::string, Grpc::CompressionAlgorithm>, ThreadLocalStream> stream_map_;
     SharedStateSharedPtr shared_state_;
   };
 
@@ -109,13 +135,16 @@ private:
 };
 
 /**
- * Access log Instance that streams HTTP logs over gRPC.
+ * Access log Instance that streams HTTP logs over gRPC. Each worker buffers its logs and sends them
+ * in one message once they reach the buffer size or after the buffer flush interval. Logs which
+ * are still buffered when the access log is destroyed are dropped.
  */
 class HttpGrpcAccessLog : public AccessLog::Instance {
 public:
   HttpGrpcAccessLog(AccessLog::FilterPtr&& filter,
                     const envoy::config::accesslog::v2::HttpGrpcAccessLogConfig& config,
-                    GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer);
+                    GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer,
+                    ThreadLocal::SlotAllocator& tls, Stats::Scope& scope);
 
   static void responseFlagsToAccessLogResponseFlags(
       envoy::data::accesslog::v2::AccessLogCommon& common_access_log,
@@ -127,9 +156,43 @@ public:
            const StreamInfo::StreamInfo& stream_info) override;
 
 private:
+  /**
+   * Shared state that is owned by the per-thread loggers. This allows the access log to be
+   * destroyed while the loggers hold onto the shared state.
+   */
+  struct SharedState {
+    SharedState(GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer,
+                const envoy::config::accesslog::v2::CommonGrpcAccessLogConfig& config,
+                Stats::Scope& scope);
+
+    const GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer_;
+    const std::string log_name_;
+    const std::chrono::milliseconds buffer_flush_interval_;
+    const uint64_t buffer_size_bytes_;
+    const Grpc::CompressionAlgorithm compression_;
+    GrpcAccessLoggerStats stats_;
+  };
+
+  typedef std::shared_ptr<SharedState> SharedStateSharedPtr;
+
+  /**
+   * Per-thread buffer of logs.
+   */
+  struct ThreadLocalLogger : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalLogger(const SharedStateSharedPtr& shared_state, Event::Dispatcher& dispatcher);
+
+    void log(envoy::data::accesslog::v2::HTTPAccessLogEntry&& entry);
+    void flush();
+
+    SharedStateSharedPtr shared_state_;
+    envoy::service::accesslog::v2::StreamAccessLogsMessage message_;
+    uint64_t approximate_message_size_bytes_{};
+    Event::TimerPtr flush_timer_;
+  };
+
   AccessLog::FilterPtr filter_;
   const envoy::config::accesslog::v2::HttpGrpcAccessLogConfig config_;
-  GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer_;
+  ThreadLocal::SlotPtr tls_slot_;
   std::vector<Http::LowerCaseString> request_headers_to_log_;
   std::vector<Http::LowerCaseString> response_headers_to_log_;
   std::vector<Http::LowerCaseString> response_trailers_to_log_;
@@ -16,6 +16,8 @@ class AccessLogNameValues {
 public:
   // File access log
   const std::string File = "envoy.file_access_log";
+  // Columnar file access log
+  const std::string ColumnarFile = "envoy.access_loggers.columnar_file";
   // HTTP gRPC access log
   const std::string HttpGrpc = "envoy.http_grpc_access_log";
 };
@@ -0,0 +1,44 @@
+#include "extensions/compression/deflate/common/content_coding.h"
+
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/fmt.h"
+#include "common/http/headers.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Deflate {
+
+std::string contentCoding(const std::string& content_coding) {
+  const auto& values = Http::Headers::get().ContentEncodingValues;
+  if (content_coding.empty()) {
+    return values.Deflate;
+  }
+  const auto is_coding_char = [](char c) -> bool {
+    return absl::ascii_islower(c) || absl::ascii_isdigit(c) || c == '-';
+  };
+  if (!std::all_of(content_coding.begin(), content_coding.end(), is_coding_char)) {
+    throw EnvoyException(fmt::format("deflate: invalid content coding '{}': it must be made of "
+                                     "lower case letters, digits and dashes",
+                                     content_coding));
+  }
+  // The standard content codings other than deflate name other formats.
+  for (const char* standard : {"br", "compress", "gzip", "identity", "x-compress", "x-gzip"}) {
+    if (content_coding == standard) {
+      throw EnvoyException(
+          fmt::format("deflate: invalid content coding '{}': it is the name of another format",
+                      content_coding));
+    }
+  }
+  return content_coding;
+}
+
+} // namespace Deflate
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Deflate {
+
+/**
+ * @return the content coding of a deflate compressor or decompressor, which is "deflate" unless
+ *         another one is configured.
+ * @param content_coding supplies the configured content coding, empty if none is configured.
+ * @throw EnvoyException if the content coding is not made of lower case letters, digits and dashes
+ *        or is a standard content coding other than "deflate".
+ */
+std::string contentCoding(const std::string& content_coding);
+
+} // namespace Deflate
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
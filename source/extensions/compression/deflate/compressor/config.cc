@@ -0,0 +1,108 @@
+#include "extensions/compression/deflate/compressor/config.h"
+
+#include "envoy/config/compression/deflate/v2alpha/deflate.pb.validate.h"
+#include "envoy/common/exception.h"
+#include "envoy/registry/registry.h"
+
+#include "common/config/datasource.h"
+#include "common/http/headers.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/compression/deflate/common/content_coding.h"
+#include "extensions/compression/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Deflate {
+
+namespace {
+// Default zlib memory level.
+const uint64_t DefaultMemoryLevel = 5;
+
+// Default compression window size.
+const uint64_t DefaultWindowBits = 12;
+} // namespace
+
+DeflateCompressorFactory::DeflateCompressorFactory(
+    const envoy::config::compression::deflate::v2alpha::DeflateCompressor& deflate,
+    std::string&& dictionary)
+    : compression_level_(compressionLevelEnum(deflate.compression_level())),
+      compression_strategy_(compressionStrategyEnum(deflate.compression_strategy())),
+      window_bits_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(deflate, window_bits, DefaultWindowBits)),
+      memory_level_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(deflate, memory_level, DefaultMemoryLevel)),
+      dictionary_(std::move(dictionary)),
+      content_encoding_(contentCoding(deflate.content_coding())) {
+  // Every client accepting the deflate content coding would be sent responses which it cannot
+  // decompress without the dictionary.
+  if (!dictionary_.empty() &&
+      content_encoding_ == Http::Headers::get().ContentEncodingValues.Deflate) {
+    throw EnvoyException("deflate compressor: a dictionary requires a content coding other than "
+                         "'deflate'");
+  }
+}
+
+Envoy::Compressor::ZlibCompressorImpl::CompressionLevel
+DeflateCompressorFactory::compressionLevelEnum(
+    envoy::config::compression::deflate::v2alpha::DeflateCompressor::CompressionLevel
+        compression_level) {
+  switch (compression_level) {
+  case envoy::config::compression::deflate::v2alpha::DeflateCompressor::BEST:
+    return Envoy::Compressor::ZlibCompressorImpl::CompressionLevel::Best;
+  case envoy::config::compression::deflate::v2alpha::DeflateCompressor::SPEED:
+    return Envoy::Compressor::ZlibCompressorImpl::CompressionLevel::Speed;
+  default:
+    return Envoy::Compressor::ZlibCompressorImpl::CompressionLevel::Standard;
+  }
+}
+
+Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy
+DeflateCompressorFactory::compressionStrategyEnum(
+    envoy::config::compression::deflate::v2alpha::DeflateCompressor::CompressionStrategy
+        compression_strategy) {
+  switch (compression_strategy) {
+  case envoy::config::compression::deflate::v2alpha::DeflateCompressor::RLE:
+    return Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Rle;
+  case envoy::config::compression::deflate::v2alpha::DeflateCompressor::FILTERED:
+    return Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Filtered;
+  case envoy::config::compression::deflate::v2alpha::DeflateCompressor::HUFFMAN:
+    return Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Huffman;
+  default:
+    return Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Standard;
+  }
+}
+
+Envoy::Compressor::CompressorPtr DeflateCompressorFactory::createCompressor() {
+  auto compressor = std::make_unique<Envoy::Compressor::ZlibCompressorImpl>();
+  compressor->init(compression_level_, compression_strategy_, window_bits_, memory_level_);
+  if (!dictionary_.empty()) {
+    compressor->setDictionary(dictionary_);
+  }
+  return compressor;
+}
+
+const std::string& DeflateCompressorFactory::contentEncoding() const { return content_encoding_; }
+
+Envoy::Compressor::CompressorFactoryPtr
+DeflateCompressorLibraryFactory::createCompressorFactoryFromProto(
+    const Protobuf::Message& config, Server::Configuration::FactoryContext& context) {
+  const auto& deflate = MessageUtil::downcastAndValidate<
+      const envoy::config::compression::deflate::v2alpha::DeflateCompressor&>(config);
+  return std::make_unique<DeflateCompressorFactory>(
+      deflate, Config::DataSource::read(deflate.dictionary(), true, context.api()));
+}
+
+std::string DeflateCompressorLibraryFactory::name() {
+  return CompressorLibraryNames::get().Deflate;
+}
+
+/**
+ * Static registration for the deflate compressor library. @see RegisterFactory.
+ */
+REGISTER_FACTORY(DeflateCompressorLibraryFactory,
+                 Envoy::Compressor::NamedCompressorLibraryConfigFactory);
+
+} // namespace Deflate
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+
+#include "envoy/compressor/config.h"
+#include "envoy/config/compression/deflate/v2alpha/deflate.pb.h"
+
+#include "common/compressor/zlib_compressor_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Deflate {
+
+/**
+ * Creates the zlib compressors of the deflate content coding, primed with the preset dictionary if
+ * one is configured. The content coding is named differently when a dictionary is configured.
+ */
+class DeflateCompressorFactory : public Envoy::Compressor::CompressorFactory {
+public:
+  DeflateCompressorFactory(
+      const envoy::config::compression::deflate::v2alpha::DeflateCompressor& deflate,
+      std::string&& dictionary);
+
+  // Compressor::CompressorFactory
+  Envoy::Compressor::CompressorPtr createCompressor() override;
+  const std::string& contentEncoding() const override;
+
+private:
+  static Envoy::Compressor::ZlibCompressorImpl::CompressionLevel compressionLevelEnum(
+      envoy::config::compression::deflate::v2alpha::DeflateCompressor::CompressionLevel
+          compression_level);
+  static Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy compressionStrategyEnum(
+      envoy::config::compression::deflate::v2alpha::DeflateCompressor::CompressionStrategy
+          compression_strategy);
+
+  const Envoy::Compressor::ZlibCompressorImpl::CompressionLevel compression_level_;
+  const Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy compression_strategy_;
+  const int64_t window_bits_;
+  const uint64_t memory_level_;
+  // Empty if no dictionary is configured.
+  const std::string dictionary_;
+  const std::string content_encoding_;
+};
+
+/**
+ * Config registration for the deflate compressor library.
+ * @see NamedCompressorLibraryConfigFactory.
+ */
+class DeflateCompressorLibraryFactory
+    : public Envoy::Compressor::NamedCompressorLibraryConfigFactory {
+public:
+  // Compressor::NamedCompressorLibraryConfigFactory
+  Envoy::Compressor::CompressorFactoryPtr
+  createCompressorFactoryFromProto(const Protobuf::Message& config,
+                                   Server::Configuration::FactoryContext& context) override;
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<envoy::config::compression::deflate::v2alpha::DeflateCompressor>();
+  }
+  std::string name() override;
+};
+
+} // namespace Deflate
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
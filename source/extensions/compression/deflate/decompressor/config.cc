@@ -0,0 +1,67 @@
+#include "extensions/compression/deflate/decompressor/config.h"
+
+#include "envoy/config/compression/deflate/v2alpha/deflate.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "common/config/datasource.h"
+#include "common/decompressor/zlib_decompressor_impl.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/compression/deflate/common/content_coding.h"
+#include "extensions/compression/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Deflate {
+
+namespace {
+// Default decompression window size, which reads the data compressed with any window size.
+const uint64_t DefaultWindowBits = 15;
+
+// Default size of the output chunks.
+const uint64_t DefaultChunkSize = 4096;
+} // namespace
+
+DeflateDecompressorFactory::DeflateDecompressorFactory(
+    const envoy::config::compression::deflate::v2alpha::DeflateDecompressor& deflate,
+    std::string&& dictionary)
+    : window_bits_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(deflate, window_bits, DefaultWindowBits)),
+      chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(deflate, chunk_size, DefaultChunkSize)),
+      dictionary_(std::move(dictionary)),
+      content_encoding_(contentCoding(deflate.content_coding())) {}
+
+Envoy::Decompressor::DecompressorPtr DeflateDecompressorFactory::createDecompressor() {
+  auto decompressor = std::make_unique<Envoy::Decompressor::ZlibDecompressorImpl>(chunk_size_);
+  decompressor->init(window_bits_);
+  decompressor->setDictionary(dictionary_);
+  return decompressor;
+}
+
+const std::string& DeflateDecompressorFactory::contentEncoding() const {
+  return content_encoding_;
+}
+
+Envoy::Decompressor::DecompressorFactoryPtr
+DeflateDecompressorLibraryFactory::createDecompressorFactoryFromProto(
+    const Protobuf::Message& config, Server::Configuration::FactoryContext& context) {
+  const auto& deflate = MessageUtil::downcastAndValidate<
+      const envoy::config::compression::deflate::v2alpha::DeflateDecompressor&>(config);
+  return std::make_unique<DeflateDecompressorFactory>(
+      deflate, Config::DataSource::read(deflate.dictionary(), true, context.api()));
+}
+
+std::string DeflateDecompressorLibraryFactory::name() {
+  return DecompressorLibraryNames::get().Deflate;
+}
+
+/**
+ * Static registration for the deflate decompressor library. @see RegisterFactory.
+ */
+REGISTER_FACTORY(DeflateDecompressorLibraryFactory,
+                 Envoy::Decompressor::NamedDecompressorLibraryConfigFactory);
+
+} // namespace Deflate
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+
+#include "envoy/config/compression/deflate/v2alpha/deflate.pb.h"
+#include "envoy/decompressor/config.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Deflate {
+
+/**
+ * Creates the zlib decompressors of the deflate content coding. The decompressors refer to the
+ * dictionary of the factory, so they must not outlive it.
+ */
+class DeflateDecompressorFactory : public Envoy::Decompressor::DecompressorFactory {
+public:
+  DeflateDecompressorFactory(
+      const envoy::config::compression::deflate::v2alpha::DeflateDecompressor& deflate,
+      std::string&& dictionary);
+
+  // Decompressor::DecompressorFactory
+  Envoy::Decompressor::DecompressorPtr createDecompressor() override;
+  const std::string& contentEncoding() const override;
+
+private:
+  const int64_t window_bits_;
+  const uint64_t chunk_size_;
+  // Empty if no dictionary is configured.
+  const std::string dictionary_;
+  const std::string content_encoding_;
+};
+
+/**
+ * Config registration for the deflate decompressor library.
+ * @see NamedDecompressorLibraryConfigFactory.
+ */
+class DeflateDecompressorLibraryFactory
+    : public Envoy::Decompressor::NamedDecompressorLibraryConfigFactory {
+public:
+  // Decompressor::NamedDecompressorLibraryConfigFactory
+  Envoy::Decompressor::DecompressorFactoryPtr
+  createDecompressorFactoryFromProto(const Protobuf::Message& config,
+                                     Server::Configuration::FactoryContext& context) override;
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<envoy::config::compression::deflate::v2alpha::DeflateDecompressor>();
+  }
+  std::string name() override;
+};
+
+} // namespace Deflate
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,94 @@
+#include "extensions/compression/gzip/compressor/config.h"
+
+#include "envoy/config/compression/gzip/v2alpha/gzip.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "common/http/headers.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/compression/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Gzip {
+
+namespace {
+// Default zlib memory level.
+const uint64_t DefaultMemoryLevel = 5;
+
+// Default compression window size.
+const uint64_t DefaultWindowBits = 12;
+
+// When summed to window bits, this sets a gzip header and trailer around the compressed data.
+const uint64_t GzipHeaderValue = 16;
+} // namespace
+
+GzipCompressorFactory::GzipCompressorFactory(
+    const envoy::config::compression::gzip::v2alpha::GzipCompressor& gzip)
+    : compression_level_(compressionLevelEnum(gzip.compression_level())),
+      compression_strategy_(compressionStrategyEnum(gzip.compression_strategy())),
+      window_bits_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(gzip, window_bits, DefaultWindowBits) |
+                   GzipHeaderValue),
+      memory_level_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(gzip, memory_level, DefaultMemoryLevel)) {}
+
+Envoy::Compressor::ZlibCompressorImpl::CompressionLevel
+GzipCompressorFactory::compressionLevelEnum(
+    envoy::config::compression::gzip::v2alpha::GzipCompressor::CompressionLevel
+        compression_level) {
+  switch (compression_level) {
+  case envoy::config::compression::gzip::v2alpha::GzipCompressor::BEST:
+    return Envoy::Compressor::ZlibCompressorImpl::CompressionLevel::Best;
+  case envoy::config::compression::gzip::v2alpha::GzipCompressor::SPEED:
+    return Envoy::Compressor::ZlibCompressorImpl::CompressionLevel::Speed;
+  default:
+    return Envoy::Compressor::ZlibCompressorImpl::CompressionLevel::Standard;
+  }
+}
+
+Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy
+GzipCompressorFactory::compressionStrategyEnum(
+    envoy::config::compression::gzip::v2alpha::GzipCompressor::CompressionStrategy
+        compression_strategy) {
+  switch (compression_strategy) {
+  case envoy::config::compression::gzip::v2alpha::GzipCompressor::RLE:
+    return Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Rle;
+  case envoy::config::compression::gzip::v2alpha::GzipCompressor::FILTERED:
+    return Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Filtered;
+  case envoy::config::compression::gzip::v2alpha::GzipCompressor::HUFFMAN:
+    return Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Huffman;
+  default:
+    return Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Standard;
+  }
+}
+
+Envoy::Compressor::CompressorPtr GzipCompressorFactory::createCompressor() {
+  auto compressor = std::make_unique<Envoy::Compressor::ZlibCompressorImpl>();
+  compressor->init(compression_level_, compression_strategy_, window_bits_, memory_level_);
+  return compressor;
+}
+
+const std::string& GzipCompressorFactory::contentEncoding() const {
+  return Http::Headers::get().ContentEncodingValues.Gzip;
+}
+
+Envoy::Compressor::CompressorFactoryPtr
+GzipCompressorLibraryFactory::createCompressorFactoryFromProto(
+    const Protobuf::Message& config, Server::Configuration::FactoryContext&) {
+  return std::make_unique<GzipCompressorFactory>(
+      MessageUtil::downcastAndValidate<
+          const envoy::config::compression::gzip::v2alpha::GzipCompressor&>(config));
+}
+
+std::string GzipCompressorLibraryFactory::name() { return CompressorLibraryNames::get().Gzip; }
+
+/**
+ * Static registration for the gzip compressor library. @see RegisterFactory.
+ */
+REGISTER_FACTORY(GzipCompressorLibraryFactory,
+                 Envoy::Compressor::NamedCompressorLibraryConfigFactory);
+
+} // namespace Gzip
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+
+#include "envoy/compressor/config.h"
+#include "envoy/config/compression/gzip/v2alpha/gzip.pb.h"
+
+#include "common/compressor/zlib_compressor_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Gzip {
+
+/**
+ * Creates the zlib compressors of the gzip content coding.
+ */
+class GzipCompressorFactory : public Envoy::Compressor::CompressorFactory {
+public:
+  GzipCompressorFactory(const envoy::config::compression::gzip::v2alpha::GzipCompressor& gzip);
+
+  // Compressor::CompressorFactory
+  Envoy::Compressor::CompressorPtr createCompressor() override;
+  const std::string& contentEncoding() const override;
+
+private:
+  static Envoy::Compressor::ZlibCompressorImpl::CompressionLevel compressionLevelEnum(
+      envoy::config::compression::gzip::v2alpha::GzipCompressor::CompressionLevel
+          compression_level);
+  static Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy compressionStrategyEnum(
+      envoy::config::compression::gzip::v2alpha::GzipCompressor::CompressionStrategy
+          compression_strategy);
+
+  const Envoy::Compressor::ZlibCompressorImpl::CompressionLevel compression_level_;
+  const Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy compression_strategy_;
+  const int64_t window_bits_;
+  const uint64_t memory_level_;
+};
+
+/**
+ * Config registration for the gzip compressor library. @see NamedCompressorLibraryConfigFactory.
+ */
+class GzipCompressorLibraryFactory
+    : public Envoy::Compressor::NamedCompressorLibraryConfigFactory {
+public:
+  // Compressor::NamedCompressorLibraryConfigFactory
+  Envoy::Compressor::CompressorFactoryPtr
+  createCompressorFactoryFromProto(const Protobuf::Message& config,
+                                   Server::Configuration::FactoryContext&) override;
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<envoy::config::compression::gzip::v2alpha::GzipCompressor>();
+  }
+  std::string name() override;
+};
+
+} // namespace Gzip
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
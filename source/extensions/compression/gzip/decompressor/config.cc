@@ -0,0 +1,65 @@
+#include "extensions/compression/gzip/decompressor/config.h"
+
+#include "envoy/config/compression/gzip/v2alpha/gzip.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "common/decompressor/zlib_decompressor_impl.h"
+#include "common/http/headers.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/compression/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Gzip {
+
+namespace {
+// Default decompression window size, which reads the data compressed with any window size.
+const uint64_t DefaultWindowBits = 15;
+
+// Default size of the output chunks.
+const uint64_t DefaultChunkSize = 4096;
+
+// When summed to window bits, this expects a gzip header and trailer around the compressed data.
+const uint64_t GzipHeaderValue = 16;
+} // namespace
+
+GzipDecompressorFactory::GzipDecompressorFactory(
+    const envoy::config::compression::gzip::v2alpha::GzipDecompressor& gzip)
+    : window_bits_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(gzip, window_bits, DefaultWindowBits) |
+                   GzipHeaderValue),
+      chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(gzip, chunk_size, DefaultChunkSize)) {}
+
+Envoy::Decompressor::DecompressorPtr GzipDecompressorFactory::createDecompressor() {
+  auto decompressor = std::make_unique<Envoy::Decompressor::ZlibDecompressorImpl>(chunk_size_);
+  decompressor->init(window_bits_);
+  return decompressor;
+}
+
+const std::string& GzipDecompressorFactory::contentEncoding() const {
+  return Http::Headers::get().ContentEncodingValues.Gzip;
+}
+
+Envoy::Decompressor::DecompressorFactoryPtr
+GzipDecompressorLibraryFactory::createDecompressorFactoryFromProto(
+    const Protobuf::Message& config, Server::Configuration::FactoryContext&) {
+  return std::make_unique<GzipDecompressorFactory>(
+      MessageUtil::downcastAndValidate<
+          const envoy::config::compression::gzip::v2alpha::GzipDecompressor&>(config));
+}
+
+std::string GzipDecompressorLibraryFactory::name() {
+  return DecompressorLibraryNames::get().Gzip;
+}
+
+/**
+ * Static registration for the gzip decompressor library. @see RegisterFactory.
+ */
+REGISTER_FACTORY(GzipDecompressorLibraryFactory,
+                 Envoy::Decompressor::NamedDecompressorLibraryConfigFactory);
+
+} // namespace Gzip
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
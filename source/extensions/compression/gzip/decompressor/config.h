@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+
+#include "envoy/config/compression/gzip/v2alpha/gzip.pb.h"
+#include "envoy/decompressor/config.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Gzip {
+
+/**
+ * Creates the zlib decompressors of the gzip content coding.
+ */
+class GzipDecompressorFactory : public Envoy::Decompressor::DecompressorFactory {
+public:
+  GzipDecompressorFactory(const envoy::config::compression::gzip::v2alpha::GzipDecompressor& gzip);
+
+  // Decompressor::DecompressorFactory
+  Envoy::Decompressor::DecompressorPtr createDecompressor() override;
+  const std::string& contentEncoding() const override;
+
+private:
+  const int64_t window_bits_;
+  const uint64_t chunk_size_;
+};
+
+/**
+ * Config registration for the gzip decompressor library.
+ * @see NamedDecompressorLibraryConfigFactory.
+ */
+class GzipDecompressorLibraryFactory
+    : public Envoy::Decompressor::NamedDecompressorLibraryConfigFactory {
+public:
+  // Decompressor::NamedDecompressorLibraryConfigFactory
+  Envoy::Decompressor::DecompressorFactoryPtr
+  createDecompressorFactoryFromProto(const Protobuf::Message& config,
+                                     Server::Configuration::FactoryContext&) override;
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<envoy::config::compression::gzip::v2alpha::GzipDecompressor>();
+  }
+  std::string name() override;
+};
+
+} // namespace Gzip
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
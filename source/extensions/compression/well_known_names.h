@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+
+#include "common/singleton/const_singleton.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+
+/**
+ * Well-known compressor library names.
+ */
+class CompressorLibraryNameValues {
+public:
+  // Deflate compressor, built on zlib.
+  const std::string Deflate = "envoy.compression.deflate.compressor";
+  // Gzip compressor, built on zlib.
+  const std::string Gzip = "envoy.compression.gzip.compressor";
+};
+
+typedef ConstSingleton<CompressorLibraryNameValues> CompressorLibraryNames;
+
+/**
+ * Well-known decompressor library names.
+ */
+class DecompressorLibraryNameValues {
+public:
+  // Deflate decompressor, built on zlib.
+  const std::string Deflate = "envoy.compression.deflate.decompressor";
+  // Gzip decompressor, built on zlib.
+  const std::string Gzip = "envoy.compression.gzip.decompressor";
+};
+
+typedef ConstSingleton<DecompressorLibraryNameValues> DecompressorLibraryNames;
+
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
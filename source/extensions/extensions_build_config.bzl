@@ -4,6 +4,7 @@ EXTENSIONS = {
     # Access loggers
     #
 
+    "envoy.access_loggers.columnar_file":               "//source/extensions/access_loggers/columnar_file:config",
     "envoy.access_loggers.file":                        "//source/extensions/access_loggers/file:config",
     "envoy.access_loggers.http_grpc":                   "//source/extensions/access_loggers/http_grpc:config",
 
@@ -18,6 +19,15 @@ EXTENSIONS = {
 
     "envoy.grpc_credentials.file_based_metadata":       "//source/extensions/grpc_credentials/file_based_metadata:config",
 
+    #
+    # Compression libraries
+    #
+
+    "envoy.compression.deflate.compressor":             "//source/extensions/compression/deflate/compressor:config",
+    "envoy.compression.deflate.decompressor":           "//source/extensions/compression/deflate/decompressor:config",
+    "envoy.compression.gzip.compressor":                "//source/extensions/compression/gzip/compressor:config",
+    "envoy.compression.gzip.decompressor":              "//source/extensions/compression/gzip/decompressor:config",
+
     #
     # Health checkers
     #
@@ -28,9 +38,13 @@ EXTENSIONS = {
     # HTTP filters
     #
 
+    "envoy.filters.http.adaptive_concurrency":          "//source/extensions/filters/http/adaptive_concurrency:config",
     "envoy.filters.http.buffer":                        "//source/extensions/filters/http/buffer:config",
+    "envoy.filters.http.cache":                         "//source/extensions/filters/http/cache:config",
+    "envoy.filters.http.compressor":                    "//source/extensions/filters/http/compressor:config",
     "envoy.filters.http.cors":                          "//source/extensions/filters/http/cors:config",
     "envoy.filters.http.csrf":                          "//source/extensions/filters/http/csrf:config",
+    "envoy.filters.http.decompressor":                  "//source/extensions/filters/http/decompressor:config",
     "envoy.filters.http.dynamo":                        "//source/extensions/filters/http/dynamo:config",
     "envoy.filters.http.ext_authz":                     "//source/extensions/filters/http/ext_authz:config",
     "envoy.filters.http.fault":                         "//source/extensions/filters/http/fault:config",
@@ -43,6 +57,7 @@ EXTENSIONS = {
     "envoy.filters.http.health_check":                  "//source/extensions/filters/http/health_check:config",
     "envoy.filters.http.ip_tagging":                    "//source/extensions/filters/http/ip_tagging:config",
     "envoy.filters.http.jwt_authn":                     "//source/extensions/filters/http/jwt_authn:config",
+    "envoy.filters.http.local_ratelimit":               "//source/extensions/filters/http/local_ratelimit:config",
     "envoy.filters.http.lua":                           "//source/extensions/filters/http/lua:config",
     "envoy.filters.http.ratelimit":                     "//source/extensions/filters/http/ratelimit:config",
     "envoy.filters.http.rbac":                          "//source/extensions/filters/http/rbac:config",
@@ -80,6 +95,7 @@ EXTENSIONS = {
     "envoy.filters.network.kafka":                      "//source/extensions/filters/network/kafka:kafka_request_codec_lib",
     "envoy.filters.network.mongo_proxy":                "//source/extensions/filters/network/mongo_proxy:config",
     "envoy.filters.network.mysql_proxy":                "//source/extensions/filters/network/mysql_proxy:config",
+    "envoy.filters.network.local_ratelimit":            "//source/extensions/filters/network/local_ratelimit:config",
     "envoy.filters.network.ratelimit":                  "//source/extensions/filters/network/ratelimit:config",
     "envoy.filters.network.rbac":                       "//source/extensions/filters/network/rbac:config",
     "envoy.filters.network.redis_proxy":                "//source/extensions/filters/network/redis_proxy:config",
@@ -139,6 +155,7 @@ WINDOWS_EXTENSIONS = {
     # Access loggers
     #
 
+    "envoy.access_loggers.columnar_file":               "//source/extensions/access_loggers/columnar_file:config",
     "envoy.access_loggers.file":                        "//source/extensions/access_loggers/file:config",
     #"envoy.access_loggers.http_grpc":                   "//source/extensions/access_loggers/http_grpc:config",
 
@@ -148,6 +165,15 @@ WINDOWS_EXTENSIONS = {
 
     #"envoy.grpc_credentials.file_based_metadata":      "//source/extensions/grpc_credentials/file_based_metadata:config",
 
+    #
+    # Compression libraries
+    #
+
+    #"envoy.compression.deflate.compressor":             "//source/extensions/compression/deflate/compressor:config",
+    #"envoy.compression.deflate.decompressor":           "//source/extensions/compression/deflate/decompressor:config",
+    #"envoy.compression.gzip.compressor":                "//source/extensions/compression/gzip/compressor:config",
+    #"envoy.compression.gzip.decompressor":              "//source/extensions/compression/gzip/decompressor:config",
+
     #
     # Health checkers
     #
@@ -158,9 +184,13 @@ WINDOWS_EXTENSIONS = {
     # HTTP filters
     #
 
+    #"envoy.filters.http.adaptive_concurrency":          "//source/extensions/filters/http/adaptive_concurrency:config",
     #"envoy.filters.http.buffer":                        "//source/extensions/filters/http/buffer:config",
+    #"envoy.filters.http.cache":                         "//source/extensions/filters/http/cache:config",
+    #"envoy.filters.http.compressor":                    "//source/extensions/filters/http/compressor:config",
     #"envoy.filters.http.cors":                          "//source/extensions/filters/http/cors:config",
     #"envoy.filters.http.csrf":                          "//source/extensions/filters/http/csrf:config",
+    #"envoy.filters.http.decompressor":                  "//source/extensions/filters/http/decompressor:config",
     #"envoy.filters.http.dynamo":                        "//source/extensions/filters/http/dynamo:config",
     #"envoy.filters.http.ext_authz":                     "//source/extensions/filters/http/ext_authz:config",
     #"envoy.filters.http.fault":                         "//source/extensions/filters/http/fault:config",
@@ -170,6 +200,7 @@ WINDOWS_EXTENSIONS = {
     #"envoy.filters.http.gzip":                          "//source/extensions/filters/http/gzip:config",
     #"envoy.filters.http.health_check":                  "//source/extensions/filters/http/health_check:config",
     #"envoy.filters.http.ip_tagging":                    "//source/extensions/filters/http/ip_tagging:config",
+    #"envoy.filters.http.local_ratelimit":               "//source/extensions/filters/http/local_ratelimit:config",
     #"envoy.filters.http.lua":                           "//source/extensions/filters/http/lua:config",
     #"envoy.filters.http.ratelimit":                     "//source/extensions/filters/http/ratelimit:config",
     #"envoy.filters.http.rbac":                          "//source/extensions/filters/http/rbac:config",
@@ -201,6 +232,7 @@ WINDOWS_EXTENSIONS = {
     #"envoy.filters.network.mongo_proxy":                "//source/extensions/filters/network/mongo_proxy:config",
     #"envoy.filters.network.mysql_proxy":                "//source/extensions/filters/network/mysql_proxy:config",
     #"envoy.filters.network.redis_proxy":                "//source/extensions/filters/network/redis_proxy:config",
+    #"envoy.filters.network.local_ratelimit":            "//source/extensions/filters/network/local_ratelimit:config",
     #"envoy.filters.network.ratelimit":                  "//source/extensions/filters/network/ratelimit:config",
     "envoy.filters.network.tcp_proxy":                  "//source/extensions/filters/network/tcp_proxy:config",
     #"envoy.filters.network.thrift_proxy":               "//source/extensions/filters/network/thrift_proxy:config",
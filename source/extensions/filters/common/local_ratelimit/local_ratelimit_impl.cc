@@ -0,0 +1,62 @@
+#include "extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
+
+#include "common/common/atomic_token_bucket_impl.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace LocalRateLimit {
+
+namespace {
+
+TokenBucketPtr createTokenBucket(const envoy::type::TokenBucket& config, TimeSource& time_source) {
+  const uint32_t tokens_per_fill = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, tokens_per_fill, 1);
+  const double fill_interval_seconds =
+      config.fill_interval().seconds() + config.fill_interval().nanos() / 1e9;
+  return std::make_unique<AtomicTokenBucketImpl>(config.max_tokens(), time_source,
+                                                 tokens_per_fill / fill_interval_seconds);
+}
+
+} // namespace
+
+LocalRateLimiterImpl::LocalRateLimiterImpl(const envoy::type::TokenBucket& token_bucket,
+                                           TimeSource& time_source)
+    : time_source_(time_source), token_bucket_(createTokenBucket(token_bucket, time_source)) {}
+
+void LocalRateLimiterImpl::addDescriptor(const RateLimit::Descriptor& descriptor,
+                                         const envoy::type::TokenBucket& token_bucket) {
+  descriptors_[descriptorKey(descriptor)] = createTokenBucket(token_bucket, time_source_);
+}
+
+bool LocalRateLimiterImpl::requestAllowed(
+    const std::vector<RateLimit::Descriptor>& request_descriptors) {
+  if (!descriptors_.empty()) {
+    for (const RateLimit::Descriptor& descriptor : request_descriptors) {
+      auto token_bucket = descriptors_.find(descriptorKey(descriptor));
+      if (token_bucket != descriptors_.end()) {
+        return token_bucket->second->consume(1, false) == 1;
+      }
+    }
+  }
+  return token_bucket_->consume(1, false) == 1;
+}
+
+std::string LocalRateLimiterImpl::descriptorKey(const RateLimit::Descriptor& descriptor) {
+  // The separators keep the entries of different descriptors from producing the same key.
+  std::string key;
+  for (const RateLimit::DescriptorEntry& entry : descriptor.entries_) {
+    key.append(entry.key_);
+    key.push_back('\0');
+    key.append(entry.value_);
+    key.push_back('\0');
+  }
+  return key;
+}
+
+} // namespace LocalRateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/common/token_bucket.h"
+#include "envoy/ratelimit/ratelimit.h"
+#include "envoy/type/token_bucket.pb.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace LocalRateLimit {
+
+/**
+ * Rate limits requests locally, without a round trip to a rate limit service. The token buckets
+ * are shared by all the workers, so that the limits apply to the whole Envoy instance, and taking
+ * a token from them is lock free.
+ */
+class LocalRateLimiterImpl {
+public:
+  /**
+   * @param token_bucket supplies the token bucket of the requests without a matching descriptor.
+   * @param time_source supplies the time source of the token buckets.
+   */
+  LocalRateLimiterImpl(const envoy::type::TokenBucket& token_bucket, TimeSource& time_source);
+
+  /**
+   * Add a token bucket for the requests with a descriptor. This must be done before the limiter is
+   * shared with the workers.
+   * @param descriptor supplies the descriptor.
+   * @param token_bucket supplies the token bucket of the requests with the descriptor.
+   */
+  void addDescriptor(const RateLimit::Descriptor& descriptor,
+                     const envoy::type::TokenBucket& token_bucket);
+
+  /**
+   * @return bool whether there is no descriptor with its own token bucket.
+   */
+  bool descriptorsEmpty() const { return descriptors_.empty(); }
+
+  /**
+   * Take a token for a request.
+   * @param request_descriptors supplies the descriptors of the request. The token is taken from
+   *        the bucket of the first of them which was added with addDescriptor(), if any, and from
+   *        the default bucket otherwise.
+   * @return bool whether the request is allowed, false if the bucket was empty.
+   */
+  bool requestAllowed(const std::vector<RateLimit::Descriptor>& request_descriptors);
+
+private:
+  static std::string descriptorKey(const RateLimit::Descriptor& descriptor);
+
+  TimeSource& time_source_;
+  const TokenBucketPtr token_bucket_;
+  absl::flat_hash_map<std::string, TokenBucketPtr> descriptors_;
+};
+
+} // namespace LocalRateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,86 @@
+#include "extensions/filters/http/adaptive_concurrency/adaptive_concurrency_filter.h"
+
+#include "envoy/http/codes.h"
+#include "envoy/router/router.h"
+
+#include "common/singleton/const_singleton.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace AdaptiveConcurrency {
+
+struct RcDetailsValues {
+  // The number of outstanding requests to the upstream cluster reached its concurrency limit.
+  const std::string ConcurrencyLimitReached = "reached_concurrency_limit";
+};
+typedef ConstSingleton<RcDetailsValues> RcDetails;
+
+AdaptiveConcurrencyFilterConfig::AdaptiveConcurrencyFilterConfig(
+    const envoy::config::filter::http::adaptive_concurrency::v2alpha::AdaptiveConcurrency&
+        proto_config,
+    const std::string& stats_prefix, Stats::Scope& scope, TimeSource& time_source)
+    : controller_config_(proto_config.gradient_controller_config()),
+      stats_prefix_(stats_prefix + "adaptive_concurrency."), scope_(scope),
+      time_source_(time_source) {}
+
+GradientController& AdaptiveConcurrencyFilterConfig::controller(const std::string& cluster_name) {
+  {
+    absl::ReaderMutexLock lock(&controllers_lock_);
+    auto controller = controllers_.find(cluster_name);
+    if (controller != controllers_.end()) {
+      return *controller->second;
+    }
+  }
+
+  absl::MutexLock lock(&controllers_lock_);
+  std::unique_ptr<GradientController>& controller = controllers_[cluster_name];
+  if (controller == nullptr) {
+    controller = std::make_unique<GradientController>(
+        controller_config_, time_source_,
+        absl::StrCat(stats_prefix_, cluster_name, ".gradient_controller."), scope_);
+  }
+  return *controller;
+}
+
+Http::FilterHeadersStatus AdaptiveConcurrencyFilter::decodeHeaders(Http::HeaderMap&, bool) {
+  Router::RouteConstSharedPtr route = decoder_callbacks_->route();
+  if (route == nullptr || route->routeEntry() == nullptr) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  GradientController& controller = config_->controller(route->routeEntry()->clusterName());
+  if (!controller.forwardingDecision()) {
+    decoder_callbacks_->sendLocalReply(Http::Code::ServiceUnavailable, "reached concurrency limit",
+                                       nullptr, absl::nullopt,
+                                       RcDetails::get().ConcurrencyLimitReached);
+    decoder_callbacks_->streamInfo().setResponseFlag(StreamInfo::ResponseFlag::UpstreamOverflow);
+    return Http::FilterHeadersStatus::StopIteration;
+  }
+
+  controller_ = &controller;
+  rq_start_time_ = config_->timeSource().monotonicTime();
+  return Http::FilterHeadersStatus::Continue;
+}
+
+Http::FilterHeadersStatus AdaptiveConcurrencyFilter::encodeHeaders(Http::HeaderMap&, bool) {
+  if (controller_ != nullptr) {
+    controller_->recordLatencySample(config_->timeSource().monotonicTime() - rq_start_time_);
+    controller_ = nullptr;
+  }
+  return Http::FilterHeadersStatus::Continue;
+}
+
+void AdaptiveConcurrencyFilter::onDestroy() {
+  if (controller_ != nullptr) {
+    controller_->cancelLatencySample();
+    controller_ = nullptr;
+  }
+}
+
+} // namespace AdaptiveConcurrency
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,165 @@
+#include "extensions/filters/http/adaptive_concurrency/gradient_controller.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/lock_guard.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace AdaptiveConcurrency {
+
+namespace {
+
+double percentOrDefault(bool has_percent, const envoy::type::Percent& percent,
+                        double default_value) {
+  return has_percent ? percent.value() / 100.0 : default_value;
+}
+
+} // namespace
+
+GradientControllerConfig::GradientControllerConfig(
+    const envoy::config::filter::http::adaptive_concurrency::v2alpha::GradientControllerConfig&
+        proto_config)
+    : concurrency_update_interval_(PROTOBUF_GET_MS_REQUIRED(
+          proto_config.concurrency_limit_params(), concurrency_update_interval)),
+      max_concurrency_limit_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          proto_config.concurrency_limit_params(), max_concurrency_limit, 1000)),
+      min_rtt_calc_interval_(
+          PROTOBUF_GET_MS_REQUIRED(proto_config.min_rtt_calc_params(), interval)),
+      min_rtt_aggregate_request_count_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config.min_rtt_calc_params(), request_count, 50)),
+      min_concurrency_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config.min_rtt_calc_params(), min_concurrency, 3)),
+      min_rtt_buffer_(percentOrDefault(proto_config.min_rtt_calc_params().has_buffer(),
+                                       proto_config.min_rtt_calc_params().buffer(), 0.25)),
+      sample_aggregate_percentile_(
+          percentOrDefault(proto_config.has_sample_aggregate_percentile(),
+                           proto_config.sample_aggregate_percentile(), 0.5)) {
+  if (min_concurrency_ > max_concurrency_limit_) {
+    throw EnvoyException(fmt::format(
+        "adaptive concurrency: min_concurrency {} is greater than max_concurrency_limit {}",
+        min_concurrency_, max_concurrency_limit_));
+  }
+}
+
+GradientController::GradientController(const GradientControllerConfig& config,
+                                       TimeSource& time_source, const std::string& stats_prefix,
+                                       Stats::Scope& scope)
+    : config_(config), time_source_(time_source), stats_(generateStats(stats_prefix, scope)),
+      concurrency_limit_(config_.minConcurrency()), deferred_limit_(config_.minConcurrency()),
+      min_rtt_calculation_start_(time_source_.monotonicTime()) {
+  stats_.concurrency_limit_.set(concurrency_limit_.load());
+  stats_.min_rtt_calculation_active_.set(1);
+}
+
+GradientControllerStats GradientController::generateStats(const std::string& prefix,
+                                                          Stats::Scope& scope) {
+  return {ALL_GRADIENT_CONTROLLER_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                        POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+bool GradientController::forwardingDecision() {
+  uint32_t outstanding = num_rq_outstanding_.load();
+  do {
+    if (outstanding >= concurrency_limit_.load()) {
+      stats_.rq_blocked_.inc();
+      return false;
+    }
+  } while (!num_rq_outstanding_.compare_exchange_weak(outstanding, outstanding + 1));
+  return true;
+}
+
+void GradientController::cancelLatencySample() {
+  ASSERT(num_rq_outstanding_.load() > 0);
+  --num_rq_outstanding_;
+}
+
+void GradientController::recordLatencySample(std::chrono::nanoseconds rq_latency) {
+  ASSERT(num_rq_outstanding_.load() > 0);
+  --num_rq_outstanding_;
+
+  const MonotonicTime now = time_source_.monotonicTime();
+  Thread::LockGuard lock(sample_lock_);
+  if (in_min_rtt_calculation_) {
+    if (now - rq_latency < min_rtt_calculation_start_) {
+      return;
+    }
+    latency_samples_.push_back(std::chrono::duration_cast<std::chrono::microseconds>(rq_latency));
+    if (latency_samples_.size() < config_.minRTTAggregateRequestCount()) {
+      return;
+    }
+
+    min_rtt_ = processLatencySamples();
+    stats_.min_rtt_msecs_.set(
+        std::chrono::duration_cast<std::chrono::milliseconds>(min_rtt_).count());
+    in_min_rtt_calculation_ = false;
+    stats_.min_rtt_calculation_active_.set(0);
+    updateConcurrencyLimit(deferred_limit_);
+    next_limit_update_ = now + config_.concurrencyUpdateInterval();
+    next_min_rtt_calculation_ = now + config_.minRTTCalcInterval();
+    return;
+  }
+
+  latency_samples_.push_back(std::chrono::duration_cast<std::chrono::microseconds>(rq_latency));
+  if (now < next_limit_update_) {
+    return;
+  }
+
+  sample_rtt_ = processLatencySamples();
+  stats_.sample_rtt_msecs_.set(
+      std::chrono::duration_cast<std::chrono::milliseconds>(sample_rtt_).count());
+  updateConcurrencyLimit(calculateNewLimit());
+  next_limit_update_ = now + config_.concurrencyUpdateInterval();
+  if (now >= next_min_rtt_calculation_) {
+    startMinRTTCalculation(now);
+  }
+}
+
+void GradientController::startMinRTTCalculation(MonotonicTime now) {
+  in_min_rtt_calculation_ = true;
+  stats_.min_rtt_calculation_active_.set(1);
+  min_rtt_calculation_start_ = now;
+  deferred_limit_ = concurrency_limit_.load();
+  updateConcurrencyLimit(config_.minConcurrency());
+}
+
+std::chrono::microseconds GradientController::processLatencySamples() {
+  ASSERT(!latency_samples_.empty());
+  // Nearest rank percentile.
+  const double rank = std::ceil(config_.sampleAggregatePercentile() * latency_samples_.size());
+  const size_t index = static_cast<size_t>(std::max(rank, 1.0)) - 1;
+  std::nth_element(latency_samples_.begin(), latency_samples_.begin() + index,
+                   latency_samples_.end());
+  const std::chrono::microseconds percentile = latency_samples_[index];
+  latency_samples_.clear();
+  return percentile;
+}
+
+uint32_t GradientController::calculateNewLimit() {
+  const double buffered_min_rtt = std::max<double>(min_rtt_.count(), 1) *
+                                  (1 + config_.minRTTBuffer());
+  const double gradient =
+      std::max(0.5, std::min(2.0, buffered_min_rtt / std::max<double>(sample_rtt_.count(), 1)));
+  const double limit = concurrency_limit_.load() * gradient;
+  // The headroom lets the limit grow while the latency stays within the buffer of the minRTT.
+  const double new_limit = limit + std::sqrt(limit);
+  return static_cast<uint32_t>(std::max<double>(
+      config_.minConcurrency(), std::min<double>(config_.maxConcurrencyLimit(), new_limit)));
+}
+
+void GradientController::updateConcurrencyLimit(uint32_t new_limit) {
+  concurrency_limit_.store(new_limit);
+  stats_.concurrency_limit_.set(new_limit);
+}
+
+} // namespace AdaptiveConcurrency
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
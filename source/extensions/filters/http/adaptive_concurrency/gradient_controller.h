@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/config/filter/http/adaptive_concurrency/v2alpha/adaptive_concurrency.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace AdaptiveConcurrency {
+
+/**
+ * All stats for the gradient controller. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_GRADIENT_CONTROLLER_STATS(COUNTER, GAUGE)                                              \
+  COUNTER(rq_blocked)                                                                              \
+  GAUGE(concurrency_limit)                                                                         \
+  GAUGE(min_rtt_msecs)                                                                             \
+  GAUGE(sample_rtt_msecs)                                                                          \
+  GAUGE(min_rtt_calculation_active)
+// clang-format on
+
+/**
+ * Wrapper struct for gradient controller stats. @see stats_macros.h
+ */
+struct GradientControllerStats {
+  ALL_GRADIENT_CONTROLLER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * The parsed configuration of the gradient controllers.
+ */
+class GradientControllerConfig {
+public:
+  GradientControllerConfig(
+      const envoy::config::filter::http::adaptive_concurrency::v2alpha::GradientControllerConfig&
+          proto_config);
+
+  std::chrono::milliseconds concurrencyUpdateInterval() const {
+    return concurrency_update_interval_;
+  }
+  uint32_t maxConcurrencyLimit() const { return max_concurrency_limit_; }
+  std::chrono::milliseconds minRTTCalcInterval() const { return min_rtt_calc_interval_; }
+  uint32_t minRTTAggregateRequestCount() const { return min_rtt_aggregate_request_count_; }
+  uint32_t minConcurrency() const { return min_concurrency_; }
+  // The fraction of the minRTT that the sampled RTT may exceed it by, between 0 and 1.
+  double minRTTBuffer() const { return min_rtt_buffer_; }
+  // The percentile of the sampled latencies that is used as the RTT, between 0 and 1.
+  double sampleAggregatePercentile() const { return sample_aggregate_percentile_; }
+
+private:
+  const std::chrono::milliseconds concurrency_update_interval_;
+  const uint32_t max_concurrency_limit_;
+  const std::chrono::milliseconds min_rtt_calc_interval_;
+  const uint32_t min_rtt_aggregate_request_count_;
+  const uint32_t min_concurrency_;
+  const double min_rtt_buffer_;
+  const double sample_aggregate_percentile_;
+};
+
+/**
+ * Computes the concurrency limit of an upstream cluster from the latencies of its requests, and
+ * decides whether new requests may be forwarded to it. It is shared by all the workers.
+ *
+ * The minimum round trip time (minRTT) is measured first, by sampling the latency of a number of
+ * requests while the concurrency limit is held at its minimum, so that the upstream does not queue
+ * them. Afterwards, the latencies of the requests are sampled during each update interval, and the
+ * limit is multiplied by the gradient minRTT / sampled RTT, clamped to [0.5, 2], plus a headroom of
+ * the square root of the limit which lets it grow while the latency is stable. The minRTT is
+ * measured again at a fixed interval, to follow the changes of the upstream.
+ *
+ * The limit is updated by the requests that complete once the update interval is over rather than
+ * by a timer, so the controller needs no dispatcher.
+ */
+class GradientController {
+public:
+  GradientController(const GradientControllerConfig& config, TimeSource& time_source,
+                     const std::string& stats_prefix, Stats::Scope& scope);
+
+  /**
+   * Called when a request starts.
+   * @return bool whether the request may be forwarded upstream. If it may, the request is counted
+   *         as outstanding until recordLatencySample() or cancelLatencySample() is called.
+   */
+  bool forwardingDecision();
+
+  /**
+   * Called when the upstream answers a forwarded request.
+   * @param rq_latency supplies the time between the forwarding decision and the response headers.
+   */
+  void recordLatencySample(std::chrono::nanoseconds rq_latency);
+
+  /**
+   * Called when a forwarded request ends without a response from the upstream.
+   */
+  void cancelLatencySample();
+
+  uint32_t concurrencyLimit() const { return concurrency_limit_.load(); }
+
+private:
+  static GradientControllerStats generateStats(const std::string& prefix, Stats::Scope& scope);
+
+  void startMinRTTCalculation(MonotonicTime now) EXCLUSIVE_LOCKS_REQUIRED(sample_lock_);
+  std::chrono::microseconds processLatencySamples() EXCLUSIVE_LOCKS_REQUIRED(sample_lock_);
+  uint32_t calculateNewLimit() EXCLUSIVE_LOCKS_REQUIRED(sample_lock_);
+  void updateConcurrencyLimit(uint32_t new_limit);
+
+  const GradientControllerConfig& config_;
+  TimeSource& time_source_;
+  GradientControllerStats stats_;
+
+  std::atomic<uint32_t> num_rq_outstanding_{0};
+  std::atomic<uint32_t> concurrency_limit_;
+
+  Thread::MutexBasicLockable sample_lock_;
+  // The latencies sampled since the last update of the limit or of the minRTT.
+  std::vector<std::chrono::microseconds> latency_samples_ GUARDED_BY(sample_lock_);
+  bool in_min_rtt_calculation_ GUARDED_BY(sample_lock_){true};
+  std::chrono::microseconds min_rtt_ GUARDED_BY(sample_lock_){};
+  std::chrono::microseconds sample_rtt_ GUARDED_BY(sample_lock_){};
+  // The limit to restore once the minRTT is measured.
+  uint32_t deferred_limit_ GUARDED_BY(sample_lock_);
+  // The requests forwarded before the minRTT calculation started are not sampled, since they may
+  // have been queued by the upstream.
+  MonotonicTime min_rtt_calculation_start_ GUARDED_BY(sample_lock_);
+  MonotonicTime next_limit_update_ GUARDED_BY(sample_lock_);
+  MonotonicTime next_min_rtt_calculation_ GUARDED_BY(sample_lock_);
+};
+
+typedef std::shared_ptr<GradientController> GradientControllerSharedPtr;
+
+} // namespace AdaptiveConcurrency
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
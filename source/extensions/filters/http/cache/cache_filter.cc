@@ -0,0 +1,544 @@
+#include "extensions/filters/http/cache/cache_filter.h"
+
+#include "envoy/http/codes.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/enum_to_int.h"
+#include "common/common/fmt.h"
+#include "common/common/stack_array.h"
+#include "common/common/utility.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/headers.h"
+#include "common/http/utility.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+struct RcDetailsValues {
+  // The request only accepted a cached response, and there was none.
+  const std::string OnlyIfCachedMiss = "cache_only_if_cached_miss";
+};
+typedef ConstSingleton<RcDetailsValues> RcDetails;
+
+namespace {
+
+// References the body of a cached response, which it keeps alive until the buffer it is added to
+// is done with it, so that responses are served from the cache without copying their body.
+class CachedBodyFragment : public Buffer::BufferFragment {
+public:
+  explicit CachedBodyFragment(std::shared_ptr<const std::string> body) : body_(std::move(body)) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return body_->data(); }
+  size_t size() const override { return body_->size(); }
+  void done() override { delete this; }
+
+private:
+  const std::shared_ptr<const std::string> body_;
+};
+
+void addCachedBody(Buffer::Instance& buffer, const std::shared_ptr<const std::string>& body) {
+  buffer.addBufferFragment(*new CachedBodyFragment(body));
+}
+
+// The response statuses which are cacheable by default (RFC 7231 section 6.1).
+bool isCacheableStatus(uint64_t status) {
+  switch (status) {
+  case 200:
+  case 203:
+  case 204:
+  case 300:
+  case 301:
+  case 404:
+  case 405:
+  case 410:
+  case 414:
+  case 501:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// The methods which do not invalidate cached responses (RFC 7231 section 4.2.1).
+bool isSafeMethod(absl::string_view method) {
+  const auto& methods = Http::Headers::get().MethodValues;
+  return method == methods.Get || method == methods.Head || method == methods.Options ||
+         method == methods.Trace;
+}
+
+bool isConditional(const Http::HeaderMap& request_headers) {
+  return request_headers.get(CacheHeaders::get().IfNoneMatch) != nullptr ||
+         request_headers.get(CacheHeaders::get().IfModifiedSince) != nullptr;
+}
+
+// Weak comparison of two entity tags (RFC 7232 section 2.3.2).
+bool etagsMatch(absl::string_view lhs, absl::string_view rhs) {
+  const absl::string_view weak_prefix = "W/";
+  if (absl::StartsWith(lhs, weak_prefix)) {
+    lhs.remove_prefix(weak_prefix.size());
+  }
+  if (absl::StartsWith(rhs, weak_prefix)) {
+    rhs.remove_prefix(weak_prefix.size());
+  }
+  return lhs == rhs;
+}
+
+// Whether the preconditions of a request are false for a cached response, which is then answered
+// with a 304 (RFC 7232 section 6).
+bool isNotModified(const Http::HeaderMap& request_headers,
+                   const Http::HeaderMap& response_headers) {
+  const Http::HeaderEntry* if_none_match = request_headers.get(CacheHeaders::get().IfNoneMatch);
+  if (if_none_match != nullptr) {
+    const Http::HeaderEntry* etag = response_headers.Etag();
+    for (absl::string_view tag :
+         StringUtil::splitToken(if_none_match->value().getStringView(), ",")) {
+      tag = StringUtil::trim(tag);
+      if (tag == "*" || (etag != nullptr && etagsMatch(tag, etag->value().getStringView()))) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const Http::HeaderEntry* if_modified_since =
+      request_headers.get(CacheHeaders::get().IfModifiedSince);
+  if (if_modified_since == nullptr || response_headers.LastModified() == nullptr) {
+    return false;
+  }
+  const absl::optional<SystemTime> since =
+      CacheHeadersUtils::httpTime(if_modified_since->value().getStringView());
+  const absl::optional<SystemTime> last_modified =
+      CacheHeadersUtils::httpTime(response_headers.LastModified()->value().getStringView());
+  return since.has_value() && last_modified.has_value() && last_modified.value() <= since.value();
+}
+
+void addHeader(Http::HeaderMap& headers, const Http::HeaderEntry& header) {
+  headers.addCopy(Http::LowerCaseString(std::string(header.key().getStringView())),
+                  std::string(header.value().getStringView()));
+}
+
+// Builds a response to cache from the headers of an upstream response.
+CachedResponseConstSharedPtr
+makeCachedResponse(Http::HeaderMapPtr&& headers, std::shared_ptr<const std::string> body,
+                   std::vector<std::pair<Http::LowerCaseString, std::string>> vary_values,
+                   SystemTime request_time, SystemTime response_time) {
+  auto response = std::make_shared<CachedResponse>();
+  const ResponseCacheControl cache_control = CacheHeadersUtils::responseCacheControl(*headers);
+  // A no-cache response may be cached, but must be revalidated before it is used.
+  response->freshness_lifetime_ =
+      cache_control.no_cache_
+          ? std::chrono::seconds(0)
+          : CacheHeadersUtils::freshnessLifetime(cache_control, *headers, response_time)
+                .value_or(std::chrono::seconds(0));
+  response->must_revalidate_ = cache_control.must_revalidate_ || cache_control.no_cache_;
+  response->initial_age_ = CacheHeadersUtils::initialAge(*headers, request_time, response_time);
+  response->response_time_ = response_time;
+
+  // The Age header is set when the response is served, and the body is only stored once it is
+  // complete.
+  headers->remove(CacheHeaders::get().Age);
+  headers->removeTransferEncoding();
+  headers->insertContentLength().value(body->size());
+  response->headers_ = std::move(headers);
+  response->body_ = std::move(body);
+  response->vary_values_ = std::move(vary_values);
+  return response;
+}
+
+} // namespace
+
+CacheFilterConfig::CacheFilterConfig(
+    const envoy::config::filter::http::cache::v2alpha::Cache& config, HttpCacheSharedPtr cache,
+    const std::string& stats_prefix, Stats::Scope& scope, TimeSource& time_source)
+    : cache_(std::move(cache)),
+      coalescer_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, coalesce_requests, true)
+                     ? std::make_unique<RequestCoalescer>()
+                     : nullptr),
+      max_body_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_body_bytes, 1024 * 1024)),
+      stats_{ALL_CACHE_FILTER_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix + "cache."))},
+      time_source_(time_source) {}
+
+CacheFilter::CacheFilter(const CacheFilterConfigSharedPtr& config) : config_(config) {}
+
+void CacheFilter::onDestroy() {
+  fill_callback_.reset();
+  inserting_ = false;
+  finishFill(false);
+}
+
+Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::HeaderMap& headers, bool) {
+  if (headers.Method() == nullptr || headers.Host() == nullptr || headers.Path() == nullptr) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  const std::string key = fmt::format(
+      "{}://{}{}",
+      headers.ForwardedProto() != nullptr ? headers.ForwardedProto()->value().getStringView()
+                                          : Http::Headers::get().SchemeValues.Http,
+      headers.Host()->value().getStringView(), headers.Path()->value().getStringView());
+  const absl::string_view method = headers.Method()->value().getStringView();
+  if (method != Http::Headers::get().MethodValues.Get) {
+    if (!isSafeMethod(method)) {
+      invalidated_key_ = key;
+    }
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  // Responses to requests with credentials are not shared, and range and precondition requests
+  // other than those which revalidate a response are passed through.
+  const auto& cache_headers = CacheHeaders::get();
+  if (headers.Authorization() != nullptr || headers.get(cache_headers.Range) != nullptr ||
+      headers.get(cache_headers.IfMatch) != nullptr ||
+      headers.get(cache_headers.IfUnmodifiedSince) != nullptr ||
+      headers.get(cache_headers.IfRange) != nullptr) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  key_ = key;
+  request_headers_ = &headers;
+  request_cache_control_ = CacheHeadersUtils::requestCacheControl(headers);
+  request_time_ = config_->timeSource().systemTime();
+  store_ = !request_cache_control_.no_store_;
+
+  switch (lookup()) {
+  case LookupResult::Served:
+    return Http::FilterHeadersStatus::StopIteration;
+  case LookupResult::Revalidating:
+    return Http::FilterHeadersStatus::Continue;
+  case LookupResult::Miss:
+    break;
+  }
+
+  if (request_cache_control_.only_if_cached_) {
+    store_ = false;
+    decoder_callbacks_->sendLocalReply(Http::Code::GatewayTimeout, "", nullptr, absl::nullopt,
+                                       RcDetails::get().OnlyIfCachedMiss);
+    return Http::FilterHeadersStatus::StopIteration;
+  }
+
+  // Conditional requests may be answered with a 304 which cannot be cached, so they never hold up
+  // other requests.
+  if (store_ && config_->coalescer() != nullptr && !isConditional(headers)) {
+    fill_callback_ = std::make_shared<RequestCoalescer::FillCallback>(
+        [this](bool filled) -> void { onFillComplete(filled); });
+    if (!config_->coalescer()->join(key_, decoder_callbacks_->dispatcher(), fill_callback_)) {
+      ENVOY_STREAM_LOG(debug, "waiting for the response to {} to be cached", *decoder_callbacks_,
+                       key_);
+      config_->stats().coalesced_.inc();
+      return Http::FilterHeadersStatus::StopIteration;
+    }
+    fill_callback_.reset();
+    filling_ = true;
+  }
+
+  config_->stats().miss_.inc();
+  return Http::FilterHeadersStatus::Continue;
+}
+
+CacheFilter::LookupResult CacheFilter::lookup() {
+  CachedResponseConstSharedPtr response = config_->cache().lookup(key_, *request_headers_);
+  if (response == nullptr) {
+    return LookupResult::Miss;
+  }
+
+  const SystemTime now = config_->timeSource().systemTime();
+  if (isServable(*response, now)) {
+    config_->stats().hit_.inc();
+    serve(*response, now);
+    return LookupResult::Served;
+  }
+
+  // Revalidate the response with its validators, unless the request has its own, in which case a
+  // 304 answers them rather than revalidating the cached response.
+  const Http::HeaderMap& response_headers = *response->headers_;
+  if (request_cache_control_.only_if_cached_ || isConditional(*request_headers_) ||
+      (response_headers.Etag() == nullptr && response_headers.LastModified() == nullptr)) {
+    return LookupResult::Miss;
+  }
+  if (response_headers.Etag() != nullptr) {
+    request_headers_->addCopy(CacheHeaders::get().IfNoneMatch,
+                              std::string(response_headers.Etag()->value().getStringView()));
+  }
+  if (response_headers.LastModified() != nullptr) {
+    request_headers_->addCopy(
+        CacheHeaders::get().IfModifiedSince,
+        std::string(response_headers.LastModified()->value().getStringView()));
+  }
+  ENVOY_STREAM_LOG(debug, "revalidating the cached response to {}", *decoder_callbacks_, key_);
+  revalidated_response_ = std::move(response);
+  return LookupResult::Revalidating;
+}
+
+bool CacheFilter::isServable(const CachedResponse& response, SystemTime now) const {
+  if (request_cache_control_.no_cache_) {
+    return false;
+  }
+  const std::chrono::seconds age = response.currentAge(now);
+  if (request_cache_control_.max_age_.has_value() &&
+      age > request_cache_control_.max_age_.value()) {
+    return false;
+  }
+
+  const std::chrono::seconds lifetime = response.freshness_lifetime_;
+  if (age < lifetime) {
+    return !request_cache_control_.min_fresh_.has_value() ||
+           lifetime - age >= request_cache_control_.min_fresh_.value();
+  }
+  // The response is stale, which the request may accept unless the response forbids it.
+  return !response.must_revalidate_ && request_cache_control_.max_stale_.has_value() &&
+         age - lifetime <= request_cache_control_.max_stale_.value();
+}
+
+void CacheFilter::serve(const CachedResponse& response, SystemTime now) {
+  // The response is encoded by this filter too, which must then leave it alone.
+  store_ = false;
+  key_.clear();
+
+  Http::HeaderMapPtr headers = std::make_unique<Http::HeaderMapImpl>(*response.headers_);
+  headers->addReferenceKey(CacheHeaders::get().Age,
+                           static_cast<uint64_t>(response.currentAge(now).count()));
+  if (isNotModified(*request_headers_, *response.headers_)) {
+    headers->Status()->value(enumToInt(Http::Code::NotModified));
+    headers->removeContentLength();
+    decoder_callbacks_->encodeHeaders(std::move(headers), true);
+    return;
+  }
+
+  const bool end_stream = response.body_->empty();
+  decoder_callbacks_->encodeHeaders(std::move(headers), end_stream);
+  if (!end_stream) {
+    Buffer::OwnedImpl body;
+    addCachedBody(body, response.body_);
+    decoder_callbacks_->encodeData(body, true);
+  }
+}
+
+void CacheFilter::onFillComplete(bool filled) {
+  fill_callback_.reset();
+  if (filled) {
+    const LookupResult result = lookup();
+    if (result == LookupResult::Served) {
+      return;
+    }
+    if (result == LookupResult::Revalidating) {
+      decoder_callbacks_->continueDecoding();
+      return;
+    }
+  }
+  config_->stats().miss_.inc();
+  decoder_callbacks_->continueDecoding();
+}
+
+void CacheFilter::finishFill(bool filled) {
+  if (filling_) {
+    filling_ = false;
+    config_->coalescer()->complete(key_, filled);
+  }
+}
+
+Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::HeaderMap& headers, bool end_stream) {
+  const uint64_t status = Http::Utility::getResponseStatus(headers);
+  if (!invalidated_key_.empty()) {
+    // A successful unsafe request may have changed the resource (RFC 7234 section 4.4).
+    if (status >= 200 && status < 400) {
+      config_->cache().remove(invalidated_key_);
+      config_->stats().invalidated_.inc();
+    }
+    return Http::FilterHeadersStatus::Continue;
+  }
+  if (key_.empty()) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  if (revalidated_response_ != nullptr && status == enumToInt(Http::Code::NotModified)) {
+    return encodeRevalidatedHeaders(headers, end_stream);
+  }
+  if (store_ && isCacheable(headers)) {
+    startInsert(headers);
+    if (end_stream) {
+      insert();
+    }
+  } else {
+    if (store_) {
+      config_->stats().not_cacheable_.inc();
+    }
+    finishFill(false);
+  }
+  return Http::FilterHeadersStatus::Continue;
+}
+
+Http::FilterDataStatus CacheFilter::encodeData(Buffer::Instance& data, bool end_stream) {
+  if (encoding_revalidated_body_) {
+    // A 304 has no body, it is replaced by the body of the revalidated response.
+    data.drain(data.length());
+    if (end_stream) {
+      addCachedBody(data, revalidated_response_->body_);
+    }
+    return Http::FilterDataStatus::Continue;
+  }
+
+  if (inserting_) {
+    if (inserted_body_.size() + data.length() > config_->maxBodyBytes()) {
+      abandonInsert();
+      return Http::FilterDataStatus::Continue;
+    }
+    const uint64_t num_slices = data.getRawSlices(nullptr, 0);
+    STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+    data.getRawSlices(slices.begin(), num_slices);
+    for (const Buffer::RawSlice& slice : slices) {
+      inserted_body_.append(static_cast<const char*>(slice.mem_), slice.len_);
+    }
+    if (end_stream) {
+      insert();
+    }
+  }
+  return Http::FilterDataStatus::Continue;
+}
+
+Http::FilterTrailersStatus CacheFilter::encodeTrailers(Http::HeaderMap&) {
+  if (encoding_revalidated_body_) {
+    Buffer::OwnedImpl body;
+    addCachedBody(body, revalidated_response_->body_);
+    encoder_callbacks_->addEncodedData(body, false);
+  }
+  // Responses with trailers are not cached.
+  if (inserting_) {
+    abandonInsert();
+  }
+  return Http::FilterTrailersStatus::Continue;
+}
+
+bool CacheFilter::isCacheable(const Http::HeaderMap& response_headers) const {
+  if (!isCacheableStatus(Http::Utility::getResponseStatus(response_headers))) {
+    return false;
+  }
+  const ResponseCacheControl cache_control =
+      CacheHeadersUtils::responseCacheControl(response_headers);
+  std::vector<std::string> vary_headers;
+  if (cache_control.no_store_ || cache_control.private_ ||
+      !CacheHeadersUtils::varyHeaders(response_headers, vary_headers)) {
+    return false;
+  }
+  uint64_t content_length;
+  if (response_headers.ContentLength() != nullptr &&
+      absl::SimpleAtoi(response_headers.ContentLength()->value().getStringView(),
+                       &content_length) &&
+      content_length > config_->maxBodyBytes()) {
+    return false;
+  }
+  // Without an explicit expiration time, a response is only worth caching if it can be
+  // revalidated.
+  return CacheHeadersUtils::freshnessLifetime(cache_control, response_headers,
+                                              config_->timeSource().systemTime())
+             .has_value() ||
+         response_headers.Etag() != nullptr || response_headers.LastModified() != nullptr;
+}
+
+void CacheFilter::startInsert(const Http::HeaderMap& response_headers) {
+  inserting_ = true;
+  inserted_headers_ = std::make_unique<Http::HeaderMapImpl>(response_headers);
+  inserted_body_.clear();
+}
+
+void CacheFilter::insert() {
+  inserting_ = false;
+  std::vector<std::string> vary_headers;
+  CacheHeadersUtils::varyHeaders(*inserted_headers_, vary_headers);
+  std::vector<std::pair<Http::LowerCaseString, std::string>> vary_values;
+  for (const std::string& name : vary_headers) {
+    Http::LowerCaseString vary_header(name);
+    const Http::HeaderEntry* entry = request_headers_->get(vary_header);
+    vary_values.emplace_back(std::move(vary_header),
+                             entry != nullptr ? std::string(entry->value().getStringView()) : "");
+  }
+
+  config_->cache().insert(
+      key_, makeCachedResponse(std::move(inserted_headers_),
+                               std::make_shared<const std::string>(std::move(inserted_body_)),
+                               std::move(vary_values), request_time_,
+                               config_->timeSource().systemTime()));
+  config_->stats().inserted_.inc();
+  finishFill(true);
+}
+
+void CacheFilter::abandonInsert() {
+  inserting_ = false;
+  inserted_headers_.reset();
+  std::string().swap(inserted_body_);
+  config_->stats().not_cacheable_.inc();
+  finishFill(false);
+}
+
+Http::FilterHeadersStatus CacheFilter::encodeRevalidatedHeaders(Http::HeaderMap& headers,
+                                                                bool end_stream) {
+  config_->stats().revalidated_.inc();
+
+  // The headers of the 304 replace those of the cached response (RFC 7234 section 4.3.4).
+  Http::HeaderMapPtr updated_headers =
+      std::make_unique<Http::HeaderMapImpl>(*revalidated_response_->headers_);
+  headers.iterate(
+      [](const Http::HeaderEntry& header, void* context) -> Http::HeaderMap::Iterate {
+        const absl::string_view key = header.key().getStringView();
+        if (!absl::StartsWith(key, ":") &&
+            key != Http::Headers::get().ContentLength.get() &&
+            key != Http::Headers::get().TransferEncoding.get()) {
+          static_cast<Http::HeaderMap*>(context)->remove(Http::LowerCaseString(std::string(key)));
+        }
+        return Http::HeaderMap::Iterate::Continue;
+      },
+      updated_headers.get());
+  headers.iterate(
+      [](const Http::HeaderEntry& header, void* context) -> Http::HeaderMap::Iterate {
+        const absl::string_view key = header.key().getStringView();
+        if (!absl::StartsWith(key, ":") &&
+            key != Http::Headers::get().ContentLength.get() &&
+            key != Http::Headers::get().TransferEncoding.get()) {
+          addHeader(*static_cast<Http::HeaderMap*>(context), header);
+        }
+        return Http::HeaderMap::Iterate::Continue;
+      },
+      updated_headers.get());
+
+  const SystemTime now = config_->timeSource().systemTime();
+  CachedResponseConstSharedPtr response =
+      makeCachedResponse(std::move(updated_headers), revalidated_response_->body_,
+                         revalidated_response_->vary_values_, request_time_, now);
+  const ResponseCacheControl cache_control =
+      CacheHeadersUtils::responseCacheControl(*response->headers_);
+  if (store_ && !cache_control.no_store_ && !cache_control.private_) {
+    config_->cache().insert(key_, response);
+  }
+
+  // Answer with the revalidated response.
+  headers.removePrefix(Http::LowerCaseString(""));
+  response->headers_->iterate(
+      [](const Http::HeaderEntry& header, void* context) -> Http::HeaderMap::Iterate {
+        addHeader(*static_cast<Http::HeaderMap*>(context), header);
+        return Http::HeaderMap::Iterate::Continue;
+      },
+      &headers);
+  headers.addReferenceKey(CacheHeaders::get().Age,
+                          static_cast<uint64_t>(response->currentAge(now).count()));
+
+  revalidated_response_ = std::move(response);
+  if (!end_stream) {
+    encoding_revalidated_body_ = true;
+  } else if (!revalidated_response_->body_->empty()) {
+    Buffer::OwnedImpl body;
+    addCachedBody(body, revalidated_response_->body_);
+    encoder_callbacks_->addEncodedData(body, false);
+  }
+  return Http::FilterHeadersStatus::Continue;
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/config/filter/http/cache/v2alpha/cache.pb.h"
+#include "envoy/http/filter.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/logger.h"
+
+#include "extensions/filters/http/cache/cache_headers_utils.h"
+#include "extensions/filters/http/cache/http_cache.h"
+#include "extensions/filters/http/cache/request_coalescer.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All cache filter stats. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_CACHE_FILTER_STATS(COUNTER)                                                            \
+  COUNTER(hit)                                                                                     \
+  COUNTER(miss)                                                                                    \
+  COUNTER(revalidated)                                                                             \
+  COUNTER(coalesced)                                                                               \
+  COUNTER(inserted)                                                                                \
+  COUNTER(not_cacheable)                                                                           \
+  COUNTER(invalidated)
+// clang-format on
+
+/**
+ * Struct definition for all cache filter stats. @see stats_macros.h
+ */
+struct CacheFilterStats {
+  ALL_CACHE_FILTER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Configuration for the cache filter, shared by the filters of all the workers.
+ */
+class CacheFilterConfig {
+public:
+  CacheFilterConfig(const envoy::config::filter::http::cache::v2alpha::Cache& config,
+                    HttpCacheSharedPtr cache, const std::string& stats_prefix, Stats::Scope& scope,
+                    TimeSource& time_source);
+
+  HttpCache& cache() { return *cache_; }
+  // nullptr if requests are not coalesced.
+  RequestCoalescer* coalescer() { return coalescer_.get(); }
+  uint64_t maxBodyBytes() const { return max_body_bytes_; }
+  CacheFilterStats& stats() { return stats_; }
+  TimeSource& timeSource() { return time_source_; }
+
+private:
+  const HttpCacheSharedPtr cache_;
+  const std::unique_ptr<RequestCoalescer> coalescer_;
+  const uint64_t max_body_bytes_;
+  CacheFilterStats stats_;
+  TimeSource& time_source_;
+};
+
+typedef std::shared_ptr<CacheFilterConfig> CacheFilterConfigSharedPtr;
+
+/**
+ * A filter that serves GET requests from an HttpCache, following the rules of a shared cache of
+ * RFC 7234. Stale responses are revalidated with their ETag or Last-Modified validator, and the
+ * unsafe requests which succeed invalidate the responses cached for their URI.
+ */
+class CacheFilter : public Http::StreamFilter, Logger::Loggable<Logger::Id::filter> {
+public:
+  CacheFilter(const CacheFilterConfigSharedPtr& config);
+
+  // Http::StreamFilterBase
+  void onDestroy() override;
+
+  // Http::StreamDecoderFilter
+  Http::FilterHeadersStatus decodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+  Http::FilterDataStatus decodeData(Buffer::Instance&, bool) override {
+    return Http::FilterDataStatus::Continue;
+  }
+  Http::FilterTrailersStatus decodeTrailers(Http::HeaderMap&) override {
+    return Http::FilterTrailersStatus::Continue;
+  }
+  void setDecoderFilterCallbacks(Http::StreamDecoderFilterCallbacks& callbacks) override {
+    decoder_callbacks_ = &callbacks;
+  }
+
+  // Http::StreamEncoderFilter
+  Http::FilterHeadersStatus encode100ContinueHeaders(Http::HeaderMap&) override {
+    return Http::FilterHeadersStatus::Continue;
+  }
+  Http::FilterHeadersStatus encodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+  Http::FilterDataStatus encodeData(Buffer::Instance& data, bool end_stream) override;
+  Http::FilterTrailersStatus encodeTrailers(Http::HeaderMap& trailers) override;
+  Http::FilterMetadataStatus encodeMetadata(Http::MetadataMap&) override {
+    return Http::FilterMetadataStatus::Continue;
+  }
+  void setEncoderFilterCallbacks(Http::StreamEncoderFilterCallbacks& callbacks) override {
+    encoder_callbacks_ = &callbacks;
+  }
+
+private:
+  enum class LookupResult {
+    // The request was answered from the cache.
+    Served,
+    // The request goes upstream, to revalidate a stale response.
+    Revalidating,
+    // The request goes upstream.
+    Miss,
+  };
+
+  LookupResult lookup();
+  bool isServable(const CachedResponse& response, SystemTime now) const;
+  void serve(const CachedResponse& response, SystemTime now);
+  void onFillComplete(bool filled);
+  void finishFill(bool filled);
+
+  bool isCacheable(const Http::HeaderMap& response_headers) const;
+  void startInsert(const Http::HeaderMap& response_headers);
+  void insert();
+  void abandonInsert();
+  Http::FilterHeadersStatus encodeRevalidatedHeaders(Http::HeaderMap& headers, bool end_stream);
+
+  const CacheFilterConfigSharedPtr config_;
+  Http::StreamDecoderFilterCallbacks* decoder_callbacks_{};
+  Http::StreamEncoderFilterCallbacks* encoder_callbacks_{};
+
+  // The key of the request, empty if it is neither served from nor stored in the cache.
+  std::string key_;
+  // The key whose cached responses are removed if the unsafe request succeeds.
+  std::string invalidated_key_;
+  // The request headers, which the validators of a revalidated response are added to.
+  Http::HeaderMap* request_headers_{};
+  RequestCacheControl request_cache_control_;
+  SystemTime request_time_;
+  // Whether the response may be stored in the cache.
+  bool store_{};
+  // Whether this request fetches the response that other coalesced requests wait for.
+  bool filling_{};
+  // Held while waiting for another request to fetch the response, so that the wake up is dropped
+  // once the filter is destroyed.
+  std::shared_ptr<RequestCoalescer::FillCallback> fill_callback_;
+  // The stale response being revalidated.
+  CachedResponseConstSharedPtr revalidated_response_;
+  // Whether the body of the revalidated response replaces the body of the 304 response.
+  bool encoding_revalidated_body_{};
+  // The response being stored.
+  Http::HeaderMapPtr inserted_headers_;
+  std::string inserted_body_;
+  bool inserting_{};
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
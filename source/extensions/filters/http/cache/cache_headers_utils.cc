@@ -0,0 +1,212 @@
+#include "extensions/filters/http/cache/cache_headers_utils.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "common/common/utility.h"
+#include "common/http/headers.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/time/time.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+namespace {
+
+// The largest delta-seconds value, to which larger ones are clamped (RFC 7234 section 1.2.1).
+constexpr uint64_t MaxDeltaSeconds = 1ULL << 31;
+
+// The formats of an HTTP-date: the preferred IMF-fixdate, followed by the obsolete RFC 850 and
+// asctime() formats (RFC 7231 section 7.1.1.1).
+const char* const HttpDateFormats[] = {"%a, %d %b %Y %H:%M:%S GMT", "%A, %d-%b-%y %H:%M:%S GMT",
+                                       "%a %b %e %H:%M:%S %Y"};
+
+// Calls cb with the name and the unquoted value of each directive of a Cache-Control header.
+void forEachDirective(const Http::HeaderEntry* header,
+                      const std::function<void(absl::string_view, absl::string_view)>& cb) {
+  if (header == nullptr) {
+    return;
+  }
+  for (absl::string_view directive : StringUtil::splitToken(header->value().getStringView(), ",")) {
+    const size_t separator = directive.find('=');
+    absl::string_view value;
+    if (separator != absl::string_view::npos) {
+      value = StringUtil::trim(directive.substr(separator + 1));
+      if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+        value = value.substr(1, value.size() - 2);
+      }
+    }
+    cb(StringUtil::trim(directive.substr(0, separator)), value);
+  }
+}
+
+// Parses the value of a directive whose argument is a delta-seconds value. As required by RFC 7234
+// section 4.2.1, an invalid max-age or s-maxage makes the response stale.
+std::chrono::seconds directiveSeconds(absl::string_view value) {
+  return CacheHeadersUtils::deltaSeconds(value).value_or(std::chrono::seconds(0));
+}
+
+} // namespace
+
+RequestCacheControl CacheHeadersUtils::requestCacheControl(const Http::HeaderMap& headers) {
+  RequestCacheControl cache_control;
+  if (headers.CacheControl() == nullptr) {
+    // Pragma: no-cache is only honored without Cache-Control (RFC 7234 section 5.4).
+    const Http::HeaderEntry* pragma = headers.get(CacheHeaders::get().Pragma);
+    cache_control.no_cache_ =
+        pragma != nullptr &&
+        StringUtil::caseFindToken(pragma->value().getStringView(), ",",
+                                  Http::Headers::get().CacheControlValues.NoCache);
+    return cache_control;
+  }
+
+  forEachDirective(headers.CacheControl(), [&cache_control](absl::string_view name,
+                                                            absl::string_view value) {
+    if (absl::EqualsIgnoreCase(name, "no-cache")) {
+      cache_control.no_cache_ = true;
+    } else if (absl::EqualsIgnoreCase(name, "no-store")) {
+      cache_control.no_store_ = true;
+    } else if (absl::EqualsIgnoreCase(name, "only-if-cached")) {
+      cache_control.only_if_cached_ = true;
+    } else if (absl::EqualsIgnoreCase(name, "max-age")) {
+      cache_control.max_age_ = directiveSeconds(value);
+    } else if (absl::EqualsIgnoreCase(name, "max-stale")) {
+      // Without a value, any stale response is acceptable.
+      cache_control.max_stale_ = value.empty() ? std::chrono::seconds::max()
+                                               : directiveSeconds(value);
+    } else if (absl::EqualsIgnoreCase(name, "min-fresh")) {
+      cache_control.min_fresh_ = directiveSeconds(value);
+    }
+  });
+  return cache_control;
+}
+
+ResponseCacheControl CacheHeadersUtils::responseCacheControl(const Http::HeaderMap& headers) {
+  ResponseCacheControl cache_control;
+  forEachDirective(headers.CacheControl(), [&cache_control](absl::string_view name,
+                                                            absl::string_view value) {
+    // The field names argument of no-cache and private is ignored, which makes them apply to the
+    // whole response as a cache that does not support them must do.
+    if (absl::EqualsIgnoreCase(name, "no-cache")) {
+      cache_control.no_cache_ = true;
+    } else if (absl::EqualsIgnoreCase(name, "no-store")) {
+      cache_control.no_store_ = true;
+    } else if (absl::EqualsIgnoreCase(name, "private")) {
+      cache_control.private_ = true;
+    } else if (absl::EqualsIgnoreCase(name, "must-revalidate") ||
+               absl::EqualsIgnoreCase(name, "proxy-revalidate")) {
+      cache_control.must_revalidate_ = true;
+    } else if (absl::EqualsIgnoreCase(name, "max-age")) {
+      cache_control.max_age_ = directiveSeconds(value);
+    } else if (absl::EqualsIgnoreCase(name, "s-maxage")) {
+      cache_control.s_maxage_ = directiveSeconds(value);
+      cache_control.must_revalidate_ = true;
+    }
+  });
+  return cache_control;
+}
+
+absl::optional<SystemTime> CacheHeadersUtils::httpTime(absl::string_view value) {
+  for (const char* format : HttpDateFormats) {
+    absl::Time time;
+    std::string error;
+    if (absl::ParseTime(format, std::string(value), absl::UTCTimeZone(), &time, &error)) {
+      return absl::ToChronoTime(time);
+    }
+  }
+  return absl::nullopt;
+}
+
+absl::optional<std::chrono::seconds> CacheHeadersUtils::deltaSeconds(absl::string_view value) {
+  if (value.empty()) {
+    return absl::nullopt;
+  }
+  uint64_t seconds = 0;
+  for (const char c : value) {
+    if (!absl::ascii_isdigit(c)) {
+      return absl::nullopt;
+    }
+    seconds = std::min(seconds * 10 + (c - '0'), MaxDeltaSeconds);
+  }
+  return std::chrono::seconds(seconds);
+}
+
+absl::optional<std::chrono::seconds>
+CacheHeadersUtils::freshnessLifetime(const ResponseCacheControl& cache_control,
+                                     const Http::HeaderMap& headers, SystemTime response_time) {
+  if (cache_control.s_maxage_.has_value()) {
+    return cache_control.s_maxage_;
+  }
+  if (cache_control.max_age_.has_value()) {
+    return cache_control.max_age_;
+  }
+
+  const Http::HeaderEntry* expires_header = headers.get(CacheHeaders::get().Expires);
+  if (expires_header == nullptr) {
+    return absl::nullopt;
+  }
+  // An invalid Expires header, such as "0", means that the response is already expired.
+  const absl::optional<SystemTime> expires = httpTime(expires_header->value().getStringView());
+  if (!expires.has_value()) {
+    return std::chrono::seconds(0);
+  }
+  absl::optional<SystemTime> date;
+  if (headers.Date() != nullptr) {
+    date = httpTime(headers.Date()->value().getStringView());
+  }
+  return std::max(
+      std::chrono::duration_cast<std::chrono::seconds>(expires.value() -
+                                                       date.value_or(response_time)),
+      std::chrono::seconds(0));
+}
+
+std::chrono::seconds CacheHeadersUtils::initialAge(const Http::HeaderMap& headers,
+                                                   SystemTime request_time,
+                                                   SystemTime response_time) {
+  std::chrono::seconds apparent_age(0);
+  if (headers.Date() != nullptr) {
+    const absl::optional<SystemTime> date = httpTime(headers.Date()->value().getStringView());
+    if (date.has_value()) {
+      apparent_age = std::max(
+          std::chrono::duration_cast<std::chrono::seconds>(response_time - date.value()),
+          std::chrono::seconds(0));
+    }
+  }
+
+  std::chrono::seconds age_value(0);
+  const Http::HeaderEntry* age = headers.get(CacheHeaders::get().Age);
+  if (age != nullptr) {
+    age_value = deltaSeconds(age->value().getStringView()).value_or(std::chrono::seconds(0));
+  }
+  const std::chrono::seconds response_delay =
+      std::chrono::duration_cast<std::chrono::seconds>(response_time - request_time);
+
+  return std::max(apparent_age, age_value + std::max(response_delay, std::chrono::seconds(0)));
+}
+
+bool CacheHeadersUtils::varyHeaders(const Http::HeaderMap& headers,
+                                    std::vector<std::string>& names) {
+  const Http::HeaderEntry* vary = headers.Vary();
+  if (vary == nullptr) {
+    return true;
+  }
+  for (absl::string_view name : StringUtil::splitToken(vary->value().getStringView(), ",")) {
+    name = StringUtil::trim(name);
+    if (name == "*") {
+      return false;
+    }
+    if (!name.empty()) {
+      names.push_back(absl::AsciiStrToLower(name));
+    }
+  }
+  return true;
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/http/header_map.h"
+
+#include "common/singleton/const_singleton.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Caching headers which are not used by the rest of Envoy.
+ */
+class CacheHeaderValues {
+public:
+  const Http::LowerCaseString Age{"age"};
+  const Http::LowerCaseString Expires{"expires"};
+  const Http::LowerCaseString IfMatch{"if-match"};
+  const Http::LowerCaseString IfModifiedSince{"if-modified-since"};
+  const Http::LowerCaseString IfNoneMatch{"if-none-match"};
+  const Http::LowerCaseString IfRange{"if-range"};
+  const Http::LowerCaseString IfUnmodifiedSince{"if-unmodified-since"};
+  const Http::LowerCaseString Pragma{"pragma"};
+  const Http::LowerCaseString Range{"range"};
+};
+
+typedef ConstSingleton<CacheHeaderValues> CacheHeaders;
+
+/**
+ * The Cache-Control directives of a request (RFC 7234 section 5.2.1).
+ */
+struct RequestCacheControl {
+  bool no_cache_{};
+  bool no_store_{};
+  bool only_if_cached_{};
+  absl::optional<std::chrono::seconds> max_age_;
+  // Set to std::chrono::seconds::max() when the request accepts responses of any staleness.
+  absl::optional<std::chrono::seconds> max_stale_;
+  absl::optional<std::chrono::seconds> min_fresh_;
+};
+
+/**
+ * The Cache-Control directives of a response that apply to a shared cache (RFC 7234 section
+ * 5.2.2).
+ */
+struct ResponseCacheControl {
+  bool no_cache_{};
+  bool no_store_{};
+  bool private_{};
+  // Set by must-revalidate, proxy-revalidate and s-maxage.
+  bool must_revalidate_{};
+  absl::optional<std::chrono::seconds> max_age_;
+  absl::optional<std::chrono::seconds> s_maxage_;
+};
+
+/**
+ * Parsing of the headers of RFC 7234 caching.
+ */
+class CacheHeadersUtils {
+public:
+  /**
+   * @param headers supplies the request headers.
+   * @return RequestCacheControl the Cache-Control directives of the request, or its Pragma no-cache
+   *         if it has no Cache-Control header.
+   */
+  static RequestCacheControl requestCacheControl(const Http::HeaderMap& headers);
+
+  /**
+   * @param headers supplies the response headers.
+   * @return ResponseCacheControl the Cache-Control directives of the response.
+   */
+  static ResponseCacheControl responseCacheControl(const Http::HeaderMap& headers);
+
+  /**
+   * @param value supplies an HTTP-date in any of the formats of RFC 7231 section 7.1.1.1.
+   * @return absl::optional<SystemTime> the date, or absl::nullopt if it is not valid.
+   */
+  static absl::optional<SystemTime> httpTime(absl::string_view value);
+
+  /**
+   * @param value supplies a delta-seconds value (RFC 7234 section 1.2.1).
+   * @return absl::optional<std::chrono::seconds> the value, clamped to 2^31 seconds, or
+   *         absl::nullopt if it is not valid.
+   */
+  static absl::optional<std::chrono::seconds> deltaSeconds(absl::string_view value);
+
+  /**
+   * Compute how long a response is fresh for (RFC 7234 section 4.2.1). Only explicit expiration
+   * times are used, freshness is never estimated heuristically.
+   * @param cache_control supplies the Cache-Control directives of the response.
+   * @param headers supplies the response headers.
+   * @param response_time supplies when the response was received.
+   * @return absl::optional<std::chrono::seconds> the freshness lifetime, or absl::nullopt if the
+   *         response has no explicit expiration time.
+   */
+  static absl::optional<std::chrono::seconds>
+  freshnessLifetime(const ResponseCacheControl& cache_control, const Http::HeaderMap& headers,
+                    SystemTime response_time);
+
+  /**
+   * Compute the age of a response when it was received (RFC 7234 section 4.2.3).
+   * @param headers supplies the response headers.
+   * @param request_time supplies when the request was sent.
+   * @param response_time supplies when the response was received.
+   * @return std::chrono::seconds the age of the response.
+   */
+  static std::chrono::seconds initialAge(const Http::HeaderMap& headers, SystemTime request_time,
+                                         SystemTime response_time);
+
+  /**
+   * @param headers supplies the response headers.
+   * @param names receives the lower case names of the request headers listed by the Vary header.
+   * @return bool false if the response varies on something other than request headers ("*"), in
+   *         which case it cannot be cached.
+   */
+  static bool varyHeaders(const Http::HeaderMap& headers, std::vector<std::string>& names);
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
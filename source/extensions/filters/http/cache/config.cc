@@ -0,0 +1,46 @@
+#include "extensions/filters/http/cache/config.h"
+
+#include "envoy/config/filter/http/cache/v2alpha/cache.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "common/config/utility.h"
+
+#include "extensions/filters/http/cache/cache_filter.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+Http::FilterFactoryCb CacheFilterFactory::createFilterFactoryFromProtoTyped(
+    const envoy::config::filter::http::cache::v2alpha::Cache& proto_config,
+    const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
+  HttpCacheSharedPtr cache;
+  if (proto_config.has_storage()) {
+    auto& factory =
+        Config::Utility::getAndCheckFactory<HttpCacheFactory>(proto_config.storage().name());
+    ProtobufTypes::MessagePtr storage_config =
+        Config::Utility::translateToFactoryConfig(proto_config.storage(), factory);
+    cache = factory.createCache(*storage_config, context);
+  } else {
+    auto& factory =
+        Config::Utility::getAndCheckFactory<HttpCacheFactory>(HttpCacheNames::get().InMemory);
+    cache = factory.createCache(*factory.createEmptyConfigProto(), context);
+  }
+
+  CacheFilterConfigSharedPtr config = std::make_shared<CacheFilterConfig>(
+      proto_config, std::move(cache), stats_prefix, context.scope(), context.timeSource());
+  return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addStreamFilter(std::make_shared<CacheFilter>(config));
+  };
+}
+
+/**
+ * Static registration for the cache filter. @see RegisterFactory.
+ */
+REGISTER_FACTORY(CacheFilterFactory, Server::Configuration::NamedHttpFilterConfigFactory);
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/common/pure.h"
+#include "envoy/common/time.h"
+#include "envoy/http/header_map.h"
+#include "envoy/server/filter_config.h"
+
+#include "common/protobuf/protobuf.h"
+#include "common/singleton/const_singleton.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Well-known HttpCache names.
+ */
+class HttpCacheNameValues {
+public:
+  // Sharded in-memory LRU cache
+  const std::string InMemory = "envoy.filters.http.cache.in_memory";
+};
+
+typedef ConstSingleton<HttpCacheNameValues> HttpCacheNames;
+
+/**
+ * A response stored in an HttpCache. Stored responses are immutable and shared by all the workers,
+ * so that cache hits reference the stored body instead of copying it.
+ */
+struct CachedResponse {
+  /**
+   * @return uint64_t the number of bytes used by the response.
+   */
+  uint64_t byteSize() const { return headers_->byteSize() + body_->size(); }
+
+  /**
+   * @return bool whether the request headers named by the Vary header of the response have the
+   *         same values as those of the request the response was cached for.
+   */
+  bool varyMatches(const Http::HeaderMap& request_headers) const {
+    for (const auto& vary_value : vary_values_) {
+      const Http::HeaderEntry* entry = request_headers.get(vary_value.first);
+      if ((entry == nullptr ? absl::string_view() : entry->value().getStringView()) !=
+          vary_value.second) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @return std::chrono::seconds the age of the response at a given time (RFC 7234 section 4.2.3).
+   */
+  std::chrono::seconds currentAge(SystemTime now) const {
+    return initial_age_ +
+           std::max(std::chrono::duration_cast<std::chrono::seconds>(now - response_time_),
+                    std::chrono::seconds(0));
+  }
+
+  // The response headers, without the Age header.
+  Http::HeaderMapPtr headers_;
+  // The response body. Revalidated responses share the body of the response they replace.
+  std::shared_ptr<const std::string> body_;
+  // For each request header named by the Vary header of the response, its value in the request
+  // that the response was cached for.
+  std::vector<std::pair<Http::LowerCaseString, std::string>> vary_values_;
+  // When the response was received.
+  SystemTime response_time_;
+  // The age of the response when it was received.
+  std::chrono::seconds initial_age_{};
+  // How long the response is fresh for, counted from its generation by the origin.
+  std::chrono::seconds freshness_lifetime_{};
+  // Whether the response must not be served stale, even if the request accepts stale responses.
+  bool must_revalidate_{};
+};
+
+typedef std::shared_ptr<const CachedResponse> CachedResponseConstSharedPtr;
+
+/**
+ * Storage of cached responses. A cache is shared by all the workers, so implementations must be
+ * thread safe.
+ */
+class HttpCache {
+public:
+  virtual ~HttpCache() {}
+
+  /**
+   * Look up a cached response. Stale responses are returned too, as the caller may revalidate them.
+   * @param key supplies the key of the request.
+   * @param request_headers supplies the request headers, which must match the Vary header of the
+   *        response.
+   * @return CachedResponseConstSharedPtr the cached response, or nullptr if there is none.
+   */
+  virtual CachedResponseConstSharedPtr lookup(const std::string& key,
+                                              const Http::HeaderMap& request_headers) PURE;
+
+  /**
+   * Cache a response, replacing the response cached for the same key and Vary request headers.
+   * @param key supplies the key of the request.
+   * @param response supplies the response.
+   */
+  virtual void insert(const std::string& key, CachedResponseConstSharedPtr response) PURE;
+
+  /**
+   * Remove all the responses cached for a key.
+   * @param key supplies the key of the request.
+   */
+  virtual void remove(const std::string& key) PURE;
+};
+
+typedef std::shared_ptr<HttpCache> HttpCacheSharedPtr;
+
+/**
+ * Implemented by each HttpCache and registered via Registry::registerFactory() or the convenience
+ * class RegisterFactory.
+ */
+class HttpCacheFactory {
+public:
+  virtual ~HttpCacheFactory() {}
+
+  /**
+   * Create a cache from its configuration.
+   * @param config supplies the configuration of the cache, as returned by
+   *        createEmptyConfigProto().
+   * @param context supplies the filter's factory context.
+   * @return HttpCacheSharedPtr the cache.
+   */
+  virtual HttpCacheSharedPtr createCache(const Protobuf::Message& config,
+                                         Server::Configuration::FactoryContext& context) PURE;
+
+  /**
+   * @return ProtobufTypes::MessagePtr an empty configuration of the cache.
+   */
+  virtual ProtobufTypes::MessagePtr createEmptyConfigProto() PURE;
+
+  /**
+   * @return std::string the identifying name of the cache.
+   */
+  virtual std::string name() PURE;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
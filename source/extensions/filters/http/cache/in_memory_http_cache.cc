@@ -0,0 +1,126 @@
+#include "extensions/filters/http/cache/in_memory_http_cache.h"
+
+#include "envoy/config/filter/http/cache/v2alpha/cache.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "common/common/hash.h"
+#include "common/common/lock_guard.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+InMemoryHttpCache::InMemoryHttpCache(uint64_t max_bytes, uint32_t num_shards)
+    : max_shard_bytes_(max_bytes / num_shards) {
+  ASSERT(num_shards > 0);
+  for (uint32_t i = 0; i < num_shards; i++) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+InMemoryHttpCache::Shard& InMemoryHttpCache::shard(const std::string& key) {
+  return *shards_[HashUtil::xxHash64(key) % shards_.size()];
+}
+
+CachedResponseConstSharedPtr InMemoryHttpCache::lookup(const std::string& key,
+                                                       const Http::HeaderMap& request_headers) {
+  Shard& shard = this->shard(key);
+  Thread::LockGuard lock(shard.lock_);
+  auto entry = shard.entries_.find(key);
+  if (entry == shard.entries_.end()) {
+    return nullptr;
+  }
+
+  shard.lru_.splice(shard.lru_.begin(), shard.lru_, entry->second.lru_position_);
+  for (const CachedResponseConstSharedPtr& variant : entry->second.variants_) {
+    if (variant->varyMatches(request_headers)) {
+      return variant;
+    }
+  }
+  return nullptr;
+}
+
+void InMemoryHttpCache::insert(const std::string& key, CachedResponseConstSharedPtr response) {
+  const uint64_t response_bytes = response->byteSize();
+  if (key.size() + response_bytes > max_shard_bytes_) {
+    return;
+  }
+
+  Shard& shard = this->shard(key);
+  Thread::LockGuard lock(shard.lock_);
+  auto entry = shard.entries_.find(key);
+  if (entry == shard.entries_.end()) {
+    shard.lru_.push_front(key);
+    entry = shard.entries_.emplace(key, Entry{shard.lru_.begin(), {}, key.size()}).first;
+    shard.bytes_ += key.size();
+  } else {
+    shard.lru_.splice(shard.lru_.begin(), shard.lru_, entry->second.lru_position_);
+  }
+
+  // Replace the variant selected by the same request header values, if any.
+  std::vector<CachedResponseConstSharedPtr>& variants = entry->second.variants_;
+  for (auto variant = variants.begin(); variant != variants.end(); ++variant) {
+    if ((*variant)->vary_values_ == response->vary_values_) {
+      const uint64_t variant_bytes = (*variant)->byteSize();
+      entry->second.bytes_ -= variant_bytes;
+      shard.bytes_ -= variant_bytes;
+      variants.erase(variant);
+      break;
+    }
+  }
+  variants.push_back(std::move(response));
+  entry->second.bytes_ += response_bytes;
+  shard.bytes_ += response_bytes;
+
+  // Evict the least recently used keys. The inserted key itself only goes if its other variants
+  // leave no room for the inserted one.
+  while (shard.bytes_ > max_shard_bytes_) {
+    removeEntry(shard, shard.entries_.find(shard.lru_.back()));
+  }
+}
+
+void InMemoryHttpCache::remove(const std::string& key) {
+  Shard& shard = this->shard(key);
+  Thread::LockGuard lock(shard.lock_);
+  auto entry = shard.entries_.find(key);
+  if (entry != shard.entries_.end()) {
+    removeEntry(shard, entry);
+  }
+}
+
+void InMemoryHttpCache::removeEntry(Shard& shard,
+                                    absl::flat_hash_map<std::string, Entry>::iterator entry) {
+  shard.bytes_ -= entry->second.bytes_;
+  shard.lru_.erase(entry->second.lru_position_);
+  shard.entries_.erase(entry);
+}
+
+uint64_t InMemoryHttpCache::bytes() const {
+  uint64_t bytes = 0;
+  for (const auto& shard : shards_) {
+    Thread::LockGuard lock(shard->lock_);
+    bytes += shard->bytes_;
+  }
+  return bytes;
+}
+
+HttpCacheSharedPtr InMemoryHttpCacheFactory::createCache(const Protobuf::Message& config,
+                                                         Server::Configuration::FactoryContext&) {
+  const auto& storage_config = MessageUtil::downcastAndValidate<
+      const envoy::config::filter::http::cache::v2alpha::InMemoryStorage&>(config);
+  return std::make_shared<InMemoryHttpCache>(
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(storage_config, max_bytes, 64 * 1024 * 1024),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(storage_config, shards, 16));
+}
+
+/**
+ * Static registration for the in-memory cache. @see RegisterFactory.
+ */
+REGISTER_FACTORY(InMemoryHttpCacheFactory, HttpCacheFactory);
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/filter/http/cache/v2alpha/cache.pb.h"
+
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+
+#include "extensions/filters/http/cache/http_cache.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * An HttpCache which keeps responses in memory. Keys are spread over shards with their own lock
+ * and an equal share of the capacity, and each shard evicts its least recently used keys when full.
+ */
+class InMemoryHttpCache : public HttpCache {
+public:
+  InMemoryHttpCache(uint64_t max_bytes, uint32_t num_shards);
+
+  // Cache::HttpCache
+  CachedResponseConstSharedPtr lookup(const std::string& key,
+                                      const Http::HeaderMap& request_headers) override;
+  void insert(const std::string& key, CachedResponseConstSharedPtr response) override;
+  void remove(const std::string& key) override;
+
+  /**
+   * @return uint64_t the number of bytes used by the cached responses and their keys.
+   */
+  uint64_t bytes() const;
+
+private:
+  struct Entry {
+    std::list<std::string>::iterator lru_position_;
+    // The variants of the response, one for each set of request header values named by its Vary
+    // header.
+    std::vector<CachedResponseConstSharedPtr> variants_;
+    uint64_t bytes_{};
+  };
+
+  struct Shard {
+    mutable Thread::MutexBasicLockable lock_;
+    absl::flat_hash_map<std::string, Entry> entries_ GUARDED_BY(lock_);
+    // Keys from the most to the least recently used.
+    std::list<std::string> lru_ GUARDED_BY(lock_);
+    uint64_t bytes_ GUARDED_BY(lock_){};
+  };
+
+  Shard& shard(const std::string& key);
+  void removeEntry(Shard& shard, absl::flat_hash_map<std::string, Entry>::iterator entry)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.lock_);
+
+  const uint64_t max_shard_bytes_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+/**
+ * Config registration for InMemoryHttpCache. @see HttpCacheFactory.
+ */
+class InMemoryHttpCacheFactory : public HttpCacheFactory {
+public:
+  // Cache::HttpCacheFactory
+  HttpCacheSharedPtr createCache(const Protobuf::Message& config,
+                                 Server::Configuration::FactoryContext& context) override;
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<envoy::config::filter::http::cache::v2alpha::InMemoryStorage>();
+  }
+  std::string name() override { return HttpCacheNames::get().InMemory; }
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,47 @@
+#include "extensions/filters/http/cache/request_coalescer.h"
+
+#include "common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+bool RequestCoalescer::join(const std::string& key, Event::Dispatcher& dispatcher,
+                            const std::shared_ptr<FillCallback>& callback) {
+  Thread::LockGuard lock(lock_);
+  auto fill = fills_.find(key);
+  if (fill == fills_.end()) {
+    fills_.emplace(key, std::vector<Waiter>());
+    return true;
+  }
+  fill->second.push_back(Waiter{dispatcher, callback});
+  return false;
+}
+
+void RequestCoalescer::complete(const std::string& key, bool filled) {
+  std::vector<Waiter> waiters;
+  {
+    Thread::LockGuard lock(lock_);
+    auto fill = fills_.find(key);
+    ASSERT(fill != fills_.end());
+    waiters = std::move(fill->second);
+    fills_.erase(fill);
+  }
+
+  // The callbacks may only be used on the thread of their request.
+  for (const Waiter& waiter : waiters) {
+    std::weak_ptr<FillCallback> callback = waiter.callback_;
+    waiter.dispatcher_.post([callback, filled]() -> void {
+      std::shared_ptr<FillCallback> locked_callback = callback.lock();
+      if (locked_callback != nullptr) {
+        (*locked_callback)(filled);
+      }
+    });
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Coalesces the requests of all the workers that miss the cache for the same key, so that only the
+ * first of them fetches the response while the others wait for it to be cached.
+ */
+class RequestCoalescer {
+public:
+  /**
+   * Called on the dispatcher of a waiting request once the request that fetches the response is
+   * done, with whether the response was cached.
+   */
+  typedef std::function<void(bool filled)> FillCallback;
+
+  /**
+   * Join the requests that missed the cache for a key.
+   * @param key supplies the key of the request.
+   * @param dispatcher supplies the dispatcher of the request, on which the callback is posted.
+   * @param callback supplies the callback. It is not called if it has been destroyed by then, so
+   *        the request should hold the only reference to it.
+   * @return bool true if the request is the first one to miss, in which case it must fetch the
+   *         response and call complete(), and the callback is never called.
+   */
+  bool join(const std::string& key, Event::Dispatcher& dispatcher,
+            const std::shared_ptr<FillCallback>& callback);
+
+  /**
+   * Called by the request that fetches the response once it is done, to wake up the requests
+   * waiting for it.
+   * @param key supplies the key of the request.
+   * @param filled supplies whether the response was cached.
+   */
+  void complete(const std::string& key, bool filled);
+
+private:
+  struct Waiter {
+    Event::Dispatcher& dispatcher_;
+    std::weak_ptr<FillCallback> callback_;
+  };
+
+  Thread::MutexBasicLockable lock_;
+  absl::flat_hash_map<std::string, std::vector<Waiter>> fills_ GUARDED_BY(lock_);
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
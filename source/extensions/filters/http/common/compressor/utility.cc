@@ -0,0 +1,96 @@
+#include "extensions/filters/http/common/compressor/utility.h"
+
+#include "common/common/macros.h"
+#include "common/http/headers.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+namespace Compression {
+
+const StringUtil::CaseUnorderedSet& Utility::defaultContentTypes() {
+  CONSTRUCT_ON_FIRST_USE(StringUtil::CaseUnorderedSet,
+                         {"text/html", "text/plain", "text/css", "application/javascript",
+                          "application/json", "image/svg+xml", "text/xml",
+                          "application/xhtml+xml"});
+}
+
+bool Utility::hasCacheControlNoTransform(const Http::HeaderMap& headers) {
+  const Http::HeaderEntry* cache_control = headers.CacheControl();
+  if (cache_control) {
+    return StringUtil::caseFindToken(cache_control->value().getStringView(), ",",
+                                     Http::Headers::get().CacheControlValues.NoTransform);
+  }
+
+  return false;
+}
+
+bool Utility::isContentTypeAllowed(const Http::HeaderMap& headers,
+                                   const StringUtil::CaseUnorderedSet& content_types) {
+  const Http::HeaderEntry* content_type = headers.ContentType();
+  if (content_type && !content_types.empty()) {
+    const absl::string_view value =
+        StringUtil::trim(StringUtil::cropRight(content_type->value().getStringView(), ";"));
+    return content_types.find(value) != content_types.end();
+  }
+
+  return true;
+}
+
+bool Utility::isTransferEncodingAllowed(const Http::HeaderMap& headers) {
+  const Http::HeaderEntry* transfer_encoding = headers.TransferEncoding();
+  if (transfer_encoding) {
+    for (auto header_value :
+         StringUtil::splitToken(transfer_encoding->value().getStringView(), ",", true)) {
+      const auto trimmed_value = StringUtil::trim(header_value);
+      if (StringUtil::caseCompare(trimmed_value,
+                                  Http::Headers::get().TransferEncodingValues.Gzip) ||
+          StringUtil::caseCompare(trimmed_value,
+                                  Http::Headers::get().TransferEncodingValues.Deflate)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+void Utility::insertVaryHeader(Http::HeaderMap& headers) {
+  const Http::HeaderEntry* vary = headers.Vary();
+  if (vary) {
+    if (!StringUtil::findToken(vary->value().getStringView(), ",",
+                               Http::Headers::get().VaryValues.AcceptEncoding, true)) {
+      std::string new_header;
+      absl::StrAppend(&new_header, vary->value().getStringView(), ", ",
+                      Http::Headers::get().VaryValues.AcceptEncoding);
+      headers.insertVary().value(new_header);
+    }
+  } else {
+    headers.insertVary().value(Http::Headers::get().VaryValues.AcceptEncoding);
+  }
+}
+
+// TODO(gsagula): It seems that every proxy has a different opinion how to handle Etag. Some
+// discussions around this topic have been going on for over a decade, e.g.,
+// https://bz.apache.org/bugzilla/show_bug.cgi?id=45023
+// This design attempts to stay more on the safe side by preserving weak etags and removing
+// the strong ones when disable_on_etag_header is false. Envoy does NOT re-write entity tags.
+void Utility::sanitizeEtagHeader(Http::HeaderMap& headers) {
+  const Http::HeaderEntry* etag = headers.Etag();
+  if (etag) {
+    absl::string_view value(etag->value().getStringView());
+    if (value.length() > 2 && !((value[0] == 'w' || value[0] == 'W') && value[1] == '/')) {
+      headers.removeEtag();
+    }
+  }
+}
+
+} // namespace Compression
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "envoy/http/header_map.h"
+
+#include "common/common/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+namespace Compression {
+
+/**
+ * Header handling shared by the filters that compress responses.
+ */
+class Utility {
+public:
+  /**
+   * @return const StringUtil::CaseUnorderedSet& the content types compressed by default.
+   */
+  static const StringUtil::CaseUnorderedSet& defaultContentTypes();
+
+  /**
+   * @return bool whether the Cache-Control header forbids transforming the response.
+   */
+  static bool hasCacheControlNoTransform(const Http::HeaderMap& headers);
+
+  /**
+   * @return bool whether the Content-Type of the response is one of the content types, or the
+   *         response has no Content-Type.
+   */
+  static bool isContentTypeAllowed(const Http::HeaderMap& headers,
+                                   const StringUtil::CaseUnorderedSet& content_types);
+
+  /**
+   * @return bool whether the Transfer-Encoding of the response has no compression coding.
+   */
+  static bool isTransferEncodingAllowed(const Http::HeaderMap& headers);
+
+  /**
+   * Add Accept-Encoding to the Vary header of a compressed response.
+   */
+  static void insertVaryHeader(Http::HeaderMap& headers);
+
+  /**
+   * Remove the strong ETag of a compressed response, which no longer matches its body. Weak ETags
+   * are preserved.
+   */
+  static void sanitizeEtagHeader(Http::HeaderMap& headers);
+};
+
+} // namespace Compression
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
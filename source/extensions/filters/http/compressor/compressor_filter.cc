@@ -0,0 +1,250 @@
+#include "extensions/filters/http/compressor/compressor_filter.h"
+
+#include "envoy/common/exception.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/fmt.h"
+#include "common/http/headers.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/filters/http/common/compressor/utility.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace CompressorFilter {
+
+namespace {
+// Minimum length of an upstream response that allows compression.
+const uint64_t MinimumContentLength = 30;
+
+// The quality value of a content coding listed in the Accept-Encoding header without one.
+const double DefaultQvalue = 1.0;
+
+CompressorStats generateStats(const std::string& prefix, Stats::Scope& scope) {
+  return CompressorStats{ALL_COMPRESSOR_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
+}
+
+CompressorLibraryStats generateLibraryStats(const std::string& prefix, Stats::Scope& scope) {
+  return CompressorLibraryStats{ALL_COMPRESSOR_LIBRARY_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
+}
+
+// Parses the quality value of a parameter of an Accept-Encoding element, returning false if the
+// parameter is not a quality value. Invalid quality values are considered to be zero, so that the
+// content coding is not used.
+bool parseQvalue(absl::string_view parameter, double& qvalue) {
+  if (parameter.size() < 2 || absl::ascii_tolower(parameter[0]) != 'q' || parameter[1] != '=') {
+    return false;
+  }
+  if (!absl::SimpleAtod(parameter.substr(2), &qvalue) || qvalue < 0 || qvalue > 1) {
+    qvalue = 0;
+  }
+  return true;
+}
+} // namespace
+
+CompressorFilterConfig::CompressorFilterConfig(
+    const envoy::config::filter::http::compressor::v2alpha::Compressor& compressor,
+    const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+    std::vector<Envoy::Compressor::CompressorFactoryPtr>&& factories)
+    : content_length_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(compressor, content_length, MinimumContentLength)),
+      content_type_values_(contentTypeSet(compressor.content_type())),
+      disable_on_etag_header_(compressor.disable_on_etag_header()),
+      remove_accept_encoding_header_(compressor.remove_accept_encoding_header()),
+      stats_(generateStats(stats_prefix + "compressor.", scope)), runtime_(runtime) {
+  for (auto& factory : factories) {
+    const std::string& content_encoding = factory->contentEncoding();
+    for (const CompressorLibrary& library : libraries_) {
+      if (library.factory_->contentEncoding() == content_encoding) {
+        throw EnvoyException(fmt::format(
+            "compressor filter: more than one library produces content encoding '{}'",
+            content_encoding));
+      }
+    }
+    libraries_.push_back(CompressorLibrary{
+        std::move(factory),
+        generateLibraryStats(stats_prefix + "compressor." + content_encoding + ".", scope)});
+  }
+}
+
+StringUtil::CaseUnorderedSet
+CompressorFilterConfig::contentTypeSet(const Protobuf::RepeatedPtrField<std::string>& types) {
+  return types.empty() ? Common::Compression::Utility::defaultContentTypes()
+                       : StringUtil::CaseUnorderedSet(types.cbegin(), types.cend());
+}
+
+CompressorFilter::CompressorFilter(const CompressorFilterConfigSharedPtr& config)
+    : config_(config) {}
+
+Http::FilterHeadersStatus CompressorFilter::decodeHeaders(Http::HeaderMap& headers, bool) {
+  if (config_->runtime().snapshot().featureEnabled("compressor.filter_enabled", 100)) {
+    library_ = chooseLibrary(headers);
+  }
+
+  if (library_ != nullptr) {
+    if (config_->removeAcceptEncodingHeader()) {
+      headers.removeAcceptEncoding();
+    }
+  } else {
+    config_->stats().not_compressed_.inc();
+  }
+
+  return Http::FilterHeadersStatus::Continue;
+}
+
+Http::FilterHeadersStatus CompressorFilter::encodeHeaders(Http::HeaderMap& headers,
+                                                          bool end_stream) {
+  if (library_ == nullptr) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  if (!end_stream && isMinimumContentLength(headers) &&
+      Common::Compression::Utility::isContentTypeAllowed(headers,
+                                                         config_->contentTypeValues()) &&
+      !Common::Compression::Utility::hasCacheControlNoTransform(headers) &&
+      isEtagAllowed(headers) && Common::Compression::Utility::isTransferEncodingAllowed(headers) &&
+      !headers.ContentEncoding()) {
+    Common::Compression::Utility::sanitizeEtagHeader(headers);
+    Common::Compression::Utility::insertVaryHeader(headers);
+    headers.removeContentLength();
+    headers.insertContentEncoding().value(library_->factory_->contentEncoding());
+    compressor_ = library_->factory_->createCompressor();
+    library_->stats_.compressed_.inc();
+  } else {
+    library_ = nullptr;
+    config_->stats().not_compressed_.inc();
+  }
+  return Http::FilterHeadersStatus::Continue;
+}
+
+Http::FilterDataStatus CompressorFilter::encodeData(Buffer::Instance& data, bool end_stream) {
+  if (compressor_ != nullptr) {
+    library_->stats_.total_uncompressed_bytes_.add(data.length());
+    compressor_->compress(data, end_stream ? Envoy::Compressor::State::Finish
+                                           : Envoy::Compressor::State::Flush);
+    library_->stats_.total_compressed_bytes_.add(data.length());
+  }
+  return Http::FilterDataStatus::Continue;
+}
+
+Http::FilterTrailersStatus CompressorFilter::encodeTrailers(Http::HeaderMap&) {
+  if (compressor_ != nullptr) {
+    Buffer::OwnedImpl empty_buffer;
+    compressor_->compress(empty_buffer, Envoy::Compressor::State::Finish);
+    library_->stats_.total_compressed_bytes_.add(empty_buffer.length());
+    encoder_callbacks_->addEncodedData(empty_buffer, true);
+  }
+  return Http::FilterTrailersStatus::Continue;
+}
+
+// The content coding with the highest quality value wins, the libraries listed first winning
+// ties. A content coding which is not listed takes the quality value of the wildcard, if any, and
+// identity is preferred over the libraries only when it is listed with a higher quality value.
+// https://tools.ietf.org/html/rfc7231#section-5.3.4
+CompressorLibrary* CompressorFilter::chooseLibrary(const Http::HeaderMap& headers) const {
+  const Http::HeaderEntry* accept_encoding = headers.AcceptEncoding();
+  if (accept_encoding == nullptr) {
+    config_->stats().no_accept_header_.inc();
+    return nullptr;
+  }
+
+  // A negative quality value stands for a content coding that is not listed.
+  double wildcard_qvalue = -1;
+  double identity_qvalue = -1;
+  std::vector<std::pair<absl::string_view, double>> qvalues;
+  for (const auto element :
+       StringUtil::splitToken(accept_encoding->value().getStringView(), ",", false)) {
+    const std::vector<absl::string_view> tokens = StringUtil::splitToken(element, ";", false);
+    if (tokens.empty()) {
+      continue;
+    }
+    const absl::string_view coding = StringUtil::trim(tokens[0]);
+    double qvalue = DefaultQvalue;
+    for (size_t i = 1; i < tokens.size(); i++) {
+      if (parseQvalue(StringUtil::trim(tokens[i]), qvalue)) {
+        break;
+      }
+    }
+
+    if (coding == Http::Headers::get().AcceptEncodingValues.Wildcard) {
+      wildcard_qvalue = qvalue;
+    } else if (StringUtil::caseCompare(coding,
+                                       Http::Headers::get().AcceptEncodingValues.Identity)) {
+      identity_qvalue = qvalue;
+    } else {
+      qvalues.emplace_back(coding, qvalue);
+    }
+  }
+
+  CompressorLibrary* chosen = nullptr;
+  double chosen_qvalue = 0;
+  bool chosen_by_wildcard = false;
+  for (CompressorLibrary& library : config_->libraries()) {
+    double qvalue = wildcard_qvalue;
+    bool by_wildcard = true;
+    for (const auto& listed : qvalues) {
+      if (StringUtil::caseCompare(listed.first, library.factory_->contentEncoding())) {
+        qvalue = listed.second;
+        by_wildcard = false;
+        break;
+      }
+    }
+    if (qvalue > chosen_qvalue) {
+      chosen = &library;
+      chosen_qvalue = qvalue;
+      chosen_by_wildcard = by_wildcard;
+    }
+  }
+
+  if (identity_qvalue >= 0 && (chosen == nullptr || identity_qvalue > chosen_qvalue)) {
+    config_->stats().header_identity_.inc();
+    return nullptr;
+  }
+  if (chosen == nullptr) {
+    config_->stats().header_not_valid_.inc();
+    return nullptr;
+  }
+
+  if (chosen_by_wildcard) {
+    config_->stats().header_wildcard_.inc();
+  } else {
+    chosen->stats_.header_compressor_used_.inc();
+  }
+  return chosen;
+}
+
+bool CompressorFilter::isEtagAllowed(const Http::HeaderMap& headers) const {
+  const bool is_etag_allowed = !(config_->disableOnEtagHeader() && headers.Etag());
+  if (!is_etag_allowed) {
+    config_->stats().not_compressed_etag_.inc();
+  }
+  return is_etag_allowed;
+}
+
+bool CompressorFilter::isMinimumContentLength(const Http::HeaderMap& headers) const {
+  const Http::HeaderEntry* content_length = headers.ContentLength();
+  if (content_length) {
+    uint64_t length;
+    const bool is_minimum_content_length =
+        absl::SimpleAtoi(content_length->value().getStringView(), &length) &&
+        length >= config_->minimumLength();
+    if (!is_minimum_content_length) {
+      config_->stats().content_length_too_small_.inc();
+    }
+    return is_minimum_content_length;
+  }
+
+  const Http::HeaderEntry* transfer_encoding = headers.TransferEncoding();
+  return (transfer_encoding &&
+          StringUtil::caseFindToken(transfer_encoding->value().getStringView(), ",",
+                                    Http::Headers::get().TransferEncodingValues.Chunked));
+}
+
+} // namespace CompressorFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
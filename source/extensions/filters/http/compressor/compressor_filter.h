@@ -0,0 +1,160 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/compressor/config.h"
+#include "envoy/config/filter/http/compressor/v2alpha/compressor.pb.h"
+#include "envoy/http/filter.h"
+#include "envoy/runtime/runtime.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace CompressorFilter {
+
+/**
+ * All compressor filter stats. @see stats_macros.h
+ * The counters of the responses that are compressed are found in CompressorLibraryStats, with the
+ * content coding of their library.
+ */
+// clang-format off
+#define ALL_COMPRESSOR_STATS(COUNTER)                                                              \
+  COUNTER(not_compressed)                                                                          \
+  COUNTER(no_accept_header)                                                                        \
+  COUNTER(header_identity)                                                                         \
+  COUNTER(header_wildcard)                                                                         \
+  COUNTER(header_not_valid)                                                                        \
+  COUNTER(content_length_too_small)                                                                \
+  COUNTER(not_compressed_etag)
+// clang-format on
+
+/**
+ * Struct definition for all compressor filter stats. @see stats_macros.h
+ */
+struct CompressorStats {
+  ALL_COMPRESSOR_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * All the stats of a compressor library. @see stats_macros.h
+ * "total_uncompressed_bytes" only includes the bytes of the responses that are compressed.
+ */
+// clang-format off
+#define ALL_COMPRESSOR_LIBRARY_STATS(COUNTER)                                                      \
+  COUNTER(compressed)                                                                              \
+  COUNTER(header_compressor_used)                                                                  \
+  COUNTER(total_uncompressed_bytes)                                                                \
+  COUNTER(total_compressed_bytes)
+// clang-format on
+
+/**
+ * Struct definition for the stats of a compressor library. @see stats_macros.h
+ */
+struct CompressorLibraryStats {
+  ALL_COMPRESSOR_LIBRARY_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * A compressor library of the filter, with its stats.
+ */
+struct CompressorLibrary {
+  Envoy::Compressor::CompressorFactoryPtr factory_;
+  CompressorLibraryStats stats_;
+};
+
+/**
+ * Configuration for the compressor filter.
+ */
+class CompressorFilterConfig {
+public:
+  /**
+   * @param factories supplies the compressor factories of the libraries, in the order of
+   *        preference of the server.
+   */
+  CompressorFilterConfig(
+      const envoy::config::filter::http::compressor::v2alpha::Compressor& compressor,
+      const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+      std::vector<Envoy::Compressor::CompressorFactoryPtr>&& factories);
+
+  Runtime::Loader& runtime() { return runtime_; }
+  CompressorStats& stats() { return stats_; }
+  std::vector<CompressorLibrary>& libraries() { return libraries_; }
+  const StringUtil::CaseUnorderedSet& contentTypeValues() const { return content_type_values_; }
+  bool disableOnEtagHeader() const { return disable_on_etag_header_; }
+  bool removeAcceptEncodingHeader() const { return remove_accept_encoding_header_; }
+  uint64_t minimumLength() const { return content_length_; }
+
+private:
+  static StringUtil::CaseUnorderedSet
+  contentTypeSet(const Protobuf::RepeatedPtrField<std::string>& types);
+
+  const uint64_t content_length_;
+  const StringUtil::CaseUnorderedSet content_type_values_;
+  const bool disable_on_etag_header_;
+  const bool remove_accept_encoding_header_;
+  CompressorStats stats_;
+  std::vector<CompressorLibrary> libraries_;
+  Runtime::Loader& runtime_;
+};
+
+typedef std::shared_ptr<CompressorFilterConfig> CompressorFilterConfigSharedPtr;
+
+/**
+ * A filter that compresses the responses with the library whose content coding is preferred by
+ * the Accept-Encoding header of the request. It generalizes the gzip filter to any number of
+ * compressor libraries.
+ */
+class CompressorFilter : public Http::StreamFilter {
+public:
+  CompressorFilter(const CompressorFilterConfigSharedPtr& config);
+
+  // Http::StreamFilterBase
+  void onDestroy() override {}
+
+  // Http::StreamDecoderFilter
+  Http::FilterHeadersStatus decodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+  Http::FilterDataStatus decodeData(Buffer::Instance&, bool) override {
+    return Http::FilterDataStatus::Continue;
+  }
+  Http::FilterTrailersStatus decodeTrailers(Http::HeaderMap&) override {
+    return Http::FilterTrailersStatus::Continue;
+  }
+  void setDecoderFilterCallbacks(Http::StreamDecoderFilterCallbacks&) override {}
+
+  // Http::StreamEncoderFilter
+  Http::FilterHeadersStatus encode100ContinueHeaders(Http::HeaderMap&) override {
+    return Http::FilterHeadersStatus::Continue;
+  }
+  Http::FilterHeadersStatus encodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+  Http::FilterDataStatus encodeData(Buffer::Instance& buffer, bool end_stream) override;
+  Http::FilterTrailersStatus encodeTrailers(Http::HeaderMap&) override;
+  Http::FilterMetadataStatus encodeMetadata(Http::MetadataMap&) override {
+    return Http::FilterMetadataStatus::Continue;
+  }
+  void setEncoderFilterCallbacks(Http::StreamEncoderFilterCallbacks& callbacks) override {
+    encoder_callbacks_ = &callbacks;
+  }
+
+private:
+  // The library preferred by the Accept-Encoding header of the request, or nullptr if the response
+  // must not be compressed.
+  CompressorLibrary* chooseLibrary(const Http::HeaderMap& headers) const;
+  bool isEtagAllowed(const Http::HeaderMap& headers) const;
+  bool isMinimumContentLength(const Http::HeaderMap& headers) const;
+
+  const CompressorFilterConfigSharedPtr config_;
+  CompressorLibrary* library_{};
+  Envoy::Compressor::CompressorPtr compressor_;
+  Http::StreamEncoderFilterCallbacks* encoder_callbacks_{};
+};
+
+} // namespace CompressorFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
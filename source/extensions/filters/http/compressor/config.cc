@@ -0,0 +1,44 @@
+#include "extensions/filters/http/compressor/config.h"
+
+#include "envoy/compressor/config.h"
+#include "envoy/config/filter/http/compressor/v2alpha/compressor.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "common/config/utility.h"
+
+#include "extensions/filters/http/compressor/compressor_filter.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace CompressorFilter {
+
+Http::FilterFactoryCb CompressorFilterFactory::createFilterFactoryFromProtoTyped(
+    const envoy::config::filter::http::compressor::v2alpha::Compressor& proto_config,
+    const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
+  std::vector<Envoy::Compressor::CompressorFactoryPtr> factories;
+  for (const auto& library : proto_config.compressor_libraries()) {
+    auto& factory =
+        Config::Utility::getAndCheckFactory<Envoy::Compressor::NamedCompressorLibraryConfigFactory>(
+            library.name());
+    ProtobufTypes::MessagePtr library_config =
+        Config::Utility::translateToFactoryConfig(library, factory);
+    factories.push_back(factory.createCompressorFactoryFromProto(*library_config, context));
+  }
+
+  CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
+      proto_config, stats_prefix, context.scope(), context.runtime(), std::move(factories));
+  return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addStreamFilter(std::make_shared<CompressorFilter>(config));
+  };
+}
+
+/**
+ * Static registration for the compressor filter. @see RegisterFactory.
+ */
+REGISTER_FACTORY(CompressorFilterFactory, Server::Configuration::NamedHttpFilterConfigFactory);
+
+} // namespace CompressorFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,43 @@
+#include "extensions/filters/http/decompressor/config.h"
+
+#include "envoy/config/filter/http/decompressor/v2alpha/decompressor.pb.validate.h"
+#include "envoy/decompressor/config.h"
+#include "envoy/registry/registry.h"
+
+#include "common/config/utility.h"
+
+#include "extensions/filters/http/decompressor/decompressor_filter.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace DecompressorFilter {
+
+Http::FilterFactoryCb DecompressorFilterFactory::createFilterFactoryFromProtoTyped(
+    const envoy::config::filter::http::decompressor::v2alpha::Decompressor& proto_config,
+    const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
+  std::vector<Envoy::Decompressor::DecompressorFactoryPtr> factories;
+  for (const auto& library : proto_config.decompressor_libraries()) {
+    auto& factory = Config::Utility::getAndCheckFactory<
+        Envoy::Decompressor::NamedDecompressorLibraryConfigFactory>(library.name());
+    ProtobufTypes::MessagePtr library_config =
+        Config::Utility::translateToFactoryConfig(library, factory);
+    factories.push_back(factory.createDecompressorFactoryFromProto(*library_config, context));
+  }
+
+  DecompressorFilterConfigSharedPtr config = std::make_shared<DecompressorFilterConfig>(
+      proto_config, stats_prefix, context.scope(), std::move(factories));
+  return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addStreamFilter(std::make_shared<DecompressorFilter>(config));
+  };
+}
+
+/**
+ * Static registration for the decompressor filter. @see RegisterFactory.
+ */
+REGISTER_FACTORY(DecompressorFilterFactory, Server::Configuration::NamedHttpFilterConfigFactory);
+
+} // namespace DecompressorFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,118 @@
+#include "extensions/filters/http/decompressor/decompressor_filter.h"
+
+#include "envoy/common/exception.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/fmt.h"
+#include "common/common/utility.h"
+#include "common/http/headers.h"
+
+#include "absl/strings/str_join.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace DecompressorFilter {
+
+namespace {
+DecompressorLibraryStats generateLibraryStats(const std::string& prefix, Stats::Scope& scope) {
+  return DecompressorLibraryStats{
+      ALL_DECOMPRESSOR_LIBRARY_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
+}
+} // namespace
+
+DecompressorFilterConfig::DecompressorFilterConfig(
+    const envoy::config::filter::http::decompressor::v2alpha::Decompressor& decompressor,
+    const std::string& stats_prefix, Stats::Scope& scope,
+    std::vector<Envoy::Decompressor::DecompressorFactoryPtr>&& factories) {
+  std::vector<std::string> content_encodings;
+  for (auto& factory : factories) {
+    const std::string& content_encoding = factory->contentEncoding();
+    if (library(content_encoding) != nullptr) {
+      throw EnvoyException(
+          fmt::format("decompressor filter: more than one library reads content encoding '{}'",
+                      content_encoding));
+    }
+    content_encodings.push_back(content_encoding);
+    libraries_.push_back(DecompressorLibrary{
+        std::move(factory),
+        generateLibraryStats(stats_prefix + "decompressor." + content_encoding + ".", scope)});
+  }
+
+  if (decompressor.advertise_accept_encoding()) {
+    accept_encoding_ = absl::StrJoin(content_encodings, ", ");
+  }
+}
+
+DecompressorLibrary* DecompressorFilterConfig::library(absl::string_view content_encoding) {
+  for (DecompressorLibrary& library : libraries_) {
+    if (StringUtil::caseCompare(library.factory_->contentEncoding(), content_encoding)) {
+      return &library;
+    }
+  }
+  return nullptr;
+}
+
+DecompressorFilter::DecompressorFilter(const DecompressorFilterConfigSharedPtr& config)
+    : config_(config) {}
+
+Http::FilterHeadersStatus DecompressorFilter::decodeHeaders(Http::HeaderMap& headers, bool) {
+  if (!config_->acceptEncoding().empty()) {
+    headers.insertAcceptEncoding().value(config_->acceptEncoding());
+  }
+  return Http::FilterHeadersStatus::Continue;
+}
+
+Http::FilterHeadersStatus DecompressorFilter::encodeHeaders(Http::HeaderMap& headers,
+                                                            bool end_stream) {
+  const Http::HeaderEntry* content_encoding = headers.ContentEncoding();
+  if (end_stream || content_encoding == nullptr) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  // The content codings are listed in the order they were applied, so only the last one can be
+  // removed.
+  const absl::string_view value = content_encoding->value().getStringView();
+  const auto separator = value.rfind(',');
+  const absl::string_view last_coding =
+      StringUtil::trim(separator == absl::string_view::npos ? value : value.substr(separator + 1));
+  library_ = config_->library(last_coding);
+  if (library_ == nullptr) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  if (separator == absl::string_view::npos) {
+    headers.removeContentEncoding();
+  } else {
+    const std::string remaining_codings(StringUtil::trim(value.substr(0, separator)));
+    headers.insertContentEncoding().value(remaining_codings);
+  }
+  headers.removeContentLength();
+  decompressor_ = library_->factory_->createDecompressor();
+  library_->stats_.decompressed_.inc();
+  return Http::FilterHeadersStatus::Continue;
+}
+
+Http::FilterDataStatus DecompressorFilter::encodeData(Buffer::Instance& data, bool) {
+  if (decompressor_ != nullptr) {
+    library_->stats_.total_compressed_bytes_.add(data.length());
+    Buffer::OwnedImpl output_buffer;
+    const bool decompressed = decompressor_->decompress(data, output_buffer);
+    data.drain(data.length());
+    if (!decompressed) {
+      // The headers have gone downstream already, so the stream is reset rather than passing on a
+      // body which ends early.
+      library_->stats_.decompression_error_.inc();
+      encoder_callbacks_->resetStream();
+      return Http::FilterDataStatus::StopIterationNoBuffer;
+    }
+    data.move(output_buffer);
+    library_->stats_.total_uncompressed_bytes_.add(data.length());
+  }
+  return Http::FilterDataStatus::Continue;
+}
+
+} // namespace DecompressorFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/filter/http/decompressor/v2alpha/decompressor.pb.h"
+#include "envoy/decompressor/config.h"
+#include "envoy/http/filter.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace DecompressorFilter {
+
+/**
+ * All the stats of a decompressor library. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_DECOMPRESSOR_LIBRARY_STATS(COUNTER)                                                    \
+  COUNTER(decompressed)                                                                            \
+  COUNTER(decompression_error)                                                                     \
+  COUNTER(total_compressed_bytes)                                                                  \
+  COUNTER(total_uncompressed_bytes)
+// clang-format on
+
+/**
+ * Struct definition for the stats of a decompressor library. @see stats_macros.h
+ */
+struct DecompressorLibraryStats {
+  ALL_DECOMPRESSOR_LIBRARY_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * A decompressor library of the filter, with its stats.
+ */
+struct DecompressorLibrary {
+  Envoy::Decompressor::DecompressorFactoryPtr factory_;
+  DecompressorLibraryStats stats_;
+};
+
+/**
+ * Configuration for the decompressor filter.
+ */
+class DecompressorFilterConfig {
+public:
+  DecompressorFilterConfig(
+      const envoy::config::filter::http::decompressor::v2alpha::Decompressor& decompressor,
+      const std::string& stats_prefix, Stats::Scope& scope,
+      std::vector<Envoy::Decompressor::DecompressorFactoryPtr>&& factories);
+
+  /**
+   * @return the library reading a content coding, or nullptr if there is none.
+   */
+  DecompressorLibrary* library(absl::string_view content_encoding);
+
+  // The Accept-Encoding header sent upstream, empty if the header of the requests is kept.
+  const std::string& acceptEncoding() const { return accept_encoding_; }
+
+private:
+  std::vector<DecompressorLibrary> libraries_;
+  std::string accept_encoding_;
+};
+
+typedef std::shared_ptr<DecompressorFilterConfig> DecompressorFilterConfigSharedPtr;
+
+/**
+ * A filter that decompresses the responses of the upstreams, for the filters and downstreams that
+ * do not handle their content coding.
+ */
+class DecompressorFilter : public Http::StreamFilter {
+public:
+  DecompressorFilter(const DecompressorFilterConfigSharedPtr& config);
+
+  // Http::StreamFilterBase
+  void onDestroy() override {}
+
+  // Http::StreamDecoderFilter
+  Http::FilterHeadersStatus decodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+  Http::FilterDataStatus decodeData(Buffer::Instance&, bool) override {
+    return Http::FilterDataStatus::Continue;
+  }
+  Http::FilterTrailersStatus decodeTrailers(Http::HeaderMap&) override {
+    return Http::FilterTrailersStatus::Continue;
+  }
+  void setDecoderFilterCallbacks(Http::StreamDecoderFilterCallbacks&) override {}
+
+  // Http::StreamEncoderFilter
+  Http::FilterHeadersStatus encode100ContinueHeaders(Http::HeaderMap&) override {
+    return Http::FilterHeadersStatus::Continue;
+  }
+  Http::FilterHeadersStatus encodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+  Http::FilterDataStatus encodeData(Buffer::Instance& data, bool end_stream) override;
+  Http::FilterTrailersStatus encodeTrailers(Http::HeaderMap&) override {
+    return Http::FilterTrailersStatus::Continue;
+  }
+  Http::FilterMetadataStatus encodeMetadata(Http::MetadataMap&) override {
+    return Http::FilterMetadataStatus::Continue;
+  }
+  void setEncoderFilterCallbacks(Http::StreamEncoderFilterCallbacks& callbacks) override {
+    encoder_callbacks_ = &callbacks;
+  }
+
+private:
+  const DecompressorFilterConfigSharedPtr config_;
+  Http::StreamEncoderFilterCallbacks* encoder_callbacks_{};
+  DecompressorLibrary* library_{};
+  Envoy::Decompressor::DecompressorPtr decompressor_;
+};
+
+} // namespace DecompressorFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -2,11 +2,11 @@
 
 #include "envoy/stats/scope.h"
 
-#include "common/common/macros.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/filters/http/common/compressor/utility.h"
 
-#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
-#include "absl/strings/string_view.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -23,34 +23,59 @@ const uint64_t DefaultWindowBits = 12;
 // Minimum length of an upstream response that allows compression.
 const uint64_t MinimumContentLength = 30;
 
+// Default number of idle compressors pooled by each worker.
+const uint64_t DefaultCompressorPoolSize = 16;
+
 // When summed to window bits, this sets a gzip header and trailer around the compressed data.
 const uint64_t GzipHeaderValue = 16;
 
 // Used for verifying accept-encoding values.
 const char ZeroQvalueString[] = "q=0";
 
-// Default content types will be used if any is provided by the user.
-const std::vector<std::string>& defaultContentEncoding() {
-  CONSTRUCT_ON_FIRST_USE(std::vector<std::string>,
-                         {"text/html", "text/plain", "text/css", "application/javascript",
-                          "application/json", "image/svg+xml", "text/xml",
-                          "application/xhtml+xml"});
-}
-
 } // namespace
 
 GzipFilterConfig::GzipFilterConfig(const envoy::config::filter::http::gzip::v2::Gzip& gzip,
                                    const std::string& stats_prefix, Stats::Scope& scope,
-                                   Runtime::Loader& runtime)
+                                   Runtime::Loader& runtime, ThreadLocal::SlotAllocator& tls)
     : compression_level_(compressionLevelEnum(gzip.compression_level())),
       compression_strategy_(compressionStrategyEnum(gzip.compression_strategy())),
       content_length_(contentLengthUint(gzip.content_length().value())),
       memory_level_(memoryLevelUint(gzip.memory_level().value())),
       window_bits_(windowBitsUint(gzip.window_bits().value())),
+      compressor_pool_size_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(gzip, compressor_pool_size, DefaultCompressorPoolSize)),
       content_type_values_(contentTypeSet(gzip.content_type())),
       disable_on_etag_header_(gzip.disable_on_etag_header()),
       remove_accept_encoding_header_(gzip.remove_accept_encoding_header()),
-      stats_(generateStats(stats_prefix + "gzip.", scope)), runtime_(runtime) {}
+      stats_(generateStats(stats_prefix + "gzip.", scope)), runtime_(runtime),
+      tls_(tls.allocateSlot()) {
+  tls_->set([](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<CompressorPool>();
+  });
+}
+
+ZlibCompressorImplPtr GzipFilterConfig::acquireCompressor() {
+  std::vector<ZlibCompressorImplPtr>& pool = tls_->getTyped<CompressorPool>().compressors_;
+  if (!pool.empty()) {
+    ZlibCompressorImplPtr compressor = std::move(pool.back());
+    pool.pop_back();
+    return compressor;
+  }
+
+  auto compressor = std::make_unique<Compressor::ZlibCompressorImpl>();
+  compressor->init(compression_level_, compression_strategy_, window_bits_, memory_level_);
+  return compressor;
+}
+
+void GzipFilterConfig::releaseCompressor(ZlibCompressorImplPtr&& compressor) {
+  std::vector<ZlibCompressorImplPtr>& pool = tls_->getTyped<CompressorPool>().compressors_;
+  if (pool.size() < compressor_pool_size_) {
+    // Resetting keeps the ~2^(window_bits + 2) + 2^(memory_level + 9) bytes of zlib state, which
+    // deflateInit2() would allocate again for the next response.
+    compressor->reset();
+    pool.push_back(std::move(compressor));
+  }
+}
 
 Compressor::ZlibCompressorImpl::CompressionLevel GzipFilterConfig::compressionLevelEnum(
     envoy::config::filter::http::gzip::v2::Gzip_CompressionLevel_Enum compression_level) {
@@ -85,8 +110,7 @@ Compressor::ZlibCompressorImpl::CompressionStrategy GzipFilterConfig::compressio
 
 StringUtil::CaseUnorderedSet
 GzipFilterConfig::contentTypeSet(const Protobuf::RepeatedPtrField<std::string>& types) {
-  return types.empty() ? StringUtil::CaseUnorderedSet(defaultContentEncoding().begin(),
-                                                      defaultContentEncoding().end())
+  return types.empty() ? Common::Compression::Utility::defaultContentTypes()
                        : StringUtil::CaseUnorderedSet(types.cbegin(), types.cend());
 }
 
@@ -103,7 +127,13 @@ uint64_t GzipFilterConfig::windowBitsUint(Protobuf::uint32 window_bits) {
 }
 
 GzipFilter::GzipFilter(const GzipFilterConfigSharedPtr& config)
-    : skip_compression_{true}, compressed_data_(), compressor_(), config_(config) {}
+    : skip_compression_{true}, compressed_data_(), config_(config) {}
+
+void GzipFilter::onDestroy() {
+  if (compressor_ != nullptr) {
+    config_->releaseCompressor(std::move(compressor_));
+  }
+}
 
 Http::FilterHeadersStatus GzipFilter::decodeHeaders(Http::HeaderMap& headers, bool) {
   if (config_->runtime().snapshot().featureEnabled("gzip.filter_enabled", 100) &&
@@ -127,8 +157,7 @@ Http::FilterHeadersStatus GzipFilter::encodeHeaders(Http::HeaderMap& headers, bo
     insertVaryHeader(headers);
     headers.removeContentLength();
     headers.insertContentEncoding().value(Http::Headers::get().ContentEncodingValues.Gzip);
-    compressor_.init(config_->compressionLevel(), config_->compressionStrategy(),
-                     config_->windowBits(), config_->memoryLevel());
+    compressor_ = config_->acquireCompressor();
     config_->stats().compressed_.inc();
   } else if (!skip_compression_) {
     skip_compression_ = true;
@@ -140,7 +169,7 @@ Http::FilterHeadersStatus GzipFilter::encodeHeaders(Http::HeaderMap& headers, bo
 Http::FilterDataStatus GzipFilter::encodeData(Buffer::Instance& data, bool end_stream) {
   if (!skip_compression_) {
     config_->stats().total_uncompressed_bytes_.add(data.length());
-    compressor_.compress(data, end_stream ? Compressor::State::Finish : Compressor::State::Flush);
+    compressor_->compress(data, end_stream ? Compressor::State::Finish : Compressor::State::Flush);
     config_->stats().total_compressed_bytes_.add(data.length());
   }
   return Http::FilterDataStatus::Continue;
@@ -149,7 +178,7 @@ Http::FilterDataStatus GzipFilter::encodeData(Buffer::Instance& data, bool end_s
 Http::FilterTrailersStatus GzipFilter::encodeTrailers(Http::HeaderMap&) {
   if (!skip_compression_) {
     Buffer::OwnedImpl empty_buffer;
-    compressor_.compress(empty_buffer, Compressor::State::Finish);
+    compressor_->compress(empty_buffer, Compressor::State::Finish);
     config_->stats().total_compressed_bytes_.add(empty_buffer.length());
     encoder_callbacks_->addEncodedData(empty_buffer, true);
   }
@@ -157,13 +186,7 @@ Http::FilterTrailersStatus GzipFilter::encodeTrailers(Http::HeaderMap&) {
 }
 
 bool GzipFilter::hasCacheControlNoTransform(Http::HeaderMap& headers) const {
-  const Http::HeaderEntry* cache_control = headers.CacheControl();
-  if (cache_control) {
-    return StringUtil::caseFindToken(cache_control->value().getStringView(), ",",
-                                     Http::Headers::get().CacheControlValues.NoTransform);
-  }
-
-  return false;
+  return Common::Compression::Utility::hasCacheControlNoTransform(headers);
 }
 
 // TODO(gsagula): Since gzip is the only available content-encoding in Envoy at the moment,
@@ -219,14 +242,8 @@ bool GzipFilter::isAcceptEncodingAllowed(Http::HeaderMap& headers) const {
 }
 
 bool GzipFilter::isContentTypeAllowed(Http::HeaderMap& headers) const {
-  const Http::HeaderEntry* content_type = headers.ContentType();
-  if (content_type && !config_->contentTypeValues().empty()) {
-    const absl::string_view value =
-        StringUtil::trim(StringUtil::cropRight(content_type->value().getStringView(), ";"));
-    return config_->contentTypeValues().find(value) != config_->contentTypeValues().end();
-  }
-
-  return true;
+  return Common::Compression::Utility::isContentTypeAllowed(headers,
+                                                            config_->contentTypeValues());
 }
 
 bool GzipFilter::isEtagAllowed(Http::HeaderMap& headers) const {
@@ -257,53 +274,15 @@ bool GzipFilter::isMinimumContentLength(Http::HeaderMap& headers) const {
 }
 
 bool GzipFilter::isTransferEncodingAllowed(Http::HeaderMap& headers) const {
-  const Http::HeaderEntry* transfer_encoding = headers.TransferEncoding();
-  if (transfer_encoding) {
-    for (auto header_value :
-         // TODO(gsagula): add Http::HeaderMap::string_view() so string length doesn't need to be
-         // computed twice. Find all other sites where this can be improved.
-         StringUtil::splitToken(transfer_encoding->value().getStringView(), ",", true)) {
-      const auto trimmed_value = StringUtil::trim(header_value);
-      if (StringUtil::caseCompare(trimmed_value,
-                                  Http::Headers::get().TransferEncodingValues.Gzip) ||
-          StringUtil::caseCompare(trimmed_value,
-                                  Http::Headers::get().TransferEncodingValues.Deflate)) {
-        return false;
-      }
-    }
-  }
-
-  return true;
+  return Common::Compression::Utility::isTransferEncodingAllowed(headers);
 }
 
 void GzipFilter::insertVaryHeader(Http::HeaderMap& headers) {
-  const Http::HeaderEntry* vary = headers.Vary();
-  if (vary) {
-    if (!StringUtil::findToken(vary->value().getStringView(), ",",
-                               Http::Headers::get().VaryValues.AcceptEncoding, true)) {
-      std::string new_header;
-      absl::StrAppend(&new_header, vary->value().getStringView(), ", ",
-                      Http::Headers::get().VaryValues.AcceptEncoding);
-      headers.insertVary().value(new_header);
-    }
-  } else {
-    headers.insertVary().value(Http::Headers::get().VaryValues.AcceptEncoding);
-  }
+  Common::Compression::Utility::insertVaryHeader(headers);
 }
 
-// TODO(gsagula): It seems that every proxy has a different opinion how to handle Etag. Some
-// discussions around this topic have been going on for over a decade, e.g.,
-// https://bz.apache.org/bugzilla/show_bug.cgi?id=45023
-// This design attempts to stay more on the safe side by preserving weak etags and removing
-// the strong ones when disable_on_etag_header is false. Envoy does NOT re-write entity tags.
 void GzipFilter::sanitizeEtagHeader(Http::HeaderMap& headers) {
-  const Http::HeaderEntry* etag = headers.Etag();
-  if (etag) {
-    absl::string_view value(etag->value().getStringView());
-    if (value.length() > 2 && !((value[0] == 'w' || value[0] == 'W') && value[1] == '/')) {
-      headers.removeEtag();
-    }
-  }
+  Common::Compression::Utility::sanitizeEtagHeader(headers);
 }
 
 } // namespace Gzip
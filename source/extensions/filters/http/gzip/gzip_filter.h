@@ -7,6 +7,7 @@
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/buffer/buffer_impl.h"
 #include "common/compressor/zlib_compressor_impl.h"
@@ -52,6 +53,8 @@ struct GzipStats {
   ALL_GZIP_STATS(GENERATE_COUNTER_STRUCT)
 };
 
+typedef std::unique_ptr<Compressor::ZlibCompressorImpl> ZlibCompressorImplPtr;
+
 /**
  * Configuration for the gzip filter.
  */
@@ -59,8 +62,20 @@ class GzipFilterConfig {
 
 public:
   GzipFilterConfig(const envoy::config::filter::http::gzip::v2::Gzip& gzip,
-                   const std::string& stats_prefix,
-                   Stats::Scope& scope, Runtime::Loader& runtime);
+                   const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+                   ThreadLocal::SlotAllocator& tls);
+
+  /**
+   * @return ZlibCompressorImplPtr a compressor ready to compress a new stream, taken from the pool
+   *         of the worker when it is not empty.
+   */
+  ZlibCompressorImplPtr acquireCompressor();
+
+  /**
+   * Returns a compressor acquired on the same worker to its pool, unless the pool is full.
+   * @param compressor supplies the compressor, which may not have finished its stream.
+   */
+  void releaseCompressor(ZlibCompressorImplPtr&& compressor);
 
   Compressor::ZlibCompressorImpl::CompressionLevel compressionLevel() const {
     return compression_level_;
@@ -77,8 +92,14 @@ public:
   uint64_t memoryLevel() const { return memory_level_; }
   uint64_t minimumLength() const { return content_length_; }
   uint64_t windowBits() const { return window_bits_; }
+  uint64_t compressorPoolSize() const { return compressor_pool_size_; }
 
 private:
+  // The idle compressors of a worker.
+  struct CompressorPool : public ThreadLocal::ThreadLocalObject {
+    std::vector<ZlibCompressorImplPtr> compressors_;
+  };
+
   static Compressor::ZlibCompressorImpl::CompressionLevel compressionLevelEnum(
       envoy::config::filter::http::gzip::v2::Gzip_CompressionLevel_Enum compression_level);
   static Compressor::ZlibCompressorImpl::CompressionStrategy compressionStrategyEnum(
@@ -100,12 +121,14 @@ private:
   int32_t content_length_;
   int32_t memory_level_;
   int32_t window_bits_;
+  const uint64_t compressor_pool_size_;
 
   StringUtil::CaseUnorderedSet content_type_values_;
   bool disable_on_etag_header_;
   bool remove_accept_encoding_header_;
   GzipStats stats_;
   Runtime::Loader& runtime_;
+  ThreadLocal::SlotPtr tls_;
 };
 typedef std::shared_ptr<GzipFilterConfig> GzipFilterConfigSharedPtr;
 
@@ -117,7 +140,7 @@ public:
   GzipFilter(const GzipFilterConfigSharedPtr& config);
 
   // Http::StreamFilterBase
-  void onDestroy() override{};
+  void onDestroy() override;
 
   // Http::StreamDecoderFilter
   Http::FilterHeadersStatus decodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
@@ -162,7 +185,8 @@ private:
 
   bool skip_compression_;
   Buffer::OwnedImpl compressed_data_;
-  Compressor::ZlibCompressorImpl compressor_;
+  // Only set while a response is being compressed.
+  ZlibCompressorImplPtr compressor_;
   GzipFilterConfigSharedPtr config_;
 
   Http::StreamDecoderFilterCallbacks* decoder_callbacks_{nullptr};
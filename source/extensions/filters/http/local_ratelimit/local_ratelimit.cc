@@ -0,0 +1,90 @@
+#include "extensions/filters/http/local_ratelimit/local_ratelimit.h"
+
+#include <string>
+#include <vector>
+
+#include "envoy/http/codes.h"
+#include "envoy/router/router.h"
+
+#include "common/common/fmt.h"
+#include "common/http/headers.h"
+#include "common/singleton/const_singleton.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace LocalRateLimitFilter {
+
+struct RcDetailsValues {
+  // This request went above the configured limits for the local rate limit filter.
+  const std::string RateLimited = "local_rate_limited";
+};
+typedef ConstSingleton<RcDetailsValues> RcDetails;
+
+FilterConfig::FilterConfig(
+    const envoy::config::filter::http::local_rate_limit::v2alpha::LocalRateLimit& config,
+    const LocalInfo::LocalInfo& local_info, const std::string& stats_prefix, Stats::Scope& scope,
+    TimeSource& time_source)
+    : rate_limiter_(config.token_bucket(), time_source), local_info_(local_info),
+      stage_(config.stage()),
+      stats_(generateStats(fmt::format("{}http_local_rate_limit.{}.", stats_prefix,
+                                       config.stat_prefix()),
+                           scope)) {
+  for (const auto& descriptor : config.descriptors()) {
+    RateLimit::Descriptor new_descriptor;
+    for (const auto& entry : descriptor.entries()) {
+      new_descriptor.entries_.push_back({entry.key(), entry.value()});
+    }
+    rate_limiter_.addDescriptor(new_descriptor, descriptor.token_bucket());
+  }
+}
+
+LocalRateLimitStats FilterConfig::generateStats(const std::string& name, Stats::Scope& scope) {
+  return {ALL_LOCAL_RATE_LIMIT_STATS(POOL_COUNTER_PREFIX(scope, name))};
+}
+
+Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool) {
+  std::vector<RateLimit::Descriptor> descriptors;
+  if (!config_->rateLimiter().descriptorsEmpty()) {
+    Router::RouteConstSharedPtr route = callbacks_->route();
+    if (route && route->routeEntry()) {
+      const Router::RouteEntry* route_entry = route->routeEntry();
+      populateDescriptors(route_entry->rateLimitPolicy(), descriptors, route_entry, headers);
+      if (route_entry->includeVirtualHostRateLimits()) {
+        populateDescriptors(route_entry->virtualHost().rateLimitPolicy(), descriptors,
+                            route_entry, headers);
+      }
+    }
+  }
+
+  if (config_->rateLimiter().requestAllowed(descriptors)) {
+    config_->stats().ok_.inc();
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  config_->stats().rate_limited_.inc();
+  callbacks_->sendLocalReply(
+      Http::Code::TooManyRequests, "local_rate_limited",
+      [](Http::HeaderMap& headers) -> void {
+        headers.insertEnvoyRateLimited().value(Http::Headers::get().EnvoyRateLimitedValues.True);
+      },
+      absl::nullopt, RcDetails::get().RateLimited);
+  callbacks_->streamInfo().setResponseFlag(StreamInfo::ResponseFlag::RateLimited);
+  return Http::FilterHeadersStatus::StopIteration;
+}
+
+void Filter::populateDescriptors(const Router::RateLimitPolicy& rate_limit_policy,
+                                 std::vector<RateLimit::Descriptor>& descriptors,
+                                 const Router::RouteEntry* route_entry,
+                                 const Http::HeaderMap& headers) const {
+  for (const Router::RateLimitPolicyEntry& rate_limit :
+       rate_limit_policy.getApplicableRateLimit(config_->stage())) {
+    rate_limit.populateDescriptors(*route_entry, descriptors, config_->localInfo().clusterName(),
+                                   headers, *callbacks_->streamInfo().downstreamRemoteAddress());
+  }
+}
+
+} // namespace LocalRateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
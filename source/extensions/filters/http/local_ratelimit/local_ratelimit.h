@@ -0,0 +1,101 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/config/filter/http/local_rate_limit/v2alpha/local_rate_limit.pb.h"
+#include "envoy/http/filter.h"
+#include "envoy/local_info/local_info.h"
+#include "envoy/ratelimit/ratelimit.h"
+#include "envoy/router/router_ratelimit.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace LocalRateLimitFilter {
+
+/**
+ * All local rate limit stats. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_LOCAL_RATE_LIMIT_STATS(COUNTER)                                                        \
+  COUNTER(ok)                                                                                      \
+  COUNTER(rate_limited)
+// clang-format on
+
+/**
+ * Struct definition for all local rate limit stats. @see stats_macros.h
+ */
+struct LocalRateLimitStats {
+  ALL_LOCAL_RATE_LIMIT_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Global configuration for the HTTP local rate limit filter.
+ */
+class FilterConfig {
+public:
+  FilterConfig(const envoy::config::filter::http::local_rate_limit::v2alpha::LocalRateLimit& config,
+               const LocalInfo::LocalInfo& local_info, const std::string& stats_prefix,
+               Stats::Scope& scope, TimeSource& time_source);
+
+  Filters::Common::LocalRateLimit::LocalRateLimiterImpl& rateLimiter() { return rate_limiter_; }
+  const LocalInfo::LocalInfo& localInfo() const { return local_info_; }
+  uint64_t stage() const { return stage_; }
+  LocalRateLimitStats& stats() { return stats_; }
+
+private:
+  static LocalRateLimitStats generateStats(const std::string& name, Stats::Scope& scope);
+
+  Filters::Common::LocalRateLimit::LocalRateLimiterImpl rate_limiter_;
+  const LocalInfo::LocalInfo& local_info_;
+  const uint64_t stage_;
+  LocalRateLimitStats stats_;
+};
+
+typedef std::shared_ptr<FilterConfig> FilterConfigSharedPtr;
+
+/**
+ * HTTP local rate limit filter. Requests take a token from the buckets of the filter config, and
+ * are answered with a 429 when the bucket is empty, without any round trip to a rate limit
+ * service.
+ */
+class Filter : public Http::StreamDecoderFilter {
+public:
+  Filter(FilterConfigSharedPtr config) : config_(config) {}
+
+  // Http::StreamFilterBase
+  void onDestroy() override {}
+
+  // Http::StreamDecoderFilter
+  Http::FilterHeadersStatus decodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+  Http::FilterDataStatus decodeData(Buffer::Instance&, bool) override {
+    return Http::FilterDataStatus::Continue;
+  }
+  Http::FilterTrailersStatus decodeTrailers(Http::HeaderMap&) override {
+    return Http::FilterTrailersStatus::Continue;
+  }
+  void setDecoderFilterCallbacks(Http::StreamDecoderFilterCallbacks& callbacks) override {
+    callbacks_ = &callbacks;
+  }
+
+private:
+  void populateDescriptors(const Router::RateLimitPolicy& rate_limit_policy,
+                           std::vector<RateLimit::Descriptor>& descriptors,
+                           const Router::RouteEntry* route_entry,
+                           const Http::HeaderMap& headers) const;
+
+  FilterConfigSharedPtr config_;
+  Http::StreamDecoderFilterCallbacks* callbacks_{};
+};
+
+} // namespace LocalRateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -40,6 +40,8 @@ public:
   const std::string Router = "envoy.router";
   // Health checking filter
   const std::string HealthCheck = "envoy.health_check";
+  // Local rate limit filter
+  const std::string LocalRateLimit = "envoy.filters.http.local_ratelimit";
   // Lua filter
   const std::string Lua = "envoy.lua";
   // Squash filter
@@ -54,6 +56,14 @@ public:
   const std::string HeaderToMetadata = "envoy.filters.http.header_to_metadata";
   // Tap filter
   const std::string Tap = "envoy.filters.http.tap";
+  // HTTP cache filter
+  const std::string Cache = "envoy.filters.http.cache";
+  // Adaptive concurrency limit filter
+  const std::string AdaptiveConcurrency = "envoy.filters.http.adaptive_concurrency";
+  // Compressor filter
+  const std::string Compressor = "envoy.filters.http.compressor";
+  // Decompressor filter
+  const std::string Decompressor = "envoy.filters.http.decompressor";
 
   // Converts names from v1 to v2
   const Config::V1Converter v1_converter_;
@@ -0,0 +1,36 @@
+#include "extensions/filters/network/local_ratelimit/local_ratelimit.h"
+
+#include "common/common/fmt.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace LocalRateLimitFilter {
+
+Config::Config(
+    const envoy::config::filter::network::local_rate_limit::v2alpha::LocalRateLimit& config,
+    Stats::Scope& scope, TimeSource& time_source)
+    : rate_limiter_(config.token_bucket(), time_source),
+      stats_(generateStats(config.stat_prefix(), scope)) {}
+
+LocalRateLimitStats Config::generateStats(const std::string& name, Stats::Scope& scope) {
+  const std::string final_prefix = fmt::format("local_rate_limit.{}.", name);
+  return {ALL_LOCAL_RATE_LIMIT_STATS(POOL_COUNTER_PREFIX(scope, final_prefix))};
+}
+
+bool Config::canCreateConnection() { return rate_limiter_.requestAllowed({}); }
+
+Network::FilterStatus Filter::onNewConnection() {
+  if (!config_->canCreateConnection()) {
+    config_->stats().rate_limited_.inc();
+    read_callbacks_->connection().close(Network::ConnectionCloseType::NoFlush);
+    return Network::FilterStatus::StopIteration;
+  }
+
+  return Network::FilterStatus::Continue;
+}
+
+} // namespace LocalRateLimitFilter
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -26,6 +26,8 @@ public:
   const std::string MySQLProxy = "envoy.filters.network.mysql_proxy";
   // Rate limit filter
   const std::string RateLimit = "envoy.ratelimit";
+  // Local rate limit filter
+  const std::string LocalRateLimit = "envoy.filters.network.local_ratelimit";
   // Redis proxy filter
   const std::string RedisProxy = "envoy.redis_proxy";
   // IP tagging filter
@@ -1,6 +1,7 @@
 #include "extensions/transport_sockets/tap/tap.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/network/transport_socket_options_impl.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -64,8 +65,16 @@ TapSocketFactory::TapSocketFactory(
 
 Network::TransportSocketPtr
 TapSocketFactory::createTransportSocket(Network::TransportSocketOptionsSharedPtr options) const {
-  return std::make_unique<TapSocket>(currentConfigHelper<SocketTapConfig>(),
-                                     transport_socket_factory_->createTransportSocket(options));
+  // The tap records the bytes which the wrapped socket reports as written by the doWrite() call
+  // they are passed to, so the wrapped socket must not write them later from the write batch.
+  const absl::optional<std::string> no_server_name;
+  const absl::optional<std::string>& server_name =
+      options != nullptr ? options->serverNameOverride() : no_server_name;
+  auto inner_options = std::make_shared<Network::TransportSocketOptionsImpl>(
+      server_name.has_value() ? server_name.value() : "", false);
+  return std::make_unique<TapSocket>(
+      currentConfigHelper<SocketTapConfig>(),
+      transport_socket_factory_->createTransportSocket(inner_options));
 }
 
 bool TapSocketFactory::implementsSecureTransport() const {
@@ -27,6 +27,8 @@ public:
   Network::IoResult doWrite(Buffer::Instance& buffer, bool end_stream) override;
   void onConnected() override;
   const Ssl::ConnectionInfo* ssl() const override;
+  // Data bypassing the socket would not be tapped.
+  bool passthrough() const override { return false; }
 
 private:
   SocketTapConfigSharedPtr config_;
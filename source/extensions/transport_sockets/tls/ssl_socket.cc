@@ -39,6 +39,7 @@ public:
   }
   void onConnected() override {}
   const Ssl::ConnectionInfo* ssl() const override { return nullptr; }
+  bool passthrough() const override { return false; }
 };
 } // namespace
 
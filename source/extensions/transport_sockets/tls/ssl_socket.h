@@ -72,6 +72,7 @@ public:
   Network::IoResult doWrite(Buffer::Instance& write_buffer, bool end_stream) override;
   void onConnected() override;
   const Ssl::ConnectionInfo* ssl() const override { return this; }
+  bool passthrough() const override { return false; }
 
   SSL* rawSslForTest() const { return ssl_.get(); }
 
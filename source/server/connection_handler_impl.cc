@@ -14,20 +14,38 @@
 namespace Envoy {
 namespace Server {
 
-ConnectionHandlerImpl::ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher)
-    : logger_(logger), dispatcher_(dispatcher), disable_listeners_(false) {}
+ConnectionHandlerImpl::ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher,
+                                             const std::string& per_handler_stat_prefix)
+    : logger_(logger), dispatcher_(dispatcher), per_handler_stat_prefix_(per_handler_stat_prefix),
+      disable_listeners_(false) {}
+
+void ConnectionHandlerImpl::decNumConnections() {
+  ASSERT(num_connections_ > 0);
+  --num_connections_;
+}
 
 void ConnectionHandlerImpl::addListener(Network::ListenerConfig& config) {
-  ActiveListenerPtr l(new ActiveListener(*this, config));
+  ActiveListenerDetails details;
+  if (config.socket().socketType() == Network::Address::SocketType::Stream) {
+    auto tcp_listener = std::make_unique<ActiveTcpListener>(*this, config);
+    details.tcp_listener_ = tcp_listener.get();
+    details.listener_ = std::move(tcp_listener);
+  } else {
+    // The listener manager only accepts datagram listeners which have an active udp listener
+    // factory configured.
+    ASSERT(config.udpListenerFactory() != nullptr);
+    details.listener_ =
+        config.udpListenerFactory()->createActiveUdpListener(*this, dispatcher_, logger_, config);
+  }
   if (disable_listeners_) {
-    l->listener_->disable();
+    details.listener_->listener()->disable();
   }
-  listeners_.emplace_back(config.socket().localAddress(), std::move(l));
+  listeners_.emplace_back(config.socket().localAddress(), std::move(details));
 }
 
 void ConnectionHandlerImpl::removeListeners(uint64_t listener_tag) {
   for (auto listener = listeners_.begin(); listener != listeners_.end();) {
-    if (listener->second->listener_tag_ == listener_tag) {
+    if (listener->second.listener_->listenerTag() == listener_tag) {
       listener = listeners_.erase(listener);
     } else {
       ++listener;
@@ -37,33 +55,38 @@ void ConnectionHandlerImpl::removeListeners(uint64_t listener_tag) {
 
 void ConnectionHandlerImpl::stopListeners(uint64_t listener_tag) {
   for (auto& listener : listeners_) {
-    if (listener.second->listener_tag_ == listener_tag) {
-      listener.second->listener_.reset();
+    if (listener.second.listener_->listenerTag() == listener_tag) {
+      listener.second.listener_->destroy();
     }
   }
 }
 
 void ConnectionHandlerImpl::stopListeners() {
   for (auto& listener : listeners_) {
-    listener.second->listener_.reset();
+    listener.second.listener_->destroy();
   }
 }
 
 void ConnectionHandlerImpl::disableListeners() {
   disable_listeners_ = true;
   for (auto& listener : listeners_) {
-    listener.second->listener_->disable();
+    listener.second.listener_->listener()->disable();
   }
 }
 
 void ConnectionHandlerImpl::enableListeners() {
   disable_listeners_ = false;
   for (auto& listener : listeners_) {
-    listener.second->listener_->enable();
+    listener.second.listener_->listener()->enable();
   }
 }
 
-void ConnectionHandlerImpl::ActiveListener::removeConnection(ActiveConnection& connection) {
+void ConnectionHandlerImpl::ActiveTcpListener::decNumConnections() {
+  ASSERT(num_listener_connections_ > 0);
+  --num_listener_connections_;
+}
+
+void ConnectionHandlerImpl::ActiveTcpListener::removeConnection(ActiveConnection& connection) {
   ENVOY_CONN_LOG_TO_LOGGER(parent_.logger_, debug, "adding to cleanup list",
                            *connection.connection_);
   ActiveConnectionPtr removed = connection.removeFromList(connections_);
@@ -72,23 +95,39 @@ void ConnectionHandlerImpl::ActiveListener::removeConnection(ActiveConnection& c
   parent_.num_connections_--;
 }
 
-ConnectionHandlerImpl::ActiveListener::ActiveListener(ConnectionHandlerImpl& parent,
-                                                      Network::ListenerConfig& config)
-    : ActiveListener(
+ConnectionHandlerImpl::ActiveTcpListener::ActiveTcpListener(ConnectionHandlerImpl& parent,
+                                                            Network::ListenerConfig& config)
+    : ActiveTcpListener(
           parent,
           parent.dispatcher_.createListener(config.socket(), *this, config.bindToPort(),
                                             config.handOffRestoredDestinationConnections()),
           config) {}
 
-ConnectionHandlerImpl::ActiveListener::ActiveListener(ConnectionHandlerImpl& parent,
-                                                      Network::ListenerPtr&& listener,
-                                                      Network::ListenerConfig& config)
+ConnectionHandlerImpl::ActiveTcpListener::ActiveTcpListener(ConnectionHandlerImpl& parent,
+                                                            Network::ListenerPtr&& listener,
+                                                            Network::ListenerConfig& config)
     : parent_(parent), listener_(std::move(listener)),
       stats_(generateStats(config.listenerScope())),
+      per_handler_stats_(
+          generatePerHandlerStats(config.listenerScope(), parent.per_handler_stat_prefix_)),
       listener_filters_timeout_(config.listenerFiltersTimeout()),
-      listener_tag_(config.listenerTag()), config_(config) {}
+      listener_tag_(config.listenerTag()), config_(config) {
+  config.connectionBalancer().registerHandler(*this);
+}
+
+void ConnectionHandlerImpl::ActiveTcpListener::destroy() {
+  // A stopped listener must not be picked by the connection balancer of the other workers anymore.
+  if (listener_ != nullptr) {
+    config_.connectionBalancer().unregisterHandler(*this);
+    listener_.reset();
+  }
+}
+
+ConnectionHandlerImpl::ActiveTcpListener::~ActiveTcpListener() {
+  if (listener_ != nullptr) {
+    config_.connectionBalancer().unregisterHandler(*this);
+  }
 
-ConnectionHandlerImpl::ActiveListener::~ActiveListener() {
   // Purge sockets that have not progressed to connections. This should only happen when
   // a listener filter stops iteration and never resumes.
   while (!sockets_.empty()) {
@@ -105,25 +144,26 @@ ConnectionHandlerImpl::ActiveListener::~ActiveListener() {
 
 Network::Listener*
 ConnectionHandlerImpl::findListenerByAddress(const Network::Address::Instance& address) {
-  ActiveListener* listener = findActiveListenerByAddress(address);
+  ActiveTcpListener* listener = findActiveTcpListenerByAddress(address);
   return listener ? listener->listener_.get() : nullptr;
 }
 
-ConnectionHandlerImpl::ActiveListener*
-ConnectionHandlerImpl::findActiveListenerByAddress(const Network::Address::Instance& address) {
+ConnectionHandlerImpl::ActiveTcpListener*
+ConnectionHandlerImpl::findActiveTcpListenerByAddress(const Network::Address::Instance& address) {
   // This is a linear operation, may need to add a map<address, listener> to improve performance.
   // However, linear performance might be adequate since the number of listeners is small.
-  // We do not return stopped listeners.
+  // We do not return stopped listeners, nor udp listeners.
   auto listener_it = std::find_if(
       listeners_.begin(), listeners_.end(),
-      [&address](const std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerPtr>& p) {
-        return p.second->listener_ != nullptr && p.first->type() == Network::Address::Type::Ip &&
-               *(p.first) == address;
+      [&address](
+          const std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerDetails>& p) {
+        return p.second.tcp_listener_ != nullptr && p.second.listener_->listener() != nullptr &&
+               p.first->type() == Network::Address::Type::Ip && *(p.first) == address;
       });
 
   // If there is exact address match, return the corresponding listener.
   if (listener_it != listeners_.end()) {
-    return listener_it->second.get();
+    return listener_it->second.tcp_listener_;
   }
 
   // Otherwise, we need to look for the wild card match, i.e., 0.0.0.0:[address_port].
@@ -131,11 +171,13 @@ ConnectionHandlerImpl::findActiveListenerByAddress(const Network::Address::Insta
   // TODO(wattli): consolidate with previous search for more efficiency.
   listener_it = std::find_if(
       listeners_.begin(), listeners_.end(),
-      [&address](const std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerPtr>& p) {
-        return p.second->listener_ != nullptr && p.first->type() == Network::Address::Type::Ip &&
+      [&address](
+          const std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerDetails>& p) {
+        return p.second.tcp_listener_ != nullptr && p.second.listener_->listener() != nullptr &&
+               p.first->type() == Network::Address::Type::Ip &&
                p.first->ip()->port() == address.ip()->port() && p.first->ip()->isAnyAddress();
       });
-  return (listener_it != listeners_.end()) ? listener_it->second.get() : nullptr;
+  return (listener_it != listeners_.end()) ? listener_it->second.tcp_listener_ : nullptr;
 }
 
 void ConnectionHandlerImpl::ActiveSocket::onTimeout() {
@@ -178,11 +220,11 @@ void ConnectionHandlerImpl::ActiveSocket::continueFilterChain(bool success) {
     // Successfully ran all the accept filters.
 
     // Check if the socket may need to be redirected to another listener.
-    ActiveListener* new_listener = nullptr;
+    ActiveTcpListener* new_listener = nullptr;
 
     if (hand_off_restored_destination_connections_ && socket_->localAddressRestored()) {
       // Find a listener associated with the original destination address.
-      new_listener = listener_.parent_.findActiveListenerByAddress(*socket_->localAddress());
+      new_listener = listener_.parent_.findActiveTcpListenerByAddress(*socket_->localAddress());
     }
     if (new_listener != nullptr) {
       // Hands off connections redirected by iptables to the listener associated with the
@@ -207,8 +249,35 @@ void ConnectionHandlerImpl::ActiveSocket::continueFilterChain(bool success) {
   }
 }
 
-void ConnectionHandlerImpl::ActiveListener::onAccept(
+ConnectionHandlerImpl::ActiveTcpListener*
+ConnectionHandlerImpl::findActiveTcpListenerByTag(uint64_t listener_tag) {
+  for (auto& listener : listeners_) {
+    if (listener.second.tcp_listener_ != nullptr &&
+        listener.second.listener_->listenerTag() == listener_tag) {
+      return listener.second.tcp_listener_;
+    }
+  }
+  return nullptr;
+}
+
+void ConnectionHandlerImpl::ActiveTcpListener::onAccept(
     Network::ConnectionSocketPtr&& socket, bool hand_off_restored_destination_connections) {
+  onAcceptWorker(std::move(socket), hand_off_restored_destination_connections, false);
+}
+
+void ConnectionHandlerImpl::ActiveTcpListener::onAcceptWorker(
+    Network::ConnectionSocketPtr&& socket, bool hand_off_restored_destination_connections,
+    bool rebalanced) {
+  if (!rebalanced) {
+    // The balancer accounts for the socket in the connection count of the handler it picks.
+    Network::BalancedConnectionHandler& target_handler =
+        config_.connectionBalancer().pickTargetHandler(*this);
+    if (&target_handler != this) {
+      target_handler.post(std::move(socket));
+      return;
+    }
+  }
+
   auto active_socket = std::make_unique<ActiveSocket>(*this, std::move(socket),
                                                       hand_off_restored_destination_connections);
 
@@ -224,7 +293,28 @@ void ConnectionHandlerImpl::ActiveListener::onAccept(
   }
 }
 
-void ConnectionHandlerImpl::ActiveListener::newConnection(Network::ConnectionSocketPtr&& socket) {
+void ConnectionHandlerImpl::ActiveTcpListener::post(Network::ConnectionSocketPtr&& socket) {
+  // The posted callback must be copyable, so the socket is moved into a shared pointer. The
+  // listener is looked up again on the target thread, since it may be removed in the meantime, in
+  // which case the socket is closed as the callback is destroyed.
+  auto socket_to_rebalance = std::make_shared<Network::ConnectionSocketPtr>(std::move(socket));
+  parent_.dispatcher_.post(
+      [socket_to_rebalance, listener_tag = listener_tag_, &parent = parent_]() -> void {
+        ActiveTcpListener* listener = parent.findActiveTcpListenerByTag(listener_tag);
+        if (listener == nullptr) {
+          return;
+        }
+        if (listener->listener_ == nullptr) {
+          // The listener was stopped after the balancer picked it.
+          listener->decNumConnections();
+          return;
+        }
+        listener->onAcceptWorker(std::move(*socket_to_rebalance),
+                                 listener->config_.handOffRestoredDestinationConnections(), true);
+      });
+}
+
+void ConnectionHandlerImpl::ActiveTcpListener::newConnection(Network::ConnectionSocketPtr&& socket) {
   // Find matching filter chain.
   const auto filter_chain = config_.filterChainManager().findFilterChain(*socket);
   if (filter_chain == nullptr) {
@@ -252,7 +342,7 @@ void ConnectionHandlerImpl::ActiveListener::newConnection(Network::ConnectionSoc
   onNewConnection(std::move(new_connection));
 }
 
-void ConnectionHandlerImpl::ActiveListener::onNewConnection(
+void ConnectionHandlerImpl::ActiveTcpListener::onNewConnection(
     Network::ConnectionPtr&& new_connection) {
   ENVOY_CONN_LOG_TO_LOGGER(parent_.logger_, debug, "new connection", *new_connection);
 
@@ -265,7 +355,7 @@ void ConnectionHandlerImpl::ActiveListener::onNewConnection(
   }
 }
 
-ConnectionHandlerImpl::ActiveConnection::ActiveConnection(ActiveListener& listener,
+ConnectionHandlerImpl::ActiveConnection::ActiveConnection(ActiveTcpListener& listener,
                                                           Network::ConnectionPtr&& new_connection,
                                                           TimeSource& time_source)
     : listener_(listener), connection_(std::move(new_connection)),
@@ -276,11 +366,16 @@ ConnectionHandlerImpl::ActiveConnection::ActiveConnection(ActiveListener& listen
   connection_->addConnectionCallbacks(*this);
   listener_.stats_.downstream_cx_total_.inc();
   listener_.stats_.downstream_cx_active_.inc();
+  listener_.per_handler_stats_.downstream_cx_total_.inc();
+  listener_.per_handler_stats_.downstream_cx_active_.inc();
+  listener_.incNumConnections();
 }
 
 ConnectionHandlerImpl::ActiveConnection::~ActiveConnection() {
   listener_.stats_.downstream_cx_active_.dec();
   listener_.stats_.downstream_cx_destroy_.inc();
+  listener_.per_handler_stats_.downstream_cx_active_.dec();
+  listener_.decNumConnections();
   conn_length_->complete();
 }
 
@@ -288,5 +383,11 @@ ListenerStats ConnectionHandlerImpl::generateStats(Stats::Scope& scope) {
   return {ALL_LISTENER_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope), POOL_HISTOGRAM(scope))};
 }
 
+PerHandlerListenerStats ConnectionHandlerImpl::generatePerHandlerStats(Stats::Scope& scope,
+                                                                       const std::string& prefix) {
+  return {ALL_PER_HANDLER_LISTENER_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                         POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -4,10 +4,12 @@
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <string>
 
 #include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
 #include "envoy/network/connection.h"
+#include "envoy/network/connection_balancer.h"
 #include "envoy/network/connection_handler.h"
 #include "envoy/network/filter.h"
 #include "envoy/network/listen_socket.h"
@@ -42,16 +44,38 @@ struct ListenerStats {
   ALL_LISTENER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
+// clang-format off
+#define ALL_PER_HANDLER_LISTENER_STATS(COUNTER, GAUGE)                                             \
+  COUNTER(downstream_cx_total)                                                                     \
+  GAUGE  (downstream_cx_active)
+// clang-format on
+
+/**
+ * Wrapper struct for the stats of a listener on a single connection handler. @see stats_macros.h
+ */
+struct PerHandlerListenerStats {
+  ALL_PER_HANDLER_LISTENER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
 /**
  * Server side connection handler. This is used both by workers as well as the
  * main thread for non-threaded listeners.
  */
 class ConnectionHandlerImpl : public Network::ConnectionHandler, NonCopyable {
 public:
-  ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher);
+  /**
+   * @param logger supplies the logger of the handler.
+   * @param dispatcher supplies the dispatcher of the thread which the handler runs on.
+   * @param per_handler_stat_prefix supplies the prefix of the per handler stats of the listeners,
+   *        such as "worker_0.".
+   */
+  ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher,
+                        const std::string& per_handler_stat_prefix);
 
   // Network::ConnectionHandler
   uint64_t numConnections() override { return num_connections_; }
+  void incNumConnections() override { ++num_connections_; }
+  void decNumConnections() override;
   void addListener(Network::ListenerConfig& config) override;
   void removeListeners(uint64_t listener_tag) override;
   void stopListeners(uint64_t listener_tag) override;
@@ -62,8 +86,8 @@ public:
   Network::Listener* findListenerByAddress(const Network::Address::Instance& address) override;
 
 private:
-  struct ActiveListener;
-  ActiveListener* findActiveListenerByAddress(const Network::Address::Instance& address);
+  struct ActiveTcpListener;
+  ActiveTcpListener* findActiveTcpListenerByAddress(const Network::Address::Instance& address);
 
   struct ActiveConnection;
   typedef std::unique_ptr<ActiveConnection> ActiveConnectionPtr;
@@ -71,21 +95,46 @@ private:
   typedef std::unique_ptr<ActiveSocket> ActiveSocketPtr;
 
   /**
-   * Wrapper for an active listener owned by this handler.
+   * Wrapper for an active tcp listener owned by this handler.
    */
-  struct ActiveListener : public Network::ListenerCallbacks {
-    ActiveListener(ConnectionHandlerImpl& parent, Network::ListenerConfig& config);
+  struct ActiveTcpListener : public Network::ConnectionHandler::ActiveListener,
+                             public Network::ListenerCallbacks,
+                             public Network::BalancedConnectionHandler {
+    ActiveTcpListener(ConnectionHandlerImpl& parent, Network::ListenerConfig& config);
 
-    ActiveListener(ConnectionHandlerImpl& parent, Network::ListenerPtr&& listener,
-                   Network::ListenerConfig& config);
+    ActiveTcpListener(ConnectionHandlerImpl& parent, Network::ListenerPtr&& listener,
+                      Network::ListenerConfig& config);
 
-    ~ActiveListener();
+    ~ActiveTcpListener();
+
+    // Network::ConnectionHandler::ActiveListener
+    uint64_t listenerTag() override { return listener_tag_; }
+    Network::Listener* listener() override { return listener_.get(); }
+    void destroy() override;
 
     // Network::ListenerCallbacks
     void onAccept(Network::ConnectionSocketPtr&& socket,
                   bool hand_off_restored_destination_connections) override;
     void onNewConnection(Network::ConnectionPtr&& new_connection) override;
 
+    // Network::BalancedConnectionHandler
+    uint64_t numConnections() const override { return num_listener_connections_; }
+    void incNumConnections() override { ++num_listener_connections_; }
+    void post(Network::ConnectionSocketPtr&& socket) override;
+
+    void decNumConnections();
+
+    /**
+     * Accept a socket on the thread of this handler.
+     * @param socket supplies the accepted socket.
+     * @param hand_off_restored_destination_connections supplies whether the socket may be handed
+     *        off to the listener of its original destination.
+     * @param rebalanced supplies whether the socket was posted to this handler by the connection
+     *        balancer, in which case it is not balanced again.
+     */
+    void onAcceptWorker(Network::ConnectionSocketPtr&& socket,
+                        bool hand_off_restored_destination_connections, bool rebalanced);
+
     /**
      * Remove and destroy an active connection.
      * @param connection supplies the connection to remove.
@@ -100,6 +149,10 @@ private:
     ConnectionHandlerImpl& parent_;
     Network::ListenerPtr listener_;
     ListenerStats stats_;
+    PerHandlerListenerStats per_handler_stats_;
+    // The sockets and connections of the listener owned by this handler, which includes the
+    // sockets that the connection balancer is posting to it. Read by the balancer of other threads.
+    std::atomic<uint64_t> num_listener_connections_{};
     std::list<ActiveSocketPtr> sockets_;
     std::list<ActiveConnectionPtr> connections_;
     const std::chrono::milliseconds listener_filters_timeout_;
@@ -107,15 +160,13 @@ private:
     Network::ListenerConfig& config_;
   };
 
-  typedef std::unique_ptr<ActiveListener> ActiveListenerPtr;
-
   /**
    * Wrapper for an active connection owned by this handler.
    */
   struct ActiveConnection : LinkedObject<ActiveConnection>,
                             public Event::DeferredDeletable,
                             public Network::ConnectionCallbacks {
-    ActiveConnection(ActiveListener& listener, Network::ConnectionPtr&& new_connection,
+    ActiveConnection(ActiveTcpListener& listener, Network::ConnectionPtr&& new_connection,
                      TimeSource& time_system);
     ~ActiveConnection();
 
@@ -130,7 +181,7 @@ private:
     void onAboveWriteBufferHighWatermark() override {}
     void onBelowWriteBufferLowWatermark() override {}
 
-    ActiveListener& listener_;
+    ActiveTcpListener& listener_;
     Network::ConnectionPtr connection_;
     Stats::TimespanPtr conn_length_;
   };
@@ -142,7 +193,7 @@ private:
                         public Network::ListenerFilterCallbacks,
                         LinkedObject<ActiveSocket>,
                         public Event::DeferredDeletable {
-    ActiveSocket(ActiveListener& listener, Network::ConnectionSocketPtr&& socket,
+    ActiveSocket(ActiveTcpListener& listener, Network::ConnectionSocketPtr&& socket,
                  bool hand_off_restored_destination_connections)
         : listener_(listener), socket_(std::move(socket)),
           hand_off_restored_destination_connections_(hand_off_restored_destination_connections),
@@ -152,6 +203,9 @@ private:
     ~ActiveSocket() {
       accept_filters_.clear();
       listener_.stats_.downstream_pre_cx_active_.dec();
+      // The socket was accounted for by the connection balancer. A connection created from it
+      // accounts for itself.
+      listener_.decNumConnections();
     }
 
     void onTimeout();
@@ -168,7 +222,7 @@ private:
     Event::Dispatcher& dispatcher() override { return listener_.parent_.dispatcher_; }
     void continueFilterChain(bool success) override;
 
-    ActiveListener& listener_;
+    ActiveTcpListener& listener_;
     Network::ConnectionSocketPtr socket_;
     const bool hand_off_restored_destination_connections_;
     std::list<Network::ListenerFilterPtr> accept_filters_;
@@ -176,11 +230,26 @@ private:
     Event::TimerPtr timer_;
   };
 
+  /**
+   * An active listener owned by this handler, along with the active tcp listener it is if it
+   * listens on a stream socket.
+   */
+  struct ActiveListenerDetails {
+    Network::ConnectionHandler::ActiveListenerPtr listener_;
+    // nullptr for udp listeners, which connections are not handed off to.
+    ActiveTcpListener* tcp_listener_{};
+  };
+
+  ActiveTcpListener* findActiveTcpListenerByTag(uint64_t listener_tag);
+
   static ListenerStats generateStats(Stats::Scope& scope);
+  static PerHandlerListenerStats generatePerHandlerStats(Stats::Scope& scope,
+                                                         const std::string& prefix);
 
   spdlog::logger& logger_;
   Event::Dispatcher& dispatcher_;
-  std::list<std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerPtr>> listeners_;
+  const std::string per_handler_stat_prefix_;
+  std::list<std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerDetails>> listeners_;
   std::atomic<uint64_t> num_connections_{};
   bool disable_listeners_;
 };
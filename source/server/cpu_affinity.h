@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Pins threads to CPUs. The memory a pinned thread touches first is placed on the NUMA node of its
+ * CPUs by the default local allocation policy of the kernel, so threads are pinned before they
+ * allocate their state. Pinning is only supported on Linux.
+ */
+class CpuAffinity : protected Logger::Loggable<Logger::Id::main> {
+public:
+  /**
+   * Pin the calling thread, and the threads it creates afterwards, to CPUs.
+   * @param cpus supplies the CPUs.
+   * @return bool whether the thread was pinned.
+   */
+  static bool setThreadAffinity(const std::vector<uint32_t>& cpus);
+
+  /**
+   * @return std::vector<uint32_t> the sorted CPUs the calling thread may run on, or an empty vector
+   *         if they are not known.
+   */
+  static std::vector<uint32_t> threadAffinity();
+
+  /**
+   * @param cpus supplies the CPUs.
+   * @return std::vector<uint32_t> the sorted NUMA nodes of the CPUs, without the CPUs whose node is
+   *         not known.
+   */
+  static std::vector<uint32_t> numaNodes(const std::vector<uint32_t>& cpus);
+
+  /**
+   * @param cpus supplies the CPUs the workers are pinned to, one per worker.
+   * @param index supplies the index of a worker.
+   * @return std::vector<uint32_t> the CPUs the worker is pinned to. The CPUs are handed out again
+   *         from the first one when there are more workers than CPUs.
+   */
+  static std::vector<uint32_t> workerCpus(const std::vector<uint32_t>& cpus, uint32_t index) {
+    if (cpus.empty()) {
+      return {};
+    }
+    return {cpus[index % cpus.size()]};
+  }
+};
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,16 @@
+#include "server/cpu_affinity.h"
+
+namespace Envoy {
+namespace Server {
+
+bool CpuAffinity::setThreadAffinity(const std::vector<uint32_t>&) {
+  ENVOY_LOG(warn, "CPU affinity is not supported on this platform.");
+  return false;
+}
+
+std::vector<uint32_t> CpuAffinity::threadAffinity() { return {}; }
+
+std::vector<uint32_t> CpuAffinity::numaNodes(const std::vector<uint32_t>&) { return {}; }
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,88 @@
+#if !defined(__linux__)
+#error "Linux platform file is part of non-Linux build."
+#endif
+
+#include <sched.h>
+
+#include <set>
+
+#include "envoy/common/exception.h"
+
+#include "common/api/os_sys_calls_impl_linux.h"
+#include "common/common/fmt.h"
+#include "common/filesystem/directory.h"
+
+#include "server/cpu_affinity.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_join.h"
+
+namespace Envoy {
+namespace Server {
+
+bool CpuAffinity::setThreadAffinity(const std::vector<uint32_t>& cpus) {
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (const uint32_t cpu : cpus) {
+    if (cpu >= CPU_SETSIZE) {
+      ENVOY_LOG(warn, "unable to pin thread to CPU {}: the highest CPU is {}", cpu,
+                CPU_SETSIZE - 1);
+      return false;
+    }
+    CPU_SET(cpu, &mask);
+  }
+
+  // A pid of 0 is the calling thread.
+  const Api::SysCallIntResult result =
+      Api::LinuxOsSysCallsSingleton::get().sched_setaffinity(0, sizeof(cpu_set_t), &mask);
+  if (result.rc_ == -1) {
+    ENVOY_LOG(warn, "unable to pin thread to CPUs {}: {}", absl::StrJoin(cpus, ","),
+              strerror(result.errno_));
+    return false;
+  }
+  return true;
+}
+
+std::vector<uint32_t> CpuAffinity::threadAffinity() {
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  const Api::SysCallIntResult result =
+      Api::LinuxOsSysCallsSingleton::get().sched_getaffinity(0, sizeof(cpu_set_t), &mask);
+  if (result.rc_ == -1) {
+    return {};
+  }
+
+  std::vector<uint32_t> cpus;
+  for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &mask)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+std::vector<uint32_t> CpuAffinity::numaNodes(const std::vector<uint32_t>& cpus) {
+  std::set<uint32_t> nodes;
+  for (const uint32_t cpu : cpus) {
+    // The directory of a CPU links to the directory of its node, e.g.
+    // /sys/devices/system/cpu/cpu3/node1.
+    try {
+      for (const Filesystem::DirectoryEntry& entry :
+           Filesystem::Directory(fmt::format("/sys/devices/system/cpu/cpu{}", cpu))) {
+        uint32_t node;
+        if (absl::StartsWith(entry.name_, "node") &&
+            absl::SimpleAtoi(entry.name_.substr(4), &node)) {
+          nodes.insert(node);
+          break;
+        }
+      }
+    } catch (const EnvoyException& e) {
+      ENVOY_LOG(debug, "unable to find the NUMA node of CPU {}: {}", cpu, e.what());
+    }
+  }
+  return {nodes.begin(), nodes.end()};
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -50,6 +50,8 @@
 #include "common/stats/histogram_impl.h"
 #include "common/upstream/host_utility.h"
 
+#include "server/cpu_affinity.h"
+
 #include "extensions/access_loggers/file/file_access_log_impl.h"
 
 #include "absl/strings/str_join.h"
@@ -659,6 +661,31 @@ envoy::admin::v2alpha::ServerInfo::State AdminImpl::serverState() {
   return state;
 }
 
+void AdminImpl::addThreadPlacements(envoy::admin::v2alpha::ServerInfo& server_info) {
+  const auto add_placement = [&server_info](const std::string& thread,
+                                            const std::vector<uint32_t>& cpus) {
+    envoy::admin::v2alpha::ThreadPlacement* placement = server_info.add_thread_placements();
+    placement->set_thread(thread);
+    for (const uint32_t cpu : cpus) {
+      placement->add_cpus(cpu);
+    }
+    for (const uint32_t node : CpuAffinity::numaNodes(cpus)) {
+      placement->add_numa_nodes(node);
+    }
+  };
+
+  const Options& options = server_.options();
+  if (!options.mainThreadCpuAffinity().empty()) {
+    add_placement("main_thread", options.mainThreadCpuAffinity());
+  }
+  if (!options.workerCpuAffinity().empty()) {
+    for (uint32_t i = 0; i < options.concurrency(); i++) {
+      add_placement(fmt::format("worker_{}", i),
+                    CpuAffinity::workerCpus(options.workerCpuAffinity(), i));
+    }
+  }
+}
+
 Http::Code AdminImpl::handlerServerInfo(absl::string_view, Http::HeaderMap& headers,
                                         Buffer::Instance& response, AdminStream&) {
   time_t current_time = time(nullptr);
@@ -673,6 +700,7 @@ Http::Code AdminImpl::handlerServerInfo(absl::string_view, Http::HeaderMap& head
   envoy::admin::v2alpha::CommandLineOptions* command_line_options =
       server_info.mutable_command_line_options();
   *command_line_options = *server_.options().toCommandLineOptions();
+  addThreadPlacements(server_info);
   response.add(MessageUtil::getJsonStringFromMessage(server_info, true, true));
   headers.insertContentType().value().setReference(Http::Headers::get().ContentTypeValues.Json);
   return Http::Code::OK;
@@ -10,6 +10,7 @@
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
 #include "common/config/utility.h"
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/io_socket_handle_impl.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/network/resolver_impl.h"
@@ -190,6 +191,27 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
         Network::SocketOptionFactory::buildLiteralOptions(config.socket_options()));
   }
 
+  if (socket_type_ == Network::Address::SocketType::Datagram) {
+    if (!config.has_udp_listener_config()) {
+      throw EnvoyException(fmt::format("error adding listener '{}': udp listeners require a "
+                                       "udp_listener_config",
+                                       address_->asString()));
+    }
+    auto& factory = Config::Utility::getAndCheckFactory<ActiveUdpListenerConfigFactory>(
+        config.udp_listener_config().udp_listener_name());
+    ProtobufTypes::MessagePtr message =
+        Config::Utility::translateToFactoryConfig(config.udp_listener_config(), factory);
+    udp_listener_factory_ = factory.createActiveUdpListenerFactory(*message);
+  }
+
+  if (config.has_connection_balance_config()) {
+    // Currently exact balance is the only supported type and there are no options.
+    ASSERT(config.connection_balance_config().has_exact_balance());
+    connection_balancer_ = std::make_unique<Network::ExactConnectionBalancerImpl>();
+  } else {
+    connection_balancer_ = std::make_unique<Network::NopConnectionBalancerImpl>();
+  }
+
   if (!config.listener_filters().empty()) {
     listener_filter_factories_ =
         parent_.factory_.createListenerFilterFactoryList(config.listener_filters(), *this);
@@ -684,7 +706,7 @@ ListenerManagerImpl::ListenerManagerImpl(Instance& server,
           "listeners", [this] { return dumpListenerConfigs(); })),
       enable_dispatcher_stats_(enable_dispatcher_stats) {
   for (uint32_t i = 0; i < server.options().concurrency(); i++) {
-    workers_.emplace_back(worker_factory.createWorker(server.overloadManager()));
+    workers_.emplace_back(worker_factory.createWorker(i, server.overloadManager()));
   }
 }
 
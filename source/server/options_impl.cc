@@ -13,6 +13,7 @@
 
 #include "server/options_impl_platform.h"
 
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_split.h"
 #include "spdlog/spdlog.h"
 #include "tclap/CmdLine.h"
@@ -101,6 +102,15 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
       "", "enable-mutex-tracing", "Enable mutex contention tracing functionality", cmd, false);
   TCLAP::SwitchArg cpuset_threads(
       "", "cpuset-threads", "Get the default # of worker threads from cpuset size", cmd, false);
+  TCLAP::ValueArg<std::string> worker_cpu_affinity(
+      "", "worker-cpu-affinity",
+      "Comma separated list of CPUs and CPU ranges (e.g. 0-3,8) to pin the worker threads to, one "
+      "CPU per worker",
+      false, "", "string", cmd);
+  TCLAP::ValueArg<std::string> main_thread_cpu_affinity(
+      "", "main-thread-cpu-affinity",
+      "Comma separated list of CPUs and CPU ranges (e.g. 0-3,8) to pin the main thread to", false,
+      "", "string", cmd);
 
   TCLAP::ValueArg<bool> use_libevent_buffer("", "use-libevent-buffers",
                                             "Use the original libevent buffer implementation",
@@ -130,6 +140,9 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
 
   libevent_buffer_enabled_ = use_libevent_buffer.getValue();
   cpuset_threads_ = cpuset_threads.getValue();
+  worker_cpu_affinity_ = parseCpuList("worker-cpu-affinity", worker_cpu_affinity.getValue());
+  main_thread_cpu_affinity_ =
+      parseCpuList("main-thread-cpu-affinity", main_thread_cpu_affinity.getValue());
 
   log_level_ = default_log_level;
   for (size_t i = 0; i < ARRAY_SIZE(spdlog::level::level_string_views); i++) {
@@ -233,6 +246,30 @@ void OptionsImpl::parseComponentLogLevels(const std::string& component_log_level
   }
 }
 
+std::vector<uint32_t> OptionsImpl::parseCpuList(const std::string& option,
+                                                const std::string& cpu_list) const {
+  // The number of CPUs the CPU sets of Linux can hold.
+  constexpr uint32_t max_cpus = 1024;
+  std::vector<uint32_t> cpus;
+  if (cpu_list.empty()) {
+    return cpus;
+  }
+  for (absl::string_view item : absl::StrSplit(cpu_list, ',')) {
+    const std::vector<absl::string_view> range = absl::StrSplit(item, absl::MaxSplits('-', 1));
+    uint32_t first{};
+    uint32_t last{};
+    if (!absl::SimpleAtoi(range[0], &first) ||
+        !absl::SimpleAtoi(range.size() == 2 ? range[1] : range[0], &last) || first > last ||
+        last >= max_cpus) {
+      logError(fmt::format("error: invalid CPU '{}' in --{} '{}'", item, option, cpu_list));
+    }
+    for (uint32_t cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
 uint32_t OptionsImpl::count() const { return count_; }
 
 void OptionsImpl::logError(const std::string& error) const { throw MalformedArgvException(error); }
@@ -277,6 +314,12 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   command_line_options->set_disable_hot_restart(hotRestartDisabled());
   command_line_options->set_enable_mutex_tracing(mutexTracingEnabled());
   command_line_options->set_cpuset_threads(cpusetThreadsEnabled());
+  for (const uint32_t cpu : workerCpuAffinity()) {
+    command_line_options->add_worker_cpu_affinity(cpu);
+  }
+  for (const uint32_t cpu : mainThreadCpuAffinity()) {
+    command_line_options->add_main_thread_cpu_affinity(cpu);
+  }
   command_line_options->set_restart_epoch(restartEpoch());
   return command_line_options;
 }
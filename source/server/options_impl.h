@@ -3,6 +3,7 @@
 #include <chrono>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "envoy/common/exception.h"
 #include "envoy/server/options.h"
@@ -71,6 +72,12 @@ public:
     signal_handling_enabled_ = signal_handling_enabled;
   }
   void setCpusetThreads(bool cpuset_threads_enabled) { cpuset_threads_ = cpuset_threads_enabled; }
+  void setWorkerCpuAffinity(const std::vector<uint32_t>& worker_cpu_affinity) {
+    worker_cpu_affinity_ = worker_cpu_affinity;
+  }
+  void setMainThreadCpuAffinity(const std::vector<uint32_t>& main_thread_cpu_affinity) {
+    main_thread_cpu_affinity_ = main_thread_cpu_affinity;
+  }
 
   // Server::Options
   uint64_t baseId() const override { return base_id_; }
@@ -105,10 +112,15 @@ public:
   virtual Server::CommandLineOptionsPtr toCommandLineOptions() const override;
   void parseComponentLogLevels(const std::string& component_log_levels);
   bool cpusetThreadsEnabled() const override { return cpuset_threads_; }
+  const std::vector<uint32_t>& workerCpuAffinity() const override { return worker_cpu_affinity_; }
+  const std::vector<uint32_t>& mainThreadCpuAffinity() const override {
+    return main_thread_cpu_affinity_;
+  }
   uint32_t count() const;
 
 private:
   void logError(const std::string& error) const;
+  std::vector<uint32_t> parseCpuList(const std::string& option, const std::string& cpu_list) const;
 
   uint64_t base_id_;
   uint32_t concurrency_;
@@ -134,6 +146,8 @@ private:
   bool signal_handling_enabled_;
   bool mutex_tracing_enabled_;
   bool cpuset_threads_;
+  std::vector<uint32_t> worker_cpu_affinity_;
+  std::vector<uint32_t> main_thread_cpu_affinity_;
   bool libevent_buffer_enabled_;
   uint32_t count_;
 };
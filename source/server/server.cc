@@ -28,6 +28,7 @@
 #include "common/config/resources.h"
 #include "common/config/utility.h"
 #include "common/http/codes.h"
+#include "common/http/header_map_impl.h"
 #include "common/local_info/local_info_impl.h"
 #include "common/memory/stats.h"
 #include "common/network/address_impl.h"
@@ -40,9 +41,12 @@
 
 #include "server/configuration_impl.h"
 #include "server/connection_handler_impl.h"
+#include "server/cpu_affinity.h"
 #include "server/guarddog_impl.h"
 #include "server/listener_hooks.h"
 
+#include "absl/strings/str_join.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -61,9 +65,9 @@ InstanceImpl::InstanceImpl(const Options& options, Event::TimeSystem& time_syste
       thread_local_(tls), api_(new Api::Impl(thread_factory, store, time_system, file_system)),
       dispatcher_(api_->allocateDispatcher()),
       singleton_manager_(new Singleton::ManagerImpl(api_->threadFactory().currentThreadId())),
-      handler_(new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher_)),
+      handler_(new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher_, "main_thread.")),
       random_generator_(std::move(random_generator)), listener_component_factory_(*this),
-      worker_factory_(thread_local_, *api_, hooks),
+      worker_factory_(thread_local_, *api_, hooks, options),
       dns_resolver_(dispatcher_->createDnsResolver({})),
       access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
                           store),
@@ -72,6 +76,13 @@ InstanceImpl::InstanceImpl(const Options& options, Event::TimeSystem& time_syste
                                                   : nullptr),
       http_context_(store.symbolTable()), process_context_(std::move(process_context)),
       main_thread_id_(std::this_thread::get_id()) {
+  // The workers are not pinned to the CPUs of the main thread, see ProdWorkerFactory.
+  if (!options.mainThreadCpuAffinity().empty() &&
+      CpuAffinity::setThreadAffinity(options.mainThreadCpuAffinity())) {
+    ENVOY_LOG(info, "main thread pinned to CPUs {}",
+              absl::StrJoin(options.mainThreadCpuAffinity(), ","));
+  }
+
   try {
     if (!options.logPath().empty()) {
       try {
@@ -281,10 +292,21 @@ void InstanceImpl::initialize(const Options& options,
   InstanceUtil::loadBootstrapConfig(bootstrap_, options, *api_);
   bootstrap_config_update_time_ = time_source_.systemTime();
 
+  // Custom inline headers must be registered before any header map is used.
+  for (const std::string& header : bootstrap_.inline_headers()) {
+    if (absl::AsciiStrToLower(header) != header) {
+      throw EnvoyException(fmt::format("inline header '{}' must be lower case", header));
+    }
+    Http::HeaderMapImpl::registerCustomInlineHeader(Http::LowerCaseString(header));
+  }
+
   // Needs to happen as early as possible in the instantiation to preempt the objects that require
   // stats.
   stats_store_.setTagProducer(Config::Utility::createTagProducer(bootstrap_));
   stats_store_.setStatsMatcher(Config::Utility::createStatsMatcher(bootstrap_));
+  if (bootstrap_.stats_config().per_worker_stats()) {
+    stats_store_.enablePerWorkerStats(options_.concurrency());
+  }
 
   const std::string server_stats_prefix = "server.";
   server_stats_ = std::make_unique<ServerStats>(
@@ -9,23 +9,38 @@
 #include "envoy/thread_local/thread_local.h"
 
 #include "server/connection_handler_impl.h"
+#include "server/cpu_affinity.h"
+
+#include "absl/strings/str_join.h"
 
 namespace Envoy {
 namespace Server {
 
-WorkerPtr ProdWorkerFactory::createWorker(OverloadManager& overload_manager) {
+ProdWorkerFactory::ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api,
+                                     ListenerHooks& hooks, const Options& options)
+    : tls_(tls), api_(api), hooks_(hooks), worker_cpu_affinity_(options.workerCpuAffinity()) {
+  if (worker_cpu_affinity_.empty() && !options.mainThreadCpuAffinity().empty()) {
+    process_cpus_ = CpuAffinity::threadAffinity();
+  }
+}
+
+WorkerPtr ProdWorkerFactory::createWorker(uint32_t index, OverloadManager& overload_manager) {
   Event::DispatcherPtr dispatcher(api_.allocateDispatcher());
-  return WorkerPtr{new WorkerImpl(
-      tls_, hooks_, std::move(dispatcher),
-      Network::ConnectionHandlerPtr{new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher)},
-      overload_manager, api_)};
+  Network::ConnectionHandlerPtr handler{
+      new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher, fmt::format("worker_{}.", index))};
+  const std::vector<uint32_t> cpus = worker_cpu_affinity_.empty()
+                                         ? process_cpus_
+                                         : CpuAffinity::workerCpus(worker_cpu_affinity_, index);
+  return WorkerPtr{new WorkerImpl(tls_, hooks_, std::move(dispatcher), std::move(handler),
+                                  overload_manager, api_, cpus)};
 }
 
 WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
                        Event::DispatcherPtr&& dispatcher, Network::ConnectionHandlerPtr handler,
-                       OverloadManager& overload_manager, Api::Api& api)
+                       OverloadManager& overload_manager, Api::Api& api,
+                       const std::vector<uint32_t>& cpus)
     : tls_(tls), hooks_(hooks), dispatcher_(std::move(dispatcher)), handler_(std::move(handler)),
-      api_(api) {
+      api_(api), cpus_(cpus) {
   tls_.registerThread(*dispatcher_, false);
   overload_manager.registerForAction(
       OverloadActionNames::get().StopAcceptingConnections, *dispatcher_,
@@ -98,6 +113,11 @@ void WorkerImpl::stopListeners() {
 }
 
 void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
+  // Pin the thread before it allocates the state of its connections, so that the memory is placed
+  // on the NUMA node of its CPUs.
+  if (!cpus_.empty() && CpuAffinity::setThreadAffinity(cpus_)) {
+    ENVOY_LOG(debug, "worker pinned to CPUs {}", absl::StrJoin(cpus_, ","));
+  }
   ENVOY_LOG(debug, "worker entering dispatch loop");
   auto watchdog = guard_dog.createWatchDog(api_.threadFactory().currentThreadId());
   watchdog->startWatchdog(*dispatcher_);
@@ -2,11 +2,13 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "envoy/api/api.h"
 #include "envoy/network/connection_handler.h"
 #include "envoy/server/guarddog.h"
 #include "envoy/server/listener_manager.h"
+#include "envoy/server/options.h"
 #include "envoy/server/worker.h"
 #include "envoy/thread_local/thread_local.h"
 
@@ -19,16 +21,20 @@ namespace Server {
 
 class ProdWorkerFactory : public WorkerFactory, Logger::Loggable<Logger::Id::main> {
 public:
-  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, ListenerHooks& hooks)
-      : tls_(tls), api_(api), hooks_(hooks) {}
+  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, ListenerHooks& hooks,
+                    const Options& options);
 
   // Server::WorkerFactory
-  WorkerPtr createWorker(OverloadManager& overload_manager) override;
+  WorkerPtr createWorker(uint32_t index, OverloadManager& overload_manager) override;
 
 private:
   ThreadLocal::Instance& tls_;
   Api::Api& api_;
   ListenerHooks& hooks_;
+  const std::vector<uint32_t> worker_cpu_affinity_;
+  // The CPUs of the process when the factory is created. The workers are pinned to them if only
+  // the main thread is pinned, as threads inherit the CPUs of the thread which creates them.
+  std::vector<uint32_t> process_cpus_;
 };
 
 /**
@@ -38,7 +44,7 @@ class WorkerImpl : public Worker, Logger::Loggable<Logger::Id::main> {
 public:
   WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks, Event::DispatcherPtr&& dispatcher,
              Network::ConnectionHandlerPtr handler, OverloadManager& overload_manager,
-             Api::Api& api);
+             Api::Api& api, const std::vector<uint32_t>& cpus);
 
   // Server::Worker
   void addListener(Network::ListenerConfig& listener, AddListenerCompletion completion) override;
@@ -59,6 +65,8 @@ private:
   Event::DispatcherPtr dispatcher_;
   Network::ConnectionHandlerPtr handler_;
   Api::Api& api_;
+  // The CPUs the worker thread is pinned to, if any.
+  const std::vector<uint32_t> cpus_;
   Thread::ThreadPtr thread_;
 };
 
@@ -836,6 +836,47 @@ TEST(AccessLogFormatterTest, CompositeFormatterSuccess) {
   }
 }
 
+TEST(AccessLogFormatterTest, CompositeFormatterFormatTo) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
+  Http::TestHeaderMapImpl response_header{{"second", "PUT"}};
+  Http::TestHeaderMapImpl response_trailer{{"third", "POST"}};
+
+  absl::optional<uint32_t> response_code{200};
+  EXPECT_CALL(stream_info, responseCode()).WillRepeatedly(Return(response_code));
+  EXPECT_CALL(stream_info, bytesSent()).WillRepeatedly(Return(1024));
+  absl::optional<std::chrono::nanoseconds> duration = std::chrono::milliseconds(15);
+  EXPECT_CALL(stream_info, requestComplete()).WillRepeatedly(Return(duration));
+
+  const std::string format = "%REQ(FIRST):2% %RESP(SECOND)% %TRAILER(THIRD?FIRST)% %REQ(NONE)% "
+                             "%RESPONSE_CODE% %BYTES_SENT% %DURATION%\n";
+  FormatterImpl formatter(format);
+
+  // The line is appended to what the buffer already holds.
+  std::string output = "prefix ";
+  formatter.formatTo(request_header, response_header, response_trailer, stream_info, output);
+  EXPECT_EQ("prefix GE PUT POST - 200 1024 15\n", output);
+
+  // Reusing the buffer yields the same line as format().
+  output.clear();
+  formatter.formatTo(request_header, response_header, response_trailer, stream_info, output);
+  EXPECT_EQ(formatter.format(request_header, response_header, response_trailer, stream_info),
+            output);
+}
+
+TEST(AccessLogFormatterTest, JsonFormatterFormatTo) {
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestHeaderMapImpl header{{"some_request_header", "SOME_REQUEST_HEADER"}};
+
+  std::unordered_map<std::string, std::string> key_mapping = {
+      {"request_header", "%REQ(some_request_header)%"}};
+  JsonFormatterImpl formatter(key_mapping);
+
+  std::string output = "prefix ";
+  formatter.formatTo(header, header, header, stream_info, output);
+  EXPECT_EQ("prefix " + formatter.format(header, header, header, stream_info), output);
+}
+
 TEST(AccessLogFormatterTest, ParserFailures) {
   AccessLogFormatParser parser;
 
@@ -1,6 +1,8 @@
 #include <memory>
+#include <vector>
 
 #include "common/access_log/access_log_manager_impl.h"
+#include "common/common/fmt.h"
 #include "common/filesystem/file_shared_impl.h"
 #include "common/stats/isolated_store_impl.h"
 
@@ -9,11 +11,15 @@
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/filesystem/mocks.h"
 
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/synchronization/notification.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using testing::_;
 using testing::ByMove;
+using testing::Each;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnNew;
@@ -301,6 +307,95 @@ TEST_F(AccessLogManagerImplTest, bigDataChunkShouldBeFlushedWithoutTimer) {
   EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+TEST_F(AccessLogManagerImplTest, dropWritesWhenTooMuchDataIsBuffered) {
+  NiceMock<Event::MockTimer>* timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  EXPECT_CALL(*file_, open_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  // The flush thread is blocked while writing the first data, which stays buffered until then.
+  absl::Notification write_started;
+  absl::Notification write_unblocked;
+  EXPECT_CALL(*timer, enableTimer(timeout_40ms_));
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Invoke([&](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("a"));
+        write_started.Notify();
+        write_unblocked.WaitForNotification();
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("c"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  log_file->write("a");
+  write_started.WaitForNotification();
+
+  // At most 1MiB are buffered for a write buffer, and the data being written still counts.
+  log_file->write(std::string(1024 * 1024, 'b'));
+  // The writes are added to the stats when the write buffers are flushed.
+  EXPECT_EQ(0UL, store_.counter("access_log_file.write_dropped").value());
+  EXPECT_EQ(1UL, store_.counter("access_log_file.write_buffered").value());
+  EXPECT_EQ(1UL, store_.gauge("access_log_file.write_total_buffered").value());
+
+  write_unblocked.Notify();
+  log_file->write("c");
+  log_file->flush();
+  {
+    Thread::LockGuard lock(file_->write_mutex_);
+    EXPECT_EQ(2U, file_->num_writes_);
+  }
+  EXPECT_EQ(1UL, store_.counter("access_log_file.write_dropped").value());
+  EXPECT_EQ(2UL, store_.counter("access_log_file.write_buffered").value());
+  EXPECT_EQ(0UL, store_.gauge("access_log_file.write_total_buffered").value());
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplTest, writesFromSeveralThreads) {
+  EXPECT_CALL(dispatcher_, createTimer_(_)).WillOnce(ReturnNew<NiceMock<Event::MockTimer>>());
+  EXPECT_CALL(*file_, open_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  // Writes to the file are serialized by the file lock.
+  std::string written;
+  EXPECT_CALL(*file_, write_(_))
+      .WillRepeatedly(Invoke([&written](absl::string_view data) -> Api::IoCallSizeResult {
+        written.append(data.data(), data.size());
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  const uint32_t num_threads = 4;
+  const uint32_t num_lines = 1000;
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads.emplace_back(thread_factory_.createThread([&log_file, i]() -> void {
+      for (uint32_t j = 0; j < num_lines; j++) {
+        log_file->write(fmt::format("{} {}\n", i, j));
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  log_file->flush();
+
+  // No line is lost or torn, and the lines of each thread are written in order.
+  std::vector<uint32_t> next_lines(num_threads, 0);
+  for (const absl::string_view line : absl::StrSplit(written, '\n', absl::SkipEmpty())) {
+    const std::vector<absl::string_view> fields = absl::StrSplit(line, ' ');
+    ASSERT_EQ(2U, fields.size());
+    uint32_t thread;
+    uint32_t index;
+    ASSERT_TRUE(absl::SimpleAtoi(fields[0], &thread));
+    ASSERT_TRUE(absl::SimpleAtoi(fields[1], &index));
+    ASSERT_LT(thread, num_threads);
+    EXPECT_EQ(next_lines[thread]++, index);
+  }
+  EXPECT_THAT(next_lines, Each(num_lines));
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
 TEST_F(AccessLogManagerImplTest, reopenAllFiles) {
   EXPECT_CALL(dispatcher_, createTimer_(_)).WillRepeatedly(ReturnNew<NiceMock<Event::MockTimer>>());
 
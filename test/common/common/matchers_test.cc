@@ -289,6 +289,25 @@ TEST(LowerCaseStringMatcher, MatchRegexValue) {
   EXPECT_FALSE(Envoy::Matchers::LowerCaseStringMatcher(matcher).match("Foo.Bar"));
 }
 
+TEST(LowerCaseStringMatcher, MatchSafeRegexValue) {
+  envoy::type::matcher::StringMatcher matcher;
+  matcher.mutable_safe_regex()->mutable_google_re2();
+  matcher.mutable_safe_regex()->set_regex("Foo.*");
+
+  EXPECT_TRUE(Envoy::Matchers::LowerCaseStringMatcher(matcher).match("foo.bar"));
+  EXPECT_FALSE(Envoy::Matchers::LowerCaseStringMatcher(matcher).match("Foo.Bar"));
+}
+
+TEST(StringMatcher, MatchSafeRegexValue) {
+  envoy::type::matcher::StringMatcher matcher;
+  matcher.mutable_safe_regex()->mutable_google_re2();
+  matcher.mutable_safe_regex()->set_regex("foo\\d+");
+
+  EXPECT_TRUE(Envoy::Matchers::StringMatcher(matcher).match("foo123"));
+  EXPECT_FALSE(Envoy::Matchers::StringMatcher(matcher).match("foo"));
+  EXPECT_FALSE(Envoy::Matchers::StringMatcher(matcher).match("xfoo123"));
+}
+
 } // namespace
 } // namespace Matcher
 } // namespace Envoy
@@ -0,0 +1,128 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/macros.h"
+#include "common/common/regex.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Regex {
+
+static const std::vector<std::string>& clusterInputs() {
+  CONSTRUCT_ON_FIRST_USE(std::vector<std::string>,
+                         {
+                             "cluster.no_trailing_dot",
+                             "cluster.match.",
+                             "cluster.match.normal",
+                             "cluster.match.and.a.whole.lot.of.things.coming.after.the.matches."
+                             "really.too.much.stuff",
+                         });
+}
+
+static const char ClusterRegex[] = "cluster[.](.*?)[.].*";
+
+static envoy::type::matcher::RegexMatcher googleReConfig(const std::string& regex) {
+  envoy::type::matcher::RegexMatcher config;
+  config.mutable_google_re2();
+  config.set_regex(regex);
+  return config;
+}
+
+/** Measure matching a single expression with the std::regex engine. */
+static void BM_StdRegex(benchmark::State& state) {
+  CompiledMatcherPtr matcher = Utility::parseStdRegexAsCompiledMatcher(ClusterRegex);
+  uint32_t passes = 0;
+  for (auto _ : state) {
+    for (const std::string& cluster_input : clusterInputs()) {
+      passes += matcher->match(cluster_input);
+    }
+  }
+  RELEASE_ASSERT(passes > 0, "");
+}
+BENCHMARK(BM_StdRegex);
+
+/** Measure matching a single expression with the RE2 engine. */
+static void BM_GoogleRe(benchmark::State& state) {
+  CompiledMatcherPtr matcher = Utility::parseRegex(googleReConfig(ClusterRegex));
+  uint32_t passes = 0;
+  for (auto _ : state) {
+    for (const std::string& cluster_input : clusterInputs()) {
+      passes += matcher->match(cluster_input);
+    }
+  }
+  RELEASE_ASSERT(passes > 0, "");
+}
+BENCHMARK(BM_GoogleRe);
+
+/**
+ * Builds state.range(0) route-like expressions. None of them match the input used by the
+ * benchmarks below, which is the worst case of route selection: every expression is evaluated.
+ */
+static std::vector<std::string> routeExpressions(size_t count) {
+  std::vector<std::string> expressions;
+  for (size_t i = 0; i < count; i++) {
+    expressions.push_back(fmt::format("/service_{}/v[0-9]+/[a-z]+/[0-9]+", i));
+  }
+  return expressions;
+}
+
+static const char RouteInput[] = "/service_unknown/v1/resource/12345";
+
+/** Measure a miss against N expressions evaluated one by one with the std::regex engine. */
+static void BM_StdRegexRoutesMiss(benchmark::State& state) {
+  std::vector<CompiledMatcherPtr> matchers;
+  for (const std::string& expression : routeExpressions(state.range(0))) {
+    matchers.push_back(Utility::parseStdRegexAsCompiledMatcher(expression));
+  }
+  uint32_t passes = 0;
+  for (auto _ : state) {
+    for (const CompiledMatcherPtr& matcher : matchers) {
+      passes += matcher->match(RouteInput);
+    }
+  }
+  RELEASE_ASSERT(passes == 0, "");
+}
+BENCHMARK(BM_StdRegexRoutesMiss)->Arg(10)->Arg(100)->Arg(1000);
+
+/** Measure a miss against N expressions evaluated one by one with the RE2 engine. */
+static void BM_GoogleReRoutesMiss(benchmark::State& state) {
+  std::vector<CompiledMatcherPtr> matchers;
+  for (const std::string& expression : routeExpressions(state.range(0))) {
+    matchers.push_back(Utility::parseRegex(googleReConfig(expression)));
+  }
+  uint32_t passes = 0;
+  for (auto _ : state) {
+    for (const CompiledMatcherPtr& matcher : matchers) {
+      passes += matcher->match(RouteInput);
+    }
+  }
+  RELEASE_ASSERT(passes == 0, "");
+}
+BENCHMARK(BM_GoogleReRoutesMiss)->Arg(10)->Arg(100)->Arg(1000);
+
+/** Measure a miss against N expressions compiled into a single RE2 set. */
+static void BM_GoogleReSetRoutesMiss(benchmark::State& state) {
+  std::vector<envoy::type::matcher::RegexMatcher> configs;
+  for (const std::string& expression : routeExpressions(state.range(0))) {
+    configs.push_back(googleReConfig(expression));
+  }
+  CompiledMatcherSetPtr set = Utility::parseRegexSet(configs);
+  std::vector<int> matches;
+  uint32_t passes = 0;
+  for (auto _ : state) {
+    set->match(RouteInput, matches);
+    passes += matches.size();
+  }
+  RELEASE_ASSERT(passes == 0, "");
+}
+BENCHMARK(BM_GoogleReSetRoutesMiss)->Arg(10)->Arg(100)->Arg(1000);
+
+} // namespace Regex
+} // namespace Envoy
@@ -0,0 +1,81 @@
+#include "envoy/common/exception.h"
+
+#include "common/common/regex.h"
+
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace Envoy {
+namespace Regex {
+namespace {
+
+envoy::type::matcher::RegexMatcher googleReConfig(const std::string& regex) {
+  envoy::type::matcher::RegexMatcher matcher;
+  matcher.mutable_google_re2();
+  matcher.set_regex(regex);
+  return matcher;
+}
+
+TEST(Utility, ParseStdRegex) {
+  EXPECT_THROW_WITH_REGEX(Utility::parseStdRegexAsCompiledMatcher("(+invalid)"), EnvoyException,
+                          "Invalid regex '\\(\\+invalid\\)': .+");
+
+  CompiledMatcherPtr matcher = Utility::parseStdRegexAsCompiledMatcher("/asdf/.*");
+  EXPECT_TRUE(matcher->match("/asdf/1"));
+  EXPECT_FALSE(matcher->match("/ASDF/1"));
+  EXPECT_FALSE(matcher->match("/foo/asdf/1"));
+}
+
+TEST(Utility, ParseRegex) {
+  EXPECT_THROW_WITH_MESSAGE(Utility::parseRegex(googleReConfig("(+invalid)")), EnvoyException,
+                            "Invalid regex '(+invalid)': no argument for repetition operator: +");
+
+  CompiledMatcherPtr matcher = Utility::parseRegex(googleReConfig("/asdf/.*"));
+  EXPECT_TRUE(matcher->match("/asdf/1"));
+  EXPECT_FALSE(matcher->match("/ASDF/1"));
+  // The entire input must match.
+  EXPECT_FALSE(matcher->match("/foo/asdf/1"));
+}
+
+TEST(Utility, ParseRegexMaxProgramSize) {
+  const std::string complex_regex(200, 'a');
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegex(googleReConfig(complex_regex)), EnvoyException,
+                          "RE2 program size of [0-9]+ > max program size of 100");
+
+  envoy::type::matcher::RegexMatcher config = googleReConfig(complex_regex);
+  config.mutable_google_re2()->mutable_max_program_size()->set_value(1000);
+  EXPECT_TRUE(Utility::parseRegex(config)->match(complex_regex));
+}
+
+TEST(Utility, ParseRegexSet) {
+  CompiledMatcherSetPtr set = Utility::parseRegexSet(
+      {googleReConfig("/api/v[0-9]/.*"), googleReConfig("/static/.*"), googleReConfig(".*\\.png")});
+  EXPECT_EQ(3, set->size());
+
+  std::vector<int> matches;
+  set->match("/api/v1/users", matches);
+  EXPECT_THAT(matches, ElementsAre(0));
+  set->match("/static/logo.png", matches);
+  EXPECT_THAT(matches, ElementsAre(1, 2));
+  set->match("/other", matches);
+  EXPECT_THAT(matches, IsEmpty());
+  // The entire input must match an expression.
+  set->match("/other/api/v1/users", matches);
+  EXPECT_THAT(matches, IsEmpty());
+}
+
+TEST(Utility, ParseRegexSetInvalid) {
+  EXPECT_THROW_WITH_MESSAGE(
+      Utility::parseRegexSet({googleReConfig("/ok"), googleReConfig("(+invalid)")}),
+      EnvoyException,
+      "Invalid regex '(+invalid)': no argument for repetition operator: +");
+}
+
+} // namespace
+} // namespace Regex
+} // namespace Envoy
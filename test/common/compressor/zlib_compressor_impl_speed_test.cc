@@ -0,0 +1,123 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/common/macros.h"
+#include "common/compressor/zlib_compressor_impl.h"
+
+#include "test/test_common/allocation_counter.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Compressor {
+
+// zlib defaults, for which deflateInit2() allocates about 256KB of state.
+static const int64_t GzipWindowBits = 31;
+static const int64_t ZlibWindowBits = 15;
+static const uint64_t MemoryLevel = 8;
+
+/**
+ * @param size supplies the size of the body.
+ * @return std::string a JSON body made of similar records, like the responses of an API.
+ */
+static std::string jsonBody(uint64_t size) {
+  std::string body = "[";
+  for (uint64_t i = 0; body.size() < size; i++) {
+    absl::StrAppend(&body, R"({"id": )", i, R"(, "name": "user-)", i % 97,
+                    R"(", "email": "user-)", i % 97, R"(@example.com", "active": )",
+                    i % 3 == 0 ? "false" : "true", R"(, "roles": ["reader"]},)");
+  }
+  body.resize(size);
+  return body;
+}
+
+// The keys and common values of the records of jsonBody(), the most common ones last.
+static const std::string& jsonDictionary() {
+  CONSTRUCT_ON_FIRST_USE(std::string, R"(@example.com", "active": false, "roles": ["reader"]},)"
+                                      R"({"id": , "name": "user-", "email": "user-)"
+                                      R"(@example.com", "active": true, "roles": ["reader"]},)");
+}
+
+static uint64_t compressBody(ZlibCompressorImpl& compressor, const std::string& body) {
+  Buffer::OwnedImpl data(body);
+  compressor.compress(data, State::Finish);
+  return data.length();
+}
+
+/**
+ * Measure the cost of compressing a response with a new compressor, as the gzip filter did for
+ * each response before pooling its compressors. The first argument is the size of the body.
+ */
+static void ZlibCompressNewCompressor(benchmark::State& state) {
+  const std::string body = jsonBody(state.range(0));
+  uint64_t compressed_bytes = 0;
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    ZlibCompressorImpl compressor;
+    compressor.init(ZlibCompressorImpl::CompressionLevel::Standard,
+                    ZlibCompressorImpl::CompressionStrategy::Standard, GzipWindowBits, MemoryLevel);
+    compressed_bytes = compressBody(compressor, body);
+  }
+  state.counters["compressed_bytes"] = compressed_bytes;
+}
+BENCHMARK(ZlibCompressNewCompressor)->Arg(1024)->Arg(16 * 1024)->Arg(256 * 1024);
+
+/**
+ * Measure the cost of compressing a response with a compressor reset after the previous response,
+ * as a pooled compressor of the gzip filter does. The first argument is the size of the body.
+ */
+static void ZlibCompressResetCompressor(benchmark::State& state) {
+  const std::string body = jsonBody(state.range(0));
+  ZlibCompressorImpl compressor;
+  compressor.init(ZlibCompressorImpl::CompressionLevel::Standard,
+                  ZlibCompressorImpl::CompressionStrategy::Standard, GzipWindowBits, MemoryLevel);
+  uint64_t compressed_bytes = 0;
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    compressor.reset();
+    compressed_bytes = compressBody(compressor, body);
+  }
+  state.counters["compressed_bytes"] = compressed_bytes;
+}
+BENCHMARK(ZlibCompressResetCompressor)->Arg(1024)->Arg(16 * 1024)->Arg(256 * 1024);
+
+/**
+ * Measure the cost and the output size of compressing a response into the zlib format, with a new
+ * compressor primed by a preset dictionary as the deflate compressor library does. The first
+ * argument is the size of the body, and a non zero second argument selects the dictionary.
+ */
+static void ZlibCompressDictionary(benchmark::State& state) {
+  const std::string body = jsonBody(state.range(0));
+  const bool use_dictionary = state.range(1) != 0;
+  uint64_t compressed_bytes = 0;
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    ZlibCompressorImpl compressor;
+    compressor.init(ZlibCompressorImpl::CompressionLevel::Standard,
+                    ZlibCompressorImpl::CompressionStrategy::Standard, ZlibWindowBits, MemoryLevel);
+    if (use_dictionary) {
+      compressor.setDictionary(jsonDictionary());
+    }
+    compressed_bytes = compressBody(compressor, body);
+  }
+  state.counters["compressed_bytes"] = compressed_bytes;
+}
+BENCHMARK(ZlibCompressDictionary)
+    ->Args({256, 0})
+    ->Args({256, 1})
+    ->Args({1024, 0})
+    ->Args({1024, 1})
+    ->Args({16 * 1024, 0})
+    ->Args({16 * 1024, 1});
+
+} // namespace Compressor
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -204,6 +204,24 @@ TEST_F(ZlibCompressorImplTest, CompressWithNotCommonParams) {
   expectValidFinishedBuffer(accumulation_buffer, input_size);
 }
 
+// Exercises a compressor reset in the middle of a stream, which then compresses a new stream.
+TEST_F(ZlibCompressorImplTest, CompressAfterReset) {
+  Buffer::OwnedImpl buffer;
+  ZlibCompressorImplTester compressor;
+  compressor.init(ZlibCompressorImpl::CompressionLevel::Standard,
+                  ZlibCompressorImpl::CompressionStrategy::Standard, gzip_window_bits,
+                  memory_level);
+
+  TestUtility::feedBufferWithRandomCharacters(buffer, default_input_size);
+  compressor.compressThenFlush(buffer);
+  drainBuffer(buffer);
+
+  compressor.reset();
+  TestUtility::feedBufferWithRandomCharacters(buffer, 4096);
+  compressor.finish(buffer);
+  expectValidFinishedBuffer(buffer, 4096);
+}
+
 } // namespace
 } // namespace Compressor
 } // namespace Envoy
\ No newline at end of file
@@ -52,7 +52,20 @@ protected:
     EXPECT_EQ(original_text, decompressed_text);
   }
 
+  // Compresses the text into a zlib stream primed with the dictionary.
+  static void compressWithDictionary(const std::string& text, absl::string_view dictionary,
+                                     Buffer::OwnedImpl& output_buffer) {
+    Envoy::Compressor::ZlibCompressorImpl compressor;
+    compressor.init(Envoy::Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
+                    Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Standard,
+                    zlib_window_bits, memory_level);
+    compressor.setDictionary(dictionary);
+    output_buffer.add(text);
+    compressor.compress(output_buffer, Compressor::State::Finish);
+  }
+
   static const int64_t gzip_window_bits{31};
+  static const int64_t zlib_window_bits{15};
   static const int64_t memory_level{8};
   static const uint64_t default_input_size{796};
 };
@@ -108,6 +121,43 @@ TEST_F(ZlibDecompressorImplTest, CallingChecksum) {
   EXPECT_EQ(compressor.checksum(), decompressor.checksum());
 }
 
+// Exercises decompression of data that is not a valid gzip stream, which stops the output.
+TEST_F(ZlibDecompressorImplTest, DecompressInvalidData) {
+  Buffer::OwnedImpl input_buffer("this is not a gzip stream");
+  Buffer::OwnedImpl output_buffer;
+  ZlibDecompressorImpl decompressor;
+  decompressor.init(gzip_window_bits);
+  decompressor.decompress(input_buffer, output_buffer);
+  decompressor.decompress(input_buffer, output_buffer);
+  EXPECT_EQ(0, output_buffer.length());
+}
+
+// Exercises decompression of a stream fed in several calls, each one producing less output than
+// the output buffer of the decompressor.
+TEST_F(ZlibDecompressorImplTest, DecompressInMultipleCalls) {
+  Buffer::OwnedImpl buffer;
+  TestUtility::feedBufferWithRandomCharacters(buffer, 2048);
+  const std::string original_text{buffer.toString()};
+
+  Envoy::Compressor::ZlibCompressorImpl compressor;
+  compressor.init(Envoy::Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
+                  Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Standard,
+                  gzip_window_bits, memory_level);
+  compressor.compress(buffer, Compressor::State::Finish);
+
+  ZlibDecompressorImpl decompressor;
+  decompressor.init(gzip_window_bits);
+  Buffer::OwnedImpl output_buffer;
+  while (buffer.length() > 0) {
+    Buffer::OwnedImpl input_buffer;
+    input_buffer.move(buffer, 100);
+    decompressor.decompress(input_buffer, output_buffer);
+  }
+
+  EXPECT_EQ(compressor.checksum(), decompressor.checksum());
+  EXPECT_EQ(original_text, output_buffer.toString());
+}
+
 // Exercises compression and decompression by compressing some data, decompressing it and then
 // comparing compressor's input/checksum with decompressor's output/checksum.
 TEST_F(ZlibDecompressorImplTest, CompressAndDecompress) {
@@ -149,6 +199,103 @@ TEST_F(ZlibDecompressorImplTest, CompressAndDecompress) {
   EXPECT_EQ(original_text, decompressed_text);
 }
 
+// Exercises a stream compressed with a preset dictionary, which makes repetitive content much
+// smaller.
+TEST_F(ZlibDecompressorImplTest, CompressAndDecompressWithDictionary) {
+  const std::string dictionary{R"({"id": , "name": "", "tags": [], "created_at": ""})"};
+  const std::string original_text{R"({"id": 1, "name": "a", "tags": [], "created_at": "now"})"};
+
+  Buffer::OwnedImpl compressed;
+  compressWithDictionary(original_text, dictionary, compressed);
+  Buffer::OwnedImpl compressed_without_dictionary;
+  compressWithDictionary(original_text, "", compressed_without_dictionary);
+  EXPECT_LT(compressed.length(), compressed_without_dictionary.length());
+
+  ZlibDecompressorImpl decompressor;
+  decompressor.init(zlib_window_bits);
+  decompressor.setDictionary(dictionary);
+  Buffer::OwnedImpl output_buffer;
+  decompressor.decompress(compressed, output_buffer);
+  EXPECT_EQ(original_text, output_buffer.toString());
+}
+
+// Exercises a compressor reset between streams, which is primed with its dictionary again.
+TEST_F(ZlibDecompressorImplTest, CompressWithDictionaryAfterReset) {
+  const std::string dictionary{"the quick brown fox jumps over the lazy dog"};
+  Envoy::Compressor::ZlibCompressorImpl compressor;
+  compressor.init(Envoy::Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
+                  Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Standard,
+                  zlib_window_bits, memory_level);
+
+  for (uint64_t i = 0; i < 3; ++i) {
+    compressor.reset();
+    compressor.setDictionary(dictionary);
+    const std::string original_text = "the lazy dog " + std::to_string(i);
+    Buffer::OwnedImpl buffer(original_text);
+    compressor.compress(buffer, Compressor::State::Finish);
+
+    ZlibDecompressorImpl decompressor;
+    decompressor.init(zlib_window_bits);
+    decompressor.setDictionary(dictionary);
+    Buffer::OwnedImpl output_buffer;
+    decompressor.decompress(buffer, output_buffer);
+    EXPECT_EQ(original_text, output_buffer.toString());
+  }
+}
+
+// Exercises a stream compressed with a preset dictionary which the decompressor does not have, or
+// not the same, which fails the decompression.
+TEST_F(ZlibDecompressorImplTest, DecompressWithMissingDictionary) {
+  Buffer::OwnedImpl compressed;
+  compressWithDictionary("some text", "some dictionary", compressed);
+
+  {
+    ZlibDecompressorImpl decompressor;
+    decompressor.init(zlib_window_bits);
+    Buffer::OwnedImpl output_buffer;
+    EXPECT_FALSE(decompressor.decompress(compressed, output_buffer));
+    EXPECT_EQ(0, output_buffer.length());
+  }
+
+  {
+    ZlibDecompressorImpl decompressor;
+    decompressor.init(zlib_window_bits);
+    decompressor.setDictionary("another dictionary");
+    Buffer::OwnedImpl output_buffer;
+    EXPECT_FALSE(decompressor.decompress(compressed, output_buffer));
+    EXPECT_EQ(0, output_buffer.length());
+  }
+}
+
+// Exercises a stream which is corrupted after a valid start. The decompression fails, and so does
+// any decompression after it, even of valid data.
+TEST_F(ZlibDecompressorImplTest, DecompressCorruptData) {
+  Envoy::Compressor::ZlibCompressorImpl compressor;
+  compressor.init(Envoy::Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
+                  Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Standard,
+                  gzip_window_bits, memory_level);
+  Buffer::OwnedImpl buffer("valid start");
+  compressor.compress(buffer, Compressor::State::Flush);
+
+  ZlibDecompressorImpl decompressor;
+  decompressor.init(gzip_window_bits);
+  Buffer::OwnedImpl output_buffer;
+  EXPECT_TRUE(decompressor.decompress(buffer, output_buffer));
+  EXPECT_EQ("valid start", output_buffer.toString());
+
+  // The flush ends the data on a block boundary, so this is read as a block of a reserved type.
+  Buffer::OwnedImpl corrupt_buffer(std::string(16, '\xff'));
+  output_buffer.drain(output_buffer.length());
+  EXPECT_FALSE(decompressor.decompress(corrupt_buffer, output_buffer));
+  EXPECT_EQ(0, output_buffer.length());
+
+  buffer.drain(buffer.length());
+  buffer.add("valid end");
+  compressor.compress(buffer, Compressor::State::Finish);
+  EXPECT_FALSE(decompressor.decompress(buffer, output_buffer));
+  EXPECT_EQ(0, output_buffer.length());
+}
+
 // Exercises decompression with a very small output buffer.
 TEST_F(ZlibDecompressorImplTest, DecompressWithSmallOutputBuffer) {
   Buffer::OwnedImpl buffer;
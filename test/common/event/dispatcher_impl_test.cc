@@ -9,14 +9,17 @@
 
 #include "test/mocks/common.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/test_common/test_time_system.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::AnyNumber;
 using testing::InSequence;
 using testing::NiceMock;
+using testing::Property;
 using testing::Return;
 using testing::StartsWith;
 
@@ -64,6 +67,42 @@ TEST(DeferredDeleteTest, DeferredDelete) {
   dispatcher->clearDeferredDeleteList();
 }
 
+TEST(DispatcherStatsTest, PostDelayAndDeferredDeleteSize) {
+  NiceMock<Stats::MockStore> store;
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher());
+  dispatcher->initializeStats(store, "test.");
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+
+  // Every iteration of the event loop records the loop stats.
+  EXPECT_CALL(store, deliverHistogramToSinks(_, _)).Times(AnyNumber());
+
+  EXPECT_CALL(store, deliverHistogramToSinks(
+                         Property(&Stats::Metric::name, "test.dispatcher.post_delay_us"), _));
+  dispatcher->post([]() {});
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+
+  EXPECT_CALL(store,
+              deliverHistogramToSinks(
+                  Property(&Stats::Metric::name, "test.dispatcher.deferred_delete_size"), 2));
+  dispatcher->deferredDelete(DeferredDeletablePtr{new TestDeferredDeletable([]() -> void {})});
+  dispatcher->deferredDelete(DeferredDeletablePtr{new TestDeferredDeletable([]() -> void {})});
+  dispatcher->clearDeferredDeleteList();
+}
+
+// Without stats, posting a callback does not read the clock.
+TEST(DispatcherStatsTest, PostWithoutStats) {
+  Event::DelegatingTestTimeSystem<MockTimeSystem> time_system;
+  Api::ApiPtr api = Api::createApiForTest(time_system);
+  DispatcherPtr dispatcher(api->allocateDispatcher());
+  ReadyWatcher watcher;
+
+  EXPECT_CALL(*time_system, monotonicTime()).Times(0);
+  EXPECT_CALL(watcher, ready());
+  dispatcher->post([&watcher]() { watcher.ready(); });
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+}
+
 class DispatcherImplTest : public testing::Test {
 protected:
   DispatcherImplTest()
@@ -99,8 +138,11 @@ protected:
 // TODO(mergeconflict): We also need integration testing to validate that the expected histograms
 // are written when `enable_dispatcher_stats` is true. See issue #6582.
 TEST_F(DispatcherImplTest, InitializeStats) {
+  EXPECT_CALL(scope_, histogram("test.dispatcher.deferred_delete_size"));
   EXPECT_CALL(scope_, histogram("test.dispatcher.loop_duration_us"));
   EXPECT_CALL(scope_, histogram("test.dispatcher.poll_delay_us"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.poll_wait_us"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.post_delay_us"));
   dispatcher_->initializeStats(scope_, "test.");
 }
 
@@ -1,5 +1,6 @@
 #include <arpa/inet.h>
 
+#include "common/decompressor/zlib_decompressor_impl.h"
 #include "common/grpc/common.h"
 #include "common/http/headers.h"
 #include "common/http/message_impl.h"
@@ -364,5 +365,30 @@ TEST(GrpcCommonTest, PrependGrpcFrameHeader) {
   EXPECT_EQ(buffer->toString(), header_string + "test");
 }
 
+// Ensure that messages are gzip compressed into frames flagged as compressed, and that the
+// compressor can be reused for the following messages.
+TEST(GrpcCommonTest, SerializeToCompressedGrpcFrame) {
+  auto compressor = Common::createCompressor(CompressionAlgorithm::Gzip);
+  for (const std::string& greeting : {"hello", "world"}) {
+    helloworld::HelloRequest request;
+    request.set_name(std::string(1000, greeting[0]) + greeting);
+    Buffer::InstancePtr frame = Common::serializeToCompressedGrpcFrame(request, *compressor);
+
+    std::vector<Frame> frames;
+    EXPECT_TRUE(Decoder().decode(*frame, frames));
+    ASSERT_EQ(1U, frames.size());
+    EXPECT_EQ(GRPC_FH_COMPRESSED, frames[0].flags_);
+    EXPECT_LT(frames[0].length_, request.ByteSizeLong());
+
+    Decompressor::ZlibDecompressorImpl decompressor;
+    decompressor.init(31);
+    Buffer::OwnedImpl decompressed;
+    decompressor.decompress(*frames[0].data_, decompressed);
+    helloworld::HelloRequest result;
+    EXPECT_TRUE(result.ParseFromString(decompressed.toString()));
+    EXPECT_EQ(request.name(), result.name());
+  }
+}
+
 } // namespace Grpc
 } // namespace Envoy
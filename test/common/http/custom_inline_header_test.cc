@@ -0,0 +1,76 @@
+#include "common/http/header_map_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// Custom inline headers are process wide and can only be registered before header maps are used,
+// hence this test lives in its own binary and must remain the only test in it.
+TEST(CustomInlineHeaderTest, All) {
+  EXPECT_THROW_WITH_MESSAGE(
+      HeaderMapImpl::registerCustomInlineHeader(Headers::get().ContentType), EnvoyException,
+      "'content-type' is already an inline header");
+  EXPECT_THROW_WITH_MESSAGE(HeaderMapImpl::registerCustomInlineHeader(LowerCaseString("host")),
+                            EnvoyException, "'host' is already an inline header");
+  EXPECT_THROW_WITH_MESSAGE(HeaderMapImpl::registerCustomInlineHeader(Headers::get().Path),
+                            EnvoyException,
+                            "':path' is not a valid custom inline header name: it must be a "
+                            "non-empty header name which is not a pseudo-header");
+  EXPECT_THROW_WITH_MESSAGE(HeaderMapImpl::registerCustomInlineHeader(LowerCaseString(":x-tenant")),
+                            EnvoyException,
+                            "':x-tenant' is not a valid custom inline header name: it must be a "
+                            "non-empty header name which is not a pseudo-header");
+  EXPECT_THROW_WITH_MESSAGE(HeaderMapImpl::registerCustomInlineHeader(LowerCaseString("")),
+                            EnvoyException,
+                            "'' is not a valid custom inline header name: it must be a non-empty "
+                            "header name which is not a pseudo-header");
+  EXPECT_THROW_WITH_MESSAGE(HeaderMapImpl::registerCustomInlineHeader(LowerCaseString("x tenant")),
+                            EnvoyException,
+                            "'x tenant' is not a valid custom inline header name: it must be a "
+                            "token");
+
+  for (size_t i = 0; i < HeaderMapImpl::MaxCustomInlineHeaders; i++) {
+    HeaderMapImpl::registerCustomInlineHeader(LowerCaseString(fmt::format("x-tenant-{}", i)));
+  }
+  // Registering a header again is a no-op.
+  HeaderMapImpl::registerCustomInlineHeader(LowerCaseString("x-tenant-0"));
+  EXPECT_THROW_WITH_MESSAGE(
+      HeaderMapImpl::registerCustomInlineHeader(LowerCaseString("x-too-many")), EnvoyException,
+      "cannot register inline header 'x-too-many': at most 16 custom inline headers are "
+      "supported");
+
+  HeaderMapImpl headers;
+  const LowerCaseString tenant("x-tenant-15");
+  headers.addCopy(tenant, "foo");
+  headers.addCopy(tenant, "bar");
+  headers.addCopy(LowerCaseString("x-other"), "foo");
+  headers.addCopy(LowerCaseString("x-other"), "bar");
+  EXPECT_EQ(3, headers.size());
+  EXPECT_EQ("foo,bar", headers.get(tenant)->value().getStringView());
+
+  const HeaderEntry* entry;
+  EXPECT_EQ(HeaderMap::Lookup::Found, headers.lookup(tenant, &entry));
+  EXPECT_EQ("foo,bar", entry->value().getStringView());
+  EXPECT_EQ(HeaderMap::Lookup::NotFound, headers.lookup(LowerCaseString("x-tenant-1"), &entry));
+  EXPECT_EQ(HeaderMap::Lookup::NotSupported, headers.lookup(LowerCaseString("x-other"), &entry));
+
+  headers.remove(tenant);
+  EXPECT_EQ(nullptr, headers.get(tenant));
+  EXPECT_EQ(HeaderMap::Lookup::NotFound, headers.lookup(tenant, &entry));
+  headers.setReferenceKey(tenant, "baz");
+  headers.removePrefix(LowerCaseString("x-tenant"));
+  EXPECT_EQ(HeaderMap::Lookup::NotFound, headers.lookup(tenant, &entry));
+  EXPECT_EQ(2, headers.size());
+
+  EXPECT_THROW_WITH_MESSAGE(
+      HeaderMapImpl::registerCustomInlineHeader(LowerCaseString("x-late")), EnvoyException,
+      "cannot register inline header 'x-late' after header maps have been used");
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,80 @@
+#include <cstdint>
+#include <list>
+#include <string>
+
+#include "common/http/header_map_arena.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+
+TEST(HeaderMapArenaTest, AllocatesFromSlabs) {
+  HeaderMapArena arena(256);
+  EXPECT_EQ(0, arena.slabCount());
+
+  char* first = static_cast<char*>(arena.allocate(100));
+  char* second = static_cast<char*>(arena.allocate(100));
+  EXPECT_EQ(1, arena.slabCount());
+  EXPECT_EQ(256, arena.bytesReserved());
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(first) % alignof(std::max_align_t));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(second) % alignof(std::max_align_t));
+  EXPECT_LE(first + 100, second);
+
+  // Slabs double in size.
+  arena.allocate(100);
+  EXPECT_EQ(2, arena.slabCount());
+  EXPECT_EQ(256 + 512, arena.bytesReserved());
+
+  // Allocations larger than the next slab get a slab of their own.
+  arena.allocate(4096);
+  EXPECT_EQ(3, arena.slabCount());
+  EXPECT_EQ(256 + 512 + 4096, arena.bytesReserved());
+}
+
+TEST(HeaderMapArenaTest, SlabSizeIsCapped) {
+  HeaderMapArena arena(HeaderMapArena::MaxSlabSize);
+  arena.allocate(HeaderMapArena::MaxSlabSize);
+  arena.allocate(1);
+  EXPECT_EQ(2, arena.slabCount());
+  EXPECT_EQ(2 * HeaderMapArena::MaxSlabSize, arena.bytesReserved());
+}
+
+TEST(HeaderMapArenaTest, ReusesReleasedBlocksOfTheSameSize) {
+  HeaderMapArena arena;
+  void* small = arena.allocate(24);
+  void* large = arena.allocate(200);
+  arena.deallocate(small, 24);
+  arena.deallocate(large, 200);
+
+  EXPECT_EQ(large, arena.allocate(200));
+  EXPECT_EQ(small, arena.allocate(24));
+  EXPECT_NE(small, arena.allocate(24));
+  EXPECT_EQ(1, arena.slabCount());
+}
+
+TEST(HeaderMapArenaTest, Allocator) {
+  HeaderMapArena arena;
+  {
+    std::list<std::string, HeaderMapArenaAllocator<std::string>> list{
+        HeaderMapArenaAllocator<std::string>(&arena)};
+    for (int i = 0; i < 100; i++) {
+      list.emplace_back(std::to_string(i));
+    }
+    list.remove_if([](const std::string& value) { return value.size() == 1; });
+    EXPECT_EQ(90, list.size());
+    EXPECT_EQ("10", list.front());
+  }
+  EXPECT_LT(0, arena.slabCount());
+
+  // Without an arena the allocator uses the heap.
+  HeaderMapArenaAllocator<int> heap_allocator;
+  EXPECT_EQ(nullptr, heap_allocator.arena());
+  int* value = heap_allocator.allocate(1);
+  heap_allocator.deallocate(value, 1);
+  EXPECT_TRUE(heap_allocator == HeaderMapArenaAllocator<char>());
+  EXPECT_TRUE(heap_allocator != HeaderMapArenaAllocator<char>(&arena));
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -1,10 +1,20 @@
 #include "common/http/header_map_impl.h"
 
+#include "test/test_common/allocation_counter.h"
+
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
 namespace Http {
 
+/**
+ * @param state supplies the benchmark state. A non zero first argument selects arena allocation.
+ * @return HeaderMapArenaSharedPtr a new arena if the benchmark runs in arena mode, else nullptr.
+ */
+static HeaderMapArenaSharedPtr maybeCreateArena(benchmark::State& state) {
+  return state.range(0) != 0 ? std::make_shared<HeaderMapArena>() : nullptr;
+}
+
 /**
  * Add several dummy headers to a HeaderMap.
  * @param num_headers the number of dummy headers to add.
@@ -16,14 +26,18 @@ static void addDummyHeaders(HeaderMap& headers, size_t num_headers) {
   }
 }
 
-/** Measure the construction/destruction speed of HeaderMapImpl.*/
+/**
+ * Measure the construction/destruction speed of HeaderMapImpl. The Arg selects whether the map is
+ * allocated from a new arena (1) or the heap (0), as a stream's first header map would be.
+ */
 static void HeaderMapImplCreate(benchmark::State& state) {
+  AllocationCounter counter(state);
   for (auto _ : state) {
-    HeaderMapImpl headers;
+    HeaderMapImpl headers(maybeCreateArena(state));
     benchmark::DoNotOptimize(headers.size());
   }
 }
-BENCHMARK(HeaderMapImplCreate);
+BENCHMARK(HeaderMapImplCreate)->Arg(0)->Arg(1);
 
 /**
  * Measure the speed of setting/overwriting a header value. The numeric Arg passed
@@ -180,7 +194,8 @@ BENCHMARK(HeaderMapImplRemoveInline)->Arg(0)->Arg(1)->Arg(10)->Arg(50);
 
 /**
  * Measure the speed of creating a HeaderMapImpl and populating it with a realistic
- * set of response headers.
+ * set of response headers. The Arg selects whether the entries are allocated from a
+ * per-stream arena (1) or the heap (0).
  */
 static void HeaderMapImplPopulate(benchmark::State& state) {
   const std::pair<LowerCaseString, std::string> headers_to_add[] = {
@@ -195,15 +210,67 @@ static void HeaderMapImplPopulate(benchmark::State& state) {
       {LowerCaseString("set-cookie"), "_cookie1=12345678; path = /; secure"},
       {LowerCaseString("set-cookie"), "_cookie2=12345678; path = /; secure"},
   };
+  AllocationCounter counter(state);
   for (auto _ : state) {
-    HeaderMapImpl headers;
+    HeaderMapImpl headers(maybeCreateArena(state));
     for (const auto& key_value : headers_to_add) {
       headers.addReference(key_value.first, key_value.second);
     }
     benchmark::DoNotOptimize(headers.size());
   }
 }
-BENCHMARK(HeaderMapImplPopulate);
+BENCHMARK(HeaderMapImplPopulate)->Arg(0)->Arg(1);
+
+/**
+ * Measure the lifetime of the header maps of a typical gRPC stream: request headers, response
+ * headers and response trailers, all copied in as a codec would. The Arg selects whether the
+ * maps share a per-stream arena (1) or allocate from the heap (0).
+ */
+static void HeaderMapImplStream(benchmark::State& state) {
+  const std::pair<std::string, std::string> request_headers[] = {
+      {":method", "POST"},
+      {":scheme", "https"},
+      {":path", "/envoy.service.ratelimit.v2.RateLimitService/ShouldRateLimit"},
+      {":authority", "ratelimit.example.com"},
+      {"content-type", "application/grpc"},
+      {"te", "trailers"},
+      {"user-agent", "grpc-c++/1.21.0"},
+      {"grpc-timeout", "20m"},
+      {"x-request-id", "6d2a8f8e-9f2b-4c53-9a6e-0f8bfa1a6f17"},
+  };
+  const std::pair<std::string, std::string> response_headers[] = {
+      {":status", "200"},
+      {"content-type", "application/grpc"},
+      {"date", "Wed, 23 Jan 2019 04:00:00 GMT"},
+      {"server", "envoy"},
+  };
+  const std::pair<std::string, std::string> response_trailers[] = {
+      {"grpc-status", "0"},
+      {"grpc-message", ""},
+  };
+  auto copy_into = [](HeaderMapImpl& headers, const auto& headers_to_add) {
+    for (const auto& key_value : headers_to_add) {
+      HeaderString key;
+      key.setCopy(key_value.first.data(), key_value.first.size());
+      HeaderString value;
+      value.setCopy(key_value.second.data(), key_value.second.size());
+      headers.addViaMove(std::move(key), std::move(value));
+    }
+  };
+
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    HeaderMapArenaSharedPtr arena = maybeCreateArena(state);
+    HeaderMapImpl request(arena);
+    copy_into(request, request_headers);
+    HeaderMapImpl response(arena);
+    copy_into(response, response_headers);
+    HeaderMapImpl trailers(arena);
+    copy_into(trailers, response_trailers);
+    benchmark::DoNotOptimize(request.size() + response.size() + trailers.size());
+  }
+}
+BENCHMARK(HeaderMapImplStream)->Arg(0)->Arg(1);
 
 } // namespace Http
 } // namespace Envoy
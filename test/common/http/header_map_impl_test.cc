@@ -1041,5 +1041,88 @@ TEST(HeaderMapImplTest, TestHeaderMapImplyCopy) {
   EXPECT_EQ("bar", baz.get(LowerCaseString("foo"))->value().getStringView());
 }
 
+// Once a map grows large enough, lookups by key go through a hash index which must be kept in sync
+// with the list of headers.
+TEST(HeaderMapImplTest, LargeMapIndex) {
+  HeaderMapImpl headers;
+  for (int i = 0; i < 32; i++) {
+    headers.addCopy(LowerCaseString(fmt::format("x-custom-{}", i)), std::to_string(i));
+  }
+  headers.addCopy(LowerCaseString("x-custom-1"), "second");
+  headers.addCopy(LowerCaseString("x-custom-1"), "third");
+  headers.insertContentType().value(std::string("text/plain"));
+  EXPECT_EQ(35, headers.size());
+
+  EXPECT_EQ("31", headers.get(LowerCaseString("x-custom-31"))->value().getStringView());
+  EXPECT_EQ("1", headers.get(LowerCaseString("x-custom-1"))->value().getStringView());
+  EXPECT_EQ("text/plain", headers.get(Headers::get().ContentType)->value().getStringView());
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("x-custom-32")));
+
+  headers.removePrefix(LowerCaseString("x-custom-10"));
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("x-custom-10")));
+  EXPECT_EQ("1", headers.get(LowerCaseString("x-custom-1"))->value().getStringView());
+
+  // Removes all entries of the key, which requires re-keying the index as the entry whose key the
+  // index points to goes away first.
+  headers.remove(LowerCaseString("x-custom-1"));
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("x-custom-1")));
+  EXPECT_EQ(31, headers.size());
+
+  headers.setReferenceKey(LowerCaseString("x-custom-2"), "two");
+  EXPECT_EQ("two", headers.get(LowerCaseString("x-custom-2"))->value().getStringView());
+  EXPECT_EQ(31, headers.size());
+
+  headers.removePrefix(LowerCaseString("x-custom"));
+  EXPECT_EQ(1, headers.size());
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("x-custom-3")));
+  headers.addCopy(LowerCaseString("x-custom-3"), "again");
+  EXPECT_EQ("again", headers.get(LowerCaseString("x-custom-3"))->value().getStringView());
+}
+
+// Header maps allocated from an arena behave exactly like heap allocated ones, and keep the arena
+// alive after the last external reference to it is gone.
+TEST(HeaderMapImplTest, ArenaAllocated) {
+  auto arena = std::make_shared<HeaderMapArena>();
+  HeaderMapArena* raw_arena = arena.get();
+  auto headers = std::make_unique<HeaderMapImpl>(arena);
+  HeaderMapImpl trailers(arena);
+  arena.reset();
+  EXPECT_EQ(0, raw_arena->slabCount());
+
+  headers->addCopy(LowerCaseString("hello"), "world");
+  headers->insertPath().value(std::string("/"));
+  headers->insertHost().value(std::string("host"));
+  trailers.addCopy(LowerCaseString("grpc-status"), "0");
+  EXPECT_EQ(1, raw_arena->slabCount());
+
+  std::vector<std::string> keys;
+  headers->iterate(
+      [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+        static_cast<std::vector<std::string>*>(context)->emplace_back(
+            header.key().getStringView());
+        return HeaderMap::Iterate::Continue;
+      },
+      &keys);
+  EXPECT_EQ((std::vector<std::string>{":path", ":authority", "hello"}), keys);
+
+  // Removed entries are recycled rather than growing the arena.
+  const uint64_t reserved = raw_arena->bytesReserved();
+  for (int i = 0; i < 1000; i++) {
+    headers->addCopy(LowerCaseString("foo"), "bar");
+    headers->remove(LowerCaseString("foo"));
+  }
+  EXPECT_EQ(reserved, raw_arena->bytesReserved());
+
+  headers->removePath();
+  EXPECT_EQ(nullptr, headers->Path());
+  EXPECT_EQ(2, headers->size());
+
+  const HeaderMap& to_copy = *headers;
+  HeaderMapImpl copy(to_copy);
+  EXPECT_TRUE(copy == *headers);
+  headers.reset();
+  EXPECT_EQ("0", trailers.get(LowerCaseString("grpc-status"))->value().getStringView());
+}
+
 } // namespace Http
 } // namespace Envoy
@@ -0,0 +1,86 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+
+#include "common/common/fmt.h"
+#include "common/http/http1/http_parser_impl.h"
+#include "common/http/http1/vectorized_parser.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+// Callbacks that only count the bytes handed out, so that the benchmark measures the parser.
+class CountingCallbacks : public ParserCallbacks {
+public:
+  void onMessageBeginBase() override {}
+  void onUrl(const char*, size_t length) override { bytes_ += length; }
+  void onHeaderField(const char*, size_t length) override { bytes_ += length; }
+  void onHeaderValue(const char*, size_t length) override { bytes_ += length; }
+  int onHeadersCompleteBase() override { return 0; }
+  void onBody(const char*, size_t length) override { bytes_ += length; }
+  void onMessageCompleteBase() override {}
+
+  uint64_t bytes_{};
+};
+
+// A browser like request followed by extra_headers headers with 64 byte values.
+std::string makeRequest(int64_t extra_headers) {
+  std::string request =
+      "GET /static/js/application.bundle.min.js?version=1a2b3c4d5e6f HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+      "Chrome/74.0.3729.131 Safari/537.36\r\n"
+      "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/webp,*/*;q=0.8\r\n"
+      "Accept-Encoding: gzip, deflate, br\r\n"
+      "Accept-Language: en-US,en;q=0.9\r\n"
+      "Cookie: session=0123456789abcdef0123456789abcdef; tracking=fedcba9876543210\r\n";
+  for (int64_t i = 0; i < extra_headers; i++) {
+    request += fmt::format("x-custom-header-{}: {}\r\n", i, std::string(64, 'v'));
+  }
+  request += "\r\n";
+  return request;
+}
+
+template <class ParserFactory>
+void parseRequests(benchmark::State& state, ParserFactory factory) {
+  const std::string request = makeRequest(state.range(0));
+  CountingCallbacks callbacks;
+  for (auto _ : state) {
+    auto parser = factory(callbacks);
+    parser->execute(request.data(), request.size());
+  }
+  benchmark::DoNotOptimize(callbacks.bytes_);
+  state.SetBytesProcessed(state.iterations() * request.size());
+}
+
+static void BM_HttpParser(benchmark::State& state) {
+  parseRequests(state, [](ParserCallbacks& callbacks) {
+    return std::make_unique<HttpParserImpl>(HTTP_REQUEST, callbacks);
+  });
+}
+BENCHMARK(BM_HttpParser)->Arg(0)->Arg(10)->Arg(50);
+
+static void BM_VectorizedParser(benchmark::State& state) {
+  parseRequests(state, [](ParserCallbacks& callbacks) {
+    return std::make_unique<VectorizedRequestParser>(callbacks);
+  });
+}
+BENCHMARK(BM_VectorizedParser)->Arg(0)->Arg(10)->Arg(50);
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,379 @@
+#include <string>
+#include <vector>
+
+#include "common/http/http1/vectorized_parser.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// Records the parser callbacks, merging consecutive fragments of the same element.
+class RecordingCallbacks : public ParserCallbacks {
+public:
+  void onMessageBeginBase() override { events_.push_back("begin"); }
+  void onUrl(const char* data, size_t length) override { append("url", data, length); }
+  void onHeaderField(const char* data, size_t length) override { append("field", data, length); }
+  void onHeaderValue(const char* data, size_t length) override { append("value", data, length); }
+  int onHeadersCompleteBase() override {
+    events_.push_back("headers");
+    if (pause_on_headers_complete_) {
+      parser_->pause();
+    }
+    return headers_complete_rc_;
+  }
+  void onBody(const char* data, size_t length) override { append("body", data, length); }
+  void onMessageCompleteBase() override {
+    events_.push_back("complete");
+    parser_->pause();
+  }
+
+  std::vector<std::string> events_;
+  Parser* parser_{};
+  int headers_complete_rc_{};
+  bool pause_on_headers_complete_{};
+
+private:
+  void append(const std::string& type, const char* data, size_t length) {
+    const std::string prefix = type + ":";
+    if (events_.empty() || events_.back().compare(0, prefix.size(), prefix) != 0) {
+      events_.push_back(prefix);
+    }
+    events_.back().append(data, length);
+  }
+};
+
+class VectorizedRequestParserTest : public testing::Test {
+public:
+  VectorizedRequestParserTest() : parser_(callbacks_) { callbacks_.parser_ = &parser_; }
+
+  // Parses the input, resuming after each message.
+  size_t parse(const std::string& input) {
+    size_t consumed = 0;
+    while (consumed < input.size()) {
+      parser_.resume();
+      const size_t length = input.size() - consumed;
+      const size_t rc = parser_.execute(input.data() + consumed, length);
+      consumed += rc;
+      if (parser_.error() != HPE_OK || (rc == 0 && length > 0)) {
+        break;
+      }
+    }
+    return consumed;
+  }
+
+  void expectError(const std::string& input, http_errno error) {
+    parse(input);
+    EXPECT_EQ(error, parser_.error()) << input;
+  }
+
+  RecordingCallbacks callbacks_;
+  VectorizedRequestParser parser_;
+};
+
+TEST_F(VectorizedRequestParserTest, SimpleRequest) {
+  const std::string request =
+      "GET /hello?a=b HTTP/1.1\r\nHost: example.com\r\nEmpty:\r\nx-Spaces:  a b \r\n\r\n";
+  EXPECT_EQ(request.size(), parse(request));
+  EXPECT_EQ(HPE_OK, parser_.error());
+  EXPECT_EQ(HTTP_GET, parser_.method());
+  EXPECT_TRUE(parser_.isHttp11());
+  EXPECT_FALSE(parser_.isChunked());
+  EXPECT_FALSE(parser_.contentLength().has_value());
+  EXPECT_EQ((std::vector<std::string>{"begin", "url:/hello?a=b", "field:Host", "value:example.com",
+                                      "field:Empty", "value:", "field:x-Spaces", "value:a b ",
+                                      "headers", "complete"}),
+            callbacks_.events_);
+}
+
+TEST_F(VectorizedRequestParserTest, Methods) {
+  for (const std::string method : {"DELETE", "GET", "HEAD", "POST", "PUT", "CONNECT", "OPTIONS",
+                                   "TRACE", "PATCH", "M-SEARCH", "UNSUBSCRIBE"}) {
+    RecordingCallbacks callbacks;
+    VectorizedRequestParser parser(callbacks);
+    callbacks.parser_ = &parser;
+    const std::string request = absl::StrCat(method, " /path HTTP/1.0\r\n\r\n");
+    EXPECT_EQ(request.size(), parser.execute(request.data(), request.size()));
+    EXPECT_EQ(HPE_OK, parser.error());
+    EXPECT_EQ(method, http_method_str(parser.method()));
+    EXPECT_FALSE(parser.isHttp11());
+  }
+}
+
+TEST_F(VectorizedRequestParserTest, ContentLengthBody) {
+  const std::string request =
+      "POST / HTTP/1.1\r\nContent-Length: 5 \r\n\r\n12345\r\nGET / HTTP/1.1\r\n\r\n";
+  const size_t first_request_size = request.find("\r\nGET");
+  EXPECT_EQ(first_request_size, parser_.execute(request.data(), request.size()));
+  EXPECT_EQ(5, parser_.contentLength().value());
+  EXPECT_EQ((std::vector<std::string>{"begin", "url:/", "field:Content-Length", "value:5 ",
+                                      "headers", "body:12345", "complete"}),
+            callbacks_.events_);
+
+  // Empty lines in between requests are skipped.
+  callbacks_.events_.clear();
+  EXPECT_EQ(request.size() - first_request_size, parse(request.substr(first_request_size)));
+  EXPECT_EQ(HPE_OK, parser_.error());
+  EXPECT_EQ(HTTP_GET, parser_.method());
+  EXPECT_EQ((std::vector<std::string>{"begin", "url:/", "headers", "complete"}),
+            callbacks_.events_);
+}
+
+TEST_F(VectorizedRequestParserTest, ChunkedBody) {
+  const std::string request = "POST / HTTP/1.1\r\nTransfer-Encoding: Chunked\r\n\r\n"
+                              "6\r\nHello \r\na;ext\r\nWorld12345\r\n0\r\ntrailer: x\r\n\r\n";
+  EXPECT_EQ(request.size(), parse(request));
+  EXPECT_EQ(HPE_OK, parser_.error());
+  EXPECT_TRUE(parser_.isChunked());
+  EXPECT_EQ((std::vector<std::string>{"begin", "url:/", "field:Transfer-Encoding",
+                                      "value:Chunked", "headers", "body:Hello World12345",
+                                      "complete"}),
+            callbacks_.events_);
+}
+
+TEST_F(VectorizedRequestParserTest, TransferEncodingOtherThanChunked) {
+  const std::string request = "POST / HTTP/1.1\r\nTransfer-Encoding: gzip, chunked\r\n\r\n";
+  EXPECT_EQ(request.size(), parse(request));
+  EXPECT_FALSE(parser_.isChunked());
+  EXPECT_EQ("complete", callbacks_.events_.back());
+}
+
+TEST_F(VectorizedRequestParserTest, Http09) {
+  const std::string request = "GET /\r\n\r\n";
+  EXPECT_EQ(request.size(), parse(request));
+  EXPECT_EQ(HPE_OK, parser_.error());
+  EXPECT_FALSE(parser_.isHttp11());
+}
+
+TEST_F(VectorizedRequestParserTest, AbsoluteUrl) {
+  const std::string request = "GET http://example.com:8080/path HTTP/1.1\r\n\r\n";
+  EXPECT_EQ(request.size(), parse(request));
+  EXPECT_EQ("url:http://example.com:8080/path", callbacks_.events_[1]);
+}
+
+// Splitting the request at any point and in any slice size yields the same elements.
+TEST_F(VectorizedRequestParserTest, AllSliceSizes) {
+  const std::string request =
+      "POST /a/rather/long/path/to/exercise/the/vector/loop?with=a&query=string HTTP/1.1\r\n"
+      "Host: example.com\r\nUser-Agent: a user agent that is longer than a vector register\r\n"
+      "content-length: 10\r\n\r\n0123456789";
+  parse(request);
+  const std::vector<std::string> expected = callbacks_.events_;
+  ASSERT_EQ("complete", expected.back());
+
+  for (size_t slice_size = 1; slice_size < request.size(); slice_size++) {
+    RecordingCallbacks callbacks;
+    VectorizedRequestParser parser(callbacks);
+    callbacks.parser_ = &parser;
+    size_t consumed = 0;
+    while (consumed < request.size()) {
+      const size_t length = std::min(slice_size, request.size() - consumed);
+      EXPECT_EQ(length, parser.execute(request.data() + consumed, length));
+      consumed += length;
+    }
+    EXPECT_EQ(expected, callbacks.events_) << slice_size;
+  }
+}
+
+TEST_F(VectorizedRequestParserTest, PauseOnHeadersComplete) {
+  callbacks_.pause_on_headers_complete_ = true;
+  const std::string request = "POST / HTTP/1.1\r\ncontent-length: 2\r\n\r\nab";
+  EXPECT_EQ(request.size() - 2, parser_.execute(request.data(), request.size()));
+  EXPECT_EQ("headers", callbacks_.events_.back());
+
+  // Paused parsers do not consume anything.
+  EXPECT_EQ(0, parser_.execute(request.data() + request.size() - 2, 2));
+  parser_.resume();
+  EXPECT_EQ(2, parser_.execute(request.data() + request.size() - 2, 2));
+  EXPECT_EQ("complete", callbacks_.events_.back());
+}
+
+TEST_F(VectorizedRequestParserTest, PauseOnHeadersCompleteWithoutBody) {
+  callbacks_.pause_on_headers_complete_ = true;
+  const std::string request = "GET / HTTP/1.1\r\n\r\n";
+  EXPECT_EQ(request.size(), parser_.execute(request.data(), request.size()));
+  EXPECT_EQ("headers", callbacks_.events_.back());
+
+  // The message completes on the next call, even if there is no more data.
+  parser_.resume();
+  EXPECT_EQ(0, parser_.execute(nullptr, 0));
+  EXPECT_EQ(HPE_OK, parser_.error());
+  EXPECT_EQ("complete", callbacks_.events_.back());
+}
+
+TEST_F(VectorizedRequestParserTest, UpgradeStopsParsing) {
+  callbacks_.headers_complete_rc_ = 2;
+  const std::string request = "GET / HTTP/1.1\r\ncontent-length: 5\r\n\r\nabcde";
+  EXPECT_EQ(request.size() - 5, parse(request));
+  EXPECT_EQ("complete", callbacks_.events_.back());
+}
+
+TEST_F(VectorizedRequestParserTest, SkipBody) {
+  callbacks_.headers_complete_rc_ = 1;
+  const std::string request = "POST / HTTP/1.1\r\ncontent-length: 5\r\n\r\n";
+  EXPECT_EQ(request.size(), parse(request));
+  EXPECT_EQ("complete", callbacks_.events_.back());
+}
+
+TEST_F(VectorizedRequestParserTest, EndOfConnection) {
+  EXPECT_EQ(0, parser_.execute(nullptr, 0));
+  EXPECT_EQ(HPE_OK, parser_.error());
+
+  const std::string request = "GET / HTTP/1.1\r\n";
+  parser_.execute(request.data(), request.size());
+  EXPECT_EQ(0, parser_.execute(nullptr, 0));
+  EXPECT_EQ(HPE_INVALID_EOF_STATE, parser_.error());
+}
+
+TEST_F(VectorizedRequestParserTest, InvalidMethod) {
+  expectError("get / HTTP/1.1\r\n\r\n", HPE_INVALID_METHOD);
+  EXPECT_TRUE(callbacks_.events_.empty());
+}
+
+TEST_F(VectorizedRequestParserTest, UnknownMethod) {
+  expectError("FOO / HTTP/1.1\r\n\r\n", HPE_INVALID_METHOD);
+  EXPECT_EQ("begin", callbacks_.events_[0]);
+}
+
+TEST_F(VectorizedRequestParserTest, InvalidUrl) {
+  expectError("GET www.example.com HTTP/1.1\r\n\r\n", HPE_INVALID_URL);
+}
+
+TEST_F(VectorizedRequestParserTest, ControlCharacterInUrl) {
+  expectError(absl::StrCat("GET /", std::string(1, '\x7f'), " HTTP/1.1\r\n\r\n"),
+              HPE_INVALID_URL);
+}
+
+TEST_F(VectorizedRequestParserTest, InvalidVersion) {
+  expectError("GET / HTTP/1.x\r\n\r\n", HPE_INVALID_VERSION);
+}
+
+TEST_F(VectorizedRequestParserTest, InvalidVersionConstant) {
+  expectError("GET / HTTPS/1.1\r\n\r\n", HPE_INVALID_CONSTANT);
+}
+
+TEST_F(VectorizedRequestParserTest, LfExpected) {
+  expectError("GET / HTTP/1.1\rX\n\r\n", HPE_LF_EXPECTED);
+}
+
+TEST_F(VectorizedRequestParserTest, InvalidHeaderName) {
+  expectError("GET / HTTP/1.1\r\nbad header: value\r\n\r\n", HPE_INVALID_HEADER_TOKEN);
+}
+
+TEST_F(VectorizedRequestParserTest, ObsoleteLineFolding) {
+  expectError("GET / HTTP/1.1\r\nfolded: a\r\n b\r\n\r\n", HPE_INVALID_HEADER_TOKEN);
+}
+
+TEST_F(VectorizedRequestParserTest, ControlCharacterInHeaderValue) {
+  expectError("GET / HTTP/1.1\r\nfoo: a\x01"
+              "b\r\n\r\n", HPE_INVALID_HEADER_TOKEN);
+}
+
+TEST_F(VectorizedRequestParserTest, DelInHeaderValue) {
+  expectError("GET / HTTP/1.1\r\nfoo: a\x7f\r\n\r\n", HPE_INVALID_HEADER_TOKEN);
+}
+
+TEST_F(VectorizedRequestParserTest, ControlCharacterInTrailer) {
+  expectError("POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\n0\r\nfoo: \x1f\r\n\r\n",
+              HPE_INVALID_HEADER_TOKEN);
+}
+
+TEST_F(VectorizedRequestParserTest, TabInHeaderValue) {
+  const std::string request = "GET / HTTP/1.1\r\nfoo: a\tb\r\n\r\n";
+  EXPECT_EQ(request.size(), parse(request));
+  EXPECT_EQ(HPE_OK, parser_.error());
+}
+
+TEST_F(VectorizedRequestParserTest, InvalidContentLength) {
+  expectError("POST / HTTP/1.1\r\ncontent-length: 1 2\r\n\r\n", HPE_INVALID_CONTENT_LENGTH);
+}
+
+TEST_F(VectorizedRequestParserTest, ContentLengthOverflow) {
+  expectError("POST / HTTP/1.1\r\ncontent-length: 18446744073709551616\r\n\r\n",
+              HPE_INVALID_CONTENT_LENGTH);
+}
+
+TEST_F(VectorizedRequestParserTest, DuplicateContentLength) {
+  expectError("POST / HTTP/1.1\r\ncontent-length: 1\r\nContent-Length: 1\r\n\r\n",
+              HPE_UNEXPECTED_CONTENT_LENGTH);
+}
+
+TEST_F(VectorizedRequestParserTest, ContentLengthAndChunked) {
+  expectError("POST / HTTP/1.1\r\ncontent-length: 1\r\ntransfer-encoding: chunked\r\n\r\n",
+              HPE_UNEXPECTED_CONTENT_LENGTH);
+  EXPECT_EQ("value:chunked", callbacks_.events_.back());
+}
+
+TEST_F(VectorizedRequestParserTest, InvalidChunkSize) {
+  expectError("POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\nx\r\n", HPE_INVALID_CHUNK_SIZE);
+}
+
+TEST_F(VectorizedRequestParserTest, ChunkSizeOverflow) {
+  expectError("POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\n10000000000000000\r\n",
+              HPE_INVALID_CHUNK_SIZE);
+}
+
+TEST_F(VectorizedRequestParserTest, MissingCrlfAfterChunk) {
+  expectError("POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\n1\r\nab\r\n", HPE_STRICT);
+}
+
+TEST_F(VectorizedRequestParserTest, FindUrlEnd) {
+  // Cover both the vector loop and the scalar tail, including bytes with the high bit set.
+  for (size_t position = 0; position < 40; position++) {
+    std::string url(40, 'a');
+    url[position / 2] = '\x80';
+    url[position] = ' ';
+    EXPECT_EQ(url.data() + position, VectorizedRequestParser::findUrlEnd(url.data(),
+                                                                        url.data() + url.size()));
+    url[position] = '\x7f';
+    EXPECT_EQ(url.data() + position, VectorizedRequestParser::findUrlEnd(url.data(),
+                                                                        url.data() + url.size()));
+  }
+  const std::string url(40, '\xff');
+  EXPECT_EQ(url.data() + url.size(),
+            VectorizedRequestParser::findUrlEnd(url.data(), url.data() + url.size()));
+}
+
+TEST_F(VectorizedRequestParserTest, FindLineEnd) {
+  for (size_t position = 0; position < 40; position++) {
+    std::string line(40, '\0');
+    line[position] = position % 2 == 0 ? '\r' : '\n';
+    EXPECT_EQ(line.data() + position,
+              VectorizedRequestParser::findLineEnd(line.data(), line.data() + line.size()));
+  }
+  const std::string line(40, 'a');
+  EXPECT_EQ(line.data() + line.size(),
+            VectorizedRequestParser::findLineEnd(line.data(), line.data() + line.size()));
+}
+
+TEST_F(VectorizedRequestParserTest, FindHeaderValueEnd) {
+  // Cover both the vector loop and the scalar tail, including bytes with the high bit set, NUL
+  // and HTAB, which are not rejected.
+  for (const char c : {'\x01', '\x08', '\n', '\r', '\x1f', '\x7f'}) {
+    for (size_t position = 0; position < 40; position++) {
+      std::string value(40, 'a');
+      value[position / 3] = '\x80';
+      value[position / 2] = '\t';
+      value[position / 4] = '\0';
+      value[position] = c;
+      EXPECT_EQ(value.data() + position,
+                VectorizedRequestParser::findHeaderValueEnd(value.data(),
+                                                            value.data() + value.size()));
+    }
+  }
+  std::string value;
+  for (int c = 0x80; c <= 0xff; c++) {
+    value.push_back(c);
+  }
+  value.append(" \t\0~!");
+  EXPECT_EQ(value.data() + value.size(),
+            VectorizedRequestParser::findHeaderValueEnd(value.data(), value.data() + value.size()));
+}
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -9,6 +9,7 @@
 #include "common/http/http2/codec_impl.h"
 
 #include "test/common/http/common.h"
+#include "test/mocks/buffer/mocks.h"
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/test_common/printers.h"
@@ -385,6 +386,73 @@ TEST_P(Http2CodecImplTest, TrailingHeadersLargeBody) {
   response_encoder_->encodeTrailers(TestHeaderMapImpl{{"trailing", "header"}});
 }
 
+// DATA frames end at the end of a slice of the body when one fits in the frame, so that the slices
+// are moved to the connection rather than copied.
+TEST_P(Http2CodecImplTest, DataFramesEndAtSliceBoundaries) {
+  initialize();
+
+  TestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  request_encoder_->encodeHeaders(request_headers, false);
+
+  Buffer::OwnedImpl body;
+  Buffer::OwnedImpl small_slice(std::string(10000, 'a'));
+  body.move(small_slice);
+  Buffer::OwnedImpl large_slice(std::string(20000, 'b'));
+  body.move(large_slice);
+
+  // The large slice does not fit in a frame of the default maximum size of 16384 bytes, so it is
+  // split.
+  InSequence s;
+  EXPECT_CALL(request_decoder_, decodeData(BufferStringEqual(std::string(10000, 'a')), false));
+  EXPECT_CALL(request_decoder_, decodeData(BufferStringEqual(std::string(16384, 'b')), false));
+  EXPECT_CALL(request_decoder_, decodeData(BufferStringEqual(std::string(3616, 'b')), true));
+  request_encoder_->encodeData(body, true);
+}
+
+TEST_P(Http2CodecImplTest, DataFrameOfManySmallSlices) {
+  initialize();
+
+  TestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  request_encoder_->encodeHeaders(request_headers, false);
+
+  Buffer::OwnedImpl body;
+  for (int i = 0; i < 32; i++) {
+    Buffer::OwnedImpl slice(std::string(100, 'a'));
+    body.move(slice);
+  }
+
+  // All the slices fit in a single frame.
+  EXPECT_CALL(request_decoder_, decodeData(BufferStringEqual(std::string(3200, 'a')), true));
+  request_encoder_->encodeData(body, true);
+}
+
+TEST_P(Http2CodecImplTest, DataFramesOfLargeBodyOfManySmallSlices) {
+  initialize();
+
+  TestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  request_encoder_->encodeHeaders(request_headers, false);
+
+  Buffer::OwnedImpl body;
+  for (int i = 0; i < 5000; i++) {
+    Buffer::OwnedImpl slice(std::string(10, 'a'));
+    body.move(slice);
+  }
+
+  // Too many slices are needed to fill a frame, so the frames are full instead of ending at a
+  // slice boundary.
+  InSequence s;
+  EXPECT_CALL(request_decoder_, decodeData(BufferStringEqual(std::string(16384, 'a')), false))
+      .Times(3);
+  EXPECT_CALL(request_decoder_, decodeData(BufferStringEqual(std::string(848, 'a')), true));
+  request_encoder_->encodeData(body, true);
+}
+
 TEST_P(Http2CodecImplTest, SmallMetadataVecTest) {
   allow_metadata_ = true;
   initialize();
@@ -0,0 +1,65 @@
+#include "common/network/connection_balancer_impl.h"
+
+#include "test/mocks/network/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+TEST(ExactConnectionBalancerImplTest, PicksHandlerWithFewestConnections) {
+  NiceMock<MockBalancedConnectionHandler> handler1;
+  NiceMock<MockBalancedConnectionHandler> handler2;
+  NiceMock<MockBalancedConnectionHandler> handler3;
+  ExactConnectionBalancerImpl balancer;
+  balancer.registerHandler(handler1);
+  balancer.registerHandler(handler2);
+  balancer.registerHandler(handler3);
+
+  EXPECT_CALL(handler1, numConnections()).WillRepeatedly(Return(2));
+  EXPECT_CALL(handler2, numConnections()).WillRepeatedly(Return(0));
+  EXPECT_CALL(handler3, numConnections()).WillRepeatedly(Return(1));
+  EXPECT_CALL(handler2, incNumConnections());
+  EXPECT_EQ(&handler2, &balancer.pickTargetHandler(handler1));
+
+  // The first of the handlers with the fewest connections is picked, including the current one.
+  EXPECT_CALL(handler2, numConnections()).WillRepeatedly(Return(2));
+  EXPECT_CALL(handler3, numConnections()).WillRepeatedly(Return(2));
+  EXPECT_CALL(handler1, incNumConnections());
+  EXPECT_EQ(&handler1, &balancer.pickTargetHandler(handler1));
+}
+
+TEST(ExactConnectionBalancerImplTest, UnregisteredHandlerNotPicked) {
+  NiceMock<MockBalancedConnectionHandler> handler1;
+  NiceMock<MockBalancedConnectionHandler> handler2;
+  ExactConnectionBalancerImpl balancer;
+  balancer.registerHandler(handler1);
+  balancer.registerHandler(handler2);
+
+  EXPECT_CALL(handler1, numConnections()).WillRepeatedly(Return(5));
+  EXPECT_CALL(handler2, numConnections()).WillRepeatedly(Return(0));
+  balancer.unregisterHandler(handler2);
+  EXPECT_CALL(handler1, incNumConnections());
+  EXPECT_CALL(handler2, incNumConnections()).Times(0);
+  EXPECT_EQ(&handler1, &balancer.pickTargetHandler(handler1));
+}
+
+TEST(NopConnectionBalancerImplTest, PicksCurrentHandler) {
+  NiceMock<MockBalancedConnectionHandler> handler1;
+  NiceMock<MockBalancedConnectionHandler> handler2;
+  NopConnectionBalancerImpl balancer;
+  balancer.registerHandler(handler1);
+  balancer.registerHandler(handler2);
+
+  EXPECT_CALL(handler2, incNumConnections());
+  EXPECT_EQ(&handler2, &balancer.pickTargetHandler(handler2));
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -1414,6 +1414,31 @@ TEST_F(MockTransportConnectionImplTest, ObjectDestructOrder) {
   file_ready_cb_(Event::FileReadyType::Read);
 }
 
+// Test that the socket is only handed out when data can bypass the connection.
+TEST_F(MockTransportConnectionImplTest, RawIoHandle) {
+  EXPECT_CALL(*transport_socket_, passthrough()).WillRepeatedly(Return(true));
+  EXPECT_EQ(&transport_socket_callbacks_->ioHandle(), connection_->rawIoHandle());
+
+  // The filter consuming the data is allowed, other filters are not.
+  connection_->addReadFilter(std::make_shared<Network::FakeReadFilter>());
+  EXPECT_NE(nullptr, connection_->rawIoHandle());
+  connection_->addWriteFilter(std::make_shared<NiceMock<MockWriteFilter>>());
+  EXPECT_EQ(nullptr, connection_->rawIoHandle());
+}
+
+TEST_F(MockTransportConnectionImplTest, RawIoHandleTransportSocketNotPassthrough) {
+  EXPECT_CALL(*transport_socket_, passthrough()).WillRepeatedly(Return(false));
+  EXPECT_EQ(nullptr, connection_->rawIoHandle());
+}
+
+TEST_F(MockTransportConnectionImplTest, RawIoHandleWithBufferedData) {
+  EXPECT_CALL(*transport_socket_, passthrough()).WillRepeatedly(Return(true));
+  EXPECT_CALL(*file_event_, activate(Event::FileReadyType::Write));
+  Buffer::OwnedImpl data("hello");
+  connection_->write(data, false);
+  EXPECT_EQ(nullptr, connection_->rawIoHandle());
+}
+
 // Test that BytesSentCb is invoked at the correct times
 TEST_F(MockTransportConnectionImplTest, BytesSentCallback) {
   uint64_t bytes_sent = 0;
@@ -0,0 +1,279 @@
+#include <sys/socket.h>
+
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/buffer/watermark_buffer.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/io_uring_impl.h"
+#include "common/network/raw_buffer_socket.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class MockWriteBatchCallbacks : public WriteBatchCallbacks {
+public:
+  void onBatchedWrite(Api::IoCallUint64Result&& result) override {
+    onBatchedWrite_(result.ok() ? result.rc_ : 0,
+                    result.ok() ? Api::IoError::IoErrorCode::NoSupport
+                                : result.err_->getErrorCode());
+  }
+
+  MOCK_METHOD2(onBatchedWrite_, void(uint64_t bytes_written, Api::IoError::IoErrorCode error));
+};
+
+// A connected pair of non-blocking stream sockets.
+struct SocketPair {
+  SocketPair() {
+    int fds[2];
+    RELEASE_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0, "");
+    local_ = std::make_unique<IoSocketHandleImpl>(fds[0]);
+    remote_ = std::make_unique<IoSocketHandleImpl>(fds[1]);
+  }
+
+  std::string readRemote() {
+    Buffer::OwnedImpl buffer;
+    while (buffer.read(*remote_, 65536).rc_ > 0) {
+    }
+    return buffer.toString();
+  }
+
+  IoHandlePtr local_;
+  IoHandlePtr remote_;
+};
+
+class IoUringWriteBatchImplTest : public testing::Test {
+protected:
+  IoUringWriteBatchImplTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher()),
+        batch_(IoUringWriteBatchImpl::create(*dispatcher_)) {}
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  // nullptr if the kernel does not support io_uring, in which case the tests do nothing.
+  WriteBatchPtr batch_;
+};
+
+TEST_F(IoUringWriteBatchImplTest, WritesAreSubmittedTogether) {
+  if (batch_ == nullptr) {
+    return;
+  }
+
+  SocketPair pair1;
+  SocketPair pair2;
+  Buffer::OwnedImpl buffer1("hello");
+  Buffer::OwnedImpl buffer2("world");
+  MockWriteBatchCallbacks callbacks1;
+  MockWriteBatchCallbacks callbacks2;
+  batch_->add(*pair1.local_, buffer1, callbacks1);
+  batch_->add(*pair2.local_, buffer2, callbacks2);
+  // Data added before the batch is flushed is part of the write.
+  buffer2.add("!");
+
+  EXPECT_CALL(callbacks1, onBatchedWrite_(5, Api::IoError::IoErrorCode::NoSupport));
+  EXPECT_CALL(callbacks2, onBatchedWrite_(6, Api::IoError::IoErrorCode::NoSupport));
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  EXPECT_EQ(0, buffer1.length());
+  EXPECT_EQ(0, buffer2.length());
+  EXPECT_EQ("hello", pair1.readRemote());
+  EXPECT_EQ("world!", pair2.readRemote());
+}
+
+TEST_F(IoUringWriteBatchImplTest, RemovedWriteIsNotPerformed) {
+  if (batch_ == nullptr) {
+    return;
+  }
+
+  SocketPair pair;
+  Buffer::OwnedImpl buffer("hello");
+  MockWriteBatchCallbacks callbacks;
+  batch_->add(*pair.local_, buffer, callbacks);
+  batch_->remove(callbacks);
+
+  EXPECT_CALL(callbacks, onBatchedWrite_(_, _)).Times(0);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  EXPECT_EQ(5, buffer.length());
+  EXPECT_EQ("", pair.readRemote());
+}
+
+TEST_F(IoUringWriteBatchImplTest, WriteRemovedByEarlierCompletion) {
+  if (batch_ == nullptr) {
+    return;
+  }
+
+  SocketPair pair1;
+  SocketPair pair2;
+  Buffer::OwnedImpl buffer1("hello");
+  Buffer::OwnedImpl buffer2("world");
+  MockWriteBatchCallbacks callbacks1;
+  MockWriteBatchCallbacks callbacks2;
+  batch_->add(*pair1.local_, buffer1, callbacks1);
+  batch_->add(*pair2.local_, buffer2, callbacks2);
+
+  // The second write was performed, but its owner is gone by the time it would be reported.
+  EXPECT_CALL(callbacks1, onBatchedWrite_(5, _))
+      .WillOnce(Invoke(
+          [&](uint64_t, Api::IoError::IoErrorCode) -> void { batch_->remove(callbacks2); }));
+  EXPECT_CALL(callbacks2, onBatchedWrite_(_, _)).Times(0);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  EXPECT_EQ("world", pair2.readRemote());
+}
+
+TEST_F(IoUringWriteBatchImplTest, FullSocket) {
+  if (batch_ == nullptr) {
+    return;
+  }
+
+  SocketPair pair;
+  Buffer::OwnedImpl buffer(std::string(1024, 'a'));
+  while (buffer.write(*pair.local_).ok()) {
+    buffer.add(std::string(1024, 'a'));
+  }
+  const uint64_t length = buffer.length();
+
+  MockWriteBatchCallbacks callbacks;
+  batch_->add(*pair.local_, buffer, callbacks);
+  EXPECT_CALL(callbacks, onBatchedWrite_(0, Api::IoError::IoErrorCode::Again));
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(length, buffer.length());
+}
+
+// Writes queued from a completion go into the next batch.
+TEST_F(IoUringWriteBatchImplTest, AddFromCompletion) {
+  if (batch_ == nullptr) {
+    return;
+  }
+
+  SocketPair pair;
+  Buffer::OwnedImpl buffer("hello");
+  MockWriteBatchCallbacks callbacks;
+  batch_->add(*pair.local_, buffer, callbacks);
+
+  EXPECT_CALL(callbacks, onBatchedWrite_(5, _))
+      .WillOnce(Invoke([&](uint64_t, Api::IoError::IoErrorCode) -> void {
+        buffer.add("world");
+        batch_->add(*pair.local_, buffer, callbacks);
+      }));
+  EXPECT_CALL(callbacks, onBatchedWrite_(5, _));
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  EXPECT_EQ("helloworld", pair.readRemote());
+}
+
+class RawBufferSocketBatchingTest : public IoUringWriteBatchImplTest {
+protected:
+  RawBufferSocketBatchingTest() {
+    ON_CALL(callbacks_, ioHandle()).WillByDefault(ReturnRef(*pair_.local_));
+    ON_CALL(callbacks_.connection_.dispatcher_, writeBatch()).WillByDefault(Return(batch_.get()));
+    socket_.setTransportSocketCallbacks(callbacks_);
+  }
+
+  SocketPair pair_;
+  NiceMock<MockTransportSocketCallbacks> callbacks_;
+  RawBufferSocket socket_{true};
+};
+
+TEST_F(RawBufferSocketBatchingTest, WriteCompletesThroughFlush) {
+  if (batch_ == nullptr) {
+    return;
+  }
+
+  Buffer::OwnedImpl buffer("hello");
+  IoResult result = socket_.doWrite(buffer, false);
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(0, result.bytes_processed_);
+  // A second write while the first is queued does not queue another one.
+  buffer.add(" world");
+  result = socket_.doWrite(buffer, false);
+  EXPECT_EQ(0, result.bytes_processed_);
+
+  EXPECT_CALL(callbacks_, flushWriteBuffer()).WillOnce(Invoke([&]() -> void {
+    result = socket_.doWrite(buffer, false);
+  }));
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(11, result.bytes_processed_);
+  EXPECT_EQ("hello world", pair_.readRemote());
+}
+
+TEST_F(RawBufferSocketBatchingTest, EndStreamIsWrittenDirectly) {
+  if (batch_ == nullptr) {
+    return;
+  }
+
+  Buffer::OwnedImpl buffer("hello");
+  IoResult result = socket_.doWrite(buffer, true);
+  EXPECT_EQ(5, result.bytes_processed_);
+  EXPECT_EQ("hello", pair_.readRemote());
+}
+
+TEST_F(RawBufferSocketBatchingTest, WriteError) {
+  if (batch_ == nullptr) {
+    return;
+  }
+
+  Buffer::OwnedImpl buffer("hello");
+  socket_.doWrite(buffer, false);
+  pair_.remote_->close();
+
+  IoResult result;
+  EXPECT_CALL(callbacks_, flushWriteBuffer()).WillOnce(Invoke([&]() -> void {
+    result = socket_.doWrite(buffer, false);
+  }));
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(PostIoAction::Close, result.action_);
+}
+
+TEST_F(RawBufferSocketBatchingTest, CloseRemovesQueuedWrite) {
+  if (batch_ == nullptr) {
+    return;
+  }
+
+  Buffer::OwnedImpl buffer("hello");
+  socket_.doWrite(buffer, false);
+  socket_.closeSocket(ConnectionEvent::LocalClose);
+
+  EXPECT_CALL(callbacks_, flushWriteBuffer()).Times(0);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ("", pair_.readRemote());
+}
+
+TEST_F(RawBufferSocketBatchingTest, CloseFromWatermarkCallbackDuringFlush) {
+  if (batch_ == nullptr) {
+    return;
+  }
+
+  // Draining the written data below the low watermark closes the socket, which removes the write
+  // while its completion is being handed out.
+  Buffer::WatermarkBuffer buffer([&]() -> void { socket_.closeSocket(ConnectionEvent::LocalClose); },
+                                 []() -> void {});
+  buffer.setWatermarks(4);
+  buffer.add("hello");
+  socket_.doWrite(buffer, false);
+
+  EXPECT_CALL(callbacks_, flushWriteBuffer()).Times(0);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(0, buffer.length());
+  EXPECT_EQ("hello", pair_.readRemote());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -1,3 +1,5 @@
+#include <netinet/udp.h>
+
 #include <memory>
 #include <string>
 #include <vector>
@@ -7,10 +9,12 @@
 #include "common/network/utility.h"
 
 #include "test/common/network/listener_impl_test_base.h"
+#include "test/mocks/api/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -18,8 +22,16 @@
 
 using testing::_;
 using testing::Invoke;
+using testing::NiceMock;
 using testing::Return;
 
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
 namespace Envoy {
 namespace Network {
 namespace {
@@ -37,6 +49,22 @@ public:
   }
 };
 
+// Makes UDP listeners read datagrams one at a time with doRecvFrom(), as they do where recvmmsg(2)
+// is not supported.
+class RecvMmsgUnsupported {
+#ifdef __linux__
+public:
+  RecvMmsgUnsupported() {
+    ON_CALL(linux_os_sys_calls_, recvmmsg(_, _, _, _, _))
+        .WillByDefault(Return(Api::SysCallIntResult{-1, ENOSYS}));
+  }
+
+private:
+  NiceMock<Api::MockLinuxOsSysCalls> linux_os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls_{&linux_os_sys_calls_};
+#endif
+};
+
 class UdpListenerImplTest : public ListenerImplTestBase {
 protected:
   SocketPtr getSocket(Address::SocketType type, const Address::InstanceConstSharedPtr& address,
@@ -137,7 +165,8 @@ TEST_P(UdpListenerImplTest, UseActualDstUdp) {
   auto const* server_ip = server_socket->localAddress()->ip();
   ASSERT_NE(server_ip, nullptr);
 
-  // Setup callback handler and listener.
+  // Setup callback handler and listener, which reads through doRecvFrom().
+  RecvMmsgUnsupported recvmmsg_unsupported;
   Network::MockUdpListenerCallbacks listener_callbacks;
   Network::TestUdpListenerImpl listener(dispatcherImpl(), *server_socket.get(), listener_callbacks);
 
@@ -223,7 +252,8 @@ TEST_P(UdpListenerImplTest, UdpEcho) {
   auto const* server_ip = server_socket->localAddress()->ip();
   ASSERT_NE(server_ip, nullptr);
 
-  // Setup callback handler and listener.
+  // Setup callback handler and listener, which reads through doRecvFrom().
+  RecvMmsgUnsupported recvmmsg_unsupported;
   Network::MockUdpListenerCallbacks listener_callbacks;
   Network::TestUdpListenerImpl listener(dispatcherImpl(), *server_socket.get(), listener_callbacks);
 
@@ -357,7 +387,8 @@ TEST_P(UdpListenerImplTest, UdpListenerEnableDisable) {
   auto const* server_ip = server_socket->localAddress()->ip();
   ASSERT_NE(server_ip, nullptr);
 
-  // Setup callback handler and listener.
+  // Setup callback handler and listener, which reads through doRecvFrom().
+  RecvMmsgUnsupported recvmmsg_unsupported;
   Network::MockUdpListenerCallbacks listener_callbacks;
   Network::TestUdpListenerImpl listener(dispatcherImpl(), *server_socket.get(), listener_callbacks);
 
@@ -457,7 +488,8 @@ TEST_P(UdpListenerImplTest, UdpListenerRecvFromError) {
   auto const* server_ip = server_socket->localAddress()->ip();
   ASSERT_NE(server_ip, nullptr);
 
-  // Setup callback handler and listener.
+  // Setup callback handler and listener, which reads through doRecvFrom().
+  RecvMmsgUnsupported recvmmsg_unsupported;
   Network::MockUdpListenerCallbacks listener_callbacks;
   Network::TestUdpListenerImpl listener(dispatcherImpl(), *server_socket.get(), listener_callbacks);
 
@@ -505,6 +537,266 @@ TEST_P(UdpListenerImplTest, UdpListenerRecvFromError) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+/**
+ * Tests that the UDP listener sends a single datagram of several slices.
+ */
+TEST_P(UdpListenerImplTest, Send) {
+  SocketPtr server_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+  SocketPtr client_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+
+  Network::MockUdpListenerCallbacks listener_callbacks;
+  UdpListenerImpl listener(dispatcherImpl(), *server_socket, listener_callbacks);
+
+  Buffer::OwnedImpl buffer("first");
+  Buffer::OwnedImpl second("second");
+  buffer.move(second);
+  const std::string payload = buffer.toString();
+
+  const Api::SysCallSizeResult result =
+      listener.send(UdpSendData{*client_socket->localAddress(), buffer});
+  ASSERT_EQ(payload.size(), result.rc_);
+
+  char received[64];
+  const ssize_t received_size =
+      ::recv(client_socket->ioHandle().fd(), received, sizeof(received), MSG_DONTWAIT);
+  EXPECT_EQ(payload, std::string(received, received_size));
+}
+
+/**
+ * Tests that the UDP listener sends a batch of datagrams to several peers, each of which receives
+ * its datagrams one by one and in order.
+ */
+TEST_P(UdpListenerImplTest, SendBatch) {
+  SocketPtr server_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+  SocketPtr first_client =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+  SocketPtr second_client =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+
+  Network::MockUdpListenerCallbacks listener_callbacks;
+  UdpListenerImpl listener(dispatcherImpl(), *server_socket, listener_callbacks);
+
+  // A run of datagrams of the same size to the first client, which may be coalesced, followed by a
+  // datagram to the second client and another to the first one.
+  const std::vector<std::pair<Socket*, std::string>> datagrams{
+      {first_client.get(), std::string(100, 'a')},  {first_client.get(), std::string(100, 'b')},
+      {first_client.get(), std::string(100, 'c')},  {first_client.get(), std::string(50, 'd')},
+      {second_client.get(), std::string(100, 'e')}, {first_client.get(), std::string(10, 'f')}};
+  std::vector<std::unique_ptr<Buffer::OwnedImpl>> buffers;
+  std::vector<UdpSendData> batch;
+  for (const auto& datagram : datagrams) {
+    buffers.push_back(std::make_unique<Buffer::OwnedImpl>(datagram.second));
+    batch.push_back(UdpSendData{*datagram.first->localAddress(), *buffers.back()});
+  }
+
+  const Api::SysCallIntResult result = listener.sendBatch(batch);
+  ASSERT_EQ(datagrams.size(), result.rc_);
+
+  char received[1024];
+  for (const auto& datagram : datagrams) {
+    const ssize_t received_size =
+        ::recv(datagram.first->ioHandle().fd(), received, sizeof(received), MSG_DONTWAIT);
+    EXPECT_EQ(datagram.second, std::string(received, std::max<ssize_t>(received_size, 0)));
+  }
+  EXPECT_EQ(-1, ::recv(first_client->ioHandle().fd(), received, sizeof(received), MSG_DONTWAIT));
+  EXPECT_EQ(-1, ::recv(second_client->ioHandle().fd(), received, sizeof(received), MSG_DONTWAIT));
+}
+
+#ifdef __linux__
+/**
+ * Tests that datagrams queued on the socket are read with a single recvmmsg(2) and delivered as a
+ * single batch.
+ */
+TEST_P(UdpListenerImplTest, ReceiveBatch) {
+  SocketPtr server_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+  SocketPtr client_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, false);
+
+  Network::MockUdpListenerCallbacks listener_callbacks;
+  UdpListenerImpl listener(dispatcherImpl(), *server_socket, listener_callbacks);
+
+  sockaddr_storage server_addr;
+  socklen_t addr_len;
+  getSocketAddressInfo(*client_socket, server_socket->localAddress()->ip()->port(), server_addr,
+                       addr_len);
+  ASSERT_GT(addr_len, 0);
+
+  const std::vector<std::string> payloads{"first", "second", "third"};
+  for (const std::string& payload : payloads) {
+    ASSERT_EQ(payload.size(),
+              ::sendto(client_socket->ioHandle().fd(), payload.c_str(), payload.size(), 0,
+                       reinterpret_cast<const sockaddr*>(&server_addr), addr_len));
+  }
+
+  EXPECT_CALL(listener_callbacks, onWriteReady_(_)).Times(testing::AnyNumber());
+  EXPECT_CALL(listener_callbacks, onData_(_)).Times(0);
+  EXPECT_CALL(listener_callbacks, onDataBatch_(_)).WillOnce(Invoke([&](UdpDataBatch& batch) {
+    ASSERT_EQ(payloads.size(), batch.size());
+    for (size_t i = 0; i < payloads.size(); i++) {
+      EXPECT_EQ(payloads[i], batch[i].buffer_->toString());
+      EXPECT_EQ(*server_socket->localAddress(), *batch[i].local_address_);
+      EXPECT_EQ(client_socket->localAddress()->ip()->addressAsString(),
+                batch[i].peer_address_->ip()->addressAsString());
+    }
+    dispatcher_->exit();
+  }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
+/**
+ * Tests that a read coalesced by UDP generic receive offload is split into its datagrams.
+ */
+TEST_P(UdpListenerImplTest, ReceiveCoalescedBatch) {
+  SocketPtr server_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+  SocketPtr client_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  NiceMock<Api::MockLinuxOsSysCalls> linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+
+  // Generic receive offload is enabled as the mocked UDP_GRO socket option can be set.
+  Network::MockUdpListenerCallbacks listener_callbacks;
+  UdpListenerImpl listener(dispatcherImpl(), *server_socket, listener_callbacks);
+
+  sockaddr_storage client_addr;
+  socklen_t addr_len;
+  getSocketAddressInfo(client_socket->localAddress(), client_socket->localAddress()->ip()->port(),
+                       client_addr, addr_len);
+  ASSERT_GT(addr_len, 0);
+
+  const std::string coalesced("aaabbbcc");
+  EXPECT_CALL(linux_os_sys_calls, recvmmsg(server_socket->ioHandle().fd(), _, _, _, _))
+      .WillOnce(Invoke([&](int, mmsghdr* messages, unsigned int, int, timespec*) {
+        msghdr& header = messages[0].msg_hdr;
+        memcpy(header.msg_name, &client_addr, addr_len);
+        header.msg_namelen = addr_len;
+        memcpy(header.msg_iov[0].iov_base, coalesced.data(), coalesced.size());
+        messages[0].msg_len = coalesced.size();
+
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&header);
+        EXPECT_NE(nullptr, cmsg);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_GRO;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        const int segment_size = 3;
+        memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+        return Api::SysCallIntResult{1, 0};
+      }));
+
+  EXPECT_CALL(listener_callbacks, onWriteReady_(_)).Times(testing::AnyNumber());
+  EXPECT_CALL(listener_callbacks, onDataBatch_(_)).WillOnce(Invoke([&](UdpDataBatch& batch) {
+    ASSERT_EQ(3, batch.size());
+    EXPECT_EQ("aaa", batch[0].buffer_->toString());
+    EXPECT_EQ("bbb", batch[1].buffer_->toString());
+    EXPECT_EQ("cc", batch[2].buffer_->toString());
+    for (const UdpData& data : batch) {
+      EXPECT_EQ(*client_socket->localAddress(), *data.peer_address_);
+    }
+    dispatcher_->exit();
+  }));
+
+  // Make the socket readable. The datagram itself is never read as recvmmsg(2) is mocked.
+  sockaddr_storage server_addr;
+  getSocketAddressInfo(*server_socket, server_socket->localAddress()->ip()->port(), server_addr,
+                       addr_len);
+  ASSERT_EQ(coalesced.size(),
+            ::sendto(client_socket->ioHandle().fd(), coalesced.c_str(), coalesced.size(), 0,
+                     reinterpret_cast<const sockaddr*>(&server_addr), addr_len));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
+/**
+ * Tests that a run of datagrams to the same peer is sent as a single message with UDP generic
+ * segmentation offload, and one by one once the device turns out not to support it.
+ */
+TEST_P(UdpListenerImplTest, SendCoalescedBatch) {
+  SocketPtr server_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+  SocketPtr client_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  NiceMock<Api::MockLinuxOsSysCalls> linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+
+  // Generic segmentation offload is enabled as the mocked UDP_SEGMENT socket option can be read.
+  Network::MockUdpListenerCallbacks listener_callbacks;
+  UdpListenerImpl listener(dispatcherImpl(), *server_socket, listener_callbacks);
+
+  const std::vector<std::string> payloads{std::string(100, 'a'), std::string(100, 'b'),
+                                          std::string(50, 'c')};
+  std::vector<std::unique_ptr<Buffer::OwnedImpl>> buffers;
+  std::vector<UdpSendData> batch;
+  for (const std::string& payload : payloads) {
+    buffers.push_back(std::make_unique<Buffer::OwnedImpl>(payload));
+    batch.push_back(UdpSendData{*client_socket->localAddress(), *buffers.back()});
+  }
+
+  auto segment_size = [](const msghdr& header) -> int {
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&header), cmsg)) {
+      if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_SEGMENT) {
+        uint16_t size;
+        memcpy(&size, CMSG_DATA(cmsg), sizeof(size));
+        return size;
+      }
+    }
+    return 0;
+  };
+  auto message_size = [](const msghdr& header) -> uint64_t {
+    uint64_t size = 0;
+    for (size_t i = 0; i < header.msg_iovlen; i++) {
+      size += header.msg_iov[i].iov_len;
+    }
+    return size;
+  };
+
+  EXPECT_CALL(linux_os_sys_calls, sendmmsg(server_socket->ioHandle().fd(), _, 1, 0))
+      .WillOnce(Invoke([&](int, mmsghdr* messages, unsigned int, int) {
+        EXPECT_EQ(100, segment_size(messages[0].msg_hdr));
+        EXPECT_EQ(250, message_size(messages[0].msg_hdr));
+        return Api::SysCallIntResult{1, 0};
+      }));
+  EXPECT_EQ(3, listener.sendBatch(batch).rc_);
+
+  // The device cannot offload segmentation, so the datagrams are resent one by one, and so are
+  // the datagrams of later batches.
+  EXPECT_CALL(linux_os_sys_calls, sendmmsg(server_socket->ioHandle().fd(), _, 1, 0))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EIO}));
+  EXPECT_CALL(linux_os_sys_calls, sendmmsg(server_socket->ioHandle().fd(), _, 3, 0))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](int, mmsghdr* messages, unsigned int length, int) {
+        for (unsigned int i = 0; i < length; i++) {
+          EXPECT_EQ(0, segment_size(messages[i].msg_hdr));
+          EXPECT_EQ(payloads[i].size(), message_size(messages[i].msg_hdr));
+        }
+        return Api::SysCallIntResult{3, 0};
+      }));
+  EXPECT_EQ(3, listener.sendBatch(batch).rc_);
+  EXPECT_EQ(3, listener.sendBatch(batch).rc_);
+}
+#endif
+
 } // namespace
 } // namespace Network
 } // namespace Envoy
@@ -0,0 +1,172 @@
+// Usage: bazel run //test/common/network:udp_listener_speed_test
+//
+// Measures how many datagrams per second a UDP listener reads and writes over loopback, compared
+// with reading and writing them one at a time with recvfrom(2) and sendto(2).
+
+#include <sys/socket.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/api/api_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/network/listen_socket_impl.h"
+#include "common/network/udp_listener_impl.h"
+#include "common/network/utility.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/test_common/network_utility.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+// The number of datagrams queued on the socket before each read, and written by each write.
+constexpr uint32_t DatagramsPerIteration = 64;
+
+class CountingUdpListenerCallbacks : public UdpListenerCallbacks {
+public:
+  // Network::UdpListenerCallbacks
+  void onData(const UdpData&) override { datagrams_++; }
+  void onDataBatch(UdpDataBatch& batch) override { datagrams_ += batch.size(); }
+  void onWriteReady(const Socket&) override {}
+  void onError(const ErrorCode&, int) override {}
+
+  uint64_t datagrams_{};
+};
+
+// A listener socket and a client socket connected to it over IPv4 loopback.
+class UdpListenerTester {
+public:
+  UdpListenerTester()
+      : api_(Api::createApiForTest(stats_)), dispatcher_(api_->allocateDispatcher()),
+        server_socket_(Test::getCanonicalLoopbackAddress(Address::IpVersion::v4), nullptr, true),
+        client_socket_(Test::getCanonicalLoopbackAddress(Address::IpVersion::v4), nullptr, true),
+        listener_(dispatcher_->createUdpListener(server_socket_, callbacks_)) {
+    RELEASE_ASSERT(server_socket_.localAddress()->connect(client_socket_.ioHandle().fd()).rc_ == 0,
+                   "");
+  }
+
+  // Queues datagrams of the given size on the listener socket.
+  void sendToListener(uint64_t size) {
+    const std::string payload(size, 'a');
+    for (uint32_t i = 0; i < DatagramsPerIteration; i++) {
+      RELEASE_ASSERT(::send(client_socket_.ioHandle().fd(), payload.data(), size, 0) ==
+                         static_cast<ssize_t>(size),
+                     "");
+    }
+  }
+
+  // Reads the datagrams queued on the client socket.
+  uint64_t drainClient() {
+    uint64_t datagrams = 0;
+    char buffer[65536];
+    while (::recv(client_socket_.ioHandle().fd(), buffer, sizeof(buffer), MSG_DONTWAIT) >= 0) {
+      datagrams++;
+    }
+    return datagrams;
+  }
+
+  Stats::IsolatedStoreImpl stats_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  UdpListenSocket server_socket_;
+  UdpListenSocket client_socket_;
+  CountingUdpListenerCallbacks callbacks_;
+  UdpListenerPtr listener_;
+};
+
+// Baseline: reads datagrams of state.range(0) bytes one at a time with recvfrom(2).
+void BM_RecvFrom(benchmark::State& state) {
+  UdpListenerTester tester;
+  tester.listener_->disable();
+  const int fd = tester.server_socket_.ioHandle().fd();
+  char buffer[UdpListenerImpl::MaxDatagramSize];
+  uint64_t datagrams = 0;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    tester.sendToListener(state.range(0));
+    state.ResumeTiming();
+
+    sockaddr_storage peer_addr;
+    socklen_t addr_len = sizeof(peer_addr);
+    while (::recvfrom(fd, buffer, sizeof(buffer), MSG_DONTWAIT,
+                      reinterpret_cast<sockaddr*>(&peer_addr), &addr_len) >= 0) {
+      datagrams++;
+      addr_len = sizeof(peer_addr);
+    }
+  }
+  RELEASE_ASSERT(datagrams == state.iterations() * DatagramsPerIteration, "");
+  state.SetItemsProcessed(datagrams);
+}
+BENCHMARK(BM_RecvFrom)->Arg(64)->Arg(1200);
+
+// Reads datagrams of state.range(0) bytes through the listener, including the creation of the
+// datagram buffers and addresses handed to the callbacks.
+void BM_UdpListenerRead(benchmark::State& state) {
+  UdpListenerTester tester;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    tester.sendToListener(state.range(0));
+    state.ResumeTiming();
+
+    tester.dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  RELEASE_ASSERT(tester.callbacks_.datagrams_ == state.iterations() * DatagramsPerIteration, "");
+  state.SetItemsProcessed(tester.callbacks_.datagrams_);
+}
+BENCHMARK(BM_UdpListenerRead)->Arg(64)->Arg(1200);
+
+// Writes datagrams of state.range(0) bytes through the listener, one at a time when state.range(1)
+// is zero and as a single batch otherwise.
+void BM_UdpListenerWrite(benchmark::State& state) {
+  UdpListenerTester tester;
+  tester.listener_->disable();
+  UdpListener& listener = *tester.listener_;
+  const bool batched = state.range(1) != 0;
+
+  std::vector<std::unique_ptr<Buffer::OwnedImpl>> buffers;
+  std::vector<UdpSendData> batch;
+  for (uint32_t i = 0; i < DatagramsPerIteration; i++) {
+    buffers.push_back(std::make_unique<Buffer::OwnedImpl>(std::string(state.range(0), 'a')));
+    batch.push_back(UdpSendData{*tester.client_socket_.localAddress(), *buffers.back()});
+  }
+  uint64_t datagrams = 0;
+
+  for (auto _ : state) {
+    if (batched) {
+      listener.sendBatch(batch);
+    } else {
+      for (const UdpSendData& data : batch) {
+        listener.send(data);
+      }
+    }
+
+    state.PauseTiming();
+    datagrams += tester.drainClient();
+    state.ResumeTiming();
+  }
+  RELEASE_ASSERT(datagrams == state.iterations() * DatagramsPerIteration, "");
+  state.SetItemsProcessed(datagrams);
+}
+BENCHMARK(BM_UdpListenerWrite)->Args({64, 0})->Args({64, 1})->Args({1200, 0})->Args({1200, 1});
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
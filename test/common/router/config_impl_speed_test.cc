@@ -0,0 +1,92 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+
+#include "envoy/api/v2/rds.pb.h"
+
+#include "common/router/config_impl.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Builds a route configuration with a single virtual host containing num_routes prefix routes of
+ * the form /shard/<i>/<suffix>, followed by a catch-all route.
+ */
+static envoy::api::v2::RouteConfiguration makeRouteConfig(size_t num_routes,
+                                                          const std::string& suffix) {
+  envoy::api::v2::RouteConfiguration config;
+  auto* vhost = config.add_virtual_hosts();
+  vhost->set_name("speed_test");
+  vhost->add_domains("*");
+  for (size_t i = 0; i < num_routes; i++) {
+    auto* route = vhost->add_routes();
+    route->mutable_match()->set_prefix(fmt::format("/shard/{}/{}", i, suffix));
+    route->mutable_route()->set_cluster(fmt::format("cluster_{}", i));
+  }
+  auto* route = vhost->add_routes();
+  route->mutable_match()->set_prefix("/");
+  route->mutable_route()->set_cluster("default");
+  return config;
+}
+
+static Http::TestHeaderMapImpl makeHeaders(const std::string& path) {
+  return Http::TestHeaderMapImpl{{":authority", "example.com"},
+                                 {":path", path},
+                                 {":method", "GET"},
+                                 {"x-forwarded-proto", "http"}};
+}
+
+/**
+ * Measure route selection for the last configured route as the number of routes in the virtual
+ * host grows. Lookup time should stay flat since only the routes sharing a prefix with the request
+ * path are evaluated.
+ */
+static void RouteMatcherByRouteCount(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  const size_t num_routes = state.range(0);
+  ConfigImpl config(makeRouteConfig(num_routes, "resource"), factory_context, false);
+  const Http::TestHeaderMapImpl headers =
+      makeHeaders(fmt::format("/shard/{}/resource?id=1", num_routes - 1));
+
+  size_t matches = 0;
+  for (auto _ : state) {
+    matches += (config.route(headers, 0) != nullptr);
+  }
+  benchmark::DoNotOptimize(matches);
+}
+BENCHMARK(RouteMatcherByRouteCount)->Arg(10)->Arg(100)->Arg(1000)->Arg(5000);
+
+/**
+ * Measure route selection as the request path grows with a fixed number of routes. Lookup time
+ * should grow linearly with the path length.
+ */
+static void RouteMatcherByPathLength(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  const std::string suffix(state.range(0), 'a');
+  ConfigImpl config(makeRouteConfig(1000, suffix), factory_context, false);
+  const Http::TestHeaderMapImpl headers = makeHeaders(fmt::format("/shard/999/{}", suffix));
+
+  size_t matches = 0;
+  for (auto _ : state) {
+    matches += (config.route(headers, 0) != nullptr);
+  }
+  benchmark::DoNotOptimize(matches);
+}
+BENCHMARK(RouteMatcherByPathLength)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+
+} // namespace Router
+} // namespace Envoy
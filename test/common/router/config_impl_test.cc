@@ -578,6 +578,99 @@ virtual_hosts:
             config.route(genHeaders("example.com", "/", "GET"), 0)->routeEntry()->clusterName());
 }
 
+// Verifies that first-match semantics are preserved when prefix, exact path, case insensitive and
+// regex routes are interleaved, since route selection goes through the path index.
+TEST_F(RouteMatcherTest, TestRouteOrderWithMixedMatchTypes) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: mixed
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/api/v1/users", headers: [{ name: "x-canary", exact_match: "true" }] }
+        route: { cluster: "canary" }
+      - match: { regex: "/api/v[0-9]/users/[0-9]+" }
+        route: { cluster: "regex" }
+      - match: { path: "/api/v1/users" }
+        route: { cluster: "exact" }
+      - match: { prefix: "/API/V1", case_sensitive: false }
+        route: { cluster: "insensitive" }
+      - match: { prefix: "/api" }
+        route: { cluster: "api" }
+      - match: { regex: ".*" }
+        route: { cluster: "catch_all_regex" }
+      - match: { prefix: "/" }
+        route: { cluster: "default" }
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
+
+  {
+    Http::TestHeaderMapImpl headers = genHeaders("example.com", "/api/v1/users", "GET");
+    headers.addCopy("x-canary", "true");
+    EXPECT_EQ("canary", config.route(headers, 0)->routeEntry()->clusterName());
+  }
+  EXPECT_EQ("regex", config.route(genHeaders("example.com", "/api/v1/users/42", "GET"), 0)
+                         ->routeEntry()
+                         ->clusterName());
+  EXPECT_EQ("exact", config.route(genHeaders("example.com", "/api/v1/users?page=2", "GET"), 0)
+                         ->routeEntry()
+                         ->clusterName());
+  EXPECT_EQ("insensitive", config.route(genHeaders("example.com", "/Api/V1/users/x", "GET"), 0)
+                               ->routeEntry()
+                               ->clusterName());
+  EXPECT_EQ("api", config.route(genHeaders("example.com", "/api/v2", "GET"), 0)
+                       ->routeEntry()
+                       ->clusterName());
+  EXPECT_EQ("catch_all_regex", config.route(genHeaders("example.com", "/foo", "GET"), 0)
+                                   ->routeEntry()
+                                   ->clusterName());
+}
+
+// Verifies that safe_regex routes, which are matched through a single regex set per virtual host,
+// keep first-match semantics relative to the other routes.
+TEST_F(RouteMatcherTest, TestSafeRegexRoutes) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: safe_regex
+    domains: ["*"]
+    routes:
+      - match: { safe_regex: { google_re2: {}, regex: "/users/[0-9]+" } }
+        route: { cluster: "users" }
+      - match: { prefix: "/users/me" }
+        route: { cluster: "me" }
+      - match: { safe_regex: { google_re2: {}, regex: "/users/.*" } }
+        route: { cluster: "users_catch_all" }
+      - match: { regex: "/legacy/.*" }
+        route: { cluster: "legacy" }
+      - match: { safe_regex: { google_re2: {}, regex: ".*" } }
+        route: { cluster: "catch_all" }
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
+
+  EXPECT_EQ("users", config.route(genHeaders("example.com", "/users/42?x=y", "GET"), 0)
+                         ->routeEntry()
+                         ->clusterName());
+  EXPECT_EQ("me", config.route(genHeaders("example.com", "/users/me", "GET"), 0)
+                      ->routeEntry()
+                      ->clusterName());
+  EXPECT_EQ("users_catch_all", config.route(genHeaders("example.com", "/users/abc", "GET"), 0)
+                                   ->routeEntry()
+                                   ->clusterName());
+  EXPECT_EQ("legacy", config.route(genHeaders("example.com", "/legacy/1", "GET"), 0)
+                          ->routeEntry()
+                          ->clusterName());
+  EXPECT_EQ("catch_all", config.route(genHeaders("example.com", "/foo", "GET"), 0)
+                             ->routeEntry()
+                             ->clusterName());
+
+  // Path rewriting uses the path matched by the regex.
+  Http::TestHeaderMapImpl headers = genHeaders("example.com", "/users/42", "GET");
+  const RouteEntry* route = config.route(headers, 0)->routeEntry();
+  EXPECT_EQ("/users/[0-9]+", route->pathMatchCriterion().matcher());
+  EXPECT_EQ(PathMatchType::Regex, route->pathMatchCriterion().matchType());
+}
+
 TEST_F(RouteMatcherTest, TestRoutesWithInvalidRegex) {
   std::string invalid_route = R"EOF(
 virtual_hosts:
@@ -609,6 +702,20 @@ virtual_hosts:
   EXPECT_THROW_WITH_REGEX(TestConfigImpl(parseRouteConfigurationFromV2Yaml(invalid_virtual_cluster),
                                          factory_context_, true),
                           EnvoyException, "Invalid regex '\\^/\\(\\+invalid\\)':");
+
+  std::string invalid_safe_regex_route = R"EOF(
+virtual_hosts:
+  - name: regex
+    domains: ["*"]
+    routes:
+      - match: { safe_regex: { google_re2: {}, regex: "/(+invalid)" } }
+        route: { cluster: "regex" }
+  )EOF";
+
+  EXPECT_THROW_WITH_REGEX(
+      TestConfigImpl(parseRouteConfigurationFromV2Yaml(invalid_safe_regex_route), factory_context_,
+                     true),
+      EnvoyException, "Invalid regex '/\\(\\+invalid\\)':");
 }
 
 // Validates behavior of request_headers_to_add at router, vhost, and route levels.
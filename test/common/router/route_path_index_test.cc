@@ -0,0 +1,87 @@
+#include "common/router/route_path_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+RoutePathIndex::Candidates findCandidates(const RoutePathIndex& index, absl::string_view path) {
+  const size_t query_start = path.find('?');
+  RoutePathIndex::Candidates candidates;
+  index.findCandidates(path, query_start == absl::string_view::npos ? path.size() : query_start,
+                       candidates);
+  return candidates;
+}
+
+TEST(RoutePathIndexTest, Empty) {
+  RoutePathIndex index;
+  EXPECT_THAT(findCandidates(index, "/foo"), IsEmpty());
+}
+
+TEST(RoutePathIndexTest, Prefix) {
+  RoutePathIndex index;
+  index.addPrefix("/foo/bar", true, 0);
+  index.addPrefix("/foo", true, 1);
+  index.addPrefix("", true, 2);
+
+  EXPECT_THAT(findCandidates(index, "/foo/bar/baz"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(findCandidates(index, "/foo/ba"), ElementsAre(1, 2));
+  EXPECT_THAT(findCandidates(index, "/fo"), ElementsAre(2));
+  EXPECT_THAT(findCandidates(index, "/FOO"), ElementsAre(2));
+  // Prefixes are compared against the full path including the query string.
+  EXPECT_THAT(findCandidates(index, "/foo?/bar"), ElementsAre(1, 2));
+}
+
+TEST(RoutePathIndexTest, Exact) {
+  RoutePathIndex index;
+  index.addExact("/foo", true, 0);
+  index.addExact("/foo/bar", true, 1);
+
+  EXPECT_THAT(findCandidates(index, "/foo"), ElementsAre(0));
+  EXPECT_THAT(findCandidates(index, "/foo?bar=baz"), ElementsAre(0));
+  EXPECT_THAT(findCandidates(index, "/foo/bar"), ElementsAre(1));
+  EXPECT_THAT(findCandidates(index, "/foo/"), IsEmpty());
+  EXPECT_THAT(findCandidates(index, "/fo"), IsEmpty());
+}
+
+TEST(RoutePathIndexTest, CaseInsensitive) {
+  RoutePathIndex index;
+  index.addPrefix("/Foo", false, 0);
+  index.addExact("/BAR", false, 1);
+  index.addPrefix("/foo", true, 2);
+
+  EXPECT_THAT(findCandidates(index, "/foo"), ElementsAre(0, 2));
+  EXPECT_THAT(findCandidates(index, "/FOO/x"), ElementsAre(0));
+  EXPECT_THAT(findCandidates(index, "/bar"), ElementsAre(1));
+  EXPECT_THAT(findCandidates(index, "/bAr?x"), ElementsAre(1));
+}
+
+TEST(RoutePathIndexTest, AlwaysEvaluatedPreservesOrder) {
+  RoutePathIndex index;
+  index.addAlwaysEvaluated(0);
+  index.addPrefix("/foo", true, 1);
+  index.addAlwaysEvaluated(2);
+  index.addExact("/foo", true, 3);
+  index.addAlwaysEvaluated(4);
+
+  EXPECT_THAT(findCandidates(index, "/foo"), ElementsAre(0, 1, 2, 3, 4));
+  EXPECT_THAT(findCandidates(index, "/foo/bar"), ElementsAre(0, 1, 2, 4));
+  EXPECT_THAT(findCandidates(index, "/bar"), ElementsAre(0, 2, 4));
+}
+
+TEST(RoutePathIndexTest, SharedPrefixesShareNodes) {
+  RoutePathIndex index;
+  index.addPrefix("/abc", true, 0);
+  index.addPrefix("/abd", true, 1);
+  // Two roots, "/", "a", "b", "c" and "d".
+  EXPECT_EQ(7, index.nodeCount());
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -9,6 +9,7 @@
 
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "benchmark/benchmark.h"
 
@@ -54,6 +55,54 @@ static void BM_CreateRace(benchmark::State& state) {
 }
 BENCHMARK(BM_CreateRace);
 
+// Encodes names from several threads at once, as workers do when a config push creates per
+// cluster and per route stats. With unique_names each thread creates its own tokens, so every
+// token is inserted into the table; otherwise all threads encode the same names, whose tokens
+// are already in the table.
+static void encodeFromThreads(benchmark::State& state, bool unique_names) {
+  Envoy::Thread::ThreadFactory& thread_factory = Envoy::Thread::threadFactoryForTest();
+  const int num_threads = state.range(0);
+  constexpr int num_names = 1000;
+  Envoy::Stats::SymbolTableImpl table;
+  Envoy::Stats::StatNameStorage initial("cluster.upstream_rq_2xx", table);
+
+  for (auto _ : state) {
+    std::vector<Envoy::Thread::ThreadPtr> threads;
+    threads.reserve(num_threads);
+    Envoy::ConditionalInitializer access;
+    for (int i = 0; i < num_threads; ++i) {
+      threads.push_back(thread_factory.createThread([&access, &table, i, unique_names]() {
+        const std::string prefix = unique_names ? absl::StrCat("thread", i, ".") : "";
+        std::vector<Envoy::Stats::StatNameStorage> names;
+        names.reserve(num_names);
+        access.wait();
+        for (int j = 0; j < num_names; ++j) {
+          names.emplace_back(absl::StrCat("cluster.", prefix, "c", j % 100, ".upstream_rq_2xx"),
+                             table);
+        }
+        for (Envoy::Stats::StatNameStorage& name : names) {
+          name.free(table);
+        }
+      }));
+    }
+    access.setReady();
+    for (auto& thread : threads) {
+      thread->join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_threads * num_names);
+
+  initial.free(table);
+}
+
+static void BM_EncodeExistingMultiThreaded(benchmark::State& state) {
+  encodeFromThreads(state, false);
+}
+BENCHMARK(BM_EncodeExistingMultiThreaded)->Arg(1)->Arg(4)->Arg(16);
+
+static void BM_EncodeNewMultiThreaded(benchmark::State& state) { encodeFromThreads(state, true); }
+BENCHMARK(BM_EncodeNewMultiThreaded)->Arg(1)->Arg(4)->Arg(16);
+
 int main(int argc, char** argv) {
   Envoy::Thread::MutexBasicLockable lock;
   Envoy::Logger::Context logger_context(spdlog::level::warn,
@@ -47,6 +47,30 @@ public:
     }
   }
 
+  void enablePerWorkerStats(uint32_t concurrency) { store_.enablePerWorkerStats(concurrency); }
+
+  // Increments the same few counters from several threads at once, like workers updating the
+  // stats of a busy cluster.
+  void incrementCounters(uint32_t num_threads, uint32_t increments) {
+    std::vector<Stats::Counter*> counters;
+    for (uint32_t i = 0; i < 4; ++i) {
+      counters.push_back(&store_.counterFromStatName(stat_names_[i]->statName()));
+    }
+    std::vector<Thread::ThreadPtr> threads;
+    for (uint32_t i = 0; i < num_threads; ++i) {
+      threads.push_back(api_->threadFactory().createThread([&counters, increments]() {
+        for (uint32_t j = 0; j < increments; ++j) {
+          for (Stats::Counter* counter : counters) {
+            counter->inc();
+          }
+        }
+      }));
+    }
+    for (Thread::ThreadPtr& thread : threads) {
+      thread->join();
+    }
+  }
+
   void initThreading() {
     dispatcher_ = api_->allocateDispatcher();
     tls_ = std::make_unique<ThreadLocal::InstanceImpl>();
@@ -94,6 +118,26 @@ BENCHMARK(BM_StatsWithTls);
 // TODO(jmarantz): add multi-threaded variant of this test, that aggressively
 // looks up stats in multiple threads to try to trigger contention issues.
 
+// Tests the contention of threads incrementing the same counters. The first argument enables
+// per worker stats, the second is the number of threads.
+static void BM_CounterContention(benchmark::State& state) {
+  Envoy::ThreadLocalStorePerf context;
+  const uint32_t num_threads = state.range(1);
+  if (state.range(0) != 0) {
+    context.enablePerWorkerStats(num_threads);
+  }
+
+  for (auto _ : state) {
+    context.incrementCounters(num_threads, 100000);
+  }
+}
+BENCHMARK(BM_CounterContention)
+    ->Args({0, 4})
+    ->Args({1, 4})
+    ->Args({0, 16})
+    ->Args({1, 16})
+    ->Unit(benchmark::kMillisecond);
+
 // Boilerplate main(), which discovers benchmarks in the same file and runs them.
 int main(int argc, char** argv) {
   benchmark::Initialize(&argc, argv);
@@ -945,6 +945,86 @@ TEST_F(StatsThreadLocalStoreTest, MergeDuringShutDown) {
   tls_.shutdownThread();
 }
 
+// Each shard starts a cache line of its own.
+TEST(StatShardsTest, CacheLineAligned) {
+  for (uint32_t count = 1; count <= 9; count++) {
+    StatShards shards(count);
+    for (uint32_t i = 0; i < count; i++) {
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(shards.shardForTest(i)) % ABSL_CACHELINE_SIZE);
+    }
+    shards.add(3);
+    EXPECT_EQ(3, shards.sum());
+    EXPECT_EQ(3, shards.drain());
+    EXPECT_EQ(0, shards.sum());
+  }
+}
+
+TEST_F(StatsThreadLocalStoreTest, PerWorkerStats) {
+  InSequence s;
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+  Counter& unsharded = store_->counter("unsharded");
+  store_->enablePerWorkerStats(3);
+
+  Counter& c1 = store_->counter("c1");
+  EXPECT_EQ(&c1, &store_->counter("c1"));
+  EXPECT_NE(nullptr, dynamic_cast<ShardedCounterImpl*>(&c1));
+  EXPECT_EQ(nullptr, dynamic_cast<ShardedCounterImpl*>(&unsharded));
+  EXPECT_EQ("c1", c1.name());
+  EXPECT_FALSE(c1.used());
+  c1.add(100);
+  c1.inc();
+  EXPECT_TRUE(c1.used());
+  EXPECT_EQ(101, c1.value());
+  EXPECT_EQ(101, c1.latch());
+  EXPECT_EQ(0, c1.latch());
+  EXPECT_EQ(101, c1.value());
+
+  Gauge& g1 = store_->gauge("g1");
+  EXPECT_NE(nullptr, dynamic_cast<ShardedGaugeImpl*>(&g1));
+  g1.add(10);
+  g1.sub(3);
+  g1.dec();
+  EXPECT_EQ(6, g1.value());
+  g1.set(20);
+  EXPECT_EQ(20, g1.value());
+  g1.sub(5);
+
+  // Updates from other threads are merged during the flush.
+  Api::ApiPtr api = Api::createApiForTest();
+  std::vector<Thread::ThreadPtr> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(api->threadFactory().createThread([&c1, &g1]() {
+      for (int j = 0; j < 1000; ++j) {
+        c1.inc();
+        g1.inc();
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  EXPECT_EQ(4101, c1.value());
+  EXPECT_EQ(4015, g1.value());
+
+  bool merge_called = false;
+  store_->mergeHistograms([&merge_called]() -> void { merge_called = true; });
+  EXPECT_TRUE(merge_called);
+  EXPECT_EQ(4101, c1.value());
+  EXPECT_EQ(4000, c1.latch());
+  EXPECT_EQ(4015, g1.value());
+
+  // A net subtraction is merged as well.
+  g1.sub(15);
+  store_->mergeHistograms([]() -> void {});
+  EXPECT_EQ(4000, g1.value());
+
+  c1.reset();
+  EXPECT_EQ(0, c1.value());
+
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+}
+
 TEST(ThreadLocalStoreThreadTest, ConstructDestruct) {
   Stats::FakeSymbolTableImpl symbol_table;
   Api::ApiPtr api = Api::createApiForTest();
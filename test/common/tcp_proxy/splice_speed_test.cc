@@ -0,0 +1,144 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares forwarding data between two loopback TCP connections through a user space buffer, as
+// the TCP proxy does by default, with forwarding it through a pipe with splice(2), as it does with
+// zero_copy_forwarding.
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/network/io_socket_handle_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace TcpProxy {
+
+// A loopback TCP connection. The proxy reads from or writes to the proxy end, the benchmark
+// writes to or reads from the peer end.
+struct LoopbackConnection {
+  LoopbackConnection() {
+    const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_length = sizeof(address);
+    RELEASE_ASSERT(::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0,
+                   "");
+    RELEASE_ASSERT(::listen(listener, 1) == 0, "");
+    RELEASE_ASSERT(
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &address_length) == 0, "");
+    peer_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    RELEASE_ASSERT(::connect(peer_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0,
+                   "");
+    proxy_ = ::accept(listener, nullptr, nullptr);
+    RELEASE_ASSERT(proxy_ != -1, "");
+    ::close(listener);
+    for (int fd : {peer_, proxy_}) {
+      ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+  }
+
+  ~LoopbackConnection() {
+    ::close(peer_);
+    ::close(proxy_);
+  }
+
+  int peer_;
+  int proxy_;
+};
+
+// Writes chunk to the downstream peer until the socket is full.
+void fill(int fd, const std::string& chunk) {
+  while (::write(fd, chunk.data(), chunk.size()) > 0) {
+  }
+}
+
+// Reads everything the upstream peer has received.
+uint64_t drain(int fd) {
+  static char sink[256 * 1024];
+  uint64_t total = 0;
+  ssize_t rc;
+  while ((rc = ::read(fd, sink, sizeof(sink))) > 0) {
+    total += rc;
+  }
+  return total;
+}
+
+// Forward through a buffer, like RawBufferSocket::doRead()/doWrite().
+static void BM_CopyForwarding(benchmark::State& state) {
+  LoopbackConnection downstream;
+  LoopbackConnection upstream;
+  Network::IoSocketHandleImpl source(::dup(downstream.proxy_));
+  Network::IoSocketHandleImpl destination(::dup(upstream.proxy_));
+  const std::string chunk(state.range(0), 'a');
+  uint64_t forwarded = 0;
+  Buffer::OwnedImpl buffer;
+  for (auto _ : state) {
+    fill(downstream.peer_, chunk);
+    while (buffer.read(source, 16 * 1024 * 1024).rc_ > 0 || buffer.length() > 0) {
+      if (!buffer.write(destination).ok()) {
+        break;
+      }
+    }
+    forwarded += drain(upstream.peer_);
+  }
+  state.SetBytesProcessed(forwarded);
+}
+BENCHMARK(BM_CopyForwarding)->Arg(16 * 1024)->Arg(256 * 1024);
+
+// Forward through a pipe, like Splicer.
+static void BM_SpliceForwarding(benchmark::State& state) {
+  LoopbackConnection downstream;
+  LoopbackConnection upstream;
+  int pipe_fds[2];
+  RELEASE_ASSERT(::pipe2(pipe_fds, O_NONBLOCK) == 0, "");
+  const std::string chunk(state.range(0), 'a');
+  uint64_t forwarded = 0;
+  uint64_t pipe_bytes = 0;
+  for (auto _ : state) {
+    fill(downstream.peer_, chunk);
+    while (true) {
+      if (pipe_bytes == 0) {
+        const ssize_t rc = ::splice(downstream.proxy_, nullptr, pipe_fds[1], nullptr, 64 * 1024,
+                                    SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (rc <= 0) {
+          break;
+        }
+        pipe_bytes = rc;
+      }
+      const ssize_t rc = ::splice(pipe_fds[0], nullptr, upstream.proxy_, nullptr, pipe_bytes,
+                                  SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (rc <= 0) {
+        break;
+      }
+      pipe_bytes -= rc;
+    }
+    forwarded += drain(upstream.peer_);
+  }
+  ::close(pipe_fds[0]);
+  ::close(pipe_fds[1]);
+  state.SetBytesProcessed(forwarded);
+}
+BENCHMARK(BM_SpliceForwarding)->Arg(16 * 1024)->Arg(256 * 1024);
+
+} // namespace TcpProxy
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,184 @@
+#include <sys/socket.h>
+
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/tcp_proxy/splicer.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace TcpProxy {
+namespace {
+
+class MockSplicerCallbacks : public SplicerCallbacks {
+public:
+  MOCK_METHOD1(onDownstreamBytesSpliced, void(uint64_t bytes));
+  MOCK_METHOD1(onUpstreamBytesSpliced, void(uint64_t bytes));
+  MOCK_METHOD1(onSpliceError, void(Network::Connection& connection));
+};
+
+// A connected pair of non-blocking stream sockets. The local end is the socket of a connection,
+// the remote end is its peer.
+struct SocketPair {
+  SocketPair() {
+    int fds[2];
+    RELEASE_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0, "");
+    local_ = std::make_unique<Network::IoSocketHandleImpl>(fds[0]);
+    remote_ = std::make_unique<Network::IoSocketHandleImpl>(fds[1]);
+  }
+
+  void writeRemote(const std::string& data) {
+    Buffer::OwnedImpl buffer(data);
+    while (buffer.length() > 0) {
+      RELEASE_ASSERT(buffer.write(*remote_).ok(), "");
+    }
+  }
+
+  std::string readRemote() {
+    Buffer::OwnedImpl buffer;
+    while (buffer.read(*remote_, 65536).rc_ > 0) {
+    }
+    return buffer.toString();
+  }
+
+  Network::IoHandlePtr local_;
+  Network::IoHandlePtr remote_;
+};
+
+class SplicerTest : public testing::Test {
+protected:
+  SplicerTest() : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher()) {
+    setupConnection(downstream_, downstream_sockets_);
+    setupConnection(upstream_, upstream_sockets_);
+  }
+
+  void setupConnection(NiceMock<Network::MockConnection>& connection, SocketPair& sockets) {
+    ON_CALL(connection, rawIoHandle()).WillByDefault(Return(sockets.local_.get()));
+    ON_CALL(connection, dispatcher()).WillByDefault(ReturnRef(*dispatcher_));
+    ON_CALL(connection, bufferLimit()).WillByDefault(Return(0));
+  }
+
+  void create() {
+    EXPECT_CALL(downstream_, readDisable(true));
+    EXPECT_CALL(upstream_, readDisable(true));
+    splicer_ = Splicer::create(downstream_, upstream_, callbacks_);
+    ASSERT_NE(nullptr, splicer_);
+  }
+
+  void run() { dispatcher_->run(Event::Dispatcher::RunType::NonBlock); }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  SocketPair downstream_sockets_;
+  SocketPair upstream_sockets_;
+  NiceMock<Network::MockConnection> downstream_;
+  NiceMock<Network::MockConnection> upstream_;
+  NiceMock<MockSplicerCallbacks> callbacks_;
+  SplicerPtr splicer_;
+};
+
+TEST_F(SplicerTest, NotAvailable) {
+  EXPECT_CALL(upstream_, rawIoHandle()).WillOnce(Return(nullptr));
+  EXPECT_CALL(downstream_, readDisable(_)).Times(0);
+  EXPECT_CALL(upstream_, readDisable(_)).Times(0);
+  EXPECT_EQ(nullptr, Splicer::create(downstream_, upstream_, callbacks_));
+}
+
+TEST_F(SplicerTest, SpliceBothDirections) {
+  // Data that is already waiting on the sockets is spliced as well.
+  downstream_sockets_.writeRemote("hello");
+  create();
+
+  EXPECT_CALL(callbacks_, onDownstreamBytesSpliced(5));
+  run();
+  EXPECT_EQ("hello", upstream_sockets_.readRemote());
+
+  EXPECT_CALL(callbacks_, onUpstreamBytesSpliced(5));
+  upstream_sockets_.writeRemote("world");
+  run();
+  EXPECT_EQ("world", downstream_sockets_.readRemote());
+  EXPECT_TRUE(splicer_->active());
+}
+
+TEST_F(SplicerTest, LargeTransfer) {
+  create();
+
+  // More than the capacity of the pipe and of the socket buffers.
+  const std::string data(4 * 1024 * 1024, 'a');
+  Buffer::OwnedImpl to_write(data);
+  std::string received;
+  uint64_t spliced = 0;
+  ON_CALL(callbacks_, onDownstreamBytesSpliced(_)).WillByDefault(Invoke([&](uint64_t bytes) {
+    spliced += bytes;
+  }));
+  while (received.size() < data.size()) {
+    if (to_write.length() > 0) {
+      to_write.write(*downstream_sockets_.remote_);
+    }
+    run();
+    received += upstream_sockets_.readRemote();
+  }
+  EXPECT_EQ(data, received);
+  EXPECT_EQ(data.size(), spliced);
+}
+
+TEST_F(SplicerTest, EndStreamIsHandedBack) {
+  create();
+
+  downstream_sockets_.writeRemote("hello");
+  ::shutdown(downstream_sockets_.remote_->fd(), SHUT_WR);
+  EXPECT_CALL(downstream_, readDisable(false));
+  EXPECT_CALL(upstream_, readDisable(false)).Times(0);
+  run();
+  EXPECT_EQ("hello", upstream_sockets_.readRemote());
+  EXPECT_TRUE(splicer_->active());
+
+  // The other direction keeps splicing.
+  upstream_sockets_.writeRemote("world");
+  run();
+  EXPECT_EQ("world", downstream_sockets_.readRemote());
+
+  ::shutdown(upstream_sockets_.remote_->fd(), SHUT_WR);
+  EXPECT_CALL(upstream_, readDisable(false));
+  run();
+  EXPECT_FALSE(splicer_->active());
+}
+
+TEST_F(SplicerTest, WriteError) {
+  create();
+
+  upstream_sockets_.remote_->close();
+  downstream_sockets_.writeRemote("hello");
+  EXPECT_CALL(callbacks_, onSpliceError(_)).WillOnce(Invoke([&](Network::Connection& connection) {
+    EXPECT_EQ(&upstream_, &connection);
+  }));
+  run();
+  EXPECT_FALSE(splicer_->active());
+}
+
+TEST_F(SplicerTest, Disable) {
+  create();
+  splicer_->disable();
+  EXPECT_FALSE(splicer_->active());
+
+  downstream_sockets_.writeRemote("hello");
+  EXPECT_CALL(callbacks_, onDownstreamBytesSpliced(_)).Times(0);
+  run();
+  EXPECT_EQ("", upstream_sockets_.readRemote());
+}
+
+} // namespace
+} // namespace TcpProxy
+} // namespace Envoy
@@ -1,3 +1,5 @@
+#include <sys/socket.h>
+
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -7,6 +9,7 @@
 #include "common/buffer/buffer_impl.h"
 #include "common/config/filter_json.h"
 #include "common/network/address_impl.h"
+#include "common/network/io_socket_handle_impl.h"
 #include "common/network/transport_socket_options_impl.h"
 #include "common/network/upstream_server_name.h"
 #include "common/router/metadatamatchcriteria_impl.h"
@@ -1116,6 +1119,59 @@ TEST_F(TcpProxyTest, UpstreamFlushReceiveUpstreamData) {
   upstream_callbacks_->onUpstreamData(buffer, false);
 }
 
+// Tests that data is forwarded through the connection buffers when it cannot bypass them.
+TEST_F(TcpProxyTest, ZeroCopyForwardingUnavailable) {
+  envoy::config::filter::network::tcp_proxy::v2::TcpProxy config = defaultConfig();
+  config.set_zero_copy_forwarding(true);
+  setup(1, config);
+
+  EXPECT_CALL(filter_callbacks_.connection_, rawIoHandle()).WillOnce(Return(nullptr));
+  raiseEventUpstreamConnected(0);
+  EXPECT_EQ(0U, config_->stats().splice_cx_total_.value());
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferEqual(&buffer), false));
+  filter_->onData(buffer, false);
+  EXPECT_EQ(5U, config_->stats().copy_bytes_total_.value());
+}
+
+TEST_F(TcpProxyTest, ZeroCopyForwarding) {
+  envoy::config::filter::network::tcp_proxy::v2::TcpProxy config =
+      accessLogConfig("bytesreceived=%BYTES_RECEIVED% bytessent=%BYTES_SENT%");
+  config.set_zero_copy_forwarding(true);
+  setup(1, config);
+
+  int fds[2];
+  ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+  Network::IoSocketHandleImpl downstream_handle(fds[0]);
+  Network::IoSocketHandleImpl upstream_handle(fds[1]);
+  ON_CALL(filter_callbacks_.connection_, rawIoHandle()).WillByDefault(Return(&downstream_handle));
+  ON_CALL(*upstream_connections_.at(0), rawIoHandle()).WillByDefault(Return(&upstream_handle));
+  EXPECT_CALL(filter_callbacks_.connection_.dispatcher_, createFileEvent_(_, _, _, _))
+      .Times(2)
+      .WillRepeatedly(InvokeWithoutArgs(
+          []() -> Event::FileEvent* { return new NiceMock<Event::MockFileEvent>(); }));
+  EXPECT_CALL(filter_callbacks_.connection_, readDisable(true));
+  EXPECT_CALL(*upstream_connections_.at(0), readDisable(true));
+  raiseEventUpstreamConnected(0);
+  EXPECT_EQ(1U, config_->stats().splice_cx_total_.value());
+
+  filter_->onDownstreamBytesSpliced(3);
+  filter_->onUpstreamBytesSpliced(4);
+  EXPECT_EQ(7U, config_->stats().splice_bytes_total_.value());
+  EXPECT_EQ(0U, config_->stats().copy_bytes_total_.value());
+  EXPECT_EQ(3U, config_->stats().downstream_cx_rx_bytes_total_.value());
+  EXPECT_EQ(4U, config_->stats().downstream_cx_tx_bytes_total_.value());
+
+  // A splice error closes the failed connection, which closes the other one.
+  EXPECT_CALL(filter_callbacks_.connection_.dispatcher_, deferredDelete_(_));
+  EXPECT_CALL(*upstream_connections_.at(0), close(Network::ConnectionCloseType::NoFlush));
+  filter_->onSpliceError(filter_callbacks_.connection_);
+  filter_.reset();
+
+  EXPECT_EQ(access_log_data_, "bytesreceived=3 bytessent=4");
+}
+
 class TcpProxyRoutingTest : public testing::Test {
 public:
   TcpProxyRoutingTest() {
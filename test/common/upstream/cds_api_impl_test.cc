@@ -305,6 +305,51 @@ TEST_F(CdsApiImplTest, DeltaConfigUpdate) {
   }
 }
 
+// Validate that all cluster changes of a config update are made in a single cluster update batch.
+TEST_F(CdsApiImplTest, ConfigUpdateIsBatched) {
+  {
+    InSequence s;
+    setup();
+  }
+  EXPECT_CALL(initialized_, ready());
+  EXPECT_CALL(request_, cancel());
+
+  Protobuf::RepeatedPtrField<envoy::api::v2::Resource> resources;
+  envoy::api::v2::Cluster cluster;
+  cluster.set_name("cluster_1");
+  auto* resource = resources.Add();
+  resource->mutable_resource()->PackFrom(cluster);
+  resource->set_name("cluster_1");
+  Protobuf::RepeatedPtrField<std::string> removed;
+  *removed.Add() = "cluster_2";
+
+  InSequence s;
+  EXPECT_CALL(cm_, beginClusterUpdateBatch());
+  cm_.expectAdd("cluster_1");
+  EXPECT_CALL(cm_, removeCluster(StrEq("cluster_2"))).WillOnce(Return(true));
+  EXPECT_CALL(cm_, endClusterUpdateBatch());
+  dynamic_cast<CdsApiImpl*>(cds_.get())->onConfigUpdate(resources, removed, "");
+}
+
+// Validate that the cluster update batch ends when the config update is rejected.
+TEST_F(CdsApiImplTest, ConfigUpdateBatchEndsOnFailure) {
+  {
+    InSequence s;
+    setup();
+  }
+  EXPECT_CALL(cm_, clusters()).WillRepeatedly(Return(cluster_map_));
+  EXPECT_CALL(initialized_, ready());
+  EXPECT_CALL(request_, cancel());
+
+  Protobuf::RepeatedPtrField<ProtobufWkt::Any> clusters;
+  envoy::api::v2::Cluster cluster;
+  clusters.Add()->PackFrom(cluster);
+
+  EXPECT_CALL(cm_, beginClusterUpdateBatch());
+  EXPECT_CALL(cm_, endClusterUpdateBatch());
+  EXPECT_THROW(dynamic_cast<CdsApiImpl*>(cds_.get())->onConfigUpdate(clusters, ""), EnvoyException);
+}
+
 TEST_F(CdsApiImplTest, ConfigUpdateAddsSecondClusterEvenIfFirstThrows) {
   {
     InSequence s;
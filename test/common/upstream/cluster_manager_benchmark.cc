@@ -0,0 +1,202 @@
+// Usage: bazel run //test/common/upstream:cluster_manager_benchmark
+//
+// Measures how long it takes for a CDS sized set of clusters to be added to the cluster manager and
+// become visible on all workers, with and without a cluster update batch.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/api/api_impl.h"
+#include "common/http/context_impl.h"
+#include "common/singleton/manager_impl.h"
+#include "common/stats/isolated_store_impl.h"
+#include "common/thread_local/thread_local_impl.h"
+#include "common/upstream/cluster_factory_impl.h"
+#include "common/upstream/cluster_manager_impl.h"
+
+#include "extensions/transport_sockets/tls/context_manager_impl.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/secret/mocks.h"
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+// Creates real clusters. Connection pools and CDS are never needed by the benchmark.
+class BenchmarkClusterManagerFactory : public ClusterManagerFactory {
+public:
+  BenchmarkClusterManagerFactory(Stats::Store& stats, ThreadLocal::Instance& tls, Api::Api& api,
+                                 Event::Dispatcher& dispatcher)
+      : stats_(stats), tls_(tls), api_(api), dispatcher_(dispatcher),
+        ssl_context_manager_(dispatcher.timeSource()) {}
+
+  ClusterManagerPtr
+  clusterManagerFromProto(const envoy::config::bootstrap::v2::Bootstrap&) override {
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+  }
+  Http::ConnectionPool::InstancePtr
+  allocateConnPool(Event::Dispatcher&, HostConstSharedPtr, ResourcePriority, Http::Protocol,
+                   const Network::ConnectionSocket::OptionsSharedPtr&) override {
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+  }
+  Tcp::ConnectionPool::InstancePtr
+  allocateTcpConnPool(Event::Dispatcher&, HostConstSharedPtr, ResourcePriority,
+                      const Network::ConnectionSocket::OptionsSharedPtr&,
+                      Network::TransportSocketOptionsSharedPtr) override {
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+  }
+  ClusterSharedPtr clusterFromProto(const envoy::api::v2::Cluster& cluster, ClusterManager& cm,
+                                    Outlier::EventLoggerSharedPtr outlier_event_logger,
+                                    bool added_via_api) override {
+    return ClusterFactoryImplBase::create(cluster, cm, stats_, tls_, dns_resolver_,
+                                          ssl_context_manager_, runtime_, random_, dispatcher_,
+                                          log_manager_, local_info_, admin_, singleton_manager_,
+                                          outlier_event_logger, added_via_api, api_);
+  }
+  CdsApiPtr createCds(const envoy::api::v2::core::ConfigSource&, ClusterManager&) override {
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+  }
+  Secret::SecretManager& secretManager() override { return secret_manager_; }
+
+  Stats::Store& stats_;
+  ThreadLocal::Instance& tls_;
+  Api::Api& api_;
+  Event::Dispatcher& dispatcher_;
+  std::shared_ptr<NiceMock<Network::MockDnsResolver>> dns_resolver_{
+      new NiceMock<Network::MockDnsResolver>};
+  Extensions::TransportSockets::Tls::ContextManagerImpl ssl_context_manager_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Runtime::MockRandomGenerator> random_;
+  NiceMock<AccessLog::MockAccessLogManager> log_manager_;
+  NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  NiceMock<Server::MockAdmin> admin_;
+  NiceMock<Secret::MockSecretManager> secret_manager_;
+  Singleton::ManagerImpl singleton_manager_{Thread::threadFactoryForTest().currentThreadId()};
+};
+
+// A cluster manager whose thread local state lives on real worker threads.
+class ClusterManagerTester {
+public:
+  ClusterManagerTester(uint32_t num_workers)
+      : api_(Api::createApiForTest(stats_)), dispatcher_(api_->allocateDispatcher()),
+        http_context_(stats_.symbolTable()), factory_(stats_, tls_, *api_, *dispatcher_) {
+    tls_.registerThread(*dispatcher_, true);
+    for (uint32_t i = 0; i < num_workers; i++) {
+      worker_dispatchers_.push_back(api_->allocateDispatcher());
+      Event::Dispatcher& worker_dispatcher = *worker_dispatchers_.back();
+      tls_.registerThread(worker_dispatcher, false);
+      workers_.push_back(api_->threadFactory().createThread([&worker_dispatcher]() {
+        worker_dispatcher.run(Event::Dispatcher::RunType::RunUntilExit);
+      }));
+    }
+    cluster_manager_ = std::make_unique<ClusterManagerImpl>(
+        envoy::config::bootstrap::v2::Bootstrap(), factory_, stats_, tls_, factory_.runtime_,
+        factory_.random_, factory_.local_info_, factory_.log_manager_, *dispatcher_,
+        factory_.admin_, *api_, http_context_);
+  }
+
+  ~ClusterManagerTester() {
+    cluster_manager_->shutdown();
+    tls_.shutdownGlobalThreading();
+    for (auto& worker_dispatcher : worker_dispatchers_) {
+      worker_dispatcher->post([this, &worker_dispatcher]() {
+        tls_.shutdownThread();
+        worker_dispatcher->exit();
+      });
+    }
+    for (auto& worker : workers_) {
+      worker->join();
+    }
+    tls_.shutdownThread();
+    cluster_manager_.reset();
+  }
+
+  // Waits until all workers have applied all updates posted so far.
+  void waitForWorkers() {
+    ThreadLocal::SlotPtr slot = tls_.allocateSlot();
+    slot->runOnAllThreads([]() -> void {}, [this]() -> void { dispatcher_->exit(); });
+    dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  }
+
+  Stats::IsolatedStoreImpl stats_;
+  ThreadLocal::InstanceImpl tls_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Http::ContextImpl http_context_;
+  BenchmarkClusterManagerFactory factory_;
+  std::vector<Event::DispatcherPtr> worker_dispatchers_;
+  std::vector<Thread::ThreadPtr> workers_;
+  std::unique_ptr<ClusterManagerImpl> cluster_manager_;
+};
+
+// Adds and then removes state.range(0) clusters with state.range(1) workers. When state.range(2)
+// is set, the clusters are added within a single cluster update batch, as CDS does.
+void BM_AddClusters(benchmark::State& state) {
+  const uint64_t num_clusters = state.range(0);
+  const bool batched = state.range(2) != 0;
+  ClusterManagerTester tester(state.range(1));
+  std::vector<envoy::api::v2::Cluster> clusters;
+  for (uint64_t i = 0; i < num_clusters; i++) {
+    clusters.push_back(defaultStaticCluster(fmt::format("cluster_{}", i)));
+  }
+  const ClusterManager::ClusterWarmingCallback warming_cb = [](auto, auto) {};
+
+  for (auto _ : state) {
+    if (batched) {
+      tester.cluster_manager_->beginClusterUpdateBatch();
+    }
+    for (const auto& cluster : clusters) {
+      tester.cluster_manager_->addOrUpdateCluster(cluster, "", warming_cb);
+    }
+    if (batched) {
+      tester.cluster_manager_->endClusterUpdateBatch();
+    }
+    tester.waitForWorkers();
+
+    state.PauseTiming();
+    tester.cluster_manager_->beginClusterUpdateBatch();
+    for (const auto& cluster : clusters) {
+      tester.cluster_manager_->removeCluster(cluster.name());
+    }
+    tester.cluster_manager_->endClusterUpdateBatch();
+    tester.waitForWorkers();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * num_clusters);
+}
+BENCHMARK(BM_AddClusters)
+    ->Args({10000, 4, 0})
+    ->Args({10000, 4, 1})
+    ->Args({50000, 4, 0})
+    ->Args({50000, 4, 1})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  // The cluster manager logs every cluster it adds or removes at info level.
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -1300,6 +1300,65 @@ TEST_F(ClusterManagerImplTest, DynamicAddRemove) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(callbacks.get()));
 }
 
+// Validate that the thread local changes of a cluster update batch are posted to the workers at
+// once, in the order they were made.
+TEST_F(ClusterManagerImplTest, DynamicAddRemoveBatched) {
+  create(defaultConfig());
+
+  std::unique_ptr<MockClusterUpdateCallbacks> callbacks(new NiceMock<MockClusterUpdateCallbacks>());
+  ClusterUpdateCallbacksHandlePtr cb =
+      cluster_manager_->addThreadLocalClusterUpdateCallbacks(*callbacks);
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  cluster1->info_->name_ = "cluster1";
+  std::shared_ptr<MockClusterMockPrioritySet> cluster2(new NiceMock<MockClusterMockPrioritySet>());
+  cluster2->info_->name_ = "cluster2";
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(cluster1))
+      .WillOnce(Return(cluster2));
+  for (auto* cluster : {cluster1.get(), cluster2.get()}) {
+    EXPECT_CALL(*cluster, initialize(_))
+        .WillOnce(Invoke([](std::function<void()> initialize_callback) { initialize_callback(); }));
+  }
+
+  cluster_manager_->beginClusterUpdateBatch();
+  EXPECT_CALL(factory_.tls_, runOnAllThreads(_)).Times(0);
+  EXPECT_CALL(factory_.tls_, runOnAllThreads(_, _)).Times(0);
+  EXPECT_CALL(*callbacks, onClusterAddOrUpdate(_)).Times(0);
+  EXPECT_TRUE(
+      cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster1"), "", dummyWarmingCb));
+  EXPECT_TRUE(
+      cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster2"), "", dummyWarmingCb));
+  EXPECT_TRUE(cluster_manager_->removeCluster("cluster1"));
+  EXPECT_EQ(nullptr, cluster_manager_->get("cluster2"));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(&factory_.tls_));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(callbacks.get()));
+
+  {
+    InSequence s;
+    EXPECT_CALL(factory_.tls_, runOnAllThreads(_, _))
+        .WillOnce(Invoke(&factory_.tls_, &ThreadLocal::MockInstance::runOnAllThreads2_));
+    EXPECT_CALL(*callbacks, onClusterAddOrUpdate(_));
+    EXPECT_CALL(*callbacks, onClusterAddOrUpdate(_));
+    EXPECT_CALL(*callbacks, onClusterRemoval("cluster1"));
+  }
+  EXPECT_CALL(factory_.tls_, runOnAllThreads(_)).Times(0);
+  cluster_manager_->endClusterUpdateBatch();
+
+  EXPECT_EQ(nullptr, cluster_manager_->get("cluster1"));
+  EXPECT_EQ(cluster2->info_, cluster_manager_->get("cluster2")->info());
+  checkStats(2 /*added*/, 0 /*modified*/, 1 /*removed*/, 1 /*active*/, 0 /*warming*/);
+
+  // An empty batch posts nothing.
+  EXPECT_CALL(factory_.tls_, runOnAllThreads(_, _)).Times(0);
+  cluster_manager_->beginClusterUpdateBatch();
+  cluster_manager_->endClusterUpdateBatch();
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster2.get()));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(callbacks.get()));
+}
+
 TEST_F(ClusterManagerImplTest, addOrUpdateClusterStaticExists) {
   const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
                                         clustersJson({defaultStaticClusterJson("fake_cluster")}));
@@ -0,0 +1,163 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/http/header_map_impl.h"
+
+#include "extensions/access_loggers/columnar_file/columnar_file_access_log_impl.h"
+
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace ColumnarFile {
+namespace {
+
+class ColumnarFileAccessLogTest : public testing::Test {
+public:
+  void initialize(uint64_t max_entries_per_block, AccessLog::FilterPtr&& filter = nullptr) {
+    flush_timer_ = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
+    log_ = std::make_unique<ColumnarFileAccessLog>(std::move(filter), file_,
+                                                   max_entries_per_block, 500ms, tls_);
+  }
+
+  void expectWrite() {
+    EXPECT_CALL(*file_, write(_)).WillOnce(Invoke([this](absl::string_view data) {
+      written_.append(data.data(), data.size());
+    }));
+  }
+
+  std::vector<ColumnarRecord> decodeWritten() {
+    std::vector<ColumnarRecord> records;
+    absl::string_view remaining = written_;
+    while (!remaining.empty()) {
+      const size_t size = ColumnarBlockDecoder::decode(remaining, records);
+      EXPECT_NE(0U, size);
+      if (size == 0) {
+        break;
+      }
+      remaining.remove_prefix(size);
+    }
+    return records;
+  }
+
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  std::shared_ptr<AccessLog::MockAccessLogFile> file_{new AccessLog::MockAccessLogFile()};
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+  Http::TestHeaderMapImpl request_headers_{
+      {":method", "GET"}, {":authority", "example.com"}, {":path", "/rewritten"},
+      {"x-envoy-original-path", "/original"}};
+  Event::MockTimer* flush_timer_{};
+  std::unique_ptr<ColumnarFileAccessLog> log_;
+  std::string written_;
+};
+
+TEST_F(ColumnarFileAccessLogTest, FlushOnTimer) {
+  initialize(1024);
+  stream_info_.start_time_ = SystemTime(1000001us);
+  stream_info_.end_time_ = 2ms;
+  stream_info_.response_code_ = 503;
+  stream_info_.protocol_ = Http::Protocol::Http11;
+  stream_info_.bytes_received_ = 10;
+  stream_info_.bytes_sent_ = 20;
+  stream_info_.route_name_ = "route";
+  EXPECT_CALL(stream_info_, hasAnyResponseFlag()).WillRepeatedly(Return(true));
+  EXPECT_CALL(stream_info_, hasResponseFlag(_)).WillRepeatedly(Return(false));
+  EXPECT_CALL(stream_info_, hasResponseFlag(StreamInfo::ResponseFlag::NoHealthyUpstream))
+      .WillRepeatedly(Return(true));
+
+  // The first entry of a block starts the flush timer.
+  EXPECT_CALL(*flush_timer_, enableTimer(std::chrono::milliseconds(500)));
+  EXPECT_CALL(*file_, write(_)).Times(0);
+  log_->log(&request_headers_, nullptr, nullptr, stream_info_);
+  EXPECT_CALL(*flush_timer_, enableTimer(_)).Times(0);
+  log_->log(nullptr, nullptr, nullptr, stream_info_);
+  testing::Mock::VerifyAndClearExpectations(file_.get());
+
+  expectWrite();
+  flush_timer_->invokeCallback();
+
+  const std::vector<ColumnarRecord> records = decodeWritten();
+  ASSERT_EQ(2U, records.size());
+  EXPECT_EQ(1000001U, records[0].start_time_us_);
+  EXPECT_EQ(2000U, records[0].duration_us_.value());
+  EXPECT_EQ(503U, records[0].response_code_);
+  EXPECT_EQ(static_cast<uint64_t>(StreamInfo::ResponseFlag::NoHealthyUpstream),
+            records[0].response_flags_);
+  EXPECT_EQ(Http::Protocol::Http11, records[0].protocol_.value());
+  EXPECT_EQ(10U, records[0].bytes_received_);
+  EXPECT_EQ(20U, records[0].bytes_sent_);
+  EXPECT_EQ("GET", records[0].method_);
+  EXPECT_EQ("example.com", records[0].authority_);
+  EXPECT_EQ("/original", records[0].path_);
+  EXPECT_EQ("fake_cluster", records[0].upstream_cluster_);
+  EXPECT_EQ("10.0.0.1:443", records[0].upstream_host_);
+  EXPECT_EQ("route", records[0].route_name_);
+  EXPECT_EQ("127.0.0.1:0", records[0].downstream_remote_address_);
+
+  // The entry logged without request headers.
+  EXPECT_EQ("", records[1].method_);
+  EXPECT_EQ("", records[1].path_);
+  EXPECT_EQ(503U, records[1].response_code_);
+
+  // Nothing is written when the block is empty.
+  EXPECT_CALL(*file_, write(_)).Times(0);
+  log_.reset();
+}
+
+TEST_F(ColumnarFileAccessLogTest, FlushFullBlock) {
+  initialize(2);
+
+  EXPECT_CALL(*file_, write(_)).Times(0);
+  log_->log(&request_headers_, nullptr, nullptr, stream_info_);
+  testing::Mock::VerifyAndClearExpectations(file_.get());
+
+  expectWrite();
+  log_->log(&request_headers_, nullptr, nullptr, stream_info_);
+  EXPECT_FALSE(flush_timer_->enabled_);
+  EXPECT_EQ(2U, decodeWritten().size());
+}
+
+TEST_F(ColumnarFileAccessLogTest, FlushOnDestruction) {
+  initialize(1024);
+
+  log_->log(&request_headers_, nullptr, nullptr, stream_info_);
+  expectWrite();
+  log_.reset();
+  EXPECT_EQ(1U, decodeWritten().size());
+}
+
+TEST_F(ColumnarFileAccessLogTest, Filter) {
+  AccessLog::MockFilter* filter = new AccessLog::MockFilter();
+  initialize(1, AccessLog::FilterPtr{filter});
+
+  EXPECT_CALL(*filter, evaluate(_, _, _, _)).WillOnce(Return(false));
+  EXPECT_CALL(*file_, write(_)).Times(0);
+  log_->log(&request_headers_, nullptr, nullptr, stream_info_);
+  testing::Mock::VerifyAndClearExpectations(file_.get());
+
+  EXPECT_CALL(*filter, evaluate(_, _, _, _)).WillOnce(Return(true));
+  expectWrite();
+  log_->log(&request_headers_, nullptr, nullptr, stream_info_);
+  EXPECT_EQ(1U, decodeWritten().size());
+}
+
+} // namespace
+} // namespace ColumnarFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
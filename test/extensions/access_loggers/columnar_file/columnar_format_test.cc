@@ -0,0 +1,158 @@
+#include <string>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "extensions/access_loggers/columnar_file/columnar_format.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace ColumnarFile {
+namespace {
+
+ColumnarRecord testRecord(uint64_t start_time_us, absl::string_view path) {
+  ColumnarRecord record;
+  record.start_time_us_ = start_time_us;
+  record.duration_us_ = 1500;
+  record.response_code_ = 200;
+  record.response_flags_ = 0x5;
+  record.protocol_ = Http::Protocol::Http2;
+  record.bytes_received_ = 10;
+  record.bytes_sent_ = 1 << 20;
+  record.method_ = "GET";
+  record.authority_ = "example.com";
+  record.path_ = path;
+  record.upstream_cluster_ = "cluster";
+  record.upstream_host_ = "10.0.0.1:443";
+  record.route_name_ = "route";
+  record.downstream_remote_address_ = "127.0.0.1:1234";
+  return record;
+}
+
+void expectRecordEq(const ColumnarRecord& expected, const ColumnarRecord& actual) {
+  EXPECT_EQ(expected.start_time_us_, actual.start_time_us_);
+  EXPECT_EQ(expected.duration_us_, actual.duration_us_);
+  EXPECT_EQ(expected.response_code_, actual.response_code_);
+  EXPECT_EQ(expected.response_flags_, actual.response_flags_);
+  EXPECT_EQ(expected.protocol_, actual.protocol_);
+  EXPECT_EQ(expected.bytes_received_, actual.bytes_received_);
+  EXPECT_EQ(expected.bytes_sent_, actual.bytes_sent_);
+  EXPECT_EQ(expected.method_, actual.method_);
+  EXPECT_EQ(expected.authority_, actual.authority_);
+  EXPECT_EQ(expected.path_, actual.path_);
+  EXPECT_EQ(expected.upstream_cluster_, actual.upstream_cluster_);
+  EXPECT_EQ(expected.upstream_host_, actual.upstream_host_);
+  EXPECT_EQ(expected.route_name_, actual.route_name_);
+  EXPECT_EQ(expected.downstream_remote_address_, actual.downstream_remote_address_);
+}
+
+TEST(ColumnarFormatTest, RoundTrip) {
+  std::vector<ColumnarRecord> expected;
+  expected.push_back(testRecord(1000000, "/a"));
+  // Start times are not ordered within a block.
+  expected.push_back(testRecord(900000, "/b"));
+  ColumnarRecord empty;
+  expected.push_back(empty);
+
+  ColumnarBlockEncoder encoder;
+  for (const ColumnarRecord& record : expected) {
+    encoder.add(record);
+  }
+  EXPECT_EQ(3U, encoder.records());
+  std::string block;
+  encoder.finish(block);
+  EXPECT_EQ(0U, encoder.records());
+
+  std::vector<ColumnarRecord> records;
+  EXPECT_EQ(block.size(), ColumnarBlockDecoder::decode(block, records));
+  ASSERT_EQ(3U, records.size());
+  for (size_t i = 0; i < records.size(); i++) {
+    expectRecordEq(expected[i], records[i]);
+  }
+}
+
+// Repeated strings are written once per block.
+TEST(ColumnarFormatTest, Dictionary) {
+  ColumnarBlockEncoder encoder;
+  std::string one_record;
+  encoder.add(testRecord(1000000, "/"));
+  encoder.finish(one_record);
+
+  std::string many_records;
+  for (uint64_t i = 0; i < 100; i++) {
+    encoder.add(testRecord(1000000 + i, "/"));
+  }
+  encoder.finish(many_records);
+
+  // Each further entry only costs a few bytes per column besides the path and the address.
+  EXPECT_LT(many_records.size(), one_record.size() + 99 * 40);
+
+  std::vector<ColumnarRecord> records;
+  EXPECT_EQ(many_records.size(), ColumnarBlockDecoder::decode(many_records, records));
+  ASSERT_EQ(100U, records.size());
+  expectRecordEq(testRecord(1000099, "/"), records.back());
+}
+
+TEST(ColumnarFormatTest, SeveralBlocks) {
+  ColumnarBlockEncoder encoder;
+  std::string data;
+  encoder.add(testRecord(1000000, "/a"));
+  encoder.finish(data);
+  encoder.add(testRecord(2000000, "/b"));
+  encoder.add(testRecord(3000000, "/c"));
+  encoder.finish(data);
+
+  std::vector<ColumnarRecord> records;
+  absl::string_view remaining = data;
+  while (!remaining.empty()) {
+    const size_t size = ColumnarBlockDecoder::decode(remaining, records);
+    ASSERT_NE(0U, size);
+    remaining.remove_prefix(size);
+  }
+  ASSERT_EQ(3U, records.size());
+  expectRecordEq(testRecord(1000000, "/a"), records[0]);
+  expectRecordEq(testRecord(2000000, "/b"), records[1]);
+  expectRecordEq(testRecord(3000000, "/c"), records[2]);
+}
+
+TEST(ColumnarFormatTest, TruncatedBlock) {
+  ColumnarBlockEncoder encoder;
+  std::string block;
+  encoder.add(testRecord(1000000, "/"));
+  encoder.finish(block);
+
+  std::vector<ColumnarRecord> records;
+  for (size_t size = 0; size < block.size(); size++) {
+    EXPECT_EQ(0U, ColumnarBlockDecoder::decode(absl::string_view(block).substr(0, size), records));
+  }
+  EXPECT_TRUE(records.empty());
+}
+
+TEST(ColumnarFormatTest, MalformedBlock) {
+  std::vector<ColumnarRecord> records;
+  EXPECT_THROW_WITH_MESSAGE(ColumnarBlockDecoder::decode("NOPE", records), EnvoyException,
+                            "columnar access log: bad block magic");
+  EXPECT_THROW_WITH_MESSAGE(ColumnarBlockDecoder::decode(absl::string_view("EACL\x02\x00", 6),
+                                                         records),
+                            EnvoyException, "columnar access log: unsupported version 2");
+
+  ColumnarBlockEncoder encoder;
+  std::string block;
+  encoder.add(ColumnarRecord());
+  encoder.finish(block);
+  // Claim many more entries than the block holds. The entry count of a small block follows the
+  // magic, the version and the one byte length.
+  block[6] = 0x7f;
+  EXPECT_THROW(ColumnarBlockDecoder::decode(block, records), EnvoyException);
+}
+
+} // namespace
+} // namespace ColumnarFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
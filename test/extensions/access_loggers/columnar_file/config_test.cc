@@ -0,0 +1,64 @@
+#include "envoy/config/accesslog/v2alpha/columnar_file.pb.h"
+#include "envoy/registry/registry.h"
+
+#include "common/access_log/access_log_impl.h"
+#include "common/protobuf/protobuf.h"
+
+#include "extensions/access_loggers/columnar_file/columnar_file_access_log_impl.h"
+#include "extensions/access_loggers/columnar_file/config.h"
+#include "extensions/access_loggers/well_known_names.h"
+
+#include "test/mocks/server/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace ColumnarFile {
+namespace {
+
+TEST(ColumnarFileAccessLogConfigTest, ValidateFail) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+
+  EXPECT_THROW(ColumnarFileAccessLogFactory().createAccessLogInstance(
+                   envoy::config::accesslog::v2alpha::ColumnarFileAccessLog(), nullptr, context),
+               ProtoValidationException);
+}
+
+TEST(ColumnarFileAccessLogConfigTest, ConfigureFromProto) {
+  envoy::config::filter::accesslog::v2::AccessLog config;
+  config.set_name(AccessLogNames::get().ColumnarFile);
+
+  envoy::config::accesslog::v2alpha::ColumnarFileAccessLog columnar_config;
+  columnar_config.set_path("/dev/null");
+  columnar_config.mutable_max_entries_per_block()->set_value(16);
+  MessageUtil::jsonConvert(columnar_config, *config.mutable_config());
+
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  EXPECT_CALL(context.access_log_manager_, createAccessLog("/dev/null"));
+  AccessLog::InstanceSharedPtr log = AccessLog::AccessLogFactory::fromProto(config, context);
+
+  EXPECT_NE(nullptr, log);
+  EXPECT_NE(nullptr, dynamic_cast<ColumnarFileAccessLog*>(log.get()));
+}
+
+TEST(ColumnarFileAccessLogConfigTest, ZeroEntriesPerBlock) {
+  envoy::config::accesslog::v2alpha::ColumnarFileAccessLog columnar_config;
+  columnar_config.set_path("/dev/null");
+  columnar_config.mutable_max_entries_per_block()->set_value(0);
+
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  EXPECT_THROW(ColumnarFileAccessLogFactory().createAccessLogInstance(columnar_config, nullptr,
+                                                                      context),
+               ProtoValidationException);
+}
+
+} // namespace
+} // namespace ColumnarFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -1,10 +1,12 @@
 #include <memory>
 
 #include "common/network/address_impl.h"
+#include "common/stats/isolated_store_impl.h"
 
 #include "extensions/access_loggers/http_grpc/grpc_access_log_impl.h"
 
 #include "test/mocks/access_log/mocks.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/grpc/mocks.h"
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/ssl/mocks.h"
@@ -63,22 +65,25 @@ TEST_F(GrpcAccessLogStreamerImplTest, BasicFlow) {
   AccessLogCallbacks* callbacks1;
   expectStreamStart(stream1, &callbacks1);
   EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream1, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
   EXPECT_CALL(stream1, sendMessage(_, false));
   envoy::service::accesslog::v2::StreamAccessLogsMessage message_log1;
-  streamer_->send(message_log1, "log1");
+  EXPECT_TRUE(streamer_->send(message_log1, "log1", Grpc::CompressionAlgorithm::None));
 
   message_log1.Clear();
+  EXPECT_CALL(stream1, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
   EXPECT_CALL(stream1, sendMessage(_, false));
-  streamer_->send(message_log1, "log1");
+  EXPECT_TRUE(streamer_->send(message_log1, "log1", Grpc::CompressionAlgorithm::None));
 
   // Start a stream for the second log.
   MockAccessLogStream stream2;
   AccessLogCallbacks* callbacks2;
   expectStreamStart(stream2, &callbacks2);
   EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream2, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
   EXPECT_CALL(stream2, sendMessage(_, false));
   envoy::service::accesslog::v2::StreamAccessLogsMessage message_log2;
-  streamer_->send(message_log2, "log2");
+  EXPECT_TRUE(streamer_->send(message_log2, "log2", Grpc::CompressionAlgorithm::None));
 
   // Verify that sending an empty response message doesn't do anything bad.
   callbacks1->onReceiveMessage(
@@ -88,8 +93,9 @@ TEST_F(GrpcAccessLogStreamerImplTest, BasicFlow) {
   callbacks2->onRemoteClose(Grpc::Status::Internal, "bad");
   expectStreamStart(stream2, &callbacks2);
   EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream2, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
   EXPECT_CALL(stream2, sendMessage(_, false));
-  streamer_->send(message_log2, "log2");
+  EXPECT_TRUE(streamer_->send(message_log2, "log2", Grpc::CompressionAlgorithm::None));
 }
 
 // Test that stream failure is handled correctly.
@@ -104,14 +110,90 @@ TEST_F(GrpcAccessLogStreamerImplTest, StreamFailure) {
           }));
   EXPECT_CALL(local_info_, node());
   envoy::service::accesslog::v2::StreamAccessLogsMessage message_log1;
-  streamer_->send(message_log1, "log1");
+  EXPECT_FALSE(streamer_->send(message_log1, "log1", Grpc::CompressionAlgorithm::None));
+}
+
+// Test that messages are dropped while the stream is backed up.
+TEST_F(GrpcAccessLogStreamerImplTest, WriteBufferAboveHighWatermark) {
+  InSequence s;
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  EXPECT_CALL(stream, sendMessage(_, _)).Times(0);
+  envoy::service::accesslog::v2::StreamAccessLogsMessage message;
+  EXPECT_FALSE(streamer_->send(message, "log", Grpc::CompressionAlgorithm::None));
+
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
+  EXPECT_CALL(stream, sendMessage(_, false));
+  EXPECT_TRUE(streamer_->send(message, "log", Grpc::CompressionAlgorithm::None));
+}
+
+// Test that a compressed stream asks for gzip encoded messages.
+TEST_F(GrpcAccessLogStreamerImplTest, Compression) {
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
+  EXPECT_CALL(stream, sendMessage(_, false));
+  envoy::service::accesslog::v2::StreamAccessLogsMessage message;
+  EXPECT_TRUE(streamer_->send(message, "log", Grpc::CompressionAlgorithm::Gzip));
+
+  Http::TestHeaderMapImpl metadata;
+  callbacks->onCreateInitialMetadata(metadata);
+  EXPECT_EQ("gzip", metadata.get_("grpc-encoding"));
+}
+
+// Access logs which share a log name but not the compression are sent on separate streams.
+TEST_F(GrpcAccessLogStreamerImplTest, CompressionOfSameLogName) {
+  MockAccessLogStream stream1;
+  AccessLogCallbacks* callbacks1;
+  expectStreamStart(stream1, &callbacks1);
+  EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream1, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
+  EXPECT_CALL(stream1, sendMessage(_, false));
+  envoy::service::accesslog::v2::StreamAccessLogsMessage message1;
+  EXPECT_TRUE(streamer_->send(message1, "log", Grpc::CompressionAlgorithm::None));
+
+  MockAccessLogStream stream2;
+  AccessLogCallbacks* callbacks2;
+  expectStreamStart(stream2, &callbacks2);
+  EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream2, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
+  EXPECT_CALL(stream2, sendMessage(_, false));
+  envoy::service::accesslog::v2::StreamAccessLogsMessage message2;
+  EXPECT_TRUE(streamer_->send(message2, "log", Grpc::CompressionAlgorithm::Gzip));
+
+  Http::TestHeaderMapImpl metadata1;
+  callbacks1->onCreateInitialMetadata(metadata1);
+  EXPECT_FALSE(metadata1.has("grpc-encoding"));
+  Http::TestHeaderMapImpl metadata2;
+  callbacks2->onCreateInitialMetadata(metadata2);
+  EXPECT_EQ("gzip", metadata2.get_("grpc-encoding"));
+
+  // Both streams are reused.
+  EXPECT_CALL(stream1, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
+  EXPECT_CALL(stream1, sendMessage(_, false));
+  EXPECT_TRUE(streamer_->send(message1, "log", Grpc::CompressionAlgorithm::None));
+  EXPECT_CALL(stream2, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
+  EXPECT_CALL(stream2, sendMessage(_, false));
+  EXPECT_TRUE(streamer_->send(message2, "log", Grpc::CompressionAlgorithm::Gzip));
+
+  // Closing one stream leaves the other one in place.
+  callbacks2->onRemoteClose(Grpc::Status::Internal, "bad");
+  EXPECT_CALL(stream1, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
+  EXPECT_CALL(stream1, sendMessage(_, false));
+  EXPECT_TRUE(streamer_->send(message1, "log", Grpc::CompressionAlgorithm::None));
 }
 
 class MockGrpcAccessLogStreamer : public GrpcAccessLogStreamer {
 public:
   // GrpcAccessLogStreamer
-  MOCK_METHOD2(send, void(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
-                          const std::string& log_name));
+  MOCK_METHOD3(send, bool(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
+                          const std::string& log_name, Grpc::CompressionAlgorithm compression));
 };
 
 class HttpGrpcAccessLogTest : public testing::Test {
@@ -119,8 +201,12 @@ public:
   void init() {
     ON_CALL(*filter_, evaluate(_, _, _, _)).WillByDefault(Return(true));
     config_.mutable_common_config()->set_log_name("hello_log");
-    access_log_ =
-        std::make_unique<HttpGrpcAccessLog>(AccessLog::FilterPtr{filter_}, config_, streamer_);
+    if (!config_.common_config().has_buffer_size_bytes()) {
+      // Send each log in a message of its own unless a test batches them.
+      config_.mutable_common_config()->mutable_buffer_size_bytes()->set_value(0);
+    }
+    access_log_ = std::make_unique<HttpGrpcAccessLog>(AccessLog::FilterPtr{filter_}, config_,
+                                                      streamer_, tls_, stats_store_);
   }
 
   void expectLog(const std::string& expected_request_msg_yaml) {
@@ -130,11 +216,12 @@ public:
 
     envoy::service::accesslog::v2::StreamAccessLogsMessage expected_request_msg;
     MessageUtil::loadFromYaml(expected_request_msg_yaml, expected_request_msg);
-    EXPECT_CALL(*streamer_, send(_, "hello_log"))
+    EXPECT_CALL(*streamer_, send(_, "hello_log", Grpc::CompressionAlgorithm::None))
         .WillOnce(Invoke(
             [expected_request_msg](envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
-                                   const std::string&) {
+                                   const std::string&, Grpc::CompressionAlgorithm) {
               EXPECT_EQ(message.DebugString(), expected_request_msg.DebugString());
+              return true;
             }));
   }
 
@@ -171,6 +258,8 @@ public:
   AccessLog::MockFilter* filter_{new NiceMock<AccessLog::MockFilter>()};
   envoy::config::accesslog::v2::HttpGrpcAccessLogConfig config_;
   std::shared_ptr<MockGrpcAccessLogStreamer> streamer_{new MockGrpcAccessLogStreamer()};
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Stats::IsolatedStoreImpl stats_store_;
   std::unique_ptr<HttpGrpcAccessLog> access_log_;
 };
 
@@ -514,6 +603,70 @@ http_logs:
   }
 }
 
+// Test that logs are batched until the flush interval elapses.
+TEST_F(HttpGrpcAccessLogTest, FlushInterval) {
+  config_.mutable_common_config()->mutable_buffer_size_bytes()->set_value(1024 * 1024);
+  config_.mutable_common_config()->mutable_buffer_flush_interval()->set_seconds(2);
+  Event::MockTimer* flush_timer = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
+  init();
+
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  EXPECT_CALL(*flush_timer, enableTimer(std::chrono::milliseconds(2000)));
+  EXPECT_CALL(*streamer_, send(_, _, _)).Times(0);
+  for (int i = 0; i < 3; i++) {
+    access_log_->log(nullptr, nullptr, nullptr, stream_info);
+  }
+  testing::Mock::VerifyAndClearExpectations(streamer_.get());
+
+  EXPECT_CALL(*streamer_, send(_, "hello_log", Grpc::CompressionAlgorithm::None))
+      .WillOnce(Invoke([](envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
+                          const std::string&, Grpc::CompressionAlgorithm) {
+        EXPECT_EQ(3, message.http_logs().log_entry_size());
+        return true;
+      }));
+  flush_timer->invokeCallback();
+  EXPECT_EQ(3U, stats_store_.counter("access_logs.grpc_access_log.logs_written").value());
+
+  // An empty buffer is not sent.
+  EXPECT_CALL(*streamer_, send(_, _, _)).Times(0);
+  flush_timer->callback_();
+}
+
+// Test that logs are sent once they reach the buffer size.
+TEST_F(HttpGrpcAccessLogTest, BufferSize) {
+  config_.mutable_common_config()->mutable_buffer_size_bytes()->set_value(200);
+  config_.mutable_common_config()->set_gzip_compression(true);
+  init();
+
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  int logged = 0;
+  int sent = 0;
+  EXPECT_CALL(*streamer_, send(_, "hello_log", Grpc::CompressionAlgorithm::Gzip))
+      .WillOnce(Invoke([&sent](envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
+                               const std::string&, Grpc::CompressionAlgorithm) {
+        sent = message.http_logs().log_entry_size();
+        return true;
+      }));
+  while (sent == 0 && logged < 100) {
+    access_log_->log(nullptr, nullptr, nullptr, stream_info);
+    logged++;
+  }
+  EXPECT_GT(sent, 1);
+  EXPECT_EQ(logged, sent);
+}
+
+// Test that logs which cannot be sent are counted.
+TEST_F(HttpGrpcAccessLogTest, Dropped) {
+  init();
+
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  EXPECT_CALL(*streamer_, send(_, "hello_log", Grpc::CompressionAlgorithm::None))
+      .WillOnce(Return(false));
+  access_log_->log(nullptr, nullptr, nullptr, stream_info);
+  EXPECT_EQ(0U, stats_store_.counter("access_logs.grpc_access_log.logs_written").value());
+  EXPECT_EQ(1U, stats_store_.counter("access_logs.grpc_access_log.logs_dropped").value());
+}
+
 TEST(responseFlagsToAccessLogResponseFlagsTest, All) {
   NiceMock<StreamInfo::MockStreamInfo> stream_info;
   ON_CALL(stream_info, hasResponseFlag(_)).WillByDefault(Return(true));
@@ -0,0 +1,155 @@
+#include "envoy/compressor/config.h"
+#include "envoy/decompressor/config.h"
+#include "envoy/registry/registry.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/compression/deflate/compressor/config.h"
+#include "extensions/compression/deflate/decompressor/config.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Deflate {
+namespace {
+
+const char JsonResponse[] =
+    R"({"id": 42, "name": "deflate", "labels": {"team": "edge"}, "created_at": "today"})";
+
+class DeflateLibraryTest : public testing::Test {
+protected:
+  Envoy::Compressor::CompressorFactoryPtr createCompressorFactory(const std::string& yaml) {
+    auto* factory = Registry::FactoryRegistry<
+        Envoy::Compressor::NamedCompressorLibraryConfigFactory>::getFactory(
+        "envoy.compression.deflate.compressor");
+    EXPECT_NE(nullptr, factory);
+    ProtobufTypes::MessagePtr config = factory->createEmptyConfigProto();
+    MessageUtil::loadFromYaml(yaml, *config);
+    return factory->createCompressorFactoryFromProto(*config, context_);
+  }
+
+  Envoy::Decompressor::DecompressorFactoryPtr createDecompressorFactory(const std::string& yaml) {
+    auto* factory = Registry::FactoryRegistry<
+        Envoy::Decompressor::NamedDecompressorLibraryConfigFactory>::getFactory(
+        "envoy.compression.deflate.decompressor");
+    EXPECT_NE(nullptr, factory);
+    ProtobufTypes::MessagePtr config = factory->createEmptyConfigProto();
+    MessageUtil::loadFromYaml(yaml, *config);
+    return factory->createDecompressorFactoryFromProto(*config, context_);
+  }
+
+  static std::string compress(Envoy::Compressor::CompressorFactory& factory,
+                              const std::string& text) {
+    Envoy::Compressor::CompressorPtr compressor = factory.createCompressor();
+    Buffer::OwnedImpl data(text);
+    compressor->compress(data, Envoy::Compressor::State::Finish);
+    return data.toString();
+  }
+
+  static std::string decompress(Envoy::Decompressor::DecompressorFactory& factory,
+                                const std::string& compressed) {
+    Envoy::Decompressor::DecompressorPtr decompressor = factory.createDecompressor();
+    Buffer::OwnedImpl data(compressed);
+    Buffer::OwnedImpl decompressed;
+    decompressor->decompress(data, decompressed);
+    return decompressed.toString();
+  }
+
+  NiceMock<Server::Configuration::MockFactoryContext> context_;
+};
+
+TEST_F(DeflateLibraryTest, DefaultConfig) {
+  auto compressor_factory = createCompressorFactory("{}");
+  auto decompressor_factory = createDecompressorFactory("{}");
+  EXPECT_EQ("deflate", compressor_factory->contentEncoding());
+  EXPECT_EQ("deflate", decompressor_factory->contentEncoding());
+
+  Buffer::OwnedImpl data;
+  TestUtility::feedBufferWithRandomCharacters(data, 4096);
+  const std::string expected = data.toString();
+  EXPECT_EQ(expected, decompress(*decompressor_factory, compress(*compressor_factory, expected)));
+}
+
+// A dictionary holding the keys of the responses makes them smaller, and the decompressors need the
+// same dictionary.
+TEST_F(DeflateLibraryTest, Dictionary) {
+  const std::string dictionary_config = R"EOF(
+  dictionary:
+    inline_string: '{"id": , "name": "", "labels": {"team": ""}, "created_at": ""}'
+  content_coding: x-deflate-json
+  )EOF";
+  auto compressor_factory = createCompressorFactory(dictionary_config);
+  auto decompressor_factory = createDecompressorFactory(dictionary_config);
+  EXPECT_EQ("x-deflate-json", compressor_factory->contentEncoding());
+  EXPECT_EQ("x-deflate-json", decompressor_factory->contentEncoding());
+
+  const std::string compressed = compress(*compressor_factory, JsonResponse);
+  EXPECT_LT(compressed.size(), compress(*createCompressorFactory("{}"), JsonResponse).size());
+  EXPECT_EQ(JsonResponse, decompress(*decompressor_factory, compressed));
+  // Each compressor is primed with the dictionary.
+  EXPECT_EQ(compressed, compress(*compressor_factory, JsonResponse));
+
+  EXPECT_EQ("", decompress(*createDecompressorFactory("{}"), compressed));
+  auto other_decompressor_factory = createDecompressorFactory(R"EOF(
+  dictionary:
+    inline_string: 'another dictionary'
+  content_coding: x-deflate-json
+  )EOF");
+  EXPECT_EQ("", decompress(*other_decompressor_factory, compressed));
+}
+
+// Clients accepting the standard deflate content coding do not have the dictionary, so the
+// responses compressed with one are advertised with another content coding.
+TEST_F(DeflateLibraryTest, DictionaryRequiresContentCoding) {
+  EXPECT_THROW_WITH_MESSAGE(createCompressorFactory(R"EOF(
+  dictionary:
+    inline_string: 'dictionary'
+  )EOF"),
+                            EnvoyException,
+                            "deflate compressor: a dictionary requires a content coding other "
+                            "than 'deflate'");
+  EXPECT_THROW_WITH_MESSAGE(createCompressorFactory(R"EOF(
+  dictionary:
+    inline_string: 'dictionary'
+  content_coding: deflate
+  )EOF"),
+                            EnvoyException,
+                            "deflate compressor: a dictionary requires a content coding other "
+                            "than 'deflate'");
+
+  // The decompressor of the deflate content coding can read streams with or without the
+  // dictionary.
+  EXPECT_EQ("deflate", createDecompressorFactory(R"EOF(
+  dictionary:
+    inline_string: 'dictionary'
+  )EOF")
+                           ->contentEncoding());
+}
+
+TEST_F(DeflateLibraryTest, InvalidContentCoding) {
+  EXPECT_THROW_WITH_MESSAGE(createCompressorFactory("content_coding: X-Deflate"), EnvoyException,
+                            "deflate: invalid content coding 'X-Deflate': it must be made of "
+                            "lower case letters, digits and dashes");
+  EXPECT_THROW_WITH_MESSAGE(createDecompressorFactory("content_coding: 'x deflate'"),
+                            EnvoyException,
+                            "deflate: invalid content coding 'x deflate': it must be made of "
+                            "lower case letters, digits and dashes");
+  EXPECT_THROW_WITH_MESSAGE(createCompressorFactory("content_coding: gzip"), EnvoyException,
+                            "deflate: invalid content coding 'gzip': it is the name of another "
+                            "format");
+}
+
+} // namespace
+} // namespace Deflate
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
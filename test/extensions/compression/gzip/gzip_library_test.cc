@@ -0,0 +1,102 @@
+#include "envoy/compressor/config.h"
+#include "envoy/decompressor/config.h"
+#include "envoy/registry/registry.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/compression/gzip/compressor/config.h"
+#include "extensions/compression/gzip/decompressor/config.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Gzip {
+namespace {
+
+class GzipLibraryTest : public testing::Test {
+protected:
+  Envoy::Compressor::CompressorFactoryPtr createCompressorFactory(const std::string& yaml) {
+    auto* factory = Registry::FactoryRegistry<
+        Envoy::Compressor::NamedCompressorLibraryConfigFactory>::getFactory(
+        "envoy.compression.gzip.compressor");
+    EXPECT_NE(nullptr, factory);
+    ProtobufTypes::MessagePtr config = factory->createEmptyConfigProto();
+    MessageUtil::loadFromYaml(yaml, *config);
+    return factory->createCompressorFactoryFromProto(*config, context_);
+  }
+
+  Envoy::Decompressor::DecompressorFactoryPtr createDecompressorFactory(const std::string& yaml) {
+    auto* factory = Registry::FactoryRegistry<
+        Envoy::Decompressor::NamedDecompressorLibraryConfigFactory>::getFactory(
+        "envoy.compression.gzip.decompressor");
+    EXPECT_NE(nullptr, factory);
+    ProtobufTypes::MessagePtr config = factory->createEmptyConfigProto();
+    MessageUtil::loadFromYaml(yaml, *config);
+    return factory->createDecompressorFactoryFromProto(*config, context_);
+  }
+
+  NiceMock<Server::Configuration::MockFactoryContext> context_;
+};
+
+void roundTrip(Envoy::Compressor::CompressorFactory& compressor_factory,
+               Envoy::Decompressor::DecompressorFactory& decompressor_factory) {
+  EXPECT_EQ("gzip", compressor_factory.contentEncoding());
+  EXPECT_EQ("gzip", decompressor_factory.contentEncoding());
+
+  Envoy::Compressor::CompressorPtr compressor = compressor_factory.createCompressor();
+  Buffer::OwnedImpl data;
+  TestUtility::feedBufferWithRandomCharacters(data, 4096);
+  const std::string expected = data.toString();
+  compressor->compress(data, Envoy::Compressor::State::Finish);
+  EXPECT_NE(expected, data.toString());
+
+  Envoy::Decompressor::DecompressorPtr decompressor = decompressor_factory.createDecompressor();
+  Buffer::OwnedImpl decompressed;
+  decompressor->decompress(data, decompressed);
+  EXPECT_EQ(expected, decompressed.toString());
+}
+
+TEST_F(GzipLibraryTest, DefaultConfig) {
+  auto compressor_factory = createCompressorFactory("{}");
+  auto decompressor_factory = createDecompressorFactory("{}");
+  roundTrip(*compressor_factory, *decompressor_factory);
+}
+
+TEST_F(GzipLibraryTest, CustomConfig) {
+  auto compressor_factory = createCompressorFactory(R"EOF(
+  memory_level: 9
+  compression_level: BEST
+  compression_strategy: HUFFMAN
+  window_bits: 15
+  )EOF");
+  auto decompressor_factory = createDecompressorFactory(R"EOF(
+  window_bits: 15
+  chunk_size: 8192
+  )EOF");
+  roundTrip(*compressor_factory, *decompressor_factory);
+}
+
+// The compressors of a factory are independent of each other.
+TEST_F(GzipLibraryTest, IndependentCompressors) {
+  auto compressor_factory = createCompressorFactory("{}");
+  auto decompressor_factory = createDecompressorFactory("{}");
+  Envoy::Compressor::CompressorPtr compressor = compressor_factory->createCompressor();
+  Buffer::OwnedImpl unfinished("unfinished");
+  compressor->compress(unfinished, Envoy::Compressor::State::Flush);
+  roundTrip(*compressor_factory, *decompressor_factory);
+}
+
+} // namespace
+} // namespace Gzip
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,94 @@
+#include "extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
+
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace LocalRateLimit {
+namespace {
+
+envoy::type::TokenBucket tokenBucket(const std::string& yaml) {
+  envoy::type::TokenBucket token_bucket;
+  MessageUtil::loadFromYaml(yaml, token_bucket);
+  return token_bucket;
+}
+
+class LocalRateLimiterImplTest : public testing::Test {
+public:
+  const std::vector<RateLimit::Descriptor> no_descriptors_;
+  Event::SimulatedTimeSystem time_system_;
+};
+
+TEST_F(LocalRateLimiterImplTest, TokenBucket) {
+  LocalRateLimiterImpl rate_limiter(tokenBucket(R"EOF(
+  max_tokens: 2
+  tokens_per_fill: 2
+  fill_interval: 1s
+  )EOF"),
+                                    time_system_);
+  EXPECT_TRUE(rate_limiter.descriptorsEmpty());
+
+  EXPECT_TRUE(rate_limiter.requestAllowed(no_descriptors_));
+  EXPECT_TRUE(rate_limiter.requestAllowed(no_descriptors_));
+  EXPECT_FALSE(rate_limiter.requestAllowed(no_descriptors_));
+
+  // Tokens are returned gradually, at two per second.
+  time_system_.sleep(std::chrono::milliseconds(499));
+  EXPECT_FALSE(rate_limiter.requestAllowed(no_descriptors_));
+  time_system_.sleep(std::chrono::milliseconds(1));
+  EXPECT_TRUE(rate_limiter.requestAllowed(no_descriptors_));
+  EXPECT_FALSE(rate_limiter.requestAllowed(no_descriptors_));
+
+  // The bucket never holds more than max_tokens.
+  time_system_.sleep(std::chrono::seconds(10));
+  EXPECT_TRUE(rate_limiter.requestAllowed(no_descriptors_));
+  EXPECT_TRUE(rate_limiter.requestAllowed(no_descriptors_));
+  EXPECT_FALSE(rate_limiter.requestAllowed(no_descriptors_));
+}
+
+TEST_F(LocalRateLimiterImplTest, Descriptors) {
+  LocalRateLimiterImpl rate_limiter(tokenBucket(R"EOF(
+  max_tokens: 1
+  fill_interval: 60s
+  )EOF"),
+                                    time_system_);
+  rate_limiter.addDescriptor({{{"remote_address", "10.0.0.1"}}}, tokenBucket(R"EOF(
+  max_tokens: 2
+  fill_interval: 60s
+  )EOF"));
+  rate_limiter.addDescriptor({{{"generic_key", "a"}, {"header_match", "b"}}}, tokenBucket(R"EOF(
+  max_tokens: 1
+  fill_interval: 60s
+  )EOF"));
+  EXPECT_FALSE(rate_limiter.descriptorsEmpty());
+
+  const std::vector<RateLimit::Descriptor> address{{{{"remote_address", "10.0.0.1"}}}};
+  EXPECT_TRUE(rate_limiter.requestAllowed(address));
+  EXPECT_TRUE(rate_limiter.requestAllowed(address));
+  EXPECT_FALSE(rate_limiter.requestAllowed(address));
+
+  // The first matching descriptor selects the bucket.
+  const std::vector<RateLimit::Descriptor> composite{
+      {{{"generic_key", "a"}}},
+      {{{"generic_key", "a"}, {"header_match", "b"}}},
+      {{{"remote_address", "10.0.0.1"}}}};
+  EXPECT_TRUE(rate_limiter.requestAllowed(composite));
+  EXPECT_FALSE(rate_limiter.requestAllowed(composite));
+
+  // Requests without a matching descriptor use the default bucket.
+  const std::vector<RateLimit::Descriptor> other_address{{{{"remote_address", "10.0.0.2"}}}};
+  EXPECT_TRUE(rate_limiter.requestAllowed(other_address));
+  EXPECT_FALSE(rate_limiter.requestAllowed(no_descriptors_));
+}
+
+} // namespace
+} // namespace LocalRateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
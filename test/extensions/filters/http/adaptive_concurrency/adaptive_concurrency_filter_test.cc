@@ -0,0 +1,133 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "envoy/config/filter/http/adaptive_concurrency/v2alpha/adaptive_concurrency.pb.validate.h"
+
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/adaptive_concurrency/adaptive_concurrency_filter.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace AdaptiveConcurrency {
+namespace {
+
+class AdaptiveConcurrencyFilterTest : public testing::Test {
+public:
+  AdaptiveConcurrencyFilterTest() {
+    envoy::config::filter::http::adaptive_concurrency::v2alpha::AdaptiveConcurrency proto_config;
+    MessageUtil::loadFromYamlAndValidate(R"EOF(
+    gradient_controller_config:
+      concurrency_limit_params:
+        concurrency_update_interval: 0.1s
+      min_rtt_calc_params:
+        interval: 30s
+        request_count: 2
+        min_concurrency: 2
+    )EOF",
+                                         proto_config);
+    config_ = std::make_shared<AdaptiveConcurrencyFilterConfig>(proto_config, "prefix.", stats_,
+                                                                time_system_);
+  }
+
+  std::unique_ptr<AdaptiveConcurrencyFilter> createFilter() {
+    auto filter = std::make_unique<AdaptiveConcurrencyFilter>(config_);
+    filter->setDecoderFilterCallbacks(decoder_callbacks_);
+    return filter;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl stats_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  Http::TestHeaderMapImpl request_headers_{{":method", "GET"}, {":path", "/"}};
+  Http::TestHeaderMapImpl response_headers_{{":status", "200"}};
+  AdaptiveConcurrencyFilterConfigSharedPtr config_;
+};
+
+TEST_F(AdaptiveConcurrencyFilterTest, ConcurrencyLimitReached) {
+  auto filter1 = createFilter();
+  auto filter2 = createFilter();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter1->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter2->decodeHeaders(request_headers_, true));
+
+  auto filter3 = createFilter();
+  EXPECT_CALL(decoder_callbacks_, encodeHeaders_(HeaderHasValueRef(":status", "503"), false));
+  EXPECT_CALL(decoder_callbacks_.stream_info_,
+              setResponseFlag(StreamInfo::ResponseFlag::UpstreamOverflow));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter3->decodeHeaders(request_headers_, true));
+  EXPECT_EQ("reached_concurrency_limit", decoder_callbacks_.details_);
+  filter3->onDestroy();
+  EXPECT_EQ(1U, stats_.counter("prefix.adaptive_concurrency.fake_cluster.gradient_controller."
+                               "rq_blocked")
+                    .value());
+
+  // A reset request frees its slot without being sampled.
+  filter1->onDestroy();
+  auto filter4 = createFilter();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter4->decodeHeaders(request_headers_, true));
+
+  // The latency of the requests is sampled once the upstream answers them.
+  time_system_.sleep(std::chrono::milliseconds(10));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter2->encodeHeaders(response_headers_, true));
+  filter2->onDestroy();
+  time_system_.sleep(std::chrono::milliseconds(10));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter4->encodeHeaders(response_headers_, true));
+  filter4->onDestroy();
+  EXPECT_EQ(0U, stats_.gauge("prefix.adaptive_concurrency.fake_cluster.gradient_controller."
+                             "min_rtt_calculation_active")
+                    .value());
+  EXPECT_EQ(10U, stats_.gauge("prefix.adaptive_concurrency.fake_cluster.gradient_controller."
+                              "min_rtt_msecs")
+                     .value());
+}
+
+TEST_F(AdaptiveConcurrencyFilterTest, ControllerPerCluster) {
+  auto filter1 = createFilter();
+  auto filter2 = createFilter();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter1->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter2->decodeHeaders(request_headers_, true));
+
+  const std::string other_cluster = "other_cluster";
+  EXPECT_CALL(decoder_callbacks_.route_->route_entry_, clusterName())
+      .WillRepeatedly(ReturnRef(other_cluster));
+  auto filter3 = createFilter();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter3->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(2U, stats_.gauge("prefix.adaptive_concurrency.other_cluster.gradient_controller."
+                             "concurrency_limit")
+                    .value());
+
+  filter1->onDestroy();
+  filter2->onDestroy();
+  filter3->onDestroy();
+}
+
+TEST_F(AdaptiveConcurrencyFilterTest, NoRoute) {
+  EXPECT_CALL(decoder_callbacks_, route()).WillRepeatedly(Return(nullptr));
+  for (int i = 0; i < 3; i++) {
+    auto filter = createFilter();
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter->decodeHeaders(request_headers_, true));
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+              filter->encodeHeaders(response_headers_, true));
+    filter->onDestroy();
+  }
+}
+
+} // namespace
+} // namespace AdaptiveConcurrency
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
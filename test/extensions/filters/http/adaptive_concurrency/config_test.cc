@@ -0,0 +1,54 @@
+#include "envoy/config/filter/http/adaptive_concurrency/v2alpha/adaptive_concurrency.pb.validate.h"
+
+#include "extensions/filters/http/adaptive_concurrency/config.h"
+
+#include "test/mocks/server/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace AdaptiveConcurrency {
+namespace {
+
+TEST(AdaptiveConcurrencyFilterFactoryTest, ValidateFail) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  envoy::config::filter::http::adaptive_concurrency::v2alpha::AdaptiveConcurrency proto_config;
+  AdaptiveConcurrencyFilterFactory factory;
+  EXPECT_THROW(factory.createFilterFactoryFromProto(proto_config, "stats", context),
+               ProtoValidationException);
+}
+
+TEST(AdaptiveConcurrencyFilterFactoryTest, CorrectProto) {
+  const std::string yaml = R"EOF(
+  gradient_controller_config:
+    sample_aggregate_percentile:
+      value: 90
+    concurrency_limit_params:
+      max_concurrency_limit: 500
+      concurrency_update_interval: 0.1s
+    min_rtt_calc_params:
+      interval: 60s
+      request_count: 100
+  )EOF";
+
+  envoy::config::filter::http::adaptive_concurrency::v2alpha::AdaptiveConcurrency proto_config;
+  MessageUtil::loadFromYamlAndValidate(yaml, proto_config);
+
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  AdaptiveConcurrencyFilterFactory factory;
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(proto_config, "stats", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+}
+
+} // namespace
+} // namespace AdaptiveConcurrency
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
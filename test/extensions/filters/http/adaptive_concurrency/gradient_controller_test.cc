@@ -0,0 +1,207 @@
+#include <chrono>
+#include <string>
+
+#include "envoy/config/filter/http/adaptive_concurrency/v2alpha/adaptive_concurrency.pb.validate.h"
+
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/adaptive_concurrency/gradient_controller.h"
+
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace AdaptiveConcurrency {
+namespace {
+
+class GradientControllerTest : public testing::Test {
+public:
+  std::unique_ptr<GradientController> makeController(const std::string& yaml) {
+    envoy::config::filter::http::adaptive_concurrency::v2alpha::GradientControllerConfig
+        proto_config;
+    MessageUtil::loadFromYamlAndValidate(yaml, proto_config);
+    config_ = std::make_unique<GradientControllerConfig>(proto_config);
+    return std::make_unique<GradientController>(*config_, time_system_, "test.", stats_);
+  }
+
+  // Forward a request and complete it after the given latency.
+  void sampleLatency(GradientController& controller, std::chrono::milliseconds latency) {
+    ASSERT_TRUE(controller.forwardingDecision());
+    time_system_.sleep(latency);
+    controller.recordLatencySample(latency);
+  }
+
+  uint64_t gauge(const std::string& name) { return stats_.gauge("test." + name).value(); }
+
+  const std::string yaml_ = R"EOF(
+  sample_aggregate_percentile:
+    value: 50
+  concurrency_limit_params:
+    max_concurrency_limit: 20
+    concurrency_update_interval: 0.1s
+  min_rtt_calc_params:
+    interval: 30s
+    request_count: 5
+    min_concurrency: 3
+    buffer:
+      value: 25
+  )EOF";
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl stats_;
+  std::unique_ptr<GradientControllerConfig> config_;
+};
+
+TEST_F(GradientControllerTest, Defaults) {
+  envoy::config::filter::http::adaptive_concurrency::v2alpha::GradientControllerConfig
+      proto_config;
+  MessageUtil::loadFromYamlAndValidate(R"EOF(
+  concurrency_limit_params:
+    concurrency_update_interval: 0.1s
+  min_rtt_calc_params:
+    interval: 30s
+  )EOF",
+                                       proto_config);
+  GradientControllerConfig config(proto_config);
+  EXPECT_EQ(1000U, config.maxConcurrencyLimit());
+  EXPECT_EQ(50U, config.minRTTAggregateRequestCount());
+  EXPECT_EQ(3U, config.minConcurrency());
+  EXPECT_DOUBLE_EQ(0.25, config.minRTTBuffer());
+  EXPECT_DOUBLE_EQ(0.5, config.sampleAggregatePercentile());
+  EXPECT_EQ(std::chrono::milliseconds(100), config.concurrencyUpdateInterval());
+  EXPECT_EQ(std::chrono::seconds(30), config.minRTTCalcInterval());
+}
+
+TEST_F(GradientControllerTest, MinConcurrencyAboveMaxLimit) {
+  envoy::config::filter::http::adaptive_concurrency::v2alpha::GradientControllerConfig
+      proto_config;
+  MessageUtil::loadFromYamlAndValidate(R"EOF(
+  concurrency_limit_params:
+    max_concurrency_limit: 2
+    concurrency_update_interval: 0.1s
+  min_rtt_calc_params:
+    interval: 30s
+  )EOF",
+                                       proto_config);
+  EXPECT_THROW_WITH_MESSAGE(
+      GradientControllerConfig config(proto_config), EnvoyException,
+      "adaptive concurrency: min_concurrency 3 is greater than max_concurrency_limit 2");
+}
+
+TEST_F(GradientControllerTest, ForwardingDecision) {
+  auto controller = makeController(yaml_);
+  EXPECT_EQ(3U, controller->concurrencyLimit());
+  EXPECT_TRUE(controller->forwardingDecision());
+  EXPECT_TRUE(controller->forwardingDecision());
+  EXPECT_TRUE(controller->forwardingDecision());
+  EXPECT_FALSE(controller->forwardingDecision());
+  EXPECT_EQ(1U, stats_.counter("test.rq_blocked").value());
+
+  controller->cancelLatencySample();
+  EXPECT_TRUE(controller->forwardingDecision());
+  EXPECT_FALSE(controller->forwardingDecision());
+  EXPECT_EQ(2U, stats_.counter("test.rq_blocked").value());
+}
+
+TEST_F(GradientControllerTest, MinRTTCalculation) {
+  auto controller = makeController(yaml_);
+  EXPECT_EQ(1U, gauge("min_rtt_calculation_active"));
+  for (const uint64_t latency : {20, 10, 50, 30, 40}) {
+    sampleLatency(*controller, std::chrono::milliseconds(latency));
+  }
+  EXPECT_EQ(0U, gauge("min_rtt_calculation_active"));
+  EXPECT_EQ(30U, gauge("min_rtt_msecs"));
+  EXPECT_EQ(3U, controller->concurrencyLimit());
+}
+
+TEST_F(GradientControllerTest, LimitGrowsWithStableLatency) {
+  auto controller = makeController(yaml_);
+  for (int i = 0; i < 5; i++) {
+    sampleLatency(*controller, std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(10U, gauge("min_rtt_msecs"));
+
+  // The gradient is 12.5 / 10, so the limit becomes 3 * 1.25 + sqrt(3.75).
+  time_system_.sleep(std::chrono::milliseconds(100));
+  sampleLatency(*controller, std::chrono::milliseconds(10));
+  EXPECT_EQ(10U, gauge("sample_rtt_msecs"));
+  EXPECT_EQ(5U, controller->concurrencyLimit());
+  EXPECT_EQ(5U, gauge("concurrency_limit"));
+
+  // The limit is not updated before the end of the update interval.
+  sampleLatency(*controller, std::chrono::milliseconds(10));
+  EXPECT_EQ(5U, controller->concurrencyLimit());
+
+  // The limit never goes above max_concurrency_limit.
+  for (int i = 0; i < 10; i++) {
+    time_system_.sleep(std::chrono::milliseconds(100));
+    sampleLatency(*controller, std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(20U, controller->concurrencyLimit());
+}
+
+TEST_F(GradientControllerTest, LimitShrinksWithIncreasingLatency) {
+  auto controller = makeController(yaml_);
+  for (int i = 0; i < 5; i++) {
+    sampleLatency(*controller, std::chrono::milliseconds(10));
+  }
+  for (int i = 0; i < 10; i++) {
+    time_system_.sleep(std::chrono::milliseconds(100));
+    sampleLatency(*controller, std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(20U, controller->concurrencyLimit());
+
+  // The gradient is clamped to 0.5, so the limit becomes 20 * 0.5 + sqrt(10).
+  time_system_.sleep(std::chrono::milliseconds(100));
+  sampleLatency(*controller, std::chrono::milliseconds(100));
+  EXPECT_EQ(13U, controller->concurrencyLimit());
+
+  // The limit never goes below min_concurrency.
+  for (int i = 0; i < 5; i++) {
+    time_system_.sleep(std::chrono::milliseconds(100));
+    sampleLatency(*controller, std::chrono::milliseconds(100));
+  }
+  EXPECT_EQ(3U, controller->concurrencyLimit());
+}
+
+TEST_F(GradientControllerTest, MinRTTRecalculation) {
+  auto controller = makeController(yaml_);
+  for (int i = 0; i < 5; i++) {
+    sampleLatency(*controller, std::chrono::milliseconds(10));
+  }
+  for (int i = 0; i < 10; i++) {
+    time_system_.sleep(std::chrono::milliseconds(100));
+    sampleLatency(*controller, std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(20U, controller->concurrencyLimit());
+
+  // Once the minRTT interval is over, the limit drops to min_concurrency while the minRTT is
+  // measured again.
+  EXPECT_TRUE(controller->forwardingDecision());
+  time_system_.sleep(std::chrono::seconds(30));
+  sampleLatency(*controller, std::chrono::milliseconds(10));
+  EXPECT_EQ(1U, gauge("min_rtt_calculation_active"));
+  EXPECT_EQ(3U, controller->concurrencyLimit());
+
+  // Requests forwarded before the measurement started are not sampled.
+  controller->recordLatencySample(std::chrono::milliseconds(30010));
+  for (int i = 0; i < 4; i++) {
+    sampleLatency(*controller, std::chrono::milliseconds(20));
+  }
+  EXPECT_EQ(1U, gauge("min_rtt_calculation_active"));
+
+  sampleLatency(*controller, std::chrono::milliseconds(20));
+  EXPECT_EQ(0U, gauge("min_rtt_calculation_active"));
+  EXPECT_EQ(20U, gauge("min_rtt_msecs"));
+  EXPECT_EQ(20U, controller->concurrencyLimit());
+}
+
+} // namespace
+} // namespace AdaptiveConcurrency
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
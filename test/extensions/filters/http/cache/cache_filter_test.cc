@@ -0,0 +1,352 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/cache/cache_filter.h"
+#include "extensions/filters/http/cache/in_memory_http_cache.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+const std::string Date = "Sun, 06 Nov 1994 08:49:37 GMT";
+
+class CacheFilterTest : public testing::Test {
+public:
+  CacheFilterTest() : cache_(std::make_shared<InMemoryHttpCache>(1024 * 1024, 1)) {
+    time_system_.setSystemTime(CacheHeadersUtils::httpTime(Date).value());
+    setupConfig();
+  }
+
+  void setupConfig() {
+    config_ = std::make_shared<CacheFilterConfig>(proto_config_, cache_, "test.", stats_,
+                                                  time_system_);
+  }
+
+  struct TestFilter {
+    TestFilter(const CacheFilterConfigSharedPtr& config) : filter_(config) {
+      filter_.setDecoderFilterCallbacks(decoder_callbacks_);
+      filter_.setEncoderFilterCallbacks(encoder_callbacks_);
+    }
+    ~TestFilter() { filter_.onDestroy(); }
+
+    NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+    NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks_;
+    CacheFilter filter_;
+  };
+
+  Http::TestHeaderMapImpl request(const std::string& method = "GET") {
+    return Http::TestHeaderMapImpl{
+        {":method", method}, {":path", "/resource"}, {":authority", "example.com"}};
+  }
+
+  // Sends a request through a new filter, and answers it with a response from upstream.
+  void fill(Http::TestHeaderMapImpl response_headers, const std::string& body) {
+    TestFilter filter(config_);
+    Http::TestHeaderMapImpl request_headers = request();
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+              filter.filter_.decodeHeaders(request_headers, true));
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+              filter.filter_.encodeHeaders(response_headers, body.empty()));
+    if (!body.empty()) {
+      Buffer::OwnedImpl data(body);
+      EXPECT_EQ(Http::FilterDataStatus::Continue, filter.filter_.encodeData(data, true));
+      EXPECT_EQ(body, data.toString());
+    }
+  }
+
+  // Expects a request to be served from the cache by a new filter.
+  void expectHit(Http::TestHeaderMapImpl request_headers, const std::string& age,
+                 const std::string& body) {
+    TestFilter filter(config_);
+    EXPECT_CALL(filter.decoder_callbacks_, encodeHeaders_(_, false))
+        .WillOnce(Invoke([&](Http::HeaderMap& headers, bool) -> void {
+          EXPECT_THAT(headers, HeaderHasValueRef(":status", "200"));
+          EXPECT_THAT(headers, HeaderHasValueRef("age", age));
+          EXPECT_THAT(headers, HeaderHasValueRef("content-length", std::to_string(body.size())));
+        }));
+    EXPECT_CALL(filter.decoder_callbacks_, encodeData(_, true))
+        .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> void {
+          EXPECT_EQ(body, data.toString());
+        }));
+    EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+              filter.filter_.decodeHeaders(request_headers, true));
+  }
+
+  uint64_t counter(const std::string& name) {
+    return stats_.counter("test.cache." + name).value();
+  }
+
+  envoy::config::filter::http::cache::v2alpha::Cache proto_config_;
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl stats_;
+  std::shared_ptr<InMemoryHttpCache> cache_;
+  CacheFilterConfigSharedPtr config_;
+};
+
+TEST_F(CacheFilterTest, MissThenHit) {
+  fill(Http::TestHeaderMapImpl{{":status", "200"},
+                               {"date", Date},
+                               {"cache-control", "public, max-age=60"},
+                               {"transfer-encoding", "chunked"}},
+       "body");
+  EXPECT_EQ(1, counter("miss"));
+  EXPECT_EQ(1, counter("inserted"));
+
+  time_system_.sleep(std::chrono::seconds(10));
+  expectHit(request(), "10", "body");
+  EXPECT_EQ(1, counter("hit"));
+
+  // The request only accepts responses younger than they are.
+  Http::TestHeaderMapImpl young_request = request();
+  young_request.addCopy("cache-control", "max-age=5");
+  TestFilter filter(config_);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            filter.filter_.decodeHeaders(young_request, true));
+  EXPECT_EQ(2, counter("miss"));
+}
+
+TEST_F(CacheFilterTest, NotCacheable) {
+  fill(Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "private, max-age=60"}},
+       "body");
+  fill(Http::TestHeaderMapImpl{{":status", "500"}, {"cache-control", "max-age=60"}}, "body");
+  // Without an expiration time nor a validator.
+  fill(Http::TestHeaderMapImpl{{":status", "200"}}, "body");
+  EXPECT_EQ(3, counter("not_cacheable"));
+  EXPECT_EQ(0, counter("inserted"));
+  EXPECT_EQ(0, cache_->bytes());
+}
+
+TEST_F(CacheFilterTest, BodyTooLarge) {
+  proto_config_.mutable_max_body_bytes()->set_value(3);
+  setupConfig();
+  fill(Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "max-age=60"}}, "body");
+  EXPECT_EQ(1, counter("not_cacheable"));
+  EXPECT_EQ(0, cache_->bytes());
+}
+
+TEST_F(CacheFilterTest, NoStoreRequest) {
+  TestFilter filter(config_);
+  Http::TestHeaderMapImpl request_headers = request();
+  request_headers.addCopy("cache-control", "no-store");
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            filter.filter_.decodeHeaders(request_headers, true));
+  Http::TestHeaderMapImpl response_headers{{":status", "200"}, {"cache-control", "max-age=60"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            filter.filter_.encodeHeaders(response_headers, true));
+  EXPECT_EQ(0, counter("inserted"));
+}
+
+TEST_F(CacheFilterTest, ConditionalRequestHit) {
+  fill(Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "max-age=60"},
+                               {"etag", "\"v1\""}},
+       "body");
+
+  TestFilter filter(config_);
+  Http::TestHeaderMapImpl request_headers = request();
+  request_headers.addCopy("if-none-match", "\"v0\", W/\"v1\"");
+  EXPECT_CALL(filter.decoder_callbacks_, encodeHeaders_(_, true))
+      .WillOnce(Invoke([](Http::HeaderMap& headers, bool) -> void {
+        EXPECT_THAT(headers, HeaderHasValueRef(":status", "304"));
+        EXPECT_EQ(nullptr, headers.ContentLength());
+      }));
+  EXPECT_CALL(filter.decoder_callbacks_, encodeData(_, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter.filter_.decodeHeaders(request_headers, true));
+}
+
+TEST_F(CacheFilterTest, Revalidate) {
+  fill(Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "max-age=10"},
+                               {"etag", "\"v1\""}, {"x-version", "1"}},
+       "body");
+  time_system_.sleep(std::chrono::seconds(20));
+
+  {
+    TestFilter filter(config_);
+    Http::TestHeaderMapImpl request_headers = request();
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+              filter.filter_.decodeHeaders(request_headers, true));
+    EXPECT_THAT(request_headers, HeaderHasValueRef("if-none-match", "\"v1\""));
+
+    Http::TestHeaderMapImpl response_headers{
+        {":status", "304"}, {"cache-control", "max-age=10"}, {"x-version", "2"}};
+    EXPECT_CALL(filter.encoder_callbacks_, addEncodedData(_, false))
+        .WillOnce(Invoke([](Buffer::Instance& data, bool) -> void {
+          EXPECT_EQ("body", data.toString());
+        }));
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+              filter.filter_.encodeHeaders(response_headers, true));
+    EXPECT_THAT(response_headers, HeaderHasValueRef(":status", "200"));
+    EXPECT_THAT(response_headers, HeaderHasValueRef("etag", "\"v1\""));
+    EXPECT_THAT(response_headers, HeaderHasValueRef("x-version", "2"));
+    EXPECT_THAT(response_headers, HeaderHasValueRef("age", "0"));
+    EXPECT_EQ(1, counter("revalidated"));
+  }
+
+  // The revalidated response is fresh again.
+  time_system_.sleep(std::chrono::seconds(5));
+  expectHit(request(), "5", "body");
+}
+
+TEST_F(CacheFilterTest, MustRevalidateIsNotServedStale) {
+  fill(Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "max-age=10"}}, "body");
+  time_system_.sleep(std::chrono::seconds(20));
+
+  Http::TestHeaderMapImpl stale_request = request();
+  stale_request.addCopy("cache-control", "max-stale=30");
+  expectHit(stale_request, "20", "body");
+
+  fill(Http::TestHeaderMapImpl{{":status", "200"},
+                               {"cache-control", "max-age=10, must-revalidate"}},
+       "body");
+  time_system_.sleep(std::chrono::seconds(20));
+  TestFilter filter(config_);
+  Http::TestHeaderMapImpl must_revalidate_request = request();
+  must_revalidate_request.addCopy("cache-control", "max-stale=30");
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            filter.filter_.decodeHeaders(must_revalidate_request, true));
+}
+
+TEST_F(CacheFilterTest, OnlyIfCachedMiss) {
+  TestFilter filter(config_);
+  Http::TestHeaderMapImpl request_headers = request();
+  request_headers.addCopy("cache-control", "only-if-cached");
+  EXPECT_CALL(filter.decoder_callbacks_, encodeHeaders_(HeaderHasValueRef(":status", "504"), _))
+      .WillOnce(Invoke([&](Http::HeaderMap& headers, bool end_stream) -> void {
+        filter.filter_.encodeHeaders(headers, end_stream);
+      }));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter.filter_.decodeHeaders(request_headers, true));
+  EXPECT_EQ(0, counter("not_cacheable"));
+}
+
+TEST_F(CacheFilterTest, UnsafeRequestInvalidates) {
+  fill(Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "max-age=60"}}, "body");
+
+  TestFilter filter(config_);
+  Http::TestHeaderMapImpl request_headers = request("POST");
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            filter.filter_.decodeHeaders(request_headers, false));
+  Http::TestHeaderMapImpl response_headers{{":status", "204"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            filter.filter_.encodeHeaders(response_headers, true));
+  EXPECT_EQ(1, counter("invalidated"));
+  EXPECT_EQ(0, cache_->bytes());
+}
+
+TEST_F(CacheFilterTest, BypassedRequests) {
+  for (const auto& header : std::vector<std::pair<std::string, std::string>>{
+           {"authorization", "Basic Zm9vOmJhcg=="}, {"range", "bytes=0-1"}, {"if-match", "*"}}) {
+    TestFilter filter(config_);
+    Http::TestHeaderMapImpl request_headers = request();
+    request_headers.addCopy(header.first, header.second);
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+              filter.filter_.decodeHeaders(request_headers, true));
+    Http::TestHeaderMapImpl response_headers{{":status", "200"}, {"cache-control", "max-age=60"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+              filter.filter_.encodeHeaders(response_headers, true));
+  }
+  EXPECT_EQ(0, counter("miss"));
+  EXPECT_EQ(0, cache_->bytes());
+}
+
+TEST_F(CacheFilterTest, TrailersAreNotCached) {
+  TestFilter filter(config_);
+  Http::TestHeaderMapImpl request_headers = request();
+  filter.filter_.decodeHeaders(request_headers, true);
+  Http::TestHeaderMapImpl response_headers{{":status", "200"}, {"cache-control", "max-age=60"}};
+  filter.filter_.encodeHeaders(response_headers, false);
+  Buffer::OwnedImpl data("body");
+  filter.filter_.encodeData(data, false);
+  Http::TestHeaderMapImpl trailers{{"grpc-status", "0"}};
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter.filter_.encodeTrailers(trailers));
+  EXPECT_EQ(1, counter("not_cacheable"));
+  EXPECT_EQ(0, cache_->bytes());
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestsAreServedFromTheCache) {
+  TestFilter leader(config_);
+  Http::TestHeaderMapImpl leader_request = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            leader.filter_.decodeHeaders(leader_request, true));
+
+  TestFilter waiter(config_);
+  Http::TestHeaderMapImpl waiter_request = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            waiter.filter_.decodeHeaders(waiter_request, true));
+  EXPECT_EQ(1, counter("coalesced"));
+
+  // Filling the cache wakes up the waiting request, which is then served from the cache.
+  EXPECT_CALL(waiter.decoder_callbacks_,
+              encodeHeaders_(HeaderHasValueRef(":status", "200"), false));
+  EXPECT_CALL(waiter.decoder_callbacks_, encodeData(_, true));
+  EXPECT_CALL(waiter.decoder_callbacks_, continueDecoding()).Times(0);
+  Http::TestHeaderMapImpl response_headers{{":status", "200"}, {"cache-control", "max-age=60"}};
+  leader.filter_.encodeHeaders(response_headers, false);
+  Buffer::OwnedImpl data("body");
+  leader.filter_.encodeData(data, true);
+  EXPECT_EQ(1, counter("hit"));
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestsContinueIfNotCached) {
+  TestFilter leader(config_);
+  Http::TestHeaderMapImpl leader_request = request();
+  leader.filter_.decodeHeaders(leader_request, true);
+
+  TestFilter waiter(config_);
+  Http::TestHeaderMapImpl waiter_request = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            waiter.filter_.decodeHeaders(waiter_request, true));
+
+  EXPECT_CALL(waiter.decoder_callbacks_, continueDecoding());
+  Http::TestHeaderMapImpl response_headers{{":status", "200"}, {"cache-control", "no-store"}};
+  leader.filter_.encodeHeaders(response_headers, true);
+  EXPECT_EQ(2, counter("miss"));
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestsContinueIfLeaderIsReset) {
+  TestFilter waiter(config_);
+  {
+    TestFilter leader(config_);
+    Http::TestHeaderMapImpl leader_request = request();
+    leader.filter_.decodeHeaders(leader_request, true);
+
+    Http::TestHeaderMapImpl waiter_request = request();
+    EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+              waiter.filter_.decodeHeaders(waiter_request, true));
+    EXPECT_CALL(waiter.decoder_callbacks_, continueDecoding());
+  }
+}
+
+TEST_F(CacheFilterTest, CoalescingDisabled) {
+  proto_config_.mutable_coalesce_requests()->set_value(false);
+  setupConfig();
+  TestFilter first(config_);
+  Http::TestHeaderMapImpl first_request = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            first.filter_.decodeHeaders(first_request, true));
+  TestFilter second(config_);
+  Http::TestHeaderMapImpl second_request = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            second.filter_.decodeHeaders(second_request, true));
+  EXPECT_EQ(0, counter("coalesced"));
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
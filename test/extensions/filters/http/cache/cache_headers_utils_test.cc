@@ -0,0 +1,157 @@
+#include "common/http/header_map_impl.h"
+
+#include "extensions/filters/http/cache/cache_headers_utils.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+SystemTime time(const std::string& date) {
+  return CacheHeadersUtils::httpTime(date).value();
+}
+
+TEST(CacheHeadersUtilsTest, RequestCacheControl) {
+  {
+    Http::TestHeaderMapImpl headers{
+        {"cache-control", "no-cache, No-Store, max-age=10, max-stale, min-fresh=\"5\""}};
+    const RequestCacheControl cache_control = CacheHeadersUtils::requestCacheControl(headers);
+    EXPECT_TRUE(cache_control.no_cache_);
+    EXPECT_TRUE(cache_control.no_store_);
+    EXPECT_FALSE(cache_control.only_if_cached_);
+    EXPECT_EQ(std::chrono::seconds(10), cache_control.max_age_.value());
+    EXPECT_EQ(std::chrono::seconds::max(), cache_control.max_stale_.value());
+    EXPECT_EQ(std::chrono::seconds(5), cache_control.min_fresh_.value());
+  }
+  {
+    Http::TestHeaderMapImpl headers{{"cache-control", "only-if-cached,max-stale=30"}};
+    const RequestCacheControl cache_control = CacheHeadersUtils::requestCacheControl(headers);
+    EXPECT_TRUE(cache_control.only_if_cached_);
+    EXPECT_EQ(std::chrono::seconds(30), cache_control.max_stale_.value());
+    EXPECT_FALSE(cache_control.max_age_.has_value());
+  }
+  {
+    Http::TestHeaderMapImpl headers{{"pragma", "no-cache"}};
+    EXPECT_TRUE(CacheHeadersUtils::requestCacheControl(headers).no_cache_);
+  }
+  {
+    // Pragma is ignored when there is a Cache-Control header.
+    Http::TestHeaderMapImpl headers{{"pragma", "no-cache"}, {"cache-control", "max-age=1"}};
+    EXPECT_FALSE(CacheHeadersUtils::requestCacheControl(headers).no_cache_);
+  }
+}
+
+TEST(CacheHeadersUtilsTest, ResponseCacheControl) {
+  {
+    Http::TestHeaderMapImpl headers{{"cache-control", "private=\"set-cookie\", max-age=60"}};
+    const ResponseCacheControl cache_control = CacheHeadersUtils::responseCacheControl(headers);
+    EXPECT_TRUE(cache_control.private_);
+    EXPECT_FALSE(cache_control.must_revalidate_);
+    EXPECT_EQ(std::chrono::seconds(60), cache_control.max_age_.value());
+  }
+  {
+    Http::TestHeaderMapImpl headers{{"cache-control", "public, s-maxage=20, no-cache"}};
+    const ResponseCacheControl cache_control = CacheHeadersUtils::responseCacheControl(headers);
+    EXPECT_TRUE(cache_control.no_cache_);
+    EXPECT_TRUE(cache_control.must_revalidate_);
+    EXPECT_EQ(std::chrono::seconds(20), cache_control.s_maxage_.value());
+  }
+  {
+    // An invalid max-age makes the response stale.
+    Http::TestHeaderMapImpl headers{{"cache-control", "max-age=soon, proxy-revalidate"}};
+    const ResponseCacheControl cache_control = CacheHeadersUtils::responseCacheControl(headers);
+    EXPECT_TRUE(cache_control.must_revalidate_);
+    EXPECT_EQ(std::chrono::seconds(0), cache_control.max_age_.value());
+  }
+}
+
+TEST(CacheHeadersUtilsTest, HttpTime) {
+  const SystemTime expected = time("Sun, 06 Nov 1994 08:49:37 GMT");
+  EXPECT_EQ(std::chrono::seconds(784111777),
+            std::chrono::duration_cast<std::chrono::seconds>(expected.time_since_epoch()));
+  EXPECT_EQ(expected, CacheHeadersUtils::httpTime("Sunday, 06-Nov-94 08:49:37 GMT").value());
+  EXPECT_EQ(expected, CacheHeadersUtils::httpTime("Sun Nov  6 08:49:37 1994").value());
+  EXPECT_FALSE(CacheHeadersUtils::httpTime("0").has_value());
+  EXPECT_FALSE(CacheHeadersUtils::httpTime("").has_value());
+}
+
+TEST(CacheHeadersUtilsTest, DeltaSeconds) {
+  EXPECT_EQ(std::chrono::seconds(0), CacheHeadersUtils::deltaSeconds("0").value());
+  EXPECT_EQ(std::chrono::seconds(3600), CacheHeadersUtils::deltaSeconds("3600").value());
+  EXPECT_EQ(std::chrono::seconds(1LL << 31),
+            CacheHeadersUtils::deltaSeconds("99999999999999999999999").value());
+  EXPECT_FALSE(CacheHeadersUtils::deltaSeconds("").has_value());
+  EXPECT_FALSE(CacheHeadersUtils::deltaSeconds("-1").has_value());
+  EXPECT_FALSE(CacheHeadersUtils::deltaSeconds("1.5").has_value());
+}
+
+TEST(CacheHeadersUtilsTest, FreshnessLifetime) {
+  const SystemTime response_time = time("Sun, 06 Nov 1994 08:49:37 GMT");
+  Http::TestHeaderMapImpl headers{{"date", "Sun, 06 Nov 1994 08:49:37 GMT"},
+                                  {"expires", "Sun, 06 Nov 1994 08:59:37 GMT"}};
+  ResponseCacheControl cache_control;
+  EXPECT_EQ(std::chrono::seconds(600),
+            CacheHeadersUtils::freshnessLifetime(cache_control, headers, response_time).value());
+
+  cache_control.max_age_ = std::chrono::seconds(30);
+  EXPECT_EQ(std::chrono::seconds(30),
+            CacheHeadersUtils::freshnessLifetime(cache_control, headers, response_time).value());
+  cache_control.s_maxage_ = std::chrono::seconds(20);
+  EXPECT_EQ(std::chrono::seconds(20),
+            CacheHeadersUtils::freshnessLifetime(cache_control, headers, response_time).value());
+
+  // An invalid Expires header means the response is already expired.
+  ResponseCacheControl no_directives;
+  headers.remove(Http::LowerCaseString("expires"));
+  headers.addCopy("expires", "0");
+  EXPECT_EQ(std::chrono::seconds(0),
+            CacheHeadersUtils::freshnessLifetime(no_directives, headers, response_time).value());
+
+  headers.remove(Http::LowerCaseString("expires"));
+  EXPECT_FALSE(
+      CacheHeadersUtils::freshnessLifetime(no_directives, headers, response_time).has_value());
+}
+
+TEST(CacheHeadersUtilsTest, InitialAge) {
+  const SystemTime date = time("Sun, 06 Nov 1994 08:49:37 GMT");
+  {
+    // The apparent age, from the Date header.
+    Http::TestHeaderMapImpl headers{{"date", "Sun, 06 Nov 1994 08:49:37 GMT"}};
+    EXPECT_EQ(std::chrono::seconds(10),
+              CacheHeadersUtils::initialAge(headers, date + std::chrono::seconds(8),
+                                            date + std::chrono::seconds(10)));
+  }
+  {
+    // The Age header, corrected by the response delay.
+    Http::TestHeaderMapImpl headers{{"date", "Sun, 06 Nov 1994 08:49:37 GMT"}, {"age", "100"}};
+    EXPECT_EQ(std::chrono::seconds(102),
+              CacheHeadersUtils::initialAge(headers, date + std::chrono::seconds(8),
+                                            date + std::chrono::seconds(10)));
+  }
+}
+
+TEST(CacheHeadersUtilsTest, VaryHeaders) {
+  std::vector<std::string> names;
+  Http::TestHeaderMapImpl headers{{"vary", "Accept-Encoding, accept-language"}};
+  EXPECT_TRUE(CacheHeadersUtils::varyHeaders(headers, names));
+  EXPECT_EQ((std::vector<std::string>{"accept-encoding", "accept-language"}), names);
+
+  names.clear();
+  Http::TestHeaderMapImpl any_headers{{"vary", "accept-encoding, *"}};
+  EXPECT_FALSE(CacheHeadersUtils::varyHeaders(any_headers, names));
+
+  names.clear();
+  EXPECT_TRUE(CacheHeadersUtils::varyHeaders(Http::TestHeaderMapImpl{}, names));
+  EXPECT_TRUE(names.empty());
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
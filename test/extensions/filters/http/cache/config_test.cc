@@ -0,0 +1,63 @@
+#include "envoy/config/filter/http/cache/v2alpha/cache.pb.validate.h"
+
+#include "extensions/filters/http/cache/config.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+TEST(CacheFilterFactoryTest, DefaultStorage) {
+  envoy::config::filter::http::cache::v2alpha::Cache config;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  CacheFilterFactory factory;
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(config, "stats.", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+}
+
+TEST(CacheFilterFactoryTest, InMemoryStorage) {
+  const std::string yaml = R"EOF(
+  storage:
+    name: envoy.filters.http.cache.in_memory
+    config:
+      max_bytes: 1048576
+      shards: 4
+  max_body_bytes: 4096
+  )EOF";
+
+  envoy::config::filter::http::cache::v2alpha::Cache config;
+  MessageUtil::loadFromYaml(yaml, config);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  CacheFilterFactory factory;
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(config, "stats.", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+}
+
+TEST(CacheFilterFactoryTest, UnknownStorage) {
+  envoy::config::filter::http::cache::v2alpha::Cache config;
+  config.mutable_storage()->set_name("envoy.filters.http.cache.unknown");
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  CacheFilterFactory factory;
+  EXPECT_THROW_WITH_REGEX(factory.createFilterFactoryFromProto(config, "stats.", context),
+                          EnvoyException, "envoy.filters.http.cache.unknown");
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,92 @@
+#include "common/http/header_map_impl.h"
+
+#include "extensions/filters/http/cache/in_memory_http_cache.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+CachedResponseConstSharedPtr
+makeResponse(const std::string& body,
+             std::vector<std::pair<Http::LowerCaseString, std::string>> vary_values = {}) {
+  auto response = std::make_shared<CachedResponse>();
+  response->headers_ = std::make_unique<Http::TestHeaderMapImpl>(
+      std::initializer_list<std::pair<std::string, std::string>>{{":status", "200"}});
+  response->body_ = std::make_shared<const std::string>(body);
+  response->vary_values_ = std::move(vary_values);
+  return response;
+}
+
+TEST(InMemoryHttpCacheTest, InsertLookupRemove) {
+  InMemoryHttpCache cache(1024 * 1024, 4);
+  Http::TestHeaderMapImpl request_headers;
+  EXPECT_EQ(nullptr, cache.lookup("http://example.com/a", request_headers));
+
+  CachedResponseConstSharedPtr response = makeResponse("a");
+  cache.insert("http://example.com/a", response);
+  EXPECT_EQ(response, cache.lookup("http://example.com/a", request_headers));
+  EXPECT_EQ(nullptr, cache.lookup("http://example.com/b", request_headers));
+  EXPECT_EQ(std::string("http://example.com/a").size() + response->byteSize(), cache.bytes());
+
+  // Inserting a response with the same vary values replaces the cached one.
+  CachedResponseConstSharedPtr replacement = makeResponse("aa");
+  cache.insert("http://example.com/a", replacement);
+  EXPECT_EQ(replacement, cache.lookup("http://example.com/a", request_headers));
+  EXPECT_EQ(std::string("http://example.com/a").size() + replacement->byteSize(), cache.bytes());
+
+  cache.remove("http://example.com/a");
+  EXPECT_EQ(nullptr, cache.lookup("http://example.com/a", request_headers));
+  EXPECT_EQ(0, cache.bytes());
+}
+
+TEST(InMemoryHttpCacheTest, Variants) {
+  InMemoryHttpCache cache(1024 * 1024, 1);
+  const Http::LowerCaseString accept_encoding("accept-encoding");
+  CachedResponseConstSharedPtr gzip = makeResponse("gzip", {{accept_encoding, "gzip"}});
+  CachedResponseConstSharedPtr identity = makeResponse("identity", {{accept_encoding, ""}});
+  cache.insert("key", gzip);
+  cache.insert("key", identity);
+
+  EXPECT_EQ(gzip, cache.lookup("key", Http::TestHeaderMapImpl{{"accept-encoding", "gzip"}}));
+  EXPECT_EQ(identity, cache.lookup("key", Http::TestHeaderMapImpl{}));
+  EXPECT_EQ(nullptr, cache.lookup("key", Http::TestHeaderMapImpl{{"accept-encoding", "br"}}));
+}
+
+TEST(InMemoryHttpCacheTest, EvictLeastRecentlyUsed) {
+  const std::string body(100, 'a');
+  const uint64_t entry_bytes = std::string("key0").size() + makeResponse(body)->byteSize();
+  InMemoryHttpCache cache(3 * entry_bytes, 1);
+  Http::TestHeaderMapImpl request_headers;
+
+  cache.insert("key0", makeResponse(body));
+  cache.insert("key1", makeResponse(body));
+  cache.insert("key2", makeResponse(body));
+  // Looking up key0 makes key1 the least recently used key.
+  EXPECT_NE(nullptr, cache.lookup("key0", request_headers));
+  cache.insert("key3", makeResponse(body));
+
+  EXPECT_NE(nullptr, cache.lookup("key0", request_headers));
+  EXPECT_EQ(nullptr, cache.lookup("key1", request_headers));
+  EXPECT_NE(nullptr, cache.lookup("key2", request_headers));
+  EXPECT_NE(nullptr, cache.lookup("key3", request_headers));
+  EXPECT_EQ(3 * entry_bytes, cache.bytes());
+}
+
+TEST(InMemoryHttpCacheTest, ResponseLargerThanShard) {
+  InMemoryHttpCache cache(1024, 4);
+  cache.insert("key", makeResponse(std::string(512, 'a')));
+  EXPECT_EQ(nullptr, cache.lookup("key", Http::TestHeaderMapImpl{}));
+  EXPECT_EQ(0, cache.bytes());
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,274 @@
+#include <memory>
+#include <string>
+
+#include "envoy/config/filter/http/compressor/v2alpha/compressor.pb.validate.h"
+
+#include "common/compressor/zlib_compressor_impl.h"
+#include "common/decompressor/zlib_decompressor_impl.h"
+#include "common/protobuf/utility.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/compressor/compressor_filter.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace CompressorFilter {
+namespace {
+
+// Compresses with zlib, as any content coding.
+class TestCompressorFactory : public Envoy::Compressor::CompressorFactory {
+public:
+  TestCompressorFactory(const std::string& content_encoding)
+      : content_encoding_(content_encoding) {}
+
+  // Compressor::CompressorFactory
+  Envoy::Compressor::CompressorPtr createCompressor() override {
+    auto compressor = std::make_unique<Envoy::Compressor::ZlibCompressorImpl>();
+    compressor->init(Envoy::Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
+                     Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Standard, 31, 8);
+    return compressor;
+  }
+  const std::string& contentEncoding() const override { return content_encoding_; }
+
+private:
+  const std::string content_encoding_;
+};
+
+class CompressorFilterTest : public testing::Test {
+protected:
+  CompressorFilterTest() {
+    ON_CALL(runtime_.snapshot_, featureEnabled("compressor.filter_enabled", 100))
+        .WillByDefault(Return(true));
+    setUpFilter("{}", {"gzip", "test"});
+    decompressor_.init(31);
+  }
+
+  void setUpFilter(const std::string& json, const std::vector<std::string>& content_encodings) {
+    envoy::config::filter::http::compressor::v2alpha::Compressor compressor;
+    MessageUtil::loadFromJson(json, compressor);
+    std::vector<Envoy::Compressor::CompressorFactoryPtr> factories;
+    for (const std::string& content_encoding : content_encodings) {
+      factories.push_back(std::make_unique<TestCompressorFactory>(content_encoding));
+    }
+    config_ = std::make_shared<CompressorFilterConfig>(compressor, "test.", stats_, runtime_,
+                                                       std::move(factories));
+    filter_ = std::make_unique<CompressorFilter>(config_);
+    filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+  }
+
+  void doRequest(const std::string& accept_encoding) {
+    Http::TestHeaderMapImpl headers{{":method", "get"}, {"accept-encoding", accept_encoding}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  }
+
+  // Sends a compressible response, returning its content coding.
+  std::string doResponse() {
+    Http::TestHeaderMapImpl headers{{":status", "200"}, {"content-length", "256"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+    return headers.get_("content-encoding");
+  }
+
+  void expectCompressed(const std::string& content_encoding, bool with_trailers) {
+    Http::TestHeaderMapImpl headers{{":status", "200"}, {"content-length", "256"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+    EXPECT_EQ(content_encoding, headers.get_("content-encoding"));
+    EXPECT_EQ("", headers.get_("content-length"));
+    EXPECT_EQ("Accept-Encoding", headers.get_("vary"));
+
+    Buffer::OwnedImpl data;
+    TestUtility::feedBufferWithRandomCharacters(data, 256);
+    const std::string expected = data.toString();
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data, !with_trailers));
+    if (with_trailers) {
+      EXPECT_CALL(encoder_callbacks_, addEncodedData(_, true))
+          .WillOnce(Invoke([&](Buffer::Instance& trailer_data, bool) { data.move(trailer_data); }));
+      Http::TestHeaderMapImpl trailers;
+      EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->encodeTrailers(trailers));
+    }
+
+    Buffer::OwnedImpl decompressed;
+    decompressor_.decompress(data, decompressed);
+    EXPECT_EQ(expected, decompressed.toString());
+    const std::string prefix = "test.compressor." + content_encoding + ".";
+    EXPECT_EQ(1, stats_.counter(prefix + "compressed").value());
+    EXPECT_EQ(256, stats_.counter(prefix + "total_uncompressed_bytes").value());
+    EXPECT_EQ(data.length(), stats_.counter(prefix + "total_compressed_bytes").value());
+  }
+
+  Stats::IsolatedStoreImpl stats_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks_;
+  CompressorFilterConfigSharedPtr config_;
+  std::unique_ptr<CompressorFilter> filter_;
+  Decompressor::ZlibDecompressorImpl decompressor_;
+};
+
+TEST_F(CompressorFilterTest, CompressesWithRequestedLibrary) {
+  doRequest("test");
+  expectCompressed("test", false);
+  EXPECT_EQ(1, stats_.counter("test.compressor.test.header_compressor_used").value());
+  EXPECT_EQ(0, stats_.counter("test.compressor.not_compressed").value());
+}
+
+TEST_F(CompressorFilterTest, CompressesWithTrailers) {
+  doRequest("gzip");
+  expectCompressed("gzip", true);
+}
+
+TEST_F(CompressorFilterTest, HighestQvalueWins) {
+  doRequest("gzip;q=0.5, test;q=0.8");
+  EXPECT_EQ("test", doResponse());
+}
+
+TEST_F(CompressorFilterTest, ServerOrderBreaksTies) {
+  doRequest("test, gzip");
+  EXPECT_EQ("gzip", doResponse());
+}
+
+TEST_F(CompressorFilterTest, CaseInsensitiveCodings) {
+  doRequest("GZIP;Q=0.5, Test;q=0.1");
+  EXPECT_EQ("gzip", doResponse());
+}
+
+TEST_F(CompressorFilterTest, Wildcard) {
+  doRequest("*");
+  EXPECT_EQ("gzip", doResponse());
+  EXPECT_EQ(1, stats_.counter("test.compressor.header_wildcard").value());
+}
+
+TEST_F(CompressorFilterTest, ExplicitZeroQvalueOverridesWildcard) {
+  doRequest("*, gzip;q=0");
+  EXPECT_EQ("test", doResponse());
+  EXPECT_EQ(1, stats_.counter("test.compressor.header_wildcard").value());
+}
+
+TEST_F(CompressorFilterTest, InvalidQvalue) {
+  doRequest("gzip;q=high, test;q=2");
+  EXPECT_EQ("", doResponse());
+  EXPECT_EQ(1, stats_.counter("test.compressor.header_not_valid").value());
+  EXPECT_EQ(1, stats_.counter("test.compressor.not_compressed").value());
+}
+
+TEST_F(CompressorFilterTest, IdentityPreferred) {
+  doRequest("gzip;q=0.5, identity");
+  EXPECT_EQ("", doResponse());
+  EXPECT_EQ(1, stats_.counter("test.compressor.header_identity").value());
+}
+
+TEST_F(CompressorFilterTest, IdentityNotPreferred) {
+  doRequest("identity;q=0.5, gzip");
+  EXPECT_EQ("gzip", doResponse());
+  EXPECT_EQ(0, stats_.counter("test.compressor.header_identity").value());
+}
+
+TEST_F(CompressorFilterTest, UnknownCoding) {
+  doRequest("br");
+  EXPECT_EQ("", doResponse());
+  EXPECT_EQ(1, stats_.counter("test.compressor.header_not_valid").value());
+}
+
+TEST_F(CompressorFilterTest, NoAcceptEncoding) {
+  Http::TestHeaderMapImpl headers{{":method", "get"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  EXPECT_EQ("", doResponse());
+  EXPECT_EQ(1, stats_.counter("test.compressor.no_accept_header").value());
+  EXPECT_EQ(1, stats_.counter("test.compressor.not_compressed").value());
+}
+
+TEST_F(CompressorFilterTest, RuntimeDisabled) {
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("compressor.filter_enabled", 100))
+      .WillOnce(Return(false));
+  doRequest("gzip");
+  EXPECT_EQ("", doResponse());
+  EXPECT_EQ(1, stats_.counter("test.compressor.not_compressed").value());
+}
+
+TEST_F(CompressorFilterTest, RemoveAcceptEncodingHeader) {
+  setUpFilter(R"EOF({"remove_accept_encoding_header": true})EOF", {"gzip"});
+  Http::TestHeaderMapImpl headers{{":method", "get"}, {"accept-encoding", "gzip"}};
+  filter_->decodeHeaders(headers, false);
+  EXPECT_FALSE(headers.has("accept-encoding"));
+}
+
+TEST_F(CompressorFilterTest, ContentLengthTooSmall) {
+  doRequest("gzip");
+  Http::TestHeaderMapImpl headers{{":status", "200"}, {"content-length", "10"}};
+  filter_->encodeHeaders(headers, false);
+  EXPECT_FALSE(headers.has("content-encoding"));
+  EXPECT_EQ(1, stats_.counter("test.compressor.content_length_too_small").value());
+  EXPECT_EQ(1, stats_.counter("test.compressor.not_compressed").value());
+}
+
+TEST_F(CompressorFilterTest, ContentTypeNotAllowed) {
+  doRequest("gzip");
+  Http::TestHeaderMapImpl headers{
+      {":status", "200"}, {"content-length", "256"}, {"content-type", "image/jpeg"}};
+  filter_->encodeHeaders(headers, false);
+  EXPECT_FALSE(headers.has("content-encoding"));
+}
+
+TEST_F(CompressorFilterTest, AlreadyEncoded) {
+  doRequest("gzip");
+  Http::TestHeaderMapImpl headers{
+      {":status", "200"}, {"content-length", "256"}, {"content-encoding", "test"}};
+  filter_->encodeHeaders(headers, false);
+  EXPECT_EQ("test", headers.get_("content-encoding"));
+  EXPECT_EQ("256", headers.get_("content-length"));
+}
+
+TEST_F(CompressorFilterTest, DisableOnEtag) {
+  setUpFilter(R"EOF({"disable_on_etag_header": true})EOF", {"gzip"});
+  doRequest("gzip");
+  Http::TestHeaderMapImpl headers{
+      {":status", "200"}, {"content-length", "256"}, {"etag", "\"abc\""}};
+  filter_->encodeHeaders(headers, false);
+  EXPECT_FALSE(headers.has("content-encoding"));
+  EXPECT_EQ(1, stats_.counter("test.compressor.not_compressed_etag").value());
+}
+
+TEST_F(CompressorFilterTest, StrongEtagRemoved) {
+  doRequest("gzip");
+  Http::TestHeaderMapImpl headers{
+      {":status", "200"}, {"content-length", "256"}, {"etag", "\"abc\""}};
+  filter_->encodeHeaders(headers, false);
+  EXPECT_EQ("gzip", headers.get_("content-encoding"));
+  EXPECT_FALSE(headers.has("etag"));
+}
+
+TEST_F(CompressorFilterTest, HeadersOnlyResponse) {
+  doRequest("gzip");
+  Http::TestHeaderMapImpl headers{{":status", "200"}, {"content-length", "256"}};
+  filter_->encodeHeaders(headers, true);
+  EXPECT_FALSE(headers.has("content-encoding"));
+}
+
+TEST(CompressorFilterConfigTest, DuplicateContentEncoding) {
+  Stats::IsolatedStoreImpl stats;
+  NiceMock<Runtime::MockLoader> runtime;
+  std::vector<Envoy::Compressor::CompressorFactoryPtr> factories;
+  factories.push_back(std::make_unique<TestCompressorFactory>("gzip"));
+  factories.push_back(std::make_unique<TestCompressorFactory>("gzip"));
+  EXPECT_THROW_WITH_MESSAGE(
+      CompressorFilterConfig(envoy::config::filter::http::compressor::v2alpha::Compressor(),
+                             "test.", stats, runtime, std::move(factories)),
+      EnvoyException, "compressor filter: more than one library produces content encoding 'gzip'");
+}
+
+} // namespace
+} // namespace CompressorFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,68 @@
+#include "envoy/config/filter/http/compressor/v2alpha/compressor.pb.validate.h"
+
+#include "extensions/filters/http/compressor/config.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace CompressorFilter {
+namespace {
+
+TEST(CompressorFilterFactoryTest, GzipLibrary) {
+  const std::string yaml = R"EOF(
+  compressor_libraries:
+  - name: envoy.compression.gzip.compressor
+    config:
+      compression_level: BEST
+      window_bits: 15
+  content_length: 100
+  )EOF";
+
+  envoy::config::filter::http::compressor::v2alpha::Compressor config;
+  MessageUtil::loadFromYaml(yaml, config);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  CompressorFilterFactory factory;
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(config, "stats.", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+}
+
+TEST(CompressorFilterFactoryTest, UnknownLibrary) {
+  envoy::config::filter::http::compressor::v2alpha::Compressor config;
+  config.add_compressor_libraries()->set_name("envoy.compression.unknown");
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  CompressorFilterFactory factory;
+  EXPECT_THROW_WITH_REGEX(factory.createFilterFactoryFromProto(config, "stats.", context),
+                          EnvoyException, "envoy.compression.unknown");
+}
+
+TEST(CompressorFilterFactoryTest, DuplicateLibrary) {
+  const std::string yaml = R"EOF(
+  compressor_libraries:
+  - name: envoy.compression.gzip.compressor
+  - name: envoy.compression.gzip.compressor
+  )EOF";
+
+  envoy::config::filter::http::compressor::v2alpha::Compressor config;
+  MessageUtil::loadFromYaml(yaml, config);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  CompressorFilterFactory factory;
+  EXPECT_THROW_WITH_REGEX(factory.createFilterFactoryFromProto(config, "stats.", context),
+                          EnvoyException, "more than one library produces content encoding");
+}
+
+} // namespace
+} // namespace CompressorFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
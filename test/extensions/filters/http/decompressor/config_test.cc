@@ -0,0 +1,52 @@
+#include "envoy/config/filter/http/decompressor/v2alpha/decompressor.pb.validate.h"
+
+#include "extensions/filters/http/decompressor/config.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace DecompressorFilter {
+namespace {
+
+TEST(DecompressorFilterFactoryTest, GzipLibrary) {
+  const std::string yaml = R"EOF(
+  decompressor_libraries:
+  - name: envoy.compression.gzip.decompressor
+    config:
+      chunk_size: 8192
+  advertise_accept_encoding: true
+  )EOF";
+
+  envoy::config::filter::http::decompressor::v2alpha::Decompressor config;
+  MessageUtil::loadFromYaml(yaml, config);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  DecompressorFilterFactory factory;
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(config, "stats.", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+}
+
+TEST(DecompressorFilterFactoryTest, UnknownLibrary) {
+  envoy::config::filter::http::decompressor::v2alpha::Decompressor config;
+  config.add_decompressor_libraries()->set_name("envoy.compression.unknown");
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  DecompressorFilterFactory factory;
+  EXPECT_THROW_WITH_REGEX(factory.createFilterFactoryFromProto(config, "stats.", context),
+                          EnvoyException, "envoy.compression.unknown");
+}
+
+} // namespace
+} // namespace DecompressorFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,194 @@
+#include <memory>
+#include <string>
+
+#include "envoy/config/filter/http/decompressor/v2alpha/decompressor.pb.validate.h"
+
+#include "common/compressor/zlib_compressor_impl.h"
+#include "common/decompressor/zlib_decompressor_impl.h"
+#include "common/protobuf/utility.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/decompressor/decompressor_filter.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace DecompressorFilter {
+namespace {
+
+using testing::NiceMock;
+
+// Decompresses with zlib, as any content coding.
+class TestDecompressorFactory : public Envoy::Decompressor::DecompressorFactory {
+public:
+  TestDecompressorFactory(const std::string& content_encoding)
+      : content_encoding_(content_encoding) {}
+
+  // Decompressor::DecompressorFactory
+  Envoy::Decompressor::DecompressorPtr createDecompressor() override {
+    auto decompressor = std::make_unique<Envoy::Decompressor::ZlibDecompressorImpl>();
+    decompressor->init(31);
+    return decompressor;
+  }
+  const std::string& contentEncoding() const override { return content_encoding_; }
+
+private:
+  const std::string content_encoding_;
+};
+
+class DecompressorFilterTest : public testing::Test {
+protected:
+  DecompressorFilterTest() { setUpFilter("{}", {"gzip", "test"}); }
+
+  void setUpFilter(const std::string& json, const std::vector<std::string>& content_encodings) {
+    envoy::config::filter::http::decompressor::v2alpha::Decompressor decompressor;
+    MessageUtil::loadFromJson(json, decompressor);
+    std::vector<Envoy::Decompressor::DecompressorFactoryPtr> factories;
+    for (const std::string& content_encoding : content_encodings) {
+      factories.push_back(std::make_unique<TestDecompressorFactory>(content_encoding));
+    }
+    config_ = std::make_shared<DecompressorFilterConfig>(decompressor, "test.", stats_,
+                                                         std::move(factories));
+    filter_ = std::make_unique<DecompressorFilter>(config_);
+    filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+  }
+
+  // Compresses the data and returns the uncompressed data.
+  std::string compress(Buffer::Instance& data) {
+    TestUtility::feedBufferWithRandomCharacters(data, 1024);
+    const std::string uncompressed = data.toString();
+    Envoy::Compressor::ZlibCompressorImpl compressor;
+    compressor.init(Envoy::Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
+                    Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Standard, 31, 8);
+    compressor.compress(data, Envoy::Compressor::State::Finish);
+    return uncompressed;
+  }
+
+  Stats::IsolatedStoreImpl stats_;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks_;
+  DecompressorFilterConfigSharedPtr config_;
+  std::unique_ptr<DecompressorFilter> filter_;
+};
+
+TEST_F(DecompressorFilterTest, Decompresses) {
+  Buffer::OwnedImpl data;
+  const std::string expected = compress(data);
+  const uint64_t compressed_length = data.length();
+
+  Http::TestHeaderMapImpl headers{
+      {":status", "200"}, {"content-encoding", "test"}, {"content-length", "100"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  EXPECT_FALSE(headers.has("content-encoding"));
+  EXPECT_FALSE(headers.has("content-length"));
+
+  // Feed the compressed data in two chunks.
+  Buffer::OwnedImpl first_chunk;
+  first_chunk.move(data, compressed_length / 2);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(first_chunk, false));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data, true));
+  EXPECT_EQ(expected, first_chunk.toString() + data.toString());
+
+  EXPECT_EQ(1, stats_.counter("test.decompressor.test.decompressed").value());
+  EXPECT_EQ(compressed_length,
+            stats_.counter("test.decompressor.test.total_compressed_bytes").value());
+  EXPECT_EQ(expected.size(),
+            stats_.counter("test.decompressor.test.total_uncompressed_bytes").value());
+}
+
+TEST_F(DecompressorFilterTest, RemovesLastContentCoding) {
+  Http::TestHeaderMapImpl headers{{":status", "200"}, {"content-encoding", "br, GZIP"}};
+  filter_->encodeHeaders(headers, false);
+  EXPECT_EQ("br", headers.get_("content-encoding"));
+  EXPECT_EQ(1, stats_.counter("test.decompressor.gzip.decompressed").value());
+}
+
+TEST_F(DecompressorFilterTest, UnknownContentCoding) {
+  Http::TestHeaderMapImpl headers{
+      {":status", "200"}, {"content-encoding", "gzip, br"}, {"content-length", "100"}};
+  filter_->encodeHeaders(headers, false);
+  EXPECT_EQ("gzip, br", headers.get_("content-encoding"));
+  EXPECT_EQ("100", headers.get_("content-length"));
+
+  Buffer::OwnedImpl data("untouched");
+  filter_->encodeData(data, true);
+  EXPECT_EQ("untouched", data.toString());
+}
+
+TEST_F(DecompressorFilterTest, HeadersOnlyResponse) {
+  Http::TestHeaderMapImpl headers{{":status", "204"}, {"content-encoding", "gzip"}};
+  filter_->encodeHeaders(headers, true);
+  EXPECT_EQ("gzip", headers.get_("content-encoding"));
+  EXPECT_EQ(0, stats_.counter("test.decompressor.gzip.decompressed").value());
+}
+
+TEST_F(DecompressorFilterTest, InvalidData) {
+  Http::TestHeaderMapImpl headers{{":status", "200"}, {"content-encoding", "gzip"}};
+  filter_->encodeHeaders(headers, false);
+  Buffer::OwnedImpl data("not gzip data");
+  EXPECT_CALL(encoder_callbacks_, resetStream());
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(data, true));
+  EXPECT_EQ(0, data.length());
+  EXPECT_EQ(1, stats_.counter("test.decompressor.gzip.decompression_error").value());
+}
+
+// A body which is corrupted after a valid start resets the stream rather than passing on a body
+// which ends early.
+TEST_F(DecompressorFilterTest, CorruptData) {
+  // The flush ends the first chunk on a block boundary, so the corrupt bytes which follow are read
+  // as a block header of a reserved type.
+  Envoy::Compressor::ZlibCompressorImpl compressor;
+  compressor.init(Envoy::Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
+                  Envoy::Compressor::ZlibCompressorImpl::CompressionStrategy::Standard, 31, 8);
+  Buffer::OwnedImpl first_chunk("valid start");
+  compressor.compress(first_chunk, Envoy::Compressor::State::Flush);
+  Buffer::OwnedImpl corrupt_chunk(std::string(16, '\xff'));
+
+  Http::TestHeaderMapImpl headers{{":status", "200"}, {"content-encoding", "test"}};
+  filter_->encodeHeaders(headers, false);
+  EXPECT_CALL(encoder_callbacks_, resetStream()).Times(0);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(first_chunk, false));
+  EXPECT_EQ("valid start", first_chunk.toString());
+  EXPECT_EQ(0, stats_.counter("test.decompressor.test.decompression_error").value());
+
+  EXPECT_CALL(encoder_callbacks_, resetStream());
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer,
+            filter_->encodeData(corrupt_chunk, true));
+  EXPECT_EQ(0, corrupt_chunk.length());
+  EXPECT_EQ(1, stats_.counter("test.decompressor.test.decompression_error").value());
+}
+
+TEST_F(DecompressorFilterTest, KeepsAcceptEncoding) {
+  Http::TestHeaderMapImpl headers{{":method", "get"}, {"accept-encoding", "br"}};
+  filter_->decodeHeaders(headers, false);
+  EXPECT_EQ("br", headers.get_("accept-encoding"));
+}
+
+TEST_F(DecompressorFilterTest, AdvertiseAcceptEncoding) {
+  setUpFilter(R"EOF({"advertise_accept_encoding": true})EOF", {"gzip", "test"});
+  Http::TestHeaderMapImpl headers{{":method", "get"}, {"accept-encoding", "br"}};
+  filter_->decodeHeaders(headers, false);
+  EXPECT_EQ("gzip, test", headers.get_("accept-encoding"));
+}
+
+TEST(DecompressorFilterConfigTest, DuplicateContentEncoding) {
+  Stats::IsolatedStoreImpl stats;
+  std::vector<Envoy::Decompressor::DecompressorFactoryPtr> factories;
+  factories.push_back(std::make_unique<TestDecompressorFactory>("gzip"));
+  factories.push_back(std::make_unique<TestDecompressorFactory>("GZIP"));
+  EXPECT_THROW_WITH_MESSAGE(
+      DecompressorFilterConfig(envoy::config::filter::http::decompressor::v2alpha::Decompressor(),
+                               "test.", stats, std::move(factories)),
+      EnvoyException, "decompressor filter: more than one library reads content encoding 'GZIP'");
+}
+
+} // namespace
+} // namespace DecompressorFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
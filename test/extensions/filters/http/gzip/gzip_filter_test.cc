@@ -11,6 +11,7 @@
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -66,7 +67,7 @@ protected:
     Json::ObjectSharedPtr config = Json::Factory::loadFromString(json);
     envoy::config::filter::http::gzip::v2::Gzip gzip;
     MessageUtil::loadFromJson(json, gzip);
-    config_.reset(new GzipFilterConfig(gzip, "test.", stats_, runtime_));
+    config_.reset(new GzipFilterConfig(gzip, "test.", stats_, runtime_, tls_));
     filter_ = std::make_unique<GzipFilter>(config_);
     filter_->setEncoderFilterCallbacks(encoder_callbacks_);
   }
@@ -176,6 +177,7 @@ protected:
     EXPECT_EQ(1, stats_.counter("test.gzip.not_compressed").value());
   }
 
+  NiceMock<ThreadLocal::MockInstance> tls_;
   GzipFilterConfigSharedPtr config_;
   std::unique_ptr<GzipFilter> filter_;
   Buffer::OwnedImpl data_;
@@ -207,6 +209,7 @@ TEST_F(GzipFilterTest, DefaultConfigValues) {
   EXPECT_EQ(Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
             config_->compressionLevel());
   EXPECT_EQ(8, config_->contentTypeValues().size());
+  EXPECT_EQ(16, config_->compressorPoolSize());
 }
 
 TEST_F(GzipFilterTest, AvailableCombinationCompressionStrategyAndLevelConfig) {
@@ -789,6 +792,55 @@ TEST_F(GzipFilterTest, RemoveAcceptEncodingHeader) {
   }
 }
 
+// The compressors released to a full pool are dropped.
+TEST_F(GzipFilterTest, CompressorPoolSize) {
+  setUpFilter(R"EOF({"compressor_pool_size": 1})EOF");
+  EXPECT_EQ(1, config_->compressorPoolSize());
+  ZlibCompressorImplPtr first = config_->acquireCompressor();
+  ZlibCompressorImplPtr second = config_->acquireCompressor();
+  const Compressor::ZlibCompressorImpl* pooled = first.get();
+  config_->releaseCompressor(std::move(first));
+  config_->releaseCompressor(std::move(second));
+
+  ZlibCompressorImplPtr acquired = config_->acquireCompressor();
+  EXPECT_EQ(pooled, acquired.get());
+  ZlibCompressorImplPtr created = config_->acquireCompressor();
+  EXPECT_NE(pooled, created.get());
+}
+
+// Once its filter is destroyed in the middle of a response, the compressor is reset and compresses
+// the next response from scratch.
+TEST_F(GzipFilterTest, CompressorPooledMidStream) {
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip"}}, true);
+  Http::TestHeaderMapImpl headers{{":method", "get"}, {"content-length", "256"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  Buffer::OwnedImpl unfinished("unfinished");
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(unfinished, false));
+  filter_->onDestroy();
+
+  filter_ = std::make_unique<GzipFilter>(config_);
+  filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip"}}, true);
+  Http::TestHeaderMapImpl next_headers{{":method", "get"}, {"content-length", "256"}};
+  feedBuffer(256);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(next_headers, false));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data_, true));
+  expectValidFinishedBuffer(256);
+  decompressor_.decompress(data_, decompressed_data_);
+  EXPECT_EQ(expected_str_, decompressed_data_.toString());
+  filter_->onDestroy();
+}
+
+// Pooling is disabled by a pool size of 0.
+TEST_F(GzipFilterTest, CompressorPoolDisabled) {
+  setUpFilter(R"EOF({"compressor_pool_size": 0})EOF");
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip"}}, true);
+  doResponseCompression({{":method", "get"}, {"content-length", "256"}}, false);
+  filter_->onDestroy();
+  ZlibCompressorImplPtr created = config_->acquireCompressor();
+  EXPECT_NE(nullptr, created);
+}
+
 } // namespace Gzip
 } // namespace HttpFilters
 } // namespace Extensions
@@ -0,0 +1,70 @@
+#include "envoy/config/filter/http/local_rate_limit/v2alpha/local_rate_limit.pb.validate.h"
+
+#include "extensions/filters/http/local_ratelimit/config.h"
+
+#include "test/mocks/server/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace LocalRateLimitFilter {
+namespace {
+
+TEST(LocalRateLimitFilterConfigTest, ValidateFail) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  EXPECT_THROW(LocalRateLimitFilterConfig().createFilterFactoryFromProto(
+                   envoy::config::filter::http::local_rate_limit::v2alpha::LocalRateLimit(),
+                   "stats", context),
+               ProtoValidationException);
+}
+
+TEST(LocalRateLimitFilterConfigTest, LocalRateLimitCorrectProto) {
+  const std::string yaml = R"EOF(
+  stat_prefix: local
+  token_bucket:
+    max_tokens: 100
+    tokens_per_fill: 10
+    fill_interval: 0.5s
+  descriptors:
+  - entries:
+    - key: remote_address
+      value: 10.0.0.1
+    token_bucket:
+      max_tokens: 10
+      fill_interval: 1s
+  )EOF";
+
+  envoy::config::filter::http::local_rate_limit::v2alpha::LocalRateLimit proto_config;
+  MessageUtil::loadFromYamlAndValidate(yaml, proto_config);
+
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  LocalRateLimitFilterConfig factory;
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(proto_config, "stats", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamDecoderFilter(_));
+  cb(filter_callback);
+}
+
+TEST(LocalRateLimitFilterConfigTest, ZeroFillInterval) {
+  const std::string yaml = R"EOF(
+  stat_prefix: local
+  token_bucket:
+    max_tokens: 100
+    fill_interval: 0s
+  )EOF";
+
+  envoy::config::filter::http::local_rate_limit::v2alpha::LocalRateLimit proto_config;
+  EXPECT_THROW(MessageUtil::loadFromYamlAndValidate(yaml, proto_config),
+               ProtoValidationException);
+}
+
+} // namespace
+} // namespace LocalRateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
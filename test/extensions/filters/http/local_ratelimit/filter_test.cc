@@ -0,0 +1,146 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/http/headers.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/local_ratelimit/local_ratelimit.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/router/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::WithArgs;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace LocalRateLimitFilter {
+namespace {
+
+class LocalRateLimitFilterTest : public testing::Test {
+public:
+  void setup(const std::string& yaml) {
+    envoy::config::filter::http::local_rate_limit::v2alpha::LocalRateLimit proto_config;
+    MessageUtil::loadFromYaml(yaml, proto_config);
+    config_ = std::make_shared<FilterConfig>(proto_config, local_info_, "prefix.", stats_store_,
+                                             time_system_);
+    filter_ = std::make_unique<Filter>(config_);
+    filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+    decoder_callbacks_.route_->route_entry_.rate_limit_policy_.rate_limit_policy_entry_.clear();
+    decoder_callbacks_.route_->route_entry_.rate_limit_policy_.rate_limit_policy_entry_
+        .emplace_back(route_rate_limit_);
+  }
+
+  void expectRateLimited() {
+    EXPECT_CALL(decoder_callbacks_, encodeHeaders_(HeaderHasValueRef(":status", "429"), false))
+        .WillOnce(Invoke([](const Http::HeaderMap& headers, bool) -> void {
+          EXPECT_THAT(headers, HeaderHasValueRef("x-envoy-ratelimited",
+                                                 Http::Headers::get().EnvoyRateLimitedValues.True));
+        }));
+    EXPECT_CALL(decoder_callbacks_.stream_info_,
+                setResponseFlag(StreamInfo::ResponseFlag::RateLimited));
+    EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+              filter_->decodeHeaders(request_headers_, true));
+    EXPECT_EQ("local_rate_limited", decoder_callbacks_.details_);
+  }
+
+  uint64_t counter(const std::string& name) {
+    return stats_store_.counter("prefix.http_local_rate_limit.local." + name).value();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl stats_store_;
+  NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  NiceMock<Router::MockRateLimitPolicyEntry> route_rate_limit_;
+  Http::TestHeaderMapImpl request_headers_{{":method", "GET"}, {":path", "/"}};
+  FilterConfigSharedPtr config_;
+  std::unique_ptr<Filter> filter_;
+};
+
+TEST_F(LocalRateLimitFilterTest, RateLimited) {
+  setup(R"EOF(
+  stat_prefix: local
+  token_bucket:
+    max_tokens: 1
+    fill_interval: 60s
+  )EOF");
+
+  // Without descriptors the route policy is not even looked at.
+  EXPECT_CALL(route_rate_limit_, populateDescriptors(_, _, _, _, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+  expectRateLimited();
+  EXPECT_EQ(1U, counter("ok"));
+  EXPECT_EQ(1U, counter("rate_limited"));
+
+  time_system_.sleep(std::chrono::seconds(60));
+  filter_ = std::make_unique<Filter>(config_);
+  filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(2U, counter("ok"));
+}
+
+TEST_F(LocalRateLimitFilterTest, Descriptors) {
+  setup(R"EOF(
+  stat_prefix: local
+  token_bucket:
+    max_tokens: 1
+    fill_interval: 60s
+  descriptors:
+  - entries:
+    - key: header_match
+      value: fast
+    token_bucket:
+      max_tokens: 2
+      fill_interval: 60s
+  )EOF");
+
+  EXPECT_CALL(route_rate_limit_, populateDescriptors(_, _, _, _, _))
+      .Times(3)
+      .WillRepeatedly(WithArgs<1>(Invoke([](std::vector<RateLimit::Descriptor>& descriptors) {
+        descriptors.push_back({{{"header_match", "fast"}}});
+      })));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+  expectRateLimited();
+  EXPECT_EQ(2U, counter("ok"));
+  EXPECT_EQ(1U, counter("rate_limited"));
+}
+
+TEST_F(LocalRateLimitFilterTest, NoRoute) {
+  setup(R"EOF(
+  stat_prefix: local
+  token_bucket:
+    max_tokens: 1
+    fill_interval: 60s
+  descriptors:
+  - entries:
+    - key: header_match
+      value: fast
+    token_bucket:
+      max_tokens: 2
+      fill_interval: 60s
+  )EOF");
+
+  // Requests without a route take their token from the default bucket.
+  EXPECT_CALL(*decoder_callbacks_.route_, routeEntry()).WillRepeatedly(Return(nullptr));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, true));
+  expectRateLimited();
+}
+
+} // namespace
+} // namespace LocalRateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
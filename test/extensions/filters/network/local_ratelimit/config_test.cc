@@ -0,0 +1,49 @@
+#include "envoy/config/filter/network/local_rate_limit/v2alpha/local_rate_limit.pb.validate.h"
+
+#include "extensions/filters/network/local_ratelimit/config.h"
+
+#include "test/mocks/server/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace LocalRateLimitFilter {
+namespace {
+
+TEST(LocalRateLimitConfigTest, ValidateFail) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  EXPECT_THROW(LocalRateLimitConfigFactory().createFilterFactoryFromProto(
+                   envoy::config::filter::network::local_rate_limit::v2alpha::LocalRateLimit(),
+                   context),
+               ProtoValidationException);
+}
+
+TEST(LocalRateLimitConfigTest, LocalRateLimitCorrectProto) {
+  const std::string yaml = R"EOF(
+  stat_prefix: local
+  token_bucket:
+    max_tokens: 100
+    fill_interval: 1s
+  )EOF";
+
+  envoy::config::filter::network::local_rate_limit::v2alpha::LocalRateLimit proto_config;
+  MessageUtil::loadFromYamlAndValidate(yaml, proto_config);
+
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  LocalRateLimitConfigFactory factory;
+  Network::FilterFactoryCb cb = factory.createFilterFactoryFromProto(proto_config, context);
+  Network::MockConnection connection;
+  EXPECT_CALL(connection, addReadFilter(_));
+  cb(connection);
+}
+
+} // namespace
+} // namespace LocalRateLimitFilter
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
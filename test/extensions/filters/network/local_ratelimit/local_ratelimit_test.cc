@@ -0,0 +1,72 @@
+#include <memory>
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/network/local_ratelimit/local_ratelimit.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace LocalRateLimitFilter {
+namespace {
+
+class LocalRateLimitNetworkFilterTest : public testing::Test {
+public:
+  LocalRateLimitNetworkFilterTest() {
+    envoy::config::filter::network::local_rate_limit::v2alpha::LocalRateLimit proto_config;
+    MessageUtil::loadFromYaml(R"EOF(
+    stat_prefix: local
+    token_bucket:
+      max_tokens: 1
+      fill_interval: 10s
+    )EOF",
+                              proto_config);
+    config_ = std::make_shared<Config>(proto_config, stats_store_, time_system_);
+  }
+
+  std::unique_ptr<Filter> createFilter() {
+    auto filter = std::make_unique<Filter>(config_);
+    filter->initializeReadFilterCallbacks(read_filter_callbacks_);
+    return filter;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl stats_store_;
+  NiceMock<Network::MockReadFilterCallbacks> read_filter_callbacks_;
+  ConfigSharedPtr config_;
+};
+
+TEST_F(LocalRateLimitNetworkFilterTest, RateLimited) {
+  EXPECT_CALL(read_filter_callbacks_.connection_, close(_)).Times(0);
+  EXPECT_EQ(Network::FilterStatus::Continue, createFilter()->onNewConnection());
+
+  EXPECT_CALL(read_filter_callbacks_.connection_, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_EQ(Network::FilterStatus::StopIteration, createFilter()->onNewConnection());
+  EXPECT_EQ(1U, stats_store_.counter("local_rate_limit.local.rate_limited").value());
+
+  // The token is back once the fill interval is over.
+  time_system_.sleep(std::chrono::seconds(10));
+  EXPECT_CALL(read_filter_callbacks_.connection_, close(_)).Times(0);
+  auto filter = createFilter();
+  EXPECT_EQ(Network::FilterStatus::Continue, filter->onNewConnection());
+  Buffer::OwnedImpl data("hello");
+  EXPECT_EQ(Network::FilterStatus::Continue, filter->onData(data, false));
+}
+
+} // namespace
+} // namespace LocalRateLimitFilter
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,169 @@
+#include <sys/socket.h>
+
+#include "envoy/config/transport_socket/tap/v2alpha/tap.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/raw_buffer_socket.h"
+#include "common/network/transport_socket_options_impl.h"
+#include "common/singleton/manager_impl.h"
+
+#include "extensions/transport_sockets/tap/tap.h"
+
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/server/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tap {
+namespace {
+
+class MockPerSocketTapper : public PerSocketTapper {
+public:
+  MOCK_METHOD1(closeSocket, void(Network::ConnectionEvent event));
+  MOCK_METHOD2(onRead, void(const Buffer::Instance& data, uint32_t bytes_read));
+  MOCK_METHOD3(onWrite, void(const Buffer::Instance& data, uint32_t bytes_written, bool end_stream));
+};
+
+class MockSocketTapConfig : public SocketTapConfig {
+public:
+  PerSocketTapperPtr createPerSocketTapper(const Network::Connection& connection) override {
+    return PerSocketTapperPtr{createPerSocketTapper_(connection)};
+  }
+
+  Extensions::Common::Tap::PerTapSinkHandleManagerPtr
+  createPerTapSinkHandleManager(uint64_t trace_id) override {
+    return Extensions::Common::Tap::PerTapSinkHandleManagerPtr{
+        createPerTapSinkHandleManager_(trace_id)};
+  }
+
+  MOCK_METHOD1(createPerSocketTapper_, PerSocketTapper*(const Network::Connection& connection));
+  MOCK_METHOD1(createPerTapSinkHandleManager_,
+               Extensions::Common::Tap::PerTapSinkHandleManager*(uint64_t trace_id));
+  MOCK_CONST_METHOD0(maxBufferedRxBytes, uint32_t());
+  MOCK_CONST_METHOD0(maxBufferedTxBytes, uint32_t());
+  MOCK_CONST_METHOD0(createMatchStatusVector,
+                     Extensions::Common::Tap::Matcher::MatchStatusVector());
+  MOCK_CONST_METHOD0(rootMatcher, const Extensions::Common::Tap::Matcher&());
+  MOCK_CONST_METHOD0(streaming, bool());
+  MOCK_CONST_METHOD0(timeSource, TimeSource&());
+};
+
+class TestTapConfigFactory : public Extensions::Common::Tap::TapConfigFactory {
+public:
+  TestTapConfigFactory(std::shared_ptr<MockSocketTapConfig> config) : config_(config) {}
+
+  // TapConfigFactory
+  Extensions::Common::Tap::TapConfigSharedPtr
+  createConfigFromProto(envoy::service::tap::v2alpha::TapConfig&&,
+                        Extensions::Common::Tap::Sink*) override {
+    return config_;
+  }
+
+private:
+  const std::shared_ptr<MockSocketTapConfig> config_;
+};
+
+class MockWriteBatch : public Network::WriteBatch {
+public:
+  MOCK_METHOD3(add, void(Network::IoHandle& io_handle, Buffer::Instance& buffer,
+                         Network::WriteBatchCallbacks& callbacks));
+  MOCK_METHOD1(remove, void(Network::WriteBatchCallbacks& callbacks));
+};
+
+class TapSocketFactoryTest : public testing::Test {
+protected:
+  std::unique_ptr<TapSocketFactory>
+  createFactory(Network::TransportSocketFactoryPtr&& transport_socket_factory) {
+    envoy::config::transport_socket::tap::v2alpha::Tap proto_config;
+    proto_config.mutable_common_config()->mutable_static_config();
+    return std::make_unique<TapSocketFactory>(
+        proto_config, std::make_unique<TestTapConfigFactory>(config_), admin_, singleton_manager_,
+        tls_, dispatcher_, std::move(transport_socket_factory));
+  }
+
+  std::shared_ptr<MockSocketTapConfig> config_{std::make_shared<MockSocketTapConfig>()};
+  NiceMock<Server::MockAdmin> admin_;
+  Singleton::ManagerImpl singleton_manager_{Thread::threadFactoryForTest().currentThreadId()};
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+};
+
+// The wrapped socket keeps the server name override but may not batch its writes.
+TEST_F(TapSocketFactoryTest, WrappedSocketOptions) {
+  auto* inner_factory = new Network::MockTransportSocketFactory;
+  auto factory = createFactory(Network::TransportSocketFactoryPtr{inner_factory});
+
+  EXPECT_CALL(*inner_factory, createTransportSocket(_))
+      .WillOnce(Invoke([](Network::TransportSocketOptionsSharedPtr options) {
+        EXPECT_FALSE(options->allowWriteBatching());
+        EXPECT_EQ("example.com", options->serverNameOverride().value());
+        return std::make_unique<NiceMock<Network::MockTransportSocket>>();
+      }));
+  factory->createTransportSocket(
+      std::make_shared<Network::TransportSocketOptionsImpl>("example.com"));
+
+  EXPECT_CALL(*inner_factory, createTransportSocket(_))
+      .WillOnce(Invoke([](Network::TransportSocketOptionsSharedPtr options) {
+        EXPECT_FALSE(options->allowWriteBatching());
+        EXPECT_FALSE(options->serverNameOverride().has_value());
+        return std::make_unique<NiceMock<Network::MockTransportSocket>>();
+      }));
+  factory->createTransportSocket(nullptr);
+}
+
+// With write batching available the wrapped raw buffer socket still writes directly, so the tap
+// records the bytes which were written by the doWrite() call they were passed to.
+TEST_F(TapSocketFactoryTest, WritesAreNotBatched) {
+  auto factory = createFactory(std::make_unique<Network::RawBufferSocketFactory>());
+  Network::TransportSocketPtr socket = factory->createTransportSocket(nullptr);
+
+  int fds[2];
+  ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+  Network::IoSocketHandleImpl local(fds[0]);
+  Network::IoSocketHandleImpl remote(fds[1]);
+
+  NiceMock<Network::MockTransportSocketCallbacks> callbacks;
+  MockWriteBatch write_batch;
+  ON_CALL(callbacks, ioHandle()).WillByDefault(ReturnRef(local));
+  ON_CALL(callbacks.connection_.dispatcher_, writeBatch()).WillByDefault(Return(&write_batch));
+  auto* tapper = new MockPerSocketTapper;
+  EXPECT_CALL(*config_, createPerSocketTapper_(_)).WillOnce(Return(tapper));
+  socket->setTransportSocketCallbacks(callbacks);
+
+  EXPECT_CALL(write_batch, add(_, _, _)).Times(0);
+  EXPECT_CALL(*tapper, onWrite(BufferStringEqual("hello"), 5, false));
+  Buffer::OwnedImpl buffer("hello");
+  Network::IoResult result = socket->doWrite(buffer, false);
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(5, result.bytes_processed_);
+
+  EXPECT_CALL(*tapper, onWrite(BufferStringEqual("world"), 5, false));
+  buffer.add("world");
+  result = socket->doWrite(buffer, false);
+  EXPECT_EQ(5, result.bytes_processed_);
+
+  Buffer::OwnedImpl received;
+  received.read(remote, 1024);
+  EXPECT_EQ("helloworld", received.toString());
+}
+
+} // namespace
+} // namespace Tap
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -65,6 +65,7 @@ public:
   MOCK_METHOD4(recv, SysCallSizeResult(int socket, void* buffer, size_t length, int flags));
   MOCK_METHOD6(recvfrom, SysCallSizeResult(int sockfd, void* buffer, size_t length, int flags,
                                            struct sockaddr* addr, socklen_t* addrlen));
+  MOCK_METHOD3(sendmsg, SysCallSizeResult(int sockfd, const msghdr* message, int flags));
   MOCK_METHOD2(ftruncate, SysCallIntResult(int fd, off_t length));
   MOCK_METHOD6(mmap, SysCallPtrResult(void* addr, size_t length, int prot, int flags, int fd,
                                       off_t offset));
@@ -85,6 +86,12 @@ class MockLinuxOsSysCalls : public LinuxOsSysCallsImpl {
 public:
   // Api::LinuxOsSysCalls
   MOCK_METHOD3(sched_getaffinity, SysCallIntResult(pid_t pid, size_t cpusetsize, cpu_set_t* mask));
+  MOCK_METHOD3(sched_setaffinity,
+               SysCallIntResult(pid_t pid, size_t cpusetsize, const cpu_set_t* mask));
+  MOCK_METHOD5(recvmmsg, SysCallIntResult(int sockfd, mmsghdr* messages, unsigned int length,
+                                          int flags, timespec* timeout));
+  MOCK_METHOD4(sendmmsg,
+               SysCallIntResult(int sockfd, mmsghdr* messages, unsigned int length, int flags));
 };
 #endif
 
@@ -63,9 +63,9 @@ public:
         createListener_(socket, cb, bind_to_port, hand_off_restored_destination_connections)};
   }
 
-  Network::ListenerPtr createUdpListener(Network::Socket& socket,
-                                         Network::UdpListenerCallbacks& cb) override {
-    return Network::ListenerPtr{createUdpListener_(socket, cb)};
+  Network::UdpListenerPtr createUdpListener(Network::Socket& socket,
+                                            Network::UdpListenerCallbacks& cb) override {
+    return Network::UdpListenerPtr{createUdpListener_(socket, cb)};
   }
 
   Event::TimerPtr createTimer(Event::TimerCb cb) override {
@@ -106,7 +106,7 @@ public:
                                   bool bind_to_port,
                                   bool hand_off_restored_destination_connections));
   MOCK_METHOD2(createUdpListener_,
-               Network::Listener*(Network::Socket& socket, Network::UdpListenerCallbacks& cb));
+               Network::UdpListener*(Network::Socket& socket, Network::UdpListenerCallbacks& cb));
   MOCK_METHOD1(createTimer_, Timer*(Event::TimerCb cb));
   MOCK_METHOD1(deferredDelete_, void(DeferredDeletable* to_delete));
   MOCK_METHOD0(exit, void());
@@ -114,6 +114,7 @@ public:
   MOCK_METHOD1(post, void(std::function<void()> callback));
   MOCK_METHOD1(run, void(RunType type));
   Buffer::WatermarkFactory& getWatermarkFactory() override { return buffer_factory_; }
+  MOCK_METHOD0(writeBatch, Network::WriteBatch*());
 
   GlobalTimeSystem time_system_;
   std::list<DeferredDeletablePtr> to_delete_;
@@ -85,6 +85,7 @@ public:
   MOCK_METHOD1(setDelayedCloseTimeout, void(std::chrono::milliseconds));
   MOCK_CONST_METHOD0(delayedCloseTimeout, std::chrono::milliseconds());
   MOCK_CONST_METHOD0(transportFailureReason, absl::string_view());
+  MOCK_METHOD0(rawIoHandle, IoHandle*());
 };
 
 /**
@@ -131,6 +132,7 @@ public:
   MOCK_METHOD1(setDelayedCloseTimeout, void(std::chrono::milliseconds));
   MOCK_CONST_METHOD0(delayedCloseTimeout, std::chrono::milliseconds());
   MOCK_CONST_METHOD0(transportFailureReason, absl::string_view());
+  MOCK_METHOD0(rawIoHandle, IoHandle*());
 
   // Network::ClientConnection
   MOCK_METHOD0(connect, void());
@@ -180,6 +182,7 @@ public:
   MOCK_METHOD1(setDelayedCloseTimeout, void(std::chrono::milliseconds));
   MOCK_CONST_METHOD0(delayedCloseTimeout, std::chrono::milliseconds());
   MOCK_CONST_METHOD0(transportFailureReason, absl::string_view());
+  MOCK_METHOD0(rawIoHandle, IoHandle*());
 
   // Network::FilterManagerConnection
   MOCK_METHOD0(getReadBuffer, StreamBuffer());
@@ -29,6 +29,7 @@ MockListenerConfig::MockListenerConfig() {
   ON_CALL(*this, socket()).WillByDefault(ReturnRef(socket_));
   ON_CALL(*this, listenerScope()).WillByDefault(ReturnRef(scope_));
   ON_CALL(*this, name()).WillByDefault(ReturnRef(name_));
+  ON_CALL(*this, connectionBalancer()).WillByDefault(ReturnRef(connection_balancer_));
 }
 MockListenerConfig::~MockListenerConfig() {}
 
@@ -91,7 +92,13 @@ MockFilter::~MockFilter() {}
 MockListenerCallbacks::MockListenerCallbacks() {}
 MockListenerCallbacks::~MockListenerCallbacks() {}
 
-MockUdpListenerCallbacks::MockUdpListenerCallbacks() {}
+MockUdpListenerCallbacks::MockUdpListenerCallbacks() {
+  ON_CALL(*this, onDataBatch_(_)).WillByDefault(Invoke([this](UdpDataBatch& batch) {
+    for (const UdpData& data : batch) {
+      onData_(data);
+    }
+  }));
+}
 MockUdpListenerCallbacks::~MockUdpListenerCallbacks() {}
 
 MockDrainDecision::MockDrainDecision() {}
@@ -147,6 +154,12 @@ MockConnectionSocket::MockConnectionSocket()
 MockListener::MockListener() {}
 MockListener::~MockListener() { onDestroy(); }
 
+MockBalancedConnectionHandler::MockBalancedConnectionHandler() {}
+MockBalancedConnectionHandler::~MockBalancedConnectionHandler() {}
+
+MockConnectionBalancer::MockConnectionBalancer() {}
+MockConnectionBalancer::~MockConnectionBalancer() {}
+
 MockConnectionHandler::MockConnectionHandler() {}
 MockConnectionHandler::~MockConnectionHandler() {}
 
@@ -13,6 +13,7 @@
 #include "envoy/network/transport_socket.h"
 #include "envoy/stats/scope.h"
 
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/filter_manager_impl.h"
 #include "common/stats/isolated_store_impl.h"
 
@@ -142,12 +143,16 @@ public:
 
   void onData(const UdpData& data) override { onData_(data); }
 
+  void onDataBatch(UdpDataBatch& batch) override { onDataBatch_(batch); }
+
   void onWriteReady(const Socket& socket) override { onWriteReady_(socket); }
 
   void onError(const ErrorCode& err_code, int err) override { onError_(err_code, err); }
 
   MOCK_METHOD1(onData_, void(const UdpData& data));
 
+  MOCK_METHOD1(onDataBatch_, void(UdpDataBatch& batch));
+
   MOCK_METHOD1(onWriteReady_, void(const Socket& socket));
 
   MOCK_METHOD2(onError_, void(const ErrorCode& err_code, int err));
@@ -306,11 +311,14 @@ public:
   MOCK_METHOD0(listenerScope, Stats::Scope&());
   MOCK_CONST_METHOD0(listenerTag, uint64_t());
   MOCK_CONST_METHOD0(name, const std::string&());
+  MOCK_METHOD0(udpListenerFactory, const ActiveUdpListenerFactory*());
+  MOCK_METHOD0(connectionBalancer, ConnectionBalancer&());
 
   testing::NiceMock<MockFilterChainFactory> filter_chain_factory_;
   testing::NiceMock<MockListenSocket> socket_;
   Stats::IsolatedStoreImpl scope_;
   std::string name_;
+  NopConnectionBalancerImpl connection_balancer_;
 };
 
 class MockListener : public Listener {
@@ -323,12 +331,37 @@ public:
   MOCK_METHOD0(disable, void());
 };
 
+class MockBalancedConnectionHandler : public BalancedConnectionHandler {
+public:
+  MockBalancedConnectionHandler();
+  ~MockBalancedConnectionHandler();
+
+  void post(ConnectionSocketPtr&& socket) override { post_(socket); }
+
+  MOCK_CONST_METHOD0(numConnections, uint64_t());
+  MOCK_METHOD0(incNumConnections, void());
+  MOCK_METHOD1(post_, void(ConnectionSocketPtr& socket));
+};
+
+class MockConnectionBalancer : public ConnectionBalancer {
+public:
+  MockConnectionBalancer();
+  ~MockConnectionBalancer();
+
+  MOCK_METHOD1(registerHandler, void(BalancedConnectionHandler& handler));
+  MOCK_METHOD1(unregisterHandler, void(BalancedConnectionHandler& handler));
+  MOCK_METHOD1(pickTargetHandler,
+               BalancedConnectionHandler&(BalancedConnectionHandler& current_handler));
+};
+
 class MockConnectionHandler : public ConnectionHandler {
 public:
   MockConnectionHandler();
   ~MockConnectionHandler();
 
   MOCK_METHOD0(numConnections, uint64_t());
+  MOCK_METHOD0(incNumConnections, void());
+  MOCK_METHOD0(decNumConnections, void());
   MOCK_METHOD1(addListener, void(ListenerConfig& config));
   MOCK_METHOD1(addUdpListener, void(ListenerConfig& config));
   MOCK_METHOD1(findListenerByAddress,
@@ -391,6 +424,7 @@ public:
   MOCK_METHOD2(doWrite, IoResult(Buffer::Instance& buffer, bool end_stream));
   MOCK_METHOD0(onConnected, void());
   MOCK_CONST_METHOD0(ssl, const Ssl::ConnectionInfo*());
+  MOCK_CONST_METHOD0(passthrough, bool());
 
   TransportSocketCallbacks* callbacks_{};
 };
@@ -415,6 +449,7 @@ public:
   MOCK_METHOD0(shouldDrainReadBuffer, bool());
   MOCK_METHOD0(setReadBufferReady, void());
   MOCK_METHOD1(raiseEvent, void(ConnectionEvent));
+  MOCK_METHOD0(flushWriteBuffer, void());
 
   testing::NiceMock<MockConnection> connection_;
 };
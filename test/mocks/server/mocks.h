@@ -79,6 +79,8 @@ public:
   MOCK_CONST_METHOD0(mutexTracingEnabled, bool());
   MOCK_CONST_METHOD0(libeventBufferEnabled, bool());
   MOCK_CONST_METHOD0(cpusetThreadsEnabled, bool());
+  MOCK_CONST_METHOD0(workerCpuAffinity, const std::vector<uint32_t>&());
+  MOCK_CONST_METHOD0(mainThreadCpuAffinity, const std::vector<uint32_t>&());
   MOCK_CONST_METHOD0(toCommandLineOptions, Server::CommandLineOptionsPtr());
 
   std::string config_path_;
@@ -95,6 +97,8 @@ public:
   bool signal_handling_enabled_{true};
   bool mutex_tracing_enabled_{};
   bool cpuset_threads_enabled_{};
+  std::vector<uint32_t> worker_cpu_affinity_;
+  std::vector<uint32_t> main_thread_cpu_affinity_;
 };
 
 class MockConfigTracker : public ConfigTracker {
@@ -277,7 +281,9 @@ public:
   ~MockWorkerFactory();
 
   // Server::WorkerFactory
-  WorkerPtr createWorker(OverloadManager&) override { return WorkerPtr{createWorker_()}; }
+  WorkerPtr createWorker(uint32_t, OverloadManager&) override {
+    return WorkerPtr{createWorker_()};
+  }
 
   MOCK_METHOD0(createWorker_, Worker*());
 };
@@ -309,6 +309,8 @@ public:
                                                   LoadBalancerContext* context));
   MOCK_METHOD1(httpAsyncClientForCluster, Http::AsyncClient&(const std::string& cluster));
   MOCK_METHOD1(removeCluster, bool(const std::string& cluster));
+  MOCK_METHOD0(beginClusterUpdateBatch, void());
+  MOCK_METHOD0(endClusterUpdateBatch, void());
   MOCK_METHOD0(shutdown, void());
   MOCK_CONST_METHOD0(bindConfig, const envoy::api::v2::core::BindConfig&());
   MOCK_METHOD0(adsMux, Config::GrpcMux&());
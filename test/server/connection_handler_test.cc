@@ -2,6 +2,7 @@
 
 #include "common/common/utility.h"
 #include "common/network/address_impl.h"
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/raw_buffer_socket.h"
 #include "common/network/utility.h"
 
@@ -18,7 +19,9 @@ using testing::_;
 using testing::ByRef;
 using testing::InSequence;
 using testing::Invoke;
+using testing::InvokeWithoutArgs;
 using testing::NiceMock;
+using testing::Ref;
 using testing::Return;
 using testing::ReturnRef;
 
@@ -29,7 +32,7 @@ namespace {
 class ConnectionHandlerTest : public testing::Test, protected Logger::Loggable<Logger::Id::main> {
 public:
   ConnectionHandlerTest()
-      : handler_(new ConnectionHandlerImpl(ENVOY_LOGGER(), dispatcher_)),
+      : handler_(new ConnectionHandlerImpl(ENVOY_LOGGER(), dispatcher_, "test.")),
         filter_chain_(Network::Test::createEmptyFilterChainWithRawBufferSockets()) {}
 
   class TestListener : public Network::ListenerConfig, public LinkedObject<TestListener> {
@@ -39,7 +42,8 @@ public:
                  std::chrono::milliseconds listener_filters_timeout)
         : parent_(parent), tag_(tag), bind_to_port_(bind_to_port),
           hand_off_restored_destination_connections_(hand_off_restored_destination_connections),
-          name_(name), listener_filters_timeout_(listener_filters_timeout) {}
+          name_(name), listener_filters_timeout_(listener_filters_timeout),
+          connection_balancer_(std::make_unique<Network::NopConnectionBalancerImpl>()) {}
 
     // Network::ListenerConfig
     Network::FilterChainManager& filterChainManager() override { return parent_.manager_; }
@@ -57,14 +61,50 @@ public:
     Stats::Scope& listenerScope() override { return parent_.stats_store_; }
     uint64_t listenerTag() const override { return tag_; }
     const std::string& name() const override { return name_; }
+    const Network::ActiveUdpListenerFactory* udpListenerFactory() override {
+      return udp_listener_factory_.get();
+    }
+    Network::ConnectionBalancer& connectionBalancer() override { return *connection_balancer_; }
 
     ConnectionHandlerTest& parent_;
-    Network::MockListenSocket socket_;
+    NiceMock<Network::MockListenSocket> socket_;
     uint64_t tag_;
     bool bind_to_port_;
     const bool hand_off_restored_destination_connections_;
     const std::string name_;
     const std::chrono::milliseconds listener_filters_timeout_;
+    Network::ActiveUdpListenerFactoryPtr udp_listener_factory_;
+    Network::ConnectionBalancerPtr connection_balancer_;
+  };
+
+  // An active udp listener wrapping a mock listener, which is handed out by its factory.
+  class TestActiveUdpListener : public Network::ConnectionHandler::ActiveListener {
+  public:
+    TestActiveUdpListener(Network::ListenerPtr&& listener, uint64_t tag)
+        : listener_(std::move(listener)), tag_(tag) {}
+
+    // Network::ConnectionHandler::ActiveListener
+    uint64_t listenerTag() override { return tag_; }
+    Network::Listener* listener() override { return listener_.get(); }
+    void destroy() override { listener_.reset(); }
+
+    Network::ListenerPtr listener_;
+    const uint64_t tag_;
+  };
+
+  class TestActiveUdpListenerFactory : public Network::ActiveUdpListenerFactory {
+  public:
+    TestActiveUdpListenerFactory(Network::MockListener* listener) : listener_(listener) {}
+
+    // Network::ActiveUdpListenerFactory
+    Network::ConnectionHandler::ActiveListenerPtr
+    createActiveUdpListener(Network::ConnectionHandler&, Event::Dispatcher&, spdlog::logger&,
+                            Network::ListenerConfig& config) const override {
+      return std::make_unique<TestActiveUdpListener>(Network::ListenerPtr{listener_},
+                                                     config.listenerTag());
+    }
+
+    Network::MockListener* const listener_;
   };
 
   typedef std::unique_ptr<TestListener> TestListenerPtr;
@@ -82,10 +122,11 @@ public:
 
   Stats::IsolatedStoreImpl stats_store_;
   NiceMock<Event::MockDispatcher> dispatcher_;
+  // The listeners outlive the handler, which unregisters from their connection balancers.
+  std::list<TestListenerPtr> listeners_;
   Network::ConnectionHandlerPtr handler_;
   NiceMock<Network::MockFilterChainManager> manager_;
   NiceMock<Network::MockFilterChainFactory> factory_;
-  std::list<TestListenerPtr> listeners_;
   const Network::FilterChainSharedPtr filter_chain_;
 };
 
@@ -167,6 +208,128 @@ TEST_F(ConnectionHandlerTest, AddDisabledListener) {
   handler_->addListener(*test_listener);
 }
 
+TEST_F(ConnectionHandlerTest, UdpListener) {
+  Network::MockListener* listener = new NiceMock<Network::MockListener>();
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _)).Times(0);
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  EXPECT_CALL(test_listener->socket_, socketType())
+      .WillRepeatedly(Return(Network::Address::SocketType::Datagram));
+  test_listener->udp_listener_factory_ = std::make_unique<TestActiveUdpListenerFactory>(listener);
+  handler_->addListener(*test_listener);
+
+  // Connections are not handed off to udp listeners.
+  EXPECT_EQ(nullptr, handler_->findListenerByAddress(*test_listener->socket_.localAddress()));
+
+  EXPECT_CALL(*listener, disable());
+  handler_->disableListeners();
+  EXPECT_CALL(*listener, enable());
+  handler_->enableListeners();
+
+  // The connections of the udp listener are counted by the handler.
+  handler_->incNumConnections();
+  EXPECT_EQ(1UL, handler_->numConnections());
+  handler_->decNumConnections();
+  EXPECT_EQ(0UL, handler_->numConnections());
+
+  EXPECT_CALL(*listener, onDestroy());
+  handler_->stopListeners(1);
+  handler_->removeListeners(1);
+}
+
+TEST_F(ConnectionHandlerTest, ConnectionBalancerPostsToTargetHandler) {
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  Network::MockConnectionBalancer* balancer = new Network::MockConnectionBalancer();
+  test_listener->connection_balancer_.reset(balancer);
+  Network::MockListener* listener = new NiceMock<Network::MockListener>();
+  Network::ListenerCallbacks* listener_callbacks;
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+          }));
+  Network::BalancedConnectionHandler* current_handler;
+  EXPECT_CALL(*balancer, registerHandler(_))
+      .WillOnce(Invoke(
+          [&](Network::BalancedConnectionHandler& handler) { current_handler = &handler; }));
+  handler_->addListener(*test_listener);
+
+  // The socket is posted to the handler picked by the balancer, without running the listener
+  // filters.
+  NiceMock<Network::MockBalancedConnectionHandler> target_handler;
+  EXPECT_CALL(*balancer, pickTargetHandler(_)).WillOnce(ReturnRef(target_handler));
+  EXPECT_CALL(target_handler, post_(_));
+  EXPECT_CALL(factory_, createListenerFilterChain(_)).Times(0);
+  listener_callbacks->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, true);
+  EXPECT_EQ(0UL, handler_->numConnections());
+
+  // A socket posted to this handler is accepted without being balanced again. The balancer counts
+  // it on this handler when it picks it.
+  EXPECT_CALL(*balancer, pickTargetHandler(_)).Times(0);
+  EXPECT_CALL(factory_, createListenerFilterChain(_)).WillOnce(Return(true));
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(filter_chain_.get()));
+  Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).WillOnce(Return(connection));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillOnce(Return(true));
+  current_handler->incNumConnections();
+  current_handler->post(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()});
+  EXPECT_EQ(1UL, current_handler->numConnections());
+  EXPECT_EQ(1UL, handler_->numConnections());
+  EXPECT_EQ(1UL, stats_store_.counter("test.downstream_cx_total").value());
+  EXPECT_EQ(1UL, stats_store_.gauge("test.downstream_cx_active").value());
+
+  EXPECT_CALL(*balancer, unregisterHandler(Ref(*current_handler)));
+  EXPECT_CALL(*connection, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*listener, onDestroy());
+  handler_->removeListeners(1);
+  EXPECT_EQ(0UL, handler_->numConnections());
+  EXPECT_EQ(0UL, stats_store_.gauge("test.downstream_cx_active").value());
+}
+
+TEST_F(ConnectionHandlerTest, ExactConnectionBalancerAcrossHandlers) {
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  test_listener->connection_balancer_ = std::make_unique<Network::ExactConnectionBalancerImpl>();
+  Network::ListenerCallbacks* listener_callbacks;
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return new NiceMock<Network::MockListener>();
+          }))
+      .WillOnce(Return(new NiceMock<Network::MockListener>()));
+  handler_->addListener(*test_listener);
+  // Another worker with the same listener.
+  ConnectionHandlerImpl handler2(ENVOY_LOGGER(), dispatcher_, "test2.");
+  handler2.addListener(*test_listener);
+
+  EXPECT_CALL(manager_, findFilterChain(_)).WillRepeatedly(Return(filter_chain_.get()));
+  EXPECT_CALL(dispatcher_, createServerConnection_(_, _))
+      .WillRepeatedly(InvokeWithoutArgs(
+          []() -> Network::Connection* { return new NiceMock<Network::MockConnection>(); }));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillRepeatedly(Return(true));
+
+  // All the sockets are accepted by the first handler, and the connections are balanced across
+  // both.
+  for (int i = 0; i < 4; i++) {
+    listener_callbacks->onAccept(
+        Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, true);
+  }
+  EXPECT_EQ(2UL, handler_->numConnections());
+  EXPECT_EQ(2UL, handler2.numConnections());
+  EXPECT_EQ(4UL, stats_store_.gauge("downstream_cx_active").value());
+  EXPECT_EQ(2UL, stats_store_.gauge("test.downstream_cx_active").value());
+  EXPECT_EQ(2UL, stats_store_.gauge("test2.downstream_cx_active").value());
+
+  // Once the listener of the second handler is stopped, it is not picked anymore.
+  handler2.stopListeners(1);
+  listener_callbacks->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, true);
+  EXPECT_EQ(3UL, handler_->numConnections());
+  EXPECT_EQ(2UL, handler2.numConnections());
+}
+
 TEST_F(ConnectionHandlerTest, DestroyCloseConnections) {
   InSequence s;
 
@@ -0,0 +1,85 @@
+#include <vector>
+
+#include "server/cpu_affinity.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#include "test/mocks/api/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::ElementsAre;
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+TEST(CpuAffinityTest, WorkerCpus) {
+  EXPECT_TRUE(CpuAffinity::workerCpus({}, 0).empty());
+
+  // The CPUs are handed out again from the first one when there are more workers than CPUs.
+  const std::vector<uint32_t> cpus{2, 4, 6};
+  EXPECT_THAT(CpuAffinity::workerCpus(cpus, 0), ElementsAre(2));
+  EXPECT_THAT(CpuAffinity::workerCpus(cpus, 2), ElementsAre(6));
+  EXPECT_THAT(CpuAffinity::workerCpus(cpus, 3), ElementsAre(2));
+}
+
+#if defined(__linux__)
+
+using testing::DoAll;
+using testing::Invoke;
+using testing::Return;
+using testing::SetArgPointee;
+
+TEST(CpuAffinityLinuxTest, SetThreadAffinity) {
+  Api::MockLinuxOsSysCalls linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+
+  EXPECT_CALL(linux_os_sys_calls, sched_setaffinity(0, sizeof(cpu_set_t), _))
+      .WillOnce(Invoke([](pid_t, size_t, const cpu_set_t* mask) -> Api::SysCallIntResult {
+        EXPECT_EQ(2, CPU_COUNT(mask));
+        EXPECT_TRUE(CPU_ISSET(1, mask));
+        EXPECT_TRUE(CPU_ISSET(3, mask));
+        return {0, 0};
+      }));
+  EXPECT_TRUE(CpuAffinity::setThreadAffinity({1, 3}));
+
+  EXPECT_CALL(linux_os_sys_calls, sched_setaffinity(0, sizeof(cpu_set_t), _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EINVAL}));
+  EXPECT_FALSE(CpuAffinity::setThreadAffinity({1}));
+
+  // CPUs which do not fit in a CPU set are rejected without a system call.
+  EXPECT_CALL(linux_os_sys_calls, sched_setaffinity(_, _, _)).Times(0);
+  EXPECT_FALSE(CpuAffinity::setThreadAffinity({CPU_SETSIZE}));
+}
+
+TEST(CpuAffinityLinuxTest, ThreadAffinity) {
+  Api::MockLinuxOsSysCalls linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+
+  cpu_set_t test_set;
+  CPU_ZERO(&test_set);
+  CPU_SET(0, &test_set);
+  CPU_SET(5, &test_set);
+  EXPECT_CALL(linux_os_sys_calls, sched_getaffinity(0, sizeof(cpu_set_t), _))
+      .WillOnce(DoAll(SetArgPointee<2>(test_set), Return(Api::SysCallIntResult{0, 0})));
+  EXPECT_THAT(CpuAffinity::threadAffinity(), ElementsAre(0, 5));
+
+  EXPECT_CALL(linux_os_sys_calls, sched_getaffinity(0, sizeof(cpu_set_t), _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EINVAL}));
+  EXPECT_TRUE(CpuAffinity::threadAffinity().empty());
+}
+
+TEST(CpuAffinityLinuxTest, NumaNodesOfUnknownCpus) {
+  EXPECT_TRUE(CpuAffinity::numaNodes({CPU_SETSIZE + 1}).empty());
+}
+
+#endif
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
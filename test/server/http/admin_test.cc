@@ -34,6 +34,7 @@
 
 using testing::_;
 using testing::AllOf;
+using testing::ElementsAre;
 using testing::Ge;
 using testing::HasSubstr;
 using testing::InSequence;
@@ -1237,6 +1238,31 @@ TEST_P(AdminInstanceTest, GetRequest) {
   EXPECT_EQ(server_info_proto.command_line_options().service_cluster(), "cluster");
 }
 
+TEST_P(AdminInstanceTest, GetServerInfoThreadPlacements) {
+  NiceMock<Init::MockManager> initManager;
+  ON_CALL(server_, initManager()).WillByDefault(ReturnRef(initManager));
+  server_.options_.concurrency_ = 3;
+  server_.options_.worker_cpu_affinity_ = {4, 5};
+  server_.options_.main_thread_cpu_affinity_ = {0, 1};
+
+  Http::HeaderMapImpl response_headers;
+  std::string body;
+  EXPECT_EQ(Http::Code::OK, admin_.request("/server_info", "GET", response_headers, body));
+  envoy::admin::v2alpha::ServerInfo server_info_proto;
+  MessageUtil::loadFromJson(body, server_info_proto);
+
+  // The NUMA nodes depend on the host, so only the CPUs are checked.
+  ASSERT_EQ(4, server_info_proto.thread_placements_size());
+  EXPECT_EQ("main_thread", server_info_proto.thread_placements(0).thread());
+  EXPECT_THAT(server_info_proto.thread_placements(0).cpus(), ElementsAre(0, 1));
+  EXPECT_EQ("worker_0", server_info_proto.thread_placements(1).thread());
+  EXPECT_THAT(server_info_proto.thread_placements(1).cpus(), ElementsAre(4));
+  EXPECT_EQ("worker_1", server_info_proto.thread_placements(2).thread());
+  EXPECT_THAT(server_info_proto.thread_placements(2).cpus(), ElementsAre(5));
+  EXPECT_EQ("worker_2", server_info_proto.thread_placements(3).thread());
+  EXPECT_THAT(server_info_proto.thread_placements(3).cpus(), ElementsAre(4));
+}
+
 TEST_P(AdminInstanceTest, GetReadyRequest) {
   NiceMock<Init::MockManager> initManager;
   ON_CALL(server_, initManager()).WillByDefault(ReturnRef(initManager));
@@ -387,7 +387,35 @@ filter_chains:
   EXPECT_TRUE(filter_chain->transportSocketFactory().implementsSecureTransport());
 }
 
+class TestActiveUdpListenerFactory : public Network::ActiveUdpListenerFactory {
+public:
+  // Network::ActiveUdpListenerFactory
+  Network::ConnectionHandler::ActiveListenerPtr
+  createActiveUdpListener(Network::ConnectionHandler&, Event::Dispatcher&, spdlog::logger&,
+                          Network::ListenerConfig&) const override {
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+};
+
+class TestActiveUdpListenerConfigFactory : public ActiveUdpListenerConfigFactory {
+public:
+  // Server::ActiveUdpListenerConfigFactory
+  Network::ActiveUdpListenerFactoryPtr
+  createActiveUdpListenerFactory(const Protobuf::Message&) override {
+    return std::make_unique<TestActiveUdpListenerFactory>();
+  }
+
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<Envoy::ProtobufWkt::Empty>();
+  }
+
+  std::string name() override { return "udp_test"; }
+};
+
 TEST_F(ListenerManagerImplWithRealFiltersTest, UdpAddress) {
+  Registry::RegisterFactory<TestActiveUdpListenerConfigFactory, ActiveUdpListenerConfigFactory>
+      registered;
+
   const std::string proto_text = R"EOF(
     address: {
       socket_address: {
@@ -397,6 +425,9 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, UdpAddress) {
       }
     }
     filter_chains: {}
+    udp_listener_config: {
+      udp_listener_name: "udp_test"
+    }
   )EOF";
   envoy::api::v2::Listener listener_proto;
   EXPECT_TRUE(Protobuf::TextFormat::ParseFromString(proto_text, &listener_proto));
@@ -406,6 +437,51 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, UdpAddress) {
               createListenSocket(_, Network::Address::SocketType::Datagram, _, true));
   manager_->addOrUpdateListener(listener_proto, "", true);
   EXPECT_EQ(1U, manager_->listeners().size());
+  EXPECT_NE(nullptr, manager_->listeners().front().get().udpListenerFactory());
+}
+
+TEST_F(ListenerManagerImplWithRealFiltersTest, UdpAddressWithoutUdpListenerConfig) {
+  const std::string proto_text = R"EOF(
+    address: {
+      socket_address: {
+        protocol: UDP
+        address: "127.0.0.1"
+        port_value: 1234
+      }
+    }
+    filter_chains: {}
+  )EOF";
+  envoy::api::v2::Listener listener_proto;
+  EXPECT_TRUE(Protobuf::TextFormat::ParseFromString(proto_text, &listener_proto));
+
+  EXPECT_THROW_WITH_MESSAGE(manager_->addOrUpdateListener(listener_proto, "", true),
+                            EnvoyException,
+                            "error adding listener '127.0.0.1:1234': udp listeners require a "
+                            "udp_listener_config");
+  EXPECT_EQ(0U, manager_->listeners().size());
+}
+
+TEST_F(ListenerManagerImplWithRealFiltersTest, UdpAddressWithUnknownUdpListener) {
+  const std::string proto_text = R"EOF(
+    address: {
+      socket_address: {
+        protocol: UDP
+        address: "127.0.0.1"
+        port_value: 1234
+      }
+    }
+    filter_chains: {}
+    udp_listener_config: {
+      udp_listener_name: "unknown"
+    }
+  )EOF";
+  envoy::api::v2::Listener listener_proto;
+  EXPECT_TRUE(Protobuf::TextFormat::ParseFromString(proto_text, &listener_proto));
+
+  EXPECT_THROW_WITH_MESSAGE(manager_->addOrUpdateListener(listener_proto, "", true),
+                            EnvoyException,
+                            "Didn't find a registered implementation for name: 'unknown'");
+  EXPECT_EQ(0U, manager_->listeners().size());
 }
 
 TEST_F(ListenerManagerImplWithRealFiltersTest, BadListenerConfig) {
@@ -75,7 +75,8 @@ TEST_F(OptionsImplTest, All) {
       "--service-cluster cluster --service-node node --service-zone zone "
       "--file-flush-interval-msec 9000 "
       "--drain-time-s 60 --log-format [%v] --parent-shutdown-time-s 90 --log-path /foo/bar "
-      "--disable-hot-restart --cpuset-threads");
+      "--disable-hot-restart --cpuset-threads --worker-cpu-affinity 0-2,5 "
+      "--main-thread-cpu-affinity 7");
   EXPECT_EQ(Server::Mode::Validate, options->mode());
   EXPECT_EQ(2U, options->concurrency());
   EXPECT_EQ("hello", options->configPath());
@@ -95,6 +96,8 @@ TEST_F(OptionsImplTest, All) {
   EXPECT_EQ(true, options->hotRestartDisabled());
   EXPECT_EQ(true, options->libeventBufferEnabled());
   EXPECT_EQ(true, options->cpusetThreadsEnabled());
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 5}), options->workerCpuAffinity());
+  EXPECT_EQ(std::vector<uint32_t>({7}), options->mainThreadCpuAffinity());
 
   options = createOptionsImpl("envoy --mode init_only");
   EXPECT_EQ(Server::Mode::InitOnly, options->mode());
@@ -126,6 +129,8 @@ TEST_F(OptionsImplTest, SetAll) {
   options->setHotRestartDisabled(!options->hotRestartDisabled());
   options->setSignalHandling(!options->signalHandlingEnabled());
   options->setCpusetThreads(!options->cpusetThreadsEnabled());
+  options->setWorkerCpuAffinity({1, 3});
+  options->setMainThreadCpuAffinity({0});
 
   EXPECT_EQ(109876, options->baseId());
   EXPECT_EQ(42U, options->concurrency());
@@ -147,6 +152,8 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(!hot_restart_disabled, options->hotRestartDisabled());
   EXPECT_EQ(!signal_handling_enabled, options->signalHandlingEnabled());
   EXPECT_EQ(!cpuset_threads_enabled, options->cpusetThreadsEnabled());
+  EXPECT_EQ(std::vector<uint32_t>({1, 3}), options->workerCpuAffinity());
+  EXPECT_EQ(std::vector<uint32_t>({0}), options->mainThreadCpuAffinity());
 
   // Validate that CommandLineOptions is constructed correctly.
   Server::CommandLineOptionsPtr command_line_options = options->toCommandLineOptions();
@@ -174,6 +181,8 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(options->hotRestartDisabled(), command_line_options->disable_hot_restart());
   EXPECT_EQ(options->mutexTracingEnabled(), command_line_options->enable_mutex_tracing());
   EXPECT_EQ(options->cpusetThreadsEnabled(), command_line_options->cpuset_threads());
+  EXPECT_THAT(command_line_options->worker_cpu_affinity(), testing::ElementsAre(1, 3));
+  EXPECT_THAT(command_line_options->main_thread_cpu_affinity(), testing::ElementsAre(0));
 }
 
 TEST_F(OptionsImplTest, DefaultParams) {
@@ -185,6 +194,8 @@ TEST_F(OptionsImplTest, DefaultParams) {
   EXPECT_EQ(Server::Mode::Serve, options->mode());
   EXPECT_EQ(false, options->hotRestartDisabled());
   EXPECT_EQ(false, options->cpusetThreadsEnabled());
+  EXPECT_TRUE(options->workerCpuAffinity().empty());
+  EXPECT_TRUE(options->mainThreadCpuAffinity().empty());
 
   // Validate that CommandLineOptions is constructed correctly with default params.
   Server::CommandLineOptionsPtr command_line_options = options->toCommandLineOptions();
@@ -218,6 +229,21 @@ TEST_F(OptionsImplTest, BadCliOption) {
                           MalformedArgvException, "error: unknown IP address version 'foo'");
 }
 
+TEST_F(OptionsImplTest, BadCpuAffinity) {
+  EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy -c hello --worker-cpu-affinity 0,a"),
+                          MalformedArgvException,
+                          "error: invalid CPU 'a' in --worker-cpu-affinity '0,a'");
+  EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy -c hello --worker-cpu-affinity 3-1"),
+                          MalformedArgvException,
+                          "error: invalid CPU '3-1' in --worker-cpu-affinity '3-1'");
+  EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy -c hello --main-thread-cpu-affinity 0-1024"),
+                          MalformedArgvException,
+                          "error: invalid CPU '0-1024' in --main-thread-cpu-affinity '0-1024'");
+  EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy -c hello --main-thread-cpu-affinity 1,"),
+                          MalformedArgvException,
+                          "error: invalid CPU '' in --main-thread-cpu-affinity '1,'");
+}
+
 TEST_F(OptionsImplTest, ParseComponentLogLevels) {
   std::unique_ptr<OptionsImpl> options = createOptionsImpl("envoy --mode init_only");
   options->parseComponentLogLevels("upstream:debug,connection:trace");
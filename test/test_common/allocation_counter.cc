@@ -0,0 +1,28 @@
+#include "test/test_common/allocation_counter.h"
+
+#ifdef TCMALLOC
+#include "gperftools/malloc_hook.h"
+#endif
+
+namespace Envoy {
+
+std::atomic<uint64_t> AllocationCounter::allocations_;
+
+AllocationCounter::AllocationCounter(benchmark::State& state) : state_(state) {
+#ifdef TCMALLOC
+  allocations_ = 0;
+  MallocHook::AddNewHook(&onNew);
+#endif
+}
+
+AllocationCounter::~AllocationCounter() {
+#ifdef TCMALLOC
+  MallocHook::RemoveNewHook(&onNew);
+  state_.counters["allocs/op"] =
+      benchmark::Counter(allocations_, benchmark::Counter::kAvgIterations);
+#endif
+}
+
+void AllocationCounter::onNew(const void*, size_t) { allocations_++; }
+
+} // namespace Envoy
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+
+/**
+ * Counts the heap allocations made while it is in scope and reports them per iteration as the
+ * "allocs/op" counter of a benchmark. Counting relies on tcmalloc hooks, so no counter is reported
+ * in builds without tcmalloc.
+ */
+class AllocationCounter {
+public:
+  AllocationCounter(benchmark::State& state);
+  ~AllocationCounter();
+
+private:
+  static void onNew(const void*, size_t);
+
+  benchmark::State& state_;
+  static std::atomic<uint64_t> allocations_;
+};
+
+} // namespace Envoy
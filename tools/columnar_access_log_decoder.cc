@@ -0,0 +1,99 @@
+/**
+ * Utility to convert a columnar access log to tab separated values, one line per entry.
+ *
+ * Usage:
+ *
+ * columnar_access_log_decoder <columnar access log path>
+ */
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/utility.h"
+
+#include "extensions/access_loggers/columnar_file/columnar_format.h"
+
+// NOLINT(namespace-envoy)
+namespace {
+
+std::string protocolName(const absl::optional<Envoy::Http::Protocol>& protocol) {
+  if (!protocol) {
+    return "-";
+  }
+  switch (protocol.value()) {
+  case Envoy::Http::Protocol::Http10:
+    return "HTTP/1.0";
+  case Envoy::Http::Protocol::Http11:
+    return "HTTP/1.1";
+  case Envoy::Http::Protocol::Http2:
+    return "HTTP/2";
+  }
+  return "-";
+}
+
+std::string orDash(absl::string_view value) {
+  return value.empty() ? "-" : std::string(value);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <columnar access log path>" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::ifstream file(argv[1], std::ios::binary);
+  if (!file) {
+    std::cerr << "unable to open " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  const std::string data = contents.str();
+
+  std::cout << "start_time\tduration_us\tresponse_code\tresponse_flags\tprotocol\tbytes_received\t"
+               "bytes_sent\tmethod\tauthority\tpath\tupstream_cluster\tupstream_host\troute_name\t"
+               "downstream_remote_address"
+            << std::endl;
+
+  absl::string_view remaining = data;
+  std::vector<Envoy::Extensions::AccessLoggers::ColumnarFile::ColumnarRecord> records;
+  while (!remaining.empty()) {
+    records.clear();
+    size_t size;
+    try {
+      size = Envoy::Extensions::AccessLoggers::ColumnarFile::ColumnarBlockDecoder::decode(remaining,
+                                                                                          records);
+    } catch (const Envoy::EnvoyException& e) {
+      std::cerr << "offset " << data.size() - remaining.size() << ": " << e.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (size == 0) {
+      // The last block is still being written.
+      std::cerr << "offset " << data.size() - remaining.size() << ": ignoring a partial block"
+                << std::endl;
+      break;
+    }
+    remaining.remove_prefix(size);
+
+    for (const auto& record : records) {
+      const Envoy::SystemTime start_time{std::chrono::microseconds(record.start_time_us_)};
+      std::cout << Envoy::AccessLogDateTimeFormatter::fromTime(start_time) << "\t"
+                << (record.duration_us_ ? std::to_string(record.duration_us_.value()) : "-")
+                << "\t" << record.response_code_ << "\t" << record.response_flags_ << "\t"
+                << protocolName(record.protocol_) << "\t" << record.bytes_received_ << "\t"
+                << record.bytes_sent_ << "\t" << orDash(record.method_) << "\t"
+                << orDash(record.authority_) << "\t" << orDash(record.path_) << "\t"
+                << orDash(record.upstream_cluster_) << "\t" << orDash(record.upstream_host_)
+                << "\t" << orDash(record.route_name_) << "\t"
+                << orDash(record.downstream_remote_address_) << "\n";
+    }
+  }
+  return EXIT_SUCCESS;
+}